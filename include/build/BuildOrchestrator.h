@@ -0,0 +1,181 @@
+// BuildOrchestrator.h
+#ifndef BUILDORCHESTRATOR_H
+#define BUILDORCHESTRATOR_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class JobRunner;
+class Netlist;
+
+/**
+ * @brief Incremental compile and link of the schematic's SystemC testbench
+ *
+ * A build turns the netlist into translation units under .scv/build: one
+ * unit per instance, which includes the component's .cpp (or the Verilated
+ * header), creates the module and binds its ports to the channels it is
+ * handed, and tb_main.cpp, which declares the signals and calls every unit.
+ * Since binding happens inside the units, rewiring the schematic or renaming
+ * a net only recompiles tb_main.
+ *
+ * Units are compiled with -MMD; the manifest keeps the command line and the
+ * SHA-1 of every file the compiler read (the unit, the component source and
+ * any project header it includes). A unit whose command and dependencies are
+ * unchanged is not recompiled, and an unchanged set of objects is not
+ * relinked. File hashes are cached by mtime and size, so a no-op build only
+ * stats files.
+ *
+ * Compiles run on the terminal section's JobRunner, which bounds the number
+ * of concurrent compilers, lists each job in the Jobs tab and feeds compiler
+ * diagnostics to the Problems view. Optionally <systemc.h> is precompiled
+ * once into scv_pch.h.gch; every unit includes scv_pch.h first, so GCC picks
+ * it up whenever it exists.
+ */
+class BuildOrchestrator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Settings {
+        QString compiler;                ///< Defaults to $CXX, then g++
+        QString cxxFlags;
+        QString systemcHome;             ///< Defaults to $SYSTEMC_HOME
+        QString verilatorRoot;           ///< Defaults to $VERILATOR_ROOT
+        int jobs = 0;                    ///< Concurrent compiles; 0 is one per core
+        bool usePrecompiledHeader = true;
+
+        static Settings load();
+        void save() const;
+    };
+
+    struct Result {
+        bool ok = false;
+        QString executable;
+        int compiled = 0;                ///< Units that were recompiled
+        int upToDate = 0;                ///< Units that were skipped
+        bool linked = false;
+        qint64 elapsedMs = 0;
+        QStringList warnings;            ///< From the netlist and the build setup
+        QString errorString;
+    };
+
+    explicit BuildOrchestrator(JobRunner* runner, QObject* parent = nullptr);
+    ~BuildOrchestrator() override;
+
+    void setSettings(const Settings& settings) { m_settings = settings; }
+    const Settings& settings() const { return m_settings; }
+
+    /**
+     * @brief Starts an incremental build of @p netlist; finished() reports the outcome
+     * @return false if a build is already running or the sources could not be written
+     */
+    bool build(const QString& workingDirectory, const Netlist& netlist);
+
+    /**
+     * @brief Stops the running build; its finished() reports a failure
+     */
+    void cancel();
+
+    /**
+     * @brief Removes the build directory, forcing the next build to compile everything
+     */
+    bool clean(const QString& workingDirectory);
+
+    bool isBuilding() const { return m_phase != Phase::Idle; }
+
+    static QString buildDirectory(const QString& workingDirectory);
+
+    static constexpr const char* BUILD_DIRECTORY = ".scv/build";
+    static constexpr const char* MANIFEST_NAME = "manifest.json";
+    static constexpr const char* EXECUTABLE_NAME = "scv_sim";
+    static constexpr const char* MAIN_UNIT = "tb_main";
+    static constexpr int MANIFEST_VERSION = 1;
+
+signals:
+    void progress(const QString& message);
+    void finished(const BuildOrchestrator::Result& result);
+
+private:
+    enum class Phase {
+        Idle,
+        PrecompiledHeader,
+        Compile,
+        Link
+    };
+
+    struct Unit {
+        QString name;                    ///< Instance name, or MAIN_UNIT
+        QString source;
+        QString object;
+        QString depFile;
+        bool rtl = false;                ///< Needs the Verilator include paths
+    };
+
+    struct FileStamp {
+        qint64 mtime = 0;
+        qint64 size = -1;
+        QByteArray hash;
+    };
+
+    struct UnitRecord {
+        QByteArray commandHash;
+        QHash<QString, QByteArray> dependencies;  ///< Path -> SHA-1 when it was compiled
+    };
+
+    bool writeSources(const Netlist& netlist);
+    void removeStaleUnits();
+    void startPrecompiledHeader();
+    void startCompile();
+    void startLink();
+    void finish(bool ok, const QString& errorString = QString());
+
+    void submit(const QString& target, const QString& command);
+    void onJobChanged(int id);
+    void onUnitCompiled(const QString& name, bool passed);
+
+    bool isDirty(const Unit& unit, const QByteArray& commandHash);
+    QByteArray fileHash(const QString& path);
+    QByteArray commandHash(const QString& command) const;
+    static QStringList readDepFile(const QString& path);
+
+    QString compileCommand(const Unit& unit) const;
+    QString precompiledHeaderCommand() const;
+    QString linkCommand() const;
+    QString includeFlags(bool rtl) const;
+    QString compiler() const;
+
+    bool loadManifest();
+    bool saveManifest() const;
+
+    static bool writeIfChanged(const QString& path, const QString& content);
+    static QString quoted(const QString& path);
+
+    QPointer<JobRunner> m_runner;
+    Settings m_settings;
+
+    Phase m_phase = Phase::Idle;
+    QString m_workingDirectory;
+    QString m_buildDirectory;
+    QVector<Unit> m_units;
+    QStringList m_rtlModules;            ///< Verilated models to link, by module name
+    QHash<int, QString> m_jobTargets;    ///< JobRunner job id -> unit name, "pch" or "link"
+    QHash<QString, QHash<QString, QByteArray>> m_snapshots;  ///< Dependency hashes taken at submit time
+    QHash<QString, UnitRecord> m_records;
+    QHash<QString, FileStamp> m_stamps;
+    QByteArray m_pchHash;                ///< Command the current scv_pch.h.gch was built with
+    QByteArray m_linkHash;               ///< Command and inputs of the current executable
+    QByteArray m_pendingHash;            ///< Replaces one of the above once its job passes
+    bool m_failed = false;
+    bool m_submitting = false;
+    int m_savedMaxConcurrent = 0;        ///< The runner's own limit while a build overrides it
+    Result m_result;
+    QElapsedTimer m_timer;
+};
+
+#endif // BUILDORCHESTRATOR_H
@@ -0,0 +1,376 @@
+// SchematicCommands.h
+#ifndef SCHEMATICCOMMANDS_H
+#define SCHEMATICCOMMANDS_H
+
+#include <QUndoCommand>
+#include <QPointer>
+#include <QPointF>
+#include <QSizeF>
+#include <QColor>
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QHash>
+#include <QByteArray>
+#include "graphics/wire/WireGraphicsItem.h"
+#include "persistence/BlockPersistence.h"
+#include "persistence/ConnectionPersistence.h"
+
+class QGraphicsItem;
+class ReadyComponentGraphicsItem;
+class BlockGraphicsItem;
+class TextGraphicsItem;
+class SchematicScene;
+
+/**
+ * @brief Base of all schematic edits recorded by UndoHistory
+ *
+ * Commands keep the smallest description of an edit that can replay it in
+ * both directions - a move is one offset for the whole selection, not the
+ * positions of every item - and report what that costs so the history can
+ * keep itself within its byte budget. Items are held through a QPointer, so
+ * a command whose item has since been deleted does nothing.
+ */
+class SchematicCommand : public QUndoCommand
+{
+public:
+    using QUndoCommand::QUndoCommand;
+
+    virtual qint64 byteCost() const = 0;
+
+    enum Id { MoveItemsId = 1 };
+
+protected:
+    struct ItemRef {
+        QGraphicsItem* item = nullptr;
+        QPointer<QObject> guard;
+
+        QGraphicsItem* get() const { return guard ? item : nullptr; }
+    };
+
+    struct WireRef {
+        QPointer<WireGraphicsItem> wire;
+        QPointer<ReadyComponentGraphicsItem> source;
+        QPointer<ReadyComponentGraphicsItem> target;
+
+        bool canConnect() const { return wire && source && target; }
+    };
+
+    static ItemRef refOf(QGraphicsItem* item);
+    static WireRef wireRefOf(WireGraphicsItem* wire);
+};
+
+/**
+ * @brief Commands run one after another as a single undo step
+ *
+ * Built by UndoHistory between beginMacro() and endMacro() from commands
+ * that have already run, so the first redo() does nothing. Undo runs the
+ * commands in reverse order.
+ */
+class MacroCommand : public SchematicCommand
+{
+public:
+    explicit MacroCommand(const QString& text, QUndoCommand* parent = nullptr);
+    ~MacroCommand() override;
+
+    /**
+     * @brief Append a command that has already run; ownership is taken
+     */
+    void append(QUndoCommand* command);
+    bool isEmpty() const { return m_commands.isEmpty(); }
+
+    void undo() override;
+    void redo() override;
+    qint64 byteCost() const override;
+
+private:
+    QVector<QUndoCommand*> m_commands;
+    bool m_pending = true;               ///< The commands have already run
+};
+
+/**
+ * @brief Moves items, by one shared offset or each by its own
+ *
+ * Pushed after the items have already moved, so the first redo() does
+ * nothing. Commands of the same drag @p gesture on the same items merge
+ * into one undo step; a command with NoGesture never merges.
+ */
+class MoveItemsCommand : public SchematicCommand
+{
+public:
+    static constexpr int NoGesture = -1;
+
+    MoveItemsCommand(const QList<QGraphicsItem*>& items, const QPointF& delta, int gesture,
+                     QUndoCommand* parent = nullptr);
+    /// Moves each item by its own offset, as one step that never merges
+    explicit MoveItemsCommand(const QList<QPair<QGraphicsItem*, QPointF>>& moves,
+                              QUndoCommand* parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+    int id() const override { return m_gesture == NoGesture ? -1 : int(MoveItemsId); }
+    bool mergeWith(const QUndoCommand* other) override;
+    qint64 byteCost() const override;
+
+private:
+    void translate(int sign);
+
+    QVector<ItemRef> m_items;
+    QVector<QPointF> m_deltas;           ///< One per item
+    int m_gesture;
+    bool m_pending = true;               ///< The scene already applied the first redo()
+};
+
+/**
+ * @brief Resizes a component and saves its size
+ */
+class ResizeComponentCommand : public SchematicCommand
+{
+public:
+    ResizeComponentCommand(ReadyComponentGraphicsItem* component, const QSizeF& oldSize, const QSizeF& newSize,
+                           QUndoCommand* parent = nullptr);
+
+    void undo() override { apply(m_oldSize); }
+    void redo() override { apply(m_newSize); }
+    qint64 byteCost() const override { return sizeof(*this); }
+
+private:
+    void apply(const QSizeF& size);
+
+    QPointer<ReadyComponentGraphicsItem> m_component;
+    QSizeF m_oldSize;
+    QSizeF m_newSize;
+};
+
+/**
+ * @brief Connects and disconnects wires
+ *
+ * redo() takes @p removed out of the scene and puts @p added into it; undo()
+ * does the reverse. Either step registers the wires with their components
+ * and the scene's WireManager and saves or removes their connections. Both
+ * are idempotent, so a wire the scene has just connected can be recorded as
+ * added without connecting it twice. Wires out of the scene belong to the
+ * command and are deleted with it.
+ */
+class ChangeWiresCommand : public SchematicCommand
+{
+public:
+    ChangeWiresCommand(SchematicScene* scene, const QList<WireGraphicsItem*>& added,
+                       const QList<WireGraphicsItem*>& removed, const QString& text,
+                       QUndoCommand* parent = nullptr);
+    ~ChangeWiresCommand() override;
+
+    void undo() override;
+    void redo() override;
+    qint64 byteCost() const override;
+
+    static void attach(SchematicScene* scene, WireGraphicsItem* wire);
+    static void detach(WireGraphicsItem* wire);
+
+private:
+    static QVector<WireRef> refsOf(const QList<WireGraphicsItem*>& wires);
+    void connectAll(const QVector<WireRef>& wires);
+    void disconnectAll(const QVector<WireRef>& wires);
+
+    QPointer<SchematicScene> m_scene;
+    QVector<WireRef> m_added;
+    QVector<WireRef> m_removed;
+    bool m_done = false;
+};
+
+/**
+ * @brief Adds and removes components, RTL modules and text items
+ *
+ * What ChangeWiresCommand is for wires: redo() takes @p removed out of the
+ * scene and puts @p added into it, undo() does the reverse, and both are
+ * idempotent. Taking an item out unregisters it and removes its persisted
+ * data - a component's files, a module's placement, a text's entry -
+ * keeping a copy that putting it back restores. Items out of the scene
+ * belong to the command and are deleted with it. The wires of removed items
+ * go in a ChangeWiresCommand pushed before this one.
+ */
+class ChangeItemsCommand : public SchematicCommand
+{
+public:
+    ChangeItemsCommand(SchematicScene* scene, const QList<QGraphicsItem*>& added,
+                       const QList<QGraphicsItem*>& removed, const QString& text,
+                       QUndoCommand* parent = nullptr);
+    ~ChangeItemsCommand() override;
+
+    void undo() override;
+    void redo() override;
+    qint64 byteCost() const override;
+
+private:
+    struct ItemRecord {
+        ItemRef ref;
+        QString id;                              ///< Component ID or RTL module name, while out of the scene
+        QString filePath;                        ///< Source of an RTL module
+        QHash<QString, QByteArray> files;        ///< A component's files, by name, while out of the scene
+    };
+
+    static QVector<ItemRecord> recordsOf(const QList<QGraphicsItem*>& items);
+    void attach(ItemRecord& record);
+    static void detach(ItemRecord& record);
+
+    QPointer<SchematicScene> m_scene;
+    QVector<ItemRecord> m_added;
+    QVector<ItemRecord> m_removed;
+    bool m_done = false;
+};
+
+/**
+ * @brief Collapses components into a block, or expands a block into them
+ *
+ * Folding moves the members - components, RTL modules and nested blocks -
+ * and the wires between them from the scene into the block's own scene,
+ * puts the block in their place and swaps each wire crossing the border for
+ * one to the block's port; unfolding does the reverse. Only blocks.json
+ * changes: the members keep their files and connections, and neither scene
+ * is reloaded. The block and the wires out of the scene belong to the command.
+ */
+class FoldBlockCommand : public SchematicCommand
+{
+public:
+    /// Collapses @p members into @p block, a new block described by @p data that is not in the scene yet
+    FoldBlockCommand(SchematicScene* scene, BlockGraphicsItem* block, const BlockData& data,
+                     const QList<ReadyComponentGraphicsItem*>& members, QUndoCommand* parent = nullptr);
+    /// Expands @p block, which is in @p scene
+    FoldBlockCommand(SchematicScene* scene, BlockGraphicsItem* block, QUndoCommand* parent = nullptr);
+    ~FoldBlockCommand() override;
+
+    void undo() override { m_collapse ? unfold() : fold(); }
+    void redo() override { m_collapse ? fold() : unfold(); }
+    qint64 byteCost() const override;
+
+private:
+    struct Crossing {
+        WireRef member;                  ///< Joins a member to the outside; empty if it has no block port
+        WireRef block;                   ///< The same connection through the block's port
+    };
+
+    void fold();
+    void unfold();
+
+    QPointer<SchematicScene> m_scene;
+    QPointer<BlockGraphicsItem> m_block;
+    BlockData m_data;                    ///< The block as it was when it last unfolded
+    QVector<QPointer<ReadyComponentGraphicsItem>> m_members;
+    QVector<WireRef> m_wires;            ///< Between members
+    QVector<Crossing> m_crossings;
+    QPointF m_offset;                    ///< How far the block had moved from its origin when it unfolded
+    bool m_collapse;
+};
+
+/**
+ * @brief Deletes a block with everything inside it
+ *
+ * The contents are not loaded, so redo() keeps what deleting them removes
+ * from disk - the blocks, the component files, the RTL placements and the
+ * connections of the components - and undo() writes it back. The block's
+ * scene is dropped and loads again when it is next opened.
+ */
+class RemoveBlockCommand : public SchematicCommand
+{
+public:
+    RemoveBlockCommand(SchematicScene* scene, BlockGraphicsItem* block, QUndoCommand* parent = nullptr);
+    ~RemoveBlockCommand() override;
+
+    void undo() override;
+    void redo() override;
+    qint64 byteCost() const override;
+
+private:
+    struct ModulePlacement {
+        QString name;
+        QString definition;
+        QString filePath;
+        QPointF position;
+    };
+
+    QPointer<SchematicScene> m_scene;
+    QPointer<BlockGraphicsItem> m_block;
+    QVector<WireRef> m_wires;
+    QVector<BlockData> m_blocks;                 ///< The deleted blocks and those around them, while deleted
+    QHash<QString, QByteArray> m_files;          ///< The components' files, by name
+    QVector<ModulePlacement> m_modules;
+    QList<ConnectionData> m_connections;
+    bool m_done = false;
+};
+
+/**
+ * @brief Changes a wire's control points and segment offset
+ */
+class WireGeometryCommand : public SchematicCommand
+{
+public:
+    WireGeometryCommand(WireGraphicsItem* wire, const WireGraphicsItem::Geometry& before,
+                        const WireGraphicsItem::Geometry& after, const QString& text,
+                        QUndoCommand* parent = nullptr);
+
+    void undo() override { apply(m_before); }
+    void redo() override { apply(m_after); }
+    qint64 byteCost() const override;
+
+private:
+    void apply(const WireGraphicsItem::Geometry& geometry);
+
+    QPointer<WireGraphicsItem> m_wire;
+    WireGraphicsItem::Geometry m_before;
+    WireGraphicsItem::Geometry m_after;
+};
+
+/**
+ * @brief Changes a component's geometry and appearance, as edited in the properties dialog
+ */
+class ComponentPropertiesCommand : public SchematicCommand
+{
+public:
+    struct State {
+        QPointF position;
+        QSizeF size;
+        qreal rotation = 0.0;
+        qreal opacity = 1.0;
+        bool visible = true;
+        QColor color;                    ///< Invalid when the component has no custom color
+
+        static State of(const ReadyComponentGraphicsItem* component);
+    };
+
+    ComponentPropertiesCommand(ReadyComponentGraphicsItem* component, const State& before, const State& after,
+                               const QString& text, QUndoCommand* parent = nullptr);
+
+    void undo() override { apply(m_before); }
+    void redo() override { apply(m_after); }
+    qint64 byteCost() const override { return sizeof(*this); }
+
+private:
+    void apply(const State& state);
+
+    QPointer<ReadyComponentGraphicsItem> m_component;
+    State m_before;
+    State m_after;
+};
+
+/**
+ * @brief Changes the text of a text item
+ */
+class TextEditCommand : public SchematicCommand
+{
+public:
+    TextEditCommand(TextGraphicsItem* item, const QString& oldText, const QString& newText,
+                    QUndoCommand* parent = nullptr);
+
+    void undo() override { apply(m_oldText); }
+    void redo() override { apply(m_newText); }
+    qint64 byteCost() const override;
+
+private:
+    void apply(const QString& text);
+
+    QPointer<TextGraphicsItem> m_item;
+    QString m_oldText;
+    QString m_newText;
+};
+
+#endif // SCHEMATICCOMMANDS_H
@@ -0,0 +1,118 @@
+// UndoHistory.h
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+class QUndoCommand;
+class MacroCommand;
+class SchematicScene;
+
+/**
+ * @brief Undo/redo history with a memory budget
+ *
+ * Works like QUndoStack - push() runs the command, merges it into the
+ * previous one when both share an id() and mergeWith() agrees, and drops
+ * anything that could still be redone - but its size is bounded in bytes
+ * rather than in commands: once the commands held exceed byteBudget(), the
+ * oldest are deleted. A command's cost is SchematicCommand::byteCost() plus
+ * that of its children, so a 500-item paste stored as one delta weighs what
+ * its data weighs, not 500 times a fixed slot.
+ *
+ * push(), undo() and redo() each run inside one PersistenceManager::Batch,
+ * so whatever a command changes reaches meta.json in a single write. Undo
+ * and redo of a command recorded with its scene also run inside a
+ * SchematicScene::Transaction there, so a 500-item step costs one routing
+ * pass and one repaint, as it did when it was first made.
+ * Commands pushed between beginMacro() and endMacro() are run as they come
+ * and recorded together as one step.
+ */
+class UndoHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UndoHistory(QObject* parent = nullptr);
+    ~UndoHistory() override;
+
+    /**
+     * @brief Run @p command and record it; the history takes ownership
+     * @param scene Scene the command edits, if any
+     *
+     * Commands pushed while an undo or redo is running are run but not recorded.
+     */
+    void push(QUndoCommand* command, SchematicScene* scene = nullptr);
+    void clear();
+    
+    /**
+     * @brief Record the commands pushed until the matching endMacro() as one step named @p text
+     *
+     * Macros nest; only the outermost one is recorded. Undo and redo are
+     * unavailable while a macro is open. Macros opened while an undo or
+     * redo is running record nothing.
+     */
+    void beginMacro(const QString& text, SchematicScene* scene = nullptr);
+    void endMacro();
+    bool isInMacro() const { return m_macroDepth > 0; }
+
+    bool canUndo() const { return m_index > 0; }
+    bool canRedo() const { return m_index < m_entries.size(); }
+    QString undoText() const;
+    QString redoText() const;
+    int count() const { return m_entries.size(); }
+    int index() const { return m_index; }
+
+    void setByteBudget(qint64 bytes);
+    qint64 byteBudget() const { return m_byteBudget; }
+    qint64 bytesUsed() const { return m_bytesUsed; }
+
+    static qint64 costOf(const QUndoCommand* command);
+
+    static constexpr qint64 DEFAULT_BYTE_BUDGET = 16 * 1024 * 1024;
+
+public slots:
+    void undo();
+    void redo();
+
+signals:
+    void canUndoChanged(bool canUndo);
+    void canRedoChanged(bool canRedo);
+    void undoTextChanged(const QString& undoText);
+    void redoTextChanged(const QString& redoText);
+    void indexChanged(int index);
+
+private:
+    struct Entry {
+        QUndoCommand* command;
+        qint64 cost;
+        QPointer<SchematicScene> scene;
+    };
+
+    struct State {
+        bool canUndo;
+        bool canRedo;
+        QString undoText;
+        QString redoText;
+        int index;
+    };
+
+    void run(const Entry& entry, bool undo);
+    State state() const;
+    void notify(const State& before);
+    void truncateRedo();
+    void enforceBudget();
+
+    QVector<Entry> m_entries;
+    int m_index = 0;                     ///< Commands before this one are applied
+    qint64 m_bytesUsed = 0;
+    qint64 m_byteBudget = DEFAULT_BYTE_BUDGET;
+    bool m_running = false;              ///< Inside a command's redo() or undo()
+    int m_macroDepth = 0;
+    MacroCommand* m_macro = nullptr;     ///< Open macro, recorded by the outermost endMacro()
+    QPointer<SchematicScene> m_macroScene;
+};
+
+#endif // UNDOHISTORY_H
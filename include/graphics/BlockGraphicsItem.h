@@ -0,0 +1,99 @@
+// BlockGraphicsItem.h
+#ifndef BLOCKGRAPHICSITEM_H
+#define BLOCKGRAPHICSITEM_H
+
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "persistence/BlockPersistence.h"
+#include <QList>
+#include <QPointF>
+#include <QVector>
+#include <memory>
+
+class SchematicScene;
+
+/**
+ * @brief A collapsed region of the schematic, drawn as one component
+ *
+ * The block's ports stand for the wires that crossed its border when it was
+ * collapsed: inputs on the left, outputs on the right, each leading to one
+ * port of a component inside. Wires attach to these ports like to any
+ * component's, and memberOf() tells persistence which component a wire
+ * really joins.
+ *
+ * The contents live in a SchematicScene of their own, created and loaded by
+ * childScene() the first time the block is opened; until then nothing inside
+ * is parsed or instantiated.
+ */
+class BlockGraphicsItem : public ReadyComponentGraphicsItem
+{
+public:
+    explicit BlockGraphicsItem(const BlockData& data, QGraphicsItem* parent = nullptr);
+    ~BlockGraphicsItem() override;
+
+    enum { Type = SchematicItemType::Block };
+    int type() const override { return Type; }
+
+    QString blockName() const { return m_blockName; }
+    QString label() const { return m_label; }
+    void setLabel(const QString& label);  // Saved to blocks.json
+
+    // Ports
+    const QVector<BlockPort>& ports() const { return m_ports; }
+    const BlockPort* memberOf(const QPointF& port) const;  ///< nullptr if @p port is not one of the block's
+    QPointF portFor(const QString& memberId, bool isRTL, const QPointF& memberPort) const;  ///< Null if none leads there
+
+    /**
+     * @brief Re-read label and ports from blocks.json after the inside was edited
+     *
+     * Wires stay on the port of their member; wires whose member is gone are
+     * removed from the scene (their connections already went with the member).
+     */
+    void syncWithPersistence();
+
+    /**
+     * @brief The scene showing the inside of the block, loaded on first use
+     * @param loadContents False to create it empty, for a caller that moves the contents in itself
+     */
+    SchematicScene* childScene(bool loadContents = true);
+    bool isChildSceneLoaded() const { return m_childScene != nullptr; }
+
+    /**
+     * @brief Drop the inside, unregistering its items; childScene() loads it again
+     */
+    void unloadChildScene();
+
+    // Port management (override base class methods)
+    QList<QPointF> getInputPorts() const override;
+    QList<QPointF> getOutputPorts() const override;
+    QPointF getPortAt(const QPointF& pos, bool& isInput) const override;
+    bool isNearPort(const QPointF& pos) const override;
+    int getPortWidth(const QPointF& port, bool isInput) const override;
+
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+protected:
+    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
+    void hoverMoveEvent(QGraphicsSceneHoverEvent* event) override;
+    void contextMenuEvent(QGraphicsSceneContextMenuEvent* event) override;
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private:
+    QString m_blockName;
+    QString m_label;
+    QVector<BlockPort> m_ports;
+    QList<QPointF> m_inputPositions;   ///< Item positions of the input ports, in port order
+    QList<QPointF> m_outputPositions;
+    QVector<int> m_inputIndexes;       ///< Index into m_ports of each input position
+    QVector<int> m_outputIndexes;
+    std::unique_ptr<SchematicScene> m_childScene;
+
+    static constexpr qreal WIDTH = 160.0;
+    static constexpr qreal HEADER_HEIGHT = 28.0;
+    static constexpr qreal PORT_SPACING = 20.0;
+    static constexpr qreal PORT_DETECTION_RADIUS = 12.0;
+
+    void setPorts(const QVector<BlockPort>& ports);
+    int portIndexAt(const QPointF& port, bool isInput) const;
+};
+
+#endif // BLOCKGRAPHICSITEM_H
@@ -28,6 +28,7 @@
 #include "parsers/SvParser.h"
 #include <QList>
 #include <QSizeF>
+#include <QVector>
 #include <QCursor>
 
 class WireGraphicsItem;
@@ -52,6 +53,9 @@ public:
      * The item starts in RTL view mode by default.
      */
     explicit ModuleGraphicsItem(const ModuleInfo& info, QGraphicsItem *parent = nullptr);
+
+    enum { Type = SchematicItemType::Module };
+    int type() const override { return Type; }
     
     /**
      * @brief Set the RTL view mode
@@ -75,6 +79,12 @@ public:
      * Updates the module's port configuration and refreshes the display.
      */
     void updateModuleInfo(const ModuleInfo& newInfo);
+    
+    /**
+     * @brief Get the module information
+     * @return Module name and ports as last parsed or edited
+     */
+    const ModuleInfo& getModuleInfo() const { return m_info; }
 
     /**
      * @brief Get the bounding rectangle of the module
@@ -135,6 +145,16 @@ public:
      */
     bool isNearPort(const QPointF& pos) const override;
     
+    /**
+     * @brief Get the bit width of the port at a position
+     * @param port Port position, as returned by getInputPorts()/getOutputPorts()
+     * @param isInput Whether the port is an input
+     * @return Width in bits, or 0 for the bundled RTL view port
+     * 
+     * Looks the width up in a table built whenever the module info changes.
+     */
+    int getPortWidth(const QPointF& port, bool isInput) const override;
+    
     // Wire management (override base class methods)
     /**
      * @brief Update wire connections
@@ -235,6 +255,10 @@ private:
     bool m_isHovering;              ///< Whether mouse is hovering over module
     bool m_isRTLView;               ///< Whether in RTL view mode
     bool m_hovered;                 ///< Whether module is being hovered
+    QVector<int> m_inputWidths;     ///< Bits per input port, in port order
+    QVector<int> m_outputWidths;    ///< Bits per output port, in port order
+    
+    void updatePortWidths();
     
     // Resize functionality
     /**
@@ -35,6 +35,7 @@
 #include <QObject>
 #include <memory>
 #include "parsers/SvParser.h"
+#include "graphics/SchematicItemTypes.h"
 
 class WireGraphicsItem;
 class ComponentPortManager;
@@ -78,6 +79,9 @@ public:
      */
     ~ReadyComponentGraphicsItem() override;
 
+    enum { Type = SchematicItemType::ReadyComponent };
+    int type() const override { return Type; }
+
     /**
      * @brief Get the bounding rectangle of the component
      * @return QRectF representing the component's bounding rectangle
@@ -111,17 +115,20 @@ public:
     
     // Color management
     void setCustomColor(const QColor& color);
+    void clearCustomColor();
     QColor getCustomColor() const { return m_customColor; }
     bool hasCustomColor() const { return m_hasCustomColor; }
     
     // Port management
     void refreshPortsFromFile(const QString& filePath);
+    void refreshPorts(const ModuleInfo& moduleInfo);
     
     // Port management (delegates to ComponentPortManager)
     virtual QList<QPointF> getInputPorts() const;
     virtual QList<QPointF> getOutputPorts() const;
     virtual QPointF getPortAt(const QPointF& pos, bool& isInput) const;
     virtual bool isNearPort(const QPointF& pos) const;
+    virtual int getPortWidth(const QPointF& port, bool isInput) const;  ///< Bits; 0 if unknown
     void setHighlightedPort(const QPointF& port);
     void clearHighlightedPort();
     
@@ -163,6 +170,10 @@ protected:
     void hoverMoveEvent(QGraphicsSceneHoverEvent* event) override;
     QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
     
+    // Keep the scene's PortIndex in step with the ports' scene positions
+    void updatePortIndex();
+    void trackPortIndex(GraphicsItemChange change);
+    
     // Protected members accessible to derived classes
     std::unique_ptr<ComponentPortManager> m_portManager;
     std::unique_ptr<ComponentWireManager> m_wireManager;
@@ -0,0 +1,48 @@
+// SchematicItemTypes.h
+#ifndef SCHEMATICITEMTYPES_H
+#define SCHEMATICITEMTYPES_H
+
+#include <QGraphicsItem>
+#include <type_traits>
+
+/**
+ * @brief QGraphicsItem::type() values of the schematic's own items
+ *
+ * Lets the scene tell its items apart with one virtual call instead of a
+ * chain of dynamic_casts. ModuleGraphicsItem and BlockGraphicsItem have types
+ * of their own but are still ReadyComponentGraphicsItems; cast() accounts
+ * for that.
+ */
+namespace SchematicItemType {
+
+enum : int {
+    ReadyComponent = QGraphicsItem::UserType + 1,
+    Module,
+    Wire,
+    Text,
+    Block
+};
+
+inline bool isComponent(int type)
+{
+    return type == ReadyComponent || type == Module || type == Block;
+}
+
+/**
+ * @brief qgraphicsitem_cast() that also casts modules and blocks to ReadyComponentGraphicsItem
+ */
+template <typename T>
+T cast(QGraphicsItem* item)
+{
+    using Item = std::remove_cv_t<std::remove_pointer_t<T>>;
+    if (!item) {
+        return nullptr;
+    }
+    const int type = item->type();
+    const bool matches = int(Item::Type) == ReadyComponent ? isComponent(type) : type == int(Item::Type);
+    return matches ? static_cast<T>(item) : nullptr;
+}
+
+} // namespace SchematicItemType
+
+#endif // SCHEMATICITEMTYPES_H
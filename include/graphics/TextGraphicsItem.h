@@ -4,6 +4,7 @@
 
 #include <QGraphicsTextItem>
 #include <QFont>
+#include "graphics/SchematicItemTypes.h"
 
 class TextGraphicsItem : public QGraphicsTextItem
 {
@@ -11,6 +12,10 @@ class TextGraphicsItem : public QGraphicsTextItem
 
 public:
     explicit TextGraphicsItem(const QString& text = "", QGraphicsItem* parent = nullptr);
+    ~TextGraphicsItem() override;
+
+    enum { Type = SchematicItemType::Text };
+    int type() const override { return Type; }
     
     // Getters
     QString getText() const { return toPlainText(); }
@@ -26,6 +31,7 @@ public:
     
     // Rename functionality
     void showRenameDialog();
+    void commitText(const QString& text);  // Sets the text and saves it, as a finished edit
     
 protected:
     void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
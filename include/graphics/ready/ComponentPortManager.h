@@ -6,6 +6,7 @@
 #include <QList>
 #include <QString>
 #include <QColor>
+#include <QVector>
 
 class WireGraphicsItem;
 struct ModuleInfo;
@@ -52,6 +53,12 @@ public:
     int getNumInputPorts() const;
     int getNumOutputPorts() const;
     
+    /**
+     * @brief Bit width of the port at @p port, from the table built in updatePortsFromModuleInfo()
+     * @return 0 if the width is unknown (ports not read from a file yet)
+     */
+    int getPortWidth(const QPointF& port, bool isInput) const;
+    
     // Constants
     static constexpr int PORT_RADIUS = 6;
     static constexpr int PORT_DETECTION_RADIUS = 15;
@@ -66,6 +73,8 @@ private:
     bool m_useDynamicPorts;
     int m_dynamicInputCount;
     int m_dynamicOutputCount;
+    QVector<int> m_inputWidths;   // Bits per port, in port order
+    QVector<int> m_outputWidths;
 };
 
 #endif // COMPONENTPORTMANAGER_H
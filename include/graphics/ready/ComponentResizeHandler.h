@@ -28,6 +28,7 @@ public:
     void updateResize(const QPointF& pos, qreal& width, qreal& height);
     void endResize();
     bool isResizing() const { return m_isResizing; }
+    QSizeF getStartSize() const { return m_resizeStartSize; }
     
     // Rendering
     void drawResizeHandle(QPainter* painter, qreal width, qreal height, qreal offset) const;
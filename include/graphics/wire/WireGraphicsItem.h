@@ -14,8 +14,10 @@
 #include "graphics/wire/WireControlPoints.h"
 #include "graphics/wire/WireRenderer.h"
 #include "graphics/wire/WireSegments.h"
+#include "graphics/SchematicItemTypes.h"
 
 class ReadyComponentGraphicsItem;
+struct ConnectionEnd;
 
 /**
  * @brief Main wire graphics item - refactored with composition
@@ -56,6 +58,9 @@ public:
                      QGraphicsItem* parent = nullptr);
     ~WireGraphicsItem();
 
+    enum { Type = SchematicItemType::Wire };
+    int type() const override { return Type; }
+
     // QGraphicsItem interface
     QRectF boundingRect() const override;
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
@@ -73,6 +78,7 @@ public:
     // Save connection to persistence
     void saveConnectionToPersistence();
     void saveConnectionToPersistence(const QPointF& oldSourcePort, const QPointF& oldTargetPort);
+    void removeConnectionFromPersistence();
     
     ReadyComponentGraphicsItem* getSource() const { return m_source; }
     ReadyComponentGraphicsItem* getTarget() const { return m_target; }
@@ -80,6 +86,7 @@ public:
     QPointF getTargetPort() const { return m_targetPort; }
     QPointF getSourceScenePos() const;
     QPointF getTargetScenePos() const;
+    QPainterPath path() const { return m_path; }   ///< In scene coordinates
     QColor getNeonColor() const { return m_renderer.getWireColor(); }
     
     // Control points management (delegated to WireControlPoints)
@@ -115,11 +122,32 @@ public:
     QString getLabel() const { return m_labelText; }
     void showLabel(bool show);
     bool isLabelVisible() const { return m_labelVisible; }
+    void setLabelAnchor(qreal percent);    ///< Centre the label this fraction of the way along the path
+    qreal getLabelAnchor() const { return m_labelAnchor; }
+    QSizeF getLabelSize() const;
     
     // Offset adjustment
     void nudge(int dx, int dy);
     void setOrthogonalOffset(qreal offset) { m_orthogonalOffset = offset; updatePath(); }
     qreal getOrthogonalOffset() const { return m_orthogonalOffset; }
+    void setManualOffset(bool manual) { m_manualOffset = manual; }
+    bool hasManualOffset() const { return m_manualOffset; }    ///< Routing edited by hand; the net layout keeps off it
+    
+    // Routing geometry as one value, for undo
+    struct Geometry {
+        QList<QPointF> controlPoints;
+        qreal orthogonalOffset = 0.0;
+        bool manualOffset = false;
+        
+        bool operator==(const Geometry& other) const {
+            return controlPoints == other.controlPoints && orthogonalOffset == other.orthogonalOffset
+                   && manualOffset == other.manualOffset;
+        }
+        bool operator!=(const Geometry& other) const { return !(*this == other); }
+    };
+    Geometry geometry() const { return {getControlPoints(), m_orthogonalOffset, m_manualOffset}; }
+    void setGeometry(const Geometry& geometry);
+    void saveGeometryToPersistence();
     
     void updatePath();
 
@@ -132,12 +160,19 @@ protected:
     void hoverLeaveEvent(QGraphicsSceneHoverEvent* event) override;
     void contextMenuEvent(QGraphicsSceneContextMenuEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
+    QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
 
 private slots:
     void animateParticles();
     void onLabelChanged();
 
 private:
+    bool connectionEnds(const QPointF& sourcePort, const QPointF& targetPort,
+                        ConnectionEnd& source, ConnectionEnd& target) const;
+    void commitGeometryEdit(const QString& text);
+    void updateLabelPosition();
+    void requestNetLayout();
+    
     // Component instances
     WireControlPoints m_controlPointsManager;
     WireRenderer m_renderer;
@@ -155,6 +190,7 @@ private:
     QPainterPath m_path;
     RoutingMode m_routingMode = WirePathBuilder::Orthogonal;
     qreal m_orthogonalOffset = 0.0;
+    bool m_manualOffset = false;         ///< Set by segment drags and nudges, saved with the offset
     
     // Animation
     QTimer* m_animationTimer;
@@ -164,6 +200,7 @@ private:
     QGraphicsTextItem* m_label = nullptr;
     QString m_labelText;
     bool m_labelVisible = false;
+    qreal m_labelAnchor = 0.5;
     
     // Interaction state
     int m_draggedControlPointIndex = -1;
@@ -177,6 +214,9 @@ private:
     QPointF m_segmentDragStart;
     qreal m_segmentOriginalOffset = 0.0;
     
+    // Geometry when the current edit started; the edit is recorded for undo against it
+    Geometry m_geometryBeforeEdit;
+    
     static constexpr int PORT_RADIUS = 6;
 };
 
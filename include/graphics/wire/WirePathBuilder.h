@@ -61,7 +61,7 @@ public:
      */
     static QPainterPath createBezierPath(const QPointF& start, const QPointF& end);
 
-private:
+    /// Orthogonal paths run this far out of a port before their first bend
     static constexpr qreal PORT_SPACING = 20.0;
 };
 
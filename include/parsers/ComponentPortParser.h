@@ -30,6 +30,13 @@ public:
      */
     static ModuleInfo parseComponentContent(const QString& content, const QString& componentId);
     
+    /**
+     * @brief Extract port type and width from sc_in/sc_out declaration
+     * @param typeStr The type string (e.g., "sc_uint<8>", "bool")
+     * @param port Output Port structure to update with width info
+     */
+    static void extractPortTypeAndWidth(const QString& typeStr, Port& port);
+    
 private:
     /**
      * @brief Parse a single port declaration line
@@ -38,13 +45,6 @@ private:
      * @return true if successfully parsed, false otherwise
      */
     static bool parsePortLine(const QString& line, Port& port);
-    
-    /**
-     * @brief Extract port type and width from sc_in/sc_out declaration
-     * @param typeStr The type string (e.g., "sc_uint<8>", "bool")
-     * @param port Output Port structure to update with width info
-     */
-    static void extractPortTypeAndWidth(const QString& typeStr, Port& port);
 };
 
 #endif // COMPONENTPORTPARSER_H
@@ -0,0 +1,84 @@
+// IncrementalPortParser.h
+#ifndef INCREMENTALPORTPARSER_H
+#define INCREMENTALPORTPARSER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTextDocument>
+#include <QTimer>
+#include <QVector>
+#include "parsers/SvParser.h"  // Reuse Port and ModuleInfo
+
+/**
+ * @brief Keeps the ports of an SC_MODULE in sync with a document being edited
+ *
+ * Every line of the document is classified once (module header, port
+ * declaration, end of the port section, other) and the result is cached per
+ * line together with whether the line ends inside a block comment. On
+ * QTextDocument::contentsChange only the edited lines are re-tokenised; the
+ * re-scan runs on past them only while their comment state differs from the
+ * cached one. The port list is then reassembled from the cached lines and,
+ * after a short debounce, portsChanged() is emitted if it differs from the
+ * last one.
+ *
+ * Port lines follow the format ComponentPortParser reads from disk:
+ * sc_in<type> name; and sc_out<type> name; inside SC_MODULE(name) { ... },
+ * before the constructor or the first member function.
+ */
+class IncrementalPortParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IncrementalPortParser(QTextDocument* document, QObject* parent = nullptr);
+
+    /**
+     * @brief Ports as of the last reassembly; name is empty without an SC_MODULE
+     */
+    ModuleInfo moduleInfo() const { return m_info; }
+
+    /**
+     * @brief One-shot parse of @p content with the same line rules
+     */
+    static ModuleInfo parse(const QString& content);
+
+    static constexpr int DEBOUNCE_MS = 300;
+
+signals:
+    void portsChanged(const ModuleInfo& info);
+
+private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void reassemble();
+
+private:
+    enum LineKind : quint8 {
+        OtherLine,
+        ModuleLine,        ///< SC_MODULE(name), possibly followed by '{'
+        OpenBraceLine,     ///< Starts with '{' (a module header's brace on its own line)
+        PortLine,
+        EndLine            ///< SC_CTOR, a member function, a nested block or the closing brace
+    };
+
+    struct LineInfo {
+        LineKind kind = OtherLine;
+        bool commentAtStart = false;   ///< Line was classified starting inside a /* */ comment
+        bool commentAtEnd = false;     ///< Line ends inside a /* */ comment
+        bool moduleBrace = false;      ///< ModuleLine whose '{' is on the same line
+        QString name;                  ///< Module or port name
+        Port port;
+    };
+
+    static LineInfo classify(const QString& line, bool commentAtStart);
+    static ModuleInfo assemble(const QVector<LineInfo>& lines);
+    static bool samePorts(const ModuleInfo& a, const ModuleInfo& b);
+    void reclassifyAll();
+
+    QPointer<QTextDocument> m_document;
+    QVector<LineInfo> m_lines;         ///< Parallel to the document's blocks
+    ModuleInfo m_info;
+    QTimer* m_debounceTimer;
+};
+
+#endif // INCREMENTALPORTPARSER_H
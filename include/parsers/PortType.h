@@ -0,0 +1,59 @@
+// PortType.h
+#ifndef PORTTYPE_H
+#define PORTTYPE_H
+
+#include <QString>
+#include <QStringView>
+#include "parsers/SvParser.h"  // Reuse Port structure
+
+/**
+ * @brief Bit-width type of a port, shared by the SystemC and SystemVerilog sides
+ *
+ * Ports carry their width as a "[MSB:LSB]" string (empty for one bit) and
+ * components declare them with SystemC types. PortType converts between the
+ * two in one place: fromSystemC() reads sc_in/sc_out template arguments,
+ * fromWidthSpec() reads the Port::width string, and systemCType() /
+ * widthSpec() write them back. A width of 0 means it could not be
+ * determined (a parameterised range, a user type); such a port is
+ * compatible with any other.
+ */
+struct PortType
+{
+    enum Kind {
+        Unknown,
+        Bool,                            ///< bool, sc_logic
+        UInt,                            ///< sc_uint<N>, uintN_t
+        Int,                             ///< sc_int<N>, intN_t
+        BigUInt,                         ///< sc_biguint<N>
+        BigInt,                          ///< sc_bigint<N>
+        LogicVector,                     ///< sc_lv<N>
+        BitVector                        ///< sc_bv<N>
+    };
+
+    Kind kind = Unknown;
+    int width = 0;                       ///< Bits; 0 if unknown
+
+    bool isKnown() const { return width > 0; }
+
+    static PortType fromSystemC(QStringView type);
+    static PortType fromWidthSpec(const QString& spec);
+    static PortType fromPort(const Port& port) { return fromWidthSpec(port.width); }
+    static PortType fromWidth(int width);
+
+    /**
+     * @brief Type for an sc_signal or port of this width; sc_uint<32> if unknown
+     */
+    QString systemCType() const;
+
+    /**
+     * @brief Width in Port::width form: "" for one bit, "[N-1:0]" otherwise
+     */
+    QString widthSpec() const;
+
+    static bool widthsCompatible(int a, int b) { return a <= 0 || b <= 0 || a == b; }
+
+    static constexpr int MAX_NATIVE_WIDTH = 64;   ///< Widest sc_uint/sc_int
+    static constexpr int FALLBACK_WIDTH = 32;
+};
+
+#endif // PORTTYPE_H
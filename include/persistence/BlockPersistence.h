@@ -0,0 +1,93 @@
+// BlockPersistence.h
+#ifndef BLOCKPERSISTENCE_H
+#define BLOCKPERSISTENCE_H
+
+#include <QString>
+#include <QStringList>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+#include <QMap>
+#include <QHash>
+
+class QGraphicsScene;
+class PersistenceManager;
+
+struct BlockPort {
+    QString name;
+    int width = 0;           ///< Bits; 0 if unknown
+    bool isInput = true;
+    QString memberId;        ///< Component ID or RTL module name the port leads to, however deep
+    bool memberIsRTL = false;
+    QPointF memberPort;      ///< Port on that component, as stored in its connections
+};
+
+struct BlockData {
+    QString name;            ///< Unique; what members and nested blocks refer to
+    QString label;           ///< Shown on the block
+    QString parent;          ///< Enclosing block; empty at the top level
+    QPointF position;
+    QPointF origin;          ///< Position when collapsed; the contents keep the coordinates they had then
+    QStringList components;  ///< Component IDs directly inside
+    QStringList rtlModules;  ///< RTL module names directly inside
+    QVector<BlockPort> ports;
+};
+
+/**
+ * @brief Collapsed blocks of the schematic, in .scv/blocks.json
+ *
+ * A block lists the components and RTL modules directly inside it; nested
+ * blocks name their parent. Connections are not touched by collapsing: they
+ * keep joining the components inside, and each block port records which of
+ * them it leads to. ownerOf() is a hash lookup, so the loaders can skip
+ * everything that is not in the scene being loaded.
+ *
+ * The blocks are read on first use and kept in memory.
+ */
+class BlockPersistence
+{
+public:
+    explicit BlockPersistence(const QString& workingDirectory);
+
+    // Blocks
+    QList<BlockData> blocks();
+    BlockData block(const QString& name);
+    bool contains(const QString& name);
+    QString createBlockName();
+    void saveBlock(const BlockData& block);  // Replaces a block of the same name
+    void updateBlockPosition(const QString& name, const QPointF& position);
+    void updateBlockLabel(const QString& name, const QString& label);
+    void removeBlock(const QString& name);
+    QString parentOf(const QString& name);
+    QStringList childBlocks(const QString& name);
+    bool loadBlocks(QGraphicsScene* scene, PersistenceManager* pm);
+
+    // Membership; the owner of a component outside every block is empty
+    QString ownerOf(const QString& memberId, bool isRTL);
+    void setOwner(const QString& memberId, bool isRTL, const QString& name);
+    void removeMember(const QString& memberId, bool isRTL);  // Also drops the ports leading to it
+
+    // Working directory
+    void setWorkingDirectory(const QString& directory);
+    QString getWorkingDirectory() const { return m_workingDirectory; }
+
+    // Batched writes: blocks.json is written once by the outermost endBatch()
+    void beginBatch();
+    void endBatch();
+
+private:
+    QString m_workingDirectory;
+    bool m_loaded = false;
+    QMap<QString, BlockData> m_blocks;
+    QHash<QString, QString> m_owners;        ///< memberKey() -> block
+
+    int m_batchDepth = 0;
+    bool m_batchDirty = false;
+
+    static QString memberKey(const QString& memberId, bool isRTL);
+    void ensureLoaded();
+    void save();
+    void writeBlocksJson();
+};
+
+#endif // BLOCKPERSISTENCE_H
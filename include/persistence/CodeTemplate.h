@@ -0,0 +1,65 @@
+// CodeTemplate.h
+#ifndef CODETEMPLATE_H
+#define CODETEMPLATE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Small logic-less text template, compiled once and rendered many times
+ *
+ * Syntax (a subset of Mustache):
+ * - {{name}}               value of a field, empty if unset
+ * - {{#name}}...{{/name}}  repeated once per item if name is a list; rendered
+ *                          once if it is a non-empty field
+ * - {{^name}}...{{/name}}  rendered only if name is an empty list or field
+ *
+ * Inside a list section, the item's fields shadow the outer ones. A section
+ * tag alone on its line removes the whole line, so templates can keep one
+ * tag per line without leaving blank lines behind.
+ */
+class CodeTemplate
+{
+public:
+    using Fields = QHash<QString, QString>;
+
+    struct Data {
+        Fields fields;
+        QHash<QString, QVector<Fields>> lists;
+    };
+
+    /**
+     * @brief Parses @p source; on a syntax error returns an invalid template
+     *        and describes the problem in @p errorString
+     */
+    static CodeTemplate compile(const QString& source, QString* errorString = nullptr);
+
+    bool isValid() const { return m_valid; }
+
+    QString render(const Data& data) const;
+    void renderTo(QString* out, const Data& data) const;
+
+private:
+    enum NodeType : quint8 {
+        TextNode,
+        FieldNode,
+        SectionNode,
+        InvertedSectionNode
+    };
+
+    struct Node {
+        NodeType type = TextNode;
+        QString text;                    ///< Literal text, or the field/section name
+        int end = 0;                     ///< Sections: index one past their last child
+    };
+
+    void renderRange(QString* out, int first, int last, const Data& data, const Fields* item) const;
+    static QString lookup(const QString& name, const Data& data, const Fields* item);
+
+    QVector<Node> m_nodes;
+    int m_sizeHint = 0;                  ///< Literal length, used to reserve the output
+    bool m_valid = false;
+};
+
+#endif // CODETEMPLATE_H
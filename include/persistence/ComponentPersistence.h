@@ -13,9 +13,15 @@
 #include <QDateTime>
 #include <QHash>
 #include <QSet>
+#include <QStringList>
 #include <QObject>
+#include <QVector>
+#include <memory>
 #include "parsers/SvParser.h"
 
+class SystemCGenerator;
+class FileWriteQueue;
+
 class QGraphicsScene;
 class QGraphicsItem;
 
@@ -25,9 +31,17 @@ class ComponentPersistence : public QObject
     
 public:
     explicit ComponentPersistence(const QString& workingDirectory);
+    ~ComponentPersistence() override;
+    
+    struct ComponentPlacement {
+        QString componentType;
+        QPointF position;
+        QSizeF size;
+    };
     
-    // Component file creation
+    // Component file creation; the .cpp files are written in the background
     QString createComponentFile(const QString& componentType, const QPointF& position, const QSizeF& size);
+    QStringList createComponentFiles(const QVector<ComponentPlacement>& placements);
     QString createRTLModuleFile(const ModuleInfo& moduleInfo, const QString& filePath, 
                                const QPointF& position, const QSizeF& size);
     
@@ -77,8 +91,13 @@ public:
     QString getSystemCContentFromModuleInfo(const ModuleInfo& moduleInfo, const QString& componentId);
     QString getSystemCPortType(const Port& port);
     
+    // Blocks until every generated file queued so far is on disk
+    void flushPendingWrites();
+    
     // Performance optimization
     void scheduleMetadataUpdate(const QString& componentId);
+    void beginBatch();   // Defers meta.json writes until the outermost endBatch()
+    void endBatch();
     void clearMetadataCache();
     void restoreComponentCounter();
     
@@ -110,6 +129,12 @@ private:
     // Performance optimization
     std::unique_ptr<QTimer> m_batchUpdateTimer;
     QSet<QString> m_pendingUpdates;
+    int m_batchDepth = 0;
+    bool m_batchDirty = false;     // A write was deferred by the open batch
+    
+    // SystemC generation and background file output
+    std::unique_ptr<SystemCGenerator> m_generator;
+    std::unique_ptr<FileWriteQueue> m_writeQueue;
     
     // Metadata caching
     QHash<QString, QJsonObject> m_metadataCache;
@@ -7,6 +7,7 @@
 #include <QPointF>
 #include <QSizeF>
 #include <QList>
+#include <QStringList>
 
 class QGraphicsScene;
 class PersistenceManager;
@@ -20,6 +21,14 @@ struct ConnectionData {
     bool targetIsRTL;
     QList<QPointF> controlPoints;
     qreal orthogonalOffset;
+    bool manualOffset;          // The offset was dragged by hand, not assigned by the net layout
+};
+
+// One end of a stored connection: always a component or RTL module, never a block
+struct ConnectionEnd {
+    QString id;
+    QPointF port;
+    bool isRTL = false;
 };
 
 
@@ -32,7 +41,8 @@ public:
     void saveConnection(const QString& sourceId, const QPointF& sourcePort,
                        const QString& targetId, const QPointF& targetPort,
                        bool sourceIsRTL, bool targetIsRTL,
-                       const QList<QPointF>& controlPoints, qreal orthogonalOffset = 0.0);
+                       const QList<QPointF>& controlPoints, qreal orthogonalOffset = 0.0,
+                       bool manualOffset = false);
     void removeConnection(const QString& sourceId, const QPointF& sourcePort,
                          const QString& targetId, const QPointF& targetPort);
     void updateConnectionControlPoints(const QString& sourceId, const QPointF& sourcePort,
@@ -40,8 +50,9 @@ public:
                                        const QList<QPointF>& controlPoints);
     void updateConnectionOrthogonalOffset(const QString& sourceId, const QPointF& sourcePort,
                                           const QString& targetId, const QPointF& targetPort,
-                                          qreal orthogonalOffset);
+                                          qreal orthogonalOffset, bool manualOffset);
     bool loadConnections(QGraphicsScene* scene, PersistenceManager* pm);
+    QList<ConnectionData> connectionsOf(const QStringList& componentIds);  // Those removeComponentFromConnections() drops
     
     // Component tracking in connections
     void updateRTLComponentInConnections(const QString& componentId, const QPointF& position);
@@ -52,9 +63,18 @@ public:
     void setWorkingDirectory(const QString& directory);
     QString getWorkingDirectory() const { return m_workingDirectory; }
     
+    // Batched writes: the connections are kept in memory and written once by the outermost endBatch()
+    void beginBatch();
+    void endBatch();
+    
 private:
     QString m_workingDirectory;
     
+    int m_batchDepth = 0;
+    bool m_batchLoaded = false;
+    bool m_batchDirty = false;
+    QJsonObject m_batchJson;
+    
     QJsonObject loadConnectionsJson();
     void saveConnectionsJson(const QJsonObject& json);
     QList<ConnectionData> parseConnections(const QJsonObject& json);
@@ -0,0 +1,52 @@
+// FileWriteQueue.h
+#ifndef FILEWRITEQUEUE_H
+#define FILEWRITEQUEUE_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+/**
+ * @brief Writes generated files on a worker thread, in the order they were queued
+ *
+ * Each file is written through QSaveFile, so a reader never sees a half
+ * written file. Anything that reads a queued file back must flush() first;
+ * isPending() tells whether a path still has a write in flight.
+ */
+class FileWriteQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FileWriteQueue(QObject* parent = nullptr);
+    ~FileWriteQueue() override;
+
+    void enqueue(const QString& filePath, const QString& content);
+    void enqueue(const QVector<QPair<QString, QString>>& files);
+
+    bool isPending(const QString& filePath) const;
+    int pendingCount() const;
+
+    /**
+     * @brief Blocks until every queued write has finished
+     */
+    void flush();
+
+signals:
+    void fileWritten(const QString& filePath, bool ok, const QString& errorString);
+    void idle();
+
+private:
+    void write(const QString& filePath, const QString& content);
+
+    QThreadPool m_pool;                  ///< One worker keeps writes in queue order
+    mutable QMutex m_mutex;
+    QHash<QString, int> m_pending;       ///< Writes in flight per path
+    int m_pendingTotal = 0;
+};
+
+#endif // FILEWRITEQUEUE_H
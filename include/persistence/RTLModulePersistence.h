@@ -12,7 +12,8 @@ class PersistenceManager;
 struct Port;
 
 struct RTLModuleData {
-    QString moduleName;
+    QString moduleName;      ///< Name the placed module is registered under
+    QString definition;      ///< Module parsed from filePath; the same as moduleName unless pasted
     QString filePath;
     QPointF position;
 };
@@ -23,7 +24,8 @@ public:
     explicit RTLModulePersistence(const QString& workingDirectory);
     
     // RTL module placement
-    void saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position);
+    void saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position,
+                                const QString& definition = QString());
     void updateRTLModulePosition(const QString& moduleName, const QPointF& position);
     void updateRTLModulePorts(const QString& moduleName, const QList<Port>& inputs, const QList<Port>& outputs);
     void removeRTLModulePlacement(const QString& moduleName);
@@ -39,9 +41,18 @@ public:
     // Public for legacy code access
     QJsonObject loadRTLPlacementsJson();
     
+    // Batched writes: the placements are kept in memory and written once by the outermost endBatch()
+    void beginBatch();
+    void endBatch();
+    
 private:
     QString m_workingDirectory;
     
+    int m_batchDepth = 0;
+    bool m_batchLoaded = false;
+    bool m_batchDirty = false;
+    QJsonObject m_batchJson;
+    
     void saveRTLPlacementsJson(const QJsonObject& json);
     QList<RTLModuleData> parseRTLPlacements(const QJsonObject& json);
 };
@@ -0,0 +1,74 @@
+// SystemCGenerator.h
+#ifndef SYSTEMCGENERATOR_H
+#define SYSTEMCGENERATOR_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "persistence/CodeTemplate.h"
+#include "parsers/SvParser.h"  // Reuse Port and ModuleInfo
+
+/**
+ * @brief Renders SystemC skeletons for components and RTL module wrappers
+ *
+ * Skeletons come from compiled CodeTemplates, cached per component type. A
+ * project may override any of them with <project>/.scv/templates/<Type>.sc.tmpl
+ * (RTLModule.sc.tmpl for module wrappers); an override is recompiled when
+ * its modification time changes and falls back to the built-in template if
+ * it does not compile.
+ *
+ * Component templates see the fields type, id and note and the list ports
+ * (direction, ctype, name, comment). Module wrapper templates see module, id,
+ * has_inputs and has_outputs and the lists inputs and outputs (ctype, name,
+ * width).
+ */
+class SystemCGenerator
+{
+public:
+    struct Request {
+        QString componentType;           ///< Ready component type; unused for module wrappers
+        QString componentId;
+        ModuleInfo moduleInfo;           ///< Ports of the RTL module to wrap
+        bool moduleWrapper = false;
+    };
+
+    explicit SystemCGenerator(const QString& workingDirectory = QString());
+
+    /**
+     * @brief Changes the project whose templates override the built-in ones
+     */
+    void setWorkingDirectory(const QString& directory);
+
+    QString generate(const Request& request);
+
+    /**
+     * @brief Renders every request; results are in request order
+     *
+     * Templates are resolved once per distinct type up front. Batches of
+     * PARALLEL_BATCH_SIZE or more are rendered on the global thread pool.
+     */
+    QVector<QString> generateBatch(const QVector<Request>& requests);
+
+    static QString systemCPortType(const Port& port);
+
+    static constexpr int PARALLEL_BATCH_SIZE = 16;
+
+private:
+    struct CachedTemplate {
+        CodeTemplate compiled;
+        QString sourcePath;              ///< Empty for the built-in template
+        QDateTime modified;
+    };
+
+    const CodeTemplate& templateFor(const Request& request);
+    QString userTemplatePath(const QString& key) const;
+    static CodeTemplate builtinTemplate(bool moduleWrapper);
+    static QString templateKey(const Request& request);
+    static CodeTemplate::Data templateData(const Request& request);
+
+    QString m_workingDirectory;
+    QHash<QString, CachedTemplate> m_cache;
+};
+
+#endif // SYSTEMCGENERATOR_H
@@ -0,0 +1,53 @@
+// TestbenchExporter.h
+#ifndef TESTBENCHEXPORTER_H
+#define TESTBENCHEXPORTER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class Netlist;
+
+/**
+ * @brief Writes the schematic's netlist out as a SystemC sc_main
+ *
+ * The generated file declares one sc_signal per net (typed like the driving
+ * port), an sc_clock for undriven clock inputs, one instance per component or
+ * Verilated RTL module and binds every declared port. Each of these lives in
+ * a "// SCV BEGIN <section>" ... "// SCV END <section>" block; an export
+ * rewrites only the blocks whose text changed and leaves the rest of the
+ * file, including user code outside the blocks, alone. If nothing changed
+ * the file is not touched, so its timestamp does not trigger a rebuild.
+ */
+class TestbenchExporter
+{
+public:
+    struct Result {
+        bool ok = false;
+        QString filePath;
+        QStringList changedSections;     ///< Empty if the file was already up to date
+        QStringList warnings;            ///< From the netlist
+        QString errorString;
+    };
+
+    explicit TestbenchExporter(const QString& workingDirectory);
+
+    Result exportNetlist(const Netlist& netlist);
+
+    /**
+     * @brief Section bodies for @p netlist, keyed by section name
+     */
+    static QHash<QString, QString> renderSections(const Netlist& netlist);
+    static QStringList sectionNames();
+
+    static constexpr const char* FILE_NAME = "sc_main.cpp";
+    static constexpr int CLOCK_PERIOD_NS = 10;
+
+private:
+    static QString skeleton(const QHash<QString, QString>& sections);
+    static bool replaceSection(QString* text, const QString& name, const QString& body, bool* changed);
+
+    QString m_workingDirectory;
+};
+
+#endif // TESTBENCHEXPORTER_H
@@ -0,0 +1,127 @@
+// TopSvModel.h
+#ifndef TOPSVMODEL_H
+#define TOPSVMODEL_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Token-level model of top.sv for batched instance edits
+ *
+ * load() tokenizes the file once - comments, strings, compiler directives
+ * and escaped identifiers are single tokens, so a "module" inside a comment
+ * does not count - finds the top module and records every instantiation in
+ * its body. Instances added by the tool live between "// SCV BEGIN instances"
+ * and "// SCV END instances"; the region is created just before endmodule on
+ * the first edit. addInstance(), setConnections() and removeInstance() only
+ * queue changes; flush() applies them, regenerates the managed region and
+ * writes the file once, leaving every byte outside the region as it was.
+ * Instances written by hand elsewhere in the module are known, so they are
+ * not added a second time, but they are never edited.
+ *
+ * If the file changed on disk since it was parsed, flush() parses it again
+ * before applying the queued edits.
+ */
+class TopSvModel
+{
+public:
+    struct Connection {
+        QString port;                    ///< Empty for a positional connection
+        QString signal;                  ///< Connected expression
+    };
+
+    struct Instance {
+        QString module;
+        QString name;
+        QVector<Connection> connections;
+        bool wildcard = false;           ///< Has a ".*" connection
+        bool managed = false;            ///< Inside the managed region
+    };
+
+    explicit TopSvModel(const QString& filePath, const QString& moduleName = "top");
+
+    bool load(QString* error = nullptr);
+    bool isLoaded() const { return m_loaded; }
+    QString filePath() const { return m_filePath; }
+
+    bool hasInstance(const QString& name) const { return m_instanceIndex.contains(name); }
+    const Instance* instance(const QString& name) const;
+    QStringList instanceNames() const;   ///< In file order, managed ones last
+
+    /**
+     * @brief Queues an instance; without connections it is bound with ".*"
+     */
+    void addInstance(const QString& module, const QString& name, const QVector<Connection>& connections = {});
+    void setConnections(const QString& name, const QVector<Connection>& connections);
+    void removeInstance(const QString& name);
+    int pendingEdits() const { return m_edits.size(); }
+
+    /**
+     * @brief Applies the queued edits and writes the file if its text changed
+     */
+    bool flush(QString* error = nullptr);
+
+    static constexpr const char* REGION_BEGIN = "// SCV BEGIN instances";
+    static constexpr const char* REGION_END = "// SCV END instances";
+
+private:
+    enum class TokenType {
+        Identifier,
+        Number,
+        String,
+        Symbol,
+        Comment,
+        Directive
+    };
+
+    struct Token {
+        TokenType type;
+        int start;
+        int length;
+    };
+
+    struct Edit {
+        enum Kind { Add, Connect, Remove } kind;
+        Instance instance;
+    };
+
+    static QVector<Token> tokenize(const QString& text);
+    bool parse(QString* error);
+    void parseBody(int first, int last);
+    int parseInstance(int index, int last, Instance* instance) const;
+    void parseConnections(int open, int close, Instance* instance) const;
+    int nextSignificant(int index, int last) const;
+    int matching(int open, int last) const;
+    bool isSymbol(int index, QChar symbol) const;
+    QStringView tokenText(int index) const;
+    QString textBetween(int first, int last) const;
+    int lineStart(int offset) const;
+    int lineEnd(int offset) const;
+
+    void applyEdit(const Edit& edit);
+    QString renderRegion() const;
+    QString renderInstance(const Instance& instance) const;
+    bool changedOnDisk() const;
+
+    QString m_filePath;
+    QString m_moduleName;
+    bool m_loaded = false;
+    QString m_text;
+    QVector<Token> m_tokens;
+    QDateTime m_lastModified;
+    qint64 m_size = -1;
+
+    QVector<Instance> m_instances;
+    QHash<QString, int> m_instanceIndex;
+    int m_regionStart = -1;              ///< First character of the region body
+    int m_regionEnd = -1;                ///< Start of the END marker's line
+    int m_insertAt = -1;                 ///< Where a new region goes: before endmodule
+    bool m_insertNewline = false;        ///< endmodule shares its line with other code
+    QString m_indent;
+    QVector<Edit> m_edits;
+};
+
+#endif // TOPSVMODEL_H
@@ -0,0 +1,107 @@
+// AutoPlacement.h
+#ifndef AUTOPLACEMENT_H
+#define AUTOPLACEMENT_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QPointer>
+#include <QPointF>
+#include <QSizeF>
+#include <QVector>
+
+class QGraphicsItem;
+class ReadyComponentGraphicsItem;
+class SchematicScene;
+
+/**
+ * @brief Layered placement of a scene's components along their signal flow
+ *
+ * Components and blocks are laid out left to right in layers, Sugiyama
+ * style: cycles are broken, every component goes one layer right of the
+ * furthest component driving it, the order within each layer is improved
+ * by barycenter sweeps to cut wire crossings, and the layers are stacked on
+ * the 20px grid. Incremental placement leaves the placed items alone and
+ * only puts new ones next to what they connect to, or where they are if
+ * they connect to nothing, then nudges them off anything they overlap.
+ *
+ * The layout runs on a snapshot in a worker thread; the positions are
+ * applied as one scene transaction, so they cost one write and one undo
+ * step. Items deleted meanwhile, or taken out of the scene, are skipped.
+ * Requests made while a layout runs are merged into the next one.
+ */
+class AutoPlacement : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode { All, NewItems };
+
+    struct Node {
+        QSizeF size;
+        QPointF position;          ///< Top-left corner of the scene bounding rect
+        bool movable = true;
+    };
+
+    struct Graph {
+        QVector<Node> nodes;
+        QVector<QPair<int, int>> edges;   ///< Driving node (output) to driven node (input)
+    };
+
+    explicit AutoPlacement(SchematicScene* scene);
+
+    void placeAll();
+
+    /**
+     * @brief Place @p items next to what they connect to
+     * @param undoable False to move them without an undo step, as when they are being loaded
+     */
+    void placeNew(const QList<QGraphicsItem*>& items, bool undoable = true);
+
+    /**
+     * @brief placeNew() those of @p items that overlap another component or block
+     *
+     * For items loaded at stale or default positions, which would otherwise stack up.
+     */
+    void placeOverlapping(const QList<QGraphicsItem*>& items, bool undoable = true);
+
+    bool isRunning() const { return m_watcher.isRunning(); }
+
+    /**
+     * @brief Compute the layout of @p graph; thread-safe, touches no items
+     * @return New top-left position of every node, in node order
+     */
+    static QVector<QPointF> layout(const Graph& graph, Mode mode);
+
+    static constexpr qreal GRID = 20.0;
+    static constexpr qreal LAYER_SPACING = 120.0;
+    static constexpr qreal NODE_SPACING = 40.0;
+
+signals:
+    void finished(int moved);
+
+private:
+    SchematicScene* m_scene;
+    QFutureWatcher<QVector<QPointF>> m_watcher;
+
+    // The layout being computed
+    Graph m_graph;
+    QVector<QPointer<ReadyComponentGraphicsItem>> m_items;   ///< Item of each node; null once deleted
+    QVector<QPointF> m_offsets;            ///< Item position minus bounding rect corner
+    QVector<bool> m_undoable;              ///< Whether the node's move is recorded for undo
+
+    // Requests waiting for the running layout; the guard tells a deleted item from a new one at its address
+    struct PendingItem {
+        QPointer<ReadyComponentGraphicsItem> guard;
+        bool undoable = true;
+    };
+    bool m_pendingAll = false;
+    QHash<ReadyComponentGraphicsItem*, PendingItem> m_pendingNew;
+
+    void start();
+    void apply();
+};
+
+#endif // AUTOPLACEMENT_H
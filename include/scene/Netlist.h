@@ -0,0 +1,95 @@
+// Netlist.h
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "parsers/SvParser.h"  // Reuse Port and ModuleInfo
+
+class SchematicScene;
+class ReadyComponentGraphicsItem;
+
+/**
+ * @brief Port-level connectivity of a schematic
+ *
+ * Wires only know the positions of the ports they attach to; the netlist
+ * maps those positions back to the declared ports of each instance (from the
+ * component's .cpp file, or the ModuleInfo of an RTL module) and merges the
+ * wires into nets, so fan-out shows up as one net with several pins. Every
+ * declared port ends up on exactly one net; ports without a wire get a net of
+ * their own.
+ *
+ * Instances, pins and nets are sorted, so the same schematic always yields
+ * the same netlist regardless of scene item order.
+ */
+class Netlist
+{
+public:
+    struct Instance {
+        QString name;                    ///< Instance name, u_<id>
+        QString moduleName;              ///< SystemC class to instantiate
+        QString componentId;             ///< Component ID or RTL module name
+        QString sourceFile;              ///< File declaring moduleName, relative to the project
+        bool rtl = false;                ///< Verilated RTL module rather than a component
+        QList<Port> inputs;
+        QList<Port> outputs;
+    };
+
+    struct Pin {
+        int instance = -1;
+        Port::Direction direction = Port::Input;
+        int port = -1;                   ///< Index into the instance's inputs or outputs
+
+        bool operator==(const Pin& other) const;
+        bool operator<(const Pin& other) const;
+    };
+
+    struct Net {
+        QString name;
+        QString type;                    ///< SystemC value type, from the driver if there is one
+        QVector<Pin> pins;
+        int drivers = 0;                 ///< Output pins on the net
+        bool clock = false;              ///< Undriven and feeding a clock input
+        bool wired = false;              ///< At least one wire is on the net
+    };
+
+    /**
+     * @brief Builds the netlist of every component and RTL module in @p scene
+     */
+    static Netlist fromScene(SchematicScene* scene);
+
+    const QVector<Instance>& instances() const { return m_instances; }
+    const QVector<Net>& nets() const { return m_nets; }
+
+    /**
+     * @brief Connections that could not be mapped to a declared port
+     */
+    const QStringList& warnings() const { return m_warnings; }
+
+    const Port& port(const Pin& pin) const;
+    QString pinName(const Pin& pin) const;
+
+    static bool isClockPort(const Port& port);
+
+private:
+    struct Connection {
+        Pin from;
+        Pin to;
+        QString label;                   ///< Wire label, used as the net name
+    };
+
+    bool addInstance(ReadyComponentGraphicsItem* item, const QString& componentId, const QString& workingDirectory);
+    bool resolvePin(ReadyComponentGraphicsItem* item, const QPointF& position, Pin* pin);
+    void buildNets(const QVector<Connection>& connections);
+
+    QVector<Instance> m_instances;
+    QVector<Net> m_nets;
+    QStringList m_warnings;
+    QHash<ReadyComponentGraphicsItem*, int> m_instanceOfItem;  ///< Only while building
+};
+
+#endif // NETLIST_H
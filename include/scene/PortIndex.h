@@ -0,0 +1,65 @@
+// PortIndex.h
+#ifndef PORTINDEX_H
+#define PORTINDEX_H
+
+#include <QHash>
+#include <QPointF>
+#include <QVector>
+
+class ReadyComponentGraphicsItem;
+
+/**
+ * @brief Spatial hash of the scene positions of every component port
+ *
+ * The scene is divided into square cells of CELL_SIZE; each port is stored
+ * in the cell containing its scene position. Since the detection radius is
+ * smaller than a cell, portAt() reads at most four cells, so a hit test
+ * costs the same with ten components as with ten thousand.
+ *
+ * Components keep their own entries current: they call update() when they
+ * are added to the scene, move, rotate, resize or change their ports, and
+ * remove() when they leave it.
+ */
+class PortIndex
+{
+public:
+    struct Hit {
+        ReadyComponentGraphicsItem* item = nullptr;
+        QPointF port;                    ///< In the item's coordinates
+        bool isInput = false;
+
+        bool isValid() const { return item != nullptr; }
+    };
+
+    void update(ReadyComponentGraphicsItem* item);
+    void remove(ReadyComponentGraphicsItem* item);
+    void clear();
+
+    /**
+     * @brief Nearest port within @p radius of @p scenePos, confirmed by the item's own getPortAt()
+     */
+    Hit portAt(const QPointF& scenePos, qreal radius = DETECTION_RADIUS) const;
+
+    int size() const { return m_size; }
+
+    static constexpr qreal CELL_SIZE = 32.0;
+    static constexpr qreal DETECTION_RADIUS = 15.0;   ///< ComponentPortManager::PORT_DETECTION_RADIUS
+
+private:
+    struct Entry {
+        ReadyComponentGraphicsItem* item;
+        QPointF port;
+        QPointF scenePos;
+        bool isInput;
+    };
+
+    static quint64 cellKey(int column, int row);
+    static int cellOf(qreal coordinate);
+    void insert(ReadyComponentGraphicsItem* item, const QPointF& port, bool isInput);
+
+    QHash<quint64, QVector<Entry>> m_cells;
+    QHash<ReadyComponentGraphicsItem*, QVector<quint64>> m_cellsOfItem;
+    int m_size = 0;
+};
+
+#endif // PORTINDEX_H
@@ -0,0 +1,62 @@
+// RubberBandSelection.h
+#ifndef RUBBERBANDSELECTION_H
+#define RUBBERBANDSELECTION_H
+
+#include <QObject>
+#include <QPointF>
+#include <QRectF>
+#include <QSet>
+#include <QTimer>
+
+class QGraphicsItem;
+class QGraphicsScene;
+
+/**
+ * @brief Incremental rubber-band selection
+ *
+ * QGraphicsScene::setSelectionArea() re-tests every item under the whole
+ * rectangle on each mouse move. Here only the strips between the previous
+ * and the current rectangle are queried from the scene's index - an item
+ * whose selection can change must touch one of them - and only items whose
+ * state actually flips are toggled. An item counts as inside when its shape
+ * intersects the rectangle, as with setSelectionArea().
+ *
+ * In additive mode (Ctrl held) items selected before the drag stay selected.
+ * The scene's per-item selectionChanged() emissions are suppressed while
+ * toggling; selectionChanged() is emitted at most once per frame instead,
+ * and once more from finish() if a change is still pending.
+ */
+class RubberBandSelection : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RubberBandSelection(QGraphicsScene* scene, QObject* parent = nullptr);
+
+    void begin(const QPointF& origin, bool additive);
+    void update(const QPointF& currentPos);
+    void finish();
+
+    bool isActive() const { return m_active; }
+    QRectF rect() const { return m_rect; }
+
+    static constexpr int FRAME_INTERVAL_MS = 16;
+
+signals:
+    void selectionChanged();
+
+private:
+    bool toggle(const QRectF& region);
+    static bool isInside(QGraphicsItem* item, const QRectF& rect);
+    static int subtract(const QRectF& a, const QRectF& b, QRectF* out);
+
+    QGraphicsScene* m_scene;
+    QPointF m_origin;
+    QRectF m_rect;
+    QSet<QGraphicsItem*> m_base;         ///< Selected before an additive drag
+    QSet<QGraphicsItem*> m_visited;      ///< Items tested during the current update
+    bool m_active = false;
+    QTimer m_notifyTimer;
+};
+
+#endif // RUBBERBANDSELECTION_H
@@ -0,0 +1,56 @@
+// SceneItemRegistry.h
+#ifndef SCENEITEMREGISTRY_H
+#define SCENEITEMREGISTRY_H
+
+#include <QHash>
+#include <QVector>
+
+class QGraphicsItem;
+class ReadyComponentGraphicsItem;
+class ModuleGraphicsItem;
+class WireGraphicsItem;
+class TextGraphicsItem;
+class BlockGraphicsItem;
+
+/**
+ * @brief The schematic items of one scene, by category, in flat arrays
+ *
+ * Items are filed by their QGraphicsItem::type() when they enter the scene
+ * and taken out again when they leave it or are deleted, both in constant
+ * time: a removed item's slot is filled with the last item of its array.
+ * The arrays are therefore in no particular order. components() holds the
+ * modules too, which are also listed in modules(); blocks are only listed
+ * in blocks(), as they stand for components rather than being one.
+ */
+class SceneItemRegistry
+{
+public:
+    void add(QGraphicsItem* item);
+    void remove(QGraphicsItem* item);
+    void clear();
+
+    const QVector<ReadyComponentGraphicsItem*>& components() const { return m_components.items; }
+    const QVector<ModuleGraphicsItem*>& modules() const { return m_modules.items; }
+    const QVector<WireGraphicsItem*>& wires() const { return m_wires.items; }
+    const QVector<TextGraphicsItem*>& texts() const { return m_texts.items; }
+    const QVector<BlockGraphicsItem*>& blocks() const { return m_blocks.items; }
+
+private:
+    template <typename T>
+    struct Category {
+        QVector<T*> items;
+        QHash<const QGraphicsItem*, int> positions;
+
+        void add(const QGraphicsItem* key, T* item);
+        void remove(const QGraphicsItem* key);
+        void clear();
+    };
+
+    Category<ReadyComponentGraphicsItem> m_components;
+    Category<ModuleGraphicsItem> m_modules;
+    Category<WireGraphicsItem> m_wires;
+    Category<TextGraphicsItem> m_texts;
+    Category<BlockGraphicsItem> m_blocks;
+};
+
+#endif // SCENEITEMREGISTRY_H
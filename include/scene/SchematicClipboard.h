@@ -0,0 +1,53 @@
+// SchematicClipboard.h
+#ifndef SCHEMATICCLIPBOARD_H
+#define SCHEMATICCLIPBOARD_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPointF>
+
+class QGraphicsItem;
+class SchematicScene;
+
+/**
+ * @brief Copy and paste of schematic subgraphs
+ *
+ * serialize() packs components, RTL modules, text items and the wires
+ * running between the packed components into a compact QDataStream
+ * payload, published on the system clipboard under MIME_TYPE. Components
+ * are referred to by their index in the payload rather than by ID, so
+ * paste() gives every copy a fresh component ID or RTL module name and
+ * reconnects the wires among the copies - in the same project or in
+ * another one. An RTL module carries its parsed ports along, so pasting it
+ * does not need to re-read the source file.
+ *
+ * paste() is one scene transaction: the component files are generated in
+ * one batch, meta.json is written once and the wires form one undo step.
+ */
+class SchematicClipboard
+{
+public:
+    static constexpr const char* MIME_TYPE = "application/x-scv-schematic";
+
+    /**
+     * @brief Pack @p items; items that cannot be copied are left out
+     * @return Payload, or an empty array when nothing could be copied
+     */
+    static QByteArray serialize(const QList<QGraphicsItem*>& items);
+
+    /**
+     * @brief Insert the items of @p payload into @p scene, moved by @p offset, and select them
+     * @return The new items; empty if the payload is empty or invalid
+     */
+    static QList<QGraphicsItem*> paste(SchematicScene* scene, const QByteArray& payload, const QPointF& offset);
+
+    // System clipboard
+    static void copyToClipboard(const QByteArray& payload);
+    static QByteArray clipboardPayload();
+
+private:
+    static constexpr quint32 MAGIC = 0x53435643;   // "SCVC"
+    static constexpr quint16 VERSION = 2;
+};
+
+#endif // SCHEMATICCLIPBOARD_H
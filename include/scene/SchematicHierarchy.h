@@ -0,0 +1,64 @@
+// SchematicHierarchy.h
+#ifndef SCHEMATICHIERARCHY_H
+#define SCHEMATICHIERARCHY_H
+
+#include <QList>
+
+class QGraphicsItem;
+class SchematicScene;
+class BlockGraphicsItem;
+class WireGraphicsItem;
+
+/**
+ * @brief Collapsing schematic regions into blocks and expanding them again
+ *
+ * A scene shows one level of the hierarchy: the top level, or the inside of
+ * the block named by SchematicScene::blockName(). load() fills a scene with
+ * just the components, RTL modules and blocks of its level, so a closed
+ * block costs one item however much it holds; its contents are loaded when
+ * BlockGraphicsItem::childScene() is first asked for.
+ *
+ * Collapsing and expanding only rewrite blocks.json - the components,
+ * their files and their connections stay as they are - and move the items
+ * between the scene and the block's own scene without reloading either.
+ * Both, like deleting a block, are undoable commands.
+ */
+class SchematicHierarchy
+{
+public:
+    static void load(SchematicScene* scene);
+    static void unload(SchematicScene* scene);    ///< Remove the level's items; texts and persistence stay
+
+    /**
+     * @brief Replace the components and blocks among @p items by one new block
+     * @return The block, selected; nullptr if @p items holds nothing to collapse
+     */
+    static BlockGraphicsItem* collapse(SchematicScene* scene, const QList<QGraphicsItem*>& items);
+
+    /**
+     * @brief Put the contents of @p block back into @p scene, where the block stands
+     */
+    static void expand(SchematicScene* scene, BlockGraphicsItem* block);
+
+    /**
+     * @brief Delete @p block together with everything inside it
+     */
+    static void remove(SchematicScene* scene, BlockGraphicsItem* block);
+
+    /**
+     * @brief Take @p wire out of its scene and delete it, leaving its connection record alone
+     */
+    static void discardWire(WireGraphicsItem* wire);
+
+    /**
+     * @brief Take @p wire out of its scene and off its components, leaving its connection record alone
+     */
+    static void takeWire(WireGraphicsItem* wire);
+
+    /**
+     * @brief Put a wire taken out by takeWire() into @p scene, reconnected to its components
+     */
+    static void placeWire(SchematicScene* scene, WireGraphicsItem* wire);
+};
+
+#endif // SCHEMATICHIERARCHY_H
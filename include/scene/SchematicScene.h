@@ -14,6 +14,8 @@
  * - Persistence management
  * - Intelligent wire routing and collision detection
  * - Selection rectangle for multi-item selection
+ * - Hierarchy: a scene shows the top level or the inside of one block
+ * - Unbounded canvas: the scene rect grows in tiles as items near its edge
  * 
  * Architecture:
  * - WireManager: Handles intelligent wire routing and organization
@@ -31,12 +33,21 @@
 #include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsSceneContextMenuEvent>
+#include <QPointer>
 #include <memory>
+#include "scene/SceneItemRegistry.h"
 
 class ReadyComponentGraphicsItem;
 class ModuleGraphicsItem;
 class WireGraphicsItem;
+class TextGraphicsItem;
+class BlockGraphicsItem;
 class WireManager;
+class PortIndex;
+class RubberBandSelection;
+class UndoHistory;
+class AutoPlacement;
+class QUndoCommand;
 
 /**
  * @class SchematicScene
@@ -92,6 +103,120 @@ public:
      */
     WireManager* getWireManager() const { return m_wireManager.get(); }
     
+    /**
+     * @brief Get the port hit-test index
+     * @return Spatial hash of the scene positions of all component ports
+     * 
+     * Components update their own entries as they move, resize or change
+     * ports; wire drawing looks ports up here instead of scanning items.
+     */
+    PortIndex* portIndex() const { return m_portIndex.get(); }
+    
+    // Schematic items by category, in no particular order; components() includes the modules
+    const QVector<ReadyComponentGraphicsItem*>& components() const { return m_items.components(); }
+    const QVector<ModuleGraphicsItem*>& modules() const { return m_items.modules(); }
+    const QVector<WireGraphicsItem*>& wires() const { return m_items.wires(); }
+    const QVector<TextGraphicsItem*>& texts() const { return m_items.texts(); }
+    const QVector<BlockGraphicsItem*>& blocks() const { return m_items.blocks(); }
+    
+    // Canvas
+    /**
+     * @brief Bounding rectangle of the components, blocks and texts
+     * 
+     * Grown as items are added and moved, recomputed after removals and
+     * drags, so reading it rarely walks the items. The minimap frames it
+     * instead of the scene rect, which only ever grows.
+     */
+    QRectF contentBounds() const;
+    
+    /**
+     * @brief Layered placement of the scene's components along their signal flow
+     * 
+     * Runs in the background; Ctrl+Shift+L places everything, dropped
+     * components and stacked RTL modules are moved off what they overlap.
+     */
+    AutoPlacement* autoPlacement() const { return m_autoPlacement; }
+    
+    // Hierarchy
+    /**
+     * @brief Name of the block whose inside the scene shows; empty for the top level
+     * 
+     * Set once, before the scene is loaded. Components added to the scene
+     * are moved into this block in persistence.
+     */
+    QString blockName() const { return m_blockName; }
+    void setBlockName(const QString& name) { m_blockName = name; }
+    
+    /**
+     * @brief The block item named @p name in this scene, or nullptr
+     */
+    BlockGraphicsItem* blockItem(const QString& name) const;
+    
+    /**
+     * @brief Put the contents of the block named @p name back in its place
+     */
+    void expandBlock(const QString& name);
+    
+    /**
+     * @brief Keep the item registries of the scenes @p item moves between up to date
+     * 
+     * Called by the schematic items from itemChange(), and untrackItem() from
+     * their destructors; items outside a SchematicScene are ignored.
+     */
+    static void trackItem(QGraphicsItem* item, QGraphicsItem::GraphicsItemChange change);
+    static void untrackItem(QGraphicsItem* item);
+    
+    // Undo/redo
+    /**
+     * @brief Set the history edits made in this scene are recorded on
+     * @param history Undo history, owned by the caller; nullptr records nothing
+     */
+    void setUndoHistory(UndoHistory* history);
+    UndoHistory* undoHistory() const;
+    
+    /**
+     * @brief Run a command and record it on the undo history
+     * @param command Command to run; ownership is taken
+     * 
+     * Without a history the command is run and deleted.
+     */
+    void pushCommand(QUndoCommand* command);
+    
+    /**
+     * @brief pushCommand() on @p scene if it is a SchematicScene, otherwise run and delete @p command
+     */
+    static void execute(QGraphicsScene* scene, QUndoCommand* command);
+    
+    // Transactions
+    /**
+     * @brief Open a transaction around a multi-item edit
+     * @param text Undo text; commands pushed until the matching commitTransaction() form one undo step
+     * 
+     * Until the outermost transaction is committed, persistence writes are
+     * batched, WireManager bookkeeping is deferred, the views do not repaint
+     * and selectionChanged() is held back, so an edit touching n items costs
+     * one write, one routing pass and one repaint. Transactions nest.
+     */
+    void beginTransaction(const QString& text = QString());
+    void commitTransaction();
+    bool isInTransaction() const { return m_transactionDepth > 0; }
+    
+    /**
+     * @brief Scoped beginTransaction()/commitTransaction() pair
+     */
+    class Transaction
+    {
+    public:
+        explicit Transaction(SchematicScene* scene, const QString& text = QString())
+            : m_scene(scene) { m_scene->beginTransaction(text); }
+        ~Transaction() { if (m_scene) m_scene->commitTransaction(); }
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+        
+    private:
+        QPointer<SchematicScene> m_scene;
+    };
+    
     
     // Scene management with persistence cleanup
     /**
@@ -102,6 +227,23 @@ public:
      */
     void clearSceneWithPersistenceCleanup();
     void clearSceneWithExplicitDeletion();
+    
+    // Width checks
+    /**
+     * @brief Compare the bit widths of the two ports a wire joins
+     * @param wire Wire to check
+     * @return False if both widths are known and differ
+     * 
+     * Marks a mismatching wire with the Error state and clears the state
+     * again once the widths agree; Locked wires keep their state.
+     */
+    bool checkWireWidth(WireGraphicsItem* wire);
+    
+    /**
+     * @brief Check every wire in one pass
+     * @return Number of wires joining ports of different widths
+     */
+    int checkAllWireWidths();
 
 signals:
     /**
@@ -109,6 +251,29 @@ signals:
      * @param position The scene position where text should be added
      */
     void addTextRequested(const QPointF& position);
+    
+    /**
+     * @brief Signal emitted when the source of an RTL module should be shown
+     * @param moduleName Name of the module definition to open
+     */
+    void moduleDefinitionRequested(const QString& moduleName);
+    
+    /**
+     * @brief Signal emitted when a new wire joins ports of different widths
+     * @param message Description of the mismatch, for the status bar
+     */
+    void wireWidthMismatch(const QString& message);
+    
+    /**
+     * @brief Signal emitted when the inside of a block should be shown
+     * @param block Block to open; its childScene() is the scene to show
+     */
+    void blockOpenRequested(BlockGraphicsItem* block);
+    
+    /**
+     * @brief Signal emitted when the view should return from this block to its parent
+     */
+    void blockExitRequested();
 
 protected:
     void drawBackground(QPainter *painter, const QRectF &rect) override;
@@ -128,22 +293,67 @@ private:
     bool m_wireSourceIsInput = false;  // Whether the source port is an input or output
     WireGraphicsItem* m_temporaryWire = nullptr;
     
+    // Port under the cursor while drawing a wire; only this one is highlighted
+    QPointer<ReadyComponentGraphicsItem> m_highlightedItem;
+    QPointF m_highlightedPort;
+    
     // Selection rectangle
     bool m_isSelecting = false;
     QPointF m_selectionStart;
     QGraphicsRectItem* m_selectionRect = nullptr;
+    RubberBandSelection* m_rubberBand = nullptr;
+    
+    // Clipboard; copies are serialized onto the system clipboard
+    int m_pasteCount = 0;                      ///< Pastes since the last copy
+    static constexpr qreal PASTE_OFFSET = 50.0;
+    
+    // Undo history and the item drag it is recording
+    QPointer<UndoHistory> m_undoHistory;
+    QList<QGraphicsItem*> m_dragItems;
+    QGraphicsItem* m_dragAnchor = nullptr;
+    QPointer<QObject> m_dragAnchorGuard;
+    QPointF m_dragAnchorPos;
+    int m_dragGesture = 0;
+    bool m_isDraggingItems = false;
+    
+    // Open transaction
+    int m_transactionDepth = 0;
+    bool m_transactionSignalsBlocked = false;   ///< Signals were already blocked when it began
+    QList<QPointer<QWidget>> m_frozenViewports;
+    
+    // Items by category
+    SceneItemRegistry m_items;
+    
+    // Block shown by this scene; empty at the top level
+    QString m_blockName;
+    
+    // Canvas: the scene rect is a union of whole tiles keeping CANVAS_MARGIN around the content
+    mutable QRectF m_contentBounds;
+    mutable bool m_contentBoundsDirty = false;
+    QRectF m_pendingCanvasBounds;               ///< Content placed during the open transaction
+    static constexpr qreal CANVAS_TILE = 2000.0;
+    static constexpr qreal CANVAS_MARGIN = 500.0;
+    
+    // BSP index depth: 2^depth leaves for about ITEMS_PER_BSP_LEAF items each
+    static constexpr int ITEMS_PER_BSP_LEAF = 8;
+    static constexpr int MIN_BSP_DEPTH = 5;
+    static constexpr int MAX_BSP_DEPTH = 12;
     
-    // Clipboard
-    QList<QGraphicsItem*> m_clipboard;
+    AutoPlacement* m_autoPlacement = nullptr;   ///< Child QObject
     
     // Wire management
     std::unique_ptr<WireManager> m_wireManager;
+    std::unique_ptr<PortIndex> m_portIndex;
     
     
-    ReadyComponentGraphicsItem* getComponentAt(const QPointF& pos);
-    ModuleGraphicsItem* getModuleAt(const QPointF& pos);
-    QPointF getPortAt(QGraphicsItem* item, const QPointF& scenePos, bool& isInput, bool& isModule);
     void addWireToItem(QGraphicsItem* item, WireGraphicsItem* wire, bool isModule);
+    void growCanvas(const QRectF& itemBounds);
+    void resetCanvas();
+    void updateIndexDepth();
+    void beginItemDrag();
+    void recordItemDrag();
+    void endItemDrag();
+    void highlightPort(ReadyComponentGraphicsItem* item, const QPointF& port);
     void removeWireFromItem(QGraphicsItem* item, WireGraphicsItem* wire, bool isModule);
     void selectAllItems();
     void updateSelectionRect(const QPointF& currentPos);
@@ -153,6 +363,8 @@ private:
     void cutSelectedItems();
     void pasteItems();
     void duplicateSelectedItems();
+    void collapseSelectedItems();
+    void expandSelectedBlocks();
 };
 
 #endif // SCHEMATICSCENE_H
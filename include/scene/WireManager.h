@@ -8,9 +8,11 @@
 #include <QRectF>
 #include <QMap>
 #include <QSet>
+#include <QVector>
 
 class WireGraphicsItem;
 class QGraphicsScene;
+class QTimer;
 
 /**
  * @brief Global wire manager for intelligent routing and organization
@@ -20,6 +22,7 @@ class QGraphicsScene;
  * - Intelligent routing algorithms
  * - Collision detection and avoidance
  * - Wire spacing and offset management
+ * - Crossing-aware channel and label layout around edits
  * - Z-order management for better visibility
  * - Wire bundling for parallel connections
  */
@@ -34,7 +37,15 @@ public:
     // Wire registration
     void registerWire(WireGraphicsItem* wire);
     void unregisterWire(WireGraphicsItem* wire);
-    QList<WireGraphicsItem*> getAllWires() const { return m_wires; }
+    QList<WireGraphicsItem*> getAllWires() const;
+    void clear();
+    
+    // Deferred bookkeeping: between beginUpdate() and the matching endUpdate(),
+    // removals are collected and applied in one pass and new wires are routed
+    // once at the end, with a single wireRoutesOptimized(). Updates nest.
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const { return m_updateDepth > 0; }
     
     // Intelligent routing
     void optimizeAllWireRoutes();
@@ -48,8 +59,21 @@ public:
     QList<WireGraphicsItem*> getWiresNearPoint(const QPointF& point, qreal radius = 20.0) const;
     bool areWiresOverlapping(WireGraphicsItem* wire1, WireGraphicsItem* wire2) const;
     
+    // Net layout
+    /**
+     * @brief Lay out the nets around @p region again once the edits there settle
+     * 
+     * Regions invalidated within LAYOUT_DELAY_MS of each other are laid out
+     * in one pass. The pass moves the middle segment of each auto-routed
+     * orthogonal wire near them to the track crossing and running alongside
+     * the fewest other nets, then puts the wires' labels where they cover
+     * the fewest labels, components and wires. Wires routed or offset by
+     * hand, locked or not orthogonal are obstacles only.
+     */
+    void invalidateLayout(const QRectF& region);
+    
     // Wire spacing and offset
-    void applyWireSpacing();
+    void applyWireSpacing();   ///< Net layout of every wire, at once
     qreal calculateWireOffset(WireGraphicsItem* wire, const QPointF& point) const;
     void bundleParallelWires();
     
@@ -71,6 +95,9 @@ public:
     static constexpr qreal MIN_WIRE_SPACING = 4.0;
     static constexpr qreal MAX_WIRE_SPACING = 20.0;
     static constexpr qreal COLLISION_THRESHOLD = 5.0;
+    static constexpr int LAYOUT_DELAY_MS = 150;
+    static constexpr qreal LAYOUT_NEIGHBOURHOOD = 60.0;   ///< Wires this close to an edit are laid out with it
+    static constexpr int MAX_TRACKS = 8;                  ///< Tracks tried on each side of a wire's centre line
 
 public slots:
     void onWirePathChanged(WireGraphicsItem* wire);
@@ -83,7 +110,26 @@ signals:
 
 private:
     QGraphicsScene* m_scene;
-    QList<WireGraphicsItem*> m_wires;
+    mutable QList<WireGraphicsItem*> m_wires;
+    QSet<WireGraphicsItem*> m_wireSet;
+    
+    // Deferred bookkeeping
+    int m_updateDepth = 0;
+    mutable QSet<WireGraphicsItem*> m_pendingRemovals;   ///< Still in m_wires, gone from m_wireSet
+    QList<WireGraphicsItem*> m_pendingRoutes;
+    
+    const QList<WireGraphicsItem*>& wires() const;
+    
+    // Net layout
+    QTimer* m_layoutTimer;
+    QList<QRectF> m_dirtyRegions;
+    
+    void layoutDirtyNets();
+    void layoutNets(QVector<WireGraphicsItem*> batch);
+    bool isAutoRouted(WireGraphicsItem* wire) const;
+    bool assignChannel(WireGraphicsItem* wire);
+    void placeLabel(WireGraphicsItem* wire);
+    QVector<WireGraphicsItem*> wiresIn(const QRectF& region, WireGraphicsItem* exclude = nullptr) const;
     
     // Configuration
     bool m_autoRoutingEnabled;
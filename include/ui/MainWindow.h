@@ -32,10 +32,10 @@
 
 #include <QGraphicsScene>
 #include <QMainWindow>
-#include <QUndoStack>
 #include <QFileSystemWatcher>
 #include <QListWidgetItem>
 #include "scene/SchematicScene.h"
+#include "parsers/SvParser.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -49,9 +49,14 @@ class FileManager;
 class RecentProjectsManager;
 class WidgetManager;
 class TextItemManager;
+class SymbolIndex;
+class QuickOpenIndex;
+class UndoHistory;
+class BlockGraphicsItem;
 #include "ui/widgets/ComponentLibraryWidget.h"
 #include "ui/widgets/FileExplorerTreeWidget.h"
 #include "ui/widgets/TerminalSectionWidget.h"
+#include "build/BuildOrchestrator.h"
 
 /**
  * @class MainWindow
@@ -82,15 +87,18 @@ public:
      */
     ~MainWindow();
     
-    QUndoStack* undoStack() { return m_undoStack; }
+    UndoHistory* undoHistory() { return m_undoHistory; }
     SchematicScene* schematicScene() { return scene; }
     QString currentDirectory() const { return currentRtlDirectory; }
     WidgetManager* widgetManager() { return m_widgetManager; }
+    SymbolIndex* symbolIndex() { return m_symbolIndex; }
+    QuickOpenIndex* quickOpenIndex() { return m_quickOpenIndex; }
     
     // Public methods for managers to use
     void openFileInTab(const QString& filePath);
     void loadProject(const QString& projectPath);
     void refreshComponent(const QString& filePath);
+    void applyComponentPorts(const QString& filePath, const ModuleInfo& moduleInfo);
     void refreshModuleView(const QString& filePath);
 
 private:
@@ -100,7 +108,7 @@ private:
     bool m_isLoadingProject;      // Flag to prevent multiple simultaneous loading operations
     
     // Undo/Redo
-    QUndoStack *m_undoStack;
+    UndoHistory *m_undoHistory;
     
     // File Watcher for RTL changes
     QFileSystemWatcher *m_fileWatcher;
@@ -112,10 +120,21 @@ private:
     WidgetManager *m_widgetManager;
     TextItemManager *m_textItemManager;
     
+    // Project-wide symbol index for go-to-definition and the symbol palette
+    SymbolIndex *m_symbolIndex;
+    QuickOpenIndex *m_quickOpenIndex;
+    
     // UI Components
     ComponentLibraryWidget *m_componentLibrary;
     FileExplorerTreeWidget *m_fileExplorerTree;
     TerminalSectionWidget *m_terminalSection;
+    
+    // Scenes of the blocks opened on the way to the one shown, outermost first; empty at the top level
+    QList<SchematicScene*> m_openBlockScenes;
+    
+    // Incremental testbench build on the terminal section's job runner
+    BuildOrchestrator *m_buildOrchestrator = nullptr;
+    bool m_runAfterBuild = false;
 
     // Setup methods
     void setupUndoRedo();
@@ -126,10 +145,23 @@ private:
     void setupControlButtonsWidget();
     void setupTerminalSection();
     void setupTerminalMenuActions();
+    void setupNavigationActions();
+    void setupExportActions();
+    void setupBuildActions();
     void loadProjectInternal(const QString& projectPath);
     
+    // Block hierarchy navigation
+    void openBlock(BlockGraphicsItem* block);
+    void leaveBlock();
+    void showScene(SchematicScene* shown);
+    
     // Control button actions
     void executeMakeVerilate();
+    void exportTestbench();
+    void buildTestbench(bool run);
+    void onBuildFinished(const BuildOrchestrator::Result& result);
+    void runSimulation(const QString& executable);
+    ReadyComponentGraphicsItem* findComponentForFile(const QString& filePath) const;
     
 protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
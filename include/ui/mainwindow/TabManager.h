@@ -5,9 +5,14 @@
 #include <QObject>
 #include <QMap>
 #include <QString>
+#include <QVector>
 
 class QTabWidget;
 class MainWindow;
+class CodeEditorWidget;
+class SymbolPalette;
+class QuickOpenPalette;
+struct SymbolLocation;
 
 class TabManager : public QObject
 {
@@ -18,6 +23,13 @@ public:
     
     void setupTabWidget();
     void openFileInTab(const QString& filePath);
+    
+    // Symbol navigation through the project SymbolIndex
+    void openFileAtLocation(const QString& filePath, int line, int column = 1);
+    void goToDefinition(const QString& name);
+    void findReferences(const QString& name);
+    void showSymbolPalette();
+    void showQuickOpen();
 
 private slots:
     void onTabCloseRequested(int index);
@@ -28,6 +40,14 @@ private:
     MainWindow* m_mainWindow;
     QTabWidget* m_tabWidget;
     QMap<QString, int> m_openFileTabs;  // Maps file path to tab index
+    SymbolPalette* m_symbolPalette;     // Created on first use
+    QuickOpenPalette* m_quickOpenPalette;
+    int m_referencesRequest;            // Latest findReferences() request; older replies are dropped
+    
+    void onReferencesFound(int requestId, const QString& name, const QVector<SymbolLocation>& locations);
+    CodeEditorWidget* editorForFile(const QString& filePath) const;
+    void attachLivePortParser(CodeEditorWidget* editor);
+    SymbolPalette* symbolPalette();
 };
 
 #endif // TABMANAGER_H
@@ -3,6 +3,7 @@
 #define WIDGETMANAGER_H
 
 #include <QObject>
+#include <QMetaObject>
 
 class MainWindow;
 class MinimapWidget;
@@ -10,6 +11,7 @@ class VerticalToolbar;
 class EditComponentWidget;
 class ControlButtonsWidget;
 class QGraphicsView;
+class QGraphicsScene;
 
 class WidgetManager : public QObject
 {
@@ -23,6 +25,7 @@ public:
     void setupEditComponentWidget();
     void setupControlButtons();
     void updateMinimapPosition();
+    void setMinimapScene(QGraphicsScene* scene);  // Follow the view into and out of blocks
     void updateSchematicOverlaysPosition();
     void setCurrentRtlDirectory(const QString& directory);
 
@@ -39,6 +42,7 @@ private:
     EditComponentWidget* m_editComponentWidget;
     ControlButtonsWidget* m_controlButtons;
     QString m_currentRtlDirectory;
+    QMetaObject::Connection m_sceneChangedConnection;
 };
 
 #endif // WIDGETMANAGER_H
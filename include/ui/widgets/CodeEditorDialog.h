@@ -9,7 +9,7 @@
 #include <QString>
 
 // Forward declaration
-class CppHighlighter;
+class CodeHighlighter;
 
 class CodeEditorDialog : public QDialog
 {
@@ -40,7 +40,7 @@ private:
     QLabel* m_statusLabel;
     bool m_modified;
     bool m_isLightTheme = false;
-    CppHighlighter* m_highlighter;
+    CodeHighlighter* m_highlighter;
     
     void setupUI();
     void loadCode();
@@ -7,9 +7,12 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QString>
+#include <QTimer>
+#include <QTextDocument>
 
 // Forward declaration
-class SyntaxHighlighter;
+class CodeHighlighter;
+class DocumentLoader;
 
 class CodeEditorWidget : public QWidget
 {
@@ -22,6 +25,24 @@ public:
     bool isModified() const;
     QString getFilePath() const { return m_filePath; }
     QString getFileName() const;
+    bool isLoading() const { return m_loading; }
+    bool isLargeFile() const { return m_largeFile; }
+    QTextDocument* document() const { return m_codeEditor->document(); }
+    
+    /**
+     * @brief Moves the cursor to a 1-based line and column and centres it;
+     *        applied once loading finishes if the file is still loading
+     */
+    void goToLine(int line, int column = 1);
+    QString identifierAtCursor() const;
+
+    // Files at least this big are read on a worker thread and inserted in chunks
+    static constexpr qint64 ASYNC_LOAD_THRESHOLD = 1024 * 1024;
+    // Above this, highlighting follows the viewport and line wrap/undo are off
+    static constexpr qint64 LARGE_FILE_THRESHOLD = 16 * 1024 * 1024;
+    static constexpr int INSERT_BUDGET_MS = 12;
+    static constexpr int HIGHLIGHT_MARGIN_BLOCKS = 50;
+    static constexpr int VIEWPORT_UPDATE_MS = 30;
 
 public slots:
     void onSaveClicked();
@@ -30,9 +51,18 @@ public slots:
 signals:
     void fileModified(bool modified);
     void fileSaved();
+    void loadFinished(bool ok);   ///< Emitted when an asynchronous load completes
+    void definitionRequested(const QString& identifier);
+    void referencesRequested(const QString& identifier);
 
 private slots:
     void onTextChanged();
+    void insertPendingChunks();
+    void onLoaderFinished(bool ok, const QString& errorString);
+    void updateHighlightWindow();
+    void requestDefinition();
+    void requestReferences();
+    void showContextMenu(const QPoint& pos);
 
 private:
     QString m_filePath;
@@ -43,10 +73,20 @@ private:
     QLabel* m_filePathLabel;
     bool m_modified;
     bool m_isLightTheme = false;
-    SyntaxHighlighter* m_highlighter;
+    CodeHighlighter* m_highlighter;
+    DocumentLoader* m_loader;
+    QTimer* m_insertTimer;
+    QTimer* m_viewportTimer;
+    bool m_loading = false;
+    bool m_loaderDone = false;
+    bool m_largeFile = false;
+    int m_pendingLine = 0;
+    int m_pendingColumn = 1;
     
     void setupUI();
     void loadCode();
+    void startAsyncLoad(qint64 fileSize);
+    void finishAsyncLoad();
     void saveCode();
     void applyCodeEditorStyle();
 };
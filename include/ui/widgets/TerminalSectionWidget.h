@@ -32,6 +32,7 @@
 #include <QListWidget>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
+#include <QTreeView>
 #include <QHeaderView>
 #include <QMenu>
 #include <QAction>
@@ -48,6 +49,11 @@
 #include <QLabel>
 #include <QProcessEnvironment>
 #include <QKeyEvent>
+#include "ui/widgets/terminal/ProblemsModel.h"
+#include "ui/widgets/terminal/DiagnosticExtractor.h"
+#include "ui/widgets/terminal/ScrollbackSearchBar.h"
+#include "ui/widgets/terminal/SessionCapture.h"
+#include "ui/widgets/terminal/JobRunnerTab.h"
 
 QT_BEGIN_NAMESPACE
 class QTextEdit;
@@ -81,6 +87,7 @@ public:
     void setWorkingDirectory(const QString& dir);
     QString workingDirectory() const;
     void clearTerminal();
+    ScrollbackSearchBar* searchBar() const { return m_searchBar; }
     
     // Environment
     void setEnvironmentVariable(const QString& name, const QString& value);
@@ -91,6 +98,17 @@ public:
     void saveSessionState();
     void restoreSessionState();
     bool hasUnsavedChanges() const;
+    
+    // Output capture to disk
+    void setCaptureEnabled(bool enabled);
+    bool isCaptureEnabled() const { return m_captureWriter != nullptr; }
+    QString captureDirectory() const;
+    QStringList captureFiles() const;
+    void exportCapture(const QString& targetPath);
+    
+    // Scrollback kept in the widget while capturing (older lines live on disk)
+    static constexpr int CAPTURED_SCROLLBACK_LINES = 5000;
+    static constexpr int SCROLLBACK_TRIM_SLACK = 500;
 
 signals:
     void sessionClosed();
@@ -99,6 +117,7 @@ signals:
     void commandExecuted(const QString& command);
     void outputReceived(const QString& output);
     void errorReceived(const QString& error);
+    void problemsDetected(const QVector<ProblemEntry>& problems);
 
 private slots:
     void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
@@ -118,6 +137,10 @@ private:
     void addToHistory(const QString& command);
     void navigateHistory(int direction);
     void setupShell();
+    void setupDiagnostics();
+    void trimScrollback();
+    QString captureBaseName() const;
+    void exportCaptureFiles(const QString& targetPath);
     void writeToTerminal(const QString& text, const QColor& color = QColor());
     void handleUserInput(const QString& input);
     void processCommand(const QString& command);
@@ -132,6 +155,7 @@ protected:
     // UI Components
     QVBoxLayout* m_layout;
     QTextEdit* m_terminal;
+    ScrollbackSearchBar* m_searchBar;
     QHBoxLayout* m_statusLayout;
     QLabel* m_statusLabel;
     QLabel* m_workingDirLabel;
@@ -145,6 +169,13 @@ protected:
     QProcess* m_process;
     QProcessEnvironment m_environment;
     bool m_isActive;
+    
+    // Diagnostics extraction (one line buffer per stream so they never interleave)
+    DiagnosticExtractor* m_stdoutDiagnostics;
+    DiagnosticExtractor* m_stderrDiagnostics;
+    
+    // Raw output capture (null while disabled)
+    SessionCaptureWriter* m_captureWriter;
     bool m_hasUnsavedChanges;
     
     // Command history and input
@@ -162,6 +193,9 @@ protected:
     QAction* m_copyAction;
     QAction* m_pasteAction;
     QAction* m_selectAllAction;
+    QAction* m_findAction;
+    QAction* m_captureAction;
+    QAction* m_exportCaptureAction;
     QAction* m_clearHistoryAction;
     QAction* m_testBashAction;
     
@@ -194,6 +228,7 @@ public:
 
 signals:
     void sessionCountChanged(int count);
+    void problemsDetected(const QVector<ProblemEntry>& problems);
 
 private slots:
     void onSessionClosed();
@@ -222,6 +257,10 @@ private:
 /**
  * @class ProblemsTab
  * @brief Problems tab for displaying compilation errors and warnings
+ * 
+ * Diagnostics are held by a ProblemsModel (flat record array plus trigram
+ * index) and shown grouped by file. Filter edits are debounced and evaluated
+ * on a worker thread, so large lint or build runs do not stall typing.
  */
 class ProblemsTab : public QWidget
 {
@@ -232,33 +271,41 @@ public:
     ~ProblemsTab();
 
     void addProblem(const QString& file, int line, int column, const QString& message, const QString& severity);
+    void addProblems(const QVector<ProblemEntry>& problems);
     void clearProblems();
     void setFilter(const QString& filter);
     int problemCount() const;
+    ProblemsModel* model() const { return m_model; }
 
 signals:
     void problemDoubleClicked(const QString& file, int line, int column);
 
 private slots:
-    void onProblemDoubleClicked(QTreeWidgetItem* item, int column);
+    void onProblemDoubleClicked(const QModelIndex& index);
     void onContextMenuRequested(const QPoint& pos);
     void onFilterChanged();
+    void onFilterApplied();
+    void onGroupsInserted(const QModelIndex& parent, int first, int last);
 
 private:
     void setupUI();
     void setupContextMenu();
     void updateProblemCount();
 
+    static constexpr int FILTER_DEBOUNCE_MS = 150;
+
     QVBoxLayout* m_layout;
     QHBoxLayout* m_filterLayout;
     QLineEdit* m_filterEdit;
+    QLabel* m_countLabel;
     QPushButton* m_clearButton;
-    QTreeWidget* m_problemsTree;
+    QTreeView* m_problemsView;
+    ProblemsModel* m_model;
+    QTimer* m_filterTimer;
     QMenu* m_contextMenu;
     QAction* m_clearAction;
     QAction* m_copyAction;
     QAction* m_goToFileAction;
-    int m_problemCount;
 };
 
 /**
@@ -276,9 +323,11 @@ public:
     void appendOutput(const QString& text);
     void clearOutput();
     void setOutput(const QString& text);
+    ScrollbackSearchBar* searchBar() const { return m_searchBar; }
 
 signals:
     void outputCleared();
+    void problemsDetected(const QVector<ProblemEntry>& problems);
 
 private slots:
     void onContextMenuRequested(const QPoint& pos);
@@ -292,10 +341,13 @@ private:
     QHBoxLayout* m_buttonLayout;
     QPushButton* m_clearButton;
     QTextEdit* m_outputText;
+    ScrollbackSearchBar* m_searchBar;
+    DiagnosticExtractor* m_diagnostics;
     QMenu* m_contextMenu;
     QAction* m_clearAction;
     QAction* m_copyAction;
     QAction* m_selectAllAction;
+    QAction* m_findAction;
 };
 
 /**
@@ -313,6 +365,7 @@ public:
     void appendDebugMessage(const QString& message, const QString& level = "INFO");
     void clearDebugMessages();
     void setDebugLevel(const QString& level);
+    ScrollbackSearchBar* searchBar() const { return m_searchBar; }
 
 signals:
     void debugMessageAdded(const QString& message, const QString& level);
@@ -332,10 +385,12 @@ private:
     QComboBox* m_levelCombo;
     QPushButton* m_clearButton;
     QTextEdit* m_debugText;
+    ScrollbackSearchBar* m_searchBar;
     QMenu* m_contextMenu;
     QAction* m_clearAction;
     QAction* m_copyAction;
     QAction* m_selectAllAction;
+    QAction* m_findAction;
     QString m_currentLevel;
 };
 
@@ -356,12 +411,14 @@ public:
     OutputTab* outputTab() const { return m_outputTab; }
     TerminalTab* terminalTab() const { return m_terminalTab; }
     DebugConsoleTab* debugConsoleTab() const { return m_debugConsoleTab; }
+    JobRunnerTab* jobRunnerTab() const { return m_jobRunnerTab; }
 
     // Convenience methods
     void showProblemsTab();
     void showOutputTab();
     void showTerminalTab();
     void showDebugConsoleTab();
+    void showJobsTab();
     void toggleVisibility();
 
 signals:
@@ -382,6 +439,7 @@ private:
     OutputTab* m_outputTab;
     TerminalTab* m_terminalTab;
     DebugConsoleTab* m_debugConsoleTab;
+    JobRunnerTab* m_jobRunnerTab;
     QMenu* m_contextMenu;
     QAction* m_toggleVisibilityAction;
     QAction* m_moveToPanelAction;
@@ -0,0 +1,140 @@
+// CodeHighlighter.h
+#ifndef CODEHIGHLIGHTER_H
+#define CODEHIGHLIGHTER_H
+
+#include <QSyntaxHighlighter>
+#include <QString>
+#include <QStringView>
+#include <QTextCharFormat>
+#include <QVector>
+
+/**
+ * @brief Static perfect-hash table from keyword to token kind
+ *
+ * Built once with hash-and-displace: keywords are spread over buckets by a
+ * first hash, and each bucket gets a displacement that moves all its keys to
+ * free slots. A lookup hashes the word once, mixes in the bucket's
+ * displacement and compares against a single slot - no probing, no regex.
+ */
+class KeywordTable
+{
+public:
+    struct Entry {
+        const char* word;
+        quint8 kind;
+    };
+
+    explicit KeywordTable(const QVector<Entry>& entries);
+
+    /**
+     * @brief Returns the kind of @p word, or -1 if it is not a keyword
+     */
+    int lookup(QStringView word) const;
+
+    int size() const { return m_count; }
+
+    static constexpr quint32 MAX_DISPLACEMENT = 1u << 16;
+
+private:
+    bool build(const QVector<QString>& keys, const QVector<quint8>& kinds, quint32 tableSize);
+    static quint32 hashWord(QStringView word);
+    static quint32 slotHash(quint32 hash, quint32 displacement);
+
+    QVector<QString> m_keys;
+    QVector<quint8> m_kinds;
+    QVector<quint32> m_displacements;
+    quint32 m_mask = 0;
+    int m_bucketCount = 1;
+    int m_count = 0;
+};
+
+/**
+ * @brief Single-pass highlighter for SystemVerilog and C++/SystemC sources
+ *
+ * Each block is scanned once, left to right, by a small hand-written lexer.
+ * Identifiers are classified through a KeywordTable of the active language;
+ * block comments, strings and preprocessor lines continued with a backslash
+ * carry over to the next block through the block state.
+ */
+class CodeHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+
+public:
+    enum Theme {
+        Light,
+        Monokai
+    };
+
+    enum Language {
+        SystemVerilog,
+        Cpp
+    };
+
+    enum TokenKind {
+        KeywordToken,
+        TypeToken,
+        PreprocessorToken,
+        CommentToken,
+        StringToken,
+        NumberToken,
+        TokenKindCount
+    };
+
+    explicit CodeHighlighter(QTextDocument* parent = nullptr, Language language = Cpp);
+
+    void setTheme(Theme theme);
+    Theme theme() const { return m_theme; }
+
+    void setLanguage(Language language);
+    Language language() const { return m_language; }
+
+    /**
+     * @brief Restricts highlighting to a window of blocks (large-file mode)
+     *
+     * Blocks outside the window are left unformatted and keep no block state,
+     * so inserting or editing text elsewhere never cascades through the
+     * document. A block comment opened above the window is not seen.
+     */
+    void setViewportOnly(bool enabled);
+    bool isViewportOnly() const { return m_viewportOnly; }
+
+    /**
+     * @brief Moves the viewport-only window and highlights the blocks in it
+     */
+    void setHighlightWindow(int firstBlock, int lastBlock);
+
+    /**
+     * @brief Picks the language profile from a file extension (.sv/.svh/.v/.vh -> SystemVerilog)
+     */
+    static Language languageForFile(const QString& filePath);
+
+    static const KeywordTable& keywordTable(Language language);
+
+protected:
+    void highlightBlock(const QString& text) override;
+
+private:
+    enum BlockState {
+        NormalState = 0,
+        CommentState = 1,
+        StringState = 2,
+        PreprocessorState = 3
+    };
+
+    void updateFormats();
+    void rehighlightWindow();
+    int scanString(const QString& text, int start, QChar quote, bool* closed) const;
+    int scanNumber(const QString& text, int start) const;
+    bool isSvNumberStart(const QString& text, int pos) const;
+
+    Theme m_theme;
+    Language m_language;
+    const KeywordTable* m_keywords;
+    QTextCharFormat m_formats[TokenKindCount];
+    bool m_viewportOnly = false;
+    int m_windowFirst = -1;
+    int m_windowLast = -1;
+};
+
+#endif // CODEHIGHLIGHTER_H
@@ -0,0 +1,69 @@
+// DocumentLoader.h
+#ifndef DOCUMENTLOADER_H
+#define DOCUMENTLOADER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <atomic>
+
+/**
+ * @brief Reads and decodes a text file on a worker thread, handing it over in chunks
+ *
+ * The worker reads READ_BLOCK_SIZE bytes at a time, decodes them as UTF-8,
+ * normalises line endings the way QIODevice::Text does and queues the result.
+ * The GUI thread drains the queue with takeChunk() at its own pace; when
+ * MAX_QUEUED_CHUNKS are waiting the worker blocks, so a slow consumer bounds
+ * the memory held in flight. finished() is posted after the last chunk was
+ * queued; the consumer keeps draining until takeChunk() returns false.
+ */
+class DocumentLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DocumentLoader(QObject* parent = nullptr);
+    ~DocumentLoader() override;
+
+    /**
+     * @brief Starts loading @p filePath, cancelling any load in progress
+     */
+    void start(const QString& filePath);
+    void cancel();
+
+    /**
+     * @brief Pops the next decoded chunk; returns false if none is queued yet
+     */
+    bool takeChunk(QString* chunk);
+
+    bool isRunning() const { return m_running; }
+    qint64 fileSize() const { return m_fileSize; }
+    qint64 bytesRead() const { return m_bytesRead.load(); }
+
+    // Load limits
+    static constexpr qint64 READ_BLOCK_SIZE = 512 * 1024;
+    static constexpr int MAX_QUEUED_CHUNKS = 16;
+
+signals:
+    void chunksAvailable();
+    void finished(bool ok, const QString& errorString);
+
+private:
+    void load(QString filePath, int generation);
+    bool enqueue(QString chunk, int generation);
+    void reportFinished(int generation, bool ok, const QString& errorString);
+
+    QThreadPool m_pool;                  ///< One worker: a new load queues behind the cancelled one
+    QMutex m_mutex;
+    QWaitCondition m_queueNotFull;
+    QQueue<QString> m_chunks;
+    std::atomic<int> m_generation{0};
+    std::atomic<qint64> m_bytesRead{0};
+    qint64 m_fileSize = 0;
+    bool m_running = false;
+};
+
+#endif // DOCUMENTLOADER_H
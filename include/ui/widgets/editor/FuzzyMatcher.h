@@ -0,0 +1,75 @@
+// FuzzyMatcher.h
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief Subsequence scorer over a fixed candidate list
+ *
+ * setCandidates() folds every candidate once into a single contiguous
+ * lower-case ASCII buffer, along with a word-boundary flag per character
+ * and a 64-bit mask of the characters it contains. A query first rejects
+ * candidates whose mask lacks one of its characters, then scores the rest by
+ * a greedy subsequence walk that rewards word starts and consecutive runs.
+ *
+ * While the user types, a Narrowing remembers every candidate that matched
+ * the previous query. Anything matching a longer query also matched the
+ * shorter one, so the next keystroke only rescans that set.
+ */
+class FuzzyMatcher
+{
+public:
+    struct Match {
+        int index = -1;
+        int score = 0;
+    };
+
+    /**
+     * @brief Match state carried from one keystroke to the next
+     *
+     * Reset it whenever the candidate list changes.
+     */
+    struct Narrowing {
+        QByteArray query;                ///< Folded query that produced matched
+        QVector<int> matched;            ///< Every candidate matching it, in list order
+        bool valid = false;
+
+        void reset() { query.clear(); matched.clear(); valid = false; }
+    };
+
+    void setCandidates(const QStringList& candidates);
+    void clear();
+    int candidateCount() const { return m_offsets.isEmpty() ? 0 : m_offsets.size() - 1; }
+
+    /**
+     * @brief Best @p limit candidates containing @p query as a subsequence, best first
+     */
+    QVector<Match> match(const QString& query, int limit) const;
+
+    /**
+     * @brief Same as match(), but rescans only the candidates @p narrowing
+     *        kept for the previous query when the new one extends it
+     */
+    QVector<Match> match(const QString& query, int limit, Narrowing* narrowing) const;
+
+    /**
+     * @brief Score of one candidate, or -1 if it does not match
+     */
+    int score(int index, const QByteArray& foldedQuery, quint64 queryMask) const;
+
+    static QByteArray fold(const QString& text);
+    static quint64 characterMask(const char* data, int length);
+    static bool isSubsequence(const QByteArray& needle, const QByteArray& haystack);
+
+private:
+    QByteArray m_folded;                 ///< All candidates back to back, folded
+    QByteArray m_boundaries;             ///< 1 where a word starts, parallel to m_folded
+    QVector<int> m_offsets;              ///< Candidate i spans [m_offsets[i], m_offsets[i + 1])
+    QVector<quint64> m_masks;
+};
+
+#endif // FUZZYMATCHER_H
@@ -0,0 +1,104 @@
+// QuickOpenIndex.h
+#ifndef QUICKOPENINDEX_H
+#define QUICKOPENINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include "ui/widgets/editor/FuzzyMatcher.h"
+#include "ui/widgets/editor/SymbolIndex.h"
+
+/**
+ * @brief In-memory index of project file paths and module names for quick open
+ *
+ * setRoot() and refresh() walk the project on a worker thread and fold every
+ * relative path into a FuzzyMatcher there too, so the GUI thread only swaps
+ * the finished matcher in. Module names come from the SymbolIndex and are
+ * re-read lazily after it changes.
+ *
+ * query() is meant to run on every keystroke: each matcher keeps a
+ * Narrowing, so typing more characters rescans only the previous matches.
+ */
+class QuickOpenIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QString title;                   ///< File name or module name
+        QString subtitle;                ///< Directory, or declaring file and line for modules
+        QString filePath;                ///< Absolute path to open
+        int line = 0;                    ///< 1-based; 0 for plain files
+        int column = 0;
+        bool module = false;
+        int score = 0;
+    };
+
+    explicit QuickOpenIndex(SymbolIndex* symbols, QObject* parent = nullptr);
+    ~QuickOpenIndex() override;
+
+    void setRoot(const QString& rootPath);
+    QString root() const { return m_root; }
+
+    /**
+     * @brief Rescans the current root; the old list stays queryable meanwhile
+     */
+    void refresh();
+
+    bool isScanning() const { return m_scanning; }
+    int fileCount() const { return m_paths.size(); }
+    int moduleCount();
+
+    /**
+     * @brief Best @p limit files and modules for @p text, best first
+     */
+    QVector<Entry> query(const QString& text, int limit = MAX_RESULTS);
+
+    // Limits
+    static constexpr int MAX_FILES = 200000;
+    static constexpr int MAX_RESULTS = 100;
+    // File candidates pulled from the path matcher before file names are re-scored
+    static constexpr int RERANK_FACTOR = 4;
+    // Added when the query also matches the file name on its own
+    static constexpr int FILE_NAME_BONUS = 10;
+
+signals:
+    void indexChanged();
+
+private:
+    struct ScanResult {
+        QStringList paths;
+        FuzzyMatcher pathMatcher;
+        FuzzyMatcher nameMatcher;
+    };
+
+    void applyScan(int generation, const ScanResult& result);
+    void rebuildModules();
+    QVector<Entry> queryFiles(const QString& text, int limit);
+    QVector<Entry> queryModules(const QString& text, int limit);
+    QString relativePath(const QString& filePath) const;
+
+    static ScanResult scan(QuickOpenIndex* receiver, const QString& rootPath, int generation);
+
+    SymbolIndex* m_symbols;
+    QString m_root;
+    bool m_scanning = false;
+
+    QStringList m_paths;                 ///< Relative to m_root
+    FuzzyMatcher m_pathMatcher;
+    FuzzyMatcher m_nameMatcher;          ///< File names only, same indices as m_pathMatcher
+    FuzzyMatcher::Narrowing m_pathNarrowing;
+
+    QVector<SymbolMatch> m_modules;
+    FuzzyMatcher m_moduleMatcher;
+    FuzzyMatcher::Narrowing m_moduleNarrowing;
+    bool m_modulesDirty = true;
+
+    std::atomic<int> m_generation{0};
+    QThreadPool m_pool;                  ///< One worker: a newer scan waits for the older one to bail out
+};
+
+#endif // QUICKOPENINDEX_H
@@ -0,0 +1,60 @@
+// QuickOpenPalette.h
+#ifndef QUICKOPENPALETTE_H
+#define QUICKOPENPALETTE_H
+
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+#include "ui/widgets/editor/QuickOpenIndex.h"
+
+/**
+ * @brief Ctrl+P popup: fuzzy search over project files and module names
+ *
+ * Every keystroke queries the QuickOpenIndex synchronously and refills a
+ * bounded list; the status line shows how long the query took so the
+ * per-keystroke budget stays visible.
+ */
+class QuickOpenPalette : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit QuickOpenPalette(QuickOpenIndex* index, QWidget* parent = nullptr);
+
+    void showPalette();
+
+    enum ItemRole {
+        FilePathRole = Qt::UserRole,
+        LineRole,
+        ColumnRole
+    };
+
+    static constexpr int PALETTE_WIDTH = 640;
+    static constexpr int PALETTE_HEIGHT = 420;
+
+signals:
+    void fileActivated(const QString& filePath, int line, int column);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private slots:
+    void onQueryChanged(const QString& query);
+    void activateCurrent();
+    void onIndexChanged();
+
+private:
+    void setupUI();
+    void populate(const QString& query);
+
+    QuickOpenIndex* m_index;
+
+    QVBoxLayout* m_layout;
+    QLineEdit* m_queryEdit;
+    QListWidget* m_resultList;
+    QLabel* m_statusLabel;
+};
+
+#endif // QUICKOPENPALETTE_H
@@ -0,0 +1,214 @@
+// SymbolIndex.h
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QMultiHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include "ui/widgets/editor/FuzzyMatcher.h"
+
+/**
+ * @brief A position in a source file (1-based line and column)
+ */
+struct SymbolLocation {
+    QString filePath;
+    int line = 0;
+    int column = 0;
+    QString preview;                     ///< Trimmed source line, filled in for references
+};
+
+/**
+ * @brief One symbol palette row
+ */
+struct SymbolMatch {
+    QString name;
+    QString container;                   ///< Enclosing module, empty for modules
+    QString detail;                      ///< Declaration text before the name, e.g. "input logic [7:0]"
+    quint8 kind = 0;
+    int score = 0;
+    SymbolLocation location;
+};
+
+/**
+ * @brief Project-wide index of RTL and SystemC declarations
+ *
+ * setRoot() walks the project on a worker thread and parses every
+ * SystemVerilog and C++ source into modules, ports and parameters (SV) and
+ * SC_MODULEs with their sc_in/sc_out members (SystemC). Parsed files are
+ * merged in batches on the GUI thread, so the index fills in while the build
+ * runs. updateFile() re-parses a single file, e.g. after it was saved.
+ *
+ * Storage is compact: names, containers and details are interned once in a
+ * reference-counted string pool and each symbol is a fixed 24-byte record.
+ * For references every file keeps only the sorted hashes of the identifiers
+ * it mentions; a findReferences() query rescans just the files whose hash set
+ * contains the name. The palette's fuzzy matcher is rebuilt on a worker after
+ * every merge, so search() never folds the symbol list on the GUI thread.
+ */
+class SymbolIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum SymbolKind : quint8 {
+        ModuleSymbol,
+        PortSymbol,
+        ParameterSymbol,
+        ScModuleSymbol,
+        ScPortSymbol
+    };
+
+    explicit SymbolIndex(QObject* parent = nullptr);
+    ~SymbolIndex() override;
+
+    /**
+     * @brief Drops the index and rebuilds it for @p rootPath in the background
+     */
+    void setRoot(const QString& rootPath);
+    QString root() const { return m_root; }
+
+    /**
+     * @brief Re-parses one file from @p text (its unsaved or just-saved content)
+     */
+    void updateFile(const QString& filePath, const QString& text);
+
+    /**
+     * @brief Re-parses one file from disk, or drops it if it no longer exists
+     */
+    void updateFile(const QString& filePath);
+    void removeFile(const QString& filePath);
+
+    bool isBuilding() const { return m_building; }
+    int fileCount() const;
+    int symbolCount() const { return int(m_definitions.size()); }
+
+    /**
+     * @brief All indexed file paths, in indexing order
+     */
+    QStringList files() const;
+
+    /**
+     * @brief Declarations named exactly @p name, modules first
+     */
+    QVector<SymbolLocation> definitions(const QString& name) const;
+
+    /**
+     * @brief Fuzzy symbol palette query; an empty query lists modules
+     */
+    QVector<SymbolMatch> search(const QString& query, int limit = MAX_PALETTE_RESULTS) const;
+
+    /**
+     * @brief Every module and SC_MODULE declaration, in indexing order
+     */
+    QVector<SymbolMatch> modules() const;
+
+    /**
+     * @brief Starts a background search for uses of @p name
+     * @return Request id echoed by referencesFound()
+     */
+    int findReferences(const QString& name);
+
+    static QString kindToString(quint8 kind);
+    static bool isIndexedFile(const QString& filePath);
+
+    // Limits
+    static constexpr qint64 MAX_FILE_SIZE = 16 * 1024 * 1024;
+    static constexpr int BUILD_BATCH_SIZE = 64;
+    static constexpr int MAX_PALETTE_RESULTS = 200;
+    static constexpr int MAX_REFERENCES = 5000;
+
+signals:
+    void indexingStarted();
+    void indexingFinished(int files, int symbols, qint64 elapsedMs);
+    void indexUpdated();
+    void referencesFound(int requestId, const QString& name, const QVector<SymbolLocation>& locations);
+
+public:
+    // Worker-side parse result; strings are interned when it is merged
+    struct ParsedSymbol {
+        QString name;
+        QString container;
+        QString detail;
+        int line = 0;
+        int column = 0;
+        quint8 kind = 0;
+    };
+
+    struct ParsedFile {
+        QString filePath;
+        qint64 modified = 0;
+        bool exists = true;
+        QVector<ParsedSymbol> symbols;
+        QVector<quint32> identifierHashes;   ///< Sorted, unique
+    };
+
+    static ParsedFile parse(const QString& filePath, const QString& text);
+    static ParsedFile parseFromDisk(const QString& filePath);
+    static quint32 identifierHash(QStringView identifier);
+
+private:
+    struct Symbol {
+        quint32 name;
+        quint32 container;
+        quint32 detail;
+        quint32 file;
+        quint32 line;
+        quint16 column;
+        quint8 kind;
+    };
+
+    struct FileEntry {
+        QString filePath;
+        qint64 modified = 0;
+        bool live = false;
+        QVector<Symbol> symbols;
+        QVector<quint32> identifierHashes;
+    };
+
+    static constexpr quint32 NO_STRING = 0xffffffffu;
+
+    void applyParsed(int generation, const QVector<ParsedFile>& files);
+    void finishBuild(int generation, qint64 elapsedMs);
+    void replaceFile(const ParsedFile& parsed);
+    void dropSymbols(quint32 fileId);
+    quint32 intern(const QString& text);
+    void release(quint32 id);
+    QString string(quint32 id) const;
+    SymbolLocation locationOf(const Symbol& symbol) const;
+    void rebuildPalette();
+    void applyPalette(int generation, const FuzzyMatcher& palette, const QStringList& names);
+
+    static void build(SymbolIndex* receiver, QString rootPath, int generation);
+    static quint64 packSymbol(quint32 fileId, quint32 symbolIndex) { return (quint64(fileId) << 32) | symbolIndex; }
+
+    QString m_root;
+    bool m_building = false;
+
+    QVector<QString> m_strings;
+    QVector<quint32> m_stringRefs;                ///< Symbol fields using each pooled string
+    QVector<quint32> m_freeStrings;               ///< Released pool slots, reused by intern()
+    QHash<QString, quint32> m_stringIds;
+    QVector<FileEntry> m_files;
+    QHash<QString, quint32> m_fileIds;
+    QMultiHash<quint32, quint64> m_definitions;   ///< Name id -> packed (file id, symbol index)
+
+    FuzzyMatcher m_palette;
+    mutable FuzzyMatcher::Narrowing m_paletteNarrowing;
+    QStringList m_paletteNames;                   ///< Candidate index -> symbol name
+    bool m_paletteRebuilding = false;
+    bool m_palettePending = false;                ///< The index changed while a rebuild was running
+
+    int m_nextReferenceRequest = 0;
+    std::atomic<int> m_generation{0};
+    QThreadPool m_pool;                  ///< One worker: builds and file updates apply in order
+    QThreadPool m_referencePool;
+    QThreadPool m_palettePool;
+};
+
+#endif // SYMBOLINDEX_H
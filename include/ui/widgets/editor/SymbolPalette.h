@@ -0,0 +1,71 @@
+// SymbolPalette.h
+#ifndef SYMBOLPALETTE_H
+#define SYMBOLPALETTE_H
+
+#include <QDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+#include <QVector>
+#include "ui/widgets/editor/SymbolIndex.h"
+
+/**
+ * @brief Popup list of symbol locations: fuzzy symbol search, definitions or references
+ *
+ * In search mode every keystroke queries the SymbolIndex directly; the
+ * query is cheap enough to need no debounce. In location mode the palette
+ * shows a fixed list (several definitions, or the result of a references
+ * search) and the line edit filters it. Activating a row emits
+ * locationActivated() and closes the popup.
+ */
+class SymbolPalette : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SymbolPalette(SymbolIndex* index, QWidget* parent = nullptr);
+
+    void showSearch(const QString& initialQuery = QString());
+    void showLocations(const QString& title, const QVector<SymbolLocation>& locations);
+
+    enum ItemRole {
+        FilePathRole = Qt::UserRole,
+        LineRole,
+        ColumnRole
+    };
+
+    static constexpr int PALETTE_WIDTH = 640;
+    static constexpr int PALETTE_HEIGHT = 420;
+
+signals:
+    void locationActivated(const QString& filePath, int line, int column);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private slots:
+    void onQueryChanged(const QString& query);
+    void activateCurrent();
+    void onIndexUpdated();
+
+private:
+    void setupUI();
+    void popup();
+    void populateSearch(const QString& query);
+    void populateLocations(const QString& filter);
+    void addLocationItem(const QString& text, const QString& toolTip, const SymbolLocation& location);
+    QString displayPath(const QString& filePath) const;
+
+    SymbolIndex* m_index;
+    bool m_searchMode;
+    QVector<SymbolLocation> m_locations;
+
+    QVBoxLayout* m_layout;
+    QLabel* m_titleLabel;
+    QLineEdit* m_queryEdit;
+    QListWidget* m_resultList;
+    QLabel* m_statusLabel;
+};
+
+#endif // SYMBOLPALETTE_H
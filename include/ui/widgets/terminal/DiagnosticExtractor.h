@@ -0,0 +1,107 @@
+// DiagnosticExtractor.h
+#ifndef DIAGNOSTICEXTRACTOR_H
+#define DIAGNOSTICEXTRACTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringDecoder>
+#include <QStringView>
+#include <QTimer>
+#include <QVector>
+#include "ui/widgets/terminal/ProblemsModel.h"
+
+/**
+ * @brief Streaming extractor that turns tool output into ProblemEntry batches
+ *
+ * Output is fed in arbitrary chunks (raw bytes or decoded text). A line
+ * assembly buffer joins lines that were split across chunks, so every byte
+ * is looked at once and finished lines are never rescanned.
+ *
+ * Recognised formats:
+ * - g++/clang: file:line[:col]: (fatal error|error|warning|note): message
+ * - Verilator: %Error[-CODE]: file:line[:col]: message
+ * - Icarus:    file:line: (syntax error|error|warning|sorry)[: message]
+ * - SystemC:   Error|Warning|Info|Fatal: message, with an optional
+ *              "In file: path:line" continuation (SC_REPORT_* output)
+ *
+ * Matchers are compiled once and guarded by a cheap keyword pre-check, so
+ * ordinary output lines never reach a regular expression. Matches are
+ * collected and emitted in batches.
+ */
+class DiagnosticExtractor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticExtractor(QObject* parent = nullptr);
+
+    /**
+     * @brief Feeds raw process output; UTF-8 sequences split across chunks are handled
+     */
+    void feed(const QByteArray& chunk);
+
+    /**
+     * @brief Feeds already decoded output text
+     */
+    void feed(const QString& text);
+
+    /**
+     * @brief Processes a trailing partial line and emits everything pending
+     */
+    void finish();
+
+    /**
+     * @brief Drops buffered input and pending diagnostics
+     */
+    void reset();
+
+    /**
+     * @brief Directory used to resolve relative file paths in diagnostics
+     */
+    void setWorkingDirectory(const QString& dir) { m_workingDirectory = dir; }
+    QString workingDirectory() const { return m_workingDirectory; }
+
+    /**
+     * @brief Name used as the file of reports that carry no location
+     */
+    void setSourceName(const QString& name) { m_sourceName = name; }
+
+    int extractedCount() const { return m_extractedCount; }
+
+    // Batching limits
+    static constexpr int MAX_BATCH_SIZE = 500;
+    static constexpr int FLUSH_INTERVAL_MS = 100;
+    static constexpr int MAX_LINE_LENGTH = 64 * 1024;
+
+signals:
+    void problemsExtracted(const QVector<ProblemEntry>& problems);
+
+private slots:
+    void flush();
+
+private:
+    void consumeLines();
+    void processLine(QStringView line);
+    bool matchCompilerLine(const QString& line);
+    bool matchVerilatorLine(const QString& line);
+    bool matchIcarusLine(const QString& line);
+    bool matchSystemCReport(const QString& line);
+    void finishSystemCReport();
+    void addProblem(const QString& file, int line, int column,
+                    const QString& message, const QString& severity);
+    QString resolvePath(const QString& path) const;
+
+    QStringDecoder m_decoder;
+    QString m_buffer;                ///< Line assembly buffer (unterminated tail)
+    QVector<ProblemEntry> m_pending;
+    QTimer m_flushTimer;
+    QString m_workingDirectory;
+    QString m_sourceName;
+    int m_extractedCount = 0;
+
+    // SystemC reports span several lines; the header waits for "In file:"
+    bool m_hasPendingReport = false;
+    ProblemEntry m_pendingReport;
+};
+
+#endif // DIAGNOSTICEXTRACTOR_H
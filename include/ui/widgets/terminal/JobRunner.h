@@ -0,0 +1,170 @@
+// JobRunner.h
+#ifndef JOBRUNNER_H
+#define JOBRUNNER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+#include <QProcess>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "ui/widgets/terminal/ProblemsModel.h"
+
+class DiagnosticExtractor;
+class SessionCaptureWriter;
+
+using JobParameters = QVector<QPair<QString, QString>>;
+
+/**
+ * @brief Lifecycle of a single job
+ */
+enum class JobState {
+    Queued,
+    Running,
+    Passed,
+    Failed,
+    Cancelled
+};
+
+/**
+ * @brief One expanded command of a sweep and its outcome
+ */
+struct JobRecord {
+    int id = -1;
+    QString command;
+    JobParameters parameters;
+    JobState state = JobState::Queued;
+    int exitCode = 0;
+    qint64 elapsedMs = 0;
+    int errorCount = 0;
+    int warningCount = 0;
+    QByteArray outputTail;               ///< Last MAX_TAIL_BYTES of output
+    QString captureDirectory;
+    QString captureBaseName;
+};
+
+/**
+ * @brief Aggregated counters over all jobs of the runner
+ */
+struct JobStats {
+    int queued = 0;
+    int running = 0;
+    int passed = 0;
+    int failed = 0;
+    int cancelled = 0;
+    qint64 wallMs = 0;                   ///< Since the first job of the current batch started
+    qint64 totalRuntimeMs = 0;           ///< Sum over finished jobs
+    qint64 minRuntimeMs = 0;
+    qint64 maxRuntimeMs = 0;
+
+    int finished() const { return passed + failed; }
+    qint64 averageRuntimeMs() const { return finished() > 0 ? totalRuntimeMs / finished() : 0; }
+};
+
+/**
+ * @brief Runs a command template over a parameter sweep on N concurrent processes
+ *
+ * submit() expands the template against the cartesian product of the sweep
+ * and appends one job per combination to a FIFO queue. Up to
+ * maxConcurrent() jobs run at a time; each finished job pulls the next one.
+ * Job output is kept as a bounded in-memory tail, teed to disk through a
+ * SessionCaptureWriter and scanned by a DiagnosticExtractor. A job passes
+ * when it exits with code 0 and reported no errors.
+ *
+ * Sweep syntax: "seed=1..32; mode=fast,slow" - parameters separated by ';',
+ * values by ','; "a..b" and "a..b:step" expand to integer ranges. The
+ * template refers to parameters as {name}; {index} is the job number.
+ */
+class JobRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit JobRunner(QObject* parent = nullptr);
+    ~JobRunner() override;
+
+    // Configuration
+    void setMaxConcurrent(int count);
+    int maxConcurrent() const { return m_maxConcurrent; }
+    void setWorkingDirectory(const QString& dir) { m_workingDirectory = dir; }
+    QString workingDirectory() const { return m_workingDirectory; }
+
+    /**
+     * @brief Expands and enqueues a sweep
+     * @param ids Receives the ids of the added jobs, in sweep order
+     * @return Number of jobs added, or -1 with @p error set if the sweep is invalid
+     */
+    int submit(const QString& commandTemplate, const QString& sweep, QString* error = nullptr,
+               QVector<int>* ids = nullptr);
+
+    /**
+     * @brief Cancels queued jobs and kills running ones
+     */
+    void stopAll();
+
+    /**
+     * @brief Cancels the given queued or running jobs and leaves the others alone
+     */
+    void cancel(const QVector<int>& ids);
+
+    /**
+     * @brief Forgets all finished jobs; fails while jobs are queued or running
+     */
+    bool clearFinished();
+
+    bool isBusy() const { return !m_queue.isEmpty() || !m_running.isEmpty(); }
+    const QVector<JobRecord>& jobs() const { return m_jobs; }
+    const JobRecord* job(int id) const;
+    qint64 elapsedMs(int id) const;      ///< Live for running jobs, final otherwise
+    JobStats stats() const;
+
+    static QVector<JobParameters> expandSweep(const QString& sweep, QString* error = nullptr);
+    static QString expandTemplate(const QString& commandTemplate, const JobParameters& parameters, int index);
+    static QString stateToString(JobState state);
+
+    // Limits
+    static constexpr int MAX_TAIL_BYTES = 256 * 1024;
+    static constexpr int MAX_JOBS_PER_SUBMIT = 10000;
+
+signals:
+    void jobAdded(int id);
+    void jobChanged(int id);
+    void jobsCleared();
+    void jobOutput(int id, const QByteArray& data);
+    void statsChanged();
+    void allFinished();
+    void problemsDetected(const QVector<ProblemEntry>& problems);
+
+private:
+    struct RunningJob {
+        QProcess* process = nullptr;
+        SessionCaptureWriter* capture = nullptr;
+        DiagnosticExtractor* stdoutDiagnostics = nullptr;
+        DiagnosticExtractor* stderrDiagnostics = nullptr;
+        QElapsedTimer timer;
+        bool cancelRequested = false;
+    };
+
+    void scheduleJobs();
+    void startJob(int id);
+    void onJobOutput(int id, bool isError);
+    void onJobFinished(int id, int exitCode, QProcess::ExitStatus status);
+    void onJobError(int id, QProcess::ProcessError error);
+    void finishJob(int id, JobState state, int exitCode);
+    void appendTail(JobRecord& record, const QByteArray& data);
+
+    QVector<JobRecord> m_jobs;           ///< Indexed by job id
+    QQueue<int> m_queue;
+    QHash<int, RunningJob> m_running;
+    int m_maxConcurrent;
+    QString m_workingDirectory;
+    QString m_captureRoot;               ///< Per-batch capture directory
+    QElapsedTimer m_wallTimer;
+    qint64 m_wallMs = 0;
+};
+
+#endif // JOBRUNNER_H
@@ -0,0 +1,101 @@
+// JobRunnerTab.h
+#ifndef JOBRUNNERTAB_H
+#define JOBRUNNERTAB_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMenu>
+#include <QAction>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTextEdit>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QVector>
+#include "ui/widgets/terminal/JobRunner.h"
+
+/**
+ * @brief "Jobs" tab of the terminal section: parameter sweeps over parallel processes
+ *
+ * The user enters a command template and a sweep; the tab hands them to a
+ * JobRunner and lists every job with its status, runtime and diagnostics
+ * count. Selecting a job shows its (bounded) output tail; the full output is
+ * kept in the job's capture files and can be exported.
+ */
+class JobRunnerTab : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit JobRunnerTab(QWidget* parent = nullptr);
+    ~JobRunnerTab();
+
+    JobRunner* runner() const { return m_runner; }
+
+    void setWorkingDirectory(const QString& dir);
+
+    enum Column {
+        IndexColumn,
+        ParametersColumn,
+        StatusColumn,
+        TimeColumn,
+        ExitColumn,
+        DiagnosticsColumn
+    };
+
+    static constexpr int STATS_REFRESH_MS = 500;
+
+public slots:
+    void runJobs();
+    void stopJobs();
+    void clearJobs();
+
+private slots:
+    void onJobAdded(int id);
+    void onJobChanged(int id);
+    void onJobsCleared();
+    void onJobOutput(int id, const QByteArray& data);
+    void onSelectionChanged();
+    void onContextMenuRequested(const QPoint& pos);
+    void updateStats();
+
+private:
+    void setupUI();
+    void setupContextMenu();
+    void updateItem(int id);
+    void updateButtons();
+    void saveSettings();
+    void restoreSettings();
+    int selectedJobId() const;
+    static QString formatDuration(qint64 ms);
+
+    JobRunner* m_runner;
+
+    QVBoxLayout* m_layout;
+    QLineEdit* m_commandEdit;
+    QLineEdit* m_sweepEdit;
+    QLineEdit* m_workingDirEdit;
+    QSpinBox* m_concurrencySpin;
+    QPushButton* m_runButton;
+    QPushButton* m_stopButton;
+    QPushButton* m_clearButton;
+    QSplitter* m_splitter;
+    QTreeWidget* m_jobList;
+    QTextEdit* m_jobOutput;
+    QLabel* m_statsLabel;
+    QTimer* m_statsTimer;
+
+    QVector<QTreeWidgetItem*> m_items;   ///< Indexed by job id
+
+    QMenu* m_contextMenu;
+    QAction* m_rerunAction;
+    QAction* m_exportLogAction;
+    QAction* m_copyCommandAction;
+};
+
+#endif // JOBRUNNERTAB_H
@@ -0,0 +1,207 @@
+// ProblemsModel.h
+#ifndef PROBLEMSMODEL_H
+#define PROBLEMSMODEL_H
+
+#include <QAbstractItemModel>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * @brief Severity of a single diagnostic, stored as one byte per record
+ */
+enum class ProblemSeverity : quint8 {
+    Error,
+    Warning,
+    Info
+};
+
+/**
+ * @brief Plain diagnostic as handed over by producers (parsers, tools, tests)
+ */
+struct ProblemEntry {
+    QString file;
+    int line = 0;
+    int column = 0;
+    QString message;
+    QString severity;
+};
+
+/**
+ * @brief Compact stored diagnostic
+ *
+ * File paths are interned by the model, so a record only carries an index
+ * into the file table instead of its own copy of the path.
+ */
+struct ProblemRecord {
+    int fileIndex = -1;
+    int line = 0;
+    int column = 0;
+    ProblemSeverity severity = ProblemSeverity::Info;
+    QString message;
+};
+
+/**
+ * @brief Visible diagnostics of one file, in display order
+ */
+struct ProblemGroup {
+    int fileIndex = -1;
+    QVector<int> ids;
+};
+
+/**
+ * @brief Trigram index over the searchable text of every diagnostic
+ *
+ * Each record contributes one case-folded haystack (severity, file name and
+ * message). Queries of three or more characters intersect the posting lists
+ * of their trigrams and only verify the surviving candidates; shorter queries
+ * fall back to a linear scan. The index is implicitly shared, so handing a
+ * copy to a worker thread is cheap and never races with later appends.
+ */
+class ProblemIndex
+{
+public:
+    void clear();
+    void append(const QString& text);
+    int size() const { return m_haystacks.size(); }
+
+    /**
+     * @brief Returns true if record @p id contains the case-folded @p needle
+     */
+    bool matches(int id, const QString& needle) const;
+
+    /**
+     * @brief Returns the sorted ids of all records containing @p needle
+     * @param cancelled Polled between posting lists and candidates; an empty
+     *                  result is returned once it reports true
+     */
+    QVector<int> query(const QString& needle, const std::function<bool()>& cancelled = {}) const;
+
+    static QString fold(const QString& text) { return text.toCaseFolded(); }
+
+private:
+    static quint64 trigramKey(QChar a, QChar b, QChar c);
+
+    QVector<QString> m_haystacks;
+    QHash<quint64, QVector<int>> m_postings;
+};
+
+/**
+ * @brief Two-level item model for the Problems tab
+ *
+ * Top-level rows are files ("name (count)"), children are the diagnostics of
+ * that file. Records live in a flat array; the tree only holds id lists for
+ * the rows that pass the current filter. Filtering runs on a worker thread
+ * and the result replaces the visible groups in one model reset.
+ */
+class ProblemsModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        SeverityColumn,
+        LineColumn,
+        ColumnColumn,
+        FileColumn,
+        MessageColumn,
+        ColumnCount
+    };
+
+    // Data roles on column 0, kept compatible with the old QTreeWidget items
+    static constexpr int FilePathRole = Qt::UserRole;
+    static constexpr int LineRole = Qt::UserRole + 1;
+    static constexpr int ColumnRole = Qt::UserRole + 2;
+    static constexpr int IsGroupRole = Qt::UserRole + 3;
+
+    explicit ProblemsModel(QObject* parent = nullptr);
+    ~ProblemsModel() override;
+
+    // QAbstractItemModel interface
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // Diagnostics
+    void addProblem(const ProblemEntry& entry);
+    void addProblems(const QVector<ProblemEntry>& entries);
+    void clear();
+    int problemCount() const { return m_records.size(); }
+    int visibleCount() const { return m_visibleCount; }
+    int countBySeverity(ProblemSeverity severity) const;
+
+    // Filtering
+    void setFilter(const QString& filter);
+    QString filter() const { return m_filterText; }
+    bool isFiltering() const { return m_watcher.isRunning(); }
+
+    bool isGroup(const QModelIndex& index) const;
+    static ProblemSeverity severityFromString(const QString& severity);
+    static QString severityToString(ProblemSeverity severity);
+
+signals:
+    /**
+     * @brief Emitted after the visible rows were rebuilt by a filter run
+     */
+    void filterApplied(int visibleCount, int totalCount);
+
+    /**
+     * @brief Emitted whenever the total or visible counts change
+     */
+    void countsChanged();
+
+private slots:
+    void onFilterFinished();
+
+private:
+    struct FilterResult {
+        int generation = 0;
+        int snapshotSize = 0;
+        QVector<ProblemGroup> groups;
+    };
+
+    int internFile(const QString& file);
+    void appendRecord(const ProblemEntry& entry);
+    void insertVisible(int id);
+    int insertionRow(const ProblemGroup& group, int id) const;
+    int groupInsertionRow(int fileIndex) const;
+    void rebuildGroupLookup();
+    void startFilter();
+
+    static FilterResult computeGroups(QVector<ProblemRecord> records, QStringList fileNames,
+                                      ProblemIndex index, QString needle, int sortColumn,
+                                      Qt::SortOrder order, int generation,
+                                      std::shared_ptr<const std::atomic<int>> latestGeneration);
+
+    // Storage
+    QVector<ProblemRecord> m_records;
+    QStringList m_files;                 ///< Interned absolute/relative paths
+    QStringList m_fileNames;             ///< File name part of each interned path
+    QHash<QString, int> m_fileLookup;    ///< Path -> index into m_files
+    ProblemIndex m_index;
+    int m_severityCounts[3] = {0, 0, 0};
+
+    // Visible tree
+    QVector<ProblemGroup> m_groups;
+    QHash<int, int> m_groupOfFile;       ///< fileIndex -> row in m_groups
+    int m_visibleCount = 0;
+
+    // Filter / sort state
+    QString m_filterText;
+    QString m_needle;                    ///< Case-folded m_filterText
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+    std::shared_ptr<std::atomic<int>> m_generation;   ///< Shared with workers so stale runs bail out
+    QFutureWatcher<FilterResult> m_watcher;
+};
+
+#endif // PROBLEMSMODEL_H
@@ -0,0 +1,180 @@
+// ScrollbackSearch.h
+#ifndef SCROLLBACKSEARCH_H
+#define SCROLLBACKSEARCH_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+class QTextDocument;
+
+/**
+ * @brief One match inside a scanned buffer, in document positions
+ */
+struct SearchHit {
+    int position = 0;
+    int length = 0;
+};
+
+/**
+ * @brief Plain-text copy of a log view, kept in line-aligned chunks
+ *
+ * Updated from QTextDocument::contentsChange as the view is written to, by
+ * re-reading only the lines from the change to the end. A snapshot copies
+ * the chunk handles, not the text: the strings are implicitly shared, so a
+ * scan keeps reading its chunks while later writes detach only the last one.
+ * Positions match the document's, one character per position, with line
+ * breaks as '\n'.
+ */
+class ScrollbackBuffer
+{
+public:
+    struct Snapshot {
+        QVector<QString> chunks;
+        int offset = 0;              ///< Document position of the first chunk
+    };
+
+    /**
+     * @brief Re-reads @p document from the line holding @p position to the end
+     */
+    void sync(const QTextDocument* document, int position);
+
+    /**
+     * @brief Drops the first @p length characters, as trimmed from the top of the view
+     */
+    void removeFront(int length);
+
+    void clear();
+    int length() const { return m_length; }
+
+    /**
+     * @brief The chunks holding @p from and everything after it
+     */
+    Snapshot snapshot(int from = 0) const;
+
+    static constexpr int CHUNK_SIZE = 256 * 1024;
+
+private:
+    int chunkAt(int position) const;
+    void appendText(const QString& text, bool endOfLine);
+
+    QVector<QString> m_chunks;
+    QVector<int> m_starts;           ///< Document position of each chunk
+    int m_length = 0;
+};
+
+/**
+ * @brief Chunked background search over terminal scrollback and log text
+ *
+ * A search runs on a private single-thread pool over a ScrollbackBuffer
+ * snapshot, one line-aligned chunk at a time. Hits of every chunk are
+ * streamed back to the GUI thread as they are found, and starting a new
+ * search makes the running one bail out at its next chunk boundary. Text that
+ * is appended later can be scanned with extend() without rescanning what
+ * came before.
+ */
+class ScrollbackSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString pattern;
+        bool regex = false;
+        bool caseSensitive = false;
+    };
+
+    explicit ScrollbackSearch(QObject* parent = nullptr);
+    ~ScrollbackSearch() override;
+
+    /**
+     * @brief Starts a new search over @p text, dropping all previous hits
+     * @return false if the pattern is empty or not a valid regular expression
+     */
+    bool start(const ScrollbackBuffer::Snapshot& text, const Options& options);
+
+    /**
+     * @brief Rescans from @p offset with @p tail, a snapshot reaching from there to the end
+     *
+     * Hits at or after @p offset are dropped first, so @p offset should be the
+     * start of the first line that changed. Must not be called while a scan
+     * is running; wait for searchFinished() instead.
+     */
+    void extend(const ScrollbackBuffer::Snapshot& tail, int offset);
+
+    /**
+     * @brief Follows the text as its first @p length characters are removed
+     *
+     * Hits inside the removed text are dropped and the rest move up.
+     * @return false while a scan is running, whose hits would land in the wrong place
+     */
+    bool removeFront(int length);
+
+    void cancel();
+    void clear();
+
+    bool isRunning() const { return m_watcher.isRunning(); }
+    bool isActive() const { return !m_options.pattern.isEmpty(); }
+    bool isTruncated() const { return m_truncated; }
+    const Options& options() const { return m_options; }
+    QString errorString() const { return m_errorString; }
+
+    // Hits are kept sorted by position
+    const QVector<SearchHit>& hits() const { return m_hits; }
+    int hitCount() const { return m_hits.size(); }
+    int searchedLength() const { return m_searchedLength; }
+
+    /**
+     * @brief Index of the first hit ending after @p position, or -1
+     */
+    int firstHitAfter(int position) const;
+
+    // Navigation
+    int currentIndex() const { return m_currentIndex; }
+    int next(int fromPosition = -1);
+    int previous(int fromPosition = -1);
+    void setCurrentIndex(int index);
+
+    // Scan limits
+    static constexpr int MAX_HITS = 100000;
+
+signals:
+    void hitsChanged();
+    void currentHitChanged(int index, int total);
+    void searchFinished(int total, bool truncated);
+
+private slots:
+    void onScanFinished();
+
+private:
+    struct ScanResult {
+        int generation = 0;
+        int endOffset = 0;
+        bool truncated = false;
+        bool cancelled = false;
+    };
+
+    void startScan(const ScrollbackBuffer::Snapshot& text, int from);
+    void deliverHits(int generation, const QVector<SearchHit>& hits);
+
+    static ScanResult scan(ScrollbackSearch* receiver, ScrollbackBuffer::Snapshot text, int from,
+                           Options options, int budget, int generation,
+                           std::shared_ptr<const std::atomic<int>> latestGeneration);
+
+    Options m_options;
+    QString m_errorString;
+    QVector<SearchHit> m_hits;
+    int m_currentIndex = -1;
+    int m_searchedLength = 0;
+    bool m_truncated = false;
+
+    std::shared_ptr<std::atomic<int>> m_generation;   ///< Shared with workers so stale runs bail out
+    QThreadPool m_pool;                              ///< One worker: a new scan queues behind the cancelled one
+    QFutureWatcher<ScanResult> m_watcher;
+};
+
+#endif // SCROLLBACKSEARCH_H
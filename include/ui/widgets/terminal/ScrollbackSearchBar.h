@@ -0,0 +1,85 @@
+// ScrollbackSearchBar.h
+#ifndef SCROLLBACKSEARCHBAR_H
+#define SCROLLBACKSEARCHBAR_H
+
+#include <QWidget>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTextEdit>
+#include <QTimer>
+#include <QToolButton>
+#include "ui/widgets/terminal/ScrollbackSearch.h"
+
+/**
+ * @brief Find bar attached to a read-only log view (terminal, output, debug console)
+ *
+ * Queries are debounced and handed to a ScrollbackSearch. Only the hits that
+ * fall inside the viewport are painted (as extra selections), so the cost of
+ * highlighting does not grow with the number of matches. Text appended while
+ * the bar is open is searched incrementally from the first changed line.
+ *
+ * The bar keeps a ScrollbackBuffer of the view's text in step with every
+ * write, open or not, so a query hands the search a snapshot of it instead of
+ * copying the document on the GUI thread.
+ */
+class ScrollbackSearchBar : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ScrollbackSearchBar(QTextEdit* target, QWidget* parent = nullptr);
+    ~ScrollbackSearchBar();
+
+    ScrollbackSearch* search() const { return m_search; }
+
+    // Timing and painting limits
+    static constexpr int QUERY_DEBOUNCE_MS = 150;
+    static constexpr int EXTEND_INTERVAL_MS = 250;
+    static constexpr int MAX_VISIBLE_HIGHLIGHTS = 1000;
+
+public slots:
+    void activate();
+    void deactivate();
+    void findNext();
+    void findPrevious();
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private slots:
+    void onQueryChanged();
+    void runSearch();
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void onExtendTimeout();
+    void onHitsChanged();
+    void onCurrentHitChanged(int index, int total);
+    void updateHighlights();
+
+private:
+    void setupUI();
+    void updateCountLabel();
+    void revealHit(int index);
+    int firstVisiblePosition() const;
+    int lastVisiblePosition() const;
+
+    QTextEdit* m_target;
+    ScrollbackSearch* m_search;
+    ScrollbackBuffer m_buffer;
+
+    QHBoxLayout* m_layout;
+    QLineEdit* m_findEdit;
+    QToolButton* m_caseButton;
+    QToolButton* m_regexButton;
+    QLabel* m_countLabel;
+    QToolButton* m_previousButton;
+    QToolButton* m_nextButton;
+    QToolButton* m_closeButton;
+
+    QTimer* m_queryTimer;
+    QTimer* m_extendTimer;
+    int m_dirtyOffset;            ///< First changed position since the last scan, -1 if none
+    bool m_revealPending;         ///< Jump to the first hit once a fresh query reports one
+};
+
+#endif // SCROLLBACKSEARCHBAR_H
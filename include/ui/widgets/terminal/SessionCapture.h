@@ -0,0 +1,153 @@
+// SessionCapture.h
+#ifndef SESSIONCAPTURE_H
+#define SESSIONCAPTURE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Which pipe a captured chunk came from
+ */
+enum class CaptureStream : quint8 {
+    StandardOutput = 0,
+    StandardError = 1
+};
+
+/**
+ * @brief Tees raw session output to disk on a background thread
+ *
+ * append() only copies the bytes into a pending buffer under a mutex; the
+ * writer thread packs them into blocks, compresses each block and appends it
+ * to the current capture file. When a file grows past the size limit a new
+ * one is started and the oldest files of the same session are deleted.
+ *
+ * File layout: an 8 byte header ("SCVCAP1\n") followed by blocks of
+ * [quint32 LE payload size][qCompress payload]. A decompressed block is a
+ * sequence of records [quint8 stream][quint32 LE length][bytes].
+ */
+class SessionCaptureWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Settings {
+        QString directory;
+        QString baseName;
+        qint64 maxFileSize = 64 * 1024 * 1024;
+        int maxFiles = 8;
+        int blockSize = 256 * 1024;
+        int compressionLevel = 1;          ///< zlib level; 1 keeps up with fast producers
+        int flushIntervalMs = 1000;
+        qint64 maxPendingBytes = 32 * 1024 * 1024;
+    };
+
+    explicit SessionCaptureWriter(const Settings& settings, QObject* parent = nullptr);
+    ~SessionCaptureWriter() override;
+
+    /**
+     * @brief Queues @p data for writing; thread-safe and never touches the disk
+     *
+     * If the disk falls so far behind that more than maxPendingBytes are
+     * queued, new data is dropped and counted in bytesDropped().
+     */
+    void append(CaptureStream stream, const QByteArray& data);
+
+    /**
+     * @brief Asks the writer to write out everything queued so far
+     * @return Ticket that flushed() reports once that data is on disk
+     */
+    quint64 flush();
+
+    /**
+     * @brief Asks the thread to write out pending data and end; returns at once
+     *
+     * QThread::finished() reports when it is done.
+     */
+    void requestStop();
+
+    /**
+     * @brief Writes out pending data and ends the thread; blocks until done
+     */
+    void stop();
+
+    const Settings& settings() const { return m_settings; }
+    QString currentFile() const;
+    qint64 bytesCaptured() const { return m_bytesCaptured.load(); }
+    qint64 bytesDropped() const { return m_bytesDropped.load(); }
+
+    static QString fileSuffix() { return QStringLiteral("scvcap"); }
+    static QByteArray fileMagic() { return QByteArrayLiteral("SCVCAP1\n"); }
+
+signals:
+    /**
+     * @brief Everything queued before the flush() that returned @p ticket, or any earlier one, is on disk
+     *
+     * Also emitted when the thread ends, for every flush still outstanding.
+     */
+    void flushed(quint64 ticket);
+    void fileRotated(const QString& path);
+    void captureError(const QString& message);
+
+protected:
+    void run() override;
+
+private:
+    bool writeBlock(const QByteArray& records);
+    bool openNextFile();
+    void pruneOldFiles();
+
+    const Settings m_settings;
+
+    // Shared with producers
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QByteArray m_pending;
+    bool m_flushRequested = false;
+    quint64 m_flushesRequested = 0;    ///< flush() calls so far
+    bool m_stopRequested = false;
+    QString m_currentPath;
+    std::atomic<qint64> m_bytesCaptured{0};
+    std::atomic<qint64> m_bytesDropped{0};
+
+    // Writer thread only
+    QFile* m_file = nullptr;
+    QString m_runStamp;                ///< Start time shared by all files of this run
+    int m_fileSequence = 0;
+    bool m_failed = false;
+};
+
+/**
+ * @brief Reads capture files written by SessionCaptureWriter
+ */
+class SessionCaptureReader
+{
+public:
+    using RecordSink = std::function<bool(CaptureStream stream, const QByteArray& data)>;
+
+    /**
+     * @brief Capture files of one session, oldest first
+     */
+    static QStringList captureFiles(const QString& directory, const QString& baseName);
+
+    /**
+     * @brief Feeds every record of @p path to @p sink, in order
+     *
+     * Stops early when @p sink returns false. A truncated trailing block (the
+     * file is still being written) ends the read without an error.
+     */
+    static bool read(const QString& path, const RecordSink& sink, QString* error = nullptr);
+
+    /**
+     * @brief Decodes all capture files of a session into one plain text file
+     */
+    static bool exportText(const QStringList& files, const QString& targetPath, QString* error = nullptr);
+};
+
+#endif // SESSIONCAPTURE_H
@@ -12,6 +12,7 @@
  * - ComponentPersistence: Handles ready component storage and metadata
  * - RTLModulePersistence: Manages RTL module placement and information
  * - ConnectionPersistence: Handles wire connections and routing data
+ * - BlockPersistence: Manages collapsed blocks and which components they hold
  * 
  * Key Features:
  * - JSON-based data storage
@@ -44,19 +45,28 @@
 #include <QSizeF>
 #include <QColor>
 #include <QVariant>
+#include <QVector>
+#include <QPair>
+#include <QStringList>
 #include <memory>
 #include "parsers/SvParser.h"
+#include "persistence/ComponentPersistence.h"
 
 // Forward declarations for persistence components
 class SchematicPersistence;
 class ComponentPersistence;
 class RTLModulePersistence;
 class ConnectionPersistence;
+class BlockPersistence;
+class TopSvModel;
+struct ConnectionEnd;
+struct ConnectionData;
 
 // Graphics item forward declarations
 class ReadyComponentGraphicsItem;
 class ModuleGraphicsItem;
 class WireGraphicsItem;
+class BlockGraphicsItem;
 
 /**
  * @class PersistenceManager
@@ -84,6 +94,7 @@ public:
     
     // Component persistence
     QString createComponentFile(const QString& componentType, const QPointF& position, const QSizeF& size);
+    QStringList createComponentFiles(const QVector<ComponentPersistence::ComponentPlacement>& placements);
     bool loadComponentsFromDirectory(QGraphicsScene* scene);
     void updateComponentPosition(const QString& componentId, const QPointF& position);
     void updateComponentSize(const QString& componentId, const QSizeF& size);
@@ -92,7 +103,8 @@ public:
     void removeComponentOnlyFromConnections(const QString& componentId);
     
     // RTL Module persistence
-    void saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position);
+    void saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position,
+                                const QString& definition = QString());
     void updateRTLModulePosition(const QString& moduleName, const QPointF& position);
     void updateRTLModulePorts(const QString& moduleName, const QList<Port>& inputs, const QList<Port>& outputs);
     void removeRTLModulePlacement(const QString& moduleName);
@@ -105,7 +117,8 @@ public:
     void saveConnection(const QString& sourceId, const QPointF& sourcePort,
                        const QString& targetId, const QPointF& targetPort,
                        bool sourceIsRTL = false, bool targetIsRTL = false,
-                       const QList<QPointF>& controlPoints = QList<QPointF>(), qreal orthogonalOffset = 0.0);
+                       const QList<QPointF>& controlPoints = QList<QPointF>(), qreal orthogonalOffset = 0.0,
+                       bool manualOffset = false);
     void removeConnection(const QString& sourceId, const QPointF& sourcePort,
                          const QString& targetId, const QPointF& targetPort);
     void updateConnectionControlPoints(const QString& sourceId, const QPointF& sourcePort,
@@ -113,15 +126,43 @@ public:
                                        const QList<QPointF>& controlPoints);
     void updateConnectionOrthogonalOffset(const QString& sourceId, const QPointF& sourcePort,
                                           const QString& targetId, const QPointF& targetPort,
-                                          qreal orthogonalOffset);
+                                          qreal orthogonalOffset, bool manualOffset);
     bool loadConnections(QGraphicsScene* scene);
+    QList<ConnectionData> connectionsOf(const QStringList& componentIds);  ///< Connections involving any of the components
+    
+    /**
+     * @brief The stored end of a connection drawn at @p port of @p item
+     * 
+     * A block's port resolves to the component inside it that the port leads to.
+     * @return False if the item is not registered or the block has no such port
+     */
+    bool connectionEnd(ReadyComponentGraphicsItem* item, const QPointF& port, ConnectionEnd& end) const;
+    
+    // Block persistence
+    struct SceneEndpoint {
+        ReadyComponentGraphicsItem* item = nullptr;  ///< The component itself, or the block holding it
+        QPointF port;
+        BlockGraphicsItem* block = nullptr;          ///< Set if the end lies inside a block of the scene
+        bool outside = false;                        ///< The end is not in the scene at all
+    };
+    
+    /**
+     * @brief Where the stored connection end @p memberId / @p port shows in @p scene
+     * 
+     * Used by the loaders; O(depth) hash lookups, whatever the size of the design.
+     */
+    SceneEndpoint sceneEndpoint(QGraphicsScene* scene, const QString& memberId, bool isRTL, const QPointF& port);
+    QString sceneScope(QGraphicsScene* scene) const;  ///< Block a scene shows the inside of; empty for the top level
+    bool belongsToScene(QGraphicsScene* scene, const QString& memberId, bool isRTL);
+    void adoptMember(ReadyComponentGraphicsItem* item);  ///< Record the item as inside the block its scene shows
+    bool loadBlocks(QGraphicsScene* scene);
     
     // Helper to get component ID from graphics item
     QString getComponentId(ReadyComponentGraphicsItem* component) const;
     void setComponentId(ReadyComponentGraphicsItem* component, const QString& id);
     void unregisterComponent(ReadyComponentGraphicsItem* component);
     
-    // Component color persistence
+    // Component color persistence; an invalid color clears the custom one
     void updateComponentColor(const QString& componentId, const QColor& color);
     QColor getComponentColor(const QString& componentId);
     
@@ -153,11 +194,30 @@ public:
     
     // Performance optimization
     void clearMetadataCache();
+    void flushPendingWrites();  // Call before reading back a freshly generated component file
+    
+    // Batched writes: component metadata, connections and RTL placements edited between
+    // beginBatch() and the matching endBatch() reach their files in one write each. Batches nest.
+    void beginBatch();
+    void endBatch();
+    
+    /**
+     * @brief Scoped beginBatch()/endBatch() pair
+     */
+    class Batch
+    {
+    public:
+        Batch() { PersistenceManager::instance().beginBatch(); }
+        ~Batch() { PersistenceManager::instance().endBatch(); }
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+    };
     
     // RTL connection persistence
     void updateComponentRTLConnection(const QString& componentId, const QString& rtlFilePath);
     QString getComponentRTLConnection(const QString& componentId);
     void generateTopSvIntegration(const QString& componentId, const QString& rtlFilePath);
+    void generateTopSvIntegration(const QVector<QPair<QString, QString>>& components);  // (componentId, rtlFilePath), one write
     
     // Component ID generation
     QString createComponentId(const QString& componentType); // Public wrapper
@@ -170,6 +230,7 @@ public:
     QString getRTLModuleName(ModuleGraphicsItem* module) const;
     void setRTLModuleName(ModuleGraphicsItem* module, const QString& name);
     void unregisterRTLModule(ModuleGraphicsItem* module);
+    QString createRTLModuleName(const QString& definition) const;  // Unused registration name for another placement of @p definition
     
     QString getRTLModuleFilePath(const QString& moduleName);
     
@@ -198,6 +259,8 @@ public:
     
     // Accessors for persistence components
     SchematicPersistence* getSchematicPersistence() const;
+    ComponentPersistence* getComponentPersistence() const;
+    BlockPersistence* getBlockPersistence() const;
     
 private:
     PersistenceManager();
@@ -216,6 +279,8 @@ private:
     std::unique_ptr<ComponentPersistence> m_componentPersistence;
     std::unique_ptr<RTLModulePersistence> m_rtlModulePersistence;
     std::unique_ptr<ConnectionPersistence> m_connectionPersistence;
+    std::unique_ptr<BlockPersistence> m_blockPersistence;
+    std::unique_ptr<TopSvModel> m_topSvModel;  // Parsed on first use, kept across edits
 };
 
 #endif // PERSISTENCEMANAGER_H
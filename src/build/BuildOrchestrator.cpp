@@ -0,0 +1,834 @@
+// BuildOrchestrator.cpp
+#include "build/BuildOrchestrator.h"
+#include "persistence/TestbenchExporter.h"
+#include "scene/Netlist.h"
+#include "ui/widgets/terminal/JobRunner.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const QLatin1String INDENT("    ");
+const char* const PCH_TARGET = "pch";
+const char* const LINK_TARGET = "link";
+
+const char* const UNITS_HEADER = R"(// scv_units.h
+// Generated by SCV, do not edit
+#ifndef SCV_UNITS_H
+#define SCV_UNITS_H
+
+#include <systemc.h>
+#include <string>
+#include <vector>
+
+// Binds a port to a channel declared in tb_main; a type mismatch is reported
+// at elaboration instead of breaking the build of every unit
+template <typename Port>
+void scv_bind(Port& port, sc_core::sc_interface* channel)
+{
+    typename Port::if_type* typed = dynamic_cast<typename Port::if_type*>(channel);
+    if (!typed) {
+        SC_REPORT_ERROR("SCV", (std::string(port.name()) + ": signal type does not match the port").c_str());
+        return;
+    }
+    port(*typed);
+}
+
+)";
+
+QString hex(const QByteArray& hash)
+{
+    return QString::fromLatin1(hash.toHex());
+}
+
+QString createFunction(const Netlist::Instance& instance)
+{
+    return "scv_create_" + instance.name;
+}
+
+QString createSignature(const Netlist::Instance& instance)
+{
+    return QString("sc_core::sc_module* %1(const char* name, const std::vector<sc_core::sc_interface*>& channels)")
+        .arg(createFunction(instance));
+}
+
+QString systemcLibraryDirectory(const QString& systemcHome)
+{
+    if (systemcHome.isEmpty()) {
+        return QString();
+    }
+    const QDir home(systemcHome);
+    for (const char* name : {"lib-linux64", "lib-linux", "lib-macosx64", "lib-mingw64", "lib64", "lib"}) {
+        if (home.exists(name)) {
+            return home.filePath(name);
+        }
+    }
+    return home.filePath("lib");
+}
+
+} // namespace
+
+BuildOrchestrator::Settings BuildOrchestrator::Settings::load()
+{
+    QSettings settings;
+    settings.beginGroup("Build");
+    Settings result;
+    result.compiler = settings.value("compiler", qEnvironmentVariable("CXX", "g++")).toString();
+    result.cxxFlags = settings.value("cxxFlags", "-std=c++17 -O1").toString();
+    result.systemcHome = settings.value("systemcHome", qEnvironmentVariable("SYSTEMC_HOME")).toString();
+    result.verilatorRoot = settings.value("verilatorRoot", qEnvironmentVariable("VERILATOR_ROOT")).toString();
+    result.jobs = settings.value("jobs", 0).toInt();
+    result.usePrecompiledHeader = settings.value("usePrecompiledHeader", true).toBool();
+    settings.endGroup();
+    return result;
+}
+
+void BuildOrchestrator::Settings::save() const
+{
+    QSettings settings;
+    settings.beginGroup("Build");
+    settings.setValue("compiler", compiler);
+    settings.setValue("cxxFlags", cxxFlags);
+    settings.setValue("systemcHome", systemcHome);
+    settings.setValue("verilatorRoot", verilatorRoot);
+    settings.setValue("jobs", jobs);
+    settings.setValue("usePrecompiledHeader", usePrecompiledHeader);
+    settings.endGroup();
+}
+
+BuildOrchestrator::BuildOrchestrator(JobRunner* runner, QObject* parent)
+    : QObject(parent)
+    , m_runner(runner)
+    , m_settings(Settings::load())
+{
+    if (m_runner) {
+        connect(m_runner, &JobRunner::jobChanged, this, &BuildOrchestrator::onJobChanged);
+    }
+}
+
+BuildOrchestrator::~BuildOrchestrator()
+{
+    if (m_runner) {
+        disconnect(m_runner, nullptr, this, nullptr);
+        m_runner->cancel(m_jobTargets.keys());
+        if (m_savedMaxConcurrent > 0) {
+            m_runner->setMaxConcurrent(m_savedMaxConcurrent);
+        }
+    }
+}
+
+QString BuildOrchestrator::buildDirectory(const QString& workingDirectory)
+{
+    return QDir(workingDirectory).filePath(BUILD_DIRECTORY);
+}
+
+bool BuildOrchestrator::build(const QString& workingDirectory, const Netlist& netlist)
+{
+    if (isBuilding()) {
+        return false;
+    }
+
+    m_result = Result();
+    m_result.warnings = netlist.warnings();
+    m_timer.start();
+    m_failed = false;
+    m_workingDirectory = workingDirectory;
+    m_buildDirectory = buildDirectory(workingDirectory);
+    m_phase = Phase::Compile;  // Until finish(), even if it fails right away
+
+    if (!m_runner) {
+        finish(false, "No job runner is available");
+        return true;
+    }
+    if (workingDirectory.isEmpty()) {
+        finish(false, "No project is open");
+        return true;
+    }
+    if (netlist.instances().isEmpty()) {
+        finish(false, "The schematic has no components to build");
+        return true;
+    }
+    if (QStandardPaths::findExecutable(compiler()).isEmpty() && !QFileInfo(compiler()).isExecutable()) {
+        finish(false, QString("Compiler %1 not found; set CXX or the compiler in the build settings").arg(compiler()));
+        return true;
+    }
+
+    loadManifest();
+    if (!writeSources(netlist)) {
+        finish(false, QString("Could not write the build sources to %1").arg(m_buildDirectory));
+        return true;
+    }
+    removeStaleUnits();
+
+    const int jobs = m_settings.jobs > 0 ? m_settings.jobs : QThread::idealThreadCount();
+    // Borrowed for the build; finish() hands back the limit set in the Jobs tab
+    m_savedMaxConcurrent = m_runner->maxConcurrent();
+    m_runner->setMaxConcurrent(jobs);
+    qDebug() << "🔨 Build started:" << m_units.size() << "units," << jobs << "jobs";
+
+    startPrecompiledHeader();
+    return true;
+}
+
+void BuildOrchestrator::cancel()
+{
+    if (!isBuilding()) {
+        return;
+    }
+    // Forget the jobs first; their cancellation must not count as a compile failure
+    const QList<int> ids = m_jobTargets.keys();
+    m_jobTargets.clear();
+    if (m_runner) {
+        m_runner->cancel(ids);
+    }
+    finish(false, "Build cancelled");
+}
+
+bool BuildOrchestrator::clean(const QString& workingDirectory)
+{
+    if (isBuilding()) {
+        return false;
+    }
+    m_records.clear();
+    m_stamps.clear();
+    m_pchHash.clear();
+    m_linkHash.clear();
+    QDir directory(buildDirectory(workingDirectory));
+    return !directory.exists() || directory.removeRecursively();
+}
+
+bool BuildOrchestrator::writeSources(const Netlist& netlist)
+{
+    const QDir buildDir(m_buildDirectory);
+    if (!buildDir.mkpath("units") || !buildDir.mkpath("obj")) {
+        return false;
+    }
+
+    m_units.clear();
+    m_rtlModules.clear();
+    bool ok = writeIfChanged(buildDir.filePath("scv_pch.h"),
+                             "// scv_pch.h\n// Generated by SCV, do not edit\n#include <systemc.h>\n");
+
+    // Channels are handed over in port order: inputs, then outputs
+    QHash<QString, QString> netOfPin;
+    for (const Netlist::Net& net : netlist.nets()) {
+        for (const Netlist::Pin& pin : net.pins) {
+            netOfPin.insert(netlist.pinName(pin), net.name);
+        }
+    }
+
+    QString declarations;
+    QString calls;
+    for (const Netlist::Instance& instance : netlist.instances()) {
+        Unit unit;
+        unit.name = instance.name;
+        unit.source = buildDir.filePath("units/" + instance.name + ".cpp");
+        unit.object = buildDir.filePath("obj/" + instance.name + ".o");
+        unit.depFile = buildDir.filePath("obj/" + instance.name + ".d");
+        unit.rtl = instance.rtl;
+        if (instance.rtl) {
+            m_rtlModules.append(instance.componentId);
+        }
+
+        QString source;
+        source += QString("// %1.cpp\n").arg(instance.name);
+        source += QString("// Generated by SCV from %1, do not edit\n").arg(instance.sourceFile);
+        source += "#include \"scv_pch.h\"\n";
+        source += "#include \"scv_units.h\"\n";
+        source += QString("#include \"%1\"\n\n").arg(instance.sourceFile);
+        source += createSignature(instance) + "\n{\n";
+        source += QString("%1%2* module = new %2(name);\n").arg(INDENT, instance.moduleName);
+        int channel = 0;
+        QString channels;
+        for (const QList<Port>* ports : {&instance.inputs, &instance.outputs}) {
+            for (const Port& port : *ports) {
+                source += QString("%1scv_bind(module->%2, channels.at(%3));\n").arg(INDENT, port.name).arg(channel++);
+                channels += (channels.isEmpty() ? "&" : ", &") + netOfPin.value(instance.name + "." + port.name);
+            }
+        }
+        source += QString("%1return module;\n}\n").arg(INDENT);
+        ok = writeIfChanged(unit.source, source) && ok;
+
+        declarations += createSignature(instance) + ";\n";
+        calls += QString("%1%2(\"%3\", {%4});\n").arg(INDENT, createFunction(instance), instance.name, channels);
+        m_units.append(unit);
+    }
+
+    ok = writeIfChanged(buildDir.filePath("scv_units.h"),
+                        UNITS_HEADER + declarations + "\n#endif // SCV_UNITS_H\n") && ok;
+
+    // Signal declarations are the ones the exported sc_main.cpp uses
+    const QHash<QString, QString> sections = TestbenchExporter::renderSections(netlist);
+    QString main;
+    main += QString("// %1.cpp\n").arg(MAIN_UNIT);
+    main += "// Generated by SCV from the schematic, do not edit\n";
+    main += "#include \"scv_pch.h\"\n";
+    main += "#include \"scv_units.h\"\n";
+    main += "#include <cstdlib>\n\n";
+    main += "int sc_main(int argc, char* argv[])\n{\n";
+    for (const QString& warning : netlist.warnings()) {
+        main += QString("%1// Warning: %2\n").arg(INDENT, warning);
+    }
+    main += sections.value("clocks") + sections.value("signals") + "\n" + calls + "\n";
+    main += QString("%1// Run time in ns from the first argument, 1 us by default\n").arg(INDENT);
+    main += QString("%1sc_start(argc > 1 ? sc_time(std::atof(argv[1]), SC_NS) : sc_time(1, SC_US));\n").arg(INDENT);
+    main += QString("%1return 0;\n}\n").arg(INDENT);
+
+    Unit mainUnit;
+    mainUnit.name = MAIN_UNIT;
+    mainUnit.source = buildDir.filePath(QString(MAIN_UNIT) + ".cpp");
+    mainUnit.object = buildDir.filePath(QString("obj/%1.o").arg(MAIN_UNIT));
+    mainUnit.depFile = buildDir.filePath(QString("obj/%1.d").arg(MAIN_UNIT));
+    ok = writeIfChanged(mainUnit.source, main) && ok;
+    m_units.append(mainUnit);
+
+    return ok;
+}
+
+void BuildOrchestrator::removeStaleUnits()
+{
+    QSet<QString> current;
+    for (const Unit& unit : m_units) {
+        current.insert(unit.name);
+    }
+
+    const QDir buildDir(m_buildDirectory);
+    const QDir unitsDir(buildDir.filePath("units"));
+    for (const QFileInfo& info : unitsDir.entryInfoList({"*.cpp"}, QDir::Files)) {
+        const QString name = info.completeBaseName();
+        if (current.contains(name)) {
+            continue;
+        }
+        QFile::remove(info.absoluteFilePath());
+        QFile::remove(buildDir.filePath("obj/" + name + ".o"));
+        QFile::remove(buildDir.filePath("obj/" + name + ".d"));
+        m_records.remove(name);
+    }
+}
+
+void BuildOrchestrator::startPrecompiledHeader()
+{
+    const QString gch = QDir(m_buildDirectory).filePath("scv_pch.h.gch");
+    if (!m_settings.usePrecompiledHeader) {
+        // GCC would still pick up a leftover one
+        QFile::remove(gch);
+        m_pchHash.clear();
+        startCompile();
+        return;
+    }
+
+    const QString command = precompiledHeaderCommand();
+    m_pendingHash = QCryptographicHash::hash(command.toUtf8(), QCryptographicHash::Sha1);
+    if (QFileInfo::exists(gch) && m_pchHash == m_pendingHash) {
+        startCompile();
+        return;
+    }
+
+    QFile::remove(gch);
+    m_pchHash.clear();
+    m_phase = Phase::PrecompiledHeader;
+    emit progress("Precompiling systemc.h");
+    submit(PCH_TARGET, command);
+    if (m_phase == Phase::PrecompiledHeader && m_jobTargets.isEmpty()) {
+        startCompile();  // Could not be queued; build without it
+    }
+}
+
+void BuildOrchestrator::startCompile()
+{
+    m_phase = Phase::Compile;
+
+    // A job that fails to start finishes inside submit(); completion waits for the loop
+    m_submitting = true;
+    for (const Unit& unit : m_units) {
+        const QString command = compileCommand(unit);
+        if (!isDirty(unit, commandHash(command))) {
+            ++m_result.upToDate;
+            continue;
+        }
+
+        // Hashes as of now, so an edit made while compiling still counts as a change
+        QHash<QString, QByteArray> snapshot;
+        snapshot.insert(unit.source, fileHash(unit.source));
+        const UnitRecord record = m_records.value(unit.name);
+        for (auto it = record.dependencies.constBegin(); it != record.dependencies.constEnd(); ++it) {
+            snapshot.insert(it.key(), fileHash(it.key()));
+        }
+        m_snapshots.insert(unit.name, snapshot);
+        m_records.remove(unit.name);
+
+        submit(unit.name, command);
+    }
+    m_submitting = false;
+
+    if (m_jobTargets.isEmpty()) {
+        if (m_failed) {
+            finish(false, "Compilation failed, see the Problems view");
+        } else {
+            startLink();
+        }
+        return;
+    }
+    emit progress(QString("Compiling %1 of %2 units").arg(m_jobTargets.size()).arg(m_units.size()));
+}
+
+void BuildOrchestrator::startLink()
+{
+    m_phase = Phase::Link;
+    const QDir buildDir(m_buildDirectory);
+    const QDir objDir(QDir(m_workingDirectory).filePath("obj_dir"));
+
+    // Objects go through a response file to stay clear of command line limits
+    QStringList inputs;
+    for (const Unit& unit : m_units) {
+        inputs.append(unit.object);
+    }
+    for (const QString& module : m_rtlModules) {
+        const QString archive = objDir.filePath(QString("V%1__ALL.a").arg(module));
+        if (!QFileInfo::exists(archive)) {
+            finish(false, QString("obj_dir/V%1__ALL.a not found; run make verilate first").arg(module));
+            return;
+        }
+        inputs.append(archive);
+    }
+    if (!m_rtlModules.isEmpty()) {
+        for (const QFileInfo& info : objDir.entryInfoList({"verilated*.o"}, QDir::Files, QDir::Name)) {
+            inputs.append(info.absoluteFilePath());
+        }
+    }
+
+    QString responseFile;
+    QByteArray stamps;
+    for (const QString& input : inputs) {
+        responseFile += quoted(QDir::fromNativeSeparators(input)) + "\n";
+        stamps += QByteArray::number(QFileInfo(input).lastModified().toMSecsSinceEpoch()) + '\n';
+    }
+    if (!writeIfChanged(buildDir.filePath("link.rsp"), responseFile)) {
+        finish(false, "Could not write the link response file");
+        return;
+    }
+
+    const QString command = linkCommand();
+    m_pendingHash = QCryptographicHash::hash(command.toUtf8() + '\n' + responseFile.toUtf8() + stamps,
+                                             QCryptographicHash::Sha1);
+    m_result.executable = buildDir.filePath(EXECUTABLE_NAME);
+#ifdef Q_OS_WIN
+    m_result.executable += ".exe";
+#endif
+    if (QFileInfo::exists(m_result.executable) && m_linkHash == m_pendingHash) {
+        finish(true);
+        return;
+    }
+
+    emit progress("Linking " + QString(EXECUTABLE_NAME));
+    submit(LINK_TARGET, command);
+    if (m_phase == Phase::Link && m_failed) {
+        finish(false, "Could not queue the link job");
+    }
+}
+
+void BuildOrchestrator::finish(bool ok, const QString& errorString)
+{
+    m_phase = Phase::Idle;
+    m_jobTargets.clear();
+    m_snapshots.clear();
+    if (m_runner && m_savedMaxConcurrent > 0) {
+        m_runner->setMaxConcurrent(m_savedMaxConcurrent);
+    }
+    m_savedMaxConcurrent = 0;
+    if (!m_buildDirectory.isEmpty() && QDir(m_buildDirectory).exists()) {
+        saveManifest();
+    }
+
+    m_result.ok = ok;
+    m_result.errorString = errorString;
+    m_result.elapsedMs = m_timer.elapsed();
+    if (!ok) {
+        m_result.executable.clear();
+    }
+
+    if (ok) {
+        qDebug() << "✅ Build finished in" << m_result.elapsedMs << "ms | Compiled:" << m_result.compiled
+                 << "| Up to date:" << m_result.upToDate << "| Linked:" << m_result.linked;
+    } else {
+        qWarning() << "❌ Build failed:" << errorString;
+    }
+    emit finished(m_result);
+}
+
+void BuildOrchestrator::submit(const QString& target, const QString& command)
+{
+    // The sweep only labels the job in the Jobs tab; the command has no placeholders
+    QString error;
+    QVector<int> ids;
+    if (m_runner->submit(command, "target=" + target, &error, &ids) != 1) {
+        qWarning() << "Could not queue build job" << target << error;
+        m_failed = true;
+        return;
+    }
+
+    // A job that fails to start has already finished before submit() returns
+    const int id = ids.first();
+    m_jobTargets.insert(id, target);
+    onJobChanged(id);
+}
+
+void BuildOrchestrator::onJobChanged(int id)
+{
+    auto it = m_jobTargets.find(id);
+    if (it == m_jobTargets.end()) {
+        return;
+    }
+    const JobRecord* job = m_runner->job(id);
+    if (!job || job->state == JobState::Queued || job->state == JobState::Running) {
+        return;
+    }
+
+    const QString target = it.value();
+    m_jobTargets.erase(it);
+    const bool passed = job->state == JobState::Passed;
+
+    switch (m_phase) {
+        case Phase::PrecompiledHeader:
+            if (passed) {
+                m_pchHash = m_pendingHash;
+            } else {
+                m_result.warnings.append("Precompiling systemc.h failed; compiling without it");
+                QFile::remove(QDir(m_buildDirectory).filePath("scv_pch.h.gch"));
+            }
+            startCompile();
+            break;
+
+        case Phase::Compile:
+            onUnitCompiled(target, passed);
+            if (m_jobTargets.isEmpty() && !m_submitting) {
+                if (m_failed) {
+                    finish(false, "Compilation failed, see the Problems view");
+                } else {
+                    startLink();
+                }
+            }
+            break;
+
+        case Phase::Link:
+            if (passed) {
+                m_linkHash = m_pendingHash;
+                m_result.linked = true;
+                finish(true);
+            } else {
+                finish(false, "Linking failed, see the Jobs view");
+            }
+            break;
+
+        case Phase::Idle:
+            break;
+    }
+}
+
+void BuildOrchestrator::onUnitCompiled(const QString& name, bool passed)
+{
+    const QHash<QString, QByteArray> snapshot = m_snapshots.take(name);
+    if (!passed) {
+        m_failed = true;
+        return;
+    }
+
+    auto unit = std::find_if(m_units.cbegin(), m_units.cend(), [&name](const Unit& candidate) {
+        return candidate.name == name;
+    });
+    if (unit == m_units.cend()) {
+        return;
+    }
+
+    UnitRecord record;
+    record.commandHash = commandHash(compileCommand(*unit));
+    for (const QString& dependency : readDepFile(unit->depFile)) {
+        const QString path = QFileInfo(dependency).absoluteFilePath();
+        record.dependencies.insert(path, snapshot.contains(path) ? snapshot.value(path) : fileHash(path));
+    }
+    if (record.dependencies.isEmpty()) {
+        record.dependencies.insert(unit->source, snapshot.value(unit->source));
+    }
+    m_records.insert(name, record);
+    ++m_result.compiled;
+
+    const int remaining = m_jobTargets.size();
+    if (remaining > 0) {
+        emit progress(QString("Compiled %1, %2 remaining").arg(name).arg(remaining));
+    }
+}
+
+bool BuildOrchestrator::isDirty(const Unit& unit, const QByteArray& commandHash)
+{
+    auto it = m_records.constFind(unit.name);
+    if (it == m_records.constEnd() || it->commandHash != commandHash || it->dependencies.isEmpty()
+        || !QFileInfo::exists(unit.object)) {
+        return true;
+    }
+    for (auto dependency = it->dependencies.constBegin(); dependency != it->dependencies.constEnd(); ++dependency) {
+        if (fileHash(dependency.key()) != dependency.value()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray BuildOrchestrator::fileHash(const QString& path)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        m_stamps.remove(path);
+        return QByteArray();
+    }
+
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+    auto it = m_stamps.constFind(path);
+    if (it != m_stamps.constEnd() && it->mtime == mtime && it->size == info.size()) {
+        return it->hash;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+
+    FileStamp stamp;
+    stamp.mtime = mtime;
+    stamp.size = info.size();
+    stamp.hash = hash.result();
+    m_stamps.insert(path, stamp);
+    return stamp.hash;
+}
+
+QByteArray BuildOrchestrator::commandHash(const QString& command) const
+{
+    // A rebuilt precompiled header invalidates every object compiled against it
+    QByteArray key = command.toUtf8();
+    if (m_settings.usePrecompiledHeader && !m_pchHash.isEmpty()) {
+        key += '\n' + m_pchHash;
+    }
+    return QCryptographicHash::hash(key, QCryptographicHash::Sha1);
+}
+
+QStringList BuildOrchestrator::readDepFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QStringList();
+    }
+    QString text = QString::fromUtf8(file.readAll());
+    text.replace("\\\n", " ");
+
+    // "target: dep dep ..."; a ':' followed by a path separator is a drive letter
+    int start = 0;
+    for (int i = 0; i + 1 < text.size(); ++i) {
+        if (text.at(i) == QLatin1Char(':') && text.at(i + 1).isSpace()) {
+            start = i + 1;
+            break;
+        }
+    }
+
+    QStringList dependencies;
+    QString current;
+    for (int i = start; i < text.size(); ++i) {
+        const QChar c = text.at(i);
+        if (c == QLatin1Char('\\') && i + 1 < text.size() && text.at(i + 1) == QLatin1Char(' ')) {
+            current += QLatin1Char(' ');
+            ++i;
+        } else if (c == QLatin1Char('$') && i + 1 < text.size() && text.at(i + 1) == QLatin1Char('$')) {
+            current += QLatin1Char('$');
+            ++i;
+        } else if (c.isSpace()) {
+            if (!current.isEmpty()) {
+                dependencies.append(current);
+                current.clear();
+            }
+            if (c == QLatin1Char('\n')) {
+                break;  // Only the first rule; -MP stubs follow
+            }
+        } else {
+            current += c;
+        }
+    }
+    if (!current.isEmpty()) {
+        dependencies.append(current);
+    }
+    return dependencies;
+}
+
+QString BuildOrchestrator::compileCommand(const Unit& unit) const
+{
+    return QString("%1 %2 %3 -MMD -MF %4 -c %5 -o %6")
+        .arg(compiler(), m_settings.cxxFlags, includeFlags(unit.rtl),
+             quoted(unit.depFile), quoted(unit.source), quoted(unit.object));
+}
+
+QString BuildOrchestrator::precompiledHeaderCommand() const
+{
+    const QDir buildDir(m_buildDirectory);
+    return QString("%1 %2 %3 -x c++-header %4 -o %5")
+        .arg(compiler(), m_settings.cxxFlags, includeFlags(false),
+             quoted(buildDir.filePath("scv_pch.h")), quoted(buildDir.filePath("scv_pch.h.gch")));
+}
+
+QString BuildOrchestrator::linkCommand() const
+{
+    const QDir buildDir(m_buildDirectory);
+    QString executable = buildDir.filePath(EXECUTABLE_NAME);
+#ifdef Q_OS_WIN
+    executable += ".exe";
+#endif
+
+    QString command = QString("%1 @%2 -o %3").arg(compiler(), quoted(buildDir.filePath("link.rsp")), quoted(executable));
+    const QString libraryDirectory = systemcLibraryDirectory(m_settings.systemcHome);
+    if (!libraryDirectory.isEmpty()) {
+        command += " -L" + quoted(libraryDirectory);
+#ifndef Q_OS_WIN
+        command += " -Wl,-rpath," + quoted(libraryDirectory);
+#endif
+    }
+    command += " -lsystemc -lpthread";
+    return command;
+}
+
+QString BuildOrchestrator::includeFlags(bool rtl) const
+{
+    QStringList flags;
+    flags << "-I" + quoted(m_buildDirectory) << "-I" + quoted(m_workingDirectory);
+    if (!m_settings.systemcHome.isEmpty()) {
+        flags << "-I" + quoted(QDir(m_settings.systemcHome).filePath("include"));
+    }
+    if (rtl) {
+        flags << "-I" + quoted(QDir(m_workingDirectory).filePath("obj_dir"));
+        if (!m_settings.verilatorRoot.isEmpty()) {
+            const QDir root(m_settings.verilatorRoot);
+            flags << "-I" + quoted(root.filePath("include")) << "-I" + quoted(root.filePath("include/vltstd"));
+        }
+    }
+    return flags.join(' ');
+}
+
+QString BuildOrchestrator::compiler() const
+{
+    return m_settings.compiler.isEmpty() ? QString("g++") : m_settings.compiler;
+}
+
+bool BuildOrchestrator::loadManifest()
+{
+    m_records.clear();
+    m_stamps.clear();
+    m_pchHash.clear();
+    m_linkHash.clear();
+
+    QFile file(QDir(m_buildDirectory).filePath(MANIFEST_NAME));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != MANIFEST_VERSION) {
+        return false;  // Everything is rebuilt
+    }
+
+    m_pchHash = QByteArray::fromHex(root.value("pch").toString().toLatin1());
+    m_linkHash = QByteArray::fromHex(root.value("link").toString().toLatin1());
+
+    const QJsonObject units = root.value("units").toObject();
+    for (auto it = units.constBegin(); it != units.constEnd(); ++it) {
+        const QJsonObject unit = it.value().toObject();
+        UnitRecord record;
+        record.commandHash = QByteArray::fromHex(unit.value("command").toString().toLatin1());
+        const QJsonObject dependencies = unit.value("dependencies").toObject();
+        for (auto dependency = dependencies.constBegin(); dependency != dependencies.constEnd(); ++dependency) {
+            record.dependencies.insert(dependency.key(), QByteArray::fromHex(dependency.value().toString().toLatin1()));
+        }
+        m_records.insert(it.key(), record);
+    }
+
+    const QJsonObject files = root.value("files").toObject();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        FileStamp stamp;
+        stamp.mtime = qint64(entry.value("mtime").toDouble());
+        stamp.size = qint64(entry.value("size").toDouble());
+        stamp.hash = QByteArray::fromHex(entry.value("hash").toString().toLatin1());
+        m_stamps.insert(it.key(), stamp);
+    }
+    return true;
+}
+
+bool BuildOrchestrator::saveManifest() const
+{
+    QJsonObject units;
+    QSet<QString> referenced;
+    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+        QJsonObject dependencies;
+        for (auto dependency = it->dependencies.constBegin(); dependency != it->dependencies.constEnd(); ++dependency) {
+            dependencies.insert(dependency.key(), hex(dependency.value()));
+            referenced.insert(dependency.key());
+        }
+        QJsonObject unit;
+        unit.insert("command", hex(it->commandHash));
+        unit.insert("dependencies", dependencies);
+        units.insert(it.key(), unit);
+    }
+
+    // Only stamps of files some unit depends on are worth keeping
+    QJsonObject files;
+    for (auto it = m_stamps.constBegin(); it != m_stamps.constEnd(); ++it) {
+        if (!referenced.contains(it.key())) {
+            continue;
+        }
+        QJsonObject entry;
+        entry.insert("mtime", double(it->mtime));
+        entry.insert("size", double(it->size));
+        entry.insert("hash", hex(it->hash));
+        files.insert(it.key(), entry);
+    }
+
+    QJsonObject root;
+    root.insert("version", MANIFEST_VERSION);
+    root.insert("pch", hex(m_pchHash));
+    root.insert("link", hex(m_linkHash));
+    root.insert("units", units);
+    root.insert("files", files);
+
+    QSaveFile file(QDir(m_buildDirectory).filePath(MANIFEST_NAME));
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0) {
+        qWarning() << "Failed to write build manifest:" << file.errorString();
+        return false;
+    }
+    return file.commit();
+}
+
+bool BuildOrchestrator::writeIfChanged(const QString& path, const QString& content)
+{
+    // Unchanged sources keep their timestamp and hash
+    const QByteArray data = content.toUtf8();
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly) && existing.readAll() == data) {
+        return true;
+    }
+    existing.close();
+
+    QSaveFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) >= 0 && file.commit();
+}
+
+QString BuildOrchestrator::quoted(const QString& path)
+{
+    return '"' + path + '"';
+}
@@ -0,0 +1,977 @@
+// SchematicCommands.cpp
+#include "commands/SchematicCommands.h"
+#include "commands/UndoHistory.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "graphics/ModuleGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/TextGraphicsItem.h"
+#include "scene/SchematicScene.h"
+#include "scene/SchematicHierarchy.h"
+#include "scene/WireManager.h"
+#include "utils/PersistenceManager.h"
+#include <QGraphicsItem>
+#include <QObject>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSet>
+#include <QDebug>
+
+namespace {
+
+// The files of component @p componentId as they are on disk, by name
+QHash<QString, QByteArray> readComponentFiles(const QString& componentId)
+{
+    PersistenceManager& pm = PersistenceManager::instance();
+    QHash<QString, QByteArray> files;
+    if (pm.getWorkingDirectory().isEmpty()) {
+        return files;
+    }
+
+    pm.flushPendingWrites();   // A queued write would be missing from the copy
+    const QDir dir(pm.getWorkingDirectory());
+    for (const QString& name : dir.entryList({componentId + ".*"}, QDir::Files)) {
+        QFile file(dir.filePath(name));
+        if (file.open(QIODevice::ReadOnly)) {
+            files.insert(name, file.readAll());
+        }
+    }
+    return files;
+}
+
+void writeComponentFiles(const QHash<QString, QByteArray>& files)
+{
+    const QDir dir(PersistenceManager::instance().getWorkingDirectory());
+    for (auto it = files.cbegin(); it != files.cend(); ++it) {
+        QFile file(dir.filePath(it.key()));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(it.value()) != it.value().size()) {
+            qWarning() << "⚠️ Cannot restore component file" << file.fileName() << ":" << file.errorString();
+        }
+    }
+}
+
+// Move the routing of @p wire along with the components it joins
+void shiftWire(WireGraphicsItem* wire, const QPointF& offset)
+{
+    if (offset.isNull() || wire->getControlPoints().isEmpty()) {
+        return;
+    }
+    WireGraphicsItem::Geometry geometry = wire->geometry();
+    for (QPointF& point : geometry.controlPoints) {
+        point += offset;
+    }
+    wire->setGeometry(geometry);
+    wire->saveGeometryToPersistence();
+}
+
+} // namespace
+
+SchematicCommand::ItemRef SchematicCommand::refOf(QGraphicsItem* item)
+{
+    // Every item the schematic records edits for is also a QObject
+    ItemRef ref;
+    ref.item = item;
+    ref.guard = dynamic_cast<QObject*>(item);
+    return ref;
+}
+
+SchematicCommand::WireRef SchematicCommand::wireRefOf(WireGraphicsItem* wire)
+{
+    return {wire, wire->getSource(), wire->getTarget()};
+}
+
+// ---------------------------------------------------------------------------
+
+MacroCommand::MacroCommand(const QString& text, QUndoCommand* parent)
+    : SchematicCommand(text, parent)
+{
+}
+
+MacroCommand::~MacroCommand()
+{
+    for (int i = m_commands.size() - 1; i >= 0; --i) {
+        delete m_commands.at(i);
+    }
+}
+
+void MacroCommand::append(QUndoCommand* command)
+{
+    m_commands.append(command);
+}
+
+void MacroCommand::undo()
+{
+    for (int i = m_commands.size() - 1; i >= 0; --i) {
+        m_commands.at(i)->undo();
+    }
+}
+
+void MacroCommand::redo()
+{
+    if (m_pending) {
+        m_pending = false;
+        return;
+    }
+    for (QUndoCommand* command : m_commands) {
+        command->redo();
+    }
+}
+
+qint64 MacroCommand::byteCost() const
+{
+    qint64 cost = sizeof(*this) + m_commands.size() * qint64(sizeof(QUndoCommand*));
+    for (const QUndoCommand* command : m_commands) {
+        cost += UndoHistory::costOf(command);
+    }
+    return cost;
+}
+
+// ---------------------------------------------------------------------------
+
+MoveItemsCommand::MoveItemsCommand(const QList<QGraphicsItem*>& items, const QPointF& delta, int gesture,
+                                   QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Move %n Item(s)", nullptr, items.size()), parent)
+    , m_deltas(items.size(), delta)
+    , m_gesture(gesture)
+{
+    m_items.reserve(items.size());
+    for (QGraphicsItem* item : items) {
+        m_items.append(refOf(item));
+    }
+}
+
+MoveItemsCommand::MoveItemsCommand(const QList<QPair<QGraphicsItem*, QPointF>>& moves, QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Move %n Item(s)", nullptr, moves.size()), parent)
+    , m_gesture(NoGesture)
+{
+    m_items.reserve(moves.size());
+    m_deltas.reserve(moves.size());
+    for (const auto& move : moves) {
+        m_items.append(refOf(move.first));
+        m_deltas.append(move.second);
+    }
+}
+
+void MoveItemsCommand::undo()
+{
+    translate(-1);
+}
+
+void MoveItemsCommand::redo()
+{
+    if (m_pending) {
+        m_pending = false;
+        return;
+    }
+    translate(1);
+}
+
+bool MoveItemsCommand::mergeWith(const QUndoCommand* other)
+{
+    const MoveItemsCommand* move = static_cast<const MoveItemsCommand*>(other);
+    if (m_gesture == NoGesture || move->m_gesture != m_gesture || move->m_items.size() != m_items.size()) {
+        return false;
+    }
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (move->m_items.at(i).item != m_items.at(i).item) {
+            return false;
+        }
+    }
+
+    bool moves = false;
+    for (int i = 0; i < m_deltas.size(); ++i) {
+        m_deltas[i] += move->m_deltas.at(i);
+        moves = moves || !m_deltas.at(i).isNull();
+    }
+    setObsolete(!moves);
+    return true;
+}
+
+qint64 MoveItemsCommand::byteCost() const
+{
+    return sizeof(*this) + m_items.size() * qint64(sizeof(ItemRef) + sizeof(QPointF));
+}
+
+void MoveItemsCommand::translate(int sign)
+{
+    // Each item saves its own position from itemChange(); the history's batch writes them once
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (QGraphicsItem* item = m_items.at(i).get()) {
+            item->setPos(item->pos() + sign * m_deltas.at(i));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+ResizeComponentCommand::ResizeComponentCommand(ReadyComponentGraphicsItem* component, const QSizeF& oldSize,
+                                               const QSizeF& newSize, QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Resize %1").arg(component->getName()), parent)
+    , m_component(component)
+    , m_oldSize(oldSize)
+    , m_newSize(newSize)
+{
+}
+
+void ResizeComponentCommand::apply(const QSizeF& size)
+{
+    if (!m_component) {
+        return;
+    }
+    if (m_component->getSize() != size) {
+        m_component->setSize(size.width(), size.height());
+    }
+
+    PersistenceManager& pm = PersistenceManager::instance();
+    const QString componentId = pm.getComponentId(m_component);
+    if (!componentId.isEmpty()) {
+        pm.updateComponentSize(componentId, m_component->getSize());
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+ChangeWiresCommand::ChangeWiresCommand(SchematicScene* scene, const QList<WireGraphicsItem*>& added,
+                                       const QList<WireGraphicsItem*>& removed, const QString& text,
+                                       QUndoCommand* parent)
+    : SchematicCommand(text, parent)
+    , m_scene(scene)
+    , m_added(refsOf(added))
+    , m_removed(refsOf(removed))
+{
+}
+
+ChangeWiresCommand::~ChangeWiresCommand()
+{
+    // Wires out of the scene belong to the command
+    for (const WireRef& ref : m_done ? m_removed : m_added) {
+        if (ref.wire && !ref.wire->scene()) {
+            delete ref.wire.data();
+        }
+    }
+}
+
+void ChangeWiresCommand::undo()
+{
+    disconnectAll(m_added);
+    connectAll(m_removed);
+    m_done = false;
+}
+
+void ChangeWiresCommand::redo()
+{
+    disconnectAll(m_removed);
+    connectAll(m_added);
+    m_done = true;
+}
+
+qint64 ChangeWiresCommand::byteCost() const
+{
+    // Detached wires are kept alive by the command, so they count too
+    qint64 cost = sizeof(*this);
+    for (const QVector<WireRef>* wires : {&m_added, &m_removed}) {
+        for (const WireRef& ref : *wires) {
+            cost += sizeof(WireRef) + sizeof(WireGraphicsItem);
+            if (ref.wire) {
+                cost += ref.wire->getControlPoints().size() * qint64(sizeof(QPointF));
+            }
+        }
+    }
+    return cost;
+}
+
+void ChangeWiresCommand::attach(SchematicScene* scene, WireGraphicsItem* wire)
+{
+    scene->addItem(wire);
+    wire->getSource()->addWire(wire);
+    wire->getTarget()->addWire(wire);
+    if (WireManager* wireManager = scene->getWireManager()) {
+        wireManager->registerWire(wire);
+    }
+    wire->updatePath();
+    wire->saveConnectionToPersistence();
+    scene->checkWireWidth(wire);
+}
+
+void ChangeWiresCommand::detach(WireGraphicsItem* wire)
+{
+    wire->removeConnectionFromPersistence();
+    if (wire->getSource()) {
+        wire->getSource()->removeWire(wire);
+    }
+    if (wire->getTarget()) {
+        wire->getTarget()->removeWire(wire);
+    }
+    if (SchematicScene* scene = qobject_cast<SchematicScene*>(wire->scene())) {
+        if (WireManager* wireManager = scene->getWireManager()) {
+            wireManager->unregisterWire(wire);
+        }
+    }
+    if (wire->scene()) {
+        wire->scene()->removeItem(wire);
+    }
+}
+
+QVector<ChangeWiresCommand::WireRef> ChangeWiresCommand::refsOf(const QList<WireGraphicsItem*>& wires)
+{
+    QVector<WireRef> refs;
+    refs.reserve(wires.size());
+    for (WireGraphicsItem* wire : wires) {
+        refs.append(wireRefOf(wire));
+    }
+    return refs;
+}
+
+void ChangeWiresCommand::connectAll(const QVector<WireRef>& wires)
+{
+    if (!m_scene) {
+        return;
+    }
+    for (const WireRef& ref : wires) {
+        // Skip wires already connected and wires whose components are gone
+        if (!ref.wire || ref.wire->scene() || !ref.source || !ref.target) {
+            continue;
+        }
+        attach(m_scene, ref.wire);
+    }
+}
+
+void ChangeWiresCommand::disconnectAll(const QVector<WireRef>& wires)
+{
+    for (const WireRef& ref : wires) {
+        if (ref.wire && ref.wire->scene()) {
+            detach(ref.wire);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+ChangeItemsCommand::ChangeItemsCommand(SchematicScene* scene, const QList<QGraphicsItem*>& added,
+                                       const QList<QGraphicsItem*>& removed, const QString& text,
+                                       QUndoCommand* parent)
+    : SchematicCommand(text, parent)
+    , m_scene(scene)
+    , m_added(recordsOf(added))
+    , m_removed(recordsOf(removed))
+{
+}
+
+ChangeItemsCommand::~ChangeItemsCommand()
+{
+    // Items out of the scene belong to the command; their persisted data is already gone
+    for (const ItemRecord& record : m_done ? m_removed : m_added) {
+        QGraphicsItem* item = record.ref.get();
+        if (item && !item->scene()) {
+            delete item;
+        }
+    }
+}
+
+void ChangeItemsCommand::undo()
+{
+    for (ItemRecord& record : m_added) {
+        detach(record);
+    }
+    for (ItemRecord& record : m_removed) {
+        attach(record);
+    }
+    m_done = false;
+}
+
+void ChangeItemsCommand::redo()
+{
+    for (ItemRecord& record : m_removed) {
+        detach(record);
+    }
+    for (ItemRecord& record : m_added) {
+        attach(record);
+    }
+    m_done = true;
+}
+
+qint64 ChangeItemsCommand::byteCost() const
+{
+    // Items out of the scene are kept alive by the command, and so are the copies of their files
+    qint64 cost = sizeof(*this);
+    for (const QVector<ItemRecord>* records : {&m_added, &m_removed}) {
+        for (const ItemRecord& record : *records) {
+            cost += sizeof(ItemRecord) + sizeof(ReadyComponentGraphicsItem)
+                    + (record.id.size() + record.filePath.size()) * qint64(sizeof(QChar));
+            for (auto it = record.files.cbegin(); it != record.files.cend(); ++it) {
+                cost += it.key().size() * qint64(sizeof(QChar)) + it.value().size();
+            }
+        }
+    }
+    return cost;
+}
+
+QVector<ChangeItemsCommand::ItemRecord> ChangeItemsCommand::recordsOf(const QList<QGraphicsItem*>& items)
+{
+    QVector<ItemRecord> records;
+    records.reserve(items.size());
+    for (QGraphicsItem* item : items) {
+        ItemRecord record;
+        record.ref = refOf(item);
+        records.append(record);
+    }
+    return records;
+}
+
+void ChangeItemsCommand::attach(ItemRecord& record)
+{
+    QGraphicsItem* item = record.ref.get();
+    if (!item || item->scene() || !m_scene) {
+        return;
+    }
+
+    // Registered before it enters the scene, so the scene files it under its block
+    PersistenceManager& pm = PersistenceManager::instance();
+    ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+    if (module && module->isRTLView()) {
+        if (!record.id.isEmpty()) {
+            pm.setRTLModuleName(module, record.id);
+            pm.saveRTLModulePlacement(record.id, record.filePath, module->pos(), module->getModuleInfo().name);
+        }
+    } else if (ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item)) {
+        if (!record.id.isEmpty()) {
+            writeComponentFiles(record.files);
+            pm.setComponentId(component, record.id);
+        }
+    } else if (TextGraphicsItem* textItem = SchematicItemType::cast<TextGraphicsItem*>(item)) {
+        pm.saveTextItem(textItem->getText(), textItem->pos(), textItem->getTextColor(), textItem->getTextFont());
+    }
+    record.files.clear();
+    m_scene->addItem(item);
+}
+
+void ChangeItemsCommand::detach(ItemRecord& record)
+{
+    QGraphicsItem* item = record.ref.get();
+    if (!item || !item->scene()) {
+        return;
+    }
+
+    // Unregistered from the maps before the item leaves, as for a deletion
+    PersistenceManager& pm = PersistenceManager::instance();
+    ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+    if (module && module->isRTLView()) {
+        record.id = pm.getRTLModuleName(module);
+        if (!record.id.isEmpty()) {
+            record.filePath = pm.getRTLModuleFilePath(record.id);
+            pm.removeRTLModulePlacement(record.id);
+            pm.unregisterRTLModule(module);
+        }
+    } else if (ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item)) {
+        record.id = pm.getComponentId(component);
+        if (!record.id.isEmpty()) {
+            record.files = readComponentFiles(record.id);
+            pm.deleteComponentFile(record.id, true);
+            pm.unregisterComponent(component);
+        }
+    } else if (TextGraphicsItem* textItem = SchematicItemType::cast<TextGraphicsItem*>(item)) {
+        pm.removeTextItem(textItem->getText(), textItem->pos());
+    }
+    item->setSelected(false);
+    item->scene()->removeItem(item);
+}
+
+// ---------------------------------------------------------------------------
+
+FoldBlockCommand::FoldBlockCommand(SchematicScene* scene, BlockGraphicsItem* block, const BlockData& data,
+                                   const QList<ReadyComponentGraphicsItem*>& members, QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Collapse %n Item(s)", nullptr, members.size()), parent)
+    , m_scene(scene)
+    , m_block(block)
+    , m_data(data)
+    , m_collapse(true)
+{
+    PersistenceManager& pm = PersistenceManager::instance();
+    const QSet<ReadyComponentGraphicsItem*> inside(members.cbegin(), members.cend());
+    QSet<WireGraphicsItem*> seen;
+    for (ReadyComponentGraphicsItem* member : members) {
+        m_members.append(member);
+        for (WireGraphicsItem* wire : member->getWires()) {
+            if (seen.contains(wire)) {
+                continue;
+            }
+            seen.insert(wire);
+
+            const bool sourceInside = inside.contains(wire->getSource());
+            const bool targetInside = inside.contains(wire->getTarget());
+            if (sourceInside && targetInside) {
+                m_wires.append(wireRefOf(wire));
+                continue;
+            }
+
+            // The wire to the block's port runs the same way as the one it stands in for
+            Crossing crossing;
+            crossing.member = wireRefOf(wire);
+            ConnectionEnd end;
+            const QPointF memberPort = sourceInside ? wire->getSourcePort() : wire->getTargetPort();
+            const QPointF blockPort = pm.connectionEnd(member, memberPort, end)
+                ? block->portFor(end.id, end.isRTL, end.port) : QPointF();
+            if (!blockPort.isNull()) {
+                crossing.block = wireRefOf(sourceInside
+                    ? new WireGraphicsItem(block, blockPort, wire->getTarget(), wire->getTargetPort())
+                    : new WireGraphicsItem(wire->getSource(), wire->getSourcePort(), block, blockPort));
+            }
+            m_crossings.append(crossing);
+        }
+    }
+}
+
+FoldBlockCommand::FoldBlockCommand(SchematicScene* scene, BlockGraphicsItem* block, QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Expand %1").arg(block->label()), parent)
+    , m_scene(scene)
+    , m_block(block)
+    , m_collapse(false)
+{
+    // Expanding needs the contents anyway, so they are loaded here once
+    PersistenceManager& pm = PersistenceManager::instance();
+    SchematicScene* inside = block->childScene();
+    for (ReadyComponentGraphicsItem* component : inside->components()) {
+        if (!component->parentItem()) {
+            m_members.append(component);
+        }
+    }
+    for (WireGraphicsItem* wire : inside->wires()) {
+        m_wires.append(wireRefOf(wire));
+    }
+
+    // Each wire to a port comes back as a wire to the member behind it
+    for (WireGraphicsItem* wire : block->getWires()) {
+        Crossing crossing;
+        crossing.block = wireRefOf(wire);
+        const bool fromBlock = wire->getSource() == block;
+        ConnectionEnd end;
+        if (pm.connectionEnd(block, fromBlock ? wire->getSourcePort() : wire->getTargetPort(), end)) {
+            const PersistenceManager::SceneEndpoint member = pm.sceneEndpoint(inside, end.id, end.isRTL, end.port);
+            if (member.item) {
+                crossing.member = wireRefOf(fromBlock
+                    ? new WireGraphicsItem(member.item, member.port, wire->getTarget(), wire->getTargetPort())
+                    : new WireGraphicsItem(wire->getSource(), wire->getSourcePort(), member.item, member.port));
+            }
+        }
+        m_crossings.append(crossing);
+    }
+}
+
+FoldBlockCommand::~FoldBlockCommand()
+{
+    // Whichever side is out of the scene belongs to the command
+    for (const Crossing& crossing : m_crossings) {
+        for (const WireRef* ref : {&crossing.member, &crossing.block}) {
+            if (ref->wire && !ref->wire->scene()) {
+                delete ref->wire.data();
+            }
+        }
+    }
+    if (m_block && !m_block->scene()) {
+        delete m_block.data();
+    }
+}
+
+qint64 FoldBlockCommand::byteCost() const
+{
+    // An unfolded block and the wires to its ports are kept alive by the command
+    qint64 cost = sizeof(*this) + sizeof(BlockGraphicsItem)
+                  + (m_data.components.size() + m_data.rtlModules.size()) * qint64(sizeof(QString))
+                  + m_data.ports.size() * qint64(sizeof(BlockPort))
+                  + m_members.size() * qint64(sizeof(QPointer<ReadyComponentGraphicsItem>))
+                  + m_wires.size() * qint64(sizeof(WireRef));
+    cost += m_crossings.size() * qint64(sizeof(Crossing) + sizeof(WireGraphicsItem));
+    return cost;
+}
+
+void FoldBlockCommand::fold()
+{
+    BlockPersistence* blocks = PersistenceManager::instance().getBlockPersistence();
+    BlockGraphicsItem* block = m_block;
+    if (!m_scene || !block || block->scene() || !blocks) {
+        return;
+    }
+
+    // The block is recorded first, so the members entering its scene are filed under it
+    SchematicScene::Transaction transaction(m_scene);
+    blocks->saveBlock(m_data);
+    m_scene->addItem(block);
+    SchematicScene* inside = block->childScene(false);
+    SchematicScene::Transaction insideTransaction(inside);
+
+    for (const Crossing& crossing : m_crossings) {
+        if (crossing.member.wire) {
+            SchematicHierarchy::takeWire(crossing.member.wire);
+        }
+        if (crossing.block.canConnect()) {
+            SchematicHierarchy::placeWire(m_scene, crossing.block.wire);
+        }
+    }
+    for (const WireRef& ref : m_wires) {
+        if (ref.wire) {
+            SchematicHierarchy::takeWire(ref.wire);
+        }
+    }
+
+    // The contents keep the coordinates they had when the block was collapsed
+    for (ReadyComponentGraphicsItem* member : m_members) {
+        if (!member || member->scene() != m_scene) {
+            continue;
+        }
+        member->setPos(member->pos() - m_offset);
+        member->setSelected(false);
+        m_scene->removeItem(member);
+        inside->addItem(member);
+        if (BlockGraphicsItem* child = SchematicItemType::cast<BlockGraphicsItem*>(member)) {
+            BlockData childData = blocks->block(child->blockName());
+            childData.parent = m_data.name;
+            blocks->saveBlock(childData);
+        }
+    }
+    for (const WireRef& ref : m_wires) {
+        if (ref.canConnect()) {
+            SchematicHierarchy::placeWire(inside, ref.wire);
+            shiftWire(ref.wire, -m_offset);
+        }
+    }
+    qDebug() << "📦 Folded" << m_members.size() << "item(s) into" << m_data.name;
+}
+
+void FoldBlockCommand::unfold()
+{
+    BlockPersistence* blocks = PersistenceManager::instance().getBlockPersistence();
+    BlockGraphicsItem* block = m_block;
+    if (!m_scene || !block || block->scene() != m_scene || !blocks) {
+        return;
+    }
+
+    // Kept for folding again, with whatever was renamed or moved since
+    m_data = blocks->block(block->blockName());
+    m_offset = block->pos() - m_data.origin;
+    SchematicScene* inside = block->childScene();
+    const QString scope = m_scene->blockName();
+    SchematicScene::Transaction transaction(m_scene);
+
+    {
+        SchematicScene::Transaction insideTransaction(inside);
+        for (const Crossing& crossing : m_crossings) {
+            if (crossing.block.wire) {
+                SchematicHierarchy::takeWire(crossing.block.wire);
+            }
+        }
+        for (const WireRef& ref : m_wires) {
+            if (ref.wire) {
+                SchematicHierarchy::takeWire(ref.wire);
+            }
+        }
+
+        // The contents follow the block if it was moved since it was collapsed
+        for (ReadyComponentGraphicsItem* member : m_members) {
+            if (!member || member->scene() != inside) {
+                continue;
+            }
+            member->setSelected(false);
+            inside->removeItem(member);
+            m_scene->addItem(member);
+            member->setPos(member->pos() + m_offset);
+            if (BlockGraphicsItem* child = SchematicItemType::cast<BlockGraphicsItem*>(member)) {
+                BlockData childData = blocks->block(child->blockName());
+                childData.parent = scope;
+                blocks->saveBlock(childData);
+            }
+        }
+    }
+
+    for (const WireRef& ref : m_wires) {
+        if (ref.canConnect()) {
+            SchematicHierarchy::placeWire(m_scene, ref.wire);
+            shiftWire(ref.wire, m_offset);
+        }
+    }
+    for (const Crossing& crossing : m_crossings) {
+        if (crossing.member.canConnect()) {
+            SchematicHierarchy::placeWire(m_scene, crossing.member.wire);
+        }
+    }
+
+    block->setSelected(false);
+    block->unloadChildScene();
+    m_scene->removeItem(block);
+    blocks->removeBlock(m_data.name);
+    qDebug() << "📦 Unfolded" << m_data.name << "-" << m_members.size() << "item(s)";
+}
+
+// ---------------------------------------------------------------------------
+
+RemoveBlockCommand::RemoveBlockCommand(SchematicScene* scene, BlockGraphicsItem* block, QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Delete %1").arg(block->label()), parent)
+    , m_scene(scene)
+    , m_block(block)
+{
+}
+
+RemoveBlockCommand::~RemoveBlockCommand()
+{
+    // A deleted block and its wires belong to the command; its contents are already gone
+    if (!m_done) {
+        return;
+    }
+    for (const WireRef& ref : m_wires) {
+        if (ref.wire && !ref.wire->scene()) {
+            delete ref.wire.data();
+        }
+    }
+    if (m_block && !m_block->scene()) {
+        delete m_block.data();
+    }
+}
+
+void RemoveBlockCommand::redo()
+{
+    PersistenceManager& pm = PersistenceManager::instance();
+    BlockPersistence* blocks = pm.getBlockPersistence();
+    BlockGraphicsItem* block = m_block;
+    if (!m_scene || !block || block->scene() != m_scene || !blocks) {
+        return;
+    }
+
+    // Everything below is what deleting the block takes from disk
+    const QString name = block->blockName();
+    QStringList blockNames;
+    QStringList componentIds;
+    QStringList moduleNames;
+    QStringList pendingBlocks{name};
+    while (!pendingBlocks.isEmpty()) {
+        const BlockData data = blocks->block(pendingBlocks.takeLast());
+        m_blocks.append(data);
+        blockNames.append(data.name);
+        pendingBlocks.append(blocks->childBlocks(data.name));
+        componentIds.append(data.components);
+        moduleNames.append(data.rtlModules);
+    }
+    // The blocks around it lose the ports leading inside
+    QString enclosing = blocks->parentOf(name);
+    for (int depth = 0; !enclosing.isEmpty() && depth < 64; ++depth) {
+        m_blocks.append(blocks->block(enclosing));
+        enclosing = blocks->parentOf(enclosing);
+    }
+
+    for (const QString& id : componentIds) {
+        m_files.insert(readComponentFiles(id));
+    }
+    const QSet<QString> modules(moduleNames.cbegin(), moduleNames.cend());
+    const QJsonArray placements = pm.loadRTLPlacementsJson()["placements"].toArray();
+    for (const QJsonValue& value : placements) {
+        const QJsonObject placement = value.toObject();
+        if (modules.contains(placement["moduleName"].toString())) {
+            const QJsonObject position = placement["position"].toObject();
+            m_modules.append({placement["moduleName"].toString(), placement["definition"].toString(),
+                              placement["filePath"].toString(),
+                              QPointF(position["x"].toDouble(), position["y"].toDouble())});
+        }
+    }
+    m_connections = pm.connectionsOf(componentIds);
+
+    // The block's wires stay connected in persistence until their components go below
+    const QList<WireGraphicsItem*> wires = block->getWires();
+    m_wires.clear();
+    for (WireGraphicsItem* wire : wires) {
+        m_wires.append(wireRefOf(wire));
+        SchematicHierarchy::takeWire(wire);
+    }
+    block->setSelected(false);
+    block->unloadChildScene();
+    m_scene->removeItem(block);
+
+    for (const QString& id : componentIds) {
+        pm.deleteComponentFile(id, true);
+    }
+    for (const QString& moduleName : moduleNames) {
+        pm.removeRTLModulePlacement(moduleName);
+    }
+    for (const QString& blockName : blockNames) {
+        blocks->removeBlock(blockName);
+    }
+    m_done = true;
+    qDebug() << "🗑️ Deleted block" << name << "with" << componentIds.size() << "component(s) and"
+             << moduleNames.size() << "RTL module(s)";
+}
+
+void RemoveBlockCommand::undo()
+{
+    PersistenceManager& pm = PersistenceManager::instance();
+    BlockPersistence* blocks = pm.getBlockPersistence();
+    BlockGraphicsItem* block = m_block;
+    if (!m_scene || !block || block->scene() || !blocks) {
+        return;
+    }
+
+    // The contents come back on disk; the block's scene loads them when it is opened
+    writeComponentFiles(m_files);
+    for (const ModulePlacement& module : m_modules) {
+        pm.saveRTLModulePlacement(module.name, module.filePath, module.position, module.definition);
+    }
+    for (const BlockData& data : m_blocks) {
+        blocks->saveBlock(data);
+    }
+    for (const ConnectionData& connection : m_connections) {
+        pm.saveConnection(connection.sourceId, connection.sourcePort, connection.targetId, connection.targetPort,
+                          connection.sourceIsRTL, connection.targetIsRTL, connection.controlPoints,
+                          connection.orthogonalOffset, connection.manualOffset);
+    }
+
+    m_scene->addItem(block);
+    for (const WireRef& ref : m_wires) {
+        if (ref.canConnect()) {
+            SchematicHierarchy::placeWire(m_scene, ref.wire);
+        }
+    }
+
+    // The next redo() takes a fresh copy
+    m_blocks.clear();
+    m_files.clear();
+    m_modules.clear();
+    m_connections.clear();
+    m_done = false;
+}
+
+qint64 RemoveBlockCommand::byteCost() const
+{
+    // While deleted, the block, its wires and the copies of everything inside are kept
+    qint64 cost = sizeof(*this) + sizeof(BlockGraphicsItem)
+                  + m_wires.size() * qint64(sizeof(WireRef) + sizeof(WireGraphicsItem))
+                  + m_modules.size() * qint64(sizeof(ModulePlacement));
+    for (const BlockData& data : m_blocks) {
+        cost += sizeof(BlockData) + (data.components.size() + data.rtlModules.size()) * qint64(sizeof(QString))
+                + data.ports.size() * qint64(sizeof(BlockPort));
+    }
+    for (auto it = m_files.cbegin(); it != m_files.cend(); ++it) {
+        cost += it.key().size() * qint64(sizeof(QChar)) + it.value().size();
+    }
+    for (const ConnectionData& connection : m_connections) {
+        cost += sizeof(ConnectionData) + connection.controlPoints.size() * qint64(sizeof(QPointF));
+    }
+    return cost;
+}
+
+// ---------------------------------------------------------------------------
+
+WireGeometryCommand::WireGeometryCommand(WireGraphicsItem* wire, const WireGraphicsItem::Geometry& before,
+                                         const WireGraphicsItem::Geometry& after, const QString& text,
+                                         QUndoCommand* parent)
+    : SchematicCommand(text, parent)
+    , m_wire(wire)
+    , m_before(before)
+    , m_after(after)
+{
+}
+
+qint64 WireGeometryCommand::byteCost() const
+{
+    return sizeof(*this) + (m_before.controlPoints.size() + m_after.controlPoints.size()) * qint64(sizeof(QPointF));
+}
+
+void WireGeometryCommand::apply(const WireGraphicsItem::Geometry& geometry)
+{
+    if (!m_wire) {
+        return;
+    }
+    m_wire->setGeometry(geometry);
+    m_wire->saveGeometryToPersistence();
+}
+
+// ---------------------------------------------------------------------------
+
+ComponentPropertiesCommand::State ComponentPropertiesCommand::State::of(const ReadyComponentGraphicsItem* component)
+{
+    State state;
+    state.position = component->pos();
+    state.size = component->getSize();
+    state.rotation = component->rotation();
+    state.opacity = component->opacity();
+    state.visible = component->isVisible();
+    if (component->hasCustomColor()) {
+        state.color = component->getCustomColor();
+    }
+    return state;
+}
+
+ComponentPropertiesCommand::ComponentPropertiesCommand(ReadyComponentGraphicsItem* component, const State& before,
+                                                       const State& after, const QString& text,
+                                                       QUndoCommand* parent)
+    : SchematicCommand(text, parent)
+    , m_component(component)
+    , m_before(before)
+    , m_after(after)
+{
+}
+
+void ComponentPropertiesCommand::apply(const State& state)
+{
+    ReadyComponentGraphicsItem* component = m_component;
+    if (!component) {
+        return;
+    }
+
+    PersistenceManager& pm = PersistenceManager::instance();
+    const QString componentId = pm.getComponentId(component);
+
+    // Position and rotation are saved by the component itself
+    component->setPos(state.position);
+    component->setRotation(state.rotation);
+
+    if (component->getSize() != state.size) {
+        component->setSize(state.size.width(), state.size.height());
+        if (!componentId.isEmpty()) {
+            pm.updateComponentSize(componentId, component->getSize());
+        }
+    }
+    if (component->opacity() != state.opacity) {
+        component->setOpacity(state.opacity);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentOpacity(componentId, state.opacity);
+        }
+    }
+    if (component->isVisible() != state.visible) {
+        component->setVisible(state.visible);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentVisibility(componentId, state.visible);
+        }
+    }
+
+    if (state.color.isValid()) {
+        component->setCustomColor(state.color);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentColor(componentId, state.color);
+        }
+    } else if (component->hasCustomColor()) {
+        component->clearCustomColor();
+        if (!componentId.isEmpty()) {
+            pm.updateComponentColor(componentId, QColor());
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TextEditCommand::TextEditCommand(TextGraphicsItem* item, const QString& oldText, const QString& newText,
+                                 QUndoCommand* parent)
+    : SchematicCommand(QObject::tr("Edit Text"), parent)
+    , m_item(item)
+    , m_oldText(oldText)
+    , m_newText(newText)
+{
+}
+
+qint64 TextEditCommand::byteCost() const
+{
+    return sizeof(*this) + (m_oldText.size() + m_newText.size()) * qint64(sizeof(QChar));
+}
+
+void TextEditCommand::apply(const QString& text)
+{
+    if (m_item) {
+        m_item->commitText(text);
+    }
+}
@@ -0,0 +1,242 @@
+// UndoHistory.cpp
+#include "commands/UndoHistory.h"
+#include "commands/SchematicCommands.h"
+#include "scene/SchematicScene.h"
+#include "utils/PersistenceManager.h"
+#include <QUndoCommand>
+#include <QDebug>
+#include <utility>
+
+UndoHistory::UndoHistory(QObject* parent)
+    : QObject(parent)
+{
+}
+
+UndoHistory::~UndoHistory()
+{
+    delete m_macro;
+    for (const Entry& entry : m_entries) {
+        delete entry.command;
+    }
+}
+
+void UndoHistory::push(QUndoCommand* command, SchematicScene* scene)
+{
+    if (!command) {
+        return;
+    }
+
+    PersistenceManager::Batch batch;
+
+    if (m_running) {
+        command->redo();
+        delete command;
+        return;
+    }
+    
+    if (m_macro) {
+        command->redo();
+        if (command->isObsolete()) {
+            delete command;
+        } else {
+            m_macro->append(command);
+        }
+        return;
+    }
+
+    const State before = state();
+    m_running = true;
+    command->redo();
+    m_running = false;
+    truncateRedo();
+
+    if (command->isObsolete()) {
+        delete command;
+        notify(before);
+        return;
+    }
+
+    // Merge into the previous command, as QUndoStack does
+    if (m_index > 0 && command->id() != -1) {
+        Entry& top = m_entries[m_index - 1];
+        if (top.command->id() == command->id() && top.command->mergeWith(command)) {
+            delete command;
+            m_bytesUsed -= top.cost;
+            if (top.command->isObsolete()) {
+                delete top.command;
+                m_entries.removeLast();
+                --m_index;
+            } else {
+                top.cost = costOf(top.command);
+                m_bytesUsed += top.cost;
+            }
+            notify(before);
+            return;
+        }
+    }
+
+    const qint64 cost = costOf(command);
+    m_entries.append({command, cost, scene});
+    m_bytesUsed += cost;
+    m_index = m_entries.size();
+    enforceBudget();
+    notify(before);
+}
+
+void UndoHistory::beginMacro(const QString& text, SchematicScene* scene)
+{
+    // The transaction undo() and redo() open around a command records nothing
+    if (m_macroDepth++ == 0 && !m_running) {
+        m_macro = new MacroCommand(text);
+        m_macroScene = scene;
+    }
+}
+
+void UndoHistory::endMacro()
+{
+    if (m_macroDepth == 0 || --m_macroDepth > 0) {
+        return;
+    }
+    
+    MacroCommand* macro = std::exchange(m_macro, nullptr);
+    if (!macro || macro->isEmpty()) {
+        delete macro;
+        return;
+    }
+    // The commands have already run, so this only records them
+    push(macro, std::exchange(m_macroScene, nullptr));
+}
+
+void UndoHistory::undo()
+{
+    if (!canUndo() || m_running || m_macro) {
+        return;
+    }
+
+    const State before = state();
+    run(m_entries.at(m_index - 1), true);
+    --m_index;
+    notify(before);
+}
+
+void UndoHistory::redo()
+{
+    if (!canRedo() || m_running || m_macro) {
+        return;
+    }
+
+    const State before = state();
+    run(m_entries.at(m_index), false);
+    ++m_index;
+    notify(before);
+}
+
+void UndoHistory::run(const Entry& entry, bool undo)
+{
+    PersistenceManager::Batch batch;
+    m_running = true;
+    if (entry.scene) {
+        SchematicScene::Transaction transaction(entry.scene);
+        undo ? entry.command->undo() : entry.command->redo();
+    } else {
+        undo ? entry.command->undo() : entry.command->redo();
+    }
+    m_running = false;
+}
+
+void UndoHistory::clear()
+{
+    const State before = state();
+    if (m_macro) {
+        // Commands already in the open macro refer to what is being cleared
+        const QString text = m_macro->text();
+        delete m_macro;
+        m_macro = new MacroCommand(text);
+    }
+    for (const Entry& entry : m_entries) {
+        delete entry.command;
+    }
+    m_entries.clear();
+    m_index = 0;
+    m_bytesUsed = 0;
+    notify(before);
+}
+
+QString UndoHistory::undoText() const
+{
+    return canUndo() ? m_entries.at(m_index - 1).command->text() : QString();
+}
+
+QString UndoHistory::redoText() const
+{
+    return canRedo() ? m_entries.at(m_index).command->text() : QString();
+}
+
+void UndoHistory::setByteBudget(qint64 bytes)
+{
+    const State before = state();
+    m_byteBudget = bytes;
+    enforceBudget();
+    notify(before);
+}
+
+qint64 UndoHistory::costOf(const QUndoCommand* command)
+{
+    const SchematicCommand* schematicCommand = dynamic_cast<const SchematicCommand*>(command);
+    qint64 cost = schematicCommand ? schematicCommand->byteCost()
+                                   : qint64(sizeof(QUndoCommand)) + command->text().size() * qint64(sizeof(QChar));
+    for (int i = 0; i < command->childCount(); ++i) {
+        cost += costOf(command->child(i));
+    }
+    return cost;
+}
+
+UndoHistory::State UndoHistory::state() const
+{
+    return {canUndo(), canRedo(), undoText(), redoText(), m_index};
+}
+
+void UndoHistory::notify(const State& before)
+{
+    const State after = state();
+    if (after.canUndo != before.canUndo) {
+        emit canUndoChanged(after.canUndo);
+    }
+    if (after.canRedo != before.canRedo) {
+        emit canRedoChanged(after.canRedo);
+    }
+    if (after.undoText != before.undoText) {
+        emit undoTextChanged(after.undoText);
+    }
+    if (after.redoText != before.redoText) {
+        emit redoTextChanged(after.redoText);
+    }
+    if (after.index != before.index) {
+        emit indexChanged(after.index);
+    }
+}
+
+void UndoHistory::truncateRedo()
+{
+    while (m_entries.size() > m_index) {
+        const Entry entry = m_entries.takeLast();
+        m_bytesUsed -= entry.cost;
+        delete entry.command;
+    }
+}
+
+void UndoHistory::enforceBudget()
+{
+    // The newest command always stays, however large
+    int dropped = 0;
+    while (m_bytesUsed > m_byteBudget && m_entries.size() - dropped > 1 && dropped < m_index) {
+        m_bytesUsed -= m_entries.at(dropped).cost;
+        delete m_entries.at(dropped).command;
+        ++dropped;
+    }
+    if (dropped > 0) {
+        m_entries.remove(0, dropped);
+        m_index -= dropped;
+        qDebug() << "↩️ Undo history over budget - dropped" << dropped << "oldest command(s)," << m_bytesUsed << "bytes kept";
+    }
+}
@@ -0,0 +1,365 @@
+// BlockGraphicsItem.cpp
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/wire/WireGraphicsItem.h"
+#include "graphics/ready/ComponentPortManager.h"
+#include "persistence/BlockPersistence.h"
+#include "scene/SchematicScene.h"
+#include "scene/SchematicHierarchy.h"
+#include "utils/PersistenceManager.h"
+#include <QPainter>
+#include <QFontMetrics>
+#include <QGraphicsSceneMouseEvent>
+#include <QGraphicsSceneHoverEvent>
+#include <QGraphicsSceneContextMenuEvent>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QLineF>
+#include <QMenu>
+#include <QPointer>
+#include <QTimer>
+#include <QDebug>
+
+BlockGraphicsItem::BlockGraphicsItem(const BlockData& data, QGraphicsItem* parent)
+    : ReadyComponentGraphicsItem(data.label, parent),
+      m_blockName(data.name),
+      m_label(data.label.isEmpty() ? data.name : data.label)
+{
+    setPorts(data.ports);
+}
+
+BlockGraphicsItem::~BlockGraphicsItem()
+{
+    // The inside goes with the block; its items are unregistered, their files kept
+    unloadChildScene();
+}
+
+void BlockGraphicsItem::unloadChildScene()
+{
+    if (m_childScene) {
+        SchematicHierarchy::unload(m_childScene.get());
+        m_childScene.reset();
+    }
+}
+
+void BlockGraphicsItem::setLabel(const QString& label)
+{
+    if (label.isEmpty() || label == m_label) {
+        return;
+    }
+    m_label = label;
+    setName(label);
+    if (BlockPersistence* blocks = PersistenceManager::instance().getBlockPersistence()) {
+        blocks->updateBlockLabel(m_blockName, label);
+    }
+    update();
+}
+
+const BlockPort* BlockGraphicsItem::memberOf(const QPointF& port) const
+{
+    for (int i = 0; i < m_inputPositions.size(); ++i) {
+        if (QLineF(m_inputPositions.at(i), port).length() < 1.0) {
+            return &m_ports.at(m_inputIndexes.at(i));
+        }
+    }
+    for (int i = 0; i < m_outputPositions.size(); ++i) {
+        if (QLineF(m_outputPositions.at(i), port).length() < 1.0) {
+            return &m_ports.at(m_outputIndexes.at(i));
+        }
+    }
+    return nullptr;
+}
+
+QPointF BlockGraphicsItem::portFor(const QString& memberId, bool isRTL, const QPointF& memberPort) const
+{
+    // Same 1px tolerance as ConnectionPersistence uses to match ports
+    for (int i = 0; i < m_inputIndexes.size(); ++i) {
+        const BlockPort& port = m_ports.at(m_inputIndexes.at(i));
+        if (port.memberId == memberId && port.memberIsRTL == isRTL && QLineF(port.memberPort, memberPort).length() < 1.0) {
+            return m_inputPositions.at(i);
+        }
+    }
+    for (int i = 0; i < m_outputIndexes.size(); ++i) {
+        const BlockPort& port = m_ports.at(m_outputIndexes.at(i));
+        if (port.memberId == memberId && port.memberIsRTL == isRTL && QLineF(port.memberPort, memberPort).length() < 1.0) {
+            return m_outputPositions.at(i);
+        }
+    }
+    return QPointF();
+}
+
+void BlockGraphicsItem::setPorts(const QVector<BlockPort>& ports)
+{
+    // Remember which member each wire leads to before the ports move
+    struct Attachment {
+        WireGraphicsItem* wire;
+        bool isSource;
+        BlockPort member;
+        bool found;
+    };
+    QVector<Attachment> attachments;
+    for (WireGraphicsItem* wire : getWires()) {
+        const bool isSource = wire->getSource() == this;
+        const BlockPort* member = memberOf(isSource ? wire->getSourcePort() : wire->getTargetPort());
+        attachments.append({wire, isSource, member ? *member : BlockPort(), member != nullptr});
+    }
+
+    m_ports = ports;
+    m_inputPositions.clear();
+    m_outputPositions.clear();
+    m_inputIndexes.clear();
+    m_outputIndexes.clear();
+    for (int i = 0; i < m_ports.size(); ++i) {
+        QList<QPointF>& positions = m_ports.at(i).isInput ? m_inputPositions : m_outputPositions;
+        QVector<int>& indexes = m_ports.at(i).isInput ? m_inputIndexes : m_outputIndexes;
+        positions.append(QPointF(m_ports.at(i).isInput ? 0.0 : WIDTH,
+                                 HEADER_HEIGHT + PORT_SPACING / 2 + positions.size() * PORT_SPACING));
+        indexes.append(i);
+    }
+
+    QList<WireGraphicsItem*> orphaned;
+    for (const Attachment& attachment : attachments) {
+        const QPointF port = attachment.found
+            ? portFor(attachment.member.memberId, attachment.member.memberIsRTL, attachment.member.memberPort)
+            : QPointF();
+        if (port.isNull()) {
+            orphaned.append(attachment.wire);
+        } else if (attachment.isSource) {
+            attachment.wire->setSourcePort(port);
+        } else {
+            attachment.wire->setTargetPort(port);
+        }
+    }
+    for (WireGraphicsItem* wire : orphaned) {
+        SchematicHierarchy::discardWire(wire);
+    }
+
+    // Resizing re-indexes the ports and redraws the wires
+    const int rows = qMax(m_inputPositions.size(), m_outputPositions.size());
+    setSize(WIDTH, qMax(80.0, HEADER_HEIGHT + rows * PORT_SPACING + 8.0));
+}
+
+void BlockGraphicsItem::syncWithPersistence()
+{
+    BlockPersistence* blocks = PersistenceManager::instance().getBlockPersistence();
+    if (!blocks || !blocks->contains(m_blockName)) {
+        return;
+    }
+    const BlockData data = blocks->block(m_blockName);
+    m_label = data.label.isEmpty() ? data.name : data.label;
+    setName(m_label);
+    setPorts(data.ports);
+    update();
+}
+
+SchematicScene* BlockGraphicsItem::childScene(bool loadContents)
+{
+    if (!m_childScene) {
+        m_childScene = std::make_unique<SchematicScene>();
+        m_childScene->setBlockName(m_blockName);
+        if (SchematicScene* parentScene = qobject_cast<SchematicScene*>(scene())) {
+            m_childScene->setUndoHistory(parentScene->undoHistory());
+            m_childScene->setDarkMode(parentScene->isDarkMode());
+        }
+        if (!loadContents) {
+            return m_childScene.get();
+        }
+        SchematicHierarchy::load(m_childScene.get());
+        qDebug() << "📂 Loaded the inside of block" << m_blockName << "-" << m_childScene->components().size()
+                 << "component(s)," << m_childScene->blocks().size() << "block(s)";
+    }
+    return m_childScene.get();
+}
+
+QList<QPointF> BlockGraphicsItem::getInputPorts() const
+{
+    return m_inputPositions;
+}
+
+QList<QPointF> BlockGraphicsItem::getOutputPorts() const
+{
+    return m_outputPositions;
+}
+
+int BlockGraphicsItem::portIndexAt(const QPointF& port, bool isInput) const
+{
+    const QList<QPointF>& positions = isInput ? m_inputPositions : m_outputPositions;
+    for (int i = 0; i < positions.size(); ++i) {
+        if (QLineF(positions.at(i), port).length() < 1.0) {
+            return (isInput ? m_inputIndexes : m_outputIndexes).at(i);
+        }
+    }
+    return -1;
+}
+
+QPointF BlockGraphicsItem::getPortAt(const QPointF& pos, bool& isInput) const
+{
+    for (const QPointF& port : m_inputPositions) {
+        if (QLineF(pos, port).length() < PORT_DETECTION_RADIUS) {
+            isInput = true;
+            return port;
+        }
+    }
+    for (const QPointF& port : m_outputPositions) {
+        if (QLineF(pos, port).length() < PORT_DETECTION_RADIUS) {
+            isInput = false;
+            return port;
+        }
+    }
+    return QPointF();
+}
+
+bool BlockGraphicsItem::isNearPort(const QPointF& pos) const
+{
+    bool isInput;
+    return !getPortAt(pos, isInput).isNull();
+}
+
+int BlockGraphicsItem::getPortWidth(const QPointF& port, bool isInput) const
+{
+    const int index = portIndexAt(port, isInput);
+    return index >= 0 ? m_ports.at(index).width : 0;
+}
+
+void BlockGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    const qreal offset = ComponentPortManager::PORT_RADIUS;
+    const QSizeF size = getSize();
+    const QRectF bodyRect(offset, offset, size.width(), size.height());
+
+    // A folder-like container: header strip and a doubled border
+    const QColor baseColor = hasCustomColor() ? getCustomColor() : QColor("#8FA8D7");
+    painter->setPen(QPen(baseColor.darker(160), isSelected() ? 2 : 1));
+    painter->setBrush(baseColor.lighter(150));
+    painter->drawRoundedRect(bodyRect.translated(3, 3), 6, 6);
+    painter->setBrush(baseColor.lighter(125));
+    painter->drawRoundedRect(bodyRect, 6, 6);
+
+    const QRectF headerRect(bodyRect.left(), bodyRect.top(), bodyRect.width(), HEADER_HEIGHT - 4);
+    painter->setBrush(baseColor);
+    painter->drawRoundedRect(headerRect, 6, 6);
+    painter->setPen(Qt::black);
+    painter->setFont(QFont("Tajawal", 9, QFont::Bold));
+    painter->drawText(headerRect, Qt::AlignCenter, QFontMetrics(painter->font()).elidedText(m_label, Qt::ElideRight, int(headerRect.width()) - 8));
+
+    // Ports with their names inside the body
+    QFont portFont("Tajawal", 7);
+    painter->setFont(portFont);
+    const QFontMetrics metrics(portFont);
+    const QPointF highlightedPort = m_portManager->getHighlightedPort();
+    auto drawPort = [&](const QPointF& port, int index, bool isInput) {
+        const QPointF center = port + QPointF(offset, offset);
+        const bool highlighted = !highlightedPort.isNull() && QLineF(port, highlightedPort).length() < 1.0;
+        if (highlighted) {
+            painter->setPen(Qt::NoPen);
+            painter->setBrush(QColor(100, 255, 100, 150));
+            painter->drawEllipse(center, offset + 3, offset + 3);
+        }
+        painter->setPen(QPen(QColor("#229799"), 2));
+        painter->setBrush(getPortColor(port, isInput));
+        painter->drawEllipse(center, offset - 1, offset - 1);
+
+        const QString name = metrics.elidedText(m_ports.at(index).name, Qt::ElideMiddle, int(WIDTH / 2) - 14);
+        painter->setPen(Qt::black);
+        if (isInput) {
+            painter->drawText(QPointF(center.x() + offset + 4, center.y() + 4), name);
+        } else {
+            painter->drawText(QPointF(center.x() - offset - 4 - metrics.horizontalAdvance(name), center.y() + 4), name);
+        }
+    };
+    for (int i = 0; i < m_inputPositions.size(); ++i) {
+        drawPort(m_inputPositions.at(i), m_inputIndexes.at(i), true);
+    }
+    for (int i = 0; i < m_outputPositions.size(); ++i) {
+        drawPort(m_outputPositions.at(i), m_outputIndexes.at(i), false);
+    }
+}
+
+void BlockGraphicsItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton) {
+        const qreal offset = ComponentPortManager::PORT_RADIUS;
+        // Clicking on a port - let the scene handle it
+        if (isNearPort(event->pos() - QPointF(offset, offset))) {
+            event->accept();
+            return;
+        }
+    }
+    // Blocks are neither resized nor connected to files, so skip the component's own handling
+    QGraphicsItem::mousePressEvent(event);
+}
+
+void BlockGraphicsItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
+{
+    const qreal offset = ComponentPortManager::PORT_RADIUS;
+    bool isInput = false;
+    const QPointF port = getPortAt(event->pos() - QPointF(offset, offset), isInput);
+    const int index = port.isNull() ? -1 : portIndexAt(port, isInput);
+    if (index >= 0) {
+        const BlockPort& blockPort = m_ports.at(index);
+        setCursor(Qt::PointingHandCursor);
+        setToolTip(QString("%1 (%2)\nClick and drag to connect").arg(blockPort.name, blockPort.memberId));
+    } else {
+        setCursor(Qt::ArrowCursor);
+        setToolTip(QString("%1\nDouble-click to open").arg(m_label));
+    }
+    QGraphicsItem::hoverMoveEvent(event);
+}
+
+void BlockGraphicsItem::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
+{
+    QMenu menu;
+
+    // Style the menu with Tajawal font for Arabic support
+    menu.setStyleSheet("QMenu { font-family: 'Tajawal'; font-size: 10pt; }"
+                      "QMenu::item:selected { background-color: #637AB9; }");
+
+    QAction* openAction = menu.addAction("Open Block");
+    openAction->setToolTip("Show the inside of the block");
+    QAction* expandAction = menu.addAction("Expand Block");
+    expandAction->setToolTip("Put the contents back in place of the block");
+    menu.addSeparator();
+    QAction* renameAction = menu.addAction("Rename...");
+
+    QAction* selectedAction = menu.exec(event->screenPos());
+    SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene());
+
+    if (selectedAction == openAction && schematicScene) {
+        emit schematicScene->blockOpenRequested(this);
+    } else if (selectedAction == expandAction && schematicScene) {
+        // Expanding deletes this item; leave its event handler first
+        QPointer<SchematicScene> target = schematicScene;
+        const QString name = m_blockName;
+        QTimer::singleShot(0, schematicScene, [target, name]() {
+            if (target) {
+                target->expandBlock(name);
+            }
+        });
+    } else if (selectedAction == renameAction) {
+        bool ok = false;
+        const QString label = QInputDialog::getText(nullptr, "Rename Block", "Block name:", QLineEdit::Normal, m_label, &ok);
+        if (ok) {
+            setLabel(label.trimmed());
+        }
+    }
+
+    event->accept();
+}
+
+QVariant BlockGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    SchematicScene::trackItem(this, change);
+    trackPortIndex(change);
+
+    if (change == ItemPositionHasChanged) {
+        updateWires();
+
+        if (BlockPersistence* blocks = PersistenceManager::instance().getBlockPersistence()) {
+            blocks->updateBlockPosition(m_blockName, pos());
+        }
+    }
+    return QGraphicsItem::itemChange(change, value);
+}
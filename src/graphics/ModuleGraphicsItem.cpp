@@ -3,7 +3,9 @@
 #include "graphics/wire/WireGraphicsItem.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "graphics/ready/ComponentPortManager.h"
+#include "parsers/PortType.h"
 #include "utils/PersistenceManager.h"
+#include "scene/SchematicScene.h"
 #include "ui/widgets/PortEditorDialog.h"
 #include <QPainter>
 #include <QPushButton>
@@ -98,6 +100,7 @@ ModuleGraphicsItem::ModuleGraphicsItem(const ModuleInfo& info, QGraphicsItem *pa
     // Base class already sets flags, but we can override if needed
     // Enable double click
     setAcceptDrops(false);
+    updatePortWidths();
 }
 
 QRectF ModuleGraphicsItem::boundingRect() const
@@ -315,6 +318,7 @@ void ModuleGraphicsItem::setRTLView(bool enabled)
         m_isRTLView = enabled;
         update();
         prepareGeometryChange();
+        updatePortIndex();
     }
 }
 
@@ -358,6 +362,29 @@ QList<QPointF> ModuleGraphicsItem::getOutputPorts() const
     return ports;
 }
 
+int ModuleGraphicsItem::getPortWidth(const QPointF& port, bool isInput) const
+{
+    if (m_isRTLView) {
+        return 0;  // One bundled port for the whole interface
+    }
+    // Detailed view ports are PORT_SPACING apart from LABEL_HEIGHT + PADDING
+    const QVector<int>& widths = isInput ? m_inputWidths : m_outputWidths;
+    const int index = qRound((port.y() - LABEL_HEIGHT - PADDING) / qreal(PORT_SPACING));
+    return (index >= 0 && index < widths.size()) ? widths.at(index) : 0;
+}
+
+void ModuleGraphicsItem::updatePortWidths()
+{
+    m_inputWidths.clear();
+    for (const Port& port : m_info.inputs) {
+        m_inputWidths.append(PortType::fromPort(port).width);
+    }
+    m_outputWidths.clear();
+    for (const Port& port : m_info.outputs) {
+        m_outputWidths.append(PortType::fromPort(port).width);
+    }
+}
+
 QPointF ModuleGraphicsItem::getPortAt(const QPointF& pos, bool& isInput) const
 {
     // Check input ports
@@ -508,6 +535,9 @@ void ModuleGraphicsItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
 
 QVariant ModuleGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
 {
+    SchematicScene::trackItem(this, change);
+    trackPortIndex(change);
+    
     if (change == ItemPositionHasChanged) {
         updateWires();
         
@@ -542,6 +572,10 @@ void ModuleGraphicsItem::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
     QAction* propertiesAction = menu.addAction("Properties");
     propertiesAction->setToolTip("View module properties and information");
     
+    // Add "Go to Definition" action
+    QAction* definitionAction = menu.addAction("Go to Definition");
+    definitionAction->setToolTip("Open the module's source at its declaration");
+    
     // Show menu at cursor position
     QAction* selectedAction = menu.exec(event->screenPos());
     
@@ -553,6 +587,10 @@ void ModuleGraphicsItem::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
         RTLDetailWindow* detailWindow = new RTLDetailWindow(m_info);
         detailWindow->setAttribute(Qt::WA_DeleteOnClose);
         detailWindow->show();
+    } else if (selectedAction == definitionAction) {
+        if (SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene())) {
+            emit schematicScene->moduleDefinitionRequested(m_info.name);
+        }
     }
     
     event->accept();
@@ -562,6 +600,7 @@ void ModuleGraphicsItem::updateModuleInfo(const ModuleInfo& newInfo)
 {
     // Update the module info
     m_info = newInfo;
+    updatePortWidths();
     
     // Update the port manager with new port configuration
     if (m_portManager) {
@@ -612,6 +651,7 @@ void ModuleGraphicsItem::updateModuleInfo(const ModuleInfo& newInfo)
     
     // Update any connected wires
     updateWires();
+    updatePortIndex();
     
     qDebug() << "Module info updated for:" << newInfo.name 
              << "| Inputs:" << newInfo.inputs.size() 
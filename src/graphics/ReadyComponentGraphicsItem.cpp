@@ -6,6 +6,9 @@
 #include "graphics/ready/ComponentRenderer.h"
 #include "graphics/wire/WireGraphicsItem.h"
 #include "utils/PersistenceManager.h"
+#include "scene/SchematicScene.h"
+#include "scene/PortIndex.h"
+#include "commands/SchematicCommands.h"
 #include "ui/MainWindow.h"
 #include "ui/mainwindow/WidgetManager.h"
 #include "ui/widgets/EditComponentWidget.h"
@@ -54,8 +57,22 @@ ReadyComponentGraphicsItem::ReadyComponentGraphicsItem(const QString& name, QGra
     m_renderer = std::make_unique<ComponentRenderer>();
 }
 
+namespace {
+
+PortIndex* portIndexOf(QGraphicsScene* scene)
+{
+    SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene);
+    return schematicScene ? schematicScene->portIndex() : nullptr;
+}
+
+} // namespace
+
 ReadyComponentGraphicsItem::~ReadyComponentGraphicsItem()
 {
+    SchematicScene::untrackItem(this);
+    if (PortIndex* index = portIndexOf(scene())) {
+        index->remove(this);
+    }
 }
 
 qreal ReadyComponentGraphicsItem::getPortRadius() const
@@ -85,6 +102,7 @@ void ReadyComponentGraphicsItem::setSize(qreal width, qreal height)
     
     // Update connected wires to follow new port positions
     updateWires();
+    updatePortIndex();
     
     // Emit signal for real-time synchronization
     emit sizeChanged(QSizeF(m_width, m_height));
@@ -198,6 +216,7 @@ void ReadyComponentGraphicsItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
         
         // Dynamically update wire paths with new port positions
         updateWires();
+        updatePortIndex();
         
         // Force scene update to ensure smooth visual feedback
         if (scene()) {
@@ -222,20 +241,13 @@ void ReadyComponentGraphicsItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* eve
         // Final wire path update after resize completes
         updateWires();
         
-        // Save the new size to persistence
-        try {
-            PersistenceManager& pm = PersistenceManager::instance();
-            QString componentId = pm.getComponentId(this);
-            if (!componentId.isEmpty()) {
-                pm.updateComponentSize(componentId, QSizeF(m_width, m_height));
-                qDebug() << "💾 Component resized:" << m_name 
-                         << "| New size:" << m_width << "x" << m_height
-                         << "| Wires with updated port positions:" << m_wireManager->getWires().size();
-            }
-        } catch (const std::exception& e) {
-            qWarning() << "⚠️ Exception during size update:" << e.what();
-        } catch (...) {
-            qWarning() << "⚠️ Unknown exception during size update";
+        // Record the resize for undo; the command saves the new size to persistence
+        const QSizeF oldSize = m_resizeHandler->getStartSize();
+        if (oldSize != getSize()) {
+            SchematicScene::execute(scene(), new ResizeComponentCommand(this, oldSize, getSize()));
+            qDebug() << "💾 Component resized:" << m_name 
+                     << "| New size:" << m_width << "x" << m_height
+                     << "| Wires with updated port positions:" << m_wireManager->getWires().size();
         }
         
         // Emit signal for real-time synchronization
@@ -329,8 +341,9 @@ void ReadyComponentGraphicsItem::openCodeEditor()
         }
     }
     
-    // Build file path
+    // Build file path; a just created file may still be queued for writing
     QString filePath = QDir(workingDir).filePath(componentId + ".cpp");
+    pm.flushPendingWrites();
     
     qDebug() << "Opening editor for component:" << componentId << "at" << filePath;
     
@@ -391,6 +404,11 @@ void ReadyComponentGraphicsItem::refreshPortsFromFile(const QString& filePath)
     qDebug() << "📊 Parsed ports - Inputs:" << moduleInfo.inputs.size() 
              << "| Outputs:" << moduleInfo.outputs.size();
     
+    refreshPorts(moduleInfo);
+}
+
+void ReadyComponentGraphicsItem::refreshPorts(const ModuleInfo& moduleInfo)
+{
     // Update the port manager with the new port information
     m_portManager->updatePortsFromModuleInfo(moduleInfo);
     
@@ -400,6 +418,7 @@ void ReadyComponentGraphicsItem::refreshPortsFromFile(const QString& filePath)
     
     // Update all connected wires to adjust to new port positions
     updateWires();
+    updatePortIndex();
     
     qDebug() << "✅ Ports refreshed successfully for" << m_name;
 }
@@ -415,15 +434,12 @@ void ReadyComponentGraphicsItem::changeComponentColor()
                                              QColorDialog::ShowAlphaChannel);
     
     if (newColor.isValid()) {
-        setCustomColor(newColor);
-        
-        // Save color to persistence
-        PersistenceManager& pm = PersistenceManager::instance();
-        QString componentId = pm.getComponentId(this);
-        if (!componentId.isEmpty()) {
-            pm.updateComponentColor(componentId, newColor);
-            qDebug() << "Changed color for" << componentId << "to" << newColor.name();
-        }
+        // The command applies the color and saves it to persistence
+        ComponentPropertiesCommand::State after = ComponentPropertiesCommand::State::of(this);
+        after.color = newColor;
+        SchematicScene::execute(scene(), new ComponentPropertiesCommand(
+            this, ComponentPropertiesCommand::State::of(this), after, tr("Change Color")));
+        qDebug() << "Changed color for" << m_name << "to" << newColor.name();
     }
 }
 
@@ -437,6 +453,14 @@ void ReadyComponentGraphicsItem::setCustomColor(const QColor& color)
     emit colorChanged(color);
 }
 
+void ReadyComponentGraphicsItem::clearCustomColor()
+{
+    m_hasCustomColor = false;
+    update();
+    
+    emit colorChanged(getColor());
+}
+
 void ReadyComponentGraphicsItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
 {
     qreal portRadius = getPortRadius();
@@ -470,6 +494,9 @@ void ReadyComponentGraphicsItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
 
 QVariant ReadyComponentGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
 {
+    SchematicScene::trackItem(this, change);
+    trackPortIndex(change);
+    
     if (change == ItemPositionHasChanged) {
         // Safety check - ensure component is still in a scene and valid
         if (!scene()) {
@@ -506,6 +533,34 @@ QVariant ReadyComponentGraphicsItem::itemChange(GraphicsItemChange change, const
     return QGraphicsItem::itemChange(change, value);
 }
 
+void ReadyComponentGraphicsItem::updatePortIndex()
+{
+    if (PortIndex* index = portIndexOf(scene())) {
+        index->update(this);
+    }
+}
+
+void ReadyComponentGraphicsItem::trackPortIndex(GraphicsItemChange change)
+{
+    switch (change) {
+    case ItemSceneChange:
+        // Still in the scene it is leaving
+        if (PortIndex* index = portIndexOf(scene())) {
+            index->remove(this);
+        }
+        break;
+    case ItemSceneHasChanged:
+    case ItemPositionHasChanged:
+    case ItemRotationHasChanged:
+    case ItemTransformHasChanged:
+    case ItemVisibleHasChanged:
+        updatePortIndex();
+        break;
+    default:
+        break;
+    }
+}
+
 // Port management methods (delegate to ComponentPortManager)
 QList<QPointF> ReadyComponentGraphicsItem::getInputPorts() const
 {
@@ -527,6 +582,11 @@ bool ReadyComponentGraphicsItem::isNearPort(const QPointF& pos) const
     return m_portManager->isNearPort(pos);
 }
 
+int ReadyComponentGraphicsItem::getPortWidth(const QPointF& port, bool isInput) const
+{
+    return m_portManager->getPortWidth(port, isInput);
+}
+
 void ReadyComponentGraphicsItem::setHighlightedPort(const QPointF& port)
 {
     m_portManager->setHighlightedPort(port);
@@ -685,6 +745,7 @@ void ReadyComponentGraphicsItem::updateComponentPorts(const ModuleInfo& newInfo)
     if (m_wireManager) {
         updateWires();
     }
+    updatePortIndex();
     
     qDebug() << "✅ Component ports updated successfully for:" << getName();
 }
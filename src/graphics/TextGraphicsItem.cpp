@@ -1,6 +1,8 @@
 // TextGraphicsItem.cpp
 #include "graphics/TextGraphicsItem.h"
 #include "utils/PersistenceManager.h"
+#include "scene/SchematicScene.h"
+#include "commands/SchematicCommands.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsSceneContextMenuEvent>
 #include <QKeyEvent>
@@ -42,6 +44,11 @@ TextGraphicsItem::TextGraphicsItem(const QString& text, QGraphicsItem* parent)
     qDebug() << "📝 TextGraphicsItem created with text:" << text << "| Visible:" << isVisible() << "| Opacity:" << opacity();
 }
 
+TextGraphicsItem::~TextGraphicsItem()
+{
+    SchematicScene::untrackItem(this);
+}
+
 void TextGraphicsItem::setText(const QString& text)
 {
     setPlainText(text);
@@ -112,6 +119,7 @@ void TextGraphicsItem::keyPressEvent(QKeyEvent* event)
 
 QVariant TextGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
 {
+    SchematicScene::trackItem(this, change);
     if (change == ItemPositionHasChanged) {
         emit positionChanged(value.toPointF());
     }
@@ -174,17 +182,23 @@ void TextGraphicsItem::showRenameDialog()
     ok = dialog.exec();
     QString newText = dialog.textValue();
     
-    if (ok && !newText.isEmpty()) {
-        // Update the text
-        setPlainText(newText);
-        
-        // Update original tracking values to current state
-        m_originalText = newText;
-        m_originalPosition = pos();
-        
-        // Emit signals to trigger persistence update
-        emit textChanged(newText);
-        emit textEditingFinished();
+    if (ok && !newText.isEmpty() && newText != toPlainText()) {
+        // The command commits the text, and commits the old one again on undo
+        SchematicScene::execute(scene(), new TextEditCommand(this, toPlainText(), newText));
     }
 }
 
+void TextGraphicsItem::commitText(const QString& text)
+{
+    // Update the text
+    setPlainText(text);
+    
+    // Update original tracking values to current state
+    m_originalText = text;
+    m_originalPosition = pos();
+    
+    // Emit signals to trigger persistence update
+    emit textChanged(text);
+    emit textEditingFinished();
+}
+
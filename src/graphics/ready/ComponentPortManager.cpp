@@ -2,6 +2,7 @@
 #include "graphics/ready/ComponentPortManager.h"
 #include "graphics/wire/WireGraphicsItem.h"
 #include "parsers/SvParser.h"
+#include "parsers/PortType.h"
 #include <QtMath>
 #include <QDebug>
 
@@ -58,6 +59,15 @@ void ComponentPortManager::updatePortsFromModuleInfo(const ModuleInfo& moduleInf
     m_dynamicInputCount = moduleInfo.inputs.size();
     m_dynamicOutputCount = moduleInfo.outputs.size();
     
+    m_inputWidths.clear();
+    for (const Port& port : moduleInfo.inputs) {
+        m_inputWidths.append(PortType::fromPort(port).width);
+    }
+    m_outputWidths.clear();
+    for (const Port& port : moduleInfo.outputs) {
+        m_outputWidths.append(PortType::fromPort(port).width);
+    }
+    
     qDebug() << "✅ Updated ports for" << m_componentName 
              << "| Inputs:" << m_dynamicInputCount 
              << "| Outputs:" << m_dynamicOutputCount;
@@ -99,6 +109,18 @@ int ComponentPortManager::getNumOutputPorts() const
     return 1; // Default for unknown components
 }
 
+int ComponentPortManager::getPortWidth(const QPointF& port, bool isInput) const
+{
+    // Ports are evenly spaced, so the index follows from the y coordinate
+    const QVector<int>& widths = isInput ? m_inputWidths : m_outputWidths;
+    const int count = isInput ? getNumInputPorts() : getNumOutputPorts();
+    if (widths.size() != count || count == 0 || m_height <= 0) {
+        return 0;
+    }
+    const int index = qRound(port.y() / (m_height / (count + 1.0))) - 1;
+    return (index >= 0 && index < count) ? widths.at(index) : 0;
+}
+
 QList<QPointF> ComponentPortManager::getInputPorts() const
 {
     QList<QPointF> ports;
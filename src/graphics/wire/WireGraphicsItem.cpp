@@ -2,7 +2,12 @@
 #include "graphics/wire/WireGraphicsItem.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "graphics/ModuleGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "persistence/ConnectionPersistence.h"
 #include "utils/PersistenceManager.h"
+#include "scene/SchematicScene.h"
+#include "scene/WireManager.h"
+#include "commands/SchematicCommands.h"
 #include <QPen>
 #include <QCursor>
 #include <QGraphicsScene>
@@ -39,6 +44,7 @@ WireGraphicsItem::WireGraphicsItem(ReadyComponentGraphicsItem* source, const QPo
 
 WireGraphicsItem::~WireGraphicsItem()
 {
+    SchematicScene::untrackItem(this);
     if (m_animationTimer) {
         m_animationTimer->stop();
     }
@@ -118,50 +124,93 @@ void WireGraphicsItem::saveConnectionToPersistence()
 
 void WireGraphicsItem::saveConnectionToPersistence(const QPointF& oldSourcePort, const QPointF& oldTargetPort)
 {
-    if (!m_source || !m_target) {
+    ConnectionEnd oldSource;
+    ConnectionEnd oldTarget;
+    ConnectionEnd source;
+    ConnectionEnd target;
+    if (!connectionEnds(m_sourcePort, m_targetPort, source, target)) {
+        if (m_source && m_target) {
+            qWarning() << "⚠️ Cannot save connection - missing component IDs";
+        }
         return;
     }
     
     PersistenceManager& pm = PersistenceManager::instance();
     
-    QString sourceId;
-    QString targetId;
-    bool sourceIsRTL = false;
-    bool targetIsRTL = false;
-    
-    // Check if source is RTL module
-    ModuleGraphicsItem* sourceModule = dynamic_cast<ModuleGraphicsItem*>(m_source);
-    if (sourceModule && sourceModule->isRTLView()) {
-        sourceId = pm.getRTLModuleName(sourceModule);
-        sourceIsRTL = true;
-    } else {
-        sourceId = pm.getComponentId(m_source);
+    // Remove old connection using OLD port positions
+    if (connectionEnds(oldSourcePort, oldTargetPort, oldSource, oldTarget)) {
+        pm.removeConnection(oldSource.id, oldSource.port, oldTarget.id, oldTarget.port);
     }
     
-    // Check if target is RTL module
-    ModuleGraphicsItem* targetModule = dynamic_cast<ModuleGraphicsItem*>(m_target);
-    if (targetModule && targetModule->isRTLView()) {
-        targetId = pm.getRTLModuleName(targetModule);
-        targetIsRTL = true;
-    } else {
-        targetId = pm.getComponentId(m_target);
+    // Save new connection with CURRENT port positions; routing drawn to a block's port is not the components' own
+    const bool direct = !SchematicItemType::cast<BlockGraphicsItem*>(m_source) && !SchematicItemType::cast<BlockGraphicsItem*>(m_target);
+    pm.saveConnection(source.id, source.port, target.id, target.port, source.isRTL, target.isRTL,
+                      direct ? getControlPoints() : QList<QPointF>(), direct ? m_orthogonalOffset : 0.0,
+                      direct && m_manualOffset);
+    
+    qDebug() << "💾 Saved wire connection to persistence:"
+             << "Removed old: (" << oldSourcePort << "→" << oldTargetPort << ")"
+             << "Added new: (" << m_sourcePort << "→" << m_targetPort << ")";
+}
+
+void WireGraphicsItem::removeConnectionFromPersistence()
+{
+    ConnectionEnd source;
+    ConnectionEnd target;
+    if (connectionEnds(m_sourcePort, m_targetPort, source, target)) {
+        PersistenceManager::instance().removeConnection(source.id, source.port, target.id, target.port);
+    }
+}
+
+void WireGraphicsItem::setGeometry(const Geometry& geometry)
+{
+    m_controlPointsManager.setControlPoints(geometry.controlPoints.toVector());
+    m_orthogonalOffset = geometry.orthogonalOffset;
+    m_manualOffset = geometry.manualOffset;
+    updatePath();
+}
+
+void WireGraphicsItem::saveGeometryToPersistence()
+{
+    ConnectionEnd source;
+    ConnectionEnd target;
+    if (!connectionEnds(m_sourcePort, m_targetPort, source, target)) {
+        return;
     }
     
-    if (sourceId.isEmpty() || targetId.isEmpty()) {
-        qWarning() << "⚠️ Cannot save connection - missing component IDs";
+    // Routing to a block's port stays with the wire; the stored one joins the components inside
+    if (SchematicItemType::cast<BlockGraphicsItem*>(m_source) || SchematicItemType::cast<BlockGraphicsItem*>(m_target)) {
         return;
     }
     
-    // Remove old connection using OLD port positions
-    pm.removeConnection(sourceId, oldSourcePort, targetId, oldTargetPort);
+    PersistenceManager& pm = PersistenceManager::instance();
+    pm.updateConnectionControlPoints(source.id, source.port, target.id, target.port, getControlPoints());
+    pm.updateConnectionOrthogonalOffset(source.id, source.port, target.id, target.port, m_orthogonalOffset,
+                                        m_manualOffset);
+}
+
+bool WireGraphicsItem::connectionEnds(const QPointF& sourcePort, const QPointF& targetPort,
+                                      ConnectionEnd& source, ConnectionEnd& target) const
+{
+    if (!m_source || !m_target) {
+        return false;
+    }
     
-    // Save new connection with CURRENT port positions
-    pm.saveConnection(sourceId, m_sourcePort, targetId, m_targetPort,
-                     sourceIsRTL, targetIsRTL, getControlPoints());
+    // Blocks map their ports to the components inside, which the connection is stored between
+    const PersistenceManager& pm = PersistenceManager::instance();
+    return pm.connectionEnd(m_source, sourcePort, source) && pm.connectionEnd(m_target, targetPort, target);
+}
+
+void WireGraphicsItem::commitGeometryEdit(const QString& text)
+{
+    const Geometry after = geometry();
+    if (after == m_geometryBeforeEdit) {
+        return;
+    }
     
-    qDebug() << "💾 Saved wire connection to persistence:"
-             << "Removed old: (" << oldSourcePort << "→" << oldTargetPort << ")"
-             << "Added new: (" << m_sourcePort << "→" << m_targetPort << ")";
+    // The command re-applies the new geometry and saves it
+    SchematicScene::execute(scene(), new WireGeometryCommand(this, m_geometryBeforeEdit, after, text));
+    m_geometryBeforeEdit = after;
 }
 
 void WireGraphicsItem::updatePath()
@@ -181,10 +230,8 @@ void WireGraphicsItem::updatePath()
     }
     
     // Update label position
-    if (m_label && m_labelVisible) {
-        QPointF center = m_path.pointAtPercent(0.5);
-        m_label->setPos(center - QPointF(m_label->boundingRect().width() / 2, 
-                                         m_label->boundingRect().height() / 2));
+    if (m_labelVisible) {
+        updateLabelPosition();
     }
     
     // Update segments for adjustment (delegated)
@@ -237,10 +284,9 @@ void WireGraphicsItem::setLabel(const QString& label)
     m_labelText = label;
     if (m_label) {
         m_label->setPlainText(label);
-        QPointF center = m_path.pointAtPercent(0.5);
-        m_label->setPos(center - QPointF(m_label->boundingRect().width() / 2, 
-                                         m_label->boundingRect().height() / 2));
+        updateLabelPosition();
     }
+    requestNetLayout();
 }
 
 void WireGraphicsItem::showLabel(bool show)
@@ -249,6 +295,38 @@ void WireGraphicsItem::showLabel(bool show)
     if (m_label) {
         m_label->setVisible(show);
     }
+    requestNetLayout();
+}
+
+void WireGraphicsItem::setLabelAnchor(qreal percent)
+{
+    m_labelAnchor = qBound(0.0, percent, 1.0);
+    updateLabelPosition();
+}
+
+QSizeF WireGraphicsItem::getLabelSize() const
+{
+    return m_label ? m_label->boundingRect().size() : QSizeF();
+}
+
+void WireGraphicsItem::updateLabelPosition()
+{
+    if (!m_label || m_path.isEmpty()) {
+        return;
+    }
+    const QPointF center = m_path.pointAtPercent(m_labelAnchor);
+    m_label->setPos(center - QPointF(m_label->boundingRect().width() / 2, 
+                                     m_label->boundingRect().height() / 2));
+}
+
+void WireGraphicsItem::requestNetLayout()
+{
+    // The wire manager finds the label a spot clear of the others once edits settle
+    if (SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene())) {
+        if (WireManager* wireManager = schematicScene->getWireManager()) {
+            wireManager->invalidateLayout(sceneBoundingRect());
+        }
+    }
 }
 
 void WireGraphicsItem::onLabelChanged()
@@ -263,6 +341,7 @@ void WireGraphicsItem::nudge(int dx, int dy)
     // Nudge all control points
     if (!m_controlPointsManager.isEmpty()) {
         m_controlPointsManager.nudgeAll(QPointF(dx * 10, dy * 10));
+        m_manualOffset = true;
         updatePath();
     }
 }
@@ -283,6 +362,8 @@ void WireGraphicsItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
     if (event->button() == Qt::LeftButton && isSelected()) {
         int controlPointIndex = m_controlPointsManager.findControlPointAt(event->scenePos());
         
+        m_geometryBeforeEdit = geometry();
+        
         if (controlPointIndex >= 0) {
             // Start dragging control point
             m_isDraggingControlPoint = true;
@@ -293,6 +374,7 @@ void WireGraphicsItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
             // Ctrl+Click: Add new control point
             QPointF nearestPoint = m_controlPointsManager.findNearestPointOnPath(event->scenePos(), m_path);
             addControlPoint(nearestPoint);
+            commitGeometryEdit(tr("Add Control Point"));
             event->accept();
             return;
         } else if (event->modifiers() & Qt::ShiftModifier) {
@@ -300,6 +382,7 @@ void WireGraphicsItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
             int nearestIndex = m_controlPointsManager.findControlPointAt(event->scenePos());
             if (nearestIndex >= 0) {
                 removeControlPoint(nearestIndex);
+                commitGeometryEdit(tr("Remove Control Point"));
                 event->accept();
                 return;
             }
@@ -350,6 +433,7 @@ void WireGraphicsItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
         
         // Apply the offset - this works for middle segments and provides
         // intuitive sliding behavior that matches the arrow directions
+        m_manualOffset = true;
         setOrthogonalOffset(m_segmentOriginalOffset + offsetDelta);
         event->accept();
         return;
@@ -364,34 +448,8 @@ void WireGraphicsItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
         m_isDraggingControlPoint = false;
         m_draggedControlPointIndex = -1;
         
-        // Save control points to persistence
-        if (m_source && m_target) {
-            PersistenceManager& pm = PersistenceManager::instance();
-            
-            QString sourceId;
-            QString targetId;
-            
-            // Check if source is RTL module
-            ModuleGraphicsItem* sourceModule = dynamic_cast<ModuleGraphicsItem*>(m_source);
-            if (sourceModule && sourceModule->isRTLView()) {
-                sourceId = pm.getRTLModuleName(sourceModule);
-            } else {
-                sourceId = pm.getComponentId(m_source);
-            }
-            
-            // Check if target is RTL module
-            ModuleGraphicsItem* targetModule = dynamic_cast<ModuleGraphicsItem*>(m_target);
-            if (targetModule && targetModule->isRTLView()) {
-                targetId = pm.getRTLModuleName(targetModule);
-            } else {
-                targetId = pm.getComponentId(m_target);
-            }
-            
-            if (!sourceId.isEmpty() && !targetId.isEmpty()) {
-                pm.updateConnectionControlPoints(sourceId, m_sourcePort, targetId, m_targetPort, 
-                                                m_controlPointsManager.getControlPoints());
-            }
-        }
+        // Record the drag for undo; the command saves the control points to persistence
+        commitGeometryEdit(tr("Move Control Point"));
         
         event->accept();
         return;
@@ -401,33 +459,8 @@ void WireGraphicsItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
         m_isDraggingSegment = false;
         m_selectedSegmentIndex = -1;
         
-        // Save offset to persistence
-        if (m_source && m_target) {
-            PersistenceManager& pm = PersistenceManager::instance();
-            
-            QString sourceId;
-            QString targetId;
-            
-            // Check if source is RTL module
-            ModuleGraphicsItem* sourceModule = dynamic_cast<ModuleGraphicsItem*>(m_source);
-            if (sourceModule && sourceModule->isRTLView()) {
-                sourceId = pm.getRTLModuleName(sourceModule);
-            } else {
-                sourceId = pm.getComponentId(m_source);
-            }
-            
-            // Check if target is RTL module
-            ModuleGraphicsItem* targetModule = dynamic_cast<ModuleGraphicsItem*>(m_target);
-            if (targetModule && targetModule->isRTLView()) {
-                targetId = pm.getRTLModuleName(targetModule);
-            } else {
-                targetId = pm.getComponentId(m_target);
-            }
-            
-            if (!sourceId.isEmpty() && !targetId.isEmpty()) {
-                pm.updateConnectionOrthogonalOffset(sourceId, m_sourcePort, targetId, m_targetPort, m_orthogonalOffset);
-            }
-        }
+        // Record the drag for undo; the command saves the offset to persistence
+        commitGeometryEdit(tr("Move Wire Segment"));
         
         event->accept();
         update();
@@ -619,7 +652,11 @@ void WireGraphicsItem::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
     } else if (selected == resetColorAction) {
         clearCustomColor();
     } else if (selected == resetOffsetAction) {
+        // Hands the wire back to the net layout
+        m_geometryBeforeEdit = geometry();
+        m_manualOffset = false;
         setOrthogonalOffset(0);
+        commitGeometryEdit(tr("Reset Offset"));
     } else if (selected == deleteAction) {
         scene()->clearSelection();
         setSelected(true);
@@ -639,19 +676,27 @@ void WireGraphicsItem::keyPressEvent(QKeyEvent* event)
     
     switch (event->key()) {
         case Qt::Key_Up:
+            m_geometryBeforeEdit = geometry();
             nudge(0, -1);
+            commitGeometryEdit(tr("Nudge Wire"));
             event->accept();
             break;
         case Qt::Key_Down:
+            m_geometryBeforeEdit = geometry();
             nudge(0, 1);
+            commitGeometryEdit(tr("Nudge Wire"));
             event->accept();
             break;
         case Qt::Key_Left:
+            m_geometryBeforeEdit = geometry();
             nudge(-1, 0);
+            commitGeometryEdit(tr("Nudge Wire"));
             event->accept();
             break;
         case Qt::Key_Right:
+            m_geometryBeforeEdit = geometry();
             nudge(1, 0);
+            commitGeometryEdit(tr("Nudge Wire"));
             event->accept();
             break;
         case Qt::Key_Escape:
@@ -667,3 +712,9 @@ void WireGraphicsItem::keyPressEvent(QKeyEvent* event)
             break;
     }
 }
+
+QVariant WireGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    SchematicScene::trackItem(this, change);
+    return QGraphicsItem::itemChange(change, value);
+}
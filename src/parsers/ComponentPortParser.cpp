@@ -1,5 +1,6 @@
 // ComponentPortParser.cpp
 #include "parsers/ComponentPortParser.h"
+#include "parsers/PortType.h"
 #include <QFile>
 #include <QTextStream>
 #include <QRegularExpression>
@@ -78,8 +79,10 @@ ModuleInfo ComponentPortParser::parseComponentContent(const QString& content, co
         }
         
         // Parse port declarations
-        // Format: sc_in<type> name; or sc_out<type> name;
-        QRegularExpression portRegex(R"((sc_in|sc_out)\s*<\s*([^>]+)\s*>\s+(\w+)\s*;)");
+        // Format: sc_in<type> name; or sc_out<type> name; the type may be
+        // one level of template deep (sc_in<sc_uint<8>>)
+        // Compiled once, not once per line
+        static const QRegularExpression portRegex(R"((sc_in|sc_out)\s*<\s*((?:[^<>]|<[^<>]*>)+?)\s*>\s*(\w+)\s*;)");
         QRegularExpressionMatch portMatch = portRegex.match(line);
         
         if (portMatch.hasMatch()) {
@@ -112,7 +115,7 @@ ModuleInfo ComponentPortParser::parseComponentContent(const QString& content, co
 bool ComponentPortParser::parsePortLine(const QString& line, Port& port)
 {
     // Match: sc_in<type> name; or sc_out<type> name;
-    QRegularExpression regex(R"((sc_in|sc_out)\s*<\s*([^>]+)\s*>\s+(\w+)\s*;)");
+    static const QRegularExpression regex(R"((sc_in|sc_out)\s*<\s*((?:[^<>]|<[^<>]*>)+?)\s*>\s*(\w+)\s*;)");
     QRegularExpressionMatch match = regex.match(line);
     
     if (!match.hasMatch()) {
@@ -133,27 +136,6 @@ bool ComponentPortParser::parsePortLine(const QString& line, Port& port)
 
 void ComponentPortParser::extractPortTypeAndWidth(const QString& typeStr, Port& port)
 {
-    // Handle different SystemC types
-    if (typeStr == "bool") {
-        port.width = "";  // Single bit
-    } else if (typeStr.contains("sc_uint") || typeStr.contains("sc_int")) {
-        // Extract width from sc_uint<N> or sc_int<N>
-        QRegularExpression widthRegex(R"(sc_u?int\s*<\s*(\d+)\s*>)");
-        QRegularExpressionMatch match = widthRegex.match(typeStr);
-        if (match.hasMatch()) {
-            int width = match.captured(1).toInt();
-            port.width = QString("[%1:0]").arg(width - 1);
-        }
-    } else if (typeStr.contains("sc_biguint") || typeStr.contains("sc_bigint")) {
-        // Extract width from sc_biguint<N> or sc_bigint<N>
-        QRegularExpression widthRegex(R"(sc_bigu?int\s*<\s*(\d+)\s*>)");
-        QRegularExpressionMatch match = widthRegex.match(typeStr);
-        if (match.hasMatch()) {
-            int width = match.captured(1).toInt();
-            port.width = QString("[%1:0]").arg(width - 1);
-        }
-    } else {
-        // Unknown type, leave width empty
-        port.width = "";
-    }
+    // Unknown types leave the width empty
+    port.width = PortType::fromSystemC(typeStr).widthSpec();
 }
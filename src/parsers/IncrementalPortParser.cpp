@@ -0,0 +1,312 @@
+// IncrementalPortParser.cpp
+#include "parsers/IncrementalPortParser.h"
+#include "parsers/ComponentPortParser.h"
+#include <QTextBlock>
+#include <QDebug>
+
+namespace {
+
+struct LineToken {
+    int start;
+    int length;
+    bool identifier;
+};
+
+inline bool isIdentifierStart(QChar c)
+{
+    return c.isLetter() || c == QLatin1Char('_');
+}
+
+inline bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
+/**
+ * Splits one line into identifiers and single-character punctuation,
+ * dropping comments, string and character literals and numbers. Namespace
+ * qualifiers are dropped too, so sc_core::sc_in reads as sc_in.
+ */
+QVector<LineToken> tokenizeLine(const QString& line, bool* inComment)
+{
+    QVector<LineToken> tokens;
+    const int n = line.size();
+    int i = 0;
+    while (i < n) {
+        if (*inComment) {
+            const int end = line.indexOf(QLatin1String("*/"), i);
+            if (end < 0) {
+                return tokens;
+            }
+            *inComment = false;
+            i = end + 2;
+            continue;
+        }
+
+        const QChar c = line.at(i);
+        if (c.isSpace()) {
+            ++i;
+        } else if (c == QLatin1Char('/') && i + 1 < n && line.at(i + 1) == QLatin1Char('/')) {
+            return tokens;
+        } else if (c == QLatin1Char('/') && i + 1 < n && line.at(i + 1) == QLatin1Char('*')) {
+            *inComment = true;
+            i += 2;
+        } else if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            ++i;
+            while (i < n && line.at(i) != c) {
+                i += (line.at(i) == QLatin1Char('\\')) ? 2 : 1;
+            }
+            ++i;
+        } else if (isIdentifierStart(c)) {
+            const int start = i;
+            while (i < n && isIdentifierChar(line.at(i))) {
+                ++i;
+            }
+            if (i + 1 < n && line.at(i) == QLatin1Char(':') && line.at(i + 1) == QLatin1Char(':')) {
+                i += 2;  // Namespace qualifier
+                continue;
+            }
+            tokens.append({start, i - start, true});
+        } else if (c.isDigit()) {
+            while (i < n && isIdentifierChar(line.at(i))) {
+                ++i;
+            }
+        } else {
+            tokens.append({i, 1, false});
+            ++i;
+        }
+    }
+    return tokens;
+}
+
+} // namespace
+
+IncrementalPortParser::IncrementalPortParser(QTextDocument* document, QObject* parent)
+    : QObject(parent)
+    , m_document(document)
+    , m_debounceTimer(nullptr)
+{
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(DEBOUNCE_MS);
+    connect(m_debounceTimer, &QTimer::timeout, this, &IncrementalPortParser::reassemble);
+
+    reclassifyAll();
+    m_info = assemble(m_lines);
+
+    connect(m_document, &QTextDocument::contentsChange, this, &IncrementalPortParser::onContentsChange);
+}
+
+ModuleInfo IncrementalPortParser::parse(const QString& content)
+{
+    QVector<LineInfo> lines;
+    bool inComment = false;
+    for (const QString& line : content.split(QLatin1Char('\n'))) {
+        lines.append(classify(line, inComment));
+        inComment = lines.last().commentAtEnd;
+    }
+    return assemble(lines);
+}
+
+void IncrementalPortParser::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+    if (!m_document) {
+        return;
+    }
+
+    // The edit replaced old lines [first, lastOld] with new blocks [first, lastNew]
+    const QTextBlock firstBlock = m_document->findBlock(position);
+    QTextBlock lastBlock = m_document->findBlock(position + charsAdded);
+    if (!lastBlock.isValid()) {
+        lastBlock = m_document->lastBlock();
+    }
+    const int first = firstBlock.isValid() ? firstBlock.blockNumber() : 0;
+    const int lastNew = lastBlock.blockNumber();
+    const int lastOld = lastNew - (m_document->blockCount() - m_lines.size());
+    if (!firstBlock.isValid() || lastOld < first - 1 || lastOld >= m_lines.size()) {
+        reclassifyAll();
+        m_debounceTimer->start();
+        return;
+    }
+
+    bool inComment = first > 0 ? m_lines.at(first - 1).commentAtEnd : false;
+    QVector<LineInfo> fresh;
+    fresh.reserve(lastNew - first + 1);
+    for (QTextBlock block = firstBlock; block.isValid() && block.blockNumber() <= lastNew; block = block.next()) {
+        fresh.append(classify(block.text(), inComment));
+        inComment = fresh.last().commentAtEnd;
+    }
+
+    m_lines.remove(first, lastOld - first + 1);
+    m_lines.insert(first, fresh.size(), LineInfo());
+    for (int i = 0; i < fresh.size(); ++i) {
+        m_lines[first + i] = fresh.at(i);
+    }
+
+    // Opening or closing a block comment changes how the following lines read;
+    // re-scan until a line starts in the state it was cached with
+    int next = first + fresh.size();
+    for (QTextBlock block = lastBlock.next();
+         block.isValid() && next < m_lines.size() && m_lines.at(next).commentAtStart != inComment;
+         block = block.next(), ++next) {
+        m_lines[next] = classify(block.text(), inComment);
+        inComment = m_lines.at(next).commentAtEnd;
+    }
+
+    m_debounceTimer->start();
+}
+
+void IncrementalPortParser::reassemble()
+{
+    const ModuleInfo info = assemble(m_lines);
+    if (samePorts(info, m_info)) {
+        return;
+    }
+
+    m_info = info;
+    qDebug() << "🔄 Live ports for" << info.name << "| Inputs:" << info.inputs.size()
+             << "| Outputs:" << info.outputs.size();
+    emit portsChanged(m_info);
+}
+
+void IncrementalPortParser::reclassifyAll()
+{
+    m_lines.clear();
+    if (!m_document) {
+        return;
+    }
+
+    m_lines.reserve(m_document->blockCount());
+    bool inComment = false;
+    for (QTextBlock block = m_document->begin(); block.isValid(); block = block.next()) {
+        m_lines.append(classify(block.text(), inComment));
+        inComment = m_lines.last().commentAtEnd;
+    }
+}
+
+IncrementalPortParser::LineInfo IncrementalPortParser::classify(const QString& line, bool commentAtStart)
+{
+    LineInfo info;
+    info.commentAtStart = commentAtStart;
+    bool inComment = commentAtStart;
+    const QVector<LineToken> tokens = tokenizeLine(line, &inComment);
+    info.commentAtEnd = inComment;
+    if (tokens.isEmpty()) {
+        return info;
+    }
+
+    const int n = tokens.size();
+    auto word = [&line, &tokens](int i) {
+        return QStringView(line).mid(tokens.at(i).start, tokens.at(i).length);
+    };
+    auto isPunct = [&line, &tokens, n](int i, char c) {
+        return i < n && !tokens.at(i).identifier && line.at(tokens.at(i).start) == QLatin1Char(c);
+    };
+    auto isIdentifier = [&tokens, n](int i) {
+        return i < n && tokens.at(i).identifier;
+    };
+
+    bool ends = false;
+    for (int i = 0; i < n; ++i) {
+        if (isIdentifier(i)) {
+            const QStringView w = word(i);
+            if (w == u"SC_MODULE" && isPunct(i + 1, '(') && isIdentifier(i + 2) && isPunct(i + 3, ')')) {
+                info.kind = ModuleLine;
+                info.name = word(i + 2).toString();
+                info.moduleBrace = isPunct(i + 4, '{');
+                return info;
+            }
+            if ((w == u"sc_in" || w == u"sc_out") && isPunct(i + 1, '<')) {
+                // Type runs to the matching '>', so sc_in<sc_uint<8> > works
+                int depth = 0;
+                int close = i + 1;
+                for (; close < n; ++close) {
+                    if (isPunct(close, '<')) {
+                        ++depth;
+                    } else if (isPunct(close, '>') && --depth == 0) {
+                        break;
+                    }
+                }
+                if (close < n && isIdentifier(close + 1) && isPunct(close + 2, ';')) {
+                    const int typeStart = tokens.at(i + 2 < close ? i + 2 : close).start;
+                    const QString type = line.mid(typeStart, tokens.at(close).start - typeStart).simplified();
+
+                    info.kind = PortLine;
+                    info.name = word(close + 1).toString();
+                    info.port.name = info.name;
+                    info.port.direction = (w == u"sc_in") ? Port::Input : Port::Output;
+                    ComponentPortParser::extractPortTypeAndWidth(type, info.port);
+                    return info;
+                }
+            }
+            if (w == u"SC_CTOR" || w == u"void") {
+                ends = true;
+            }
+        } else if (isPunct(i, '{')) {
+            if (i == 0) {
+                info.kind = OpenBraceLine;
+                return info;
+            }
+            ends = true;
+        } else if (isPunct(i, '}')) {
+            ends = true;
+        }
+    }
+
+    if (ends) {
+        info.kind = EndLine;
+    }
+    return info;
+}
+
+ModuleInfo IncrementalPortParser::assemble(const QVector<LineInfo>& lines)
+{
+    ModuleInfo info;
+    int i = 0;
+    while (i < lines.size() && lines.at(i).kind != ModuleLine) {
+        ++i;
+    }
+    if (i == lines.size()) {
+        return info;
+    }
+
+    info.name = lines.at(i).name;
+    bool open = lines.at(i).moduleBrace;
+    for (++i; i < lines.size(); ++i) {
+        const LineInfo& line = lines.at(i);
+        if (line.kind == OtherLine) {
+            continue;
+        }
+        if (!open && line.kind == OpenBraceLine) {
+            open = true;
+            continue;
+        }
+        if (!open || line.kind != PortLine) {
+            break;
+        }
+        if (line.port.direction == Port::Input) {
+            info.inputs.append(line.port);
+        } else {
+            info.outputs.append(line.port);
+        }
+    }
+    return info;
+}
+
+bool IncrementalPortParser::samePorts(const ModuleInfo& a, const ModuleInfo& b)
+{
+    auto sameList = [](const QList<Port>& x, const QList<Port>& y) {
+        if (x.size() != y.size()) {
+            return false;
+        }
+        for (int i = 0; i < x.size(); ++i) {
+            if (x.at(i).name != y.at(i).name || x.at(i).width != y.at(i).width
+                || x.at(i).direction != y.at(i).direction) {
+                return false;
+            }
+        }
+        return true;
+    };
+    return a.name == b.name && sameList(a.inputs, b.inputs) && sameList(a.outputs, b.outputs);
+}
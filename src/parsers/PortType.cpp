@@ -0,0 +1,95 @@
+// PortType.cpp
+#include "parsers/PortType.h"
+#include <QRegularExpression>
+#include <QHash>
+
+PortType PortType::fromSystemC(QStringView type)
+{
+    static const QRegularExpression scope(R"(\b(?:sc_dt|std)\s*::\s*)");
+    QString name = type.trimmed().toString();
+    name.remove(scope);
+
+    static const QRegularExpression templated(R"(^(sc_biguint|sc_bigint|sc_uint|sc_int|sc_lv|sc_bv)\s*<\s*(\d+)\s*>$)");
+    const QRegularExpressionMatch match = templated.match(name);
+    if (match.hasMatch()) {
+        static const QHash<QString, Kind> kinds = {
+            {"sc_uint", UInt}, {"sc_int", Int}, {"sc_biguint", BigUInt},
+            {"sc_bigint", BigInt}, {"sc_lv", LogicVector}, {"sc_bv", BitVector}
+        };
+        PortType result;
+        result.kind = kinds.value(match.captured(1));
+        result.width = match.captured(2).toInt();
+        return result;
+    }
+
+    static const QHash<QString, PortType> scalars = {
+        {"bool", {Bool, 1}}, {"sc_logic", {Bool, 1}}, {"sc_bit", {Bool, 1}},
+        {"uint8_t", {UInt, 8}}, {"uint16_t", {UInt, 16}}, {"uint32_t", {UInt, 32}}, {"uint64_t", {UInt, 64}},
+        {"int8_t", {Int, 8}}, {"int16_t", {Int, 16}}, {"int32_t", {Int, 32}}, {"int64_t", {Int, 64}},
+        {"char", {Int, 8}}, {"short", {Int, 16}}, {"int", {Int, 32}}, {"long long", {Int, 64}},
+        {"unsigned", {UInt, 32}}, {"unsigned int", {UInt, 32}}, {"unsigned long long", {UInt, 64}}
+    };
+    return scalars.value(name.simplified());
+}
+
+PortType PortType::fromWidthSpec(const QString& spec)
+{
+    if (spec.trimmed().isEmpty()) {
+        return {Bool, 1};
+    }
+
+    // SvParser normalises ranges to plain numbers; either order is a valid range
+    static const QRegularExpression range(R"(^\s*\[\s*(\d+)\s*:\s*(\d+)\s*\]\s*$)");
+    const QRegularExpressionMatch match = range.match(spec);
+    if (!match.hasMatch()) {
+        return PortType();
+    }
+    return fromWidth(qAbs(match.captured(1).toInt() - match.captured(2).toInt()) + 1);
+}
+
+PortType PortType::fromWidth(int width)
+{
+    if (width <= 0) {
+        return PortType();
+    }
+    if (width == 1) {
+        return {Bool, 1};
+    }
+    return {width <= MAX_NATIVE_WIDTH ? UInt : BigUInt, width};
+}
+
+QString PortType::systemCType() const
+{
+    if (!isKnown()) {
+        return QString("sc_uint<%1>").arg(FALLBACK_WIDTH);
+    }
+
+    const QString n = QString::number(width);
+    switch (kind) {
+    case Bool:
+        return "bool";
+    case Int:
+    case BigInt:
+        return (width <= MAX_NATIVE_WIDTH ? "sc_int<" : "sc_bigint<") + n + ">";
+    case LogicVector:
+        return "sc_lv<" + n + ">";
+    case BitVector:
+        return "sc_bv<" + n + ">";
+    case Unknown:
+    case UInt:
+    case BigUInt:
+        break;
+    }
+    if (width == 1) {
+        return "bool";
+    }
+    return (width <= MAX_NATIVE_WIDTH ? "sc_uint<" : "sc_biguint<") + n + ">";
+}
+
+QString PortType::widthSpec() const
+{
+    if (!isKnown() || kind == Bool) {
+        return QString();
+    }
+    return QString("[%1:0]").arg(width - 1);
+}
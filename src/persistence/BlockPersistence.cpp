@@ -0,0 +1,356 @@
+// BlockPersistence.cpp
+#include "persistence/BlockPersistence.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "utils/PersistenceManager.h"
+#include <QFile>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QDebug>
+#include <QGraphicsScene>
+#include <algorithm>
+
+namespace {
+
+QJsonObject pointToJson(const QPointF& point)
+{
+    return QJsonObject{{"x", point.x()}, {"y", point.y()}};
+}
+
+QPointF pointFromJson(const QJsonValue& value)
+{
+    const QJsonObject object = value.toObject();
+    return QPointF(object["x"].toDouble(), object["y"].toDouble());
+}
+
+} // namespace
+
+BlockPersistence::BlockPersistence(const QString& workingDirectory)
+    : m_workingDirectory(workingDirectory)
+{
+}
+
+void BlockPersistence::setWorkingDirectory(const QString& directory)
+{
+    m_workingDirectory = directory;
+    m_loaded = false;
+    m_blocks.clear();
+    m_owners.clear();
+}
+
+void BlockPersistence::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void BlockPersistence::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0) {
+        return;
+    }
+    if (m_batchDirty) {
+        m_batchDirty = false;
+        writeBlocksJson();
+    }
+}
+
+QString BlockPersistence::memberKey(const QString& memberId, bool isRTL)
+{
+    return (isRTL ? QStringLiteral("rtl:") : QStringLiteral("component:")) + memberId;
+}
+
+void BlockPersistence::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+    if (m_workingDirectory.isEmpty()) {
+        return;
+    }
+
+    QFile file(QDir(QDir(m_workingDirectory).filePath(".scv")).filePath("blocks.json"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;  // No blocks yet
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    for (const QJsonValue& value : doc.object()["blocks"].toArray()) {
+        const QJsonObject object = value.toObject();
+        BlockData data;
+        data.name = object["name"].toString();
+        if (data.name.isEmpty()) {
+            continue;
+        }
+        data.label = object["label"].toString(data.name);
+        data.parent = object["parent"].toString();
+        data.position = pointFromJson(object["position"]);
+        data.origin = object.contains("origin") ? pointFromJson(object["origin"]) : data.position;
+        for (const QJsonValue& id : object["components"].toArray()) {
+            data.components.append(id.toString());
+            m_owners.insert(memberKey(id.toString(), false), data.name);
+        }
+        for (const QJsonValue& name : object["rtlModules"].toArray()) {
+            data.rtlModules.append(name.toString());
+            m_owners.insert(memberKey(name.toString(), true), data.name);
+        }
+        for (const QJsonValue& portValue : object["ports"].toArray()) {
+            const QJsonObject portObject = portValue.toObject();
+            BlockPort port;
+            port.name = portObject["name"].toString();
+            port.width = portObject["width"].toInt();
+            port.isInput = portObject["direction"].toString() != "output";
+            port.memberId = portObject["memberId"].toString();
+            port.memberIsRTL = portObject["memberIsRTL"].toBool(false);
+            port.memberPort = pointFromJson(portObject["memberPort"]);
+            data.ports.append(port);
+        }
+        m_blocks.insert(data.name, data);
+    }
+    qDebug() << "📂 Loaded" << m_blocks.size() << "block(s) from blocks.json";
+}
+
+void BlockPersistence::save()
+{
+    if (m_batchDepth > 0) {
+        m_batchDirty = true;
+        return;
+    }
+    writeBlocksJson();
+}
+
+void BlockPersistence::writeBlocksJson()
+{
+    if (m_workingDirectory.isEmpty()) {
+        return;
+    }
+
+    QJsonArray blocks;
+    for (const BlockData& data : m_blocks) {
+        QJsonArray ports;
+        for (const BlockPort& port : data.ports) {
+            ports.append(QJsonObject{{"name", port.name},
+                                     {"width", port.width},
+                                     {"direction", port.isInput ? "input" : "output"},
+                                     {"memberId", port.memberId},
+                                     {"memberIsRTL", port.memberIsRTL},
+                                     {"memberPort", pointToJson(port.memberPort)}});
+        }
+        QJsonObject object;
+        object["name"] = data.name;
+        object["label"] = data.label;
+        object["parent"] = data.parent;
+        object["position"] = pointToJson(data.position);
+        object["origin"] = pointToJson(data.origin);
+        object["components"] = QJsonArray::fromStringList(data.components);
+        object["rtlModules"] = QJsonArray::fromStringList(data.rtlModules);
+        object["ports"] = ports;
+        blocks.append(object);
+    }
+
+    QDir dir(QDir(m_workingDirectory).filePath(".scv"));
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+    QFile file(dir.filePath("blocks.json"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to save blocks.json";
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject{{"version", "1.0"}, {"blocks", blocks}}).toJson(QJsonDocument::Indented));
+    file.close();
+
+    qDebug() << "Saved blocks.json";
+}
+
+QList<BlockData> BlockPersistence::blocks()
+{
+    ensureLoaded();
+    return m_blocks.values();
+}
+
+BlockData BlockPersistence::block(const QString& name)
+{
+    ensureLoaded();
+    return m_blocks.value(name);
+}
+
+bool BlockPersistence::contains(const QString& name)
+{
+    ensureLoaded();
+    return m_blocks.contains(name);
+}
+
+QString BlockPersistence::createBlockName()
+{
+    ensureLoaded();
+    for (int i = m_blocks.size() + 1;; ++i) {
+        const QString name = QString("block_%1").arg(i);
+        if (!m_blocks.contains(name)) {
+            return name;
+        }
+    }
+}
+
+void BlockPersistence::saveBlock(const BlockData& block)
+{
+    ensureLoaded();
+
+    // Membership lists are authoritative: drop what the block no longer holds
+    const auto previous = m_blocks.constFind(block.name);
+    if (previous != m_blocks.cend()) {
+        for (const QString& id : previous->components) {
+            m_owners.remove(memberKey(id, false));
+        }
+        for (const QString& name : previous->rtlModules) {
+            m_owners.remove(memberKey(name, true));
+        }
+    }
+    for (const QString& id : block.components) {
+        setOwner(id, false, QString());
+        m_owners.insert(memberKey(id, false), block.name);
+    }
+    for (const QString& name : block.rtlModules) {
+        setOwner(name, true, QString());
+        m_owners.insert(memberKey(name, true), block.name);
+    }
+
+    m_blocks.insert(block.name, block);
+    save();
+}
+
+void BlockPersistence::updateBlockPosition(const QString& name, const QPointF& position)
+{
+    ensureLoaded();
+    auto it = m_blocks.find(name);
+    if (it == m_blocks.end() || it->position == position) {
+        return;
+    }
+    it->position = position;
+    save();
+}
+
+void BlockPersistence::updateBlockLabel(const QString& name, const QString& label)
+{
+    ensureLoaded();
+    auto it = m_blocks.find(name);
+    if (it == m_blocks.end() || it->label == label) {
+        return;
+    }
+    it->label = label;
+    save();
+}
+
+void BlockPersistence::removeBlock(const QString& name)
+{
+    ensureLoaded();
+    const auto it = m_blocks.constFind(name);
+    if (it == m_blocks.cend()) {
+        return;
+    }
+    for (const QString& id : it->components) {
+        m_owners.remove(memberKey(id, false));
+    }
+    for (const QString& moduleName : it->rtlModules) {
+        m_owners.remove(memberKey(moduleName, true));
+    }
+    m_blocks.erase(it);
+    save();
+}
+
+QString BlockPersistence::parentOf(const QString& name)
+{
+    ensureLoaded();
+    return m_blocks.value(name).parent;
+}
+
+QStringList BlockPersistence::childBlocks(const QString& name)
+{
+    ensureLoaded();
+    QStringList children;
+    for (const BlockData& data : m_blocks) {
+        if (data.parent == name) {
+            children.append(data.name);
+        }
+    }
+    return children;
+}
+
+bool BlockPersistence::loadBlocks(QGraphicsScene* scene, PersistenceManager* pm)
+{
+    if (m_workingDirectory.isEmpty() || !scene || !pm) {
+        return false;
+    }
+    ensureLoaded();
+
+    const QString scope = pm->sceneScope(scene);
+    int loaded = 0;
+    for (const BlockData& data : m_blocks) {
+        if (data.parent != scope) {
+            continue;
+        }
+        BlockGraphicsItem* block = new BlockGraphicsItem(data);
+        block->setPos(data.position);
+        scene->addItem(block);
+        ++loaded;
+    }
+    qDebug() << "Loaded" << loaded << "block(s) into" << (scope.isEmpty() ? QString("the top level") : scope);
+    return true;
+}
+
+QString BlockPersistence::ownerOf(const QString& memberId, bool isRTL)
+{
+    ensureLoaded();
+    return m_owners.value(memberKey(memberId, isRTL));
+}
+
+void BlockPersistence::setOwner(const QString& memberId, bool isRTL, const QString& name)
+{
+    ensureLoaded();
+    const QString key = memberKey(memberId, isRTL);
+    const QString owner = m_owners.value(key);
+    if (owner == name) {
+        return;
+    }
+
+    if (!owner.isEmpty()) {
+        auto it = m_blocks.find(owner);
+        if (it != m_blocks.end()) {
+            (isRTL ? it->rtlModules : it->components).removeAll(memberId);
+        }
+        m_owners.remove(key);
+    }
+    if (!name.isEmpty()) {
+        auto it = m_blocks.find(name);
+        if (it == m_blocks.end()) {
+            qWarning() << "⚠️ No block" << name << "to move" << memberId << "into";
+            save();
+            return;
+        }
+        (isRTL ? it->rtlModules : it->components).append(memberId);
+        m_owners.insert(key, name);
+    }
+    save();
+}
+
+void BlockPersistence::removeMember(const QString& memberId, bool isRTL)
+{
+    ensureLoaded();
+    bool changed = false;
+    for (BlockData& data : m_blocks) {
+        const int before = data.ports.size();
+        data.ports.erase(std::remove_if(data.ports.begin(), data.ports.end(), [&](const BlockPort& port) {
+            return port.memberIsRTL == isRTL && port.memberId == memberId;
+        }), data.ports.end());
+        changed = changed || data.ports.size() != before;
+    }
+    if (!m_owners.contains(memberKey(memberId, isRTL))) {
+        if (changed) {
+            save();
+        }
+        return;
+    }
+    setOwner(memberId, isRTL, QString());
+}
@@ -0,0 +1,167 @@
+// CodeTemplate.cpp
+#include "persistence/CodeTemplate.h"
+#include <QPair>
+
+namespace {
+
+bool isBlank(const QString& text, int from, int to)
+{
+    for (int i = from; i < to; ++i) {
+        if (text.at(i) != QLatin1Char(' ') && text.at(i) != QLatin1Char('\t') && text.at(i) != QLatin1Char('\r')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+CodeTemplate CodeTemplate::compile(const QString& source, QString* errorString)
+{
+    CodeTemplate tpl;
+    QVector<QPair<int, QString>> openSections;   // Node index, name
+
+    auto fail = [&tpl, errorString](const QString& message) {
+        if (errorString) {
+            *errorString = message;
+        }
+        tpl.m_nodes.clear();
+        tpl.m_valid = false;
+        return tpl;
+    };
+    auto appendText = [&tpl](const QString& text) {
+        if (text.isEmpty()) {
+            return;
+        }
+        Node node;
+        node.type = TextNode;
+        node.text = text;
+        tpl.m_sizeHint += text.size();
+        tpl.m_nodes.append(node);
+    };
+
+    int pos = 0;
+    while (pos < source.size()) {
+        const int open = source.indexOf(QLatin1String("{{"), pos);
+        if (open < 0) {
+            appendText(source.mid(pos));
+            break;
+        }
+        const int close = source.indexOf(QLatin1String("}}"), open + 2);
+        if (close < 0) {
+            return fail(QString("Unterminated tag at offset %1").arg(open));
+        }
+
+        QString tag = source.mid(open + 2, close - open - 2).trimmed();
+        const QChar sigil = tag.isEmpty() ? QChar() : tag.at(0);
+        const bool sectionTag = sigil == QLatin1Char('#') || sigil == QLatin1Char('^') || sigil == QLatin1Char('/');
+        if (sectionTag) {
+            tag = tag.mid(1).trimmed();
+        }
+        if (tag.isEmpty()) {
+            return fail(QString("Empty tag at offset %1").arg(open));
+        }
+
+        // A section tag alone on its line takes the whole line with it
+        int textEnd = open;
+        int next = close + 2;
+        if (sectionTag) {
+            const int lineStart = open > 0 ? source.lastIndexOf(QLatin1Char('\n'), open - 1) + 1 : 0;
+            int lineEnd = source.indexOf(QLatin1Char('\n'), close + 2);
+            if (lineEnd < 0) {
+                lineEnd = source.size();
+            }
+            if (lineStart >= pos && isBlank(source, lineStart, open) && isBlank(source, close + 2, lineEnd)) {
+                textEnd = lineStart;
+                next = qMin(lineEnd + 1, int(source.size()));
+            }
+        }
+        appendText(source.mid(pos, textEnd - pos));
+        pos = next;
+
+        Node node;
+        node.text = tag;
+        if (sigil == QLatin1Char('/')) {
+            if (openSections.isEmpty() || openSections.last().second != tag) {
+                return fail(QString("Unexpected {{/%1}} at offset %2").arg(tag).arg(open));
+            }
+            tpl.m_nodes[openSections.last().first].end = tpl.m_nodes.size();
+            openSections.removeLast();
+            continue;
+        }
+        if (sigil == QLatin1Char('#') || sigil == QLatin1Char('^')) {
+            node.type = (sigil == QLatin1Char('#')) ? SectionNode : InvertedSectionNode;
+            openSections.append({int(tpl.m_nodes.size()), tag});
+        } else {
+            node.type = FieldNode;
+        }
+        tpl.m_nodes.append(node);
+    }
+
+    if (!openSections.isEmpty()) {
+        return fail(QString("Section {{#%1}} is never closed").arg(openSections.last().second));
+    }
+    tpl.m_valid = true;
+    return tpl;
+}
+
+QString CodeTemplate::render(const Data& data) const
+{
+    QString out;
+    renderTo(&out, data);
+    return out;
+}
+
+void CodeTemplate::renderTo(QString* out, const Data& data) const
+{
+    out->reserve(out->size() + m_sizeHint * 2);
+    renderRange(out, 0, m_nodes.size(), data, nullptr);
+}
+
+void CodeTemplate::renderRange(QString* out, int first, int last, const Data& data, const Fields* item) const
+{
+    for (int i = first; i < last; ++i) {
+        const Node& node = m_nodes.at(i);
+        switch (node.type) {
+        case TextNode:
+            out->append(node.text);
+            break;
+        case FieldNode:
+            out->append(lookup(node.text, data, item));
+            break;
+        case SectionNode: {
+            const auto list = data.lists.constFind(node.text);
+            if (list != data.lists.constEnd()) {
+                for (const Fields& entry : list.value()) {
+                    renderRange(out, i + 1, node.end, data, &entry);
+                }
+            } else if (!lookup(node.text, data, item).isEmpty()) {
+                renderRange(out, i + 1, node.end, data, item);
+            }
+            i = node.end - 1;
+            break;
+        }
+        case InvertedSectionNode: {
+            const auto list = data.lists.constFind(node.text);
+            const bool empty = (list != data.lists.constEnd()) ? list.value().isEmpty()
+                                                               : lookup(node.text, data, item).isEmpty();
+            if (empty) {
+                renderRange(out, i + 1, node.end, data, item);
+            }
+            i = node.end - 1;
+            break;
+        }
+        }
+    }
+}
+
+QString CodeTemplate::lookup(const QString& name, const Data& data, const Fields* item)
+{
+    if (item) {
+        const auto it = item->constFind(name);
+        if (it != item->constEnd()) {
+            return it.value();
+        }
+    }
+    return data.fields.value(name);
+}
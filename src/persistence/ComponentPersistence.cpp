@@ -1,5 +1,7 @@
 // ComponentPersistence.cpp
 #include "persistence/ComponentPersistence.h"
+#include "persistence/FileWriteQueue.h"
+#include "persistence/SystemCGenerator.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "utils/PersistenceManager.h"
 #include "parsers/SvParser.h"
@@ -22,6 +24,8 @@ ComponentPersistence::ComponentPersistence(const QString& workingDirectory)
     , m_workingDirectory(workingDirectory)
     , m_componentCounter(0)
     , m_batchUpdateTimer(std::make_unique<QTimer>())
+    , m_generator(std::make_unique<SystemCGenerator>(workingDirectory))
+    , m_writeQueue(std::make_unique<FileWriteQueue>())
 {
     // Setup batch update timer for performance optimization
     m_batchUpdateTimer->setSingleShot(true);
@@ -29,9 +33,16 @@ ComponentPersistence::ComponentPersistence(const QString& workingDirectory)
     connect(m_batchUpdateTimer.get(), &QTimer::timeout, this, &ComponentPersistence::performBatchMetadataUpdate);
 }
 
+ComponentPersistence::~ComponentPersistence()
+{
+    // Out of line so the unique_ptr members see complete types
+}
+
 void ComponentPersistence::setWorkingDirectory(const QString& directory)
 {
+    flushPendingWrites();
     m_workingDirectory = directory;
+    m_generator->setWorkingDirectory(directory);
     m_componentCounter = 0;
     
     // Clear metadata cache when working directory changes
@@ -48,164 +59,80 @@ QString ComponentPersistence::generateComponentId(const QString& componentType)
 
 QString ComponentPersistence::getSystemCContent(const QString& componentType, const QString& componentId)
 {
-    QString content;
-    QTextStream stream(&content);
-    
-    stream << "// SystemC file for " << componentType << "\n";
-    stream << "// Component ID: " << componentId << "\n\n";
-    stream << "#include <systemc.h>\n\n";
-    stream << "SC_MODULE(" << componentId << ") {\n";
-    stream << "    // Ports\n";
-    
-    // Add ports based on component type
-    if (componentType == "Transactor") {
-        stream << "    sc_in<bool> clk;\n";
-        stream << "    sc_in<bool> reset;\n";
-        stream << "    sc_out<sc_uint<32>> data_out1;\n";
-        stream << "    sc_out<sc_uint<32>> data_out2;\n";
-        stream << "    sc_out<sc_uint<32>> data_out3;\n";
-    } else if (componentType == "RM") {
-        stream << "    sc_in<sc_uint<32>> data_in;\n";
-        stream << "    sc_out<sc_uint<32>> data_out;\n";
-    } else if (componentType == "Compare") {
-        stream << "    sc_in<sc_uint<32>> data_in1;\n";
-        stream << "    sc_in<sc_uint<32>> data_in2;\n";
-    } else if (componentType == "Driver") {
-        stream << "    sc_in<sc_uint<32>> data_in;\n";
-        stream << "    sc_out<bool> valid;\n";
-        stream << "    sc_out<sc_uint<32>> data_out;\n";
-    } else if (componentType == "Stimuler") {
-        stream << "    sc_in<bool> clk;\n";
-        stream << "    sc_out<sc_uint<32>> data_out;\n";
-    } else if (componentType == "Stimuli") {
-        stream << "    sc_out<sc_uint<32>> data_out;\n";
-    } else if (componentType == "RTL") {
-        stream << "    // RTL Component - SystemC wrapper for RTL modules\n";
-        stream << "    sc_in<sc_uint<32>> data_in;   // Input port\n";
-        stream << "    sc_out<sc_uint<32>> data_out;  // Output port\n";
-    }
-    
-    stream << "\n    SC_CTOR(" << componentId << ") {\n";
-    stream << "        // Constructor\n";
-    stream << "    }\n";
-    stream << "\n    void process() {\n";
-    stream << "        // Process logic\n";
-    stream << "    }\n";
-    stream << "};\n";
-    
-    return content;
+    SystemCGenerator::Request request;
+    request.componentType = componentType;
+    request.componentId = componentId;
+    return m_generator->generate(request);
 }
 
 QString ComponentPersistence::getSystemCContentFromModuleInfo(const ModuleInfo& moduleInfo, const QString& componentId)
 {
-    QString content;
-    QTextStream stream(&content);
-    
-    stream << "// SystemC file for RTL module: " << moduleInfo.name << "\n";
-    stream << "// Component ID: " << componentId << "\n";
-    stream << "// Auto-generated from SystemVerilog module\n\n";
-    stream << "#include <systemc.h>\n\n";
-    stream << "SC_MODULE(" << componentId << ") {\n";
-    stream << "    // Ports from RTL module\n";
-    
-    // Generate input ports
-    if (!moduleInfo.inputs.isEmpty()) {
-        stream << "\n    // Input ports\n";
-        for (const Port& port : moduleInfo.inputs) {
-            QString portType = getSystemCPortType(port);
-            stream << "    sc_in<" << portType << "> " << port.name << ";";
-            if (!port.width.isEmpty()) {
-                stream << "  // " << port.width;
-            }
-            stream << "\n";
-        }
-    }
-    
-    // Generate output ports
-    if (!moduleInfo.outputs.isEmpty()) {
-        stream << "\n    // Output ports\n";
-        for (const Port& port : moduleInfo.outputs) {
-            QString portType = getSystemCPortType(port);
-            stream << "    sc_out<" << portType << "> " << port.name << ";";
-            if (!port.width.isEmpty()) {
-                stream << "  // " << port.width;
-            }
-            stream << "\n";
-        }
-    }
-    
-    stream << "\n    SC_CTOR(" << componentId << ") {\n";
-    stream << "        // Constructor\n";
-    stream << "        // Initialize RTL module wrapper\n";
-    stream << "    }\n";
-    stream << "\n    void process() {\n";
-    stream << "        // Process logic for " << moduleInfo.name << "\n";
-    stream << "        // Implement RTL behavior here\n";
-    stream << "    }\n";
-    stream << "};\n";
-    
-    return content;
+    SystemCGenerator::Request request;
+    request.componentId = componentId;
+    request.moduleInfo = moduleInfo;
+    request.moduleWrapper = true;
+    return m_generator->generate(request);
 }
 
 QString ComponentPersistence::getSystemCPortType(const Port& port)
 {
-    // Parse width from format "[MSB:LSB]"
-    if (port.width.isEmpty()) {
-        return "bool";  // Single bit
-    }
-    
-    // Extract MSB from width string like "[7:0]"
-    QRegularExpression re(R"(\[(\d+):(\d+)\])");
-    QRegularExpressionMatch match = re.match(port.width);
-    
-    if (match.hasMatch()) {
-        int msb = match.captured(1).toInt();
-        int lsb = match.captured(2).toInt();
-        int width = msb - lsb + 1;
-        
-        if (width == 1) {
-            return "bool";
-        } else if (width <= 64) {
-            return "sc_uint<" + QString::number(width) + ">";
-        } else {
-            return "sc_biguint<" + QString::number(width) + ">";
-        }
-    }
-    
-    // Default fallback
-    return "sc_uint<32>";
+    return SystemCGenerator::systemCPortType(port);
+}
+
+void ComponentPersistence::flushPendingWrites()
+{
+    m_writeQueue->flush();
 }
 
 QString ComponentPersistence::createComponentFile(const QString& componentType, const QPointF& position, const QSizeF& size)
 {
     qDebug() << "📄 ComponentPersistence::createComponentFile() called for type:" << componentType << "at position:" << position;
+    const QStringList ids = createComponentFiles({{componentType, position, size}});
+    return ids.isEmpty() ? QString() : ids.first();
+}
+
+QStringList ComponentPersistence::createComponentFiles(const QVector<ComponentPlacement>& placements)
+{
     if (m_workingDirectory.isEmpty()) {
         qWarning() << "No working directory set";
-        return QString();
+        return QStringList();
     }
     
-    QString componentId = generateComponentId(componentType);
-    QString fileName = componentId + ".cpp";
-    QString filePath = QDir(m_workingDirectory).filePath(fileName);
-    
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Failed to create component file:" << filePath;
-        return QString();
+    QDir dir(m_workingDirectory);
+    QStringList componentIds;
+    QVector<SystemCGenerator::Request> requests;
+    componentIds.reserve(placements.size());
+    requests.reserve(placements.size());
+    for (const ComponentPlacement& placement : placements) {
+        SystemCGenerator::Request request;
+        request.componentType = placement.componentType;
+        request.componentId = generateComponentId(placement.componentType);
+        componentIds.append(request.componentId);
+        requests.append(request);
+    }
+    
+    // Render everything first, then hand the files to the writer in one go
+    const QVector<QString> contents = m_generator->generateBatch(requests);
+    QVector<QPair<QString, QString>> files;
+    files.reserve(contents.size());
+    for (int i = 0; i < contents.size(); ++i) {
+        files.append({dir.filePath(componentIds.at(i) + ".cpp"), contents.at(i)});
+    }
+    m_writeQueue->enqueue(files);
+    
+    for (int i = 0; i < placements.size(); ++i) {
+        const ComponentPlacement& placement = placements.at(i);
+        
+        // Create enhanced metadata
+        QJsonObject enhancedMetadata = createEnhancedMetadata(componentIds.at(i), placement.componentType,
+                                                              placement.position, placement.size);
+        
+        // Cache the metadata (no individual file creation)
+        updateCachedMetadata(componentIds.at(i), enhancedMetadata);
     }
     
-    QTextStream out(&file);
-    out << getSystemCContent(componentType, componentId);
-    file.close();
-    
-    // Create enhanced metadata
-    QJsonObject enhancedMetadata = createEnhancedMetadata(componentId, componentType, position, size);
-    
-    // Cache the metadata (no individual file creation)
-    updateCachedMetadata(componentId, enhancedMetadata);
-    
-    qDebug() << "Created component file:" << filePath << "with enhanced metadata";
-    return componentId;
+    qDebug() << "Queued" << files.size() << "component file(s) with enhanced metadata";
+    return componentIds;
 }
 
 QString ComponentPersistence::createRTLModuleFile(const ModuleInfo& moduleInfo, const QString& filePath,
@@ -221,15 +148,7 @@ QString ComponentPersistence::createRTLModuleFile(const ModuleInfo& moduleInfo,
     QString fileName = componentId + ".cpp";
     QString cppFilePath = QDir(m_workingDirectory).filePath(fileName);
     
-    QFile file(cppFilePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Failed to create RTL module file:" << cppFilePath;
-        return QString();
-    }
-    
-    QTextStream out(&file);
-    out << getSystemCContentFromModuleInfo(moduleInfo, componentId);
-    file.close();
+    m_writeQueue->enqueue(cppFilePath, getSystemCContentFromModuleInfo(moduleInfo, componentId));
     
     // Create enhanced metadata for RTL module
     QJsonObject enhancedMetadata = createEnhancedMetadata(componentId, "RTLModule", position, size);
@@ -274,7 +193,7 @@ QString ComponentPersistence::createRTLModuleFile(const ModuleInfo& moduleInfo,
     // Cache the metadata (no individual file creation)
     updateCachedMetadata(componentId, enhancedMetadata);
     
-    qDebug() << "Created RTL module file:" << cppFilePath << "for module:" << moduleInfo.name;
+    qDebug() << "Queued RTL module file:" << cppFilePath << "for module:" << moduleInfo.name;
     return componentId;
 }
 
@@ -285,6 +204,9 @@ bool ComponentPersistence::loadComponentsFromDirectory(QGraphicsScene* scene, Pe
         return false;
     }
     
+    // The .cpp files are checked for below
+    flushPendingWrites();
+    
     // Load from centralized meta.json instead of individual files
     QString metaDir = QDir(m_workingDirectory).filePath(".scv");
     QString metaFilePath = QDir(metaDir).filePath("meta.json");
@@ -316,6 +238,13 @@ bool ComponentPersistence::loadComponentsFromDirectory(QGraphicsScene* scene, Pe
         QString id = metadata["id"].toString();
         QString type = metadata["type"].toString();
         
+        // Components inside a block load with the block's own scene; their IDs are taken all the same.
+        // Checked before touching the disk, so loading a level costs only what the level holds
+        if (!pm->belongsToScene(scene, id, false)) {
+            m_componentCounter = qMax(m_componentCounter, id.mid(id.lastIndexOf('_') + 1).toInt());
+            continue;
+        }
+        
         // Verify that the corresponding .cpp file exists
         QString cppFile = id + ".cpp";
         QString cppFilePath = QDir(m_workingDirectory).filePath(cppFile);
@@ -604,6 +533,15 @@ void ComponentPersistence::updateComponentColor(const QString& componentId, cons
         return;
     }
     
+    // The appearance in meta.json is what loading restores; an invalid color clears it
+    QJsonObject metadata = getCachedMetadata(componentId);
+    if (!metadata.isEmpty()) {
+        QJsonObject appearance = metadata["appearance"].toObject();
+        appearance["color"] = color.isValid() ? color.name(QColor::HexArgb) : QString();
+        metadata["appearance"] = appearance;
+        updateCachedMetadata(componentId, metadata);
+    }
+    
     QString metaFileName = componentId + ".meta.json";
     QString metaFilePath = QDir(m_workingDirectory).filePath(metaFileName);
     
@@ -620,7 +558,11 @@ void ComponentPersistence::updateComponentColor(const QString& componentId, cons
     }
     
     QJsonObject obj = doc.object();
-    obj["color"] = color.name(QColor::HexArgb);  // Save with alpha
+    if (color.isValid()) {
+        obj["color"] = color.name(QColor::HexArgb);  // Save with alpha
+    } else {
+        obj.remove("color");
+    }
     
     if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         QJsonDocument newDoc(obj);
@@ -697,6 +639,9 @@ void ComponentPersistence::deleteComponentFile(const QString& componentId, bool
     QString metaFile = componentId + ".meta.json";
     QString metaFilePath = dir.filePath(metaFile);
     
+    // A queued write would otherwise recreate the file after it is deleted
+    flushPendingWrites();
+    
     bool cppExists = QFile::exists(cppFilePath);
     bool metaExists = QFile::exists(metaFilePath);
     
@@ -1046,6 +991,21 @@ void ComponentPersistence::scheduleMetadataUpdate(const QString& componentId)
     }
 }
 
+void ComponentPersistence::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void ComponentPersistence::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0) {
+        return;
+    }
+    if (m_batchDirty) {
+        saveAllMetadataToFile();
+    }
+}
+
 void ComponentPersistence::clearMetadataCache()
 {
     m_metadataCache.clear();
@@ -1429,6 +1389,13 @@ void ComponentPersistence::updateCachedMetadata(const QString& componentId, cons
 
 void ComponentPersistence::saveAllMetadataToFile()
 {
+    // Inside a batch every update only touches the cache; endBatch() writes once
+    if (m_batchDepth > 0) {
+        m_batchDirty = true;
+        return;
+    }
+    m_batchDirty = false;
+    
     if (m_workingDirectory.isEmpty()) {
         qWarning() << "⚠️ No working directory set - cannot save metadata";
         return;
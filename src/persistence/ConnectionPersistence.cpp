@@ -9,6 +9,7 @@
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonArray>
+#include <QSet>
 #include <QDebug>
 #include <QGraphicsScene>
 
@@ -22,8 +23,32 @@ void ConnectionPersistence::setWorkingDirectory(const QString& directory)
     m_workingDirectory = directory;
 }
 
+void ConnectionPersistence::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void ConnectionPersistence::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0) {
+        return;
+    }
+    const bool dirty = m_batchDirty;
+    const QJsonObject json = m_batchJson;
+    m_batchLoaded = false;
+    m_batchDirty = false;
+    m_batchJson = QJsonObject();
+    if (dirty) {
+        saveConnectionsJson(json);
+    }
+}
+
 QJsonObject ConnectionPersistence::loadConnectionsJson()
 {
+    if (m_batchLoaded) {
+        return m_batchJson;
+    }
+    
     qDebug() << "📂 ConnectionPersistence::loadConnectionsJson() called for directory:" << m_workingDirectory;
     if (m_workingDirectory.isEmpty()) {
         return QJsonObject();
@@ -54,11 +79,22 @@ QJsonObject ConnectionPersistence::loadConnectionsJson()
     connectionsObj["version"] = "1.0";
     connectionsObj["connections"] = rootObj["connections"].toArray();
     
+    if (m_batchDepth > 0) {
+        m_batchJson = connectionsObj;
+        m_batchLoaded = true;
+    }
     return connectionsObj;
 }
 
 void ConnectionPersistence::saveConnectionsJson(const QJsonObject& json)
 {
+    if (m_batchDepth > 0) {
+        m_batchJson = json;
+        m_batchLoaded = true;
+        m_batchDirty = true;
+        return;
+    }
+    
     qDebug() << "💾 ConnectionPersistence::saveConnectionsJson() called for directory:" << m_workingDirectory;
     if (m_workingDirectory.isEmpty()) {
         return;
@@ -129,6 +165,7 @@ QList<ConnectionData> ConnectionPersistence::parseConnections(const QJsonObject&
         
         // Parse orthogonal offset
         data.orthogonalOffset = conn["orthogonalOffset"].toDouble(0.0);
+        data.manualOffset = conn["manualOffset"].toBool(false);
         
         result.append(data);
     }
@@ -139,7 +176,8 @@ QList<ConnectionData> ConnectionPersistence::parseConnections(const QJsonObject&
 void ConnectionPersistence::saveConnection(const QString& sourceId, const QPointF& sourcePort,
                                           const QString& targetId, const QPointF& targetPort,
                                           bool sourceIsRTL, bool targetIsRTL,
-                                          const QList<QPointF>& controlPoints, qreal orthogonalOffset)
+                                          const QList<QPointF>& controlPoints, qreal orthogonalOffset,
+                                          bool manualOffset)
 {
     QJsonObject json = loadConnectionsJson();
     QJsonArray connections = json["connections"].toArray();
@@ -161,6 +199,7 @@ void ConnectionPersistence::saveConnection(const QString& sourceId, const QPoint
     
     // Save orthogonal offset
     connection["orthogonalOffset"] = orthogonalOffset;
+    connection["manualOffset"] = manualOffset;
     
     connections.append(connection);
     json["connections"] = connections;
@@ -239,7 +278,7 @@ void ConnectionPersistence::updateConnectionControlPoints(const QString& sourceI
 
 void ConnectionPersistence::updateConnectionOrthogonalOffset(const QString& sourceId, const QPointF& sourcePort,
                                                              const QString& targetId, const QPointF& targetPort,
-                                                             qreal orthogonalOffset)
+                                                             qreal orthogonalOffset, bool manualOffset)
 {
     QJsonObject json = loadConnectionsJson();
     QJsonArray connections = json["connections"].toArray();
@@ -261,6 +300,7 @@ void ConnectionPersistence::updateConnectionOrthogonalOffset(const QString& sour
                 
                 // Update orthogonal offset
                 conn["orthogonalOffset"] = orthogonalOffset;
+                conn["manualOffset"] = manualOffset;
                 connections[i] = conn;
                 
                 json["connections"] = connections;
@@ -295,6 +335,22 @@ void ConnectionPersistence::updateRTLComponentInConnections(const QString& compo
     }
 }
 
+QList<ConnectionData> ConnectionPersistence::connectionsOf(const QStringList& componentIds)
+{
+    QList<ConnectionData> result;
+    if (m_workingDirectory.isEmpty() || componentIds.isEmpty()) {
+        return result;
+    }
+    
+    const QSet<QString> ids(componentIds.cbegin(), componentIds.cend());
+    for (const ConnectionData& conn : parseConnections(loadConnectionsJson())) {
+        if (ids.contains(conn.sourceId) || ids.contains(conn.targetId)) {
+            result.append(conn);
+        }
+    }
+    return result;
+}
+
 void ConnectionPersistence::removeComponentFromConnections(const QString& componentId)
 {
     if (m_workingDirectory.isEmpty()) {
@@ -376,40 +432,38 @@ bool ConnectionPersistence::loadConnections(QGraphicsScene* scene, PersistenceMa
     
     int restoredCount = 0;
     int failedCount = 0;
+    int skippedCount = 0;
     
     for (const ConnectionData& conn : connections) {
-        ReadyComponentGraphicsItem* source = nullptr;
-        ReadyComponentGraphicsItem* target = nullptr;
-        
-        // Get source (either ready component or RTL module)
-        if (conn.sourceIsRTL) {
-            source = pm->getRTLModuleByName(conn.sourceId);
-            qDebug() << "🔍 Looking for RTL source component:" << conn.sourceId << (source ? "✅ Found" : "❌ Not found");
-        } else {
-            source = pm->getComponentById(conn.sourceId);
-            qDebug() << "🔍 Looking for ready source component:" << conn.sourceId << (source ? "✅ Found" : "❌ Not found");
+        // Ends inside a block attach to the block's port; connections within one block
+        // or reaching outside this scene belong to another scene
+        const PersistenceManager::SceneEndpoint sourceEnd = pm->sceneEndpoint(scene, conn.sourceId, conn.sourceIsRTL, conn.sourcePort);
+        const PersistenceManager::SceneEndpoint targetEnd = pm->sceneEndpoint(scene, conn.targetId, conn.targetIsRTL, conn.targetPort);
+        if (sourceEnd.outside || targetEnd.outside || (sourceEnd.block && sourceEnd.block == targetEnd.block)) {
+            skippedCount++;
+            continue;
         }
         
-        // Get target (either ready component or RTL module)
-        if (conn.targetIsRTL) {
-            target = pm->getRTLModuleByName(conn.targetId);
-            qDebug() << "🔍 Looking for RTL target component:" << conn.targetId << (target ? "✅ Found" : "❌ Not found");
-        } else {
-            target = pm->getComponentById(conn.targetId);
-            qDebug() << "🔍 Looking for ready target component:" << conn.targetId << (target ? "✅ Found" : "❌ Not found");
-        }
+        ReadyComponentGraphicsItem* source = sourceEnd.item;
+        ReadyComponentGraphicsItem* target = targetEnd.item;
+        qDebug() << "🔍 Looking for source component:" << conn.sourceId << (source ? "✅ Found" : "❌ Not found");
+        qDebug() << "🔍 Looking for target component:" << conn.targetId << (target ? "✅ Found" : "❌ Not found");
         
         if (source && target) {
-            WireGraphicsItem* wire = new WireGraphicsItem(source, conn.sourcePort, target, conn.targetPort);
+            WireGraphicsItem* wire = new WireGraphicsItem(source, sourceEnd.port, target, targetEnd.port);
+            
+            // The stored routing was drawn between the components themselves, not their blocks
+            const bool direct = !sourceEnd.block && !targetEnd.block;
             
             // Restore control points
-            if (!conn.controlPoints.isEmpty()) {
+            if (direct && !conn.controlPoints.isEmpty()) {
                 wire->setControlPoints(conn.controlPoints);
             }
             
             // Restore orthogonal offset
-            if (conn.orthogonalOffset != 0.0) {
+            if (direct && conn.orthogonalOffset != 0.0) {
                 wire->setOrthogonalOffset(conn.orthogonalOffset);
+                wire->setManualOffset(conn.manualOffset);
             }
             
             scene->addItem(wire);
@@ -435,7 +489,8 @@ bool ConnectionPersistence::loadConnections(QGraphicsScene* scene, PersistenceMa
         }
     }
     
-    qDebug() << "🔗 Connection loading completed - Restored:" << restoredCount << "Failed:" << failedCount;
+    qDebug() << "🔗 Connection loading completed - Restored:" << restoredCount << "Failed:" << failedCount
+             << "In other scenes:" << skippedCount;
     
     return true;
 }
@@ -0,0 +1,82 @@
+// FileWriteQueue.cpp
+#include "persistence/FileWriteQueue.h"
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QDebug>
+
+FileWriteQueue::FileWriteQueue(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+FileWriteQueue::~FileWriteQueue()
+{
+    // Generated files must not be lost on shutdown
+    flush();
+}
+
+void FileWriteQueue::enqueue(const QString& filePath, const QString& content)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_pending[filePath];
+        ++m_pendingTotal;
+    }
+    m_pool.start([this, filePath, content]() {
+        write(filePath, content);
+    });
+}
+
+void FileWriteQueue::enqueue(const QVector<QPair<QString, QString>>& files)
+{
+    for (const auto& file : files) {
+        enqueue(file.first, file.second);
+    }
+}
+
+bool FileWriteQueue::isPending(const QString& filePath) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.contains(filePath);
+}
+
+int FileWriteQueue::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pendingTotal;
+}
+
+void FileWriteQueue::flush()
+{
+    m_pool.waitForDone();
+}
+
+void FileWriteQueue::write(const QString& filePath, const QString& content)
+{
+    QSaveFile file(filePath);
+    bool ok = file.open(QIODevice::WriteOnly | QIODevice::Text);
+    if (ok) {
+        ok = file.write(content.toUtf8()) >= 0 && file.commit();
+    }
+    const QString errorString = ok ? QString() : file.errorString();
+    if (!ok) {
+        qWarning() << "Failed to write generated file:" << filePath << errorString;
+    }
+
+    bool drained;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (--m_pending[filePath] == 0) {
+            m_pending.remove(filePath);
+        }
+        drained = (--m_pendingTotal == 0);
+    }
+
+    QMetaObject::invokeMethod(this, [this, filePath, ok, errorString, drained]() {
+        emit fileWritten(filePath, ok, errorString);
+        if (drained) {
+            emit idle();
+        }
+    }, Qt::QueuedConnection);
+}
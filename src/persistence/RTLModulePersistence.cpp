@@ -22,8 +22,32 @@ void RTLModulePersistence::setWorkingDirectory(const QString& directory)
     m_workingDirectory = directory;
 }
 
+void RTLModulePersistence::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void RTLModulePersistence::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0) {
+        return;
+    }
+    const bool dirty = m_batchDirty;
+    const QJsonObject json = m_batchJson;
+    m_batchLoaded = false;
+    m_batchDirty = false;
+    m_batchJson = QJsonObject();
+    if (dirty) {
+        saveRTLPlacementsJson(json);
+    }
+}
+
 QJsonObject RTLModulePersistence::loadRTLPlacementsJson()
 {
+    if (m_batchLoaded) {
+        return m_batchJson;
+    }
+    
     qDebug() << "📂 RTLModulePersistence::loadRTLPlacementsJson() called for directory:" << m_workingDirectory;
     if (m_workingDirectory.isEmpty()) {
         return QJsonObject();
@@ -48,11 +72,22 @@ QJsonObject RTLModulePersistence::loadRTLPlacementsJson()
     QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
     file.close();
     
+    if (m_batchDepth > 0) {
+        m_batchJson = doc.object();
+        m_batchLoaded = true;
+    }
     return doc.object();
 }
 
 void RTLModulePersistence::saveRTLPlacementsJson(const QJsonObject& json)
 {
+    if (m_batchDepth > 0) {
+        m_batchJson = json;
+        m_batchLoaded = true;
+        m_batchDirty = true;
+        return;
+    }
+    
     qDebug() << "💾 RTLModulePersistence::saveRTLPlacementsJson() called for directory:" << m_workingDirectory;
     if (m_workingDirectory.isEmpty()) {
         return;
@@ -88,6 +123,7 @@ QList<RTLModuleData> RTLModulePersistence::parseRTLPlacements(const QJsonObject&
         
         RTLModuleData data;
         data.moduleName = placement["moduleName"].toString();
+        data.definition = placement["definition"].toString(data.moduleName);
         data.filePath = placement["filePath"].toString();
         
         QJsonObject pos = placement["position"].toObject();
@@ -99,7 +135,8 @@ QList<RTLModuleData> RTLModulePersistence::parseRTLPlacements(const QJsonObject&
     return result;
 }
 
-void RTLModulePersistence::saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position)
+void RTLModulePersistence::saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position,
+                                                  const QString& definition)
 {
     QJsonObject json = loadRTLPlacementsJson();
     QJsonArray placements = json["placements"].toArray();
@@ -108,8 +145,22 @@ void RTLModulePersistence::saveRTLModulePlacement(const QString& moduleName, con
     placement["moduleName"] = moduleName;
     placement["filePath"] = filePath;
     placement["position"] = QJsonObject{{"x", position.x()}, {"y", position.y()}};
+    if (!definition.isEmpty() && definition != moduleName) {
+        placement["definition"] = definition;
+    }
     
-    placements.append(placement);
+    // One placement per name: saving again replaces it
+    bool replaced = false;
+    for (int i = 0; i < placements.size(); ++i) {
+        if (placements[i].toObject()["moduleName"].toString() == moduleName) {
+            placements[i] = placement;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        placements.append(placement);
+    }
     json["placements"] = placements;
     
     saveRTLPlacementsJson(json);
@@ -223,6 +274,11 @@ bool RTLModulePersistence::loadRTLModules(QGraphicsScene* scene, PersistenceMana
     QStringList modulesToRemove; // Track modules that no longer exist
     
     for (const RTLModuleData& data : placements) {
+        // Modules inside a block are parsed only once the block is opened
+        if (!pm->belongsToScene(scene, data.moduleName, true)) {
+            continue;
+        }
+        
         // Check if the file still exists
         QFile file(data.filePath);
         if (!file.exists()) {
@@ -232,11 +288,11 @@ bool RTLModulePersistence::loadRTLModules(QGraphicsScene* scene, PersistenceMana
         }
         
         // Parse the module
-        ModuleInfo modInfo = SvParser::parseModule(data.filePath, data.moduleName);
+        ModuleInfo modInfo = SvParser::parseModule(data.filePath, data.definition);
         
         // Verify module was successfully parsed (has a valid name)
         if (modInfo.name.isEmpty()) {
-            qWarning() << "⚠️ Failed to parse RTL module:" << data.moduleName << "from" << data.filePath;
+            qWarning() << "⚠️ Failed to parse RTL module:" << data.definition << "from" << data.filePath;
             modulesToRemove.append(data.moduleName);
             continue;
         }
@@ -0,0 +1,265 @@
+// SystemCGenerator.cpp
+#include "persistence/SystemCGenerator.h"
+#include "parsers/PortType.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+
+namespace {
+
+const char* const COMPONENT_TEMPLATE = R"TMPL(// SystemC file for {{type}}
+// Component ID: {{id}}
+
+#include <systemc.h>
+
+SC_MODULE({{id}}) {
+    // Ports
+{{#note}}
+    // {{note}}
+{{/note}}
+{{#ports}}
+    {{direction}}<{{ctype}}> {{name}};{{comment}}
+{{/ports}}
+
+    SC_CTOR({{id}}) {
+        // Constructor
+    }
+
+    void process() {
+        // Process logic
+    }
+};
+)TMPL";
+
+const char* const MODULE_WRAPPER_TEMPLATE = R"TMPL(// SystemC file for RTL module: {{module}}
+// Component ID: {{id}}
+// Auto-generated from SystemVerilog module
+
+#include <systemc.h>
+
+SC_MODULE({{id}}) {
+    // Ports from RTL module
+{{#has_inputs}}
+
+    // Input ports
+{{#inputs}}
+    sc_in<{{ctype}}> {{name}};{{#width}}  // {{width}}{{/width}}
+{{/inputs}}
+{{/has_inputs}}
+{{#has_outputs}}
+
+    // Output ports
+{{#outputs}}
+    sc_out<{{ctype}}> {{name}};{{#width}}  // {{width}}{{/width}}
+{{/outputs}}
+{{/has_outputs}}
+
+    SC_CTOR({{id}}) {
+        // Constructor
+        // Initialize RTL module wrapper
+    }
+
+    void process() {
+        // Process logic for {{module}}
+        // Implement RTL behavior here
+    }
+};
+)TMPL";
+
+const char* const MODULE_WRAPPER_KEY = "RTLModule";
+
+struct PortSpec {
+    const char* direction;
+    const char* type;
+    const char* name;
+    const char* comment;
+};
+
+struct ComponentSpec {
+    const char* note;
+    QVector<PortSpec> ports;
+};
+
+const QHash<QString, ComponentSpec>& builtinComponents()
+{
+    static const QHash<QString, ComponentSpec> specs = {
+        {"Transactor", {"", {{"sc_in", "bool", "clk", ""},
+                             {"sc_in", "bool", "reset", ""},
+                             {"sc_out", "sc_uint<32>", "data_out1", ""},
+                             {"sc_out", "sc_uint<32>", "data_out2", ""},
+                             {"sc_out", "sc_uint<32>", "data_out3", ""}}}},
+        {"RM", {"", {{"sc_in", "sc_uint<32>", "data_in", ""},
+                     {"sc_out", "sc_uint<32>", "data_out", ""}}}},
+        {"Compare", {"", {{"sc_in", "sc_uint<32>", "data_in1", ""},
+                          {"sc_in", "sc_uint<32>", "data_in2", ""}}}},
+        {"Driver", {"", {{"sc_in", "sc_uint<32>", "data_in", ""},
+                         {"sc_out", "bool", "valid", ""},
+                         {"sc_out", "sc_uint<32>", "data_out", ""}}}},
+        {"Stimuler", {"", {{"sc_in", "bool", "clk", ""},
+                           {"sc_out", "sc_uint<32>", "data_out", ""}}}},
+        {"Stimuli", {"", {{"sc_out", "sc_uint<32>", "data_out", ""}}}},
+        {"RTL", {"RTL Component - SystemC wrapper for RTL modules",
+                 {{"sc_in", "sc_uint<32>", "data_in", "   // Input port"},
+                  {"sc_out", "sc_uint<32>", "data_out", "  // Output port"}}}}
+    };
+    return specs;
+}
+
+QVector<CodeTemplate::Fields> modulePorts(const QList<Port>& ports)
+{
+    QVector<CodeTemplate::Fields> items;
+    items.reserve(ports.size());
+    for (const Port& port : ports) {
+        CodeTemplate::Fields item;
+        item.insert("ctype", SystemCGenerator::systemCPortType(port));
+        item.insert("name", port.name);
+        item.insert("width", port.width);
+        items.append(item);
+    }
+    return items;
+}
+
+} // namespace
+
+SystemCGenerator::SystemCGenerator(const QString& workingDirectory)
+    : m_workingDirectory(workingDirectory)
+{
+}
+
+void SystemCGenerator::setWorkingDirectory(const QString& directory)
+{
+    m_workingDirectory = directory;
+    m_cache.clear();
+}
+
+QString SystemCGenerator::generate(const Request& request)
+{
+    return templateFor(request).render(templateData(request));
+}
+
+QVector<QString> SystemCGenerator::generateBatch(const QVector<Request>& requests)
+{
+    // Resolve on this thread: the cache is not shared with the workers, the
+    // compiled templates are only read from there
+    QHash<QString, CodeTemplate> templates;
+    for (const Request& request : requests) {
+        const QString key = templateKey(request);
+        if (!templates.contains(key)) {
+            templates.insert(key, templateFor(request));
+        }
+    }
+
+    auto render = [&templates](const Request& request) {
+        return templates.value(templateKey(request)).render(templateData(request));
+    };
+
+    if (requests.size() < PARALLEL_BATCH_SIZE) {
+        QVector<QString> results;
+        results.reserve(requests.size());
+        for (const Request& request : requests) {
+            results.append(render(request));
+        }
+        return results;
+    }
+    return QtConcurrent::blockingMapped<QVector<QString>>(requests, render);
+}
+
+QString SystemCGenerator::systemCPortType(const Port& port)
+{
+    return PortType::fromPort(port).systemCType();
+}
+
+const CodeTemplate& SystemCGenerator::templateFor(const Request& request)
+{
+    const QString key = templateKey(request);
+    const QString path = userTemplatePath(key);
+    const QFileInfo info(path);
+    const QDateTime modified = (!path.isEmpty() && info.exists()) ? info.lastModified() : QDateTime();
+
+    // A broken override is cached as the built-in with its timestamp, so it
+    // is not re-read until it changes
+    auto cached = m_cache.find(key);
+    if (cached != m_cache.end() && cached->modified == modified) {
+        return cached->compiled;
+    }
+
+    CachedTemplate entry;
+    entry.modified = modified;
+    if (modified.isValid()) {
+        QFile file(path);
+        QString errorString;
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            entry.compiled = CodeTemplate::compile(QString::fromUtf8(file.readAll()), &errorString);
+        } else {
+            errorString = file.errorString();
+        }
+        if (entry.compiled.isValid()) {
+            entry.sourcePath = path;
+            qDebug() << "🧩 Using project template" << path;
+        } else {
+            qWarning() << "⚠️ Ignoring template" << path << ":" << errorString;
+        }
+    }
+    if (!entry.compiled.isValid()) {
+        entry.compiled = builtinTemplate(request.moduleWrapper);
+    }
+
+    cached = m_cache.insert(key, entry);
+    return cached->compiled;
+}
+
+QString SystemCGenerator::userTemplatePath(const QString& key) const
+{
+    if (m_workingDirectory.isEmpty()) {
+        return QString();
+    }
+    return QDir(m_workingDirectory).filePath(".scv/templates/" + key + ".sc.tmpl");
+}
+
+CodeTemplate SystemCGenerator::builtinTemplate(bool moduleWrapper)
+{
+    static const CodeTemplate component = CodeTemplate::compile(COMPONENT_TEMPLATE);
+    static const CodeTemplate moduleWrapperTemplate = CodeTemplate::compile(MODULE_WRAPPER_TEMPLATE);
+    return moduleWrapper ? moduleWrapperTemplate : component;
+}
+
+QString SystemCGenerator::templateKey(const Request& request)
+{
+    return request.moduleWrapper ? QString(MODULE_WRAPPER_KEY) : request.componentType;
+}
+
+CodeTemplate::Data SystemCGenerator::templateData(const Request& request)
+{
+    CodeTemplate::Data data;
+    data.fields.insert("id", request.componentId);
+
+    if (request.moduleWrapper) {
+        const ModuleInfo& info = request.moduleInfo;
+        data.fields.insert("module", info.name);
+        data.fields.insert("has_inputs", info.inputs.isEmpty() ? QString() : "1");
+        data.fields.insert("has_outputs", info.outputs.isEmpty() ? QString() : "1");
+        data.lists.insert("inputs", modulePorts(info.inputs));
+        data.lists.insert("outputs", modulePorts(info.outputs));
+        return data;
+    }
+
+    data.fields.insert("type", request.componentType);
+    QVector<CodeTemplate::Fields> ports;
+    const auto spec = builtinComponents().constFind(request.componentType);
+    if (spec != builtinComponents().constEnd()) {
+        data.fields.insert("note", QString::fromUtf8(spec->note));
+        ports.reserve(spec->ports.size());
+        for (const PortSpec& port : spec->ports) {
+            CodeTemplate::Fields item;
+            item.insert("direction", port.direction);
+            item.insert("ctype", port.type);
+            item.insert("name", port.name);
+            item.insert("comment", port.comment);
+            ports.append(item);
+        }
+    }
+    data.lists.insert("ports", ports);
+    return data;
+}
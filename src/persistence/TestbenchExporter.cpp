@@ -0,0 +1,219 @@
+// TestbenchExporter.cpp
+#include "persistence/TestbenchExporter.h"
+#include "scene/Netlist.h"
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const QLatin1String INDENT("    ");
+
+QString beginMarker(const QString& name)
+{
+    return "// SCV BEGIN " + name;
+}
+
+QString endMarker(const QString& name)
+{
+    return "// SCV END " + name;
+}
+
+} // namespace
+
+TestbenchExporter::TestbenchExporter(const QString& workingDirectory)
+    : m_workingDirectory(workingDirectory)
+{
+}
+
+QStringList TestbenchExporter::sectionNames()
+{
+    return {"includes", "clocks", "signals", "instances", "bindings"};
+}
+
+QHash<QString, QString> TestbenchExporter::renderSections(const Netlist& netlist)
+{
+    const QVector<Netlist::Instance>& instances = netlist.instances();
+
+    QString includes;
+    QString clocks;
+    QString signalDecls;
+    QString declarations;
+    QString bindings;
+
+    includes += "#include <systemc.h>\n";
+    QSet<QString> included;
+    for (const Netlist::Instance& instance : instances) {
+        if (!included.contains(instance.sourceFile)) {
+            included.insert(instance.sourceFile);
+            includes += QString("#include \"%1\"\n").arg(instance.sourceFile);
+        }
+    }
+
+    // Nets in name order; netOfPin maps "u_x.port" to the net bound to it
+    QVector<const Netlist::Net*> nets;
+    for (const Netlist::Net& net : netlist.nets()) {
+        nets.append(&net);
+    }
+    std::sort(nets.begin(), nets.end(), [](const Netlist::Net* a, const Netlist::Net* b) {
+        return a->name < b->name;
+    });
+
+    QHash<QString, QString> netOfPin;
+    for (const Netlist::Net* net : nets) {
+        for (const Netlist::Pin& pin : net->pins) {
+            netOfPin.insert(netlist.pinName(pin), net->name);
+        }
+
+        if (net->clock) {
+            clocks += QString("%1sc_clock %2(\"%2\", %3, SC_NS);\n").arg(INDENT, net->name).arg(CLOCK_PERIOD_NS);
+            continue;
+        }
+        signalDecls += QString("%1sc_signal<%2> %3;").arg(INDENT, net->type, net->name);
+        if (!net->wired) {
+            signalDecls += "  // Unconnected";
+        }
+        signalDecls += "\n";
+    }
+
+    for (const Netlist::Instance& instance : instances) {
+        declarations += QString("%1%2 %3(\"%3\");\n").arg(INDENT, instance.moduleName, instance.name);
+    }
+
+    for (const QString& warning : netlist.warnings()) {
+        bindings += QString("%1// Warning: %2\n").arg(INDENT, warning);
+    }
+    for (const Netlist::Instance& instance : instances) {
+        if (!bindings.isEmpty()) {
+            bindings += "\n";
+        }
+        for (const QList<Port>* ports : {&instance.inputs, &instance.outputs}) {
+            for (const Port& port : *ports) {
+                const QString pinName = instance.name + "." + port.name;
+                bindings += QString("%1%2(%3);\n").arg(INDENT, pinName, netOfPin.value(pinName));
+            }
+        }
+    }
+
+    QHash<QString, QString> sections;
+    sections.insert("includes", includes);
+    sections.insert("clocks", clocks);
+    sections.insert("signals", signalDecls);
+    sections.insert("instances", declarations);
+    sections.insert("bindings", bindings);
+    return sections;
+}
+
+TestbenchExporter::Result TestbenchExporter::exportNetlist(const Netlist& netlist)
+{
+    Result result;
+    result.warnings = netlist.warnings();
+    if (m_workingDirectory.isEmpty()) {
+        result.errorString = "No project is open";
+        return result;
+    }
+    result.filePath = QDir(m_workingDirectory).filePath(FILE_NAME);
+
+    const QHash<QString, QString> sections = renderSections(netlist);
+
+    QString content;
+    QFile existing(result.filePath);
+    const bool exists = existing.exists();
+    if (exists) {
+        if (!existing.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            result.errorString = existing.errorString();
+            return result;
+        }
+        content = QString::fromUtf8(existing.readAll());
+        existing.close();
+
+        for (const QString& name : sectionNames()) {
+            bool changed = false;
+            if (!replaceSection(&content, name, sections.value(name), &changed)) {
+                // Markers were edited away; start over but keep the old file
+                qWarning() << "⚠️" << FILE_NAME << "lost its" << name << "section, regenerating it in full";
+                QFile::remove(result.filePath + ".bak");
+                QFile::copy(result.filePath, result.filePath + ".bak");
+                content = skeleton(sections);
+                result.changedSections = sectionNames();
+                break;
+            }
+            if (changed) {
+                result.changedSections.append(name);
+            }
+        }
+    } else {
+        content = skeleton(sections);
+        result.changedSections = sectionNames();
+    }
+
+    if (result.changedSections.isEmpty()) {
+        qDebug() << "🧪 Testbench up to date:" << result.filePath;
+        result.ok = true;
+        return result;
+    }
+
+    QSaveFile file(result.filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)
+        || file.write(content.toUtf8()) < 0 || !file.commit()) {
+        result.errorString = file.errorString();
+        return result;
+    }
+
+    qDebug() << "🧪 Testbench exported:" << result.filePath << "| Sections:" << result.changedSections;
+    result.ok = true;
+    return result;
+}
+
+QString TestbenchExporter::skeleton(const QHash<QString, QString>& sections)
+{
+    QString text;
+    auto section = [&text, &sections](const QString& name, const QString& indent) {
+        text += indent + beginMarker(name) + "\n";
+        text += sections.value(name);
+        text += indent + endMarker(name) + "\n";
+    };
+
+    text += QString("// %1\n").arg(FILE_NAME);
+    text += "// Testbench top level exported from the schematic. The SCV BEGIN/END\n";
+    text += "// sections are regenerated on every export; code outside them is kept.\n\n";
+    section("includes", QString());
+    text += "\nint sc_main(int, char*[])\n{\n";
+    for (const QString& name : {QString("clocks"), QString("signals"), QString("instances"), QString("bindings")}) {
+        section(name, INDENT);
+        text += "\n";
+    }
+    text += QString("%1sc_start(1, SC_US);\n").arg(INDENT);
+    text += QString("%1return 0;\n").arg(INDENT);
+    text += "}\n";
+    return text;
+}
+
+bool TestbenchExporter::replaceSection(QString* text, const QString& name, const QString& body, bool* changed)
+{
+    const QRegularExpression begin("^[ \\t]*" + QRegularExpression::escape(beginMarker(name)) + "[ \\t]*$",
+                                   QRegularExpression::MultilineOption);
+    const QRegularExpression end("^[ \\t]*" + QRegularExpression::escape(endMarker(name)) + "[ \\t]*$",
+                                 QRegularExpression::MultilineOption);
+
+    const QRegularExpressionMatch beginMatch = begin.match(*text);
+    if (!beginMatch.hasMatch()) {
+        return false;
+    }
+    const int bodyStart = beginMatch.capturedEnd() + 1;  // Past the marker's newline
+    const QRegularExpressionMatch endMatch = end.match(*text, qMin(bodyStart, int(text->size())));
+    if (!endMatch.hasMatch()) {
+        return false;
+    }
+    const int bodyEnd = endMatch.capturedStart();
+
+    *changed = QStringView(*text).mid(bodyStart, bodyEnd - bodyStart) != body;
+    if (*changed) {
+        text->replace(bodyStart, bodyEnd - bodyStart, body);
+    }
+    return true;
+}
@@ -0,0 +1,598 @@
+// TopSvModel.cpp
+#include "persistence/TopSvModel.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QDebug>
+
+namespace {
+
+// Words that can start a module item but never a module instantiation;
+// gate primitives are included since "and g1(y, a, b);" looks like one
+const QSet<QString>& keywords()
+{
+    static const QSet<QString> words = {
+        "assign", "always", "always_comb", "always_ff", "always_latch", "initial", "final",
+        "wire", "logic", "reg", "bit", "byte", "int", "integer", "shortint", "longint", "real",
+        "time", "tri", "wand", "wor", "supply0", "supply1", "var", "const", "signed", "unsigned",
+        "input", "output", "inout", "ref", "parameter", "localparam", "defparam", "genvar",
+        "generate", "endgenerate", "if", "else", "for", "foreach", "case", "casez", "casex",
+        "begin", "end", "function", "endfunction", "task", "endtask", "typedef", "struct",
+        "union", "enum", "import", "export", "assert", "assume", "cover", "property",
+        "sequence", "covergroup", "bind", "modport", "interface", "class", "package",
+        "program", "specify", "endspecify", "default", "return", "automatic", "static",
+        "module", "endmodule", "and", "or", "nand", "nor", "xor", "xnor", "not", "buf",
+        "bufif0", "bufif1", "notif0", "notif1"
+    };
+    return words;
+}
+
+bool isIdentifierStart(QChar c)
+{
+    return c.isLetter() || c == QLatin1Char('_');
+}
+
+bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('$');
+}
+
+} // namespace
+
+TopSvModel::TopSvModel(const QString& filePath, const QString& moduleName)
+    : m_filePath(filePath)
+    , m_moduleName(moduleName)
+{
+}
+
+bool TopSvModel::load(QString* error)
+{
+    m_loaded = false;
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    m_text = QString::fromUtf8(file.readAll());
+    file.close();
+
+    const QFileInfo info(m_filePath);
+    m_lastModified = info.lastModified();
+    m_size = info.size();
+
+    m_loaded = parse(error);
+    return m_loaded;
+}
+
+const TopSvModel::Instance* TopSvModel::instance(const QString& name) const
+{
+    auto it = m_instanceIndex.constFind(name);
+    return it == m_instanceIndex.constEnd() ? nullptr : &m_instances.at(it.value());
+}
+
+QStringList TopSvModel::instanceNames() const
+{
+    QStringList names;
+    names.reserve(m_instances.size());
+    for (const Instance& instance : m_instances) {
+        names.append(instance.name);
+    }
+    return names;
+}
+
+void TopSvModel::addInstance(const QString& module, const QString& name, const QVector<Connection>& connections)
+{
+    Edit edit{Edit::Add, Instance()};
+    edit.instance.module = module;
+    edit.instance.name = name;
+    edit.instance.connections = connections;
+    edit.instance.wildcard = connections.isEmpty();
+    m_edits.append(edit);
+}
+
+void TopSvModel::setConnections(const QString& name, const QVector<Connection>& connections)
+{
+    Edit edit{Edit::Connect, Instance()};
+    edit.instance.name = name;
+    edit.instance.connections = connections;
+    edit.instance.wildcard = connections.isEmpty();
+    m_edits.append(edit);
+}
+
+void TopSvModel::removeInstance(const QString& name)
+{
+    Edit edit{Edit::Remove, Instance()};
+    edit.instance.name = name;
+    m_edits.append(edit);
+}
+
+bool TopSvModel::flush(QString* error)
+{
+    if (m_edits.isEmpty()) {
+        return true;
+    }
+    if (!m_loaded || changedOnDisk()) {
+        if (!load(error)) {
+            return false;
+        }
+    }
+
+    const int editCount = m_edits.size();
+    for (const Edit& edit : m_edits) {
+        applyEdit(edit);
+    }
+    m_edits.clear();
+
+    QString text = m_text;
+    const QString region = renderRegion();
+    if (m_regionStart >= 0) {
+        text.replace(m_regionStart, m_regionEnd - m_regionStart, region);
+    } else if (!region.isEmpty()) {
+        QString block = m_indent + REGION_BEGIN + "\n" + region + m_indent + REGION_END + "\n";
+        if (m_insertNewline) {
+            block.prepend("\n");
+        }
+        text.insert(m_insertAt, block);
+    }
+
+    if (text == m_text) {
+        qDebug() << "📄 top.sv up to date after" << editCount << "edits";
+        return true;
+    }
+
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)
+        || file.write(text.toUtf8()) < 0 || !file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        m_loaded = false;  // The model is ahead of the file; parse it again next time
+        return false;
+    }
+
+    // Offsets moved; re-derive them from the text just written
+    m_text = text;
+    const QFileInfo info(m_filePath);
+    m_lastModified = info.lastModified();
+    m_size = info.size();
+    m_loaded = parse(error);
+
+    qDebug() << "📄 top.sv updated with" << editCount << "edits," << m_instances.size() << "instances";
+    return m_loaded;
+}
+
+QVector<TopSvModel::Token> TopSvModel::tokenize(const QString& text)
+{
+    QVector<Token> tokens;
+    const int size = text.size();
+    int i = 0;
+    while (i < size) {
+        const QChar c = text.at(i);
+        const int start = i;
+
+        if (c.isSpace()) {
+            ++i;
+            continue;
+        }
+
+        TokenType type = TokenType::Symbol;
+        if (c == QLatin1Char('/') && i + 1 < size && text.at(i + 1) == QLatin1Char('/')) {
+            type = TokenType::Comment;
+            while (i < size && text.at(i) != QLatin1Char('\n')) {
+                ++i;
+            }
+        } else if (c == QLatin1Char('/') && i + 1 < size && text.at(i + 1) == QLatin1Char('*')) {
+            type = TokenType::Comment;
+            const int end = text.indexOf(QLatin1String("*/"), i + 2);
+            i = end < 0 ? size : end + 2;
+        } else if (c == QLatin1Char('"')) {
+            type = TokenType::String;
+            for (++i; i < size && text.at(i) != QLatin1Char('"') && text.at(i) != QLatin1Char('\n'); ++i) {
+                if (text.at(i) == QLatin1Char('\\')) {
+                    ++i;
+                }
+            }
+            i = qMin(i + 1, size);
+        } else if (c == QLatin1Char('`')) {
+            type = TokenType::Directive;
+            for (++i; i < size && isIdentifierChar(text.at(i)); ++i) {
+            }
+            // A macro body can hold anything, including "module" or "endmodule"
+            if (QStringView(text).mid(start + 1, i - start - 1) == QLatin1String("define")) {
+                while (i < size && text.at(i) != QLatin1Char('\n')) {
+                    if (text.at(i) == QLatin1Char('\\') && i + 1 < size && text.at(i + 1) == QLatin1Char('\n')) {
+                        ++i;
+                    }
+                    ++i;
+                }
+            }
+        } else if (c == QLatin1Char('\\')) {
+            type = TokenType::Identifier;  // Escaped identifier, up to white space
+            while (i < size && !text.at(i).isSpace()) {
+                ++i;
+            }
+        } else if (isIdentifierStart(c) || c == QLatin1Char('$')) {
+            type = TokenType::Identifier;
+            while (i < size && isIdentifierChar(text.at(i))) {
+                ++i;
+            }
+        } else if (c.isDigit() || (c == QLatin1Char('\'') && i + 1 < size && text.at(i + 1).isLetterOrNumber())) {
+            type = TokenType::Number;
+            for (++i; i < size && (isIdentifierChar(text.at(i)) || text.at(i) == QLatin1Char('\'')
+                                   || text.at(i) == QLatin1Char('?')); ++i) {
+            }
+        } else {
+            ++i;
+        }
+
+        tokens.append({type, start, i - start});
+    }
+    return tokens;
+}
+
+bool TopSvModel::parse(QString* error)
+{
+    m_tokens = tokenize(m_text);
+    m_instances.clear();
+    m_instanceIndex.clear();
+    m_regionStart = -1;
+    m_regionEnd = -1;
+    m_insertAt = -1;
+    m_insertNewline = false;
+    m_indent = "    ";
+
+    const int last = m_tokens.size();
+
+    // "module <name>" with its header up to the first ';' outside parentheses
+    int header = -1;
+    for (int i = 0; i < last; ++i) {
+        if (m_tokens.at(i).type == TokenType::Identifier && tokenText(i) == QLatin1String("module")) {
+            const int name = nextSignificant(i + 1, last);
+            if (name < last && tokenText(name) == m_moduleName) {
+                header = name;
+                break;
+            }
+        }
+    }
+    if (header < 0) {
+        if (error) {
+            *error = QString("No module %1 in %2").arg(m_moduleName, m_filePath);
+        }
+        return false;
+    }
+
+    int bodyStart = -1;
+    for (int i = header + 1; i < last; ++i) {
+        if (isSymbol(i, QLatin1Char('(')) || isSymbol(i, QLatin1Char('['))) {
+            i = matching(i, last);
+            if (i >= last) {
+                break;
+            }
+        } else if (isSymbol(i, QLatin1Char(';'))) {
+            bodyStart = i + 1;
+            break;
+        }
+    }
+    int endmodule = -1;
+    for (int i = qMax(bodyStart, 0); bodyStart >= 0 && i < last; ++i) {
+        if (m_tokens.at(i).type == TokenType::Identifier && tokenText(i) == QLatin1String("endmodule")) {
+            endmodule = i;
+            break;
+        }
+    }
+    if (bodyStart < 0 || endmodule < 0) {
+        if (error) {
+            *error = QString("Module %1 in %2 is not terminated").arg(m_moduleName, m_filePath);
+        }
+        return false;
+    }
+
+    // Managed region markers, only inside the module body
+    int beginMarker = -1;
+    int endMarker = -1;
+    for (int i = bodyStart; i < endmodule; ++i) {
+        if (m_tokens.at(i).type != TokenType::Comment) {
+            continue;
+        }
+        const QStringView comment = tokenText(i).trimmed();
+        if (comment == QLatin1String(REGION_BEGIN) && beginMarker < 0) {
+            beginMarker = i;
+        } else if (comment == QLatin1String(REGION_END) && beginMarker >= 0) {
+            endMarker = i;
+            break;
+        }
+    }
+
+    // Indentation of the module items, for a region that does not exist yet
+    const int firstItem = nextSignificant(bodyStart, endmodule);
+    const Token& indentReference = m_tokens.at(beginMarker >= 0 ? beginMarker : (firstItem < endmodule ? firstItem : endmodule));
+    const int referenceLine = lineStart(indentReference.start);
+    const QString leading = m_text.mid(referenceLine, indentReference.start - referenceLine);
+    if (!leading.isEmpty() && leading.trimmed().isEmpty() && indentReference.start != m_tokens.at(endmodule).start) {
+        m_indent = leading;
+    }
+
+    if (beginMarker >= 0 && endMarker >= 0) {
+        m_regionStart = qMin(lineEnd(m_tokens.at(beginMarker).start) + 1, int(m_text.size()));
+        m_regionEnd = lineStart(m_tokens.at(endMarker).start);
+        if (m_regionEnd < m_regionStart) {
+            m_regionStart = -1;  // Both markers on one line; treat as absent
+            m_regionEnd = -1;
+        }
+    }
+
+    const int endmoduleStart = m_tokens.at(endmodule).start;
+    const int endmoduleLine = lineStart(endmoduleStart);
+    m_insertNewline = !QStringView(m_text).mid(endmoduleLine, endmoduleStart - endmoduleLine).trimmed().isEmpty();
+    m_insertAt = m_insertNewline ? endmoduleStart : endmoduleLine;
+
+    parseBody(bodyStart, endmodule);
+    return true;
+}
+
+void TopSvModel::parseBody(int first, int last)
+{
+    // Instances can only start a module item: after ';', begin/end or a block label
+    bool itemStart = true;
+    for (int i = nextSignificant(first, last); i < last; i = nextSignificant(i + 1, last)) {
+        const Token& token = m_tokens.at(i);
+
+        if (itemStart && token.type == TokenType::Identifier && !keywords().contains(tokenText(i).toString())) {
+            Instance instance;
+            const int end = parseInstance(i, last, &instance);
+            if (end >= 0) {
+                instance.managed = m_regionStart >= 0 && token.start >= m_regionStart && token.start < m_regionEnd;
+                if (!m_instanceIndex.contains(instance.name)) {
+                    m_instanceIndex.insert(instance.name, m_instances.size());
+                    m_instances.append(instance);
+                }
+                i = end;
+                itemStart = true;
+                continue;
+            }
+        }
+
+        if (isSymbol(i, QLatin1Char('(')) || isSymbol(i, QLatin1Char('[')) || isSymbol(i, QLatin1Char('{'))) {
+            i = qMin(matching(i, last), last - 1);
+            itemStart = false;
+            continue;
+        }
+
+        const QStringView text = tokenText(i);
+        if (isSymbol(i, QLatin1Char(';'))) {
+            itemStart = true;
+        } else if (token.type == TokenType::Identifier
+                   && (text == QLatin1String("begin") || text == QLatin1String("end")
+                       || text == QLatin1String("generate") || text == QLatin1String("endgenerate")
+                       || text == QLatin1String("else"))) {
+            itemStart = true;
+            // "begin : label"
+            const int colon = nextSignificant(i + 1, last);
+            if (colon < last && isSymbol(colon, QLatin1Char(':'))) {
+                i = nextSignificant(colon + 1, last);
+            }
+        } else {
+            itemStart = false;
+        }
+    }
+}
+
+int TopSvModel::parseInstance(int index, int last, Instance* instance) const
+{
+    // module [#(params)] name [range] (connections) ;
+    int i = nextSignificant(index + 1, last);
+    if (i < last && isSymbol(i, QLatin1Char('#'))) {
+        i = nextSignificant(i + 1, last);
+        if (i >= last || !isSymbol(i, QLatin1Char('('))) {
+            return -1;
+        }
+        i = nextSignificant(matching(i, last) + 1, last);
+    }
+    if (i >= last || m_tokens.at(i).type != TokenType::Identifier || keywords().contains(tokenText(i).toString())) {
+        return -1;
+    }
+    const int name = i;
+    i = nextSignificant(i + 1, last);
+    if (i < last && isSymbol(i, QLatin1Char('['))) {
+        i = nextSignificant(matching(i, last) + 1, last);
+    }
+    if (i >= last || !isSymbol(i, QLatin1Char('('))) {
+        return -1;
+    }
+    const int open = i;
+    const int close = matching(open, last);
+    const int semicolon = nextSignificant(close + 1, last);
+    if (close >= last || semicolon >= last || !isSymbol(semicolon, QLatin1Char(';'))) {
+        return -1;
+    }
+
+    instance->module = tokenText(index).toString();
+    instance->name = tokenText(name).toString();
+    parseConnections(open, close, instance);
+    return semicolon;
+}
+
+void TopSvModel::parseConnections(int open, int close, Instance* instance) const
+{
+    // Split at commas outside nested brackets
+    QVector<QPair<int, int>> items;
+    int itemStart = open + 1;
+    int depth = 0;
+    for (int i = open + 1; i < close; ++i) {
+        if (m_tokens.at(i).type != TokenType::Symbol) {
+            continue;
+        }
+        const QChar c = m_text.at(m_tokens.at(i).start);
+        if (c == QLatin1Char('(') || c == QLatin1Char('[') || c == QLatin1Char('{')) {
+            ++depth;
+        } else if (c == QLatin1Char(')') || c == QLatin1Char(']') || c == QLatin1Char('}')) {
+            --depth;
+        } else if (c == QLatin1Char(',') && depth == 0) {
+            items.append({itemStart, i});
+            itemStart = i + 1;
+        }
+    }
+    items.append({itemStart, close});
+
+    for (const auto& item : items) {
+        const int first = nextSignificant(item.first, item.second);
+        if (first >= item.second) {
+            continue;
+        }
+        if (!isSymbol(first, QLatin1Char('.'))) {
+            instance->connections.append({QString(), textBetween(first, item.second - 1)});
+            continue;
+        }
+        const int port = nextSignificant(first + 1, item.second);
+        if (port < item.second && isSymbol(port, QLatin1Char('*'))) {
+            instance->wildcard = true;
+            continue;
+        }
+        if (port >= item.second) {
+            continue;
+        }
+        Connection connection;
+        connection.port = tokenText(port).toString();
+        const int paren = nextSignificant(port + 1, item.second);
+        if (paren < item.second && isSymbol(paren, QLatin1Char('('))) {
+            const int end = matching(paren, item.second + 1);
+            connection.signal = end - 1 > paren ? textBetween(paren + 1, end - 1) : QString();
+        } else {
+            connection.signal = connection.port;  // ".name" shorthand
+        }
+        instance->connections.append(connection);
+    }
+}
+
+int TopSvModel::nextSignificant(int index, int last) const
+{
+    while (index < last && (m_tokens.at(index).type == TokenType::Comment
+                            || m_tokens.at(index).type == TokenType::Directive)) {
+        ++index;
+    }
+    return index;
+}
+
+int TopSvModel::matching(int open, int last) const
+{
+    const QChar opening = m_text.at(m_tokens.at(open).start);
+    const QChar closing = opening == QLatin1Char('(') ? QLatin1Char(')')
+                        : opening == QLatin1Char('[') ? QLatin1Char(']') : QLatin1Char('}');
+    int depth = 0;
+    for (int i = open; i < last; ++i) {
+        if (isSymbol(i, opening)) {
+            ++depth;
+        } else if (isSymbol(i, closing) && --depth == 0) {
+            return i;
+        }
+    }
+    return last;
+}
+
+bool TopSvModel::isSymbol(int index, QChar symbol) const
+{
+    const Token& token = m_tokens.at(index);
+    return token.type == TokenType::Symbol && m_text.at(token.start) == symbol;
+}
+
+QStringView TopSvModel::tokenText(int index) const
+{
+    const Token& token = m_tokens.at(index);
+    return QStringView(m_text).mid(token.start, token.length);
+}
+
+QString TopSvModel::textBetween(int first, int last) const
+{
+    const int start = m_tokens.at(first).start;
+    const int end = m_tokens.at(last).start + m_tokens.at(last).length;
+    return m_text.mid(start, end - start).simplified();
+}
+
+int TopSvModel::lineStart(int offset) const
+{
+    return offset > 0 ? m_text.lastIndexOf(QLatin1Char('\n'), offset - 1) + 1 : 0;
+}
+
+int TopSvModel::lineEnd(int offset) const
+{
+    const int end = m_text.indexOf(QLatin1Char('\n'), offset);
+    return end < 0 ? m_text.size() : end;
+}
+
+void TopSvModel::applyEdit(const Edit& edit)
+{
+    auto it = m_instanceIndex.constFind(edit.instance.name);
+    const bool exists = it != m_instanceIndex.constEnd();
+
+    switch (edit.kind) {
+        case Edit::Add:
+            if (exists) {
+                qDebug() << "Instance" << edit.instance.name << "already in top.sv";
+                return;
+            }
+            m_instanceIndex.insert(edit.instance.name, m_instances.size());
+            m_instances.append(edit.instance);
+            m_instances.last().managed = true;
+            return;
+
+        case Edit::Connect:
+            if (!exists || !m_instances.at(it.value()).managed) {
+                qWarning() << "⚠️ top.sv: not rebinding" << edit.instance.name << "- it is not in the managed region";
+                return;
+            }
+            m_instances[it.value()].connections = edit.instance.connections;
+            m_instances[it.value()].wildcard = edit.instance.wildcard;
+            return;
+
+        case Edit::Remove:
+            if (!exists || !m_instances.at(it.value()).managed) {
+                return;
+            }
+            m_instances.remove(it.value());
+            m_instanceIndex.clear();
+            for (int i = 0; i < m_instances.size(); ++i) {
+                m_instanceIndex.insert(m_instances.at(i).name, i);
+            }
+            return;
+    }
+}
+
+QString TopSvModel::renderRegion() const
+{
+    QString region;
+    for (const Instance& instance : m_instances) {
+        if (instance.managed) {
+            region += renderInstance(instance);
+        }
+    }
+    return region;
+}
+
+QString TopSvModel::renderInstance(const Instance& instance) const
+{
+    if (instance.connections.isEmpty()) {
+        return QString("%1%2 %3 (%4);\n").arg(m_indent, instance.module, instance.name,
+                                              instance.wildcard ? QString(".*") : QString());
+    }
+
+    QStringList items;
+    for (const Connection& connection : instance.connections) {
+        items.append(connection.port.isEmpty() ? connection.signal
+                                               : QString(".%1(%2)").arg(connection.port, connection.signal));
+    }
+    if (instance.wildcard) {
+        items.append(".*");
+    }
+    const QString itemIndent = m_indent + m_indent;
+    return QString("%1%2 %3 (\n%4%5\n%1);\n")
+        .arg(m_indent, instance.module, instance.name, itemIndent, items.join(",\n" + itemIndent));
+}
+
+bool TopSvModel::changedOnDisk() const
+{
+    const QFileInfo info(m_filePath);
+    return info.lastModified() != m_lastModified || info.size() != m_size;
+}
@@ -0,0 +1,494 @@
+// AutoPlacement.cpp
+#include "scene/AutoPlacement.h"
+#include "scene/SchematicScene.h"
+#include "commands/SchematicCommands.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/SchematicItemTypes.h"
+#include "graphics/wire/WireGraphicsItem.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QHash>
+#include <QPoint>
+#include <QRectF>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr int BARYCENTER_SWEEPS = 8;
+
+qreal snap(qreal value)
+{
+    return std::round(value / AutoPlacement::GRID) * AutoPlacement::GRID;
+}
+
+// Placed rectangles bucketed by cell, so overlap checks only look nearby
+class OccupancyGrid
+{
+public:
+    void insert(const QRectF& rect)
+    {
+        const int index = m_rects.size();
+        m_rects.append(rect);
+        forCells(rect, [&](const QPoint& cell) { m_cells[cell].append(index); });
+    }
+
+    const QRectF* overlapping(const QRectF& rect) const
+    {
+        const QRectF* found = nullptr;
+        forCells(rect, [&](const QPoint& cell) {
+            if (found) {
+                return;
+            }
+            for (int index : m_cells.value(cell)) {
+                if (m_rects.at(index).intersects(rect)) {
+                    found = &m_rects.at(index);
+                    return;
+                }
+            }
+        });
+        return found;
+    }
+
+private:
+    static constexpr qreal CELL = 200.0;
+
+    QVector<QRectF> m_rects;
+    QHash<QPoint, QVector<int>> m_cells;
+
+    template <typename Visit>
+    static void forCells(const QRectF& rect, Visit visit)
+    {
+        const int left = int(std::floor(rect.left() / CELL));
+        const int right = int(std::floor(rect.right() / CELL));
+        const int top = int(std::floor(rect.top() / CELL));
+        const int bottom = int(std::floor(rect.bottom() / CELL));
+        for (int x = left; x <= right; ++x) {
+            for (int y = top; y <= bottom; ++y) {
+                visit(QPoint(x, y));
+            }
+        }
+    }
+};
+
+// @p position if a node of @p size is clear of everything there, otherwise the first clear grid spot below it
+QPointF freeSpot(const OccupancyGrid& occupied, QPointF position, const QSizeF& size)
+{
+    const qreal margin = AutoPlacement::GRID;
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        const QRectF* blocker = occupied.overlapping(QRectF(position, size).adjusted(-margin, -margin, margin, margin));
+        if (!blocker) {
+            break;
+        }
+        position = QPointF(snap(position.x()), std::ceil((blocker->bottom() + margin) / AutoPlacement::GRID) * AutoPlacement::GRID);
+    }
+    return position;
+}
+
+using Adjacency = QVector<QVector<int>>;
+
+// Reverse the edges closing a cycle (depth-first back edges) so the graph can be layered
+void breakCycles(int count, const Adjacency& successors, Adjacency& dagSuccessors, Adjacency& dagPredecessors)
+{
+    enum { Unvisited, Open, Done };
+    QVector<int> state(count, Unvisited);
+    dagSuccessors = Adjacency(count);
+    dagPredecessors = Adjacency(count);
+
+    for (int root = 0; root < count; ++root) {
+        if (state.at(root) != Unvisited) {
+            continue;
+        }
+        QVector<QPair<int, int>> stack{{root, 0}};   // Node and its next successor to visit
+        state[root] = Open;
+        while (!stack.isEmpty()) {
+            const int node = stack.last().first;
+            if (stack.last().second >= successors.at(node).size()) {
+                state[node] = Done;
+                stack.removeLast();
+                continue;
+            }
+            const int target = successors.at(node).at(stack.last().second++);
+            if (state.at(target) == Open) {
+                dagSuccessors[target].append(node);
+                dagPredecessors[node].append(target);
+                continue;
+            }
+            dagSuccessors[node].append(target);
+            dagPredecessors[target].append(node);
+            if (state.at(target) == Unvisited) {
+                state[target] = Open;
+                stack.append({target, 0});
+            }
+        }
+    }
+}
+
+void layoutLayers(const AutoPlacement::Graph& graph, const Adjacency& successors, const Adjacency& predecessors,
+                  QVector<QPointF>& positions)
+{
+    const int count = graph.nodes.size();
+    Adjacency dagSuccessors;
+    Adjacency dagPredecessors;
+    breakCycles(count, successors, dagSuccessors, dagPredecessors);
+
+    // Longest path from the sources: every node one layer right of its furthest driver
+    QVector<int> layerOf(count, 0);
+    QVector<int> remaining(count);
+    QVector<int> ready;
+    for (int node = 0; node < count; ++node) {
+        remaining[node] = dagPredecessors.at(node).size();
+        if (remaining.at(node) == 0) {
+            ready.append(node);
+        }
+    }
+    for (int i = 0; i < ready.size(); ++i) {
+        const int node = ready.at(i);
+        for (int target : dagSuccessors.at(node)) {
+            layerOf[target] = qMax(layerOf.at(target), layerOf.at(node) + 1);
+            if (--remaining[target] == 0) {
+                ready.append(target);
+            }
+        }
+    }
+
+    // Unconnected nodes are packed in rows under the layers instead of piling up in the first one
+    QRectF origin;
+    QVector<QVector<int>> layers;
+    QVector<int> isolated;
+    for (int node = 0; node < count; ++node) {
+        origin |= QRectF(graph.nodes.at(node).position, graph.nodes.at(node).size);
+        if (successors.at(node).isEmpty() && predecessors.at(node).isEmpty()) {
+            isolated.append(node);
+            continue;
+        }
+        if (layers.size() <= layerOf.at(node)) {
+            layers.resize(layerOf.at(node) + 1);
+        }
+        layers[layerOf.at(node)].append(node);
+    }
+
+    // Start from the current vertical order, then sweep barycenters both ways to cut crossings
+    auto byCurrentY = [&graph](int a, int b) {
+        return graph.nodes.at(a).position.y() < graph.nodes.at(b).position.y();
+    };
+    QVector<qreal> order(count, 0.0);
+    auto updateOrder = [&order](const QVector<int>& layer) {
+        for (int i = 0; i < layer.size(); ++i) {
+            order[layer.at(i)] = (i + 0.5) / layer.size();
+        }
+    };
+    for (QVector<int>& layer : layers) {
+        std::stable_sort(layer.begin(), layer.end(), byCurrentY);
+        updateOrder(layer);
+    }
+    for (int sweep = 0; sweep < BARYCENTER_SWEEPS; ++sweep) {
+        const bool down = sweep % 2 == 0;
+        for (int step = 1; step < layers.size(); ++step) {
+            QVector<int>& layer = layers[down ? step : layers.size() - 1 - step];
+            QHash<int, qreal> barycenter;
+            for (int node : layer) {
+                const QVector<int>& neighbours = down ? dagPredecessors.at(node) : dagSuccessors.at(node);
+                qreal sum = 0.0;
+                for (int neighbour : neighbours) {
+                    sum += order.at(neighbour);
+                }
+                barycenter.insert(node, neighbours.isEmpty() ? order.at(node) : sum / neighbours.size());
+            }
+            std::stable_sort(layer.begin(), layer.end(), [&barycenter](int a, int b) {
+                return barycenter.value(a) < barycenter.value(b);
+            });
+            updateOrder(layer);
+        }
+    }
+
+    // Columns as wide as their widest node, each centred on the tallest column
+    QVector<qreal> heights(layers.size(), 0.0);
+    QVector<qreal> widths(layers.size(), 0.0);
+    qreal tallest = 0.0;
+    for (int l = 0; l < layers.size(); ++l) {
+        for (int node : layers.at(l)) {
+            heights[l] += graph.nodes.at(node).size.height() + AutoPlacement::NODE_SPACING;
+            widths[l] = qMax(widths.at(l), graph.nodes.at(node).size.width());
+        }
+        tallest = qMax(tallest, heights.at(l));
+    }
+
+    const qreal left = snap(origin.left());
+    const qreal top = snap(origin.top());
+    qreal x = left;
+    for (int l = 0; l < layers.size(); ++l) {
+        qreal y = top + (tallest - heights.at(l)) / 2;
+        for (int node : layers.at(l)) {
+            positions[node] = QPointF(snap(x), snap(y));
+            y = positions.at(node).y() + graph.nodes.at(node).size.height() + AutoPlacement::NODE_SPACING;
+        }
+        if (!layers.at(l).isEmpty()) {
+            x += widths.at(l) + AutoPlacement::LAYER_SPACING;
+        }
+    }
+
+    std::stable_sort(isolated.begin(), isolated.end(), byCurrentY);
+    const qreal rowLimit = qMax(x - left, 1200.0);
+    qreal rowX = left;
+    qreal rowY = layers.isEmpty() ? top : top + tallest + AutoPlacement::LAYER_SPACING;
+    qreal rowHeight = 0.0;
+    for (int node : isolated) {
+        const QSizeF size = graph.nodes.at(node).size;
+        if (rowX > left && rowX + size.width() > left + rowLimit) {
+            rowX = left;
+            rowY += rowHeight + AutoPlacement::NODE_SPACING;
+            rowHeight = 0.0;
+        }
+        positions[node] = QPointF(snap(rowX), snap(rowY));
+        rowX = positions.at(node).x() + size.width() + AutoPlacement::NODE_SPACING;
+        rowHeight = qMax(rowHeight, size.height());
+    }
+}
+
+void placeIncrementally(const AutoPlacement::Graph& graph, const Adjacency& successors, const Adjacency& predecessors,
+                        QVector<QPointF>& positions)
+{
+    const int count = graph.nodes.size();
+    OccupancyGrid occupied;
+    QVector<bool> placed(count, false);
+    QVector<int> pending;
+    for (int node = 0; node < count; ++node) {
+        if (graph.nodes.at(node).movable) {
+            pending.append(node);
+        } else {
+            placed[node] = true;
+            occupied.insert(QRectF(positions.at(node), graph.nodes.at(node).size));
+        }
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&graph](int a, int b) {
+        return graph.nodes.at(a).position.y() < graph.nodes.at(b).position.y();
+    });
+
+    auto placedAmong = [&placed](const QVector<int>& nodes) {
+        QVector<int> result;
+        for (int node : nodes) {
+            if (placed.at(node)) {
+                result.append(node);
+            }
+        }
+        return result;
+    };
+    auto meanCenterY = [&](const QVector<int>& nodes) {
+        qreal sum = 0.0;
+        for (int node : nodes) {
+            sum += positions.at(node).y() + graph.nodes.at(node).size.height() / 2;
+        }
+        return sum / nodes.size();
+    };
+
+    while (!pending.isEmpty()) {
+        // Nodes wired to placed ones first, so chains of new nodes grow out of the placed design
+        int pick = 0;
+        for (int i = 0; i < pending.size(); ++i) {
+            if (!placedAmong(predecessors.at(pending.at(i))).isEmpty() || !placedAmong(successors.at(pending.at(i))).isEmpty()) {
+                pick = i;
+                break;
+            }
+        }
+        const int node = pending.takeAt(pick);
+        const QSizeF size = graph.nodes.at(node).size;
+
+        // Right of what drives it, or else left of what it drives; unconnected nodes stay put
+        QPointF position = positions.at(node);
+        const QVector<int> drivers = placedAmong(predecessors.at(node));
+        const QVector<int> driven = placedAmong(successors.at(node));
+        if (!drivers.isEmpty()) {
+            qreal right = positions.at(drivers.first()).x();
+            for (int driver : drivers) {
+                right = qMax(right, positions.at(driver).x() + graph.nodes.at(driver).size.width());
+            }
+            position = QPointF(snap(right + AutoPlacement::LAYER_SPACING), snap(meanCenterY(drivers) - size.height() / 2));
+        } else if (!driven.isEmpty()) {
+            qreal left = positions.at(driven.first()).x();
+            for (int target : driven) {
+                left = qMin(left, positions.at(target).x());
+            }
+            position = QPointF(snap(left - AutoPlacement::LAYER_SPACING - size.width()), snap(meanCenterY(driven) - size.height() / 2));
+        }
+
+        positions[node] = freeSpot(occupied, position, size);
+        occupied.insert(QRectF(positions.at(node), size));
+        placed[node] = true;
+    }
+}
+
+} // namespace
+
+AutoPlacement::AutoPlacement(SchematicScene* scene)
+    : QObject(scene)
+    , m_scene(scene)
+{
+    connect(&m_watcher, &QFutureWatcher<QVector<QPointF>>::finished, this, &AutoPlacement::apply);
+}
+
+void AutoPlacement::placeAll()
+{
+    m_pendingAll = true;
+    start();
+}
+
+void AutoPlacement::placeNew(const QList<QGraphicsItem*>& items, bool undoable)
+{
+    for (QGraphicsItem* item : items) {
+        ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item);
+        if (!component) {
+            continue;
+        }
+        PendingItem& pending = m_pendingNew[component];
+        // A stale entry at a reused address belonged to a deleted item
+        pending.undoable = (pending.guard == component && pending.undoable) || undoable;
+        pending.guard = component;
+    }
+    start();
+}
+
+void AutoPlacement::placeOverlapping(const QList<QGraphicsItem*>& items, bool undoable)
+{
+    QList<QGraphicsItem*> overlapping;
+    for (QGraphicsItem* item : items) {
+        for (QGraphicsItem* other : m_scene->items(item->sceneBoundingRect())) {
+            if (other != item && !other->parentItem() && SchematicItemType::isComponent(other->type())) {
+                overlapping.append(item);
+                break;
+            }
+        }
+    }
+    if (!overlapping.isEmpty()) {
+        qDebug() << "📐" << overlapping.size() << "item(s) overlap others and will be placed";
+        placeNew(overlapping, undoable);
+    }
+}
+
+QVector<QPointF> AutoPlacement::layout(const Graph& graph, Mode mode)
+{
+    const int count = graph.nodes.size();
+    QVector<QPointF> positions(count);
+    for (int node = 0; node < count; ++node) {
+        positions[node] = graph.nodes.at(node).position;
+    }
+
+    Adjacency successors(count);
+    Adjacency predecessors(count);
+    for (const QPair<int, int>& edge : graph.edges) {
+        if (edge.first != edge.second && edge.first >= 0 && edge.second >= 0 && edge.first < count && edge.second < count) {
+            successors[edge.first].append(edge.second);
+            predecessors[edge.second].append(edge.first);
+        }
+    }
+
+    if (mode == Mode::All) {
+        layoutLayers(graph, successors, predecessors, positions);
+    } else {
+        placeIncrementally(graph, successors, predecessors, positions);
+    }
+    return positions;
+}
+
+void AutoPlacement::start()
+{
+    if (isRunning() || (!m_pendingAll && m_pendingNew.isEmpty())) {
+        return;
+    }
+    const bool all = std::exchange(m_pendingAll, false);
+    const QHash<ReadyComponentGraphicsItem*, PendingItem> newItems = std::exchange(m_pendingNew, {});
+
+    // Snapshot of the top-level components and blocks and the wires between them
+    m_graph = Graph();
+    m_items.clear();
+    m_offsets.clear();
+    m_undoable.clear();
+    QHash<QGraphicsItem*, int> indexOf;
+    bool anyMovable = false;
+    auto addNode = [&](ReadyComponentGraphicsItem* item) {
+        const QRectF bounds = item->sceneBoundingRect();
+        const auto pending = newItems.constFind(item);
+        const bool requested = pending != newItems.cend() && pending->guard == item;
+        const bool movable = all || requested;
+        anyMovable = anyMovable || movable;
+        indexOf.insert(item, m_items.size());
+        m_items.append(item);
+        m_offsets.append(item->pos() - bounds.topLeft());
+        m_undoable.append(all || (requested && pending->undoable));
+        m_graph.nodes.append({bounds.size(), bounds.topLeft(), movable});
+    };
+    for (ReadyComponentGraphicsItem* component : m_scene->components()) {
+        if (!component->parentItem()) {
+            addNode(component);
+        }
+    }
+    for (BlockGraphicsItem* block : m_scene->blocks()) {
+        addNode(block);
+    }
+    if (!anyMovable) {
+        return;  // The new items are gone already
+    }
+
+    for (WireGraphicsItem* wire : m_scene->wires()) {
+        const int source = indexOf.value(wire->getSource(), -1);
+        const int target = indexOf.value(wire->getTarget(), -1);
+        if (source < 0 || target < 0 || source == target) {
+            continue;
+        }
+        // Signals flow from outputs to inputs, whichever end the wire was drawn from
+        bool sourceIsInput = false;
+        wire->getSource()->getPortAt(wire->getSourcePort(), sourceIsInput);
+        m_graph.edges.append(sourceIsInput ? qMakePair(target, source) : qMakePair(source, target));
+    }
+
+    qDebug() << "📐 Auto placement of" << (all ? m_items.size() : newItems.size()) << "item(s) started,"
+             << m_graph.edges.size() << "connection(s)";
+    const Graph graph = m_graph;
+    const Mode mode = all ? Mode::All : Mode::NewItems;
+    m_watcher.setFuture(QtConcurrent::run([graph, mode]() {
+        return layout(graph, mode);
+    }));
+}
+
+void AutoPlacement::apply()
+{
+    const QVector<QPointF> positions = m_watcher.result();
+
+    QList<QPair<QGraphicsItem*, QPointF>> moves;
+    int moved = 0;
+    {
+        SchematicScene::Transaction transaction(m_scene, tr("Auto Place"));
+        for (int node = 0; node < m_items.size() && node < positions.size(); ++node) {
+            // Deleted while the layout ran, taken out by an edit, or moved into a block
+            ReadyComponentGraphicsItem* item = m_items.at(node);
+            if (!m_graph.nodes.at(node).movable || !item || item->scene() != m_scene || item->parentItem()) {
+                continue;
+            }
+            const QPointF delta = positions.at(node) + m_offsets.at(node) - item->pos();
+            if (delta.manhattanLength() < 0.5) {
+                continue;
+            }
+            item->setPos(item->pos() + delta);
+            ++moved;
+            if (m_undoable.at(node)) {
+                moves.append({item, delta});
+            }
+        }
+        // One step for every item, which never merges with a drag
+        if (!moves.isEmpty()) {
+            m_scene->pushCommand(new MoveItemsCommand(moves));
+        }
+    }
+    qDebug() << "📐 Auto placement moved" << moved << "item(s)";
+
+    m_graph = Graph();
+    m_items.clear();
+    m_offsets.clear();
+    m_undoable.clear();
+    emit finished(moved);
+
+    // Requests made in the meantime
+    start();
+}
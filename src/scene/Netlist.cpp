@@ -0,0 +1,358 @@
+// Netlist.cpp
+#include "scene/Netlist.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "graphics/ModuleGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/wire/WireGraphicsItem.h"
+#include "parsers/ComponentPortParser.h"
+#include "parsers/PortType.h"
+#include "persistence/SystemCGenerator.h"
+#include "utils/PersistenceManager.h"
+#include "scene/SchematicScene.h"
+#include <QDir>
+#include <QHash>
+#include <QLineF>
+#include <QSet>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+QString identifier(const QString& text)
+{
+    QString result;
+    result.reserve(text.size());
+    for (const QChar c : text) {
+        result.append((c.isLetterOrNumber() && c.unicode() < 128) || c == QLatin1Char('_') ? c : QChar('_'));
+    }
+    if (result.isEmpty() || result.at(0).isDigit()) {
+        result.prepend("n_");
+    }
+    return result;
+}
+
+int findRoot(QVector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+void unite(QVector<int>& parent, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a != b) {
+        parent[qMax(a, b)] = qMin(a, b);  // Lowest pin is the root, so roots are stable
+    }
+}
+
+} // namespace
+
+bool Netlist::Pin::operator==(const Pin& other) const
+{
+    return instance == other.instance && direction == other.direction && port == other.port;
+}
+
+bool Netlist::Pin::operator<(const Pin& other) const
+{
+    if (instance != other.instance) {
+        return instance < other.instance;
+    }
+    if (direction != other.direction) {
+        return direction < other.direction;
+    }
+    return port < other.port;
+}
+
+Netlist Netlist::fromScene(SchematicScene* scene)
+{
+    Netlist netlist;
+    if (!scene) {
+        return netlist;
+    }
+
+    PersistenceManager& pm = PersistenceManager::instance();
+    pm.flushPendingWrites();  // Component ports are read from their .cpp files
+    const QString workingDirectory = pm.getWorkingDirectory();
+
+    // Blocks are flattened: their contents are instances of the netlist like any other
+    QVector<SchematicScene*> scenes{scene};
+    for (int i = 0; i < scenes.size(); ++i) {
+        for (BlockGraphicsItem* block : scenes.at(i)->blocks()) {
+            scenes.append(block->childScene());
+        }
+    }
+
+    QVector<QPair<QString, ReadyComponentGraphicsItem*>> components;
+    for (SchematicScene* level : scenes) {
+        for (ReadyComponentGraphicsItem* component : level->components()) {
+            if (component->parentItem()) {
+                continue;
+            }
+
+            ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(component);
+            QString id = module ? pm.getRTLModuleName(module) : pm.getComponentId(component);
+            if (id.isEmpty() && module) {
+                id = module->getModuleInfo().name;
+            }
+            if (id.isEmpty()) {
+                netlist.m_warnings.append(QString("%1 has no component ID and was left out").arg(component->getName()));
+                continue;
+            }
+            components.append({id, component});
+        }
+    }
+
+    std::sort(components.begin(), components.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (const auto& component : components) {
+        netlist.addInstance(component.second, component.first, workingDirectory);
+    }
+
+    QVector<Connection> connections;
+    for (SchematicScene* level : scenes) {
+        for (WireGraphicsItem* wire : level->wires()) {
+            if (!wire->getSource() || !wire->getTarget()) {
+                continue;  // Still being drawn
+            }
+            Connection connection;
+            if (netlist.resolvePin(wire->getSource(), wire->getSourcePort(), &connection.from)
+                && netlist.resolvePin(wire->getTarget(), wire->getTargetPort(), &connection.to)) {
+                connection.label = wire->getLabel().trimmed();
+                connections.append(connection);
+            }
+        }
+    }
+
+    netlist.buildNets(connections);
+    netlist.m_instanceOfItem.clear();
+    netlist.m_warnings.sort();
+    netlist.m_warnings.removeDuplicates();
+    return netlist;
+}
+
+const Port& Netlist::port(const Pin& pin) const
+{
+    const Instance& instance = m_instances.at(pin.instance);
+    return pin.direction == Port::Input ? instance.inputs.at(pin.port) : instance.outputs.at(pin.port);
+}
+
+QString Netlist::pinName(const Pin& pin) const
+{
+    return m_instances.at(pin.instance).name + "." + port(pin).name;
+}
+
+bool Netlist::isClockPort(const Port& port)
+{
+    if (port.direction != Port::Input || !port.width.isEmpty()) {
+        return false;
+    }
+    const QString name = port.name.toLower();
+    return name == "clk" || name == "clock" || name.startsWith("clk_") || name.endsWith("_clk");
+}
+
+bool Netlist::addInstance(ReadyComponentGraphicsItem* item, const QString& componentId, const QString& workingDirectory)
+{
+    Instance instance;
+    instance.componentId = componentId;
+    instance.name = "u_" + identifier(componentId);
+
+    if (ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item)) {
+        // Verilated model; with --pins-sc-uint --pins-sc-biguint its port
+        // types are the ones SystemCGenerator::systemCPortType() picks
+        const ModuleInfo& info = module->getModuleInfo();
+        instance.rtl = true;
+        instance.moduleName = "V" + info.name;
+        instance.sourceFile = instance.moduleName + ".h";
+        instance.inputs = info.inputs;
+        instance.outputs = info.outputs;
+    } else {
+        const QString fileName = componentId + ".cpp";
+        const ModuleInfo info = ComponentPortParser::parseComponentFile(QDir(workingDirectory).filePath(fileName));
+        if (info.name.isEmpty()) {
+            m_warnings.append(QString("%1: no SC_MODULE found in %2, left out").arg(componentId, fileName));
+            return false;
+        }
+        instance.moduleName = info.name;
+        instance.sourceFile = fileName;
+        instance.inputs = info.inputs;
+        instance.outputs = info.outputs;
+    }
+
+    m_instances.append(instance);
+    m_instanceOfItem.insert(item, m_instances.size() - 1);
+    return true;
+}
+
+bool Netlist::resolvePin(ReadyComponentGraphicsItem* item, const QPointF& position, Pin* pin)
+{
+    // A block port stands for the port of a component inside
+    if (BlockGraphicsItem* block = SchematicItemType::cast<BlockGraphicsItem*>(item)) {
+        const BlockPort* member = block->memberOf(position);
+        PersistenceManager& pm = PersistenceManager::instance();
+        ReadyComponentGraphicsItem* memberItem = !member ? nullptr
+            : member->memberIsRTL ? pm.getRTLModuleByName(member->memberId) : pm.getComponentById(member->memberId);
+        if (!memberItem) {
+            m_warnings.append(QString("%1: wire on a block port that leads nowhere").arg(block->label()));
+            return false;
+        }
+        return resolvePin(memberItem, member->memberPort, pin);
+    }
+
+    pin->instance = m_instanceOfItem.value(item, -1);
+    if (pin->instance < 0) {
+        return false;  // Already reported when the instance was left out
+    }
+
+    const Instance& instance = m_instances.at(pin->instance);
+    ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+    if (module && module->isRTLView()) {
+        m_warnings.append(QString("%1: wire on the bundled RTL view port cannot be mapped to a signal; "
+                                  "switch the module to the detailed view").arg(instance.name));
+        return false;
+    }
+
+    auto indexAt = [&position](const QList<QPointF>& ports) {
+        for (int i = 0; i < ports.size(); ++i) {
+            if (QLineF(ports.at(i), position).length() < 1.0) {
+                return i;
+            }
+        }
+        return -1;
+    };
+
+    pin->direction = Port::Input;
+    pin->port = indexAt(item->getInputPorts());
+    if (pin->port < 0) {
+        pin->direction = Port::Output;
+        pin->port = indexAt(item->getOutputPorts());
+    }
+
+    const int declared = pin->direction == Port::Input ? instance.inputs.size() : instance.outputs.size();
+    if (pin->port < 0 || pin->port >= declared) {
+        m_warnings.append(QString("%1: wire attached to a port that %2 does not declare")
+                              .arg(instance.name, instance.sourceFile));
+        return false;
+    }
+    return true;
+}
+
+void Netlist::buildNets(const QVector<Connection>& connections)
+{
+    // Every declared port is one slot; wires merge slots into nets
+    QVector<int> offsets;
+    QVector<Pin> pins;
+    for (int i = 0; i < m_instances.size(); ++i) {
+        offsets.append(pins.size());
+        for (int p = 0; p < m_instances.at(i).inputs.size(); ++p) {
+            pins.append({i, Port::Input, p});
+        }
+        for (int p = 0; p < m_instances.at(i).outputs.size(); ++p) {
+            pins.append({i, Port::Output, p});
+        }
+    }
+    auto slot = [this, &offsets](const Pin& pin) {
+        return offsets.at(pin.instance) + (pin.direction == Port::Input ? 0 : m_instances.at(pin.instance).inputs.size())
+               + pin.port;
+    };
+
+    QVector<int> parent(pins.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    QSet<int> wiredSlots;
+    QHash<int, QString> labels;  // Slot -> smallest label of a wire on it
+    for (const Connection& connection : connections) {
+        const int from = slot(connection.from);
+        const int to = slot(connection.to);
+        unite(parent, from, to);
+        wiredSlots.insert(from);
+        if (!connection.label.isEmpty() && (!labels.contains(from) || connection.label < labels.value(from))) {
+            labels.insert(from, connection.label);
+        }
+    }
+
+    // Undriven clock inputs all share the testbench clock
+    QSet<int> drivenRoots;
+    for (int i = 0; i < pins.size(); ++i) {
+        if (pins.at(i).direction == Port::Output) {
+            drivenRoots.insert(findRoot(parent, i));
+        }
+    }
+    int clockRoot = -1;
+    for (int i = 0; i < pins.size(); ++i) {
+        if (isClockPort(port(pins.at(i))) && !drivenRoots.contains(findRoot(parent, i))) {
+            if (clockRoot < 0) {
+                clockRoot = findRoot(parent, i);
+            } else {
+                unite(parent, clockRoot, i);
+                clockRoot = findRoot(parent, clockRoot);
+            }
+        }
+    }
+
+    // Slots are in instance order, so walking them keeps nets deterministic
+    QHash<int, int> netOfRoot;
+    for (int i = 0; i < pins.size(); ++i) {
+        const int root = findRoot(parent, i);
+        auto it = netOfRoot.constFind(root);
+        if (it == netOfRoot.constEnd()) {
+            it = netOfRoot.insert(root, m_nets.size());
+            m_nets.append(Net());
+        }
+        Net& net = m_nets[it.value()];
+        net.pins.append(pins.at(i));
+        net.wired = net.wired || wiredSlots.contains(i);
+        if (pins.at(i).direction == Port::Output) {
+            ++net.drivers;
+        }
+        if (labels.contains(i) && (net.name.isEmpty() || labels.value(i) < net.name)) {
+            net.name = labels.value(i);
+        }
+    }
+
+    QSet<QString> usedNames;
+    for (const Instance& instance : m_instances) {
+        usedNames.insert(instance.name);
+    }
+    for (Net& net : m_nets) {
+        const auto driver = std::find_if(net.pins.cbegin(), net.pins.cend(), [](const Pin& pin) {
+            return pin.direction == Port::Output;
+        });
+        const Pin& reference = driver != net.pins.cend() ? *driver : net.pins.first();
+        net.clock = net.drivers == 0 && findRoot(parent, slot(reference)) == clockRoot;
+        net.type = net.clock ? QString("bool") : SystemCGenerator::systemCPortType(port(reference));
+
+        QString base;
+        if (!net.name.isEmpty()) {
+            base = identifier(net.name);
+        } else if (net.clock) {
+            base = "clk";
+        } else {
+            base = identifier(m_instances.at(reference.instance).componentId + "_" + port(reference).name);
+        }
+        QString name = base;
+        for (int suffix = 2; usedNames.contains(name); ++suffix) {
+            name = base + "_" + QString::number(suffix);
+        }
+        usedNames.insert(name);
+        net.name = name;
+
+        if (net.drivers > 1) {
+            m_warnings.append(QString("Net %1 has %2 drivers").arg(net.name).arg(net.drivers));
+        }
+
+        const int width = net.clock ? 1 : PortType::fromPort(port(reference)).width;
+        for (const Pin& pin : net.pins) {
+            const int pinWidth = PortType::fromPort(port(pin)).width;
+            if (!PortType::widthsCompatible(width, pinWidth)) {
+                m_warnings.append(QString("Net %1 joins ports of different widths: %2 is %3 bits, %4 is %5 bits")
+                                      .arg(net.name, pinName(reference)).arg(width)
+                                      .arg(pinName(pin)).arg(pinWidth));
+                break;
+            }
+        }
+    }
+}
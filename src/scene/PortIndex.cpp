@@ -0,0 +1,111 @@
+// PortIndex.cpp
+#include "scene/PortIndex.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include <QLineF>
+#include <QtMath>
+#include <algorithm>
+
+quint64 PortIndex::cellKey(int column, int row)
+{
+    return (quint64(quint32(column)) << 32) | quint32(row);
+}
+
+int PortIndex::cellOf(qreal coordinate)
+{
+    return qFloor(coordinate / CELL_SIZE);
+}
+
+void PortIndex::update(ReadyComponentGraphicsItem* item)
+{
+    remove(item);
+    if (!item->isVisible()) {
+        return;
+    }
+    for (const QPointF& port : item->getInputPorts()) {
+        insert(item, port, true);
+    }
+    for (const QPointF& port : item->getOutputPorts()) {
+        insert(item, port, false);
+    }
+}
+
+void PortIndex::insert(ReadyComponentGraphicsItem* item, const QPointF& port, bool isInput)
+{
+    const QPointF scenePos = item->mapToScene(port);
+    const quint64 key = cellKey(cellOf(scenePos.x()), cellOf(scenePos.y()));
+    m_cells[key].append({item, port, scenePos, isInput});
+
+    QVector<quint64>& cells = m_cellsOfItem[item];
+    if (!cells.contains(key)) {
+        cells.append(key);
+    }
+    ++m_size;
+}
+
+void PortIndex::remove(ReadyComponentGraphicsItem* item)
+{
+    const auto it = m_cellsOfItem.find(item);
+    if (it == m_cellsOfItem.end()) {
+        return;
+    }
+    for (quint64 key : it.value()) {
+        auto cell = m_cells.find(key);
+        if (cell == m_cells.end()) {
+            continue;
+        }
+        const int before = cell->size();
+        cell->erase(std::remove_if(cell->begin(), cell->end(), [item](const Entry& entry) {
+            return entry.item == item;
+        }), cell->end());
+        m_size -= before - cell->size();
+        if (cell->isEmpty()) {
+            m_cells.erase(cell);
+        }
+    }
+    m_cellsOfItem.erase(it);
+}
+
+void PortIndex::clear()
+{
+    m_cells.clear();
+    m_cellsOfItem.clear();
+    m_size = 0;
+}
+
+PortIndex::Hit PortIndex::portAt(const QPointF& scenePos, qreal radius) const
+{
+    const Entry* nearest = nullptr;
+    qreal nearestDistance = radius;
+
+    for (int column = cellOf(scenePos.x() - radius); column <= cellOf(scenePos.x() + radius); ++column) {
+        for (int row = cellOf(scenePos.y() - radius); row <= cellOf(scenePos.y() + radius); ++row) {
+            const auto cell = m_cells.constFind(cellKey(column, row));
+            if (cell == m_cells.constEnd()) {
+                continue;
+            }
+            for (const Entry& entry : *cell) {
+                const qreal distance = QLineF(entry.scenePos, scenePos).length();
+                if (distance < nearestDistance) {
+                    nearest = &entry;
+                    nearestDistance = distance;
+                }
+            }
+        }
+    }
+
+    Hit hit;
+    if (!nearest) {
+        return hit;
+    }
+
+    // The item has the final say: detection radii differ between views
+    bool isInput = nearest->isInput;
+    const QPointF port = nearest->item->getPortAt(nearest->item->mapFromScene(scenePos), isInput);
+    if (port.isNull()) {
+        return hit;
+    }
+    hit.item = nearest->item;
+    hit.port = port;
+    hit.isInput = isInput;
+    return hit;
+}
@@ -0,0 +1,129 @@
+// RubberBandSelection.cpp
+#include "scene/RubberBandSelection.h"
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QPainterPath>
+#include <QSignalBlocker>
+
+RubberBandSelection::RubberBandSelection(QGraphicsScene* scene, QObject* parent)
+    : QObject(parent)
+    , m_scene(scene)
+{
+    m_notifyTimer.setSingleShot(true);
+    m_notifyTimer.setInterval(FRAME_INTERVAL_MS);
+    connect(&m_notifyTimer, &QTimer::timeout, this, &RubberBandSelection::selectionChanged);
+}
+
+void RubberBandSelection::begin(const QPointF& origin, bool additive)
+{
+    m_active = true;
+    m_origin = origin;
+    m_rect = QRectF(origin, QSizeF(0, 0));
+    m_base.clear();
+    if (additive) {
+        const QList<QGraphicsItem*> selected = m_scene->selectedItems();
+        m_base = QSet<QGraphicsItem*>(selected.cbegin(), selected.cend());
+    }
+}
+
+void RubberBandSelection::update(const QPointF& currentPos)
+{
+    if (!m_active) {
+        return;
+    }
+    const QRectF next = QRectF(m_origin, currentPos).normalized();
+    if (next == m_rect) {
+        return;
+    }
+
+    // Only the symmetric difference of the two rectangles can change state
+    QRectF pieces[8];
+    int count = subtract(m_rect, next, pieces);
+    count += subtract(next, m_rect, pieces + count);
+    m_rect = next;
+
+    bool changed = false;
+    {
+        const QSignalBlocker blocker(m_scene);
+        m_visited.clear();
+        for (int i = 0; i < count; ++i) {
+            changed |= toggle(pieces[i]);
+        }
+    }
+
+    if (changed && !m_notifyTimer.isActive()) {
+        m_notifyTimer.start();
+    }
+}
+
+void RubberBandSelection::finish()
+{
+    m_active = false;
+    m_base.clear();
+    m_visited.clear();
+    if (m_notifyTimer.isActive()) {
+        m_notifyTimer.stop();
+        emit selectionChanged();
+    }
+}
+
+bool RubberBandSelection::toggle(const QRectF& region)
+{
+    bool changed = false;
+    for (QGraphicsItem* item : m_scene->items(region, Qt::IntersectsItemBoundingRect)) {
+        if (!(item->flags() & QGraphicsItem::ItemIsSelectable) || m_visited.contains(item)) {
+            continue;
+        }
+        m_visited.insert(item);
+
+        const bool selected = m_base.contains(item) || isInside(item, m_rect);
+        if (item->isSelected() != selected) {
+            item->setSelected(selected);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool RubberBandSelection::isInside(QGraphicsItem* item, const QRectF& rect)
+{
+    const QRectF bounds = item->sceneBoundingRect();
+    if (!bounds.intersects(rect)) {
+        return false;
+    }
+    if (rect.contains(bounds)) {
+        return true;
+    }
+    // Partly covered: wires and other non-rectangular items need their shape
+    QPainterPath path;
+    path.addRect(rect);
+    return item->collidesWithPath(item->mapFromScene(path), Qt::IntersectsItemShape);
+}
+
+int RubberBandSelection::subtract(const QRectF& a, const QRectF& b, QRectF* out)
+{
+    if (a.isEmpty()) {
+        return 0;
+    }
+    if (!a.intersects(b)) {
+        out[0] = a;
+        return 1;
+    }
+
+    // Up to four strips: above, below, left and right of the overlap
+    const QRectF overlap = a & b;
+    int count = 0;
+    if (overlap.top() > a.top()) {
+        out[count++] = QRectF(a.left(), a.top(), a.width(), overlap.top() - a.top());
+    }
+    if (overlap.bottom() < a.bottom()) {
+        out[count++] = QRectF(a.left(), overlap.bottom(), a.width(), a.bottom() - overlap.bottom());
+    }
+    if (overlap.left() > a.left()) {
+        out[count++] = QRectF(a.left(), overlap.top(), overlap.left() - a.left(), overlap.height());
+    }
+    if (overlap.right() < a.right()) {
+        out[count++] = QRectF(overlap.right(), overlap.top(), a.right() - overlap.right(), overlap.height());
+    }
+    return count;
+}
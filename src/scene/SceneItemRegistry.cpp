@@ -0,0 +1,86 @@
+// SceneItemRegistry.cpp
+#include "scene/SceneItemRegistry.h"
+#include "graphics/SchematicItemTypes.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "graphics/ModuleGraphicsItem.h"
+#include "graphics/TextGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/wire/WireGraphicsItem.h"
+
+template <typename T>
+void SceneItemRegistry::Category<T>::add(const QGraphicsItem* key, T* item)
+{
+    if (positions.contains(key)) {
+        return;
+    }
+    positions.insert(key, items.size());
+    items.append(item);
+}
+
+template <typename T>
+void SceneItemRegistry::Category<T>::remove(const QGraphicsItem* key)
+{
+    const auto it = positions.constFind(key);
+    if (it == positions.cend()) {
+        return;
+    }
+    const int slot = it.value();
+    positions.erase(it);
+
+    // Move the last item into the freed slot
+    T* last = items.takeLast();
+    if (slot < items.size()) {
+        items[slot] = last;
+        positions.insert(last, slot);
+    }
+}
+
+template <typename T>
+void SceneItemRegistry::Category<T>::clear()
+{
+    items.clear();
+    positions.clear();
+}
+
+void SceneItemRegistry::add(QGraphicsItem* item)
+{
+    switch (item ? item->type() : 0) {
+    case SchematicItemType::Module:
+        m_modules.add(item, static_cast<ModuleGraphicsItem*>(item));
+        m_components.add(item, static_cast<ReadyComponentGraphicsItem*>(item));
+        break;
+    case SchematicItemType::ReadyComponent:
+        m_components.add(item, static_cast<ReadyComponentGraphicsItem*>(item));
+        break;
+    case SchematicItemType::Wire:
+        m_wires.add(item, static_cast<WireGraphicsItem*>(item));
+        break;
+    case SchematicItemType::Text:
+        m_texts.add(item, static_cast<TextGraphicsItem*>(item));
+        break;
+    case SchematicItemType::Block:
+        m_blocks.add(item, static_cast<BlockGraphicsItem*>(item));
+        break;
+    default:
+        break;
+    }
+}
+
+void SceneItemRegistry::remove(QGraphicsItem* item)
+{
+    // Not by type(): from a base class destructor a module reports the base type
+    m_components.remove(item);
+    m_modules.remove(item);
+    m_wires.remove(item);
+    m_texts.remove(item);
+    m_blocks.remove(item);
+}
+
+void SceneItemRegistry::clear()
+{
+    m_components.clear();
+    m_modules.clear();
+    m_wires.clear();
+    m_texts.clear();
+    m_blocks.clear();
+}
@@ -0,0 +1,396 @@
+// SchematicClipboard.cpp
+#include "scene/SchematicClipboard.h"
+#include "scene/SchematicScene.h"
+#include "commands/SchematicCommands.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "graphics/ModuleGraphicsItem.h"
+#include "graphics/TextGraphicsItem.h"
+#include "graphics/wire/WireGraphicsItem.h"
+#include "utils/PersistenceManager.h"
+#include <QGuiApplication>
+#include <QClipboard>
+#include <QMimeData>
+#include <QDataStream>
+#include <QHash>
+#include <QColor>
+#include <QFont>
+#include <QSet>
+#include <QDebug>
+
+// Found by argument-dependent lookup from QList<Port>'s stream operators, so not in the anonymous namespace
+static QDataStream& operator<<(QDataStream& out, const Port& port)
+{
+    return out << quint8(port.direction) << port.name << port.width;
+}
+
+static QDataStream& operator>>(QDataStream& in, Port& port)
+{
+    quint8 direction = 0;
+    in >> direction >> port.name >> port.width;
+    port.direction = direction == Port::Output ? Port::Output : Port::Input;
+    return in;
+}
+
+namespace {
+
+struct ComponentRecord {
+    bool isModule = false;
+    QString type;                        ///< Component type, or the module's definition name
+    QString filePath;                    ///< Source of an RTL module
+    ModuleInfo moduleInfo;
+    QPointF position;
+    QSizeF size;
+    qreal rotation = 0.0;
+    qreal opacity = 1.0;
+    bool visible = true;
+    QColor color;                        ///< Invalid when the component has no custom color
+};
+
+struct WireRecord {
+    quint32 source = 0;
+    quint32 target = 0;
+    QPointF sourcePort;
+    QPointF targetPort;
+    QList<QPointF> controlPoints;
+    qreal orthogonalOffset = 0.0;
+    bool manualOffset = false;
+    QString label;
+    bool labelVisible = false;
+};
+
+struct TextRecord {
+    QString text;
+    QPointF position;
+    QColor color;
+    QFont font;
+};
+
+QDataStream& operator<<(QDataStream& out, const ComponentRecord& record)
+{
+    out << record.isModule << record.type;
+    if (record.isModule) {
+        out << record.filePath << record.moduleInfo.name << record.moduleInfo.inputs << record.moduleInfo.outputs;
+    }
+    return out << record.position << record.size << record.rotation << record.opacity << record.visible << record.color;
+}
+
+QDataStream& operator>>(QDataStream& in, ComponentRecord& record)
+{
+    in >> record.isModule >> record.type;
+    if (record.isModule) {
+        in >> record.filePath >> record.moduleInfo.name >> record.moduleInfo.inputs >> record.moduleInfo.outputs;
+    }
+    return in >> record.position >> record.size >> record.rotation >> record.opacity >> record.visible >> record.color;
+}
+
+QDataStream& operator<<(QDataStream& out, const WireRecord& record)
+{
+    return out << record.source << record.sourcePort << record.target << record.targetPort
+               << record.controlPoints << record.orthogonalOffset << record.manualOffset << record.label
+               << record.labelVisible;
+}
+
+QDataStream& operator>>(QDataStream& in, WireRecord& record)
+{
+    return in >> record.source >> record.sourcePort >> record.target >> record.targetPort
+              >> record.controlPoints >> record.orthogonalOffset >> record.manualOffset >> record.label
+              >> record.labelVisible;
+}
+
+QDataStream& operator<<(QDataStream& out, const TextRecord& record)
+{
+    return out << record.text << record.position << record.color << record.font;
+}
+
+QDataStream& operator>>(QDataStream& in, TextRecord& record)
+{
+    return in >> record.text >> record.position >> record.color >> record.font;
+}
+
+ComponentRecord recordOf(ReadyComponentGraphicsItem* component)
+{
+    ComponentRecord record;
+    record.type = component->getName();
+    record.position = component->pos();
+    record.size = component->getSize();
+    record.rotation = component->rotation();
+    record.opacity = component->opacity();
+    record.visible = component->isVisible();
+    if (component->hasCustomColor()) {
+        record.color = component->getCustomColor();
+    }
+
+    if (ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(component)) {
+        PersistenceManager& pm = PersistenceManager::instance();
+        record.isModule = true;
+        record.moduleInfo = module->getModuleInfo();
+        record.type = record.moduleInfo.name;
+        record.filePath = pm.getRTLModuleFilePath(pm.getRTLModuleName(module));
+    }
+    return record;
+}
+
+void applyAppearance(ReadyComponentGraphicsItem* component, const ComponentRecord& record, const QString& componentId)
+{
+    PersistenceManager& pm = PersistenceManager::instance();
+    if (record.rotation != 0.0) {
+        component->setRotation(record.rotation);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentRotation(componentId, record.rotation);
+        }
+    }
+    if (record.opacity != 1.0) {
+        component->setOpacity(record.opacity);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentOpacity(componentId, record.opacity);
+        }
+    }
+    if (!record.visible) {
+        component->setVisible(false);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentVisibility(componentId, false);
+        }
+    }
+    if (record.color.isValid()) {
+        component->setCustomColor(record.color);
+        if (!componentId.isEmpty()) {
+            pm.updateComponentColor(componentId, record.color);
+        }
+    }
+}
+
+} // namespace
+
+QByteArray SchematicClipboard::serialize(const QList<QGraphicsItem*>& items)
+{
+    QVector<ComponentRecord> components;
+    QVector<WireRecord> wires;
+    QVector<TextRecord> texts;
+    QHash<const ReadyComponentGraphicsItem*, quint32> indexOf;
+    QVector<const ReadyComponentGraphicsItem*> copied;
+    QList<WireGraphicsItem*> candidateWires;
+
+    for (QGraphicsItem* item : items) {
+        if (WireGraphicsItem* wire = SchematicItemType::cast<WireGraphicsItem*>(item)) {
+            candidateWires.append(wire);
+        } else if (ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item)) {
+            // Blocks are not copied: their contents live in other scenes
+            if (component->parentItem() || indexOf.contains(component) || component->type() == SchematicItemType::Block) {
+                continue;
+            }
+            indexOf.insert(component, quint32(components.size()));
+            copied.append(component);
+            components.append(recordOf(component));
+        } else if (TextGraphicsItem* textItem = SchematicItemType::cast<TextGraphicsItem*>(item)) {
+            texts.append({textItem->getText(), textItem->pos(), textItem->getTextColor(), textItem->getTextFont()});
+        }
+    }
+
+    // Wires between copied components come along even when not selected themselves
+    for (const ReadyComponentGraphicsItem* component : copied) {
+        for (WireGraphicsItem* wire : component->getWires()) {
+            if (wire->getSource() == component) {
+                candidateWires.append(wire);
+            }
+        }
+    }
+
+    QSet<const WireGraphicsItem*> seenWires;
+    for (WireGraphicsItem* wire : candidateWires) {
+        if (seenWires.contains(wire)) {
+            continue;
+        }
+        seenWires.insert(wire);
+
+        // A wire is only copied together with both of its ends
+        const auto source = indexOf.constFind(wire->getSource());
+        const auto target = indexOf.constFind(wire->getTarget());
+        if (source == indexOf.cend() || target == indexOf.cend()) {
+            continue;
+        }
+
+        WireRecord record;
+        record.source = source.value();
+        record.target = target.value();
+        record.sourcePort = wire->getSourcePort();
+        record.targetPort = wire->getTargetPort();
+        record.controlPoints = wire->getControlPoints();
+        record.orthogonalOffset = wire->geometry().orthogonalOffset;
+        record.manualOffset = wire->geometry().manualOffset;
+        record.label = wire->getLabel();
+        record.labelVisible = wire->isLabelVisible();
+        wires.append(record);
+    }
+
+    if (components.isEmpty() && texts.isEmpty()) {
+        return QByteArray();
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << MAGIC << VERSION << components << wires << texts;
+
+    qDebug() << "📋 Serialized" << components.size() << "component(s)," << wires.size() << "wire(s) and"
+             << texts.size() << "text item(s) into" << payload.size() << "bytes";
+    return payload;
+}
+
+QList<QGraphicsItem*> SchematicClipboard::paste(SchematicScene* scene, const QByteArray& payload, const QPointF& offset)
+{
+    if (!scene || payload.isEmpty()) {
+        return {};
+    }
+
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != MAGIC || version != VERSION) {
+        qWarning() << "⚠️ Clipboard payload is not a schematic or has an unknown version:" << version;
+        return {};
+    }
+
+    QVector<ComponentRecord> components;
+    QVector<WireRecord> wires;
+    QVector<TextRecord> texts;
+    in >> components >> wires >> texts;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "⚠️ Clipboard payload is truncated or corrupt";
+        return {};
+    }
+
+    const int itemCount = components.size() + texts.size();
+    SchematicScene::Transaction transaction(scene, QObject::tr("Paste %n Item(s)", nullptr, itemCount));
+    PersistenceManager& pm = PersistenceManager::instance();
+    scene->clearSelection();
+
+    QList<QGraphicsItem*> pasted;
+    QVector<ReadyComponentGraphicsItem*> created(components.size(), nullptr);
+
+    // Ready components get fresh IDs and their files in one batch
+    QVector<ComponentPersistence::ComponentPlacement> placements;
+    QVector<int> placedIndices;
+    for (int i = 0; i < components.size(); ++i) {
+        const ComponentRecord& record = components.at(i);
+        if (!record.isModule) {
+            placements.append({record.type, record.position + offset, record.size});
+            placedIndices.append(i);
+        }
+    }
+    const QStringList componentIds = pm.createComponentFiles(placements);
+
+    for (int k = 0; k < placedIndices.size(); ++k) {
+        const ComponentRecord& record = components.at(placedIndices.at(k));
+        const QString componentId = componentIds.value(k);
+
+        ReadyComponentGraphicsItem* component = new ReadyComponentGraphicsItem(record.type);
+        component->setSize(record.size.width(), record.size.height());
+        component->setPos(record.position + offset);
+        scene->addItem(component);
+        if (!componentId.isEmpty()) {
+            pm.setComponentId(component, componentId);
+        }
+        applyAppearance(component, record, componentId);
+        created[placedIndices.at(k)] = component;
+    }
+
+    // RTL modules are registered under a name no placed module uses yet
+    for (int i = 0; i < components.size(); ++i) {
+        const ComponentRecord& record = components.at(i);
+        if (!record.isModule) {
+            continue;
+        }
+
+        ModuleGraphicsItem* module = new ModuleGraphicsItem(record.moduleInfo);
+        module->setSize(record.size.width(), record.size.height());
+        module->setPos(record.position + offset);
+        scene->addItem(module);
+        applyAppearance(module, record, QString());
+
+        const QString moduleName = pm.createRTLModuleName(record.moduleInfo.name);
+        pm.setRTLModuleName(module, moduleName);
+        pm.saveRTLModulePlacement(moduleName, record.filePath, module->pos(), record.moduleInfo.name);
+        created[i] = module;
+    }
+
+    for (ReadyComponentGraphicsItem* component : created) {
+        if (component) {
+            component->setSelected(true);
+            pasted.append(component);
+        }
+    }
+
+    for (const TextRecord& record : texts) {
+        TextGraphicsItem* textItem = new TextGraphicsItem(record.text);
+        textItem->setPos(record.position + offset);
+        textItem->setTextColor(record.color);
+        textItem->setTextFont(record.font);
+        scene->addItem(textItem);
+        pm.saveTextItem(record.text, textItem->pos(), record.color, record.font);
+        textItem->setSelected(true);
+        pasted.append(textItem);
+    }
+
+    if (!pasted.isEmpty()) {
+        // Already placed and saved; undo takes them out with their files, before the wires below
+        scene->pushCommand(new ChangeItemsCommand(scene, pasted, {},
+                                                  QObject::tr("Paste %n Item(s)", nullptr, pasted.size())));
+    }
+
+    QList<WireGraphicsItem*> newWires;
+    for (const WireRecord& record : wires) {
+        ReadyComponentGraphicsItem* source = created.value(int(record.source));
+        ReadyComponentGraphicsItem* target = created.value(int(record.target));
+        if (!source || !target) {
+            continue;
+        }
+
+        WireGraphicsItem* wire = new WireGraphicsItem(source, record.sourcePort, target, record.targetPort);
+        WireGraphicsItem::Geometry geometry;
+        geometry.orthogonalOffset = record.orthogonalOffset;
+        geometry.manualOffset = record.manualOffset;
+        geometry.controlPoints.reserve(record.controlPoints.size());
+        for (const QPointF& point : record.controlPoints) {
+            geometry.controlPoints.append(point + offset);
+        }
+        wire->setGeometry(geometry);
+        if (!record.label.isEmpty()) {
+            wire->setLabel(record.label);
+            wire->showLabel(record.labelVisible);
+        }
+        newWires.append(wire);
+    }
+    if (!newWires.isEmpty()) {
+        // Connects, registers and saves every wire; one undo step
+        scene->pushCommand(new ChangeWiresCommand(scene, newWires, {},
+                                                  QObject::tr("Paste %n Wire(s)", nullptr, newWires.size())));
+        for (WireGraphicsItem* wire : newWires) {
+            if (wire->scene()) {
+                wire->setSelected(true);
+                pasted.append(wire);
+            }
+        }
+    }
+
+    qDebug() << "📄 Pasted" << components.size() << "component(s)," << newWires.size() << "wire(s) and"
+             << texts.size() << "text item(s)";
+    return pasted;
+}
+
+void SchematicClipboard::copyToClipboard(const QByteArray& payload)
+{
+    QMimeData* mimeData = new QMimeData;
+    mimeData->setData(MIME_TYPE, payload);
+    QGuiApplication::clipboard()->setMimeData(mimeData);
+}
+
+QByteArray SchematicClipboard::clipboardPayload()
+{
+    const QMimeData* mimeData = QGuiApplication::clipboard()->mimeData();
+    if (!mimeData || !mimeData->hasFormat(MIME_TYPE)) {
+        return QByteArray();
+    }
+    return mimeData->data(MIME_TYPE);
+}
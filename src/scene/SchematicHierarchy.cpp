@@ -0,0 +1,267 @@
+// SchematicHierarchy.cpp
+#include "scene/SchematicHierarchy.h"
+#include "scene/SchematicScene.h"
+#include "scene/AutoPlacement.h"
+#include "scene/WireManager.h"
+#include "commands/SchematicCommands.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/ModuleGraphicsItem.h"
+#include "graphics/wire/WireGraphicsItem.h"
+#include "persistence/BlockPersistence.h"
+#include "persistence/ConnectionPersistence.h"
+#include "utils/PersistenceManager.h"
+#include <QHash>
+#include <QLineF>
+#include <QPointer>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+// Name of @p port on @p item as the block should show it
+QString portName(ReadyComponentGraphicsItem* item, const QPointF& port, bool isInput, const ConnectionEnd& end)
+{
+    if (BlockGraphicsItem* block = SchematicItemType::cast<BlockGraphicsItem*>(item)) {
+        if (const BlockPort* member = block->memberOf(port)) {
+            return member->name;
+        }
+    }
+
+    const QList<QPointF> ports = isInput ? item->getInputPorts() : item->getOutputPorts();
+    int index = 0;
+    while (index < ports.size() && QLineF(ports.at(index), port).length() >= 1.0) {
+        ++index;
+    }
+
+    // Detailed-view modules know their port names; the bundled RTL view does not
+    ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+    if (module && !module->isRTLView()) {
+        const QList<Port>& declared = isInput ? module->getModuleInfo().inputs : module->getModuleInfo().outputs;
+        if (index < declared.size()) {
+            return declared.at(index).name;
+        }
+    }
+    return QString("%1.%2%3").arg(end.id, isInput ? "in" : "out").arg(index);
+}
+
+} // namespace
+
+void SchematicHierarchy::load(SchematicScene* scene)
+{
+    if (!scene) {
+        return;
+    }
+    PersistenceManager& pm = PersistenceManager::instance();
+    SchematicScene::Transaction transaction(scene);
+
+    // Blocks before connections, so wires into a block find its ports
+    pm.loadComponentsFromDirectory(scene);
+    pm.loadRTLModules(scene);
+    pm.loadBlocks(scene);
+    pm.loadConnections(scene);
+    scene->checkAllWireWidths();
+
+    // RTL modules without a saved position all come in at the origin, on top of each other;
+    // spreading them is part of loading, not an edit to undo
+    QList<QGraphicsItem*> modules;
+    for (ModuleGraphicsItem* module : scene->modules()) {
+        if (!module->parentItem()) {
+            modules.append(module);
+        }
+    }
+    scene->autoPlacement()->placeOverlapping(modules, false);
+}
+
+void SchematicHierarchy::unload(SchematicScene* scene)
+{
+    if (!scene) {
+        return;
+    }
+    SchematicScene::Transaction transaction(scene);
+    PersistenceManager& pm = PersistenceManager::instance();
+
+    // Recorded edits hold their items through guards and skip the ones deleted here
+    const QVector<WireGraphicsItem*> wires = scene->wires();
+    for (WireGraphicsItem* wire : wires) {
+        discardWire(wire);
+    }
+
+    const QVector<ReadyComponentGraphicsItem*> components = scene->components();
+    for (ReadyComponentGraphicsItem* component : components) {
+        if (component->parentItem()) {
+            continue;
+        }
+        // Only unregister from internal maps, don't delete files
+        ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(component);
+        if (module && module->isRTLView()) {
+            pm.unregisterRTLModule(module);
+        }
+        pm.unregisterComponent(component);
+        scene->removeItem(component);
+        delete component;
+    }
+
+    // A block unloads its own inside as it goes
+    const QVector<BlockGraphicsItem*> blocks = scene->blocks();
+    for (BlockGraphicsItem* block : blocks) {
+        scene->removeItem(block);
+        delete block;
+    }
+}
+
+void SchematicHierarchy::discardWire(WireGraphicsItem* wire)
+{
+    if (!wire) {
+        return;
+    }
+    takeWire(wire);
+    delete wire;
+}
+
+void SchematicHierarchy::takeWire(WireGraphicsItem* wire)
+{
+    if (wire->getSource()) {
+        wire->getSource()->removeWire(wire);
+    }
+    if (wire->getTarget()) {
+        wire->getTarget()->removeWire(wire);
+    }
+    if (SchematicScene* scene = qobject_cast<SchematicScene*>(wire->scene())) {
+        if (WireManager* wireManager = scene->getWireManager()) {
+            wireManager->unregisterWire(wire);
+        }
+    }
+    if (wire->scene()) {
+        wire->scene()->removeItem(wire);
+    }
+}
+
+void SchematicHierarchy::placeWire(SchematicScene* scene, WireGraphicsItem* wire)
+{
+    scene->addItem(wire);
+    wire->getSource()->addWire(wire);
+    wire->getTarget()->addWire(wire);
+    if (WireManager* wireManager = scene->getWireManager()) {
+        wireManager->registerWire(wire);
+    }
+    wire->updatePath();
+    scene->checkWireWidth(wire);
+}
+
+BlockGraphicsItem* SchematicHierarchy::collapse(SchematicScene* scene, const QList<QGraphicsItem*>& items)
+{
+    PersistenceManager& pm = PersistenceManager::instance();
+    BlockPersistence* blocks = pm.getBlockPersistence();
+    if (!scene || !blocks) {
+        return nullptr;
+    }
+
+    // Members: the selected components and blocks
+    BlockData data;
+    QList<ReadyComponentGraphicsItem*> memberList;
+    QSet<ReadyComponentGraphicsItem*> members;
+    QRectF bounds;
+    for (QGraphicsItem* item : items) {
+        ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item);
+        if (!component || component->parentItem()) {
+            continue;
+        }
+        if (!SchematicItemType::cast<BlockGraphicsItem*>(component)) {
+            ConnectionEnd end;
+            if (!pm.connectionEnd(component, QPointF(), end)) {
+                qWarning() << "⚠️" << component->getName() << "has no ID and stays out of the block";
+                continue;
+            }
+            (end.isRTL ? data.rtlModules : data.components).append(end.id);
+        }
+        memberList.append(component);
+        members.insert(component);
+        bounds |= component->sceneBoundingRect();
+    }
+    if (members.isEmpty()) {
+        return nullptr;
+    }
+
+    // Every wire crossing the border becomes a port, leading to the component inside
+    struct PendingPort {
+        BlockPort port;
+        qreal sceneY;
+    };
+    QVector<PendingPort> pending;
+    QSet<QString> seenPorts;
+    for (ReadyComponentGraphicsItem* member : memberList) {
+        for (WireGraphicsItem* wire : member->getWires()) {
+            const bool sourceInside = members.contains(wire->getSource());
+            const bool targetInside = members.contains(wire->getTarget());
+            if (sourceInside == targetInside) {
+                continue;
+            }
+            const QPointF port = sourceInside ? wire->getSourcePort() : wire->getTargetPort();
+            ConnectionEnd end;
+            if (!pm.connectionEnd(member, port, end)) {
+                continue;
+            }
+            bool isInput = false;
+            member->getPortAt(port, isInput);
+
+            const QString key = QString("%1:%2:%3,%4:%5").arg(int(end.isRTL)).arg(end.id)
+                                    .arg(end.port.x()).arg(end.port.y()).arg(int(isInput));
+            if (seenPorts.contains(key)) {
+                continue;  // Several wires leave the same port
+            }
+            seenPorts.insert(key);
+
+            BlockPort blockPort;
+            blockPort.name = portName(member, port, isInput, end);
+            blockPort.width = member->getPortWidth(port, isInput);
+            blockPort.isInput = isInput;
+            blockPort.memberId = end.id;
+            blockPort.memberIsRTL = end.isRTL;
+            blockPort.memberPort = end.port;
+            pending.append({blockPort, member->mapToScene(port).y()});
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [](const PendingPort& a, const PendingPort& b) {
+        return a.sceneY < b.sceneY;
+    });
+    for (const PendingPort& port : pending) {
+        data.ports.append(port.port);
+    }
+
+    data.name = blocks->createBlockName();
+    data.label = data.name;
+    data.parent = scene->blockName();
+    data.position = bounds.topLeft();
+    data.origin = bounds.topLeft();
+
+    // The members move into the block's scene as they are; nothing is reloaded
+    QPointer<BlockGraphicsItem> block = new BlockGraphicsItem(data);
+    block->setPos(data.position);
+    scene->pushCommand(new FoldBlockCommand(scene, block, data, memberList));
+    qDebug() << "📦 Collapsed" << members.size() << "item(s) into" << data.name << "with" << data.ports.size() << "port(s)";
+
+    if (!block || block->scene() != scene) {
+        return nullptr;
+    }
+    scene->clearSelection();
+    block->setSelected(true);
+    return block;
+}
+
+void SchematicHierarchy::expand(SchematicScene* scene, BlockGraphicsItem* block)
+{
+    BlockPersistence* blocks = PersistenceManager::instance().getBlockPersistence();
+    if (!scene || !block || !blocks || !blocks->contains(block->blockName())) {
+        return;
+    }
+    scene->pushCommand(new FoldBlockCommand(scene, block));
+}
+
+void SchematicHierarchy::remove(SchematicScene* scene, BlockGraphicsItem* block)
+{
+    if (!scene || !block || !PersistenceManager::instance().getBlockPersistence()) {
+        return;
+    }
+    scene->pushCommand(new RemoveBlockCommand(scene, block));
+}
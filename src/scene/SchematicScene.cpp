@@ -1,10 +1,19 @@
 // SchematicScene.cpp
 #include "scene/SchematicScene.h"
 #include "scene/WireManager.h"
+#include "scene/PortIndex.h"
+#include "scene/RubberBandSelection.h"
+#include "scene/SchematicClipboard.h"
+#include "scene/SchematicHierarchy.h"
+#include "scene/AutoPlacement.h"
+#include "commands/UndoHistory.h"
+#include "commands/SchematicCommands.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "graphics/ModuleGraphicsItem.h"
 #include "graphics/TextGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
 #include "graphics/wire/WireGraphicsItem.h"
+#include "parsers/PortType.h"
 #include "utils/PersistenceManager.h"
 #include "ui/widgets/ComponentPropertiesDialog.h"
 #include "persistence/SchematicPersistence.h"
@@ -12,6 +21,7 @@
 #include <QColor>
 #include <QKeyEvent>
 #include <QGraphicsItem>
+#include <QGraphicsView>
 #include <QPainterPath>
 #include <QBrush>
 #include <cmath>
@@ -20,19 +30,35 @@
 #include <QJsonArray>
 #include <QMenu>
 #include <QAction>
+#include <QSet>
+#include <QSignalBlocker>
+#include <utility>
 
 SchematicScene::SchematicScene(QObject *parent)
     : QGraphicsScene(parent)
 {
-    setSceneRect(-1000, -1000, 2000, 2000);
+    // One tile to start with; growCanvas() adds more as items approach the edge
+    resetCanvas();
+    setBspTreeDepth(MIN_BSP_DEPTH);
     
     // Initialize wire manager for intelligent routing
     m_wireManager = std::make_unique<WireManager>(this, this);
+    m_portIndex = std::make_unique<PortIndex>();
+    m_autoPlacement = new AutoPlacement(this);
+    
+    // Rubber-band selection toggles items with scene signals blocked and reports once per frame
+    m_rubberBand = new RubberBandSelection(this, this);
+    connect(m_rubberBand, &RubberBandSelection::selectionChanged, this, &QGraphicsScene::selectionChanged);
     qDebug() << "SchematicScene: WireManager initialized";
 }
 
 SchematicScene::~SchematicScene()
 {
+    endItemDrag();
+    while (m_transactionDepth > 0) {
+        commitTransaction();
+    }
+    
     // Clean up selection rectangle
     cleanupSelectionRectangle();
     
@@ -43,9 +69,6 @@ SchematicScene::~SchematicScene()
         m_temporaryWire = nullptr;
     }
     
-    // Clear clipboard to avoid dangling pointers
-    m_clipboard.clear();
-    
     qDebug() << "SchematicScene: Destructor completed - resources cleaned up";
 }
 
@@ -102,69 +125,303 @@ void SchematicScene::setDarkMode(bool enabled)
     }
 }
 
-ReadyComponentGraphicsItem* SchematicScene::getComponentAt(const QPointF& pos)
+void SchematicScene::addWireToItem(QGraphicsItem* item, WireGraphicsItem* wire, bool isModule)
+{
+    if (isModule) {
+        ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+        if (module) module->addWire(wire);
+    } else {
+        ReadyComponentGraphicsItem* comp = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item);
+        if (comp) comp->addWire(wire);
+    }
+}
+
+void SchematicScene::highlightPort(ReadyComponentGraphicsItem* item, const QPointF& port)
+{
+    if (m_highlightedItem == item && m_highlightedPort == port) {
+        return;
+    }
+    if (m_highlightedItem) {
+        m_highlightedItem->clearHighlightedPort();
+    }
+    m_highlightedItem = item;
+    m_highlightedPort = port;
+    if (item) {
+        item->setHighlightedPort(port);
+    }
+}
+
+void SchematicScene::removeWireFromItem(QGraphicsItem* item, WireGraphicsItem* wire, bool isModule)
+{
+    if (isModule) {
+        ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+        if (module) module->removeWire(wire);
+    } else {
+        ReadyComponentGraphicsItem* comp = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item);
+        if (comp) comp->removeWire(wire);
+    }
+}
+
+void SchematicScene::trackItem(QGraphicsItem* item, QGraphicsItem::GraphicsItemChange change)
 {
-    QList<QGraphicsItem*> itemsAtPos = items(pos);
-    for (QGraphicsItem* item : itemsAtPos) {
-        ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (component) {
-            return component;
+    if (change == QGraphicsItem::ItemSceneChange) {
+        // Still in the scene it is leaving
+        untrackItem(item);
+    } else if (change == QGraphicsItem::ItemSceneHasChanged || change == QGraphicsItem::ItemPositionHasChanged) {
+        SchematicScene* scene = qobject_cast<SchematicScene*>(item->scene());
+        if (!scene) {
+            return;
+        }
+        if (change == QGraphicsItem::ItemSceneHasChanged) {
+            scene->m_items.add(item);
+            scene->updateIndexDepth();
+            // A component moved into a block's scene now belongs to that block
+            if (ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item)) {
+                PersistenceManager::instance().adoptMember(component);
+            }
+        }
+        // Wires run between components, so the components alone decide the canvas
+        if (item->type() != SchematicItemType::Wire && !item->parentItem()) {
+            scene->growCanvas(item->sceneBoundingRect());
+        }
+        // The nets around a moved component are laid out again once it comes to rest
+        ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item);
+        if (change == QGraphicsItem::ItemPositionHasChanged && component && scene->m_wireManager) {
+            scene->m_wireManager->invalidateLayout(component->sceneBoundingRect());
+            for (WireGraphicsItem* wire : component->getWires()) {
+                scene->m_wireManager->invalidateLayout(wire->sceneBoundingRect());
+            }
         }
     }
-    return nullptr;
 }
 
-ModuleGraphicsItem* SchematicScene::getModuleAt(const QPointF& pos)
+void SchematicScene::untrackItem(QGraphicsItem* item)
 {
-    QList<QGraphicsItem*> itemsAtPos = items(pos);
-    for (QGraphicsItem* item : itemsAtPos) {
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module && module->isRTLView()) {
-            return module;
+    // Fails while ~QGraphicsScene deletes the items, when the registry is already gone
+    if (SchematicScene* scene = qobject_cast<SchematicScene*>(item->scene())) {
+        scene->m_items.remove(item);
+        if (item->type() != SchematicItemType::Wire) {
+            scene->m_contentBoundsDirty = true;
         }
     }
-    return nullptr;
 }
 
-QPointF SchematicScene::getPortAt(QGraphicsItem* item, const QPointF& scenePos, bool& isInput, bool& isModule)
+QRectF SchematicScene::contentBounds() const
+{
+    if (m_contentBoundsDirty) {
+        m_contentBoundsDirty = false;
+        m_contentBounds = QRectF();
+        for (ReadyComponentGraphicsItem* component : components()) {
+            if (!component->parentItem()) {
+                m_contentBounds |= component->sceneBoundingRect();
+            }
+        }
+        for (BlockGraphicsItem* block : blocks()) {
+            m_contentBounds |= block->sceneBoundingRect();
+        }
+        for (TextGraphicsItem* textItem : texts()) {
+            m_contentBounds |= textItem->sceneBoundingRect();
+        }
+    }
+    return m_contentBounds;
+}
+
+void SchematicScene::growCanvas(const QRectF& itemBounds)
 {
-    ReadyComponentGraphicsItem* readyComp = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-    if (readyComp) {
-        isModule = false;
-        QPointF localPos = readyComp->mapFromScene(scenePos);
-        return readyComp->getPortAt(localPos, isInput);
+    if (itemBounds.isEmpty()) {
+        return;
+    }
+    if (!m_contentBoundsDirty) {
+        m_contentBounds |= itemBounds;
+    }
+    if (m_transactionDepth > 0) {
+        m_pendingCanvasBounds |= itemBounds;  // Grown once, at commit
+        return;
     }
     
-    ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-    if (module && module->isRTLView()) {
-        isModule = true;
-        QPointF localPos = module->mapFromScene(scenePos);
-        return module->getPortAt(localPos, isInput);
+    const QRectF wanted = itemBounds.adjusted(-CANVAS_MARGIN, -CANVAS_MARGIN, CANVAS_MARGIN, CANVAS_MARGIN);
+    if (sceneRect().contains(wanted)) {
+        return;
     }
     
-    return QPointF();
+    // Whole tiles, centred on the origin like the first one, so the rect (and with
+    // it the index) changes once per tile rather than on every step of a drag
+    const QRectF grown = sceneRect() | wanted;
+    const qreal half = CANVAS_TILE / 2;
+    const qreal left = std::floor((grown.left() + half) / CANVAS_TILE) * CANVAS_TILE - half;
+    const qreal top = std::floor((grown.top() + half) / CANVAS_TILE) * CANVAS_TILE - half;
+    const qreal right = std::ceil((grown.right() + half) / CANVAS_TILE) * CANVAS_TILE - half;
+    const qreal bottom = std::ceil((grown.bottom() + half) / CANVAS_TILE) * CANVAS_TILE - half;
+    setSceneRect(QRectF(QPointF(left, top), QPointF(right, bottom)));
+    qDebug() << "🗺️ Canvas grown to" << sceneRect();
 }
 
-void SchematicScene::addWireToItem(QGraphicsItem* item, WireGraphicsItem* wire, bool isModule)
+void SchematicScene::resetCanvas()
 {
-    if (isModule) {
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module) module->addWire(wire);
-    } else {
-        ReadyComponentGraphicsItem* comp = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (comp) comp->addWire(wire);
+    m_contentBounds = QRectF();
+    m_contentBoundsDirty = false;
+    m_pendingCanvasBounds = QRectF();
+    setSceneRect(-CANVAS_TILE / 2, -CANVAS_TILE / 2, CANVAS_TILE, CANVAS_TILE);
+}
+
+void SchematicScene::updateIndexDepth()
+{
+    if (m_transactionDepth > 0) {
+        return;  // Tuned once, at commit
+    }
+    
+    const int count = components().size() + blocks().size() + wires().size() + texts().size();
+    int depth = MIN_BSP_DEPTH;
+    while (depth < MAX_BSP_DEPTH && (count >> depth) > ITEMS_PER_BSP_LEAF) {
+        ++depth;
+    }
+    
+    // Every change rebuilds the index; only shrink once well below the threshold
+    const int current = bspTreeDepth();
+    if (depth > current || depth < current - 1) {
+        setBspTreeDepth(depth);
+        qDebug() << "🗺️ BSP index depth" << depth << "for" << count << "items";
     }
 }
 
-void SchematicScene::removeWireFromItem(QGraphicsItem* item, WireGraphicsItem* wire, bool isModule)
+void SchematicScene::setUndoHistory(UndoHistory* history)
 {
-    if (isModule) {
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module) module->removeWire(wire);
-    } else {
-        ReadyComponentGraphicsItem* comp = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (comp) comp->removeWire(wire);
+    m_undoHistory = history;
+}
+
+UndoHistory* SchematicScene::undoHistory() const
+{
+    return m_undoHistory;
+}
+
+void SchematicScene::pushCommand(QUndoCommand* command)
+{
+    if (m_undoHistory) {
+        m_undoHistory->push(command, this);
+        return;
+    }
+    PersistenceManager::Batch batch;
+    command->redo();
+    delete command;
+}
+
+void SchematicScene::execute(QGraphicsScene* scene, QUndoCommand* command)
+{
+    if (SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene)) {
+        schematicScene->pushCommand(command);
+        return;
+    }
+    PersistenceManager::Batch batch;
+    command->redo();
+    delete command;
+}
+
+void SchematicScene::beginTransaction(const QString& text)
+{
+    if (m_transactionDepth++ > 0) {
+        return;
     }
+    
+    PersistenceManager::instance().beginBatch();
+    m_wireManager->beginUpdate();
+    if (m_undoHistory) {
+        m_undoHistory->beginMacro(text, this);
+    }
+    
+    // One repaint at commit instead of one per item
+    for (QGraphicsView* view : views()) {
+        QWidget* viewport = view->viewport();
+        if (viewport->updatesEnabled()) {
+            viewport->setUpdatesEnabled(false);
+            m_frozenViewports.append(viewport);
+        }
+    }
+    
+    // Removing or adding selected items would signal a selection change per item
+    m_transactionSignalsBlocked = blockSignals(true);
+}
+
+void SchematicScene::commitTransaction()
+{
+    if (m_transactionDepth == 0 || --m_transactionDepth > 0) {
+        return;
+    }
+    
+    blockSignals(m_transactionSignalsBlocked);
+    if (m_undoHistory) {
+        m_undoHistory->endMacro();
+    }
+    m_wireManager->endUpdate();
+    PersistenceManager::instance().endBatch();
+    
+    // Canvas and index catch up with everything the transaction placed
+    if (!m_pendingCanvasBounds.isNull()) {
+        growCanvas(std::exchange(m_pendingCanvasBounds, QRectF()));
+    }
+    updateIndexDepth();
+    
+    for (const QPointer<QWidget>& viewport : std::exchange(m_frozenViewports, {})) {
+        if (viewport) {
+            viewport->setUpdatesEnabled(true);
+        }
+    }
+    
+    emit selectionChanged();
+}
+
+void SchematicScene::beginItemDrag()
+{
+    endItemDrag();
+    
+    // QGraphicsScene drags every selected movable item when one of them is grabbed
+    QGraphicsItem* grabber = mouseGrabberItem();
+    if (!grabber || !grabber->isSelected() || !(grabber->flags() & QGraphicsItem::ItemIsMovable)) {
+        return;
+    }
+    
+    m_dragItems.clear();
+    for (QGraphicsItem* item : selectedItems()) {
+        if (item->flags() & QGraphicsItem::ItemIsMovable) {
+            m_dragItems.append(item);
+        }
+    }
+    m_dragAnchor = grabber;
+    m_dragAnchorGuard = dynamic_cast<QObject*>(grabber);
+    m_dragAnchorPos = grabber->pos();
+    ++m_dragGesture;
+    
+    // Every move of the drag saves positions; write meta.json once, on release
+    m_isDraggingItems = true;
+    PersistenceManager::instance().beginBatch();
+}
+
+void SchematicScene::recordItemDrag()
+{
+    if (!m_isDraggingItems || !m_dragAnchorGuard) {
+        return;
+    }
+    
+    const QPointF delta = m_dragAnchor->pos() - m_dragAnchorPos;
+    if (delta.isNull()) {
+        return;
+    }
+    m_dragAnchorPos = m_dragAnchor->pos();
+    
+    // Moves of one drag merge into a single undo step
+    pushCommand(new MoveItemsCommand(m_dragItems, delta, m_dragGesture));
+}
+
+void SchematicScene::endItemDrag()
+{
+    if (!m_isDraggingItems) {
+        return;
+    }
+    m_isDraggingItems = false;
+    m_dragItems.clear();
+    m_dragAnchor = nullptr;
+    m_dragAnchorGuard = nullptr;
+    m_contentBoundsDirty = true;  // The drag may have pulled items in from the edge
+    PersistenceManager::instance().endBatch();
 }
 
 void SchematicScene::mousePressEvent(QGraphicsSceneMouseEvent* event)
@@ -192,45 +449,35 @@ void SchematicScene::mousePressEvent(QGraphicsSceneMouseEvent* event)
             m_selectionRect->setRect(QRectF(m_selectionStart, m_selectionStart));
             m_selectionRect->show();
             
-            // Clear selection if not holding Ctrl
-            if (!(event->modifiers() & Qt::ControlModifier)) {
+            // Clear selection if not holding Ctrl; with Ctrl the band adds to it
+            const bool additive = event->modifiers().testFlag(Qt::ControlModifier);
+            if (!additive) {
                 clearSelection();
             }
+            m_rubberBand->begin(m_selectionStart, additive);
             
             event->accept();
             return;
         }
         
-        // Try ready component first
-        ReadyComponentGraphicsItem* readyComp = getComponentAt(event->scenePos());
-        ModuleGraphicsItem* module = nullptr;
-        QGraphicsItem* sourceItem = nullptr;
-        bool isModule = false;
-        
-        if (readyComp) {
-            sourceItem = readyComp;
-            isModule = false;
-        } else {
-            module = getModuleAt(event->scenePos());
-            if (module) {
-                sourceItem = module;
-                isModule = true;
-            }
-        }
+        // Modules are ready components too, so one index lookup covers both
+        const PortIndex::Hit hit = m_portIndex->portAt(event->scenePos());
+        ReadyComponentGraphicsItem* readyComp = hit.item;
+        QGraphicsItem* sourceItem = readyComp;
         
         if (sourceItem) {
-            bool isInput;
-            bool itemIsModule;
-            QPointF port = getPortAt(sourceItem, event->scenePos(), isInput, itemIsModule);
+            bool isInput = hit.isInput;
+            bool itemIsModule = false;
+            QPointF port = hit.port;
             
             if (!port.isNull()) {
                 // Check if this port is already connected
                 bool portAlreadyConnected = false;
                 if (itemIsModule) {
-                    ModuleGraphicsItem* mod = dynamic_cast<ModuleGraphicsItem*>(sourceItem);
+                    ModuleGraphicsItem* mod = SchematicItemType::cast<ModuleGraphicsItem*>(sourceItem);
                     portAlreadyConnected = mod && mod->isPortConnected(port, isInput);
                 } else {
-                    ReadyComponentGraphicsItem* comp = dynamic_cast<ReadyComponentGraphicsItem*>(sourceItem);
+                    ReadyComponentGraphicsItem* comp = SchematicItemType::cast<ReadyComponentGraphicsItem*>(sourceItem);
                     portAlreadyConnected = comp && comp->isPortConnected(port, isInput);
                 }
                 
@@ -250,9 +497,7 @@ void SchematicScene::mousePressEvent(QGraphicsSceneMouseEvent* event)
                 m_wireSourceIsInput = isInput;  // Store whether source is input or output
                 
                 // Create temporary wire with source component
-                ReadyComponentGraphicsItem* sourceAsReady = itemIsModule ? 
-                    reinterpret_cast<ReadyComponentGraphicsItem*>(module) : readyComp;
-                m_temporaryWire = new WireGraphicsItem(sourceAsReady, m_wireSourcePort);
+                m_temporaryWire = new WireGraphicsItem(readyComp, m_wireSourcePort);
                 m_temporaryWire->setTemporaryEnd(event->scenePos());
                 addItem(m_temporaryWire);
                 
@@ -263,6 +508,10 @@ void SchematicScene::mousePressEvent(QGraphicsSceneMouseEvent* event)
     }
     
     QGraphicsScene::mousePressEvent(event);
+    
+    if (event->button() == Qt::LeftButton) {
+        beginItemDrag();
+    }
 }
 
 void SchematicScene::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
@@ -277,44 +526,13 @@ void SchematicScene::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
     if (m_isDrawingWire && m_temporaryWire) {
         m_temporaryWire->setTemporaryEnd(event->scenePos());
         
-        // Clear all highlighted ports first (including RTL modules)
-        QList<QGraphicsItem*> allItems = items();
-        for (QGraphicsItem* item : allItems) {
-            ReadyComponentGraphicsItem* comp = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-            if (comp) {
-                comp->clearHighlightedPort();
-            }
-            ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-            if (module) {
-                module->clearHighlightedPort();
-            }
-        }
-        
-        // Check for target - try both ready component and module
-        ReadyComponentGraphicsItem* readyTarget = getComponentAt(event->scenePos());
-        ModuleGraphicsItem* moduleTarget = nullptr;
-        
-        if (!readyTarget) {
-            moduleTarget = getModuleAt(event->scenePos());
-        }
-        
-        // Highlight the target port if valid
-        if (readyTarget && readyTarget != m_wireSourceItem) {
-            bool isInput;
-            bool isModule;
-            QPointF targetPort = getPortAt(readyTarget, event->scenePos(), isInput, isModule);
-            
-            if (!targetPort.isNull() && isInput) {
-                readyTarget->setHighlightedPort(targetPort);
-            }
-        } else if (moduleTarget && moduleTarget != m_wireSourceItem) {
-            bool isInput;
-            bool isModule;
-            QPointF targetPort = getPortAt(moduleTarget, event->scenePos(), isInput, isModule);
-            
-            if (!targetPort.isNull() && isInput) {
-                moduleTarget->setHighlightedPort(targetPort);
-            }
+        // Highlight the input port under the cursor; the previous one is
+        // remembered, so at most two items repaint
+        const PortIndex::Hit hit = m_portIndex->portAt(event->scenePos());
+        if (hit.isValid() && hit.isInput && hit.item != m_wireSourceItem) {
+            highlightPort(hit.item, hit.port);
+        } else {
+            highlightPort(nullptr, QPointF());
         }
         
         event->accept();
@@ -322,6 +540,7 @@ void SchematicScene::mouseMoveEvent(QGraphicsSceneMouseEvent* event)
     }
     
     QGraphicsScene::mouseMoveEvent(event);
+    recordItemDrag();
 }
 
 void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
@@ -330,10 +549,12 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
     if (m_isSelecting && event->button() == Qt::LeftButton) {
         m_isSelecting = false;
         
+        m_rubberBand->finish();
+        
         // Hide selection rectangle with safety check
         if (m_selectionRect) {
             // Check if the selection rectangle is still valid
-            if (items().contains(m_selectionRect)) {
+            if (m_selectionRect->scene() == this) {
                 m_selectionRect->hide();
             } else {
                 qWarning() << "Selection rectangle is no longer in the scene during mouse release";
@@ -348,48 +569,33 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
     }
     
     if (m_isDrawingWire && event->button() == Qt::LeftButton) {
-        // Clear all highlighted ports (including RTL modules)
-        QList<QGraphicsItem*> allItems = items();
-        for (QGraphicsItem* item : allItems) {
-            ReadyComponentGraphicsItem* comp = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-            if (comp) {
-                comp->clearHighlightedPort();
-            }
-            ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-            if (module) {
-                module->clearHighlightedPort();
-            }
-        }
+        highlightPort(nullptr, QPointF());
         
-        // Check for target - try both types
-        ReadyComponentGraphicsItem* readyTarget = getComponentAt(event->scenePos());
+        // Find the target port through the port index
+        const PortIndex::Hit hit = m_portIndex->portAt(event->scenePos());
+        ReadyComponentGraphicsItem* readyTarget = hit.item;
         ModuleGraphicsItem* moduleTarget = nullptr;
         QGraphicsItem* targetItem = nullptr;
         bool targetIsModule = false;
         
         if (readyTarget && readyTarget != m_wireSourceItem) {
             targetItem = readyTarget;
-            targetIsModule = false;
-        } else if (!readyTarget) {
-            moduleTarget = getModuleAt(event->scenePos());
-            if (moduleTarget && moduleTarget != m_wireSourceItem) {
-                targetItem = moduleTarget;
-                targetIsModule = true;
-            }
         }
         
         if (targetItem) {
-            bool isInput;
-            bool itemIsModule;
-            QPointF targetPort = getPortAt(targetItem, event->scenePos(), isInput, itemIsModule);
+            bool isInput = hit.isInput;
+            QPointF targetPort = hit.port;
             
             if (!targetPort.isNull()) {
+                // Connection records and component metadata below reach meta.json in one write
+                PersistenceManager::Batch batch;
+                
                 // Check if this port is already connected
                 bool portAlreadyConnected = false;
                 WireGraphicsItem* existingWire = nullptr;
                 
                 if (targetIsModule) {
-                    ModuleGraphicsItem* mod = dynamic_cast<ModuleGraphicsItem*>(targetItem);
+                    ModuleGraphicsItem* mod = SchematicItemType::cast<ModuleGraphicsItem*>(targetItem);
                     if (mod) {
                         portAlreadyConnected = mod->isPortConnected(targetPort, isInput);
                         if (portAlreadyConnected) {
@@ -397,7 +603,7 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                         }
                     }
                 } else {
-                    ReadyComponentGraphicsItem* comp = dynamic_cast<ReadyComponentGraphicsItem*>(targetItem);
+                    ReadyComponentGraphicsItem* comp = SchematicItemType::cast<ReadyComponentGraphicsItem*>(targetItem);
                     if (comp) {
                         portAlreadyConnected = comp->isPortConnected(targetPort, isInput);
                         if (portAlreadyConnected) {
@@ -408,16 +614,11 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                 
                 // If input port already connected, remove the old wire first
                 // Output ports can have multiple connections (fan-out)
+                // The wire stays alive for undo; the connect command owns it from here
+                QList<WireGraphicsItem*> replacedWires;
                 if (portAlreadyConnected && existingWire && isInput) {
-                    // Remove wire from both source and target
-                    if (existingWire->getSource()) {
-                        existingWire->getSource()->removeWire(existingWire);
-                    }
-                    if (existingWire->getTarget()) {
-                        existingWire->getTarget()->removeWire(existingWire);
-                    }
-                    removeItem(existingWire);
-                    delete existingWire;
+                    ChangeWiresCommand::detach(existingWire);
+                    replacedWires.append(existingWire);
                 }
                 
                 // Valid connection - determine source and target based on port types
@@ -433,8 +634,9 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                     
                     // Create new wire with target as source and source as target
                     m_temporaryWire = new WireGraphicsItem(targetAsReady, targetPort, 
-                                                          reinterpret_cast<ReadyComponentGraphicsItem*>(m_wireSourceItem), 
+                                                          static_cast<ReadyComponentGraphicsItem*>(m_wireSourceItem), 
                                                           m_wireSourcePort);
+                    addItem(m_temporaryWire);
                     
                     // Register wire with swapped components
                     addWireToItem(targetItem, m_temporaryWire, targetIsModule);
@@ -451,6 +653,9 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                     // Same type ports - don't allow connection
                     qDebug() << "Cannot connect" << (m_wireSourceIsInput ? "input" : "output") 
                              << "to" << (isInput ? "input" : "output");
+                    for (WireGraphicsItem* wire : replacedWires) {
+                        ChangeWiresCommand::attach(this, wire);
+                    }
                     removeItem(m_temporaryWire);
                     delete m_temporaryWire;
                     m_temporaryWire = nullptr;
@@ -459,6 +664,17 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                     return;
                 }
                 
+                // Both port widths come from precomputed tables, so this is O(1)
+                if (!checkWireWidth(m_temporaryWire)) {
+                    ReadyComponentGraphicsItem* source = m_temporaryWire->getSource();
+                    ReadyComponentGraphicsItem* target = m_temporaryWire->getTarget();
+                    emit wireWidthMismatch(QString("Width mismatch: %1-bit output of %2 drives %3-bit input of %4")
+                                               .arg(source->getPortWidth(m_temporaryWire->getSourcePort(), false))
+                                               .arg(source->getName())
+                                               .arg(target->getPortWidth(m_temporaryWire->getTargetPort(), true))
+                                               .arg(target->getName()));
+                }
+                
                 // Register wire with the global wire manager for intelligent routing
                 if (m_wireManager) {
                     m_wireManager->registerWire(m_temporaryWire);
@@ -471,19 +687,19 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                 
                 // Get source ID (ready component or RTL module)
                 if (m_wireSourceIsModule) {
-                    ModuleGraphicsItem* sourceModule = dynamic_cast<ModuleGraphicsItem*>(m_wireSourceItem);
+                    ModuleGraphicsItem* sourceModule = SchematicItemType::cast<ModuleGraphicsItem*>(m_wireSourceItem);
                     sourceId = pm.getRTLModuleName(sourceModule);
                 } else {
-                    ReadyComponentGraphicsItem* sourceComp = dynamic_cast<ReadyComponentGraphicsItem*>(m_wireSourceItem);
+                    ReadyComponentGraphicsItem* sourceComp = SchematicItemType::cast<ReadyComponentGraphicsItem*>(m_wireSourceItem);
                     sourceId = pm.getComponentId(sourceComp);
                 }
                 
                 // Get target ID (ready component or RTL module)
                 if (targetIsModule) {
-                    ModuleGraphicsItem* targetModule = dynamic_cast<ModuleGraphicsItem*>(targetItem);
+                    ModuleGraphicsItem* targetModule = SchematicItemType::cast<ModuleGraphicsItem*>(targetItem);
                     targetId = pm.getRTLModuleName(targetModule);
                 } else {
-                    ReadyComponentGraphicsItem* targetComp = dynamic_cast<ReadyComponentGraphicsItem*>(targetItem);
+                    ReadyComponentGraphicsItem* targetComp = SchematicItemType::cast<ReadyComponentGraphicsItem*>(targetItem);
                     targetId = pm.getComponentId(targetComp);
                 }
                 
@@ -599,8 +815,15 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
                     }
                     
                     qDebug() << "🔗 Wire created from" << sourceId << "to" << targetId;
+                } else {
+                    // A block port: the connection is stored against the component inside
+                    m_temporaryWire->saveConnectionToPersistence();
                 }
                 
+                // Already connected above, so recording it only affects undo
+                pushCommand(new ChangeWiresCommand(this, {m_temporaryWire}, replacedWires,
+                                                   replacedWires.isEmpty() ? tr("Connect Wire") : tr("Replace Wire")));
+                
                 m_temporaryWire = nullptr;
                 m_isDrawingWire = false;
                 m_wireSourceItem = nullptr;
@@ -623,6 +846,46 @@ void SchematicScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
     }
     
     QGraphicsScene::mouseReleaseEvent(event);
+    
+    if (event->button() == Qt::LeftButton) {
+        endItemDrag();
+    }
+}
+
+bool SchematicScene::checkWireWidth(WireGraphicsItem* wire)
+{
+    ReadyComponentGraphicsItem* source = wire->getSource();
+    ReadyComponentGraphicsItem* target = wire->getTarget();
+    if (!source || !target) {
+        return true;
+    }
+
+    const bool compatible = PortType::widthsCompatible(source->getPortWidth(wire->getSourcePort(), false),
+                                                       target->getPortWidth(wire->getTargetPort(), true));
+    if (wire->getWireState() != WireGraphicsItem::Locked) {
+        if (!compatible) {
+            wire->setWireState(WireGraphicsItem::Error);
+        } else if (wire->getWireState() == WireGraphicsItem::Error) {
+            wire->setWireState(WireGraphicsItem::Normal);
+        }
+    }
+    return compatible;
+}
+
+int SchematicScene::checkAllWireWidths()
+{
+    if (!m_wireManager) {
+        return 0;
+    }
+
+    int mismatches = 0;
+    for (WireGraphicsItem* wire : m_wireManager->getAllWires()) {
+        if (!checkWireWidth(wire)) {
+            ++mismatches;
+        }
+    }
+    qDebug() << "📏 Width check:" << m_wireManager->getAllWires().size() << "wires |" << mismatches << "mismatches";
+    return mismatches;
 }
 
 void SchematicScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event)
@@ -632,8 +895,15 @@ void SchematicScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event)
         QGraphicsItem* clickedItem = itemAt(event->scenePos(), QTransform());
         
         if (clickedItem) {
+            // A block opens to show its inside
+            if (BlockGraphicsItem* block = SchematicItemType::cast<BlockGraphicsItem*>(clickedItem)) {
+                emit blockOpenRequested(block);
+                event->accept();
+                return;
+            }
+            
             // Check if it's a ready component
-            ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(clickedItem);
+            ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(clickedItem);
             if (component) {
                 // Get component ID and metadata
                 PersistenceManager& pm = PersistenceManager::instance();
@@ -655,25 +925,30 @@ void SchematicScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event)
                             // Update the component properties in the scene
                             ReadyComponentGraphicsItem* comp = pm.getComponentById(id);
                             if (comp) {
+                                const ComponentPropertiesCommand::State before = ComponentPropertiesCommand::State::of(comp);
+                                ComponentPropertiesCommand::State after = before;
+                                
                                 // Update geometry
                                 QJsonObject geometry = meta["geometry"].toObject();
                                 QJsonObject position = geometry["position"].toObject();
                                 QJsonObject size = geometry["size"].toObject();
                                 
-                                comp->setPos(QPointF(position["x"].toDouble(), position["y"].toDouble()));
-                                comp->setSize(size["width"].toDouble(), size["height"].toDouble());
-                                comp->setRotation(geometry["rotation"].toDouble());
+                                after.position = QPointF(position["x"].toDouble(), position["y"].toDouble());
+                                after.size = QSizeF(size["width"].toDouble(), size["height"].toDouble());
+                                after.rotation = geometry["rotation"].toDouble();
                                 
                                 // Update appearance
                                 QJsonObject appearance = meta["appearance"].toObject();
-                                comp->setOpacity(appearance["opacity"].toDouble());
-                                comp->setVisible(appearance["visible"].toBool());
+                                after.opacity = appearance["opacity"].toDouble();
+                                after.visible = appearance["visible"].toBool();
                                 
                                 QString colorStr = appearance["color"].toString();
                                 if (!colorStr.isEmpty() && QColor::isValidColorName(colorStr)) {
-                                    comp->setCustomColor(QColor(colorStr));
+                                    after.color = QColor(colorStr);
                                 }
                                 
+                                // Geometry and appearance are undoable; the rest of the metadata is saved as is
+                                pushCommand(new ComponentPropertiesCommand(comp, before, after, tr("Edit Properties")));
                                 
                                 qDebug() << "Component properties updated for:" << id;
                             }
@@ -690,10 +965,12 @@ void SchematicScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event)
             }
             
             // Check if it's a module
-            ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(clickedItem);
+            ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(clickedItem);
             if (module) {
-                qDebug() << "Double-clicked on module (properties editing not yet implemented)";
-                // TODO: Implement module properties editing
+                qDebug() << "Double-clicked on module, opening definition:" << module->getName();
+                emit moduleDefinitionRequested(module->getName());
+                event->accept();
+                return;
             }
         }
     }
@@ -714,16 +991,30 @@ void SchematicScene::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
         menu.setStyleSheet("QMenu { font-family: 'Tajawal'; font-size: 10pt; }"
                           "QMenu::item:selected { background-color: #637AB9; }");
         
-        // Add "Add Text" action
-        QAction* addTextAction = menu.addAction("Add Text");
-        addTextAction->setToolTip("Add text at this position");
+        // Inside a block, texts stay with the top level; offer the way back instead
+        QAction* addTextAction = nullptr;
+        QAction* leaveBlockAction = nullptr;
+        QAction* autoPlaceAction = menu.addAction("Auto Place");
+        autoPlaceAction->setToolTip("Arrange the components along their signal flow (Ctrl+Shift+L)");
+        autoPlaceAction->setEnabled(!components().isEmpty() || !blocks().isEmpty());
+        if (m_blockName.isEmpty()) {
+            addTextAction = menu.addAction("Add Text");
+            addTextAction->setToolTip("Add text at this position");
+        } else {
+            leaveBlockAction = menu.addAction("Leave Block");
+            leaveBlockAction->setToolTip("Return to the enclosing level (Alt+Up)");
+        }
         
         // Show menu at cursor position
         QAction* selectedAction = menu.exec(event->screenPos());
         
-        if (selectedAction == addTextAction) {
+        if (selectedAction && selectedAction == addTextAction) {
             // Emit signal with the scene position where text should be added
             emit addTextRequested(event->scenePos());
+        } else if (selectedAction && selectedAction == leaveBlockAction) {
+            emit blockExitRequested();
+        } else if (selectedAction && selectedAction == autoPlaceAction) {
+            m_autoPlacement->placeAll();
         }
         
         event->accept();
@@ -736,41 +1027,24 @@ void SchematicScene::contextMenuEvent(QGraphicsSceneContextMenuEvent* event)
 
 void SchematicScene::selectAllItems()
 {
-    // Select all movable/selectable items (components, modules, text items)
-    clearSelection();
-    
-    QList<QGraphicsItem*> allItems = items();
-    int selectedCount = 0;
-    
-    for (QGraphicsItem* item : allItems) {
-        // Select components
-        ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (component) {
-            item->setSelected(true);
-            selectedCount++;
-            continue;
+    // Select all components, modules, blocks and text items; wires are left out to avoid clutter
+    {
+        // One selectionChanged() for the whole selection rather than one per item
+        const QSignalBlocker blocker(this);
+        clearSelection();
+        for (ReadyComponentGraphicsItem* component : components()) {
+            component->setSelected(true);
         }
-        
-        // Select RTL modules
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module && module->isRTLView()) {
-            item->setSelected(true);
-            selectedCount++;
-            continue;
+        for (BlockGraphicsItem* block : blocks()) {
+            block->setSelected(true);
         }
-        
-        // Select text items
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            item->setSelected(true);
-            selectedCount++;
-            continue;
+        for (TextGraphicsItem* textItem : texts()) {
+            textItem->setSelected(true);
         }
-        
-        // Don't select wires in "select all" to avoid clutter
     }
+    emit selectionChanged();
     
-    qDebug() << "Selected" << selectedCount << "items (Ctrl+A)";
+    qDebug() << "Selected" << components().size() + blocks().size() + texts().size() << "items (Ctrl+A)";
 }
 
 void SchematicScene::updateSelectionRect(const QPointF& currentPos)
@@ -780,7 +1054,7 @@ void SchematicScene::updateSelectionRect(const QPointF& currentPos)
     }
     
     // Safety check: ensure the selection rectangle is still valid
-    if (!items().contains(m_selectionRect)) {
+    if (m_selectionRect->scene() != this) {
         qWarning() << "Selection rectangle is no longer in the scene, recreating...";
         m_selectionRect = nullptr;
         return;
@@ -790,16 +1064,14 @@ void SchematicScene::updateSelectionRect(const QPointF& currentPos)
     QRectF rect = QRectF(m_selectionStart, currentPos).normalized();
     m_selectionRect->setRect(rect);
     
-    // Update selection for items within the rectangle
-    QPainterPath selectionPath;
-    selectionPath.addRect(rect);
-    setSelectionArea(selectionPath);
+    // Only the items between the previous and the new rectangle are re-tested
+    m_rubberBand->update(currentPos);
 }
 
 void SchematicScene::cleanupSelectionRectangle()
 {
     if (m_selectionRect) {
-        if (items().contains(m_selectionRect)) {
+        if (m_selectionRect->scene() == this) {
             removeItem(m_selectionRect);
         }
         delete m_selectionRect;
@@ -810,166 +1082,84 @@ void SchematicScene::cleanupSelectionRectangle()
 
 void SchematicScene::deleteSelectedItems()
 {
-    QList<QGraphicsItem*> selected = selectedItems();
-    int deletedCount = 0;
+    const QList<QGraphicsItem*> selected = selectedItems();
+    if (selected.isEmpty()) {
+        return;
+    }
     
-    for (QGraphicsItem* item : selected) {
-        // Check if it's a wire
-        WireGraphicsItem* wire = dynamic_cast<WireGraphicsItem*>(item);
-        if (wire) {
-            // Remove connection from JSON
-            PersistenceManager& pm = PersistenceManager::instance();
-            ReadyComponentGraphicsItem* source = wire->getSource();
-            ReadyComponentGraphicsItem* target = wire->getTarget();
-            
-            if (source && target) {
-                QString sourceId;
-                QString targetId;
-                
-                // Check if source is RTL module
-                ModuleGraphicsItem* sourceModule = dynamic_cast<ModuleGraphicsItem*>(source);
-                if (sourceModule && sourceModule->isRTLView()) {
-                    sourceId = pm.getRTLModuleName(sourceModule);
-                } else {
-                    sourceId = pm.getComponentId(source);
-                }
-                
-                // Check if target is RTL module
-                ModuleGraphicsItem* targetModule = dynamic_cast<ModuleGraphicsItem*>(target);
-                if (targetModule && targetModule->isRTLView()) {
-                    targetId = pm.getRTLModuleName(targetModule);
-                } else {
-                    targetId = pm.getComponentId(target);
-                }
-                
-                if (!sourceId.isEmpty() && !targetId.isEmpty()) {
-                    pm.removeConnection(sourceId, wire->getSourcePort(), targetId, wire->getTargetPort());
-                }
-            }
-            
-            // Notify persistence sync system before deletion
-            
-            // Remove wire from connected components
-            if (wire->getSource()) {
-                wire->getSource()->removeWire(wire);
-            }
-            if (wire->getTarget()) {
-                wire->getTarget()->removeWire(wire);
-            }
-            
-            // Unregister from wire manager
-            if (m_wireManager) {
-                m_wireManager->unregisterWire(wire);
-            }
-            
-            removeItem(wire);
-            delete wire;
-            deletedCount++;
-            continue;
+    Transaction transaction(this, tr("Delete %n Item(s)", nullptr, selected.size()));
+    
+    QList<WireGraphicsItem*> wires;
+    QSet<WireGraphicsItem*> seenWires;
+    QList<ReadyComponentGraphicsItem*> components;
+    QList<BlockGraphicsItem*> deletedBlocks;
+    QList<TextGraphicsItem*> textItems;
+    
+    auto takeWire = [&](WireGraphicsItem* wire) {
+        if (!seenWires.contains(wire)) {
+            seenWires.insert(wire);
+            wires.append(wire);
         }
-        
-        // Check if it's a ready component
-        ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (component) {
-            PersistenceManager& pm = PersistenceManager::instance();
-            
-            // Get all connected wires
-            QList<WireGraphicsItem*> connectedWires = component->getWires();
-            
-            // Remove connected wires from scene and from persistence
-            for (WireGraphicsItem* connectedWire : connectedWires) {
-                // Remove wire from persistence (connections.json)
-                
-                // Remove wire from connected components
-                if (connectedWire->getSource()) {
-                    connectedWire->getSource()->removeWire(connectedWire);
-                }
-                if (connectedWire->getTarget()) {
-                    connectedWire->getTarget()->removeWire(connectedWire);
-                }
-                
-                // Unregister from wire manager
-                if (m_wireManager) {
-                    m_wireManager->unregisterWire(connectedWire);
-                }
-                
-                removeItem(connectedWire);
-                delete connectedWire;
-            }
-            
-            // Check if it's an RTL module
-            ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(component);
-            if (module && module->isRTLView()) {
-                // Remove RTL module placement
-                QString moduleName = pm.getRTLModuleName(module);
-                if (!moduleName.isEmpty()) {
-                    // Notify persistence sync system
-                    
-                    pm.removeRTLModulePlacement(moduleName);
-                    pm.unregisterRTLModule(module);  // Unregister from maps BEFORE deletion
-                    qDebug() << "🗑️ Deleted RTL module:" << moduleName;
-                }
-            } else {
-                // Remove ready component from persistence
-                QString componentId = pm.getComponentId(component);
-                if (!componentId.isEmpty()) {
-                    
-                    pm.deleteComponentFile(componentId, true); // Actually delete files for user deletion
-                    pm.unregisterComponent(component);  // Unregister from maps BEFORE deletion
-                    qDebug() << "🗑️ Deleted component:" << componentId;
-                }
+    };
+    
+    for (QGraphicsItem* item : selected) {
+        if (WireGraphicsItem* wire = SchematicItemType::cast<WireGraphicsItem*>(item)) {
+            takeWire(wire);
+        } else if (BlockGraphicsItem* block = SchematicItemType::cast<BlockGraphicsItem*>(item)) {
+            deletedBlocks.append(block);  // Takes its wires and contents with it
+        } else if (ReadyComponentGraphicsItem* component = SchematicItemType::cast<ReadyComponentGraphicsItem*>(item)) {
+            components.append(component);
+            // A component takes its wires with it
+            for (WireGraphicsItem* connectedWire : component->getWires()) {
+                takeWire(connectedWire);
             }
-            
-            // Remove from scene and delete
-            removeItem(component);
-            delete component;
-            deletedCount++;
-            continue;
-        }
-        
-        // Check if it's a text item
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            // Notify persistence sync system before deletion
-            
-            // Text items can be deleted
-            removeItem(textItem);
-            delete textItem;
-            deletedCount++;
-            continue;
+        } else if (TextGraphicsItem* textItem = SchematicItemType::cast<TextGraphicsItem*>(item)) {
+            textItems.append(textItem);
         }
     }
     
-    if (deletedCount > 0) {
-        qDebug() << "🗑️ Deleted" << deletedCount << "item(s)";
+    // All wires leave in one undoable step, before their components go
+    if (!wires.isEmpty()) {
+        pushCommand(new ChangeWiresCommand(this, {}, wires, tr("Delete %n Wire(s)", nullptr, wires.size())));
+    }
+    
+    // Components, modules and texts follow in a second step, keeping their files until it is dropped
+    QList<QGraphicsItem*> items;
+    for (ReadyComponentGraphicsItem* component : components) {
+        items.append(component);
+    }
+    for (TextGraphicsItem* textItem : textItems) {
+        items.append(textItem);
+    }
+    if (!items.isEmpty()) {
+        pushCommand(new ChangeItemsCommand(this, {}, items, tr("Delete %n Item(s)", nullptr, items.size())));
+    }
+    
+    // Each block goes in a step of its own, keeping what was inside it until the step is dropped
+    for (BlockGraphicsItem* block : deletedBlocks) {
+        SchematicHierarchy::remove(this, block);
     }
+    
+    qDebug() << "🗑️ Deleted" << wires.size() << "wire(s)," << components.size() << "component(s),"
+             << deletedBlocks.size() << "block(s) and" << textItems.size() << "text item(s)";
 }
 
 void SchematicScene::copySelectedItems()
 {
-    // Clear clipboard
-    m_clipboard.clear();
-    
-    QList<QGraphicsItem*> selected = selectedItems();
-    int copiedCount = 0;
-    
-    for (QGraphicsItem* item : selected) {
-        // Copy text items
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            m_clipboard.append(item);
-            copiedCount++;
-        }
-        
-        // Note: Components and modules are references to actual code,
-        // so we don't copy them - they can be dragged from the list instead
+    const QByteArray payload = SchematicClipboard::serialize(selectedItems());
+    if (payload.isEmpty()) {
+        qDebug() << "📋 Nothing to copy";
+        return;
     }
     
-    qDebug() << "📋 Copied" << copiedCount << "item(s) to clipboard";
+    SchematicClipboard::copyToClipboard(payload);
+    m_pasteCount = 0;
+    qDebug() << "📋 Copied selection to clipboard," << payload.size() << "bytes";
 }
 
 void SchematicScene::cutSelectedItems()
 {
+    Transaction transaction(this, tr("Cut"));
     copySelectedItems();
     deleteSelectedItems();
     qDebug() << "✂️ Cut selected items";
@@ -977,54 +1167,70 @@ void SchematicScene::cutSelectedItems()
 
 void SchematicScene::pasteItems()
 {
-    if (m_clipboard.isEmpty()) {
+    const QByteArray payload = SchematicClipboard::clipboardPayload();
+    if (payload.isEmpty()) {
         qDebug() << "📋 Clipboard is empty";
         return;
     }
     
-    clearSelection();
-    int pastedCount = 0;
-    QPointF offset(50, 50); // Offset pasted items so they don't overlap originals
-    
-    for (QGraphicsItem* item : m_clipboard) {
-        // Paste text items
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            TextGraphicsItem* newText = new TextGraphicsItem(textItem->getText());
-            newText->setPos(textItem->pos() + offset);
-            newText->setTextColor(textItem->getTextColor());
-            newText->setTextFont(textItem->getTextFont());
-            addItem(newText);
-            newText->setSelected(true);
-            pastedCount++;
+    // Each paste lands a step further from the originals
+    ++m_pasteCount;
+    SchematicClipboard::paste(this, payload, QPointF(PASTE_OFFSET, PASTE_OFFSET) * m_pasteCount);
+}
+
+void SchematicScene::duplicateSelectedItems()
+{
+    const QByteArray payload = SchematicClipboard::serialize(selectedItems());
+    if (payload.isEmpty()) {
+        return;
+    }
+    SchematicClipboard::paste(this, payload, QPointF(PASTE_OFFSET, PASTE_OFFSET));
+}
+
+BlockGraphicsItem* SchematicScene::blockItem(const QString& name) const
+{
+    for (BlockGraphicsItem* block : blocks()) {
+        if (block->blockName() == name) {
+            return block;
         }
     }
-    
-    qDebug() << "📄 Pasted" << pastedCount << "item(s)";
+    return nullptr;
 }
 
-void SchematicScene::duplicateSelectedItems()
+void SchematicScene::expandBlock(const QString& name)
 {
-    QList<QGraphicsItem*> selected = selectedItems();
-    clearSelection();
-    int duplicatedCount = 0;
-    QPointF offset(50, 50); // Offset duplicated items
-    
-    for (QGraphicsItem* item : selected) {
-        // Duplicate text items
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            TextGraphicsItem* newText = new TextGraphicsItem(textItem->getText());
-            newText->setPos(textItem->pos() + offset);
-            newText->setTextColor(textItem->getTextColor());
-            newText->setTextFont(textItem->getTextFont());
-            addItem(newText);
-            newText->setSelected(true);
-            duplicatedCount++;
+    if (BlockGraphicsItem* block = blockItem(name)) {
+        endItemDrag();
+        SchematicHierarchy::expand(this, block);
+    }
+}
+
+void SchematicScene::collapseSelectedItems()
+{
+    endItemDrag();
+    if (!SchematicHierarchy::collapse(this, selectedItems())) {
+        qDebug() << "📦 Nothing to collapse";
+    }
+}
+
+void SchematicScene::expandSelectedBlocks()
+{
+    QList<BlockGraphicsItem*> selectedBlocks;
+    for (QGraphicsItem* item : selectedItems()) {
+        if (BlockGraphicsItem* block = SchematicItemType::cast<BlockGraphicsItem*>(item)) {
+            selectedBlocks.append(block);
         }
     }
+    if (selectedBlocks.isEmpty()) {
+        return;
+    }
     
-    qDebug() << "📑 Duplicated" << duplicatedCount << "item(s)";
+    // Expanded blocks stay alive in the history, so the rest of the list stays valid
+    endItemDrag();
+    Transaction transaction(this, tr("Expand %n Block(s)", nullptr, selectedBlocks.size()));
+    for (BlockGraphicsItem* block : selectedBlocks) {
+        SchematicHierarchy::expand(this, block);
+    }
 }
 
 void SchematicScene::keyPressEvent(QKeyEvent* event)
@@ -1064,6 +1270,34 @@ void SchematicScene::keyPressEvent(QKeyEvent* event)
         return;
     }
     
+    // Ctrl+Shift+G: Expand the selected blocks
+    if (event->key() == Qt::Key_G && (event->modifiers() & Qt::ControlModifier) && (event->modifiers() & Qt::ShiftModifier)) {
+        expandSelectedBlocks();
+        event->accept();
+        return;
+    }
+    
+    // Ctrl+G: Collapse the selection into a block
+    if (event->key() == Qt::Key_G && (event->modifiers() & Qt::ControlModifier)) {
+        collapseSelectedItems();
+        event->accept();
+        return;
+    }
+    
+    // Ctrl+Shift+L: Auto place everything
+    if (event->key() == Qt::Key_L && (event->modifiers() & Qt::ControlModifier) && (event->modifiers() & Qt::ShiftModifier)) {
+        m_autoPlacement->placeAll();
+        event->accept();
+        return;
+    }
+    
+    // Alt+Up: Leave the block
+    if (event->key() == Qt::Key_Up && (event->modifiers() & Qt::AltModifier) && !m_blockName.isEmpty()) {
+        emit blockExitRequested();
+        event->accept();
+        return;
+    }
+    
     // Delete or Backspace: Delete selected items
     if (event->key() == Qt::Key_Delete || event->key() == Qt::Key_Backspace) {
         deleteSelectedItems();
@@ -1080,70 +1314,64 @@ void SchematicScene::clearSceneWithPersistenceCleanup()
 {
     qDebug() << "🧹 Clearing scene with persistence cleanup...";
     
+    // Recorded edits refer to the items about to go
+    endItemDrag();
+    if (m_undoHistory) {
+        m_undoHistory->clear();
+    }
+    
     // Clean up selection rectangle before clearing scene
     cleanupSelectionRectangle();
     
-    // Get all items before clearing
-    QList<QGraphicsItem*> allItems = items();
+    // The wires are about to be deleted with the scene's items
+    m_wireManager->clear();
     
     // Safety check: if no items, just clear and return
-    if (allItems.isEmpty()) {
+    if (items().isEmpty()) {
         qDebug() << "🧹 No items to clear, scene already empty";
         clear();
+        resetCanvas();
         return;
     }
     
     PersistenceManager& pm = PersistenceManager::instance();
     
-    // Process each item for proper cleanup
-    for (QGraphicsItem* item : allItems) {
-        // Handle ready components
-        ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (component) {
-            QString componentId = pm.getComponentId(component);
-            if (!componentId.isEmpty()) {
-                // NOTIFY: We do NOT call onComponentDeleted here to prevent clearing persistence files
-                // when switching projects. The component cleanup is handled by the new project loading.
-                
-                // Only unregister from internal maps, don't delete files
-                pm.unregisterComponent(component);
-                qDebug() << "🔧 Unregistered component:" << componentId << "(files preserved)";
-            }
-        }
-        
-        // Handle RTL modules
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module && module->isRTLView()) {
-            QString moduleName = pm.getRTLModuleName(module);
-            if (!moduleName.isEmpty()) {
-                // NOTIFY: We do NOT call onRTLModuleDeleted here to prevent clearing persistence files
-                // when switching projects. The module cleanup is handled by the new project loading.
-                
-                // Only unregister from internal maps, don't delete files
-                pm.unregisterRTLModule(module);
-                qDebug() << "🔧 Unregistered RTL module:" << moduleName << "(files preserved)";
-            }
+    // Handle ready components
+    for (ReadyComponentGraphicsItem* component : components()) {
+        QString componentId = pm.getComponentId(component);
+        if (!componentId.isEmpty()) {
+            // NOTIFY: We do NOT call onComponentDeleted here to prevent clearing persistence files
+            // when switching projects. The component cleanup is handled by the new project loading.
+            
+            // Only unregister from internal maps, don't delete files
+            pm.unregisterComponent(component);
+            qDebug() << "🔧 Unregistered component:" << componentId << "(files preserved)";
         }
-        
-        // Handle wires
-        WireGraphicsItem* wire = dynamic_cast<WireGraphicsItem*>(item);
-        if (wire) {
-            // NOTIFY: We do NOT call onWireDeleted here to prevent clearing persistence files
-            // when switching projects. The wire cleanup is handled by the new project loading.
-            qDebug() << "🔧 Wire removed from scene (persistence preserved)";
+    }
+    
+    // Handle RTL modules
+    for (ModuleGraphicsItem* module : modules()) {
+        if (!module->isRTLView()) {
+            continue;
         }
-        
-        // Handle text items
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            // NOTIFY: We do NOT call onTextItemDeleted here to prevent clearing persistence files
-            // when switching projects. The text item cleanup is handled by the new project loading.
-            qDebug() << "🔧 Text item removed from scene (persistence preserved)";
+        QString moduleName = pm.getRTLModuleName(module);
+        if (!moduleName.isEmpty()) {
+            // NOTIFY: We do NOT call onRTLModuleDeleted here to prevent clearing persistence files
+            // when switching projects. The module cleanup is handled by the new project loading.
+            
+            // Only unregister from internal maps, don't delete files
+            pm.unregisterRTLModule(module);
+            qDebug() << "🔧 Unregistered RTL module:" << moduleName << "(files preserved)";
         }
     }
     
+    // NOTIFY: We do NOT call onWireDeleted or onTextItemDeleted here to prevent clearing persistence
+    // files when switching projects. Their cleanup is handled by the new project loading.
+    qDebug() << "🔧" << wires().size() << "wire(s) and" << texts().size() << "text item(s) removed from scene (persistence preserved)";
+    
     // Clear all items from the scene
     clear();
+    resetCanvas();
     
     
     qDebug() << "✅ Scene cleared with persistence cleanup completed (files preserved)";
@@ -1153,59 +1381,51 @@ void SchematicScene::clearSceneWithExplicitDeletion()
 {
     qDebug() << "🧹 Clearing scene with explicit deletion...";
     
+    // Recorded edits refer to the items about to go
+    endItemDrag();
+    if (m_undoHistory) {
+        m_undoHistory->clear();
+    }
+    
     // Clean up selection rectangle before clearing scene
     cleanupSelectionRectangle();
     
-    // Get all items before clearing
-    QList<QGraphicsItem*> allItems = items();
     PersistenceManager& pm = PersistenceManager::instance();
+    m_wireManager->clear();
     
-    // Process each item for proper cleanup with explicit deletion
-    for (QGraphicsItem* item : allItems) {
-        // Handle ready components
-        ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (component) {
-            QString componentId = pm.getComponentId(component);
-            if (!componentId.isEmpty()) {
-                // Notify persistence sync system for explicit deletion
-                
-                // Delete component file
-                pm.deleteComponentFile(componentId, true); // Actually delete files for explicit deletion
-                pm.unregisterComponent(component);
-                qDebug() << "🗑️ Explicitly deleted component:" << componentId;
-            }
-        }
-        
-        // Handle RTL modules
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module && module->isRTLView()) {
-            QString moduleName = pm.getRTLModuleName(module);
-            if (!moduleName.isEmpty()) {
-                
-                // Remove RTL module placement
-                pm.removeRTLModulePlacement(moduleName);
-                pm.unregisterRTLModule(module);
-                qDebug() << "🗑️ Explicitly deleted RTL module:" << moduleName;
-            }
+    // Every deletion below rewrites meta.json; write it once
+    PersistenceManager::Batch batch;
+    
+    // Handle ready components
+    for (ReadyComponentGraphicsItem* component : components()) {
+        QString componentId = pm.getComponentId(component);
+        if (!componentId.isEmpty()) {
+            // Delete component file
+            pm.deleteComponentFile(componentId, true); // Actually delete files for explicit deletion
+            pm.unregisterComponent(component);
+            qDebug() << "🗑️ Explicitly deleted component:" << componentId;
         }
-        
-        // Handle wires
-        WireGraphicsItem* wire = dynamic_cast<WireGraphicsItem*>(item);
-        if (wire) {
-            // Notify persistence sync system for explicit deletion
-            qDebug() << "🗑️ Explicitly deleted wire";
+    }
+    
+    // Handle RTL modules
+    for (ModuleGraphicsItem* module : modules()) {
+        if (!module->isRTLView()) {
+            continue;
         }
-        
-        // Handle text items
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            // Notify persistence sync system for explicit deletion
-            qDebug() << "🗑️ Explicitly deleted text item";
+        QString moduleName = pm.getRTLModuleName(module);
+        if (!moduleName.isEmpty()) {
+            // Remove RTL module placement
+            pm.removeRTLModulePlacement(moduleName);
+            pm.unregisterRTLModule(module);
+            qDebug() << "🗑️ Explicitly deleted RTL module:" << moduleName;
         }
     }
     
+    qDebug() << "🗑️ Explicitly deleted" << wires().size() << "wire(s) and" << texts().size() << "text item(s)";
+    
     // Clear all items from the scene
     clear();
+    resetCanvas();
     
     
     qDebug() << "✅ Scene cleared with explicit deletion completed";
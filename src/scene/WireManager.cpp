@@ -1,11 +1,83 @@
 // WireManager.cpp
 #include "scene/WireManager.h"
 #include "graphics/wire/WireGraphicsItem.h"
+#include "graphics/ReadyComponentGraphicsItem.h"
+#include "graphics/SchematicItemTypes.h"
 #include <QGraphicsScene>
+#include <QTimer>
 #include <QtMath>
 #include <QDebug>
 #include <QPainterPath>
 #include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// Costs of the net layout: a crossing outweighs any amount of detour, and
+// running alongside another net outweighs keeping to the centre line
+constexpr qreal CROSSING_COST = 1000.0;
+constexpr qreal OVERLAP_COST = 10.0;      // Per pixel run closer than the wire spacing
+constexpr int MAX_DIRTY_REGIONS = 32;
+
+QVector<QLineF> pathSegments(const QPainterPath& path)
+{
+    QVector<QLineF> segments;
+    for (const QPolygonF& polygon : path.toSubpathPolygons()) {
+        for (int i = 1; i < polygon.size(); ++i) {
+            if (polygon.at(i - 1) != polygon.at(i)) {
+                segments.append(QLineF(polygon.at(i - 1), polygon.at(i)));
+            }
+        }
+    }
+    return segments;
+}
+
+bool isEnd(const QLineF& segment, const QPointF& point)
+{
+    return QLineF(segment.p1(), point).length() < 1.0 || QLineF(segment.p2(), point).length() < 1.0;
+}
+
+// Wires leaving the same output port are one net; they share their first run
+bool sameNet(WireGraphicsItem* a, WireGraphicsItem* b)
+{
+    return a->getSource() == b->getSource() && a->getSourcePort() == b->getSourcePort();
+}
+
+qreal netCost(const QVector<QLineF>& wire, const QVector<QLineF>& other, qreal spacing)
+{
+    qreal cost = 0.0;
+    for (const QLineF& a : wire) {
+        for (const QLineF& b : other) {
+            QPointF at;
+            if (a.intersects(b, &at) == QLineF::BoundedIntersection) {
+                // Ends meeting is a shared port; a bend on the other wire would read as a junction
+                if (!isEnd(a, at) || !isEnd(b, at)) {
+                    cost += CROSSING_COST;
+                }
+                continue;
+            }
+            // Parallel runs closer than the spacing blur into one
+            const bool horizontal = qAbs(a.dy()) < 0.5 && qAbs(b.dy()) < 0.5;
+            const bool vertical = qAbs(a.dx()) < 0.5 && qAbs(b.dx()) < 0.5;
+            if (horizontal && qAbs(a.y1() - b.y1()) < spacing) {
+                cost += OVERLAP_COST * qMax(0.0, qMin(qMax(a.x1(), a.x2()), qMax(b.x1(), b.x2()))
+                                                 - qMax(qMin(a.x1(), a.x2()), qMin(b.x1(), b.x2())));
+            } else if (vertical && qAbs(a.x1() - b.x1()) < spacing) {
+                cost += OVERLAP_COST * qMax(0.0, qMin(qMax(a.y1(), a.y2()), qMax(b.y1(), b.y2()))
+                                                 - qMax(qMin(a.y1(), a.y2()), qMin(b.y1(), b.y2())));
+            }
+        }
+    }
+    return cost;
+}
+
+qreal area(const QRectF& rect)
+{
+    return rect.isValid() ? rect.width() * rect.height() : 0.0;
+}
+
+} // namespace
 
 WireManager::WireManager(QGraphicsScene* scene, QObject* parent)
     : QObject(parent)
@@ -14,6 +86,10 @@ WireManager::WireManager(QGraphicsScene* scene, QObject* parent)
     , m_bundlingEnabled(true)
     , m_wireSpacing(DEFAULT_WIRE_SPACING)
 {
+    m_layoutTimer = new QTimer(this);
+    m_layoutTimer->setSingleShot(true);
+    m_layoutTimer->setInterval(LAYOUT_DELAY_MS);
+    connect(m_layoutTimer, &QTimer::timeout, this, &WireManager::layoutDirtyNets);
 }
 
 WireManager::~WireManager()
@@ -22,12 +98,29 @@ WireManager::~WireManager()
 
 void WireManager::registerWire(WireGraphicsItem* wire)
 {
-    if (!wire || m_wires.contains(wire)) {
+    if (!wire) {
+        return;
+    }
+    
+    // Removed earlier in the same update: the list entry is still there
+    if (m_pendingRemovals.remove(wire)) {
+        m_wireSet.insert(wire);
+        return;
+    }
+    if (m_wireSet.contains(wire)) {
         return;
     }
     
     m_wires.append(wire);
-    qDebug() << "WireManager: Registered wire, total wires:" << m_wires.size();
+    m_wireSet.insert(wire);
+    invalidateLayout(wire->sceneBoundingRect());
+    
+    if (m_updateDepth > 0) {
+        m_pendingRoutes.append(wire);
+        return;
+    }
+    
+    qDebug() << "WireManager: Registered wire, total wires:" << m_wireSet.size();
     
     if (m_autoRoutingEnabled) {
         optimizeWireRoute(wire);
@@ -38,10 +131,83 @@ void WireManager::registerWire(WireGraphicsItem* wire)
 
 void WireManager::unregisterWire(WireGraphicsItem* wire)
 {
+    if (!m_wireSet.remove(wire)) {
+        return;
+    }
+    invalidateLayout(wire->sceneBoundingRect());   // The nets beside it may close up
+    
+    if (m_updateDepth > 0) {
+        m_pendingRemovals.insert(wire);
+        return;
+    }
+    
     m_wires.removeAll(wire);
     qDebug() << "WireManager: Unregistered wire, remaining wires:" << m_wires.size();
 }
 
+QList<WireGraphicsItem*> WireManager::getAllWires() const
+{
+    return wires();
+}
+
+const QList<WireGraphicsItem*>& WireManager::wires() const
+{
+    // Removals are applied in one pass the first time anything looks at the list
+    if (!m_pendingRemovals.isEmpty()) {
+        m_wires.erase(std::remove_if(m_wires.begin(), m_wires.end(),
+                                     [this](WireGraphicsItem* wire) { return m_pendingRemovals.contains(wire); }),
+                      m_wires.end());
+        m_pendingRemovals.clear();
+    }
+    return m_wires;
+}
+
+void WireManager::clear()
+{
+    m_wires.clear();
+    m_wireSet.clear();
+    m_pendingRemovals.clear();
+    m_pendingRoutes.clear();
+    m_dirtyRegions.clear();
+    m_layoutTimer->stop();
+}
+
+void WireManager::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void WireManager::endUpdate()
+{
+    if (m_updateDepth == 0 || --m_updateDepth > 0) {
+        return;
+    }
+    
+    const int removed = m_pendingRemovals.size();
+    wires();
+    const QList<WireGraphicsItem*> routes = std::exchange(m_pendingRoutes, {});
+    
+    int added = 0;
+    for (WireGraphicsItem* wire : routes) {
+        // Skip wires registered and unregistered again within the update
+        if (!m_wireSet.contains(wire)) {
+            continue;
+        }
+        ++added;
+        if (m_autoRoutingEnabled) {
+            optimizeWireRoute(wire);
+        }
+    }
+    
+    if (added > 0 || removed > 0) {
+        qDebug() << "WireManager: Registered" << added << "and unregistered" << removed
+                 << "wire(s), total wires:" << m_wireSet.size();
+    }
+    if (added > 0) {
+        emit wireRoutesOptimized();
+    }
+}
+
 void WireManager::optimizeAllWireRoutes()
 {
     if (!m_autoRoutingEnabled) {
@@ -50,14 +216,10 @@ void WireManager::optimizeAllWireRoutes()
     
     qDebug() << "WireManager: Optimizing all wire routes...";
     
-    // Apply wire spacing to prevent overlaps
+    // Spread the wires over tracks with the fewest crossings; this also keeps
+    // parallel runs apart, which bundling's fixed offsets would undo
     applyWireSpacing();
     
-    // Bundle parallel wires if enabled
-    if (m_bundlingEnabled) {
-        bundleParallelWires();
-    }
-    
     // Update z-order for better visibility
     updateWireZOrder();
     
@@ -137,7 +299,7 @@ QList<QPointF> WireManager::calculateOptimalRoute(const QPointF& start, const QP
 
 bool WireManager::checkWireCollision(const QPointF& point, qreal radius, WireGraphicsItem* excludeWire) const
 {
-    for (WireGraphicsItem* wire : m_wires) {
+    for (WireGraphicsItem* wire : wires()) {
         if (wire == excludeWire) {
             continue;
         }
@@ -154,7 +316,7 @@ QList<WireGraphicsItem*> WireManager::getWiresNearPoint(const QPointF& point, qr
 {
     QList<WireGraphicsItem*> nearWires;
     
-    for (WireGraphicsItem* wire : m_wires) {
+    for (WireGraphicsItem* wire : wires()) {
         qreal distance = distanceToWire(point, wire);
         if (distance < radius) {
             nearWires.append(wire);
@@ -197,34 +359,216 @@ void WireManager::applyWireSpacing()
 {
     qDebug() << "WireManager: Applying wire spacing...";
     
-    // Group wires by their general routing paths
-    QMap<int, QList<WireGraphicsItem*>> routeGroups;
+    m_dirtyRegions.clear();
+    m_layoutTimer->stop();
+    layoutNets(wires().toVector());
+}
+
+void WireManager::invalidateLayout(const QRectF& region)
+{
+    if (!region.isValid()) {
+        return;
+    }
     
-    for (WireGraphicsItem* wire : m_wires) {
-        QPointF start = wire->getSourceScenePos();
-        QPointF end = wire->getTargetScenePos();
-        
-        // Create a routing key based on general direction
-        int routeKey = qRound(start.x() / 50) * 1000 + qRound(start.y() / 50);
-        routeGroups[routeKey].append(wire);
+    // Edits close together share a region, so a drag keeps growing one
+    auto merged = std::find_if(m_dirtyRegions.begin(), m_dirtyRegions.end(),
+                               [&region](const QRectF& dirty) { return dirty.intersects(region); });
+    if (merged != m_dirtyRegions.end()) {
+        *merged |= region;
+    } else if (m_dirtyRegions.size() < MAX_DIRTY_REGIONS) {
+        m_dirtyRegions.append(region);
+    } else {
+        for (const QRectF& dirty : std::as_const(m_dirtyRegions)) {
+            m_dirtyRegions.first() |= dirty;
+        }
+        m_dirtyRegions.first() |= region;
+        m_dirtyRegions.erase(m_dirtyRegions.begin() + 1, m_dirtyRegions.end());
+    }
+    m_layoutTimer->start();
+}
+
+void WireManager::layoutDirtyNets()
+{
+    const QList<QRectF> regions = std::exchange(m_dirtyRegions, {});
+    QVector<WireGraphicsItem*> dirty;
+    QSet<WireGraphicsItem*> seen;
+    for (const QRectF& region : regions) {
+        const qreal margin = LAYOUT_NEIGHBOURHOOD;
+        for (WireGraphicsItem* wire : wiresIn(region.adjusted(-margin, -margin, margin, margin))) {
+            if (!seen.contains(wire)) {
+                seen.insert(wire);
+                dirty.append(wire);
+            }
+        }
+    }
+    layoutNets(dirty);
+}
+
+void WireManager::layoutNets(QVector<WireGraphicsItem*> batch)
+{
+    if (batch.isEmpty()) {
+        return;
+    }
+    
+    // Long wires first: they cross the most and have the widest choice of tracks
+    auto length = [](WireGraphicsItem* wire) {
+        return QLineF(wire->getSourceScenePos(), wire->getTargetScenePos()).length();
+    };
+    std::stable_sort(batch.begin(), batch.end(), [&length](WireGraphicsItem* a, WireGraphicsItem* b) {
+        return length(a) > length(b);
+    });
+    
+    // A second pass lets the long wires move out of the way of the short ones placed after them
+    int moved = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (WireGraphicsItem* wire : std::as_const(batch)) {
+            if (isAutoRouted(wire) && assignChannel(wire)) {
+                ++moved;
+            }
+        }
+    }
+    
+    // Labels last, on the final paths; short wires first, they have the fewest spots
+    int labelled = 0;
+    for (auto it = batch.crbegin(); it != batch.crend(); ++it) {
+        if ((*it)->isLabelVisible() && !(*it)->getLabel().isEmpty()) {
+            placeLabel(*it);
+            ++labelled;
+        }
+    }
+    
+    qDebug() << "WireManager: Laid out" << batch.size() << "wire(s)," << moved << "track change(s),"
+             << labelled << "label(s)";
+    if (moved > 0) {
+        emit wireRoutesOptimized();
+    }
+}
+
+bool WireManager::isAutoRouted(WireGraphicsItem* wire) const
+{
+    if (!wire->getSource() || !wire->getTarget() || wire->isLocked()
+        || wire->getRoutingMode() != WirePathBuilder::Orthogonal || !wire->getControlPoints().isEmpty()) {
+        return false;
+    }
+    // Saved with the wire, so an offset dragged by hand stays the user's across reloads and pastes
+    return !wire->hasManualOffset();
+}
+
+bool WireManager::assignChannel(WireGraphicsItem* wire)
+{
+    const QPointF start = wire->getSourceScenePos();
+    const QPointF end = wire->getTargetScenePos();
+    const qreal dx = end.x() - start.x();
+    
+    // Wires with room between their ends slide a vertical middle segment, which
+    // must stay clear of the ports; the others a horizontal one, which is free
+    qreal low = -MAX_TRACKS * m_wireSpacing;
+    qreal high = MAX_TRACKS * m_wireSpacing;
+    if (qAbs(dx) > WirePathBuilder::PORT_SPACING * 2.0) {
+        const qreal room = qAbs(dx) / 2.0 - WirePathBuilder::PORT_SPACING;
+        low = qMax(low, -room);
+        high = qMin(high, room);
+    }
+    
+    const QPainterPath centreLine = WirePathBuilder::createOrthogonalPath(start, end, 0.0);
+    const qreal reach = MAX_TRACKS * m_wireSpacing;
+    QVector<QVector<QLineF>> others;
+    for (WireGraphicsItem* other : wiresIn(centreLine.boundingRect().adjusted(-reach, -reach, reach, reach), wire)) {
+        if (!sameNet(wire, other)) {
+            others.append(pathSegments(other->path()));
+        }
     }
     
-    // Apply spacing within each group
-    for (const QList<WireGraphicsItem*>& group : routeGroups) {
-        if (group.size() < 2) {
+    const qreal current = wire->getOrthogonalOffset();
+    qreal bestOffset = current;
+    qreal bestCost = std::numeric_limits<qreal>::max();
+    for (int track = -MAX_TRACKS; track <= MAX_TRACKS; ++track) {
+        const qreal offset = track * m_wireSpacing;
+        if (offset < low || offset > high) {
             continue;
         }
+        const QVector<QLineF> segments = pathSegments(WirePathBuilder::createOrthogonalPath(start, end, offset));
+        qreal cost = qAbs(offset);
+        for (const QVector<QLineF>& other : std::as_const(others)) {
+            cost += netCost(segments, other, m_wireSpacing);
+            if (cost >= bestCost) {
+                break;
+            }
+        }
+        // Ties keep the track the wire is on, so a pass does not shuffle wires for nothing
+        if (cost < bestCost || (cost == bestCost && offset == current)) {
+            bestCost = cost;
+            bestOffset = offset;
+        }
+    }
+    
+    if (bestOffset == current) {
+        return false;
+    }
+    wire->setOrthogonalOffset(bestOffset);
+    return true;
+}
+
+void WireManager::placeLabel(WireGraphicsItem* wire)
+{
+    const QPainterPath path = wire->path();
+    const qreal total = path.length();
+    const QSizeF size = wire->getLabelSize();
+    if (total <= 0.0 || size.isEmpty()) {
+        return;
+    }
+    
+    // The middle of every segment, and the quarter points of the whole path
+    QVector<qreal> anchors{0.5, 0.25, 0.75};
+    qreal travelled = 0.0;
+    for (const QLineF& segment : pathSegments(path)) {
+        anchors.append(path.percentAtLength(travelled + segment.length() / 2.0));
+        travelled += segment.length();
+    }
+    
+    qreal bestAnchor = wire->getLabelAnchor();
+    qreal bestCost = std::numeric_limits<qreal>::max();
+    for (qreal anchor : std::as_const(anchors)) {
+        const QRectF rect(path.pointAtPercent(anchor) - QPointF(size.width() / 2.0, size.height() / 2.0), size);
         
-        // Apply vertical offset to wires in the same group
-        for (int i = 0; i < group.size(); ++i) {
-            qreal offset = (i - group.size() / 2.0) * m_wireSpacing;
-            // Store offset for use during rendering
-            // This would be applied through wire's orthogonal offset
-            if (group[i]) {
-                group[i]->setOrthogonalOffset(offset);
+        // Covering another label or a component hides text; crossing a wire only clutters
+        qreal cost = qAbs(anchor - 0.5);
+        for (QGraphicsItem* item : m_scene->items(rect, Qt::IntersectsItemBoundingRect)) {
+            if (item == wire || item->parentItem() == wire) {
+                continue;
+            }
+            if (item->type() == SchematicItemType::Wire) {
+                cost += 1.0;
+            } else if (SchematicItemType::isComponent(item->type())) {
+                cost += CROSSING_COST;
+            } else if (item->type() == QGraphicsTextItem::Type || item->type() == SchematicItemType::Text) {
+                cost += CROSSING_COST + area(rect & item->sceneBoundingRect());
             }
         }
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestAnchor = anchor;
+        }
+    }
+    
+    if (bestAnchor != wire->getLabelAnchor()) {
+        wire->setLabelAnchor(bestAnchor);
+    }
+}
+
+QVector<WireGraphicsItem*> WireManager::wiresIn(const QRectF& region, WireGraphicsItem* exclude) const
+{
+    QVector<WireGraphicsItem*> found;
+    if (!m_scene) {
+        return found;
+    }
+    for (QGraphicsItem* item : m_scene->items(region, Qt::IntersectsItemBoundingRect)) {
+        WireGraphicsItem* wire = qgraphicsitem_cast<WireGraphicsItem*>(item);
+        if (wire && wire != exclude && m_wireSet.contains(wire)) {
+            found.append(wire);
+        }
     }
+    return found;
 }
 
 void WireManager::bundleParallelWires()
@@ -245,7 +589,7 @@ QList<WireManager::WireBundle> WireManager::identifyBundles() const
     QList<WireBundle> bundles;
     QSet<WireGraphicsItem*> processedWires;
     
-    for (WireGraphicsItem* wire : m_wires) {
+    for (WireGraphicsItem* wire : wires()) {
         if (processedWires.contains(wire)) {
             continue;
         }
@@ -257,7 +601,7 @@ QList<WireManager::WireBundle> WireManager::identifyBundles() const
         bundle.isParallel = false;
         
         // Find parallel wires
-        for (WireGraphicsItem* other : m_wires) {
+        for (WireGraphicsItem* other : wires()) {
             if (other == wire || processedWires.contains(other)) {
                 continue;
             }
@@ -323,7 +667,7 @@ void WireManager::applyBundleSpacing(const WireBundle& bundle)
 void WireManager::updateWireZOrder()
 {
     // Sort wires by length (shorter wires on top for better visibility)
-    QList<WireGraphicsItem*> sortedWires = m_wires;
+    QList<WireGraphicsItem*> sortedWires = wires();
     
     std::sort(sortedWires.begin(), sortedWires.end(), 
               [](WireGraphicsItem* a, WireGraphicsItem* b) {
@@ -351,7 +695,7 @@ void WireManager::bringWireToFront(WireGraphicsItem* wire)
     if (!wire) return;
     
     qreal maxZ = 100;
-    for (WireGraphicsItem* w : m_wires) {
+    for (WireGraphicsItem* w : wires()) {
         if (w->zValue() > maxZ) {
             maxZ = w->zValue();
         }
@@ -365,7 +709,7 @@ void WireManager::sendWireToBack(WireGraphicsItem* wire)
     if (!wire) return;
     
     qreal minZ = 100;
-    for (WireGraphicsItem* w : m_wires) {
+    for (WireGraphicsItem* w : wires()) {
         if (w->zValue() < minZ) {
             minZ = w->zValue();
         }
@@ -446,7 +790,7 @@ bool WireManager::RouteSegment::intersects(const RouteSegment& other) const
 
 bool WireManager::segmentIntersectsWires(const RouteSegment& segment, WireGraphicsItem* excludeWire) const
 {
-    for (WireGraphicsItem* wire : m_wires) {
+    for (WireGraphicsItem* wire : wires()) {
         if (wire == excludeWire) {
             continue;
         }
@@ -542,7 +886,7 @@ void WireManager::onWirePathChanged(WireGraphicsItem* wire)
 {
     if (m_autoRoutingEnabled) {
         // Check for collisions and optimize if needed
-        for (WireGraphicsItem* other : m_wires) {
+        for (WireGraphicsItem* other : wires()) {
             if (other != wire && areWiresOverlapping(wire, other)) {
                 emit wireCollisionDetected(wire, other);
             }
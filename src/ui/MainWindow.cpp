@@ -22,6 +22,7 @@
 #include <QEvent>
 #include <QTimer>
 #include <QSettings>
+#include <QInputDialog>
 #include <QListWidget>
 #include <QFileInfo>
 #include <QListWidgetItem>
@@ -36,24 +37,34 @@
 #include "ui/widgets/VerticalToolbar.h"
 #include "ui/widgets/ControlButtonsWidget.h"
 #include "ui/widgets/TerminalSectionWidget.h"
+#include "ui/widgets/terminal/JobRunnerTab.h"
+#include "ui/widgets/editor/SymbolIndex.h"
+#include "ui/widgets/editor/QuickOpenIndex.h"
 #include "scene/SchematicScene.h"
+#include "scene/SchematicHierarchy.h"
+#include "commands/UndoHistory.h"
 #include "parsers/SvParser.h"
 #include "parsers/ComponentPortParser.h"
 #include "graphics/ModuleGraphicsItem.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "graphics/TextGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
 #include "utils/PersistenceManager.h"
+#include "persistence/TestbenchExporter.h"
+#include "scene/Netlist.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , m_undoStack(new QUndoStack(this))
+    , m_undoHistory(new UndoHistory(this))
     , m_fileWatcher(new QFileSystemWatcher(this))
     , m_tabManager(nullptr)
     , m_fileManager(nullptr)
     , m_recentProjectsManager(nullptr)
     , m_widgetManager(nullptr)
     , m_textItemManager(nullptr)
+    , m_symbolIndex(nullptr)
+    , m_quickOpenIndex(nullptr)
     , m_componentLibrary(nullptr)
     , m_isLoadingProject(false)
 {
@@ -101,6 +112,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Setup scene
     scene = new SchematicScene(this);
+    scene->setUndoHistory(m_undoHistory);
     DragDropGraphicsView* graphicsView = static_cast<DragDropGraphicsView*>(ui->graphicsView);
     graphicsView->setSharedScene(scene);
     
@@ -128,6 +140,15 @@ MainWindow::MainWindow(QWidget *parent)
     // Setup terminal menu actions
     setupTerminalMenuActions();
     
+    // Setup symbol navigation actions
+    setupNavigationActions();
+    
+    // Setup testbench export action
+    setupExportActions();
+    
+    // Setup testbench build and simulation actions
+    setupBuildActions();
+    
     // Connect double-click on RTL list to open files (legacy list widget may be null now)
     if (ui->componentList) {
         connect(ui->componentList, &QListWidget::itemDoubleClicked, this, &MainWindow::onRtlListDoubleClicked);
@@ -652,8 +673,268 @@ void MainWindow::setupTerminalMenuActions()
     statusBar()->showMessage(tr("Terminal panel ready (Ctrl+` to toggle)"), 3000);
 }
 
+void MainWindow::setupNavigationActions()
+{
+    // Create Go to File action
+    QAction* goToFileAction = new QAction(tr("Go to &File..."), this);
+    goToFileAction->setObjectName("actionGoToFile");
+    goToFileAction->setShortcut(QKeySequence("Ctrl+P"));
+    goToFileAction->setStatusTip(tr("Open a project file or module by fuzzy name"));
+    connect(goToFileAction, &QAction::triggered, [this]() {
+        m_tabManager->showQuickOpen();
+    });
+    
+    // Create Go to Symbol action
+    QAction* goToSymbolAction = new QAction(tr("Go to &Symbol..."), this);
+    goToSymbolAction->setObjectName("actionGoToSymbol");
+    goToSymbolAction->setShortcut(QKeySequence("Ctrl+T"));
+    goToSymbolAction->setStatusTip(tr("Search modules, ports and parameters across the project"));
+    connect(goToSymbolAction, &QAction::triggered, [this]() {
+        m_tabManager->showSymbolPalette();
+    });
+    
+    // Add to Go menu (create if doesn't exist)
+    QMenu* goMenu = nullptr;
+    foreach (QAction* action, menuBar()->actions()) {
+        if (action->text().contains("Go")) {
+            goMenu = action->menu();
+            break;
+        }
+    }
+    if (!goMenu) {
+        goMenu = menuBar()->addMenu(tr("&Go"));
+    }
+    goMenu->addAction(goToFileAction);
+    goMenu->addAction(goToSymbolAction);
+}
+
+void MainWindow::setupExportActions()
+{
+    QAction* exportTestbenchAction = new QAction(tr("Export SystemC &Testbench"), this);
+    exportTestbenchAction->setObjectName("actionExportTestbench");
+    exportTestbenchAction->setShortcut(QKeySequence("Ctrl+Shift+E"));
+    exportTestbenchAction->setStatusTip(tr("Write sc_main.cpp with the signals and bindings of the schematic"));
+    connect(exportTestbenchAction, &QAction::triggered, this, &MainWindow::exportTestbench);
+    
+    // Add to File menu
+    QMenu* fileMenu = nullptr;
+    foreach (QAction* action, menuBar()->actions()) {
+        if (action->text().contains("File")) {
+            fileMenu = action->menu();
+            break;
+        }
+    }
+    if (fileMenu) {
+        fileMenu->addSeparator();
+        fileMenu->addAction(exportTestbenchAction);
+    }
+}
+
+void MainWindow::exportTestbench()
+{
+    const QString workingDirectory = PersistenceManager::instance().getWorkingDirectory();
+    if (workingDirectory.isEmpty()) {
+        QMessageBox::warning(this, tr("No Project Loaded"), tr("Open a project before exporting a testbench."));
+        return;
+    }
+    
+    const Netlist netlist = Netlist::fromScene(scene);
+    TestbenchExporter exporter(workingDirectory);
+    const TestbenchExporter::Result result = exporter.exportNetlist(netlist);
+    if (!result.ok) {
+        QMessageBox::critical(this, tr("Testbench Export Failed"),
+                              tr("Could not write %1:\n%2").arg(result.filePath, result.errorString));
+        return;
+    }
+    
+    for (const QString& warning : result.warnings) {
+        qWarning() << "⚠️ Testbench:" << warning;
+    }
+    
+    QString message = result.changedSections.isEmpty()
+        ? tr("Testbench up to date: %1").arg(QFileInfo(result.filePath).fileName())
+        : tr("Testbench exported: %1 (%2 instances, %3 nets; updated %4)")
+              .arg(QFileInfo(result.filePath).fileName())
+              .arg(netlist.instances().size())
+              .arg(netlist.nets().size())
+              .arg(result.changedSections.join(", "));
+    if (!result.warnings.isEmpty()) {
+        message += tr(" - %n warning(s), see sc_main.cpp", nullptr, result.warnings.size());
+    }
+    statusBar()->showMessage(message, 6000);
+}
+
+void MainWindow::setupBuildActions()
+{
+    JobRunner* runner = (m_terminalSection && m_terminalSection->jobRunnerTab())
+        ? m_terminalSection->jobRunnerTab()->runner() : nullptr;
+    m_buildOrchestrator = new BuildOrchestrator(runner, this);
+    connect(m_buildOrchestrator, &BuildOrchestrator::progress, this, [this](const QString& message) {
+        statusBar()->showMessage(message);
+    });
+    connect(m_buildOrchestrator, &BuildOrchestrator::finished, this, &MainWindow::onBuildFinished);
+    
+    QMenu* buildMenu = menuBar()->addMenu(tr("&Build"));
+    
+    QAction* buildAction = buildMenu->addAction(tr("&Build Testbench"));
+    buildAction->setObjectName("actionBuildTestbench");
+    buildAction->setShortcut(QKeySequence("Ctrl+B"));
+    buildAction->setStatusTip(tr("Compile the changed components and link the simulation"));
+    connect(buildAction, &QAction::triggered, this, [this]() { buildTestbench(false); });
+    
+    QAction* runAction = buildMenu->addAction(tr("Build and &Run Simulation"));
+    runAction->setObjectName("actionRunSimulation");
+    runAction->setShortcut(QKeySequence("Ctrl+R"));
+    runAction->setStatusTip(tr("Build the testbench and start it in the terminal"));
+    connect(runAction, &QAction::triggered, this, [this]() { buildTestbench(true); });
+    
+    QAction* cancelAction = buildMenu->addAction(tr("&Cancel Build"));
+    cancelAction->setObjectName("actionCancelBuild");
+    connect(cancelAction, &QAction::triggered, m_buildOrchestrator, &BuildOrchestrator::cancel);
+    
+    QAction* cleanAction = buildMenu->addAction(tr("C&lean Build"));
+    cleanAction->setObjectName("actionCleanBuild");
+    cleanAction->setStatusTip(tr("Remove .scv/build so the next build compiles everything"));
+    connect(cleanAction, &QAction::triggered, this, [this]() {
+        const QString workingDirectory = PersistenceManager::instance().getWorkingDirectory();
+        if (workingDirectory.isEmpty()) {
+            return;
+        }
+        const bool cleaned = m_buildOrchestrator->clean(workingDirectory);
+        statusBar()->showMessage(cleaned ? tr("Build directory removed") : tr("Cannot clean while a build is running"), 4000);
+    });
+    
+    buildMenu->addSeparator();
+    
+    QAction* widthAction = buildMenu->addAction(tr("Check &Wire Widths"));
+    widthAction->setObjectName("actionCheckWireWidths");
+    widthAction->setStatusTip(tr("Mark every wire that joins ports of different widths"));
+    connect(widthAction, &QAction::triggered, this, [this]() {
+        const int mismatches = scene->checkAllWireWidths();
+        statusBar()->showMessage(mismatches == 0 ? tr("All wire widths match")
+                                                 : tr("%n wire(s) join ports of different widths", nullptr, mismatches),
+                                 6000);
+    });
+    
+    buildMenu->addSeparator();
+    
+    QAction* pchAction = buildMenu->addAction(tr("Precompile &SystemC Header"));
+    pchAction->setObjectName("actionPrecompiledHeader");
+    pchAction->setCheckable(true);
+    pchAction->setChecked(m_buildOrchestrator->settings().usePrecompiledHeader);
+    connect(pchAction, &QAction::toggled, this, [this](bool checked) {
+        BuildOrchestrator::Settings settings = m_buildOrchestrator->settings();
+        settings.usePrecompiledHeader = checked;
+        settings.save();
+        m_buildOrchestrator->setSettings(settings);
+    });
+    
+    QAction* jobsAction = buildMenu->addAction(tr("Parallel &Jobs..."));
+    jobsAction->setObjectName("actionBuildJobs");
+    connect(jobsAction, &QAction::triggered, this, [this]() {
+        BuildOrchestrator::Settings settings = m_buildOrchestrator->settings();
+        bool ok = false;
+        const int jobs = QInputDialog::getInt(this, tr("Parallel Jobs"),
+                                              tr("Concurrent compiler processes (0 = one per core):"),
+                                              settings.jobs, 0, 256, 1, &ok);
+        if (ok) {
+            settings.jobs = jobs;
+            settings.save();
+            m_buildOrchestrator->setSettings(settings);
+        }
+    });
+}
+
+void MainWindow::buildTestbench(bool run)
+{
+    const QString workingDirectory = PersistenceManager::instance().getWorkingDirectory();
+    if (workingDirectory.isEmpty()) {
+        QMessageBox::warning(this, tr("No Project Loaded"), tr("Open a project before building the testbench."));
+        return;
+    }
+    if (m_buildOrchestrator->isBuilding()) {
+        statusBar()->showMessage(tr("A build is already running"), 3000);
+        return;
+    }
+    
+    // Compile jobs and their output show up in the Jobs tab
+    if (m_terminalSection) {
+        m_terminalSection->setVisible(true);
+        m_terminalSection->showJobsTab();
+    }
+    
+    m_runAfterBuild = run;
+    m_buildOrchestrator->build(workingDirectory, Netlist::fromScene(scene));
+}
+
+void MainWindow::onBuildFinished(const BuildOrchestrator::Result& result)
+{
+    for (const QString& warning : result.warnings) {
+        qWarning() << "⚠️ Build:" << warning;
+    }
+    
+    if (!result.ok) {
+        statusBar()->showMessage(tr("Build failed: %1").arg(result.errorString), 8000);
+        return;
+    }
+    
+    statusBar()->showMessage(tr("Build finished in %1 s: %2 compiled, %3 up to date%4")
+                                 .arg(result.elapsedMs / 1000.0, 0, 'f', 1)
+                                 .arg(result.compiled)
+                                 .arg(result.upToDate)
+                                 .arg(result.linked ? tr(", relinked") : QString()), 6000);
+    if (m_runAfterBuild) {
+        runSimulation(result.executable);
+    }
+}
+
+void MainWindow::runSimulation(const QString& executable)
+{
+    if (!m_terminalSection) {
+        qWarning() << "Terminal section not available";
+        return;
+    }
+    
+    m_terminalSection->setVisible(true);
+    m_terminalSection->showTerminalTab();
+    
+    TerminalTab* terminalTab = m_terminalSection->terminalTab();
+    if (!terminalTab) {
+        qWarning() << "Terminal tab not available";
+        return;
+    }
+    TerminalSession* session = terminalTab->currentSession();
+    if (!session) {
+        terminalTab->addNewSession();
+        session = terminalTab->currentSession();
+    }
+    if (!session) {
+        qWarning() << "Could not get or create terminal session";
+        return;
+    }
+    
+    // The simulation runs from the project directory so relative stimulus files resolve
+    const QString command = QString("cd \"%1\" && \"%2\"")
+        .arg(PersistenceManager::instance().getWorkingDirectory(), executable);
+    if (session->isActive()) {
+        session->executeCommand(command);
+    } else {
+        session->startTerminal();
+        QTimer::singleShot(1000, session, [session, command]() {
+            session->executeCommand(command);
+        });
+    }
+}
+
 void MainWindow::setupManagers()
 {
+    // The symbol index is shared by the editor tabs, so it exists before them
+    m_symbolIndex = new SymbolIndex(this);
+    connect(m_symbolIndex, &SymbolIndex::indexingFinished, this, [this](int files, int symbols, qint64 elapsedMs) {
+        statusBar()->showMessage(tr("Indexed %1 symbols in %2 files (%3 ms)").arg(symbols).arg(files).arg(elapsedMs), 3000);
+    });
+    m_quickOpenIndex = new QuickOpenIndex(m_symbolIndex, this);
+    
     // Create all managers
     m_tabManager = new TabManager(this, ui->tabWidget);
     m_fileManager = new FileManager(this, m_fileExplorerTree);
@@ -688,6 +969,11 @@ void MainWindow::setupManagers()
     
     // Connect scene context menu signals
     connect(scene, &SchematicScene::addTextRequested, m_textItemManager, &TextItemManager::onAddTextAtPosition);
+    connect(scene, &SchematicScene::moduleDefinitionRequested, m_tabManager, &TabManager::goToDefinition);
+    connect(scene, &SchematicScene::wireWidthMismatch, this, [this](const QString& message) {
+        statusBar()->showMessage(message, 6000);
+    });
+    connect(scene, &SchematicScene::blockOpenRequested, this, &MainWindow::openBlock);
     
     // Install event filter on graphics view to catch resize events
     ui->graphicsView->installEventFilter(this);
@@ -739,15 +1025,15 @@ void MainWindow::setupUndoRedo()
         }
     }
     
-    // Connect undo stack signals to update action states
-    connect(m_undoStack, &QUndoStack::canUndoChanged, undoAction, &QAction::setEnabled);
-    connect(m_undoStack, &QUndoStack::canRedoChanged, redoAction, &QAction::setEnabled);
+    // Connect undo history signals to update action states
+    connect(m_undoHistory, &UndoHistory::canUndoChanged, undoAction, &QAction::setEnabled);
+    connect(m_undoHistory, &UndoHistory::canRedoChanged, redoAction, &QAction::setEnabled);
     
     // Update action text with command descriptions
-    connect(m_undoStack, &QUndoStack::undoTextChanged, [undoAction](const QString& text) {
+    connect(m_undoHistory, &UndoHistory::undoTextChanged, [undoAction](const QString& text) {
         undoAction->setText(text.isEmpty() ? tr("&Undo") : tr("&Undo %1").arg(text));
     });
-    connect(m_undoStack, &QUndoStack::redoTextChanged, [redoAction](const QString& text) {
+    connect(m_undoHistory, &UndoHistory::redoTextChanged, [redoAction](const QString& text) {
         redoAction->setText(text.isEmpty() ? tr("&Redo") : tr("&Redo %1").arg(text));
     });
     
@@ -806,10 +1092,12 @@ void MainWindow::loadProjectInternal(const QString& projectPath)
     // Load RTL files
     m_fileManager->loadRtlFilesFromDirectory(projectPath);
     
-    // Load persisted ready components, RTL modules, connections, and text items
-    PersistenceManager::instance().loadComponentsFromDirectory(scene);
-    PersistenceManager::instance().loadRTLModules(scene);
-    PersistenceManager::instance().loadConnections(scene);
+    // Rebuild the symbol index in the background
+    m_symbolIndex->setRoot(projectPath);
+    m_quickOpenIndex->setRoot(projectPath);
+    
+    // Load persisted ready components, RTL modules, blocks, connections, and text items
+    SchematicHierarchy::load(scene);
     
     // Load text items with explicit logging
     qDebug() << "📝 Loading text items from:" << QDir(projectPath).filePath("text_items.json");
@@ -821,16 +1109,10 @@ void MainWindow::loadProjectInternal(const QString& projectPath)
     }
     
     // Connect signals for loaded text items
-    QList<QGraphicsItem*> items = scene->items();
-    int textItemCount = 0;
-    for (QGraphicsItem* item : items) {
-        TextGraphicsItem* textItem = dynamic_cast<TextGraphicsItem*>(item);
-        if (textItem) {
-            m_textItemManager->connectTextItemSignals(textItem);
-            textItemCount++;
-        }
+    for (TextGraphicsItem* textItem : scene->texts()) {
+        m_textItemManager->connectTextItemSignals(textItem);
     }
-    qDebug() << "📊 Connected signals for" << textItemCount << "text item(s)";
+    qDebug() << "📊 Connected signals for" << scene->texts().size() << "text item(s)";
     
     // Update widget manager with current directory
     m_widgetManager->setCurrentRtlDirectory(projectPath);
@@ -900,6 +1182,68 @@ void MainWindow::openFileInTab(const QString& filePath)
 void MainWindow::on_actionDark_Mode_toggled(bool checked)
 {
     scene->setDarkMode(checked);
+    for (SchematicScene* blockScene : m_openBlockScenes) {
+        blockScene->setDarkMode(checked);
+    }
+}
+
+void MainWindow::openBlock(BlockGraphicsItem* block)
+{
+    if (!block) {
+        return;
+    }
+    
+    // Collapsing creates the block's scene too, so connect afresh on every open instead of on first load
+    SchematicScene* blockScene = block->childScene();
+    disconnect(blockScene, nullptr, this, nullptr);
+    disconnect(blockScene, nullptr, m_tabManager, nullptr);
+    connect(blockScene, &SchematicScene::blockOpenRequested, this, &MainWindow::openBlock);
+    connect(blockScene, &SchematicScene::blockExitRequested, this, &MainWindow::leaveBlock);
+    connect(blockScene, &SchematicScene::moduleDefinitionRequested, m_tabManager, &TabManager::goToDefinition);
+    connect(blockScene, &SchematicScene::wireWidthMismatch, this, [this](const QString& message) {
+        statusBar()->showMessage(message, 6000);
+    });
+    // The scene goes with its block: step out to the nearest level still open
+    connect(blockScene, &QObject::destroyed, this, [this](QObject* object) {
+        const int index = m_openBlockScenes.indexOf(static_cast<SchematicScene*>(object));
+        if (index < 0) {
+            return;
+        }
+        m_openBlockScenes.erase(m_openBlockScenes.begin() + index, m_openBlockScenes.end());
+        showScene(m_openBlockScenes.isEmpty() ? scene : m_openBlockScenes.last());
+    });
+    
+    blockScene->setDarkMode(scene->isDarkMode());
+    m_openBlockScenes.append(blockScene);
+    showScene(blockScene);
+    statusBar()->showMessage(tr("Inside %1 - Alt+Up to leave").arg(block->label()), 4000);
+}
+
+void MainWindow::leaveBlock()
+{
+    if (m_openBlockScenes.isEmpty()) {
+        return;
+    }
+    SchematicScene* left = m_openBlockScenes.takeLast();
+    SchematicScene* parentScene = m_openBlockScenes.isEmpty() ? scene : m_openBlockScenes.last();
+    
+    // Edits inside may have removed members its ports led to
+    if (BlockGraphicsItem* block = parentScene->blockItem(left->blockName())) {
+        block->syncWithPersistence();
+    }
+    showScene(parentScene);
+}
+
+void MainWindow::showScene(SchematicScene* shown)
+{
+    DragDropGraphicsView* graphicsView = static_cast<DragDropGraphicsView*>(ui->graphicsView);
+    if (graphicsView->scene() == shown) {
+        return;
+    }
+    graphicsView->setSharedScene(shown);
+    if (m_widgetManager) {
+        m_widgetManager->setMinimapScene(shown);
+    }
 }
 
 void MainWindow::on_actionOpen_File_triggered()
@@ -947,17 +1291,19 @@ void MainWindow::on_actionOpen_File_triggered()
 
 void MainWindow::on_actionUndo_triggered()
 {
-    if (m_undoStack->canUndo()) {
-        m_undoStack->undo();
-        statusBar()->showMessage(tr("Undo: %1").arg(m_undoStack->undoText()), 2000);
+    if (m_undoHistory->canUndo()) {
+        const QString text = m_undoHistory->undoText();
+        m_undoHistory->undo();
+        statusBar()->showMessage(tr("Undo: %1").arg(text), 2000);
     }
 }
 
 void MainWindow::on_actionRedo_triggered()
 {
-    if (m_undoStack->canRedo()) {
-        m_undoStack->redo();
-        statusBar()->showMessage(tr("Redo: %1").arg(m_undoStack->redoText()), 2000);
+    if (m_undoHistory->canRedo()) {
+        const QString text = m_undoHistory->redoText();
+        m_undoHistory->redo();
+        statusBar()->showMessage(tr("Redo: %1").arg(text), 2000);
     }
 }
 
@@ -973,18 +1319,22 @@ void MainWindow::on_actionRefresh_triggered()
     
     // Refresh all placed RTL modules on the scene
     PersistenceManager& pm = PersistenceManager::instance();
-    QList<QGraphicsItem*> items = scene->items();
     
-    for (QGraphicsItem* item : items) {
-        ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-        if (module && module->isRTLView()) {
+    // Collect the files first: refreshing a file replaces its modules in the scene
+    QStringList filePaths;
+    for (ModuleGraphicsItem* module : scene->modules()) {
+        if (module->isRTLView()) {
             QString moduleName = pm.getRTLModuleName(module);
             QString filePath = pm.getRTLModuleFilePath(moduleName);
             if (!filePath.isEmpty()) {
-                refreshModuleView(filePath);
+                filePaths.append(filePath);
             }
         }
     }
+    filePaths.removeDuplicates();
+    for (const QString& filePath : filePaths) {
+        refreshModuleView(filePath);
+    }
     
     statusBar()->showMessage(tr("Refreshed RTL files and modules"), 2000);
 }
@@ -1004,6 +1354,7 @@ void MainWindow::onRtlFileChanged(const QString& path)
 {
     qDebug() << "File changed:" << path;
     refreshModuleView(path);
+    m_symbolIndex->updateFile(path);
     statusBar()->showMessage(tr("RTL file updated: %1").arg(QFileInfo(path).fileName()), 3000);
 }
 
@@ -1030,18 +1381,19 @@ void MainWindow::refreshModuleView(const QString& filePath)
         QString moduleName = match.captured(1);
         
         // Find module instances in the scene
-        QList<QGraphicsItem*> items = scene->items();
-        for (QGraphicsItem* item : items) {
-            ModuleGraphicsItem* module = dynamic_cast<ModuleGraphicsItem*>(item);
-            if (module && module->isRTLView()) {
+        // A copy: matching modules are replaced in the scene
+        const QVector<ModuleGraphicsItem*> modules = scene->modules();
+        for (ModuleGraphicsItem* module : modules) {
+            if (module->isRTLView()) {
                 QString currentModuleName = pm.getRTLModuleName(module);
-                if (currentModuleName == moduleName) {
+                if (module->getModuleInfo().name == moduleName) {
                     // Re-parse and update the module
                     ModuleInfo updatedInfo = SvParser::parseModule(filePath, moduleName);
                     if (!updatedInfo.name.isEmpty()) {
                         QPointF currentPos = module->pos();
                         
                         // Remove old module
+                        pm.unregisterRTLModule(module);
                         scene->removeItem(module);
                         delete module;
                         
@@ -1050,9 +1402,12 @@ void MainWindow::refreshModuleView(const QString& filePath)
                         newModule->setPos(currentPos);
                         scene->addItem(newModule);
                         
-                        // Re-register with persistence manager
-                        pm.setRTLModuleName(newModule, updatedInfo.name);
-                        pm.saveRTLModulePlacement(updatedInfo.name, filePath, currentPos);
+                        // Re-register with persistence manager; pasted copies keep their own names
+                        if (currentModuleName.isEmpty()) {
+                            currentModuleName = updatedInfo.name;
+                        }
+                        pm.setRTLModuleName(newModule, currentModuleName);
+                        pm.saveRTLModulePlacement(currentModuleName, filePath, currentPos, updatedInfo.name);
                         
                         qDebug() << "Refreshed module:" << moduleName << "at" << currentPos;
                     }
@@ -1089,9 +1444,7 @@ void MainWindow::onRtlListDoubleClicked(QListWidgetItem* item)
             PersistenceManager::instance().setWorkingDirectory(filePath);
             
             // Load persisted components for the new project
-            PersistenceManager::instance().loadComponentsFromDirectory(scene);
-            PersistenceManager::instance().loadRTLModules(scene);
-            PersistenceManager::instance().loadConnections(scene);
+            SchematicHierarchy::load(scene);
             PersistenceManager::instance().loadTextItems(scene);
         }
         
@@ -1109,6 +1462,7 @@ void MainWindow::onRtlListDoubleClicked(QListWidgetItem* item)
 void MainWindow::refreshComponent(const QString& filePath)
 {
     qDebug() << "🔄 Refreshing component from file:" << filePath;
+    PersistenceManager::instance().flushPendingWrites();
     
     // Parse the component file to extract port information
     ModuleInfo moduleInfo = ComponentPortParser::parseComponentFile(filePath);
@@ -1122,29 +1476,8 @@ void MainWindow::refreshComponent(const QString& filePath)
              << "| Inputs:" << moduleInfo.inputs.size() 
              << "| Outputs:" << moduleInfo.outputs.size();
     
-    // Find the component on the scene by matching the component ID
-    PersistenceManager& pm = PersistenceManager::instance();
-    QString workingDir = pm.getWorkingDirectory();
-    QString fileName = QFileInfo(filePath).fileName();
-    QString componentId = fileName.left(fileName.lastIndexOf('.'));
-    
-    // Iterate through items to find the matching component
-    QList<QGraphicsItem*> items = scene->items();
-    ReadyComponentGraphicsItem* targetComponent = nullptr;
-    
-    for (QGraphicsItem* item : items) {
-        ReadyComponentGraphicsItem* component = dynamic_cast<ReadyComponentGraphicsItem*>(item);
-        if (component) {
-            QString itemId = pm.getComponentId(component);
-            if (itemId == componentId) {
-                targetComponent = component;
-                break;
-            }
-        }
-    }
-    
+    ReadyComponentGraphicsItem* targetComponent = findComponentForFile(filePath);
     if (!targetComponent) {
-        qDebug() << "⚠️ Component not found on scene for:" << componentId;
         return;
     }
     
@@ -1160,7 +1493,43 @@ void MainWindow::refreshComponent(const QString& filePath)
         4000
     );
     
-    qDebug() << "✅ Component refreshed successfully:" << componentId;
+    qDebug() << "✅ Component refreshed successfully:" << targetComponent->getName();
+}
+
+void MainWindow::applyComponentPorts(const QString& filePath, const ModuleInfo& moduleInfo)
+{
+    // Live update from an open editor; the file on disk is left alone
+    ReadyComponentGraphicsItem* targetComponent = findComponentForFile(filePath);
+    if (!targetComponent || moduleInfo.name.isEmpty()) {
+        return;
+    }
+    
+    targetComponent->refreshPorts(moduleInfo);
+    statusBar()->showMessage(
+        tr("Ports updated: %1 (%2 inputs, %3 outputs)")
+            .arg(targetComponent->getName())
+            .arg(moduleInfo.inputs.size())
+            .arg(moduleInfo.outputs.size()),
+        2000
+    );
+}
+
+ReadyComponentGraphicsItem* MainWindow::findComponentForFile(const QString& filePath) const
+{
+    // Component files are named after the component ID
+    PersistenceManager& pm = PersistenceManager::instance();
+    QString fileName = QFileInfo(filePath).fileName();
+    QString componentId = fileName.left(fileName.lastIndexOf('.'));
+    
+    // Iterate through items to find the matching component
+    for (ReadyComponentGraphicsItem* component : scene->components()) {
+        if (pm.getComponentId(component) == componentId) {
+            return component;
+        }
+    }
+    
+    qDebug() << "⚠️ Component not found on scene for:" << componentId;
+    return nullptr;
 }
 
 
@@ -1212,9 +1581,7 @@ void MainWindow::onFileExplorerDirectoryDoubleClicked(const QString& dirPath)
         PersistenceManager::instance().setWorkingDirectory(dirPath);
         
         // Load persisted components for the new project
-        PersistenceManager::instance().loadComponentsFromDirectory(scene);
-        PersistenceManager::instance().loadRTLModules(scene);
-        PersistenceManager::instance().loadConnections(scene);
+        SchematicHierarchy::load(scene);
         PersistenceManager::instance().loadTextItems(scene);
     }
     
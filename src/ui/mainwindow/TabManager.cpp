@@ -2,6 +2,11 @@
 #include "ui/mainwindow/TabManager.h"
 #include "ui/MainWindow.h"
 #include "ui/widgets/CodeEditorWidget.h"
+#include "ui/widgets/editor/SymbolIndex.h"
+#include "ui/widgets/editor/SymbolPalette.h"
+#include "ui/widgets/editor/QuickOpenPalette.h"
+#include "parsers/IncrementalPortParser.h"
+#include "utils/PersistenceManager.h"
 #include <QTabWidget>
 #include <QTabBar>
 #include <QFileInfo>
@@ -14,7 +19,13 @@ TabManager::TabManager(MainWindow* mainWindow, QTabWidget* tabWidget)
     : QObject(mainWindow)
     , m_mainWindow(mainWindow)
     , m_tabWidget(tabWidget)
+    , m_symbolPalette(nullptr)
+    , m_quickOpenPalette(nullptr)
+    , m_referencesRequest(0)
 {
+    if (SymbolIndex* index = m_mainWindow->symbolIndex()) {
+        connect(index, &SymbolIndex::referencesFound, this, &TabManager::onReferencesFound);
+    }
 }
 
 void TabManager::setupTabWidget()
@@ -44,6 +55,9 @@ void TabManager::openFileInTab(const QString& filePath)
         return;
     }
     
+    // Generated component files are written in the background
+    PersistenceManager::instance().flushPendingWrites();
+    
     // Create new editor widget
     CodeEditorWidget* editor = new CodeEditorWidget(filePath, m_mainWindow);
     
@@ -67,10 +81,34 @@ void TabManager::openFileInTab(const QString& filePath)
     });
     
     // Connect signal to refresh component when file is saved
-    connect(editor, &CodeEditorWidget::fileSaved, this, [this, filePath]() {
+    connect(editor, &CodeEditorWidget::fileSaved, this, [this, filePath, editor]() {
+        if (SymbolIndex* index = m_mainWindow->symbolIndex()) {
+            index->updateFile(filePath, editor->getCode());
+        }
         onComponentFileSaved(filePath);
     });
     
+    // F12 / Shift+F12 and the editor context menu
+    connect(editor, &CodeEditorWidget::definitionRequested, this, &TabManager::goToDefinition);
+    connect(editor, &CodeEditorWidget::referencesRequested, this, &TabManager::findReferences);
+    
+    // Big files keep loading in the background; mark the tab until they are in
+    if (editor->isLoading()) {
+        m_tabWidget->setTabText(tabIndex, tr("%1 (loading...)").arg(fileName));
+        connect(editor, &CodeEditorWidget::loadFinished, this, [this, filePath, fileName, editor](bool ok) {
+            if (m_openFileTabs.contains(filePath)) {
+                m_tabWidget->setTabText(m_openFileTabs[filePath], fileName);
+            }
+            m_mainWindow->statusBar()->showMessage(ok ? tr("Loaded: %1").arg(fileName)
+                                                      : tr("Failed to load: %1").arg(fileName), 3000);
+            if (ok) {
+                attachLivePortParser(editor);
+            }
+        });
+    } else {
+        attachLivePortParser(editor);
+    }
+    
     qDebug() << "Opened file in new tab:" << filePath << "at index" << tabIndex;
 }
 
@@ -104,8 +142,10 @@ void TabManager::onTabCloseRequested(int index)
             } else if (reply == QMessageBox::Cancel) {
                 // Don't close
                 return;
+            } else {
+                // Discard: ports were updated live from the edits, so restore them from disk
+                onComponentFileSaved(editor->getFilePath());
             }
-            // Discard: continue with closing
         }
         
         // Remove from tracking map
@@ -155,4 +195,133 @@ void TabManager::onComponentFileSaved(const QString& filePath)
     });
 }
 
+void TabManager::openFileAtLocation(const QString& filePath, int line, int column)
+{
+    openFileInTab(filePath);
+    if (CodeEditorWidget* editor = editorForFile(filePath)) {
+        editor->goToLine(line, column);
+    }
+}
+
+void TabManager::goToDefinition(const QString& name)
+{
+    SymbolIndex* index = m_mainWindow->symbolIndex();
+    if (!index || name.isEmpty()) {
+        return;
+    }
+    
+    const QVector<SymbolLocation> locations = index->definitions(name);
+    if (locations.isEmpty()) {
+        m_mainWindow->statusBar()->showMessage(index->isBuilding()
+            ? tr("No definition found for '%1' yet, the symbol index is still being built").arg(name)
+            : tr("No definition found for '%1'").arg(name), 3000);
+        return;
+    }
+    
+    if (locations.size() == 1) {
+        openFileAtLocation(locations.first().filePath, locations.first().line, locations.first().column);
+        return;
+    }
+    symbolPalette()->showLocations(tr("%1 definitions of '%2'").arg(locations.size()).arg(name), locations);
+}
+
+void TabManager::findReferences(const QString& name)
+{
+    SymbolIndex* index = m_mainWindow->symbolIndex();
+    if (!index || name.isEmpty()) {
+        return;
+    }
+    
+    m_referencesRequest = index->findReferences(name);
+    m_mainWindow->statusBar()->showMessage(tr("Searching references to '%1'...").arg(name), 2000);
+}
+
+void TabManager::onReferencesFound(int requestId, const QString& name, const QVector<SymbolLocation>& locations)
+{
+    if (requestId != m_referencesRequest) {
+        return;
+    }
+    
+    if (locations.isEmpty()) {
+        m_mainWindow->statusBar()->showMessage(tr("No references to '%1'").arg(name), 3000);
+        return;
+    }
+    
+    QString title = tr("%1 references to '%2'").arg(locations.size()).arg(name);
+    if (locations.size() >= SymbolIndex::MAX_REFERENCES) {
+        title += tr(" (truncated)");
+    }
+    symbolPalette()->showLocations(title, locations);
+}
+
+void TabManager::showSymbolPalette()
+{
+    if (!m_mainWindow->symbolIndex()) {
+        return;
+    }
+    
+    // Seed the query with the identifier under the cursor of the current editor
+    QString initialQuery;
+    if (CodeEditorWidget* editor = qobject_cast<CodeEditorWidget*>(m_tabWidget->currentWidget())) {
+        initialQuery = editor->identifierAtCursor();
+    }
+    symbolPalette()->showSearch(initialQuery);
+}
+
+void TabManager::showQuickOpen()
+{
+    QuickOpenIndex* index = m_mainWindow->quickOpenIndex();
+    if (!index) {
+        return;
+    }
+    
+    if (!m_quickOpenPalette) {
+        m_quickOpenPalette = new QuickOpenPalette(index, m_mainWindow);
+        connect(m_quickOpenPalette, &QuickOpenPalette::fileActivated, this,
+                [this](const QString& filePath, int line, int column) {
+            // Plain files keep their last cursor position; modules jump to the declaration
+            if (line > 0) {
+                openFileAtLocation(filePath, line, column);
+            } else {
+                openFileInTab(filePath);
+            }
+        });
+    }
+    m_quickOpenPalette->showPalette();
+}
+
+void TabManager::attachLivePortParser(CodeEditorWidget* editor)
+{
+    // Only component sources, and not the huge files that load in viewport-only mode
+    const QString filePath = editor->getFilePath();
+    if (!filePath.endsWith(".cpp") || editor->isLargeFile()) {
+        return;
+    }
+    
+    // Owned by the editor; files without an SC_MODULE just never emit
+    IncrementalPortParser* parser = new IncrementalPortParser(editor->document(), editor);
+    connect(parser, &IncrementalPortParser::portsChanged, this, [this, filePath](const ModuleInfo& info) {
+        m_mainWindow->applyComponentPorts(filePath, info);
+    });
+}
+
+CodeEditorWidget* TabManager::editorForFile(const QString& filePath) const
+{
+    // Tabs are movable, so look the editor up rather than trusting the stored index
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        CodeEditorWidget* editor = qobject_cast<CodeEditorWidget*>(m_tabWidget->widget(i));
+        if (editor && editor->getFilePath() == filePath) {
+            return editor;
+        }
+    }
+    return nullptr;
+}
 
+SymbolPalette* TabManager::symbolPalette()
+{
+    if (!m_symbolPalette) {
+        m_symbolPalette = new SymbolPalette(m_mainWindow->symbolIndex(), m_mainWindow);
+        connect(m_symbolPalette, &SymbolPalette::locationActivated, this, &TabManager::openFileAtLocation);
+    }
+    return m_symbolPalette;
+}
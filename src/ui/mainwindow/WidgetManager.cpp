@@ -82,11 +82,26 @@ void WidgetManager::setupMinimap()
     });
     
     // Connect scene changes to update minimap
-    connect(scene, &QGraphicsScene::changed, this, [this]() {
+    m_sceneChangedConnection = connect(scene, &QGraphicsScene::changed, this, [this]() {
         m_minimap->update();
     });
 }
 
+void WidgetManager::setMinimapScene(QGraphicsScene* scene)
+{
+    if (!m_minimap) {
+        return;
+    }
+    disconnect(m_sceneChangedConnection);
+    m_minimap->setScene(scene);
+    if (scene) {
+        m_sceneChangedConnection = connect(scene, &QGraphicsScene::changed, this, [this]() {
+            m_minimap->update();
+        });
+    }
+    m_minimap->updateViewportRect();
+}
+
 void WidgetManager::updateMinimapPosition()
 {
     if (!m_minimap || !m_minimap->isVisible()) return;
@@ -1,137 +1,12 @@
 // CodeEditorDialog.cpp
 #include "ui/widgets/CodeEditorDialog.h"
+#include "ui/widgets/editor/CodeHighlighter.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFile>
 #include <QTextStream>
 #include <QMessageBox>
 #include <QFont>
-#include <QSyntaxHighlighter>
-#include <QTextCharFormat>
-#include <QRegularExpression>
-
-// Simple syntax highlighter for C++/SystemC
-class CppHighlighter : public QSyntaxHighlighter
-{
-public:
-    enum Theme {
-        Light,
-        Monokai
-    };
-
-    CppHighlighter(QTextDocument* parent = nullptr)
-        : QSyntaxHighlighter(parent), m_theme(Monokai)
-    {
-        updateTheme();
-    }
-
-    void setTheme(Theme theme)
-    {
-        m_theme = theme;
-        updateTheme();
-        rehighlight();
-    }
-
-private:
-    void updateTheme()
-    {
-        highlightingRules.clear();
-        
-        // Define color schemes based on theme
-        QColor keywordColor, preprocessorColor, commentColor, stringColor, numberColor;
-        
-        if (m_theme == Light) {
-            // Light theme colors
-            keywordColor = QColor(0, 0, 255);           // Blue
-            preprocessorColor = QColor(128, 0, 128);    // Purple
-            commentColor = QColor(0, 128, 0);           // Green
-            stringColor = QColor(163, 21, 21);          // Dark Red
-            numberColor = QColor(9, 134, 88);           // Teal
-        } else {
-            // Monokai theme colors
-            keywordColor = QColor(249, 38, 114);        // Pink
-            preprocessorColor = QColor(166, 226, 46);   // Light Green
-            commentColor = QColor(117, 113, 94);        // Gray
-            stringColor = QColor(230, 219, 116);        // Yellow
-            numberColor = QColor(174, 129, 255);        // Purple
-        }
-        
-        // Keywords
-        keywordFormat.setForeground(keywordColor);
-        keywordFormat.setFontWeight(QFont::Bold);
-        QStringList keywordPatterns = {
-            "\\bclass\\b", "\\bstruct\\b", "\\bvoid\\b", "\\bint\\b", "\\bbool\\b",
-            "\\bif\\b", "\\belse\\b", "\\bfor\\b", "\\bwhile\\b", "\\breturn\\b",
-            "\\bpublic\\b", "\\bprivate\\b", "\\bprotected\\b", "\\bvirtual\\b",
-            "\\bconst\\b", "\\bstatic\\b", "\\bnamespace\\b", "\\btemplate\\b",
-            "\\btypedef\\b", "\\btypename\\b", "\\boperator\\b", "\\bnew\\b",
-            "\\bdelete\\b", "\\bthis\\b", "\\btrue\\b", "\\bfalse\\b",
-            "\\bSC_MODULE\\b", "\\bSC_CTOR\\b", "\\bsc_in\\b", "\\bsc_out\\b",
-            "\\bsc_uint\\b", "\\bsc_int\\b", "\\bsc_signal\\b"
-        };
-        
-        for (const QString& pattern : keywordPatterns) {
-            HighlightingRule rule;
-            rule.pattern = QRegularExpression(pattern);
-            rule.format = keywordFormat;
-            highlightingRules.append(rule);
-        }
-        
-        // Preprocessor
-        preprocessorFormat.setForeground(preprocessorColor);
-        HighlightingRule preprocessorRule;
-        preprocessorRule.pattern = QRegularExpression("^\\s*#[^\n]*");
-        preprocessorRule.format = preprocessorFormat;
-        highlightingRules.append(preprocessorRule);
-        
-        // Single line comments
-        singleLineCommentFormat.setForeground(commentColor);
-        HighlightingRule commentRule;
-        commentRule.pattern = QRegularExpression("//[^\n]*");
-        commentRule.format = singleLineCommentFormat;
-        highlightingRules.append(commentRule);
-        
-        // Strings
-        quotationFormat.setForeground(stringColor);
-        HighlightingRule stringRule;
-        stringRule.pattern = QRegularExpression("\".*\"");
-        stringRule.format = quotationFormat;
-        highlightingRules.append(stringRule);
-        
-        // Numbers
-        numberFormat.setForeground(numberColor);
-        HighlightingRule numberRule;
-        numberRule.pattern = QRegularExpression("\\b[0-9]+(\\.[0-9]+)?\\b");
-        numberRule.format = numberFormat;
-        highlightingRules.append(numberRule);
-    }
-
-protected:
-    void highlightBlock(const QString& text) override
-    {
-        for (const HighlightingRule& rule : highlightingRules) {
-            QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-            while (matchIterator.hasNext()) {
-                QRegularExpressionMatch match = matchIterator.next();
-                setFormat(match.capturedStart(), match.capturedLength(), rule.format);
-            }
-        }
-    }
-
-    struct HighlightingRule
-    {
-        QRegularExpression pattern;
-        QTextCharFormat format;
-    };
-    QVector<HighlightingRule> highlightingRules;
-    
-    QTextCharFormat keywordFormat;
-    QTextCharFormat preprocessorFormat;
-    QTextCharFormat singleLineCommentFormat;
-    QTextCharFormat quotationFormat;
-    QTextCharFormat numberFormat;
-    Theme m_theme;
-};
 
 CodeEditorDialog::CodeEditorDialog(const QString& componentId, const QString& componentType,
                                    const QString& filePath, QWidget* parent)
@@ -170,7 +45,7 @@ void CodeEditorDialog::setupUI()
     applyCodeEditorStyle();
     
     // Add syntax highlighting
-    m_highlighter = new CppHighlighter(m_codeEditor->document());
+    m_highlighter = new CodeHighlighter(m_codeEditor->document(), CodeHighlighter::Cpp);
     
     // Track modifications
     connect(m_codeEditor, &QPlainTextEdit::textChanged, this, [this]() {
@@ -259,12 +134,12 @@ void CodeEditorDialog::onThemeToggled()
     if (m_isLightTheme) {
         m_themeButton->setText("🌑 Monokai Theme");
         if (m_highlighter) {
-            m_highlighter->setTheme(CppHighlighter::Light);
+            m_highlighter->setTheme(CodeHighlighter::Light);
         }
     } else {
         m_themeButton->setText("🌙 Light Theme");
         if (m_highlighter) {
-            m_highlighter->setTheme(CppHighlighter::Monokai);
+            m_highlighter->setTheme(CodeHighlighter::Monokai);
         }
     }
     
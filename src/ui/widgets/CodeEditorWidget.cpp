@@ -1,151 +1,24 @@
 // CodeEditorWidget.cpp
 #include "ui/widgets/CodeEditorWidget.h"
+#include "ui/widgets/editor/CodeHighlighter.h"
+#include "ui/widgets/editor/DocumentLoader.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFile>
 #include <QTextStream>
 #include <QMessageBox>
 #include <QFont>
-#include <QSyntaxHighlighter>
-#include <QTextCharFormat>
-#include <QRegularExpression>
 #include <QFileInfo>
 #include <QShortcut>
-
-// Simple syntax highlighter for SystemVerilog/C++/SystemC
-class SyntaxHighlighter : public QSyntaxHighlighter
-{
-public:
-    enum Theme {
-        Light,
-        Monokai
-    };
-
-    SyntaxHighlighter(QTextDocument* parent = nullptr)
-        : QSyntaxHighlighter(parent), m_theme(Monokai)
-    {
-        updateTheme();
-    }
-
-    void setTheme(Theme theme)
-    {
-        m_theme = theme;
-        updateTheme();
-        rehighlight();
-    }
-
-private:
-    void updateTheme()
-    {
-        highlightingRules.clear();
-        
-        // Define color schemes based on theme
-        QColor keywordColor, preprocessorColor, commentColor, stringColor, numberColor;
-        
-        if (m_theme == Light) {
-            // Light theme colors
-            keywordColor = QColor(0, 0, 255);           // Blue
-            preprocessorColor = QColor(128, 0, 128);    // Purple
-            commentColor = QColor(0, 128, 0);           // Green
-            stringColor = QColor(163, 21, 21);          // Dark Red
-            numberColor = QColor(9, 134, 88);           // Teal
-        } else {
-            // Monokai theme colors
-            keywordColor = QColor(249, 38, 114);        // Pink
-            preprocessorColor = QColor(166, 226, 46);   // Light Green
-            commentColor = QColor(117, 113, 94);        // Gray
-            stringColor = QColor(230, 219, 116);        // Yellow
-            numberColor = QColor(174, 129, 255);        // Purple
-        }
-        
-        // Keywords (covers C++, SystemC, and Verilog/SystemVerilog)
-        keywordFormat.setForeground(keywordColor);
-        keywordFormat.setFontWeight(QFont::Bold);
-        QStringList keywordPatterns = {
-            // C++/SystemC keywords
-            "\\bclass\\b", "\\bstruct\\b", "\\bvoid\\b", "\\bint\\b", "\\bbool\\b",
-            "\\bif\\b", "\\belse\\b", "\\bfor\\b", "\\bwhile\\b", "\\breturn\\b",
-            "\\bpublic\\b", "\\bprivate\\b", "\\bprotected\\b", "\\bvirtual\\b",
-            "\\bconst\\b", "\\bstatic\\b", "\\bnamespace\\b", "\\btemplate\\b",
-            "\\btypedef\\b", "\\btypename\\b", "\\boperator\\b", "\\bnew\\b",
-            "\\bdelete\\b", "\\bthis\\b", "\\btrue\\b", "\\bfalse\\b",
-            "\\bSC_MODULE\\b", "\\bSC_CTOR\\b", "\\bsc_in\\b", "\\bsc_out\\b",
-            "\\bsc_uint\\b", "\\bsc_int\\b", "\\bsc_signal\\b",
-            // Verilog/SystemVerilog keywords
-            "\\bmodule\\b", "\\bendmodule\\b", "\\binput\\b", "\\boutput\\b",
-            "\\binout\\b", "\\bwire\\b", "\\breg\\b", "\\binteger\\b",
-            "\\balways\\b", "\\bassign\\b", "\\bbegin\\b", "\\bend\\b",
-            "\\bcase\\b", "\\bendcase\\b", "\\bdefault\\b", "\\bparameter\\b",
-            "\\bposedge\\b", "\\bnegedge\\b", "\\bor\\b", "\\band\\b",
-            "\\blogic\\b", "\\bbit\\b", "\\bbyte\\b", "\\bshortint\\b",
-            "\\bint\\b", "\\blongint\\b", "\\btime\\b"
-        };
-        
-        for (const QString& pattern : keywordPatterns) {
-            HighlightingRule rule;
-            rule.pattern = QRegularExpression(pattern);
-            rule.format = keywordFormat;
-            highlightingRules.append(rule);
-        }
-        
-        // Preprocessor
-        preprocessorFormat.setForeground(preprocessorColor);
-        HighlightingRule preprocessorRule;
-        preprocessorRule.pattern = QRegularExpression("^\\s*[#`][^\n]*");
-        preprocessorRule.format = preprocessorFormat;
-        highlightingRules.append(preprocessorRule);
-        
-        // Single line comments
-        singleLineCommentFormat.setForeground(commentColor);
-        HighlightingRule commentRule;
-        commentRule.pattern = QRegularExpression("//[^\n]*");
-        commentRule.format = singleLineCommentFormat;
-        highlightingRules.append(commentRule);
-        
-        // Strings
-        quotationFormat.setForeground(stringColor);
-        HighlightingRule stringRule;
-        stringRule.pattern = QRegularExpression("\".*\"");
-        stringRule.format = quotationFormat;
-        highlightingRules.append(stringRule);
-        
-        // Numbers
-        numberFormat.setForeground(numberColor);
-        HighlightingRule numberRule;
-        numberRule.pattern = QRegularExpression("\\b[0-9]+(\\.[0-9]+)?\\b");
-        numberRule.format = numberFormat;
-        highlightingRules.append(numberRule);
-    }
-
-protected:
-    void highlightBlock(const QString& text) override
-    {
-        for (const HighlightingRule& rule : highlightingRules) {
-            QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-            while (matchIterator.hasNext()) {
-                QRegularExpressionMatch match = matchIterator.next();
-                setFormat(match.capturedStart(), match.capturedLength(), rule.format);
-            }
-        }
-    }
-
-    struct HighlightingRule
-    {
-        QRegularExpression pattern;
-        QTextCharFormat format;
-    };
-    QVector<HighlightingRule> highlightingRules;
-    
-    QTextCharFormat keywordFormat;
-    QTextCharFormat preprocessorFormat;
-    QTextCharFormat singleLineCommentFormat;
-    QTextCharFormat quotationFormat;
-    QTextCharFormat numberFormat;
-    Theme m_theme;
-};
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QElapsedTimer>
+#include <QMenu>
 
 CodeEditorWidget::CodeEditorWidget(const QString& filePath, QWidget* parent)
-    : QWidget(parent), m_filePath(filePath), m_modified(false), m_highlighter(nullptr)
+    : QWidget(parent), m_filePath(filePath), m_modified(false), m_highlighter(nullptr),
+      m_loader(nullptr), m_insertTimer(nullptr), m_viewportTimer(nullptr)
 {
     setupUI();
     loadCode();
@@ -188,15 +61,40 @@ void CodeEditorWidget::setupUI()
     applyCodeEditorStyle();
     
     // Add syntax highlighting
-    m_highlighter = new SyntaxHighlighter(m_codeEditor->document());
+    m_highlighter = new CodeHighlighter(m_codeEditor->document(), CodeHighlighter::languageForFile(m_filePath));
     
     // Track modifications
     connect(m_codeEditor, &QPlainTextEdit::textChanged, this, &CodeEditorWidget::onTextChanged);
     
+    // Background loading for big files; chunks are inserted a time slice at a time
+    m_loader = new DocumentLoader(this);
+    m_insertTimer = new QTimer(this);
+    m_insertTimer->setSingleShot(true);
+    m_insertTimer->setInterval(0);
+    connect(m_loader, &DocumentLoader::chunksAvailable, this, &CodeEditorWidget::insertPendingChunks);
+    connect(m_loader, &DocumentLoader::finished, this, &CodeEditorWidget::onLoaderFinished);
+    connect(m_insertTimer, &QTimer::timeout, this, &CodeEditorWidget::insertPendingChunks);
+    
+    m_viewportTimer = new QTimer(this);
+    m_viewportTimer->setSingleShot(true);
+    m_viewportTimer->setInterval(VIEWPORT_UPDATE_MS);
+    connect(m_viewportTimer, &QTimer::timeout, this, &CodeEditorWidget::updateHighlightWindow);
+    
     // Add Ctrl+S shortcut for saving
     QShortcut* saveShortcut = new QShortcut(QKeySequence::Save, this);
     connect(saveShortcut, &QShortcut::activated, this, &CodeEditorWidget::onSaveClicked);
     
+    // Symbol navigation, resolved against the project symbol index by the owner
+    QShortcut* definitionShortcut = new QShortcut(QKeySequence(Qt::Key_F12), m_codeEditor);
+    definitionShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(definitionShortcut, &QShortcut::activated, this, &CodeEditorWidget::requestDefinition);
+    QShortcut* referencesShortcut = new QShortcut(QKeySequence(Qt::SHIFT | Qt::Key_F12), m_codeEditor);
+    referencesShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(referencesShortcut, &QShortcut::activated, this, &CodeEditorWidget::requestReferences);
+    
+    m_codeEditor->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(m_codeEditor, &QPlainTextEdit::customContextMenuRequested, this, &CodeEditorWidget::showContextMenu);
+    
     mainLayout->addWidget(m_codeEditor, 1);
     
     // Status label
@@ -253,12 +151,12 @@ void CodeEditorWidget::onThemeToggled()
     if (m_isLightTheme) {
         m_themeButton->setText("🌑 Monokai Theme");
         if (m_highlighter) {
-            m_highlighter->setTheme(SyntaxHighlighter::Light);
+            m_highlighter->setTheme(CodeHighlighter::Light);
         }
     } else {
         m_themeButton->setText("🌙 Light Theme");
         if (m_highlighter) {
-            m_highlighter->setTheme(SyntaxHighlighter::Monokai);
+            m_highlighter->setTheme(CodeHighlighter::Monokai);
         }
     }
     
@@ -268,6 +166,12 @@ void CodeEditorWidget::onThemeToggled()
 void CodeEditorWidget::loadCode()
 {
     qDebug() << "📂 CodeEditorWidget::loadCode() called for file:" << m_filePath;
+    const qint64 fileSize = QFileInfo(m_filePath).size();
+    if (fileSize >= ASYNC_LOAD_THRESHOLD) {
+        startAsyncLoad(fileSize);
+        return;
+    }
+    
     QFile file(m_filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         m_statusLabel->setText("Error: Could not load file");
@@ -288,6 +192,221 @@ void CodeEditorWidget::loadCode()
     m_statusLabel->setStyleSheet("color: green; font-family: Tajawal; padding: 3px; font-size: 9pt;");
 }
 
+void CodeEditorWidget::startAsyncLoad(qint64 fileSize)
+{
+    m_largeFile = fileSize >= LARGE_FILE_THRESHOLD;
+    m_loading = true;
+    m_loaderDone = false;
+    
+    m_codeEditor->clear();
+    m_codeEditor->setReadOnly(true);
+    m_codeEditor->document()->setUndoRedoEnabled(false);
+    
+    if (m_largeFile) {
+        // Wrapping lays out every line and full highlighting lexes every block
+        m_codeEditor->setLineWrapMode(QPlainTextEdit::NoWrap);
+        m_highlighter->setViewportOnly(true);
+        
+        // Throttled rather than debounced, so the view fills in while chunks keep arriving
+        auto scheduleWindowUpdate = [this]() {
+            if (!m_viewportTimer->isActive()) {
+                m_viewportTimer->start();
+            }
+        };
+        connect(m_codeEditor->verticalScrollBar(), &QScrollBar::valueChanged, this, scheduleWindowUpdate);
+        connect(m_codeEditor, &QPlainTextEdit::blockCountChanged, this, scheduleWindowUpdate);
+    }
+    
+    qDebug() << "📂 Loading" << m_filePath << "in background," << fileSize << "bytes, large file:" << m_largeFile;
+    m_statusLabel->setText(QString("Loading %1 (%2 MB)...")
+                               .arg(getFileName())
+                               .arg(fileSize / (1024.0 * 1024.0), 0, 'f', 1));
+    m_statusLabel->setStyleSheet("color: gray; font-family: Tajawal; padding: 3px; font-size: 9pt;");
+    
+    m_loader->start(m_filePath);
+}
+
+void CodeEditorWidget::insertPendingChunks()
+{
+    if (!m_loading) {
+        return;
+    }
+    
+    // Insert for one time slice, then yield so the window keeps painting
+    QElapsedTimer budget;
+    budget.start();
+    
+    QTextCursor cursor(m_codeEditor->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    
+    QString chunk;
+    bool drained = true;
+    while (m_loader->takeChunk(&chunk)) {
+        cursor.insertText(chunk);
+        if (budget.elapsed() >= INSERT_BUDGET_MS) {
+            drained = false;
+            break;
+        }
+    }
+    cursor.endEditBlock();
+    
+    if (!drained) {
+        m_insertTimer->start();
+        return;
+    }
+    
+    if (m_loaderDone) {
+        finishAsyncLoad();
+        return;
+    }
+    
+    const qint64 total = qMax<qint64>(1, m_loader->fileSize());
+    m_statusLabel->setText(QString("Loading %1... %2%")
+                               .arg(getFileName())
+                               .arg(m_loader->bytesRead() * 100 / total));
+}
+
+void CodeEditorWidget::onLoaderFinished(bool ok, const QString& errorString)
+{
+    if (!ok) {
+        qDebug() << "❌ Background load failed for" << m_filePath << ":" << errorString;
+        m_insertTimer->stop();
+        m_codeEditor->setPlainText("// Error: Could not open file\n// " + m_filePath + "\n// " + errorString);
+        m_codeEditor->setReadOnly(true);
+        m_loading = false;
+        m_statusLabel->setText("Error: Could not load file");
+        m_statusLabel->setStyleSheet("color: red; font-family: Tajawal; padding: 3px; font-size: 9pt;");
+        emit loadFinished(false);
+        return;
+    }
+    
+    m_loaderDone = true;
+    if (!m_insertTimer->isActive()) {
+        insertPendingChunks();
+    }
+}
+
+void CodeEditorWidget::finishAsyncLoad()
+{
+    m_loading = false;
+    m_codeEditor->setReadOnly(false);
+    if (!m_largeFile) {
+        m_codeEditor->document()->setUndoRedoEnabled(true);
+    }
+    m_modified = false;
+    
+    if (m_largeFile) {
+        updateHighlightWindow();
+        m_statusLabel->setText("File loaded: " + getFileName() + " (large file: highlighting follows the view, undo and line wrap are off)");
+    } else {
+        m_statusLabel->setText("File loaded: " + getFileName());
+    }
+    m_statusLabel->setStyleSheet("color: green; font-family: Tajawal; padding: 3px; font-size: 9pt;");
+    
+    qDebug() << "✅ Loaded" << m_filePath << "-" << m_codeEditor->document()->blockCount() << "lines";
+    if (m_pendingLine > 0) {
+        goToLine(m_pendingLine, m_pendingColumn);
+        m_pendingLine = 0;
+    }
+    emit loadFinished(true);
+}
+
+void CodeEditorWidget::goToLine(int line, int column)
+{
+    if (m_loading) {
+        m_pendingLine = line;
+        m_pendingColumn = column;
+        return;
+    }
+    
+    const QTextBlock block = m_codeEditor->document()->findBlockByNumber(qMax(0, line - 1));
+    if (!block.isValid()) {
+        return;
+    }
+    
+    QTextCursor cursor(block);
+    cursor.movePosition(QTextCursor::Right, QTextCursor::MoveAnchor, qBound(0, column - 1, block.length() - 1));
+    m_codeEditor->setTextCursor(cursor);
+    m_codeEditor->centerCursor();
+    m_codeEditor->setFocus();
+}
+
+QString CodeEditorWidget::identifierAtCursor() const
+{
+    const QTextCursor cursor = m_codeEditor->textCursor();
+    if (cursor.hasSelection()) {
+        return cursor.selectedText().trimmed();
+    }
+    
+    // QTextCursor::WordUnderCursor splits on '$' and does not agree with the lexer
+    const QString text = cursor.block().text();
+    auto isIdentifierChar = [](QChar c) {
+        return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('$');
+    };
+    int start = cursor.positionInBlock();
+    int end = start;
+    while (start > 0 && isIdentifierChar(text.at(start - 1))) {
+        --start;
+    }
+    while (end < text.size() && isIdentifierChar(text.at(end))) {
+        ++end;
+    }
+    return text.mid(start, end - start);
+}
+
+void CodeEditorWidget::requestDefinition()
+{
+    const QString identifier = identifierAtCursor();
+    if (!identifier.isEmpty()) {
+        emit definitionRequested(identifier);
+    }
+}
+
+void CodeEditorWidget::requestReferences()
+{
+    const QString identifier = identifierAtCursor();
+    if (!identifier.isEmpty()) {
+        emit referencesRequested(identifier);
+    }
+}
+
+void CodeEditorWidget::showContextMenu(const QPoint& pos)
+{
+    // Right-click moves the cursor unless it lands inside the selection
+    const QTextCursor clicked = m_codeEditor->cursorForPosition(pos);
+    const QTextCursor current = m_codeEditor->textCursor();
+    if (!current.hasSelection() || clicked.position() < current.selectionStart()
+        || clicked.position() > current.selectionEnd()) {
+        m_codeEditor->setTextCursor(clicked);
+    }
+    
+    QMenu* menu = m_codeEditor->createStandardContextMenu(pos);
+    const QString identifier = identifierAtCursor();
+    menu->addSeparator();
+    QAction* definitionAction = menu->addAction("Go to Definition", this, &CodeEditorWidget::requestDefinition);
+    definitionAction->setShortcut(QKeySequence(Qt::Key_F12));
+    QAction* referencesAction = menu->addAction("Find References", this, &CodeEditorWidget::requestReferences);
+    referencesAction->setShortcut(QKeySequence(Qt::SHIFT | Qt::Key_F12));
+    definitionAction->setEnabled(!identifier.isEmpty());
+    referencesAction->setEnabled(!identifier.isEmpty());
+    
+    menu->exec(m_codeEditor->viewport()->mapToGlobal(pos));
+    delete menu;
+}
+
+void CodeEditorWidget::updateHighlightWindow()
+{
+    if (!m_highlighter->isViewportOnly()) {
+        return;
+    }
+    
+    const QTextBlock first = m_codeEditor->cursorForPosition(QPoint(0, 0)).block();
+    const QTextBlock last = m_codeEditor->cursorForPosition(QPoint(0, m_codeEditor->viewport()->height())).block();
+    m_highlighter->setHighlightWindow(qMax(0, first.blockNumber() - HIGHLIGHT_MARGIN_BLOCKS),
+                                      last.blockNumber() + HIGHLIGHT_MARGIN_BLOCKS);
+}
+
 void CodeEditorWidget::saveCode()
 {
     qDebug() << "💾 CodeEditorWidget::saveCode() called for file:" << m_filePath;
@@ -321,6 +440,11 @@ void CodeEditorWidget::onSaveClicked()
 
 void CodeEditorWidget::onTextChanged()
 {
+    // Chunks inserted by a background load are not user edits
+    if (m_loading) {
+        return;
+    }
+    
     if (!m_modified) {
         m_modified = true;
         m_saveButton->setEnabled(true);
@@ -20,6 +20,7 @@
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "utils/PersistenceManager.h"
 #include "scene/SchematicScene.h"
+#include "scene/AutoPlacement.h"
 
 
 DragDropGraphicsView::DragDropGraphicsView(QWidget *parent)
@@ -176,6 +177,11 @@ void DragDropGraphicsView::dropEvent(QDropEvent *event)
             qWarning() << "   The component can still be used, but editing may require re-initialization";
         }
 
+        // Moved off whatever it landed on
+        if (SchematicScene* schematicScene = qobject_cast<SchematicScene*>(m_scene)) {
+            schematicScene->autoPlacement()->placeOverlapping({readyComponent});
+        }
+
         event->acceptProposedAction();
         return;
     }
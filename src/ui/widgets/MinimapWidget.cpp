@@ -2,6 +2,9 @@
 #include "ui/widgets/MinimapWidget.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "graphics/ModuleGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
+#include "graphics/TextGraphicsItem.h"
+#include "scene/SchematicScene.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QGraphicsItem>
@@ -157,13 +160,13 @@ QTransform MinimapWidget::getSceneToMinimapTransform() const
         return QTransform();
     }
     
-    QRectF sceneRect = m_scene->sceneRect();
+    // Frame the content and the visible area; the scene rect only ever grows and
+    // would shrink a compact layout to a speck after one excursion to the edge
+    SchematicScene* schematicScene = qobject_cast<SchematicScene*>(m_scene);
+    QRectF sceneRect = schematicScene ? schematicScene->contentBounds() : m_scene->itemsBoundingRect();
+    sceneRect |= m_viewportRect;
     if (sceneRect.isEmpty()) {
-        // If scene rect is empty, calculate from items
-        sceneRect = m_scene->itemsBoundingRect();
-        if (sceneRect.isEmpty()) {
-            sceneRect = QRectF(-1000, -1000, 2000, 2000); // Default size
-        }
+        sceneRect = QRectF(-1000, -1000, 2000, 2000); // Default size
     }
     
     // Add some padding around the scene content
@@ -236,6 +239,7 @@ void MinimapWidget::paintEvent(QPaintEvent* event)
     
     QRectF drawableRect = getDrawableRect();
     QTransform transform = getSceneToMinimapTransform();
+    SchematicScene* schematicScene = qobject_cast<SchematicScene*>(m_scene);
     
     // Save painter state
     painter.save();
@@ -246,9 +250,27 @@ void MinimapWidget::paintEvent(QPaintEvent* event)
     // Set transform
     painter.setTransform(transform, false);
     
-    // Draw scene items in simplified form
+    // Draw scene items in simplified form; in a SchematicScene only the top-level
+    // components, blocks and texts, straight from its registries rather than the
+    // depth-sorted items() with every wire, label and port child
     painter.setPen(Qt::NoPen);
-    QList<QGraphicsItem*> items = m_scene->items();
+    QList<QGraphicsItem*> items;
+    if (schematicScene) {
+        items.reserve(schematicScene->components().size() + schematicScene->blocks().size() + schematicScene->texts().size());
+        for (ReadyComponentGraphicsItem* component : schematicScene->components()) {
+            if (!component->parentItem()) {
+                items.append(component);
+            }
+        }
+        for (BlockGraphicsItem* block : schematicScene->blocks()) {
+            items.append(block);
+        }
+        for (TextGraphicsItem* textItem : schematicScene->texts()) {
+            items.append(textItem);
+        }
+    } else {
+        items = m_scene->items();
+    }
     
     for (QGraphicsItem* item : items) {
         if (!item->isVisible()) {
@@ -367,40 +389,41 @@ void MinimapWidget::onFocusComponentsClicked()
 
 QRectF MinimapWidget::getComponentsBoundingRect() const
 {
-    if (!m_scene) {
+    // Components (ReadyComponentGraphicsItem or ModuleGraphicsItem) live in a SchematicScene
+    SchematicScene* schematicScene = qobject_cast<SchematicScene*>(m_scene);
+    if (!schematicScene) {
         return QRectF();
     }
     
     qreal minX = 0, maxX = 0, minY = 0, maxY = 0;
     bool firstItem = true;
     
-    QList<QGraphicsItem*> items = m_scene->items();
-    for (QGraphicsItem* item : items) {
-        if (!item->isVisible()) {
+    // Blocks count like components; they are kept in a registry of their own
+    QVector<ReadyComponentGraphicsItem*> components = schematicScene->components();
+    for (BlockGraphicsItem* block : schematicScene->blocks()) {
+        components.append(block);
+    }
+    
+    for (ReadyComponentGraphicsItem* component : components) {
+        if (!component->isVisible()) {
             continue;
         }
         
-        // Check if item is a component (ReadyComponentGraphicsItem or ModuleGraphicsItem)
-        ReadyComponentGraphicsItem* readyComponent = qgraphicsitem_cast<ReadyComponentGraphicsItem*>(item);
-        ModuleGraphicsItem* moduleComponent = qgraphicsitem_cast<ModuleGraphicsItem*>(item);
+        QRectF itemRect = component->mapRectToScene(component->boundingRect());
         
-        if (readyComponent || moduleComponent) {
-            QRectF itemRect = item->mapRectToScene(item->boundingRect());
-            
-            if (firstItem) {
-                // Initialize with first component's bounds
-                minX = itemRect.left();
-                maxX = itemRect.right();
-                minY = itemRect.top();
-                maxY = itemRect.bottom();
-                firstItem = false;
-            } else {
-                // Expand bounds to include this component
-                minX = qMin(minX, itemRect.left());
-                maxX = qMax(maxX, itemRect.right());
-                minY = qMin(minY, itemRect.top());
-                maxY = qMax(maxY, itemRect.bottom());
-            }
+        if (firstItem) {
+            // Initialize with first component's bounds
+            minX = itemRect.left();
+            maxX = itemRect.right();
+            minY = itemRect.top();
+            maxY = itemRect.bottom();
+            firstItem = false;
+        } else {
+            // Expand bounds to include this component
+            minX = qMin(minX, itemRect.left());
+            maxX = qMax(maxX, itemRect.right());
+            minY = qMin(minY, itemRect.top());
+            maxY = qMax(maxY, itemRect.bottom());
         }
     }
     
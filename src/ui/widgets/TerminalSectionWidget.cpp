@@ -23,6 +23,13 @@
 #include <QSettings>
 #include <QRegularExpression>
 #include <QDir>
+#include <QShortcut>
+#include <QStandardPaths>
+#include <QDebug>
+#include <QFileDialog>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include <memory>
 // #include <QTermWidget> // Commented out for now - requires external dependencies
 
 // TerminalSession Implementation
@@ -30,6 +37,7 @@ TerminalSession::TerminalSession(QWidget* parent)
     : QWidget(parent)
     , m_layout(nullptr)
     , m_terminal(nullptr)
+    , m_searchBar(nullptr)
     , m_statusLayout(nullptr)
     , m_statusLabel(nullptr)
     , m_workingDirLabel(nullptr)
@@ -37,6 +45,9 @@ TerminalSession::TerminalSession(QWidget* parent)
     , m_processStatusLabel(nullptr)
     , m_process(nullptr)
     , m_isActive(false)
+    , m_stdoutDiagnostics(nullptr)
+    , m_stderrDiagnostics(nullptr)
+    , m_captureWriter(nullptr)
     , m_hasUnsavedChanges(false)
     , m_historyIndex(-1)
     , m_promptPosition(0)
@@ -46,16 +57,22 @@ TerminalSession::TerminalSession(QWidget* parent)
     setupUI();
     setupContextMenu();
     setupShell();
+    setupDiagnostics();
 }
 
 TerminalSession::~TerminalSession()
 {
     closeTerminal();
+    setCaptureEnabled(false);
 }
 
 void TerminalSession::setSessionName(const QString& name)
 {
     m_sessionName = name;
+    if (m_stdoutDiagnostics) {
+        m_stdoutDiagnostics->setSourceName(name);
+        m_stderrDiagnostics->setSourceName(name);
+    }
     updateTitle();
 }
 
@@ -194,6 +211,12 @@ void TerminalSession::setupUI()
     // Install event filter to handle key presses
     m_terminal->installEventFilter(this);
     
+    // Scrollback search (Ctrl+F)
+    m_searchBar = new ScrollbackSearchBar(m_terminal, this);
+    QShortcut* findShortcut = new QShortcut(QKeySequence::Find, this);
+    findShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(findShortcut, &QShortcut::activated, m_searchBar, &ScrollbackSearchBar::activate);
+    
     // Create status bar
     m_statusLayout = new QHBoxLayout();
     m_statusLayout->setContentsMargins(5, 2, 5, 2);
@@ -223,6 +246,7 @@ void TerminalSession::setupUI()
     m_statusLayout->addWidget(m_processStatusLabel);
     
     // Add widgets to layout
+    m_layout->addWidget(m_searchBar);
     m_layout->addWidget(m_terminal);
     m_layout->addLayout(m_statusLayout);
     
@@ -249,6 +273,10 @@ void TerminalSession::setupContextMenu()
     m_copyAction = new QAction("Copy", this);
     m_pasteAction = new QAction("Paste", this);
     m_selectAllAction = new QAction("Select All", this);
+    m_findAction = new QAction("Find...", this);
+    m_captureAction = new QAction("Capture Output to Disk", this);
+    m_captureAction->setCheckable(true);
+    m_exportCaptureAction = new QAction("Export Captured Output...", this);
     m_clearHistoryAction = new QAction("Clear History", this);
     m_testBashAction = new QAction("Test Bash Terminal", this);
     
@@ -295,6 +323,19 @@ void TerminalSession::setupContextMenu()
         }
     });
     
+    connect(m_findAction, &QAction::triggered, m_searchBar, &ScrollbackSearchBar::activate);
+    
+    connect(m_captureAction, &QAction::toggled, this, &TerminalSession::setCaptureEnabled);
+    
+    connect(m_exportCaptureAction, &QAction::triggered, [this]() {
+        QString path = QFileDialog::getSaveFileName(this, "Export Captured Output",
+                                                    QDir(m_workingDirectory).filePath(captureBaseName() + ".log"),
+                                                    "Log Files (*.log *.txt);;All Files (*)");
+        if (!path.isEmpty()) {
+            exportCapture(path);
+        }
+    });
+    
     connect(m_clearHistoryAction, &QAction::triggered, [this]() {
         m_commandHistory.clear();
         m_historyIndex = -1;
@@ -307,6 +348,7 @@ void TerminalSession::setupContextMenu()
     m_contextMenu->addAction(m_copyAction);
     m_contextMenu->addAction(m_pasteAction);
     m_contextMenu->addAction(m_selectAllAction);
+    m_contextMenu->addAction(m_findAction);
     m_contextMenu->addSeparator();
     
     // Add shell selection submenu
@@ -323,6 +365,8 @@ void TerminalSession::setupContextMenu()
     m_contextMenu->addAction(m_renameAction);
     m_contextMenu->addAction(m_clearAction);
     m_contextMenu->addAction(m_clearHistoryAction);
+    m_contextMenu->addAction(m_captureAction);
+    m_contextMenu->addAction(m_exportCaptureAction);
     m_contextMenu->addAction(m_testBashAction);
     m_contextMenu->addSeparator();
     m_contextMenu->addAction(m_closeAction);
@@ -380,6 +424,10 @@ void TerminalSession::setWorkingDirectory(const QString& dir)
         if (m_process) {
             m_process->setWorkingDirectory(m_workingDirectory);
         }
+        if (m_stdoutDiagnostics) {
+            m_stdoutDiagnostics->setWorkingDirectory(m_workingDirectory);
+            m_stderrDiagnostics->setWorkingDirectory(m_workingDirectory);
+        }
         updateStatusBar();
         emit workingDirectoryChanged(m_workingDirectory);
     }
@@ -420,6 +468,7 @@ void TerminalSession::saveSessionState()
     settings.beginGroup("TerminalSession_" + m_sessionName);
     settings.setValue("workingDirectory", m_workingDirectory);
     settings.setValue("commandHistory", m_commandHistory);
+    settings.setValue("captureOutput", isCaptureEnabled());
     settings.endGroup();
     m_hasUnsavedChanges = false;
 }
@@ -430,9 +479,11 @@ void TerminalSession::restoreSessionState()
     settings.beginGroup("TerminalSession_" + m_sessionName);
     QString savedDir = settings.value("workingDirectory", QDir::homePath()).toString();
     QStringList savedHistory = settings.value("commandHistory", QStringList()).toStringList();
+    bool savedCapture = settings.value("captureOutput", false).toBool();
     settings.endGroup();
     
     setWorkingDirectory(savedDir);
+    setCaptureEnabled(savedCapture);
     m_commandHistory = savedHistory;
     m_historyIndex = m_commandHistory.size();
 }
@@ -448,6 +499,10 @@ void TerminalSession::onProcessFinished(int exitCode, QProcess::ExitStatus exitS
     m_isActive = false;
     m_processStatusLabel->setText("Finished");
     
+    // Emit any diagnostics still waiting for a line terminator or a batch flush
+    m_stdoutDiagnostics->finish();
+    m_stderrDiagnostics->finish();
+    
     if (exitStatus == QProcess::NormalExit) {
         writeToTerminal(QString("\nProcess finished with exit code: %1\n").arg(exitCode));
     } else {
@@ -590,6 +645,14 @@ void TerminalSession::processOutput(const QByteArray& data, bool isError)
 {
     QString text = QString::fromUtf8(data);
     
+    // Tee the raw bytes to disk before anything is dropped from the widget
+    if (m_captureWriter) {
+        m_captureWriter->append(isError ? CaptureStream::StandardError : CaptureStream::StandardOutput, data);
+    }
+    
+    // Compilers report on stderr, simulators usually on stdout
+    (isError ? m_stderrDiagnostics : m_stdoutDiagnostics)->feed(data);
+    
     if (isError) {
         writeToTerminal(text, QColor(255, 100, 100));
         emit errorReceived(text);
@@ -603,6 +666,149 @@ void TerminalSession::processOutput(const QByteArray& data, bool isError)
     }
 }
 
+void TerminalSession::setupDiagnostics()
+{
+    m_stdoutDiagnostics = new DiagnosticExtractor(this);
+    m_stderrDiagnostics = new DiagnosticExtractor(this);
+    
+    for (DiagnosticExtractor* extractor : {m_stdoutDiagnostics, m_stderrDiagnostics}) {
+        extractor->setWorkingDirectory(m_workingDirectory);
+        extractor->setSourceName(m_sessionName);
+        connect(extractor, &DiagnosticExtractor::problemsExtracted,
+                this, &TerminalSession::problemsDetected);
+    }
+}
+
+void TerminalSession::setCaptureEnabled(bool enabled)
+{
+    if (enabled == isCaptureEnabled()) {
+        return;
+    }
+    
+    if (enabled) {
+        SessionCaptureWriter::Settings captureSettings;
+        captureSettings.directory = captureDirectory();
+        captureSettings.baseName = captureBaseName();
+        
+        m_captureWriter = new SessionCaptureWriter(captureSettings, this);
+        connect(m_captureWriter, &SessionCaptureWriter::captureError, this, [this](const QString& message) {
+            writeToTerminal(QString("\nCapture error: %1\n").arg(message), QColor(255, 100, 100));
+        });
+        m_captureWriter->start(QThread::LowPriority);
+        writeToTerminal(QString("Capturing output to %1\n").arg(captureSettings.directory));
+    } else {
+        m_captureWriter->stop();
+        const qint64 dropped = m_captureWriter->bytesDropped();
+        delete m_captureWriter;
+        m_captureWriter = nullptr;
+        if (dropped > 0) {
+            qWarning() << "⚠️ Terminal capture dropped" << dropped << "bytes (disk too slow)";
+        }
+    }
+    
+    if (m_captureAction) {
+        m_captureAction->setChecked(enabled);
+    }
+    m_hasUnsavedChanges = true;
+}
+
+QString TerminalSession::captureDirectory() const
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+        .filePath("terminal-captures");
+}
+
+QStringList TerminalSession::captureFiles() const
+{
+    return SessionCaptureReader::captureFiles(captureDirectory(), captureBaseName());
+}
+
+void TerminalSession::exportCapture(const QString& targetPath)
+{
+    // The last block may still be queued, and writing it may start a new file:
+    // the export starts once the writer reports it on disk
+    if (m_captureWriter && m_captureWriter->isRunning()) {
+        struct PendingExport {
+            bool started = false;
+            QMetaObject::Connection flushed;
+            QMetaObject::Connection destroyed;
+        };
+        const quint64 ticket = m_captureWriter->flush();
+        auto pending = std::make_shared<PendingExport>();
+        auto startExport = [this, pending, targetPath]() {
+            if (pending->started) {
+                return;
+            }
+            pending->started = true;
+            disconnect(pending->flushed);
+            disconnect(pending->destroyed);
+            exportCaptureFiles(targetPath);
+        };
+        pending->flushed = connect(m_captureWriter, &SessionCaptureWriter::flushed, this,
+                                   [ticket, startExport](quint64 done) {
+            if (done >= ticket) {
+                startExport();
+            }
+        });
+        // Turning capture off in the meantime stops the writer with everything on disk
+        pending->destroyed = connect(m_captureWriter, &QObject::destroyed, this, startExport);
+        return;
+    }
+    exportCaptureFiles(targetPath);
+}
+
+void TerminalSession::exportCaptureFiles(const QString& targetPath)
+{
+    const QStringList files = captureFiles();
+    if (files.isEmpty()) {
+        writeToTerminal("\nNo captured output for this session\n", QColor(255, 200, 100));
+        return;
+    }
+    
+    // Decompressing a long history is left to a worker thread
+    auto* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, targetPath]() {
+        const QString error = watcher->result();
+        if (error.isEmpty()) {
+            writeToTerminal(QString("\nCaptured output exported to %1\n").arg(targetPath));
+        } else {
+            writeToTerminal(QString("\nExport failed: %1\n").arg(error), QColor(255, 100, 100));
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([files, targetPath]() {
+        QString error;
+        SessionCaptureReader::exportText(files, targetPath, &error);
+        return error;
+    }));
+}
+
+void TerminalSession::trimScrollback()
+{
+    // Trim in steps of SCROLLBACK_TRIM_SLACK lines so the document (and any
+    // open search) is not disturbed on every write
+    QTextDocument* document = m_terminal->document();
+    const int excess = document->blockCount() - CAPTURED_SCROLLBACK_LINES;
+    if (excess < SCROLLBACK_TRIM_SLACK) {
+        return;
+    }
+    
+    QTextCursor cursor(document);
+    cursor.movePosition(QTextCursor::Start);
+    cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, excess);
+    const int removed = cursor.selectionEnd();
+    cursor.removeSelectedText();
+    
+    m_promptPosition = qMax(0, m_promptPosition - removed);
+}
+
+QString TerminalSession::captureBaseName() const
+{
+    QString name = m_sessionName;
+    name.replace(QRegularExpression("[^A-Za-z0-9_-]"), "_");
+    return name.isEmpty() ? QString("terminal") : name;
+}
+
 void TerminalSession::handleAnsiEscapeSequences(const QString& text)
 {
     // Simple ANSI escape sequence handling
@@ -976,6 +1182,10 @@ void TerminalSession::writeToTerminal(const QString& text, const QColor& color)
     // Restore read-only state
     m_terminal->setReadOnly(wasReadOnly);
     
+    if (m_captureWriter) {
+        trimScrollback();
+    }
+    
     // Auto-scroll to bottom
     QScrollBar* scrollBar = m_terminal->verticalScrollBar();
     scrollBar->setValue(scrollBar->maximum());
@@ -1104,6 +1314,7 @@ void TerminalTab::addNewSession()
     // Connect signals
     connect(session, &TerminalSession::sessionClosed, this, &TerminalTab::onSessionClosed);
     connect(session, &TerminalSession::sessionRenamed, this, &TerminalTab::onSessionRenamed);
+    connect(session, &TerminalSession::problemsDetected, this, &TerminalTab::problemsDetected);
     
     updateSessionButtons();
     emit sessionCountChanged(m_tabWidget->count() - 1); // Subtract 1 for the "+" tab
@@ -1292,10 +1503,12 @@ ProblemsTab::ProblemsTab(QWidget* parent)
     : QWidget(parent)
     , m_layout(nullptr)
     , m_filterEdit(nullptr)
+    , m_countLabel(nullptr)
     , m_clearButton(nullptr)
-    , m_problemsTree(nullptr)
+    , m_problemsView(nullptr)
+    , m_model(nullptr)
+    , m_filterTimer(nullptr)
     , m_contextMenu(nullptr)
-    , m_problemCount(0)
 {
     setupUI();
     setupContextMenu();
@@ -1307,76 +1520,80 @@ ProblemsTab::~ProblemsTab()
 
 void ProblemsTab::addProblem(const QString& file, int line, int column, const QString& message, const QString& severity)
 {
-    QTreeWidgetItem* item = new QTreeWidgetItem(m_problemsTree);
-    item->setText(0, severity);
-    item->setText(1, QString::number(line));
-    item->setText(2, QString::number(column));
-    item->setText(3, QFileInfo(file).fileName());
-    item->setText(4, message);
-    item->setData(0, Qt::UserRole, file);
-    item->setData(0, Qt::UserRole + 1, line);
-    item->setData(0, Qt::UserRole + 2, column);
-    
-    // Set severity color
-    QColor color;
-    if (severity == "Error") {
-        color = QColor(255, 100, 100);
-    } else if (severity == "Warning") {
-        color = QColor(255, 200, 100);
-    } else {
-        color = QColor(100, 200, 255);
-    }
-    item->setForeground(0, color);
-    
-    m_problemCount++;
-    updateProblemCount();
+    ProblemEntry entry;
+    entry.file = file;
+    entry.line = line;
+    entry.column = column;
+    entry.message = message;
+    entry.severity = severity;
+    m_model->addProblem(entry);
+}
+
+void ProblemsTab::addProblems(const QVector<ProblemEntry>& problems)
+{
+    m_model->addProblems(problems);
 }
 
 void ProblemsTab::clearProblems()
 {
-    m_problemsTree->clear();
-    m_problemCount = 0;
-    updateProblemCount();
+    m_model->clear();
 }
 
 void ProblemsTab::setFilter(const QString& filter)
 {
     m_filterEdit->setText(filter);
+    // Programmatic filters apply right away instead of waiting for the debounce
+    m_filterTimer->stop();
     onFilterChanged();
 }
 
 int ProblemsTab::problemCount() const
 {
-    return m_problemCount;
+    return m_model->problemCount();
 }
 
-void ProblemsTab::onProblemDoubleClicked(QTreeWidgetItem* item, int column)
+void ProblemsTab::onProblemDoubleClicked(const QModelIndex& index)
 {
-    if (item) {
-        QString file = item->data(0, Qt::UserRole).toString();
-        int line = item->data(0, Qt::UserRole + 1).toInt();
-        int column = item->data(0, Qt::UserRole + 2).toInt();
-        emit problemDoubleClicked(file, line, column);
+    if (!index.isValid() || m_model->isGroup(index)) {
+        return;
     }
+
+    QString file = index.data(ProblemsModel::FilePathRole).toString();
+    int line = index.data(ProblemsModel::LineRole).toInt();
+    int column = index.data(ProblemsModel::ColumnRole).toInt();
+    emit problemDoubleClicked(file, line, column);
 }
 
 void ProblemsTab::onContextMenuRequested(const QPoint& pos)
 {
     if (m_contextMenu) {
-        m_contextMenu->exec(mapToGlobal(pos));
+        m_contextMenu->exec(m_problemsView->viewport()->mapToGlobal(pos));
     }
 }
 
 void ProblemsTab::onFilterChanged()
 {
-    QString filter = m_filterEdit->text();
-    for (int i = 0; i < m_problemsTree->topLevelItemCount(); ++i) {
-        QTreeWidgetItem* item = m_problemsTree->topLevelItem(i);
-        bool visible = filter.isEmpty() || 
-                      item->text(0).contains(filter, Qt::CaseInsensitive) ||
-                      item->text(3).contains(filter, Qt::CaseInsensitive) ||
-                      item->text(4).contains(filter, Qt::CaseInsensitive);
-        item->setHidden(!visible);
+    m_model->setFilter(m_filterEdit->text());
+}
+
+void ProblemsTab::onFilterApplied()
+{
+    // Spanning is per persistent index and gets dropped by the model reset
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        m_problemsView->setFirstColumnSpanned(row, QModelIndex(), true);
+    }
+    m_problemsView->expandAll();
+}
+
+void ProblemsTab::onGroupsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return; // Rows inside an existing group
+    }
+
+    for (int row = first; row <= last; ++row) {
+        m_problemsView->setFirstColumnSpanned(row, QModelIndex(), true);
+        m_problemsView->expand(m_model->index(row, 0));
     }
 }
 
@@ -1391,33 +1608,52 @@ void ProblemsTab::setupUI()
     
     m_filterEdit = new QLineEdit(this);
     m_filterEdit->setPlaceholderText("Filter problems...");
-    connect(m_filterEdit, &QLineEdit::textChanged, this, &ProblemsTab::onFilterChanged);
+    m_filterEdit->setClearButtonEnabled(true);
+    
+    // Debounce filter edits - the model evaluates the filter off the GUI thread
+    m_filterTimer = new QTimer(this);
+    m_filterTimer->setSingleShot(true);
+    m_filterTimer->setInterval(FILTER_DEBOUNCE_MS);
+    connect(m_filterEdit, &QLineEdit::textChanged, m_filterTimer, QOverload<>::of(&QTimer::start));
+    connect(m_filterTimer, &QTimer::timeout, this, &ProblemsTab::onFilterChanged);
+    
+    m_countLabel = new QLabel(this);
     
     m_clearButton = new QPushButton("Clear", this);
     connect(m_clearButton, &QPushButton::clicked, this, &ProblemsTab::clearProblems);
     
     m_filterLayout->addWidget(m_filterEdit);
+    m_filterLayout->addWidget(m_countLabel);
     m_filterLayout->addWidget(m_clearButton);
     
-    // Problems tree
-    m_problemsTree = new QTreeWidget(this);
-    m_problemsTree->setHeaderLabels({"Severity", "Line", "Column", "File", "Message"});
-    m_problemsTree->setRootIsDecorated(false);
-    m_problemsTree->setAlternatingRowColors(true);
-    m_problemsTree->setSortingEnabled(true);
-    m_problemsTree->setContextMenuPolicy(Qt::CustomContextMenu);
+    // Problems view over the model, grouped by file
+    m_model = new ProblemsModel(this);
+    
+    m_problemsView = new QTreeView(this);
+    m_problemsView->setModel(m_model);
+    m_problemsView->setRootIsDecorated(true);
+    m_problemsView->setAlternatingRowColors(true);
+    m_problemsView->setUniformRowHeights(true);
+    m_problemsView->setSortingEnabled(true);
+    m_problemsView->sortByColumn(ProblemsModel::SeverityColumn, Qt::AscendingOrder);
+    m_problemsView->setContextMenuPolicy(Qt::CustomContextMenu);
     
     // Set column widths
-    m_problemsTree->setColumnWidth(0, 80);
-    m_problemsTree->setColumnWidth(1, 60);
-    m_problemsTree->setColumnWidth(2, 60);
-    m_problemsTree->setColumnWidth(3, 150);
+    m_problemsView->setColumnWidth(ProblemsModel::SeverityColumn, 80);
+    m_problemsView->setColumnWidth(ProblemsModel::LineColumn, 60);
+    m_problemsView->setColumnWidth(ProblemsModel::ColumnColumn, 60);
+    m_problemsView->setColumnWidth(ProblemsModel::FileColumn, 150);
     
-    connect(m_problemsTree, &QTreeWidget::itemDoubleClicked, this, &ProblemsTab::onProblemDoubleClicked);
-    connect(m_problemsTree, &QTreeWidget::customContextMenuRequested, this, &ProblemsTab::onContextMenuRequested);
+    connect(m_problemsView, &QTreeView::doubleClicked, this, &ProblemsTab::onProblemDoubleClicked);
+    connect(m_problemsView, &QTreeView::customContextMenuRequested, this, &ProblemsTab::onContextMenuRequested);
+    connect(m_model, &ProblemsModel::filterApplied, this, &ProblemsTab::onFilterApplied);
+    connect(m_model, &ProblemsModel::rowsInserted, this, &ProblemsTab::onGroupsInserted);
+    connect(m_model, &ProblemsModel::countsChanged, this, &ProblemsTab::updateProblemCount);
     
     m_layout->addLayout(m_filterLayout);
-    m_layout->addWidget(m_problemsTree);
+    m_layout->addWidget(m_problemsView);
+    
+    updateProblemCount();
 }
 
 void ProblemsTab::setupContextMenu()
@@ -1430,20 +1666,23 @@ void ProblemsTab::setupContextMenu()
     
     connect(m_clearAction, &QAction::triggered, this, &ProblemsTab::clearProblems);
     connect(m_copyAction, &QAction::triggered, [this]() {
-        QTreeWidgetItem* item = m_problemsTree->currentItem();
-        if (item) {
-            QString text = QString("%1:%2:%3 - %4").arg(item->text(3), item->text(1), item->text(2), item->text(4));
-            QApplication::clipboard()->setText(text);
+        QModelIndex index = m_problemsView->currentIndex();
+        if (!index.isValid()) {
+            return;
         }
+        if (m_model->isGroup(index)) {
+            QApplication::clipboard()->setText(index.data(ProblemsModel::FilePathRole).toString());
+            return;
+        }
+        QString text = QString("%1:%2:%3 - %4").arg(
+            index.siblingAtColumn(ProblemsModel::FileColumn).data().toString(),
+            index.siblingAtColumn(ProblemsModel::LineColumn).data().toString(),
+            index.siblingAtColumn(ProblemsModel::ColumnColumn).data().toString(),
+            index.siblingAtColumn(ProblemsModel::MessageColumn).data().toString());
+        QApplication::clipboard()->setText(text);
     });
     connect(m_goToFileAction, &QAction::triggered, [this]() {
-        QTreeWidgetItem* item = m_problemsTree->currentItem();
-        if (item) {
-            QString file = item->data(0, Qt::UserRole).toString();
-            int line = item->data(0, Qt::UserRole + 1).toInt();
-            int column = item->data(0, Qt::UserRole + 2).toInt();
-            emit problemDoubleClicked(file, line, column);
-        }
+        onProblemDoubleClicked(m_problemsView->currentIndex());
     });
     
     m_contextMenu->addAction(m_copyAction);
@@ -1454,8 +1693,15 @@ void ProblemsTab::setupContextMenu()
 
 void ProblemsTab::updateProblemCount()
 {
-    // Update title or status if needed
-    // This could be connected to a status bar or title update
+    int errors = m_model->countBySeverity(ProblemSeverity::Error);
+    int warnings = m_model->countBySeverity(ProblemSeverity::Warning);
+    int infos = m_model->countBySeverity(ProblemSeverity::Info);
+    
+    QString text = QString("%1 errors, %2 warnings, %3 infos").arg(errors).arg(warnings).arg(infos);
+    if (!m_model->filter().trimmed().isEmpty()) {
+        text += QString(" (showing %1 of %2)").arg(m_model->visibleCount()).arg(m_model->problemCount());
+    }
+    m_countLabel->setText(text);
 }
 
 // OutputTab Implementation
@@ -1464,10 +1710,16 @@ OutputTab::OutputTab(QWidget* parent)
     , m_layout(nullptr)
     , m_clearButton(nullptr)
     , m_outputText(nullptr)
+    , m_searchBar(nullptr)
+    , m_diagnostics(nullptr)
     , m_contextMenu(nullptr)
 {
     setupUI();
     setupContextMenu();
+    
+    m_diagnostics = new DiagnosticExtractor(this);
+    m_diagnostics->setSourceName("Output");
+    connect(m_diagnostics, &DiagnosticExtractor::problemsExtracted, this, &OutputTab::problemsDetected);
 }
 
 OutputTab::~OutputTab()
@@ -1476,6 +1728,9 @@ OutputTab::~OutputTab()
 
 void OutputTab::appendOutput(const QString& text)
 {
+    // append() starts a new paragraph, so every call is a complete line
+    m_diagnostics->feed(text + QLatin1Char('\n'));
+    
     m_outputText->append(text);
     // Auto-scroll to bottom
     QScrollBar* scrollBar = m_outputText->verticalScrollBar();
@@ -1485,12 +1740,17 @@ void OutputTab::appendOutput(const QString& text)
 void OutputTab::clearOutput()
 {
     m_outputText->clear();
+    m_diagnostics->reset();
     emit outputCleared();
 }
 
 void OutputTab::setOutput(const QString& text)
 {
     m_outputText->setPlainText(text);
+    
+    m_diagnostics->reset();
+    m_diagnostics->feed(text);
+    m_diagnostics->finish();
 }
 
 void OutputTab::onContextMenuRequested(const QPoint& pos)
@@ -1528,7 +1788,14 @@ void OutputTab::setupUI()
     
     connect(m_outputText, &QTextEdit::customContextMenuRequested, this, &OutputTab::onContextMenuRequested);
     
+    // Search bar (Ctrl+F)
+    m_searchBar = new ScrollbackSearchBar(m_outputText, this);
+    QShortcut* findShortcut = new QShortcut(QKeySequence::Find, this);
+    findShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(findShortcut, &QShortcut::activated, m_searchBar, &ScrollbackSearchBar::activate);
+    
     m_layout->addLayout(m_buttonLayout);
+    m_layout->addWidget(m_searchBar);
     m_layout->addWidget(m_outputText);
 }
 
@@ -1547,9 +1814,12 @@ void OutputTab::setupContextMenu()
     connect(m_selectAllAction, &QAction::triggered, [this]() {
         m_outputText->selectAll();
     });
+    m_findAction = new QAction("Find...", this);
+    connect(m_findAction, &QAction::triggered, m_searchBar, &ScrollbackSearchBar::activate);
     
     m_contextMenu->addAction(m_copyAction);
     m_contextMenu->addAction(m_selectAllAction);
+    m_contextMenu->addAction(m_findAction);
     m_contextMenu->addSeparator();
     m_contextMenu->addAction(m_clearAction);
 }
@@ -1561,6 +1831,7 @@ DebugConsoleTab::DebugConsoleTab(QWidget* parent)
     , m_levelCombo(nullptr)
     , m_clearButton(nullptr)
     , m_debugText(nullptr)
+    , m_searchBar(nullptr)
     , m_contextMenu(nullptr)
     , m_currentLevel("ALL")
 {
@@ -1645,7 +1916,14 @@ void DebugConsoleTab::setupUI()
     
     connect(m_debugText, &QTextEdit::customContextMenuRequested, this, &DebugConsoleTab::onContextMenuRequested);
     
+    // Search bar (Ctrl+F)
+    m_searchBar = new ScrollbackSearchBar(m_debugText, this);
+    QShortcut* findShortcut = new QShortcut(QKeySequence::Find, this);
+    findShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+    connect(findShortcut, &QShortcut::activated, m_searchBar, &ScrollbackSearchBar::activate);
+    
     m_layout->addLayout(m_filterLayout);
+    m_layout->addWidget(m_searchBar);
     m_layout->addWidget(m_debugText);
 }
 
@@ -1664,9 +1942,12 @@ void DebugConsoleTab::setupContextMenu()
     connect(m_selectAllAction, &QAction::triggered, [this]() {
         m_debugText->selectAll();
     });
+    m_findAction = new QAction("Find...", this);
+    connect(m_findAction, &QAction::triggered, m_searchBar, &ScrollbackSearchBar::activate);
     
     m_contextMenu->addAction(m_copyAction);
     m_contextMenu->addAction(m_selectAllAction);
+    m_contextMenu->addAction(m_findAction);
     m_contextMenu->addSeparator();
     m_contextMenu->addAction(m_clearAction);
 }
@@ -1687,6 +1968,7 @@ TerminalSectionWidget::TerminalSectionWidget(QWidget* parent)
     , m_outputTab(nullptr)
     , m_terminalTab(nullptr)
     , m_debugConsoleTab(nullptr)
+    , m_jobRunnerTab(nullptr)
     , m_contextMenu(nullptr)
 {
     setupUI();
@@ -1718,6 +2000,11 @@ void TerminalSectionWidget::showDebugConsoleTab()
     m_tabWidget->setCurrentIndex(3);
 }
 
+void TerminalSectionWidget::showJobsTab()
+{
+    m_tabWidget->setCurrentIndex(4);
+}
+
 void TerminalSectionWidget::toggleVisibility()
 {
     setVisible(!isVisible());
@@ -1751,17 +2038,24 @@ void TerminalSectionWidget::setupUI()
     m_outputTab = new OutputTab(this);
     m_terminalTab = new TerminalTab(this);
     m_debugConsoleTab = new DebugConsoleTab(this);
+    m_jobRunnerTab = new JobRunnerTab(this);
     
     // Add tabs
     m_tabWidget->addTab(m_problemsTab, "Problems");
     m_tabWidget->addTab(m_outputTab, "Output");
     m_tabWidget->addTab(m_terminalTab, "Terminal");
     m_tabWidget->addTab(m_debugConsoleTab, "Debug Console");
+    m_tabWidget->addTab(m_jobRunnerTab, "Jobs");
     
     // Connect signals
     connect(m_tabWidget, &QTabWidget::currentChanged, this, &TerminalSectionWidget::onTabChanged);
     connect(m_tabWidget, &QTabWidget::customContextMenuRequested, this, &TerminalSectionWidget::onContextMenuRequested);
     
+    // Diagnostics found in terminal and build output land in the Problems tab
+    connect(m_terminalTab, &TerminalTab::problemsDetected, m_problemsTab, &ProblemsTab::addProblems);
+    connect(m_outputTab, &OutputTab::problemsDetected, m_problemsTab, &ProblemsTab::addProblems);
+    connect(m_jobRunnerTab->runner(), &JobRunner::problemsDetected, m_problemsTab, &ProblemsTab::addProblems);
+    
     m_layout->addWidget(m_tabWidget);
 }
 
@@ -0,0 +1,588 @@
+// CodeHighlighter.cpp
+#include "ui/widgets/editor/CodeHighlighter.h"
+#include <QColor>
+#include <QFileInfo>
+#include <QFont>
+#include <QSet>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <algorithm>
+
+namespace {
+
+constexpr quint8 Keyword = CodeHighlighter::KeywordToken;
+constexpr quint8 Type = CodeHighlighter::TypeToken;
+
+const QVector<KeywordTable::Entry>& cppKeywords()
+{
+    static const QVector<KeywordTable::Entry> entries = {
+        // C++ keywords
+        {"alignas", Keyword}, {"alignof", Keyword}, {"auto", Keyword}, {"break", Keyword},
+        {"case", Keyword}, {"catch", Keyword}, {"class", Keyword}, {"const", Keyword},
+        {"constexpr", Keyword}, {"const_cast", Keyword}, {"continue", Keyword}, {"decltype", Keyword},
+        {"default", Keyword}, {"delete", Keyword}, {"do", Keyword}, {"dynamic_cast", Keyword},
+        {"else", Keyword}, {"enum", Keyword}, {"explicit", Keyword}, {"extern", Keyword},
+        {"false", Keyword}, {"final", Keyword}, {"for", Keyword}, {"friend", Keyword},
+        {"goto", Keyword}, {"if", Keyword}, {"inline", Keyword}, {"mutable", Keyword},
+        {"namespace", Keyword}, {"new", Keyword}, {"noexcept", Keyword}, {"nullptr", Keyword},
+        {"operator", Keyword}, {"override", Keyword}, {"private", Keyword}, {"protected", Keyword},
+        {"public", Keyword}, {"reinterpret_cast", Keyword}, {"return", Keyword}, {"sizeof", Keyword},
+        {"static", Keyword}, {"static_assert", Keyword}, {"static_cast", Keyword}, {"struct", Keyword},
+        {"switch", Keyword}, {"template", Keyword}, {"this", Keyword}, {"thread_local", Keyword},
+        {"throw", Keyword}, {"true", Keyword}, {"try", Keyword}, {"typedef", Keyword},
+        {"typeid", Keyword}, {"typename", Keyword}, {"union", Keyword}, {"using", Keyword},
+        {"virtual", Keyword}, {"volatile", Keyword}, {"while", Keyword},
+        // C++ fundamental types
+        {"void", Type}, {"bool", Type}, {"char", Type}, {"short", Type}, {"int", Type},
+        {"long", Type}, {"float", Type}, {"double", Type}, {"signed", Type}, {"unsigned", Type},
+        {"wchar_t", Type}, {"char16_t", Type}, {"char32_t", Type}, {"size_t", Type},
+        {"int8_t", Type}, {"int16_t", Type}, {"int32_t", Type}, {"int64_t", Type},
+        {"uint8_t", Type}, {"uint16_t", Type}, {"uint32_t", Type}, {"uint64_t", Type},
+        // SystemC macros and kernel calls
+        {"SC_MODULE", Keyword}, {"SC_CTOR", Keyword}, {"SC_HAS_PROCESS", Keyword},
+        {"SC_METHOD", Keyword}, {"SC_THREAD", Keyword}, {"SC_CTHREAD", Keyword},
+        {"SC_REPORT_INFO", Keyword}, {"SC_REPORT_WARNING", Keyword}, {"SC_REPORT_ERROR", Keyword},
+        {"SC_REPORT_FATAL", Keyword}, {"sensitive", Keyword}, {"dont_initialize", Keyword},
+        {"wait", Keyword}, {"next_trigger", Keyword}, {"sc_main", Keyword}, {"sc_start", Keyword},
+        {"sc_stop", Keyword}, {"SC_ZERO_TIME", Keyword}, {"SC_FS", Keyword}, {"SC_PS", Keyword},
+        {"SC_NS", Keyword}, {"SC_US", Keyword}, {"SC_MS", Keyword}, {"SC_SEC", Keyword},
+        // SystemC types
+        {"sc_in", Type}, {"sc_out", Type}, {"sc_inout", Type}, {"sc_in_clk", Type},
+        {"sc_signal", Type}, {"sc_clock", Type}, {"sc_fifo", Type}, {"sc_fifo_in", Type},
+        {"sc_fifo_out", Type}, {"sc_event", Type}, {"sc_time", Type}, {"sc_module", Type},
+        {"sc_module_name", Type}, {"sc_port", Type}, {"sc_export", Type}, {"sc_interface", Type},
+        {"sc_trace_file", Type}, {"sc_int", Type}, {"sc_uint", Type}, {"sc_bigint", Type},
+        {"sc_biguint", Type}, {"sc_bv", Type}, {"sc_lv", Type}, {"sc_bit", Type},
+        {"sc_logic", Type}
+    };
+    return entries;
+}
+
+const QVector<KeywordTable::Entry>& systemVerilogKeywords()
+{
+    static const QVector<KeywordTable::Entry> entries = {
+        // Structure
+        {"module", Keyword}, {"endmodule", Keyword}, {"macromodule", Keyword},
+        {"interface", Keyword}, {"endinterface", Keyword}, {"modport", Keyword},
+        {"package", Keyword}, {"endpackage", Keyword}, {"import", Keyword}, {"export", Keyword},
+        {"program", Keyword}, {"endprogram", Keyword}, {"class", Keyword}, {"endclass", Keyword},
+        {"extends", Keyword}, {"implements", Keyword}, {"virtual", Keyword}, {"new", Keyword},
+        {"this", Keyword}, {"super", Keyword}, {"null", Keyword}, {"local", Keyword},
+        {"protected", Keyword}, {"static", Keyword}, {"automatic", Keyword}, {"const", Keyword},
+        {"function", Keyword}, {"endfunction", Keyword}, {"task", Keyword}, {"endtask", Keyword},
+        {"return", Keyword}, {"typedef", Keyword}, {"enum", Keyword}, {"struct", Keyword},
+        {"union", Keyword}, {"packed", Keyword}, {"signed", Keyword}, {"unsigned", Keyword},
+        // Ports and parameters
+        {"input", Keyword}, {"output", Keyword}, {"inout", Keyword}, {"ref", Keyword},
+        {"parameter", Keyword}, {"localparam", Keyword}, {"defparam", Keyword},
+        // Procedural blocks and statements
+        {"always", Keyword}, {"always_comb", Keyword}, {"always_ff", Keyword},
+        {"always_latch", Keyword}, {"initial", Keyword}, {"final", Keyword}, {"assign", Keyword},
+        {"deassign", Keyword}, {"force", Keyword}, {"release", Keyword}, {"begin", Keyword},
+        {"end", Keyword}, {"if", Keyword}, {"else", Keyword}, {"case", Keyword},
+        {"casex", Keyword}, {"casez", Keyword}, {"endcase", Keyword}, {"default", Keyword},
+        {"unique", Keyword}, {"unique0", Keyword}, {"priority", Keyword}, {"for", Keyword},
+        {"foreach", Keyword}, {"while", Keyword}, {"do", Keyword}, {"repeat", Keyword},
+        {"forever", Keyword}, {"break", Keyword}, {"continue", Keyword}, {"disable", Keyword},
+        {"fork", Keyword}, {"join", Keyword}, {"join_any", Keyword}, {"join_none", Keyword},
+        {"wait", Keyword}, {"posedge", Keyword}, {"negedge", Keyword}, {"edge", Keyword},
+        {"or", Keyword}, {"and", Keyword}, {"not", Keyword}, {"inside", Keyword},
+        {"with", Keyword}, {"iff", Keyword},
+        // Generate
+        {"generate", Keyword}, {"endgenerate", Keyword}, {"genvar", Keyword},
+        // Verification
+        {"assert", Keyword}, {"assume", Keyword}, {"cover", Keyword}, {"property", Keyword},
+        {"endproperty", Keyword}, {"sequence", Keyword}, {"endsequence", Keyword},
+        {"clocking", Keyword}, {"endclocking", Keyword}, {"constraint", Keyword},
+        {"rand", Keyword}, {"randc", Keyword}, {"covergroup", Keyword}, {"endgroup", Keyword},
+        {"coverpoint", Keyword}, {"bins", Keyword},
+        // Data types and nets
+        {"logic", Type}, {"bit", Type}, {"byte", Type}, {"shortint", Type}, {"int", Type},
+        {"longint", Type}, {"integer", Type}, {"time", Type}, {"real", Type},
+        {"realtime", Type}, {"shortreal", Type}, {"string", Type}, {"void", Type},
+        {"chandle", Type}, {"event", Type}, {"wire", Type}, {"reg", Type}, {"tri", Type},
+        {"wand", Type}, {"wor", Type}, {"supply0", Type}, {"supply1", Type}, {"var", Type}
+    };
+    return entries;
+}
+
+// murmur3 finaliser, applied on top of FNV-1a for avalanche
+inline quint32 fmix32(quint32 h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+inline bool isIdentifierStart(QChar c)
+{
+    return c.isLetter() || c == QLatin1Char('_');
+}
+
+inline bool isIdentifierChar(QChar c, bool allowDollar)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || (allowDollar && c == QLatin1Char('$'));
+}
+
+} // namespace
+
+// ============================================================================
+// KeywordTable
+// ============================================================================
+
+KeywordTable::KeywordTable(const QVector<Entry>& entries)
+{
+    QVector<QString> keys;
+    QVector<quint8> kinds;
+    QSet<QString> seen;
+    keys.reserve(entries.size());
+    kinds.reserve(entries.size());
+    for (const Entry& entry : entries) {
+        const QString key = QString::fromLatin1(entry.word);
+        if (key.isEmpty() || seen.contains(key)) {
+            continue;
+        }
+        seen.insert(key);
+        keys.append(key);
+        kinds.append(entry.kind);
+    }
+    m_count = keys.size();
+
+    // Load factor <= 0.5; a bucket that cannot be placed doubles the table
+    quint32 tableSize = 8;
+    while (tableSize < quint32(m_count) * 2) {
+        tableSize <<= 1;
+    }
+    while (!build(keys, kinds, tableSize)) {
+        tableSize <<= 1;
+    }
+}
+
+bool KeywordTable::build(const QVector<QString>& keys, const QVector<quint8>& kinds, quint32 tableSize)
+{
+    m_bucketCount = qMax(1, keys.size() / 2);
+    m_mask = tableSize - 1;
+    m_keys = QVector<QString>(int(tableSize));
+    m_kinds = QVector<quint8>(int(tableSize), 0);
+    m_displacements = QVector<quint32>(m_bucketCount, 0);
+
+    QVector<quint32> hashes(keys.size());
+    QVector<QVector<int>> buckets(m_bucketCount);
+    for (int i = 0; i < keys.size(); ++i) {
+        hashes[i] = hashWord(keys.at(i));
+        buckets[int(hashes[i] % quint32(m_bucketCount))].append(i);
+    }
+
+    // Place the largest buckets first while the table is still sparse
+    QVector<int> order(m_bucketCount);
+    for (int b = 0; b < m_bucketCount; ++b) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](int a, int b) {
+        return buckets.at(a).size() > buckets.at(b).size();
+    });
+
+    QVector<bool> used(int(tableSize), false);
+    QVector<quint32> slots;
+    for (int b : order) {
+        const QVector<int>& bucket = buckets.at(b);
+        if (bucket.isEmpty()) {
+            break;
+        }
+
+        bool placed = false;
+        for (quint32 d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+            slots.clear();
+            bool free = true;
+            for (int key : bucket) {
+                const quint32 slot = slotHash(hashes.at(key), d) & m_mask;
+                if (used.at(int(slot)) || slots.contains(slot)) {
+                    free = false;
+                    break;
+                }
+                slots.append(slot);
+            }
+            if (!free) {
+                continue;
+            }
+            for (int k = 0; k < bucket.size(); ++k) {
+                used[int(slots.at(k))] = true;
+                m_keys[int(slots.at(k))] = keys.at(bucket.at(k));
+                m_kinds[int(slots.at(k))] = kinds.at(bucket.at(k));
+            }
+            m_displacements[b] = d;
+            placed = true;
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int KeywordTable::lookup(QStringView word) const
+{
+    if (word.isEmpty() || m_count == 0) {
+        return -1;
+    }
+    const quint32 hash = hashWord(word);
+    const quint32 displacement = m_displacements.at(int(hash % quint32(m_bucketCount)));
+    const int slot = int(slotHash(hash, displacement) & m_mask);
+    return QStringView(m_keys.at(slot)) == word ? m_kinds.at(slot) : -1;
+}
+
+quint32 KeywordTable::hashWord(QStringView word)
+{
+    quint32 h = 2166136261u;
+    for (QChar c : word) {
+        h ^= c.unicode();
+        h *= 16777619u;
+    }
+    return fmix32(h);
+}
+
+quint32 KeywordTable::slotHash(quint32 hash, quint32 displacement)
+{
+    return fmix32(hash ^ (displacement * 0x9e3779b9u + 0x7f4a7c15u));
+}
+
+// ============================================================================
+// CodeHighlighter
+// ============================================================================
+
+CodeHighlighter::CodeHighlighter(QTextDocument* parent, Language language)
+    : QSyntaxHighlighter(parent)
+    , m_theme(Monokai)
+    , m_language(language)
+    , m_keywords(&keywordTable(language))
+{
+    updateFormats();
+}
+
+void CodeHighlighter::setTheme(Theme theme)
+{
+    m_theme = theme;
+    updateFormats();
+    if (m_viewportOnly) {
+        rehighlightWindow();
+    } else {
+        rehighlight();
+    }
+}
+
+void CodeHighlighter::setLanguage(Language language)
+{
+    if (m_language == language) {
+        return;
+    }
+    m_language = language;
+    m_keywords = &keywordTable(language);
+    if (m_viewportOnly) {
+        rehighlightWindow();
+    } else {
+        rehighlight();
+    }
+}
+
+void CodeHighlighter::setViewportOnly(bool enabled)
+{
+    if (m_viewportOnly == enabled) {
+        return;
+    }
+    m_viewportOnly = enabled;
+    m_windowFirst = -1;
+    m_windowLast = -1;
+    if (!enabled) {
+        rehighlight();
+    }
+}
+
+void CodeHighlighter::setHighlightWindow(int firstBlock, int lastBlock)
+{
+    m_windowFirst = firstBlock;
+    m_windowLast = lastBlock;
+    rehighlightWindow();
+}
+
+void CodeHighlighter::rehighlightWindow()
+{
+    if (!document() || m_windowFirst < 0) {
+        return;
+    }
+    QTextBlock block = document()->findBlockByNumber(m_windowFirst);
+    for (int number = m_windowFirst; block.isValid() && number <= m_windowLast; ++number) {
+        rehighlightBlock(block);
+        block = block.next();
+    }
+}
+
+CodeHighlighter::Language CodeHighlighter::languageForFile(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "sv" || suffix == "svh" || suffix == "v" || suffix == "vh") {
+        return SystemVerilog;
+    }
+    return Cpp;
+}
+
+const KeywordTable& CodeHighlighter::keywordTable(Language language)
+{
+    static const KeywordTable cppTable(cppKeywords());
+    static const KeywordTable svTable(systemVerilogKeywords());
+    return language == SystemVerilog ? svTable : cppTable;
+}
+
+void CodeHighlighter::updateFormats()
+{
+    // Define color schemes based on theme
+    QColor keywordColor, typeColor, preprocessorColor, commentColor, stringColor, numberColor;
+
+    if (m_theme == Light) {
+        // Light theme colors
+        keywordColor = QColor(0, 0, 255);           // Blue
+        typeColor = QColor(43, 145, 175);           // Steel Blue
+        preprocessorColor = QColor(128, 0, 128);    // Purple
+        commentColor = QColor(0, 128, 0);           // Green
+        stringColor = QColor(163, 21, 21);          // Dark Red
+        numberColor = QColor(9, 134, 88);           // Teal
+    } else {
+        // Monokai theme colors
+        keywordColor = QColor(249, 38, 114);        // Pink
+        typeColor = QColor(102, 217, 239);          // Cyan
+        preprocessorColor = QColor(166, 226, 46);   // Light Green
+        commentColor = QColor(117, 113, 94);        // Gray
+        stringColor = QColor(230, 219, 116);        // Yellow
+        numberColor = QColor(174, 129, 255);        // Purple
+    }
+
+    for (QTextCharFormat& format : m_formats) {
+        format = QTextCharFormat();
+    }
+    m_formats[KeywordToken].setForeground(keywordColor);
+    m_formats[KeywordToken].setFontWeight(QFont::Bold);
+    m_formats[TypeToken].setForeground(typeColor);
+    m_formats[PreprocessorToken].setForeground(preprocessorColor);
+    m_formats[CommentToken].setForeground(commentColor);
+    m_formats[StringToken].setForeground(stringColor);
+    m_formats[NumberToken].setForeground(numberColor);
+}
+
+void CodeHighlighter::highlightBlock(const QString& text)
+{
+    if (m_viewportOnly) {
+        const int number = currentBlock().blockNumber();
+        if (number < m_windowFirst || number > m_windowLast) {
+            setCurrentBlockState(-1);
+            return;
+        }
+    }
+
+    const int length = text.length();
+    const bool sv = m_language == SystemVerilog;
+    const bool continued = length > 0 && text.at(length - 1) == QLatin1Char('\\');
+    int state = previousBlockState();
+    int i = 0;
+
+    // Resume a construct left open by the previous block
+    if (state == CommentState) {
+        const int end = text.indexOf(QLatin1String("*/"));
+        if (end < 0) {
+            setFormat(0, length, m_formats[CommentToken]);
+            setCurrentBlockState(CommentState);
+            return;
+        }
+        i = end + 2;
+        setFormat(0, i, m_formats[CommentToken]);
+    } else if (state == StringState) {
+        bool closed = false;
+        i = scanString(text, 0, QLatin1Char('"'), &closed);
+        setFormat(0, i, m_formats[StringToken]);
+        if (!closed) {
+            setCurrentBlockState(continued ? StringState : NormalState);
+            return;
+        }
+    } else if (state == PreprocessorState) {
+        setFormat(0, length, m_formats[PreprocessorToken]);
+        setCurrentBlockState(continued ? PreprocessorState : NormalState);
+        return;
+    }
+
+    state = NormalState;
+    bool atLineStart = i == 0;
+
+    while (i < length) {
+        const QChar c = text.at(i);
+
+        if (c.isSpace()) {
+            ++i;
+            continue;
+        }
+
+        // Comments
+        if (c == QLatin1Char('/') && i + 1 < length) {
+            const QChar next = text.at(i + 1);
+            if (next == QLatin1Char('/')) {
+                setFormat(i, length - i, m_formats[CommentToken]);
+                break;
+            }
+            if (next == QLatin1Char('*')) {
+                const int end = text.indexOf(QLatin1String("*/"), i + 2);
+                if (end < 0) {
+                    setFormat(i, length - i, m_formats[CommentToken]);
+                    state = CommentState;
+                    break;
+                }
+                setFormat(i, end + 2 - i, m_formats[CommentToken]);
+                i = end + 2;
+                atLineStart = false;
+                continue;
+            }
+        }
+
+        // C++ preprocessor lines, possibly continued with a backslash
+        if (!sv && atLineStart && c == QLatin1Char('#')) {
+            setFormat(i, length - i, m_formats[PreprocessorToken]);
+            if (continued) {
+                state = PreprocessorState;
+            }
+            break;
+        }
+        atLineStart = false;
+
+        // String literals (and C++ character literals)
+        if (c == QLatin1Char('"') || (!sv && c == QLatin1Char('\''))) {
+            bool closed = false;
+            const int end = scanString(text, i + 1, c, &closed);
+            setFormat(i, end - i, m_formats[StringToken]);
+            if (!closed && c == QLatin1Char('"') && continued) {
+                state = StringState;
+            }
+            i = end;
+            continue;
+        }
+
+        // SystemVerilog compiler directives and macro uses: `define, `include, `FOO
+        if (sv && c == QLatin1Char('`')) {
+            int end = i + 1;
+            while (end < length && isIdentifierChar(text.at(end), false)) {
+                ++end;
+            }
+            setFormat(i, end - i, m_formats[PreprocessorToken]);
+            i = end;
+            continue;
+        }
+
+        // Numbers, including SystemVerilog based literals such as 8'hFF and '0
+        if (c.isDigit() || (sv && c == QLatin1Char('\'') && isSvNumberStart(text, i))) {
+            const int end = scanNumber(text, i);
+            setFormat(i, end - i, m_formats[NumberToken]);
+            i = end;
+            continue;
+        }
+
+        // Identifiers, keywords and SystemVerilog system tasks ($display)
+        if (isIdentifierStart(c) || (sv && c == QLatin1Char('$'))) {
+            int end = i + 1;
+            while (end < length && isIdentifierChar(text.at(end), sv)) {
+                ++end;
+            }
+            const int kind = c == QLatin1Char('$')
+                ? int(KeywordToken)
+                : m_keywords->lookup(QStringView(text).mid(i, end - i));
+            if (kind >= 0) {
+                setFormat(i, end - i, m_formats[kind]);
+            }
+            i = end;
+            continue;
+        }
+
+        ++i;
+    }
+
+    setCurrentBlockState(state);
+}
+
+int CodeHighlighter::scanString(const QString& text, int start, QChar quote, bool* closed) const
+{
+    const int length = text.length();
+    int i = start;
+    while (i < length) {
+        const QChar c = text.at(i);
+        if (c == QLatin1Char('\\')) {
+            i += 2;
+            continue;
+        }
+        ++i;
+        if (c == quote) {
+            *closed = true;
+            return i;
+        }
+    }
+    *closed = false;
+    return length;
+}
+
+int CodeHighlighter::scanNumber(const QString& text, int start) const
+{
+    const int length = text.length();
+    const bool sv = m_language == SystemVerilog;
+    const bool hex = start + 1 < length && text.at(start) == QLatin1Char('0')
+        && (text.at(start + 1) == QLatin1Char('x') || text.at(start + 1) == QLatin1Char('X'));
+    bool based = false;
+    int i = start;
+
+    while (i < length) {
+        const QChar c = text.at(i);
+        if (c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('.')) {
+            ++i;
+            continue;
+        }
+        // SystemVerilog base marker (8'hFF, 'sd3) or C++14 digit separator (1'000)
+        if (c == QLatin1Char('\'') && i + 1 < length && text.at(i + 1).isLetterOrNumber()) {
+            based = true;
+            i += 2;
+            continue;
+        }
+        // SystemVerilog don't-care digits after the base: 4'b1??0
+        if (sv && based && c == QLatin1Char('?')) {
+            ++i;
+            continue;
+        }
+        // C++ exponent signs: 1e-3, 0x1p+4
+        if (!sv && (c == QLatin1Char('+') || c == QLatin1Char('-')) && i > start) {
+            const QChar prev = text.at(i - 1).toLower();
+            if ((!hex && prev == QLatin1Char('e')) || (hex && prev == QLatin1Char('p'))) {
+                ++i;
+                continue;
+            }
+        }
+        break;
+    }
+    return i;
+}
+
+bool CodeHighlighter::isSvNumberStart(const QString& text, int pos) const
+{
+    // Called on a quote: accepts 'b0, 'sh1F and the unbased fills '0 '1 'x 'z
+    int i = pos + 1;
+    if (i >= text.length()) {
+        return false;
+    }
+    const QChar first = text.at(i).toLower();
+    if (first == QLatin1Char('0') || first == QLatin1Char('1')
+        || first == QLatin1Char('x') || first == QLatin1Char('z')) {
+        return true;
+    }
+    if (first == QLatin1Char('s')) {
+        ++i;
+        if (i >= text.length()) {
+            return false;
+        }
+    }
+    const QChar base = text.at(i).toLower();
+    return base == QLatin1Char('b') || base == QLatin1Char('o')
+        || base == QLatin1Char('d') || base == QLatin1Char('h');
+}
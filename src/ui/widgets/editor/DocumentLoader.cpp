@@ -0,0 +1,144 @@
+// DocumentLoader.cpp
+#include "ui/widgets/editor/DocumentLoader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStringDecoder>
+
+DocumentLoader::DocumentLoader(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+DocumentLoader::~DocumentLoader()
+{
+    // The worker posts to this object, so it may not outlive it
+    cancel();
+    m_pool.waitForDone();
+}
+
+void DocumentLoader::start(const QString& filePath)
+{
+    cancel();
+
+    m_fileSize = QFileInfo(filePath).size();
+    m_bytesRead.store(0);
+    m_running = true;
+
+    int generation;
+    {
+        QMutexLocker locker(&m_mutex);
+        generation = m_generation.fetch_add(1) + 1;
+    }
+
+    m_pool.start([this, filePath, generation]() {
+        load(filePath, generation);
+    });
+}
+
+void DocumentLoader::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    m_generation.fetch_add(1);
+    m_chunks.clear();
+    m_queueNotFull.wakeAll();
+    m_running = false;
+}
+
+bool DocumentLoader::takeChunk(QString* chunk)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_chunks.isEmpty()) {
+        return false;
+    }
+    *chunk = m_chunks.dequeue();
+    m_queueNotFull.wakeAll();
+    return true;
+}
+
+void DocumentLoader::load(QString filePath, int generation)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        reportFinished(generation, false, file.errorString());
+        return;
+    }
+
+    QStringDecoder decoder(QStringDecoder::Utf8);
+    bool pendingCarriageReturn = false;
+
+    while (!file.atEnd()) {
+        if (generation != m_generation.load()) {
+            return;
+        }
+
+        const QByteArray raw = file.read(READ_BLOCK_SIZE);
+        if (raw.isEmpty()) {
+            break;
+        }
+        m_bytesRead.fetch_add(raw.size());
+
+        // Same translation as QIODevice::Text; a "\r\n" may straddle two blocks
+        QString text = decoder.decode(raw);
+        if (pendingCarriageReturn) {
+            text.prepend(QLatin1Char('\r'));
+            pendingCarriageReturn = false;
+        }
+        if (text.endsWith(QLatin1Char('\r'))) {
+            text.chop(1);
+            pendingCarriageReturn = true;
+        }
+        text.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+
+        if (!enqueue(text, generation)) {
+            return;
+        }
+    }
+
+    if (pendingCarriageReturn && !enqueue(QStringLiteral("\r"), generation)) {
+        return;
+    }
+
+    if (file.error() != QFileDevice::NoError) {
+        reportFinished(generation, false, file.errorString());
+        return;
+    }
+    reportFinished(generation, true, QString());
+}
+
+bool DocumentLoader::enqueue(QString chunk, int generation)
+{
+    QMutexLocker locker(&m_mutex);
+    while (m_chunks.size() >= MAX_QUEUED_CHUNKS && generation == m_generation.load()) {
+        m_queueNotFull.wait(&m_mutex);
+    }
+    if (generation != m_generation.load()) {
+        return false;
+    }
+
+    const bool wasEmpty = m_chunks.isEmpty();
+    m_chunks.enqueue(chunk);
+    locker.unlock();
+
+    // The consumer drains until empty, so it only needs a nudge on empty -> non-empty
+    if (wasEmpty) {
+        QMetaObject::invokeMethod(this, [this, generation]() {
+            if (generation == m_generation.load()) {
+                emit chunksAvailable();
+            }
+        }, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+void DocumentLoader::reportFinished(int generation, bool ok, const QString& errorString)
+{
+    QMetaObject::invokeMethod(this, [this, generation, ok, errorString]() {
+        if (generation != m_generation.load()) {
+            return;
+        }
+        m_running = false;
+        emit finished(ok, errorString);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,239 @@
+// FuzzyMatcher.cpp
+#include "ui/widgets/editor/FuzzyMatcher.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int MAX_START_POSITIONS = 4;
+
+inline int maskBit(uchar c)
+{
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a';
+    }
+    if (c >= '0' && c <= '9') {
+        return 26 + (c - '0');
+    }
+    switch (c) {
+    case '_': return 36;
+    case '/': return 37;
+    case '.': return 38;
+    case '-': return 39;
+    default: return 63;
+    }
+}
+
+} // namespace
+
+void FuzzyMatcher::setCandidates(const QStringList& candidates)
+{
+    clear();
+
+    int total = 0;
+    for (const QString& candidate : candidates) {
+        total += candidate.size();
+    }
+    m_folded.reserve(total);
+    m_boundaries.reserve(total);
+    m_offsets.reserve(candidates.size() + 1);
+    m_masks.reserve(candidates.size());
+
+    m_offsets.append(0);
+    for (const QString& candidate : candidates) {
+        const QByteArray folded = fold(candidate);
+        for (int i = 0; i < candidate.size(); ++i) {
+            const QChar c = candidate.at(i);
+            const QChar prev = i > 0 ? candidate.at(i - 1) : QChar();
+            const bool boundary = i == 0
+                || !prev.isLetterOrNumber()
+                || (prev.isLower() && c.isUpper())
+                || (!prev.isDigit() && c.isDigit());
+            m_boundaries.append(boundary ? '\1' : '\0');
+        }
+        m_folded.append(folded);
+        m_offsets.append(m_folded.size());
+        m_masks.append(characterMask(folded.constData(), folded.size()));
+    }
+}
+
+void FuzzyMatcher::clear()
+{
+    m_folded.clear();
+    m_boundaries.clear();
+    m_offsets.clear();
+    m_masks.clear();
+}
+
+QVector<FuzzyMatcher::Match> FuzzyMatcher::match(const QString& query, int limit) const
+{
+    return match(query, limit, nullptr);
+}
+
+QVector<FuzzyMatcher::Match> FuzzyMatcher::match(const QString& query, int limit, Narrowing* narrowing) const
+{
+    QVector<Match> results;
+    QString compact = query;
+    compact.remove(QLatin1Char(' '));
+    const QByteArray folded = fold(compact);
+    if (folded.isEmpty() || limit <= 0) {
+        if (narrowing) {
+            narrowing->reset();
+        }
+        return results;
+    }
+
+    const quint64 queryMask = characterMask(folded.constData(), folded.size());
+    const bool narrowed = narrowing && narrowing->valid && isSubsequence(narrowing->query, folded);
+
+    QVector<int> candidates;
+    if (narrowed) {
+        candidates.swap(narrowing->matched);
+    } else {
+        // Mask prefilter as a branch-free compaction over the contiguous
+        // mask array, which the compiler can vectorise
+        const int count = candidateCount();
+        candidates.resize(count);
+        const quint64* masks = m_masks.constData();
+        int* out = candidates.data();
+        int kept = 0;
+        for (int i = 0; i < count; ++i) {
+            out[kept] = i;
+            kept += int((masks[i] & queryMask) == queryMask);
+        }
+        candidates.resize(kept);
+    }
+
+    QVector<int> matched;
+    matched.reserve(candidates.size());
+    for (int i : candidates) {
+        const int s = score(i, folded, queryMask);
+        if (s >= 0) {
+            results.append({i, s});
+            matched.append(i);
+        }
+    }
+
+    if (narrowing) {
+        narrowing->query = folded;
+        narrowing->matched.swap(matched);
+        narrowing->valid = true;
+    }
+
+    // Best score first; shorter candidates, then list order break ties
+    auto better = [this](const Match& a, const Match& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        const int lengthA = m_offsets.at(a.index + 1) - m_offsets.at(a.index);
+        const int lengthB = m_offsets.at(b.index + 1) - m_offsets.at(b.index);
+        if (lengthA != lengthB) {
+            return lengthA < lengthB;
+        }
+        return a.index < b.index;
+    };
+    if (results.size() > limit) {
+        std::partial_sort(results.begin(), results.begin() + limit, results.end(), better);
+        results.resize(limit);
+    } else {
+        std::sort(results.begin(), results.end(), better);
+    }
+    return results;
+}
+
+int FuzzyMatcher::score(int index, const QByteArray& foldedQuery, quint64 queryMask) const
+{
+    if ((m_masks.at(index) & queryMask) != queryMask) {
+        return -1;
+    }
+
+    const int start = m_offsets.at(index);
+    const int length = m_offsets.at(index + 1) - start;
+    const int queryLength = foldedQuery.size();
+    if (queryLength == 0 || queryLength > length) {
+        return -1;
+    }
+
+    const char* text = m_folded.constData() + start;
+    const char* boundaries = m_boundaries.constData() + start;
+    const char* query = foldedQuery.constData();
+
+    // Greedy walks from the first few occurrences of the query's first
+    // character; the best one usually starts on a word boundary
+    int best = -1;
+    int tries = 0;
+    for (int first = 0; first <= length - queryLength && tries < MAX_START_POSITIONS; ++first) {
+        if (text[first] != query[0]) {
+            continue;
+        }
+        ++tries;
+
+        int qi = 0;
+        int total = 0;
+        int prev = -2;
+        for (int ci = first; ci < length && qi < queryLength; ++ci) {
+            if (text[ci] != query[qi]) {
+                continue;
+            }
+            int bonus = 1;
+            if (boundaries[ci]) {
+                bonus += ci == 0 ? 12 : 8;
+            }
+            if (prev == ci - 1) {
+                bonus += 6;
+            } else if (prev >= 0) {
+                total -= qMin(ci - prev - 1, 4);
+            }
+            total += bonus;
+            prev = ci;
+            ++qi;
+        }
+        if (qi < queryLength) {
+            break;  // Later starts cannot match either
+        }
+
+        total -= qMin(first, 8);
+        total -= (length - queryLength) / 8;
+        if (length == queryLength) {
+            total += 10;
+        }
+        best = qMax(best, qMax(0, total));
+    }
+    return best;
+}
+
+QByteArray FuzzyMatcher::fold(const QString& text)
+{
+    QByteArray folded(text.size(), Qt::Uninitialized);
+    char* out = folded.data();
+    for (int i = 0; i < text.size(); ++i) {
+        const ushort u = text.at(i).unicode();
+        if (u >= 'A' && u <= 'Z') {
+            out[i] = char(u - 'A' + 'a');
+        } else if (u < 0x80) {
+            out[i] = char(u);
+        } else {
+            out[i] = '\x7f';
+        }
+    }
+    return folded;
+}
+
+bool FuzzyMatcher::isSubsequence(const QByteArray& needle, const QByteArray& haystack)
+{
+    int ni = 0;
+    for (int hi = 0; hi < haystack.size() && ni < needle.size(); ++hi) {
+        if (haystack.at(hi) == needle.at(ni)) {
+            ++ni;
+        }
+    }
+    return ni == needle.size();
+}
+
+quint64 FuzzyMatcher::characterMask(const char* data, int length)
+{
+    quint64 mask = 0;
+    for (int i = 0; i < length; ++i) {
+        mask |= quint64(1) << maskBit(uchar(data[i]));
+    }
+    return mask;
+}
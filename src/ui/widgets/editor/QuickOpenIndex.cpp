@@ -0,0 +1,209 @@
+// QuickOpenIndex.cpp
+#include "ui/widgets/editor/QuickOpenIndex.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <algorithm>
+
+QuickOpenIndex::QuickOpenIndex(SymbolIndex* symbols, QObject* parent)
+    : QObject(parent)
+    , m_symbols(symbols)
+{
+    m_pool.setMaxThreadCount(1);
+
+    if (m_symbols) {
+        connect(m_symbols, &SymbolIndex::indexUpdated, this, [this]() {
+            m_modulesDirty = true;
+        });
+    }
+}
+
+QuickOpenIndex::~QuickOpenIndex()
+{
+    // Workers post to this object, so none may outlive it
+    m_generation.fetch_add(1);
+    m_pool.waitForDone();
+}
+
+void QuickOpenIndex::setRoot(const QString& rootPath)
+{
+    m_root = rootPath.isEmpty() ? QString() : QDir(rootPath).absolutePath();
+    m_paths.clear();
+    m_pathMatcher.clear();
+    m_nameMatcher.clear();
+    m_pathNarrowing.reset();
+    m_modulesDirty = true;
+    refresh();
+}
+
+void QuickOpenIndex::refresh()
+{
+    const int generation = m_generation.fetch_add(1) + 1;
+    if (m_root.isEmpty()) {
+        m_scanning = false;
+        emit indexChanged();
+        return;
+    }
+
+    m_scanning = true;
+    const QString root = m_root;
+    m_pool.start([this, root, generation]() {
+        const ScanResult result = scan(this, root, generation);
+        QMetaObject::invokeMethod(this, [this, generation, result]() {
+            applyScan(generation, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+int QuickOpenIndex::moduleCount()
+{
+    if (m_modulesDirty) {
+        rebuildModules();
+    }
+    return m_modules.size();
+}
+
+QVector<QuickOpenIndex::Entry> QuickOpenIndex::query(const QString& text, int limit)
+{
+    if (m_modulesDirty) {
+        rebuildModules();
+    }
+
+    QVector<Entry> results = queryFiles(text, limit);
+    results += queryModules(text, limit);
+
+    // Files win ties: they come first and the sort is stable
+    std::stable_sort(results.begin(), results.end(), [](const Entry& a, const Entry& b) {
+        return a.score > b.score;
+    });
+    if (results.size() > limit) {
+        results.resize(limit);
+    }
+    return results;
+}
+
+QVector<QuickOpenIndex::Entry> QuickOpenIndex::queryFiles(const QString& text, int limit)
+{
+    QVector<Entry> results;
+    const QVector<FuzzyMatcher::Match> matches = m_pathMatcher.match(text, limit * RERANK_FACTOR, &m_pathNarrowing);
+    if (matches.isEmpty()) {
+        return results;
+    }
+
+    // Re-score the best path matches by file name, so "alu" prefers rtl/alu.sv
+    // over a/long/u_path.sv
+    QString compact = text;
+    compact.remove(QLatin1Char(' '));
+    const QByteArray folded = FuzzyMatcher::fold(compact);
+    const quint64 queryMask = FuzzyMatcher::characterMask(folded.constData(), folded.size());
+
+    results.reserve(matches.size());
+    for (const FuzzyMatcher::Match& match : matches) {
+        const QString& relative = m_paths.at(match.index);
+        const int slash = relative.lastIndexOf(QLatin1Char('/'));
+
+        Entry entry;
+        entry.title = relative.mid(slash + 1);
+        entry.subtitle = slash > 0 ? relative.left(slash) : QString();
+        entry.filePath = m_root + QLatin1Char('/') + relative;
+        entry.score = match.score;
+        const int nameScore = m_nameMatcher.score(match.index, folded, queryMask);
+        if (nameScore >= 0) {
+            entry.score = qMax(entry.score, nameScore + FILE_NAME_BONUS);
+        }
+        results.append(entry);
+    }
+    return results;
+}
+
+QVector<QuickOpenIndex::Entry> QuickOpenIndex::queryModules(const QString& text, int limit)
+{
+    QVector<Entry> results;
+    const QVector<FuzzyMatcher::Match> matches = m_moduleMatcher.match(text, limit, &m_moduleNarrowing);
+    results.reserve(matches.size());
+    for (const FuzzyMatcher::Match& match : matches) {
+        const SymbolMatch& module = m_modules.at(match.index);
+
+        Entry entry;
+        entry.title = module.name;
+        entry.subtitle = QString("%1 in %2:%3")
+                             .arg(SymbolIndex::kindToString(module.kind))
+                             .arg(relativePath(module.location.filePath))
+                             .arg(module.location.line);
+        entry.filePath = module.location.filePath;
+        entry.line = module.location.line;
+        entry.column = module.location.column;
+        entry.module = true;
+        entry.score = match.score;
+        results.append(entry);
+    }
+    return results;
+}
+
+void QuickOpenIndex::applyScan(int generation, const ScanResult& result)
+{
+    if (generation != m_generation.load()) {
+        return;
+    }
+
+    m_paths = result.paths;
+    m_pathMatcher = result.pathMatcher;
+    m_nameMatcher = result.nameMatcher;
+    m_pathNarrowing.reset();
+    m_scanning = false;
+
+    qDebug() << "📂 Quick open index:" << m_paths.size() << "files under" << m_root;
+    emit indexChanged();
+}
+
+void QuickOpenIndex::rebuildModules()
+{
+    m_modules = m_symbols ? m_symbols->modules() : QVector<SymbolMatch>();
+    QStringList names;
+    names.reserve(m_modules.size());
+    for (const SymbolMatch& module : m_modules) {
+        names.append(module.name);
+    }
+    m_moduleMatcher.setCandidates(names);
+    m_moduleNarrowing.reset();
+    m_modulesDirty = false;
+}
+
+QString QuickOpenIndex::relativePath(const QString& filePath) const
+{
+    if (!m_root.isEmpty() && filePath.startsWith(m_root + QLatin1Char('/'))) {
+        return filePath.mid(m_root.size() + 1);
+    }
+    return QFileInfo(filePath).fileName();
+}
+
+QuickOpenIndex::ScanResult QuickOpenIndex::scan(QuickOpenIndex* receiver, const QString& rootPath, int generation)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Hidden directories (.git and friends) are not descended into
+    ScanResult result;
+    QStringList names;
+    QDirIterator it(rootPath, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext() && result.paths.size() < MAX_FILES) {
+        const QString path = it.next();
+        if (generation != receiver->m_generation.load()) {
+            return ScanResult();
+        }
+        // Verilator's generated C++ would swamp the results
+        if (path.contains(QLatin1String("/obj_dir/"))) {
+            continue;
+        }
+        result.paths.append(path.mid(rootPath.size() + 1));
+        names.append(it.fileName());
+    }
+
+    result.pathMatcher.setCandidates(result.paths);
+    result.nameMatcher.setCandidates(names);
+
+    qDebug() << "📂 Scanned" << result.paths.size() << "files in" << timer.elapsed() << "ms";
+    return result;
+}
@@ -0,0 +1,148 @@
+// QuickOpenPalette.cpp
+#include "ui/widgets/editor/QuickOpenPalette.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QKeyEvent>
+
+QuickOpenPalette::QuickOpenPalette(QuickOpenIndex* index, QWidget* parent)
+    : QDialog(parent, Qt::Popup)
+    , m_index(index)
+    , m_layout(nullptr)
+    , m_queryEdit(nullptr)
+    , m_resultList(nullptr)
+    , m_statusLabel(nullptr)
+{
+    setupUI();
+
+    connect(m_queryEdit, &QLineEdit::textChanged, this, &QuickOpenPalette::onQueryChanged);
+    connect(m_queryEdit, &QLineEdit::returnPressed, this, &QuickOpenPalette::activateCurrent);
+    connect(m_resultList, &QListWidget::itemActivated, this, &QuickOpenPalette::activateCurrent);
+    connect(m_index, &QuickOpenIndex::indexChanged, this, &QuickOpenPalette::onIndexChanged);
+}
+
+void QuickOpenPalette::showPalette()
+{
+    // Files added since the last scan show up once the rescan lands
+    if (!m_index->isScanning()) {
+        m_index->refresh();
+    }
+
+    if (QWidget* host = parentWidget()) {
+        const QPoint topCenter = host->mapToGlobal(QPoint(host->width() / 2, 0));
+        move(topCenter.x() - width() / 2, topCenter.y() + 40);
+    }
+    populate(m_queryEdit->text());
+    show();
+    raise();
+    activateWindow();
+    m_queryEdit->setFocus();
+    m_queryEdit->selectAll();
+}
+
+bool QuickOpenPalette::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_queryEdit && event->type() == QEvent::KeyPress) {
+        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        switch (keyEvent->key()) {
+            case Qt::Key_Up:
+            case Qt::Key_Down:
+            case Qt::Key_PageUp:
+            case Qt::Key_PageDown:
+                QCoreApplication::sendEvent(m_resultList, event);
+                return true;
+            case Qt::Key_Escape:
+                reject();
+                return true;
+            default:
+                break;
+        }
+    }
+    return QDialog::eventFilter(watched, event);
+}
+
+void QuickOpenPalette::onQueryChanged(const QString& query)
+{
+    populate(query);
+}
+
+void QuickOpenPalette::activateCurrent()
+{
+    QListWidgetItem* item = m_resultList->currentItem();
+    if (!item) {
+        return;
+    }
+
+    const QString filePath = item->data(FilePathRole).toString();
+    const int line = item->data(LineRole).toInt();
+    const int column = item->data(ColumnRole).toInt();
+    accept();
+    emit fileActivated(filePath, line, column);
+}
+
+void QuickOpenPalette::onIndexChanged()
+{
+    if (isVisible()) {
+        populate(m_queryEdit->text());
+    }
+}
+
+void QuickOpenPalette::populate(const QString& query)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QVector<QuickOpenIndex::Entry> entries = m_index->query(query);
+
+    // Updates are suspended so the list lays out once, not once per row
+    m_resultList->setUpdatesEnabled(false);
+    m_resultList->clear();
+    for (const QuickOpenIndex::Entry& entry : entries) {
+        QString text = entry.module ? "◆ " + entry.title : entry.title;
+        if (!entry.subtitle.isEmpty()) {
+            text += "   " + entry.subtitle;
+        }
+        QListWidgetItem* item = new QListWidgetItem(text, m_resultList);
+        item->setToolTip(entry.filePath);
+        item->setData(FilePathRole, entry.filePath);
+        item->setData(LineRole, entry.line);
+        item->setData(ColumnRole, entry.column);
+    }
+    if (m_resultList->count() > 0) {
+        m_resultList->setCurrentRow(0);
+    }
+    m_resultList->setUpdatesEnabled(true);
+
+    const QString counts = QString("%1 files, %2 modules").arg(m_index->fileCount()).arg(m_index->moduleCount());
+    if (query.trimmed().isEmpty()) {
+        m_statusLabel->setText(m_index->isScanning() ? "Scanning project... " + counts : "Type to search " + counts);
+    } else {
+        m_statusLabel->setText(QString("%1 matches in %2 (%3 ms)")
+                                   .arg(entries.size())
+                                   .arg(counts)
+                                   .arg(timer.elapsed()));
+    }
+}
+
+void QuickOpenPalette::setupUI()
+{
+    resize(PALETTE_WIDTH, PALETTE_HEIGHT);
+
+    m_layout = new QVBoxLayout(this);
+    m_layout->setContentsMargins(6, 6, 6, 6);
+    m_layout->setSpacing(4);
+
+    m_queryEdit = new QLineEdit(this);
+    m_queryEdit->setPlaceholderText("Search files by name or path, or modules by name");
+    m_queryEdit->setClearButtonEnabled(true);
+    m_queryEdit->installEventFilter(this);
+    m_layout->addWidget(m_queryEdit);
+
+    m_resultList = new QListWidget(this);
+    m_resultList->setUniformItemSizes(true);
+    m_resultList->setFocusPolicy(Qt::NoFocus);
+    m_layout->addWidget(m_resultList, 1);
+
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setStyleSheet("QLabel { color: #888; font-size: 11px; }");
+    m_layout->addWidget(m_statusLabel);
+}
@@ -0,0 +1,1063 @@
+// SymbolIndex.cpp
+#include "ui/widgets/editor/SymbolIndex.h"
+#include "ui/widgets/editor/CodeHighlighter.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+namespace {
+
+constexpr int MAX_DETAIL_LENGTH = 80;
+constexpr int MAX_PREVIEW_LENGTH = 200;
+constexpr int HEADER_LOOKAHEAD_TOKENS = 32;
+
+struct Token {
+    int start;
+    int length;
+    int line;
+    int column;
+    bool identifier;
+};
+
+inline bool isIdentifierChar(QChar c, bool sv)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || (sv && c == QLatin1Char('$'));
+}
+
+/**
+ * Splits source text into identifiers and single-character punctuation.
+ * Comments, strings, numbers, SV compiler directives and C++ preprocessor
+ * lines are dropped, so keywords inside them never look like declarations.
+ */
+QVector<Token> tokenize(const QString& text, bool sv)
+{
+    QVector<Token> tokens;
+    const QChar* data = text.constData();
+    const int length = text.size();
+    int line = 1;
+    int lineStart = 0;
+    bool atLineStart = true;
+    int i = 0;
+
+    auto newline = [&](int pos) {
+        ++line;
+        lineStart = pos + 1;
+    };
+
+    while (i < length) {
+        const QChar c = data[i];
+
+        if (c == QLatin1Char('\n')) {
+            newline(i);
+            atLineStart = true;
+            ++i;
+            continue;
+        }
+        if (c.isSpace()) {
+            ++i;
+            continue;
+        }
+
+        // Comments
+        if (c == QLatin1Char('/') && i + 1 < length && data[i + 1] == QLatin1Char('/')) {
+            while (i < length && data[i] != QLatin1Char('\n')) {
+                ++i;
+            }
+            continue;
+        }
+        if (c == QLatin1Char('/') && i + 1 < length && data[i + 1] == QLatin1Char('*')) {
+            i += 2;
+            while (i < length && !(data[i] == QLatin1Char('*') && i + 1 < length && data[i + 1] == QLatin1Char('/'))) {
+                if (data[i] == QLatin1Char('\n')) {
+                    newline(i);
+                }
+                ++i;
+            }
+            i = qMin(length, i + 2);
+            atLineStart = false;
+            continue;
+        }
+
+        // C++ preprocessor directives, including backslash continuations
+        if (!sv && atLineStart && c == QLatin1Char('#')) {
+            while (i < length && data[i] != QLatin1Char('\n')) {
+                if (data[i] == QLatin1Char('\\') && i + 1 < length && data[i + 1] == QLatin1Char('\n')) {
+                    newline(i + 1);
+                    i += 2;
+                    continue;
+                }
+                ++i;
+            }
+            continue;
+        }
+        atLineStart = false;
+
+        // String and C++ character literals
+        if (c == QLatin1Char('"') || (!sv && c == QLatin1Char('\''))) {
+            ++i;
+            while (i < length && data[i] != c && data[i] != QLatin1Char('\n')) {
+                if (data[i] == QLatin1Char('\\') && i + 1 < length) {
+                    if (data[i + 1] == QLatin1Char('\n')) {
+                        newline(i + 1);
+                    }
+                    i += 2;
+                    continue;
+                }
+                ++i;
+            }
+            if (i < length && data[i] == c) {
+                ++i;
+            }
+            continue;
+        }
+
+        // SV compiler directives and macro uses
+        if (sv && c == QLatin1Char('`')) {
+            ++i;
+            while (i < length && isIdentifierChar(data[i], false)) {
+                ++i;
+            }
+            continue;
+        }
+
+        // Numbers, including SV based literals (8'hFF, 'b0)
+        if (c.isDigit() || (sv && c == QLatin1Char('\''))) {
+            ++i;
+            while (i < length && (data[i].isLetterOrNumber() || data[i] == QLatin1Char('_')
+                                  || data[i] == QLatin1Char('\'') || data[i] == QLatin1Char('.'))) {
+                ++i;
+            }
+            continue;
+        }
+
+        // SV escaped identifiers run to the next whitespace
+        if (sv && c == QLatin1Char('\\')) {
+            while (i < length && !data[i].isSpace()) {
+                ++i;
+            }
+            continue;
+        }
+
+        if (c.isLetter() || c == QLatin1Char('_') || (sv && c == QLatin1Char('$'))) {
+            const int start = i++;
+            while (i < length && isIdentifierChar(data[i], sv)) {
+                ++i;
+            }
+            tokens.append({start, i - start, line, start - lineStart + 1, true});
+            continue;
+        }
+
+        tokens.append({i, 1, line, i - lineStart + 1, false});
+        ++i;
+    }
+    return tokens;
+}
+
+/**
+ * Read-only cursor over a token list with bounds-checked accessors.
+ */
+class TokenReader
+{
+public:
+    TokenReader(const QString& text, const QVector<Token>& tokens)
+        : m_text(text), m_tokens(tokens)
+    {
+    }
+
+    int count() const { return m_tokens.size(); }
+    const Token& at(int i) const { return m_tokens.at(i); }
+
+    bool isIdentifier(int i) const { return i >= 0 && i < m_tokens.size() && m_tokens.at(i).identifier; }
+
+    bool isPunct(int i, char c) const
+    {
+        return i >= 0 && i < m_tokens.size() && !m_tokens.at(i).identifier
+            && m_text.at(m_tokens.at(i).start) == QLatin1Char(c);
+    }
+
+    QStringView word(int i) const
+    {
+        if (!isIdentifier(i)) {
+            return QStringView();
+        }
+        return QStringView(m_text).mid(m_tokens.at(i).start, m_tokens.at(i).length);
+    }
+
+    // Source text from token @p first up to (not including) token @p last
+    QString textBetween(int first, int last) const
+    {
+        const int start = m_tokens.at(first).start;
+        const int end = last < m_tokens.size() ? m_tokens.at(last).start : m_text.size();
+        return m_text.mid(start, end - start).simplified().left(MAX_DETAIL_LENGTH);
+    }
+
+    SymbolIndex::ParsedSymbol symbol(int i, quint8 kind, const QString& container, const QString& detail) const
+    {
+        SymbolIndex::ParsedSymbol s;
+        s.name = word(i).toString();
+        s.container = container;
+        s.detail = detail;
+        s.line = m_tokens.at(i).line;
+        s.column = m_tokens.at(i).column;
+        s.kind = kind;
+        return s;
+    }
+
+private:
+    const QString& m_text;
+    const QVector<Token>& m_tokens;
+};
+
+bool isDirection(QStringView w)
+{
+    return w == u"input" || w == u"output" || w == u"inout" || w == u"ref";
+}
+
+bool isParameterKeyword(QStringView w)
+{
+    return w == u"parameter" || w == u"localparam";
+}
+
+bool isScPortType(QStringView w)
+{
+    static const QSet<QString> types = {
+        "sc_in", "sc_out", "sc_inout", "sc_in_clk", "sc_out_clk", "sc_inout_clk",
+        "sc_in_rv", "sc_out_rv", "sc_inout_rv", "sc_in_resolved", "sc_out_resolved",
+        "sc_inout_resolved", "sc_fifo_in", "sc_fifo_out", "sc_port", "sc_export"
+    };
+    return w.startsWith(u"sc_") && types.contains(w.toString());
+}
+
+/**
+ * Parses "input logic [7:0] a, b" / "parameter int W = 8, D = 4" style lists
+ * starting at keyword token @p first. Every name gets the declaration text in
+ * front of the first one as detail. Returns the token to continue from: after
+ * the closing ';', or at a ')' that closes an ANSI list, or at a keyword that
+ * starts the next declaration of the same list.
+ */
+int parseDeclarationList(const TokenReader& r, int first, quint8 kind, const QString& container,
+                         bool (*startsDeclaration)(QStringView), QVector<SymbolIndex::ParsedSymbol>& out)
+{
+    const int n = r.count();
+    int nameToken = -1;
+    int bracket = 0;
+    int nesting = 0;
+    bool inValue = false;
+    QString detail;
+
+    auto emitName = [&]() {
+        if (nameToken < 0) {
+            return;
+        }
+        if (detail.isEmpty()) {
+            detail = r.textBetween(first, nameToken);
+        }
+        out.append(r.symbol(nameToken, kind, container, detail));
+        nameToken = -1;
+    };
+
+    for (int j = first + 1; j < n; ++j) {
+        if (r.isPunct(j, '[')) {
+            ++bracket;
+        } else if (r.isPunct(j, ']')) {
+            bracket = qMax(0, bracket - 1);
+        } else if (bracket > 0) {
+            continue;
+        } else if (r.isPunct(j, '(') || r.isPunct(j, '{')) {
+            ++nesting;
+        } else if (r.isPunct(j, ')') || r.isPunct(j, '}')) {
+            if (nesting == 0) {
+                emitName();
+                return j;
+            }
+            --nesting;
+        } else if (nesting > 0) {
+            continue;
+        } else if (r.isPunct(j, '=')) {
+            emitName();
+            inValue = true;
+        } else if (r.isPunct(j, ',')) {
+            emitName();
+            inValue = false;
+            if (startsDeclaration(r.word(j + 1))) {
+                return j + 1;
+            }
+        } else if (r.isPunct(j, ';')) {
+            emitName();
+            return j + 1;
+        } else if (r.isIdentifier(j) && !inValue) {
+            nameToken = j;
+        }
+    }
+    emitName();
+    return n;
+}
+
+// Prototypes ("extern function", "pure virtual task", DPI imports) have no body
+bool declaresPrototype(const TokenReader& r, int keyword)
+{
+    for (int k = keyword - 1; k >= 0 && k >= keyword - 3; --k) {
+        const QStringView w = r.word(k);
+        if (w == u"extern" || w == u"pure" || w == u"import" || w == u"export") {
+            return true;
+        }
+    }
+    return false;
+}
+
+void parseSystemVerilog(const TokenReader& r, QVector<SymbolIndex::ParsedSymbol>& out)
+{
+    const int n = r.count();
+    QString module;
+    bool inRoutine = false;   // Task/function arguments reuse the port keywords
+    bool inClocking = false;
+    int i = 0;
+
+    while (i < n) {
+        if (!r.isIdentifier(i)) {
+            ++i;
+            continue;
+        }
+        const QStringView w = r.word(i);
+
+        if (w == u"module" || w == u"macromodule" || w == u"interface" || w == u"program" || w == u"package") {
+            int j = i + 1;
+            if (r.word(j) == u"automatic" || r.word(j) == u"static") {
+                ++j;
+            }
+            if (r.isIdentifier(j) && !(w == u"interface" && r.word(j) == u"class")) {
+                out.append(r.symbol(j, SymbolIndex::ModuleSymbol, QString(), w.toString()));
+                module = r.word(j).toString();
+                i = j + 1;
+                continue;
+            }
+        } else if (w == u"endmodule" || w == u"endinterface" || w == u"endprogram" || w == u"endpackage") {
+            module.clear();
+        } else if (w == u"function" || w == u"task") {
+            if (!declaresPrototype(r, i)) {
+                inRoutine = true;
+            }
+        } else if (w == u"endfunction" || w == u"endtask") {
+            inRoutine = false;
+        } else if (w == u"clocking") {
+            inClocking = true;
+        } else if (w == u"endclocking") {
+            inClocking = false;
+        } else if (w == u"modport") {
+            while (i < n && !r.isPunct(i, ';')) {
+                ++i;
+            }
+            continue;
+        } else if (isDirection(w) && !module.isEmpty() && !inRoutine && !inClocking) {
+            i = parseDeclarationList(r, i, SymbolIndex::PortSymbol, module, &isDirection, out);
+            continue;
+        } else if (isParameterKeyword(w) && !inRoutine) {
+            i = parseDeclarationList(r, i, SymbolIndex::ParameterSymbol, module, &isParameterKeyword, out);
+            continue;
+        }
+        ++i;
+    }
+}
+
+// "sc_in<sc_uint<8>> a, b;" starting at the port type token; returns the token to continue from
+int parseScPorts(const TokenReader& r, int first, const QString& module, QVector<SymbolIndex::ParsedSymbol>& out)
+{
+    const int n = r.count();
+    int j = first + 1;
+    if (r.isPunct(j, '<')) {
+        int angle = 0;
+        for (; j < n; ++j) {
+            if (r.isPunct(j, '<')) {
+                ++angle;
+            } else if (r.isPunct(j, '>') && --angle == 0) {
+                ++j;
+                break;
+            } else if (r.isPunct(j, ';')) {
+                return j + 1;
+            }
+        }
+    }
+    if (j >= n) {
+        return n;
+    }
+
+    const QString detail = r.textBetween(first, j);
+    int nameToken = -1;
+    int nesting = 0;
+    for (; j < n; ++j) {
+        if (r.isPunct(j, '(') || r.isPunct(j, '{')) {
+            ++nesting;
+        } else if (r.isPunct(j, ')') || r.isPunct(j, '}')) {
+            if (nesting == 0) {
+                return j;
+            }
+            --nesting;
+        } else if (nesting > 0) {
+            continue;
+        } else if (r.isPunct(j, ',') || r.isPunct(j, ';')) {
+            if (nameToken >= 0) {
+                out.append(r.symbol(nameToken, SymbolIndex::ScPortSymbol, module, detail));
+                nameToken = -1;
+            }
+            if (r.isPunct(j, ';')) {
+                return j + 1;
+            }
+        } else if (r.isIdentifier(j) && nameToken < 0) {
+            nameToken = j;
+        }
+    }
+    return n;
+}
+
+void parseSystemC(const TokenReader& r, QVector<SymbolIndex::ParsedSymbol>& out)
+{
+    const int n = r.count();
+    int depth = 0;
+    QString module;
+    int moduleDepth = -1;
+    int pendingName = -1;      // Module name whose body has not opened yet
+    QString pendingDetail;
+
+    for (int i = 0; i < n; ++i) {
+        if (r.isPunct(i, '{')) {
+            ++depth;
+            if (pendingName >= 0) {
+                out.append(r.symbol(pendingName, SymbolIndex::ScModuleSymbol, QString(), pendingDetail));
+                module = r.word(pendingName).toString();
+                moduleDepth = depth;
+                pendingName = -1;
+            }
+            continue;
+        }
+        if (r.isPunct(i, '}')) {
+            if (depth == moduleDepth) {
+                module.clear();
+                moduleDepth = -1;
+            }
+            depth = qMax(0, depth - 1);
+            continue;
+        }
+        if (r.isPunct(i, ';')) {
+            pendingName = -1;  // Forward declaration
+            continue;
+        }
+        if (!r.isIdentifier(i)) {
+            continue;
+        }
+
+        const QStringView w = r.word(i);
+        if (w == u"SC_MODULE" && r.isPunct(i + 1, '(') && r.isIdentifier(i + 2) && r.isPunct(i + 3, ')')) {
+            pendingName = i + 2;
+            pendingDetail = QStringLiteral("SC_MODULE");
+            i += 3;
+        } else if ((w == u"struct" || w == u"class") && r.isIdentifier(i + 1)) {
+            // struct name : public sc_core::sc_module {
+            for (int j = i + 2; j < n && j < i + HEADER_LOOKAHEAD_TOKENS; ++j) {
+                if (r.isPunct(j, '{') || r.isPunct(j, ';')) {
+                    break;
+                }
+                if (r.word(j) == u"sc_module") {
+                    pendingName = i + 1;
+                    pendingDetail = w.toString() + QStringLiteral(" : sc_module");
+                    break;
+                }
+            }
+        } else if (!module.isEmpty() && depth == moduleDepth && isScPortType(w)) {
+            i = parseScPorts(r, i, module, out) - 1;
+        }
+    }
+}
+
+bool readSource(const QString& filePath, QString* text)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    *text = QString::fromUtf8(file.readAll());
+    return true;
+}
+
+int kindRank(quint8 kind)
+{
+    switch (kind) {
+    case SymbolIndex::ModuleSymbol:
+    case SymbolIndex::ScModuleSymbol:
+        return 0;
+    case SymbolIndex::ParameterSymbol:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+} // namespace
+
+SymbolIndex::SymbolIndex(QObject* parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+    m_referencePool.setMaxThreadCount(1);
+    m_palettePool.setMaxThreadCount(1);
+}
+
+SymbolIndex::~SymbolIndex()
+{
+    // Workers post to this object, so none may outlive it
+    m_generation.fetch_add(1);
+    m_pool.waitForDone();
+    m_referencePool.waitForDone();
+    m_palettePool.waitForDone();
+}
+
+void SymbolIndex::setRoot(const QString& rootPath)
+{
+    const int generation = m_generation.fetch_add(1) + 1;
+
+    m_root = rootPath.isEmpty() ? QString() : QDir(rootPath).absolutePath();
+    m_strings.clear();
+    m_stringRefs.clear();
+    m_freeStrings.clear();
+    m_stringIds.clear();
+    m_files.clear();
+    m_fileIds.clear();
+    m_definitions.clear();
+    m_palette.clear();
+    m_paletteNames.clear();
+    m_paletteNarrowing.reset();
+
+    if (m_root.isEmpty()) {
+        m_building = false;
+        emit indexUpdated();
+        return;
+    }
+
+    m_building = true;
+    emit indexingStarted();
+    emit indexUpdated();
+
+    const QString root = m_root;
+    m_pool.start([this, root, generation]() {
+        build(this, root, generation);
+    });
+}
+
+void SymbolIndex::updateFile(const QString& filePath, const QString& text)
+{
+    if (!isIndexedFile(filePath) || text.size() > MAX_FILE_SIZE) {
+        return;
+    }
+
+    const int generation = m_generation.load();
+    m_pool.start([this, filePath, text, generation]() {
+        ParsedFile parsed = parse(filePath, text);
+        parsed.modified = QFileInfo(filePath).lastModified().toMSecsSinceEpoch();
+        QMetaObject::invokeMethod(this, [this, generation, parsed]() {
+            applyParsed(generation, {parsed});
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SymbolIndex::updateFile(const QString& filePath)
+{
+    if (!isIndexedFile(filePath)) {
+        return;
+    }
+
+    const int generation = m_generation.load();
+    m_pool.start([this, filePath, generation]() {
+        const ParsedFile parsed = parseFromDisk(filePath);
+        QMetaObject::invokeMethod(this, [this, generation, parsed]() {
+            applyParsed(generation, {parsed});
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SymbolIndex::removeFile(const QString& filePath)
+{
+    const auto it = m_fileIds.constFind(filePath);
+    if (it == m_fileIds.constEnd()) {
+        return;
+    }
+
+    dropSymbols(it.value());
+    FileEntry& entry = m_files[int(it.value())];
+    entry.live = false;
+    entry.identifierHashes.clear();
+    rebuildPalette();
+    emit indexUpdated();
+}
+
+int SymbolIndex::fileCount() const
+{
+    int count = 0;
+    for (const FileEntry& entry : m_files) {
+        if (entry.live) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+QStringList SymbolIndex::files() const
+{
+    QStringList paths;
+    paths.reserve(m_files.size());
+    for (const FileEntry& entry : m_files) {
+        if (entry.live) {
+            paths.append(entry.filePath);
+        }
+    }
+    return paths;
+}
+
+QVector<SymbolLocation> SymbolIndex::definitions(const QString& name) const
+{
+    QVector<SymbolLocation> locations;
+    const auto id = m_stringIds.constFind(name);
+    if (id == m_stringIds.constEnd()) {
+        return locations;
+    }
+
+    QVector<const Symbol*> symbols;
+    for (auto it = m_definitions.constFind(id.value()); it != m_definitions.constEnd() && it.key() == id.value(); ++it) {
+        symbols.append(&m_files.at(int(it.value() >> 32)).symbols.at(int(it.value() & 0xffffffffu)));
+    }
+    std::sort(symbols.begin(), symbols.end(), [this](const Symbol* a, const Symbol* b) {
+        if (kindRank(a->kind) != kindRank(b->kind)) {
+            return kindRank(a->kind) < kindRank(b->kind);
+        }
+        if (a->file != b->file) {
+            return m_files.at(int(a->file)).filePath < m_files.at(int(b->file)).filePath;
+        }
+        return a->line < b->line;
+    });
+
+    for (const Symbol* symbol : symbols) {
+        locations.append(locationOf(*symbol));
+    }
+    return locations;
+}
+
+QVector<SymbolMatch> SymbolIndex::search(const QString& query, int limit) const
+{
+    QVector<SymbolMatch> results;
+    auto appendDefinitions = [this, &results, limit](quint32 nameId, int score) {
+        QVector<const Symbol*> symbols;
+        for (auto it = m_definitions.constFind(nameId); it != m_definitions.constEnd() && it.key() == nameId; ++it) {
+            symbols.append(&m_files.at(int(it.value() >> 32)).symbols.at(int(it.value() & 0xffffffffu)));
+        }
+        std::sort(symbols.begin(), symbols.end(), [](const Symbol* a, const Symbol* b) {
+            return kindRank(a->kind) < kindRank(b->kind);
+        });
+        for (const Symbol* symbol : symbols) {
+            if (results.size() >= limit) {
+                return;
+            }
+            SymbolMatch match;
+            match.name = string(symbol->name);
+            match.container = string(symbol->container);
+            match.detail = string(symbol->detail);
+            match.kind = symbol->kind;
+            match.score = score;
+            match.location = locationOf(*symbol);
+            results.append(match);
+        }
+    };
+
+    if (query.trimmed().isEmpty()) {
+        // No query: list modules by name
+        QVector<quint32> modules;
+        for (quint32 nameId : m_definitions.uniqueKeys()) {
+            for (auto it = m_definitions.constFind(nameId); it != m_definitions.constEnd() && it.key() == nameId; ++it) {
+                const quint8 kind = m_files.at(int(it.value() >> 32)).symbols.at(int(it.value() & 0xffffffffu)).kind;
+                if (kind == ModuleSymbol || kind == ScModuleSymbol) {
+                    modules.append(nameId);
+                    break;
+                }
+            }
+        }
+        std::sort(modules.begin(), modules.end(), [this](quint32 a, quint32 b) {
+            return m_strings.at(int(a)).compare(m_strings.at(int(b)), Qt::CaseInsensitive) < 0;
+        });
+        for (quint32 nameId : modules) {
+            if (results.size() >= limit) {
+                break;
+            }
+            appendDefinitions(nameId, 0);
+        }
+        return results;
+    }
+
+    // The palette may lag the index by one rebuild, so names are resolved again
+    const QVector<FuzzyMatcher::Match> matches = m_palette.match(query, limit, &m_paletteNarrowing);
+    for (const FuzzyMatcher::Match& match : matches) {
+        if (results.size() >= limit) {
+            break;
+        }
+        const auto id = m_stringIds.constFind(m_paletteNames.at(match.index));
+        if (id != m_stringIds.constEnd()) {
+            appendDefinitions(id.value(), match.score);
+        }
+    }
+    return results;
+}
+
+QVector<SymbolMatch> SymbolIndex::modules() const
+{
+    QVector<SymbolMatch> results;
+    for (const FileEntry& entry : m_files) {
+        if (!entry.live) {
+            continue;
+        }
+        for (const Symbol& symbol : entry.symbols) {
+            if (symbol.kind != ModuleSymbol && symbol.kind != ScModuleSymbol) {
+                continue;
+            }
+            SymbolMatch match;
+            match.name = string(symbol.name);
+            match.detail = string(symbol.detail);
+            match.kind = symbol.kind;
+            match.location = locationOf(symbol);
+            results.append(match);
+        }
+    }
+    return results;
+}
+
+int SymbolIndex::findReferences(const QString& name)
+{
+    const int requestId = ++m_nextReferenceRequest;
+
+    // Only files that mention the identifier at all are rescanned
+    const quint32 hash = identifierHash(name);
+    QStringList candidates;
+    for (const FileEntry& entry : m_files) {
+        if (entry.live && std::binary_search(entry.identifierHashes.constBegin(), entry.identifierHashes.constEnd(), hash)) {
+            candidates.append(entry.filePath);
+        }
+    }
+
+    m_referencePool.start([this, requestId, name, candidates]() {
+        QVector<SymbolLocation> locations;
+        for (const QString& filePath : candidates) {
+            if (locations.size() >= MAX_REFERENCES) {
+                break;
+            }
+            QString text;
+            if (!readSource(filePath, &text)) {
+                continue;
+            }
+            const bool sv = CodeHighlighter::languageForFile(filePath) == CodeHighlighter::SystemVerilog;
+            const QVector<Token> tokens = tokenize(text, sv);
+            for (const Token& token : tokens) {
+                if (!token.identifier || QStringView(text).mid(token.start, token.length) != name) {
+                    continue;
+                }
+                const int lineStart = token.start - (token.column - 1);
+                int lineEnd = text.indexOf(QLatin1Char('\n'), token.start);
+                if (lineEnd < 0) {
+                    lineEnd = text.size();
+                }
+
+                SymbolLocation location;
+                location.filePath = filePath;
+                location.line = token.line;
+                location.column = token.column;
+                location.preview = text.mid(lineStart, lineEnd - lineStart).trimmed().left(MAX_PREVIEW_LENGTH);
+                locations.append(location);
+                if (locations.size() >= MAX_REFERENCES) {
+                    break;
+                }
+            }
+        }
+
+        QMetaObject::invokeMethod(this, [this, requestId, name, locations]() {
+            emit referencesFound(requestId, name, locations);
+        }, Qt::QueuedConnection);
+    });
+
+    return requestId;
+}
+
+QString SymbolIndex::kindToString(quint8 kind)
+{
+    switch (kind) {
+    case ModuleSymbol: return "module";
+    case PortSymbol: return "port";
+    case ParameterSymbol: return "parameter";
+    case ScModuleSymbol: return "SC_MODULE";
+    case ScPortSymbol: return "sc port";
+    default: return "symbol";
+    }
+}
+
+bool SymbolIndex::isIndexedFile(const QString& filePath)
+{
+    static const QSet<QString> suffixes = {
+        "sv", "svh", "v", "vh", "h", "hh", "hpp", "hxx", "cpp", "cc", "cxx"
+    };
+    return suffixes.contains(QFileInfo(filePath).suffix().toLower());
+}
+
+SymbolIndex::ParsedFile SymbolIndex::parse(const QString& filePath, const QString& text)
+{
+    ParsedFile parsed;
+    parsed.filePath = filePath;
+
+    const bool sv = CodeHighlighter::languageForFile(filePath) == CodeHighlighter::SystemVerilog;
+    const QVector<Token> tokens = tokenize(text, sv);
+    const TokenReader reader(text, tokens);
+    if (sv) {
+        parseSystemVerilog(reader, parsed.symbols);
+    } else {
+        parseSystemC(reader, parsed.symbols);
+    }
+
+    parsed.identifierHashes.reserve(tokens.size());
+    for (const Token& token : tokens) {
+        if (token.identifier) {
+            parsed.identifierHashes.append(identifierHash(QStringView(text).mid(token.start, token.length)));
+        }
+    }
+    std::sort(parsed.identifierHashes.begin(), parsed.identifierHashes.end());
+    parsed.identifierHashes.erase(std::unique(parsed.identifierHashes.begin(), parsed.identifierHashes.end()),
+                                  parsed.identifierHashes.end());
+    parsed.identifierHashes.squeeze();
+    return parsed;
+}
+
+SymbolIndex::ParsedFile SymbolIndex::parseFromDisk(const QString& filePath)
+{
+    const QFileInfo info(filePath);
+    QString text;
+    if (!info.exists() || info.size() > MAX_FILE_SIZE || !readSource(filePath, &text)) {
+        ParsedFile missing;
+        missing.filePath = filePath;
+        missing.exists = info.exists() && info.size() <= MAX_FILE_SIZE;
+        return missing;
+    }
+
+    ParsedFile parsed = parse(filePath, text);
+    parsed.modified = info.lastModified().toMSecsSinceEpoch();
+    return parsed;
+}
+
+quint32 SymbolIndex::identifierHash(QStringView identifier)
+{
+    return quint32(qHash(identifier, 0));
+}
+
+void SymbolIndex::applyParsed(int generation, const QVector<ParsedFile>& files)
+{
+    if (generation != m_generation.load()) {
+        return;
+    }
+
+    for (const ParsedFile& parsed : files) {
+        if (parsed.exists) {
+            replaceFile(parsed);
+        } else {
+            removeFile(parsed.filePath);
+        }
+    }
+    rebuildPalette();
+    emit indexUpdated();
+}
+
+void SymbolIndex::finishBuild(int generation, qint64 elapsedMs)
+{
+    if (generation != m_generation.load()) {
+        return;
+    }
+
+    m_building = false;
+    qDebug() << "🔎 Symbol index built:" << fileCount() << "files," << symbolCount() << "symbols in" << elapsedMs << "ms";
+    emit indexingFinished(fileCount(), symbolCount(), elapsedMs);
+}
+
+void SymbolIndex::replaceFile(const ParsedFile& parsed)
+{
+    quint32 fileId;
+    const auto it = m_fileIds.constFind(parsed.filePath);
+    if (it == m_fileIds.constEnd()) {
+        fileId = quint32(m_files.size());
+        m_files.append(FileEntry());
+        m_files.last().filePath = parsed.filePath;
+        m_fileIds.insert(parsed.filePath, fileId);
+    } else {
+        fileId = it.value();
+        dropSymbols(fileId);
+    }
+
+    QVector<Symbol> symbols;
+    symbols.reserve(parsed.symbols.size());
+    for (const ParsedSymbol& ps : parsed.symbols) {
+        Symbol symbol;
+        symbol.name = intern(ps.name);
+        symbol.container = intern(ps.container);
+        symbol.detail = intern(ps.detail);
+        symbol.file = fileId;
+        symbol.line = quint32(ps.line);
+        symbol.column = quint16(qMin(ps.column, 0xffff));
+        symbol.kind = ps.kind;
+        m_definitions.insert(symbol.name, packSymbol(fileId, quint32(symbols.size())));
+        symbols.append(symbol);
+    }
+
+    FileEntry& entry = m_files[int(fileId)];
+    entry.modified = parsed.modified;
+    entry.live = true;
+    entry.symbols = symbols;
+    entry.identifierHashes = parsed.identifierHashes;
+}
+
+void SymbolIndex::dropSymbols(quint32 fileId)
+{
+    FileEntry& entry = m_files[int(fileId)];
+    for (int k = 0; k < entry.symbols.size(); ++k) {
+        const Symbol& symbol = entry.symbols.at(k);
+        m_definitions.remove(symbol.name, packSymbol(fileId, quint32(k)));
+        release(symbol.name);
+        release(symbol.container);
+        release(symbol.detail);
+    }
+    entry.symbols.clear();
+}
+
+quint32 SymbolIndex::intern(const QString& text)
+{
+    if (text.isEmpty()) {
+        return NO_STRING;
+    }
+    const auto it = m_stringIds.constFind(text);
+    if (it != m_stringIds.constEnd()) {
+        ++m_stringRefs[int(it.value())];
+        return it.value();
+    }
+
+    quint32 id;
+    if (!m_freeStrings.isEmpty()) {
+        id = m_freeStrings.takeLast();
+        m_strings[int(id)] = text;
+        m_stringRefs[int(id)] = 1;
+    } else {
+        id = quint32(m_strings.size());
+        m_strings.append(text);
+        m_stringRefs.append(1);
+    }
+    m_stringIds.insert(text, id);
+    return id;
+}
+
+void SymbolIndex::release(quint32 id)
+{
+    if (id == NO_STRING || --m_stringRefs[int(id)] > 0) {
+        return;
+    }
+    // Last user gone: free the text and let intern() reuse the slot
+    m_stringIds.remove(m_strings.at(int(id)));
+    m_strings[int(id)] = QString();
+    m_freeStrings.append(id);
+}
+
+QString SymbolIndex::string(quint32 id) const
+{
+    return id == NO_STRING ? QString() : m_strings.at(int(id));
+}
+
+SymbolLocation SymbolIndex::locationOf(const Symbol& symbol) const
+{
+    SymbolLocation location;
+    location.filePath = m_files.at(int(symbol.file)).filePath;
+    location.line = int(symbol.line);
+    location.column = int(symbol.column);
+    return location;
+}
+
+void SymbolIndex::rebuildPalette()
+{
+    // One rebuild at a time; merges that land meanwhile are folded into the next one
+    if (m_paletteRebuilding) {
+        m_palettePending = true;
+        return;
+    }
+    m_paletteRebuilding = true;
+
+    const QList<quint32> nameIds = m_definitions.uniqueKeys();
+    QStringList names;
+    names.reserve(nameIds.size());
+    for (quint32 nameId : nameIds) {
+        names.append(m_strings.at(int(nameId)));
+    }
+
+    const int generation = m_generation.load();
+    m_palettePool.start([this, generation, names]() {
+        FuzzyMatcher palette;
+        palette.setCandidates(names);
+        QMetaObject::invokeMethod(this, [this, generation, palette, names]() {
+            applyPalette(generation, palette, names);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SymbolIndex::applyPalette(int generation, const FuzzyMatcher& palette, const QStringList& names)
+{
+    m_paletteRebuilding = false;
+    if (generation == m_generation.load()) {
+        m_palette = palette;
+        m_paletteNames = names;
+        m_paletteNarrowing.reset();
+    }
+
+    if (m_palettePending) {
+        m_palettePending = false;
+        rebuildPalette();
+    } else if (generation == m_generation.load()) {
+        emit indexUpdated();
+    }
+}
+
+void SymbolIndex::build(SymbolIndex* receiver, QString rootPath, int generation)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList paths;
+    QDirIterator it(rootPath, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (generation != receiver->m_generation.load()) {
+            return;
+        }
+        // Verilator's generated C++ is large and never hand-edited
+        if (path.contains(QLatin1String("/obj_dir/"))) {
+            continue;
+        }
+        if (isIndexedFile(path) && it.fileInfo().size() <= MAX_FILE_SIZE) {
+            paths.append(path);
+        }
+    }
+
+    for (int start = 0; start < paths.size(); start += BUILD_BATCH_SIZE) {
+        if (generation != receiver->m_generation.load()) {
+            return;
+        }
+        const QStringList batch = paths.mid(start, BUILD_BATCH_SIZE);
+        const QVector<ParsedFile> parsed = QtConcurrent::blockingMapped<QVector<ParsedFile>>(batch, &SymbolIndex::parseFromDisk);
+        QMetaObject::invokeMethod(receiver, [receiver, generation, parsed]() {
+            receiver->applyParsed(generation, parsed);
+        }, Qt::QueuedConnection);
+    }
+
+    const qint64 elapsedMs = timer.elapsed();
+    QMetaObject::invokeMethod(receiver, [receiver, generation, elapsedMs]() {
+        receiver->finishBuild(generation, elapsedMs);
+    }, Qt::QueuedConnection);
+}
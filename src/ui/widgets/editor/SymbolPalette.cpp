@@ -0,0 +1,228 @@
+// SymbolPalette.cpp
+#include "ui/widgets/editor/SymbolPalette.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QKeyEvent>
+
+SymbolPalette::SymbolPalette(SymbolIndex* index, QWidget* parent)
+    : QDialog(parent, Qt::Popup)
+    , m_index(index)
+    , m_searchMode(true)
+    , m_layout(nullptr)
+    , m_titleLabel(nullptr)
+    , m_queryEdit(nullptr)
+    , m_resultList(nullptr)
+    , m_statusLabel(nullptr)
+{
+    setupUI();
+
+    connect(m_queryEdit, &QLineEdit::textChanged, this, &SymbolPalette::onQueryChanged);
+    connect(m_queryEdit, &QLineEdit::returnPressed, this, &SymbolPalette::activateCurrent);
+    connect(m_resultList, &QListWidget::itemActivated, this, &SymbolPalette::activateCurrent);
+    if (m_index) {
+        connect(m_index, &SymbolIndex::indexUpdated, this, &SymbolPalette::onIndexUpdated);
+    }
+}
+
+void SymbolPalette::showSearch(const QString& initialQuery)
+{
+    m_searchMode = true;
+    m_locations.clear();
+    m_titleLabel->setText("Go to Symbol");
+    m_queryEdit->setPlaceholderText("Symbol name (module, port, parameter)");
+
+    // setText() only re-runs the query when the text actually changes
+    m_queryEdit->blockSignals(true);
+    m_queryEdit->setText(initialQuery);
+    m_queryEdit->blockSignals(false);
+    populateSearch(initialQuery);
+    popup();
+}
+
+void SymbolPalette::showLocations(const QString& title, const QVector<SymbolLocation>& locations)
+{
+    m_searchMode = false;
+    m_locations = locations;
+    m_titleLabel->setText(title);
+    m_queryEdit->setPlaceholderText("Filter by file or line text");
+
+    m_queryEdit->blockSignals(true);
+    m_queryEdit->clear();
+    m_queryEdit->blockSignals(false);
+    populateLocations(QString());
+    popup();
+}
+
+bool SymbolPalette::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_queryEdit && event->type() == QEvent::KeyPress) {
+        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        switch (keyEvent->key()) {
+            case Qt::Key_Up:
+            case Qt::Key_Down:
+            case Qt::Key_PageUp:
+            case Qt::Key_PageDown:
+                // The list keeps its own selection logic; the query keeps focus
+                QCoreApplication::sendEvent(m_resultList, event);
+                return true;
+            case Qt::Key_Escape:
+                reject();
+                return true;
+            default:
+                break;
+        }
+    }
+    return QDialog::eventFilter(watched, event);
+}
+
+void SymbolPalette::onQueryChanged(const QString& query)
+{
+    if (m_searchMode) {
+        populateSearch(query);
+    } else {
+        populateLocations(query);
+    }
+}
+
+void SymbolPalette::activateCurrent()
+{
+    QListWidgetItem* item = m_resultList->currentItem();
+    if (!item) {
+        return;
+    }
+
+    const QString filePath = item->data(FilePathRole).toString();
+    const int line = item->data(LineRole).toInt();
+    const int column = item->data(ColumnRole).toInt();
+    accept();
+    emit locationActivated(filePath, line, column);
+}
+
+void SymbolPalette::onIndexUpdated()
+{
+    // Results fill in while the initial build is still running
+    if (isVisible() && m_searchMode) {
+        populateSearch(m_queryEdit->text());
+    }
+}
+
+void SymbolPalette::popup()
+{
+    if (QWidget* host = parentWidget()) {
+        const QPoint topCenter = host->mapToGlobal(QPoint(host->width() / 2, 0));
+        move(topCenter.x() - width() / 2, topCenter.y() + 40);
+    }
+    show();
+    raise();
+    activateWindow();
+    m_queryEdit->setFocus();
+    m_queryEdit->selectAll();
+}
+
+void SymbolPalette::populateSearch(const QString& query)
+{
+    m_resultList->clear();
+    if (!m_index) {
+        m_statusLabel->setText("No symbol index");
+        return;
+    }
+
+    const QVector<SymbolMatch> matches = m_index->search(query);
+    for (const SymbolMatch& match : matches) {
+        QString text = match.name;
+        if (!match.container.isEmpty()) {
+            text += "  —  " + match.container;
+        }
+        text += "  [" + SymbolIndex::kindToString(match.kind) + "]";
+
+        QString toolTip = match.detail.isEmpty() ? match.name : match.detail + " " + match.name;
+        toolTip += "\n" + displayPath(match.location.filePath) + ":" + QString::number(match.location.line);
+        addLocationItem(text, toolTip, match.location);
+    }
+
+    if (m_index->isBuilding()) {
+        m_statusLabel->setText(QString("Indexing... %1 symbols so far").arg(m_index->symbolCount()));
+    } else if (matches.isEmpty()) {
+        m_statusLabel->setText(query.trimmed().isEmpty() ? "No modules indexed" : "No matching symbols");
+    } else {
+        m_statusLabel->setText(QString("%1 of %2 symbols").arg(matches.size()).arg(m_index->symbolCount()));
+    }
+}
+
+void SymbolPalette::populateLocations(const QString& filter)
+{
+    m_resultList->clear();
+
+    const QString needle = filter.trimmed();
+    for (const SymbolLocation& location : m_locations) {
+        const QString path = displayPath(location.filePath);
+        QString text = path + ":" + QString::number(location.line);
+        if (!location.preview.isEmpty()) {
+            text += "   " + location.preview;
+        }
+        if (!needle.isEmpty() && !text.contains(needle, Qt::CaseInsensitive)) {
+            continue;
+        }
+        addLocationItem(text, location.filePath, location);
+    }
+
+    const int shown = m_resultList->count();
+    if (m_locations.isEmpty()) {
+        m_statusLabel->setText("No results");
+    } else if (shown == m_locations.size()) {
+        m_statusLabel->setText(QString("%1 locations").arg(shown));
+    } else {
+        m_statusLabel->setText(QString("%1 of %2 locations").arg(shown).arg(m_locations.size()));
+    }
+}
+
+void SymbolPalette::addLocationItem(const QString& text, const QString& toolTip, const SymbolLocation& location)
+{
+    QListWidgetItem* item = new QListWidgetItem(text, m_resultList);
+    item->setToolTip(toolTip);
+    item->setData(FilePathRole, location.filePath);
+    item->setData(LineRole, location.line);
+    item->setData(ColumnRole, location.column);
+    if (m_resultList->count() == 1) {
+        m_resultList->setCurrentItem(item);
+    }
+}
+
+QString SymbolPalette::displayPath(const QString& filePath) const
+{
+    if (m_index && !m_index->root().isEmpty()) {
+        const QString relative = QDir(m_index->root()).relativeFilePath(filePath);
+        if (!relative.startsWith("..")) {
+            return relative;
+        }
+    }
+    return QFileInfo(filePath).fileName();
+}
+
+void SymbolPalette::setupUI()
+{
+    resize(PALETTE_WIDTH, PALETTE_HEIGHT);
+
+    m_layout = new QVBoxLayout(this);
+    m_layout->setContentsMargins(6, 6, 6, 6);
+    m_layout->setSpacing(4);
+
+    m_titleLabel = new QLabel(this);
+    m_titleLabel->setStyleSheet("QLabel { font-weight: bold; color: #555; }");
+    m_layout->addWidget(m_titleLabel);
+
+    m_queryEdit = new QLineEdit(this);
+    m_queryEdit->setClearButtonEnabled(true);
+    m_queryEdit->installEventFilter(this);
+    m_layout->addWidget(m_queryEdit);
+
+    m_resultList = new QListWidget(this);
+    m_resultList->setUniformItemSizes(true);
+    m_resultList->setFocusPolicy(Qt::NoFocus);
+    m_layout->addWidget(m_resultList, 1);
+
+    m_statusLabel = new QLabel(this);
+    m_statusLabel->setStyleSheet("QLabel { color: #888; font-size: 11px; }");
+    m_layout->addWidget(m_statusLabel);
+}
@@ -0,0 +1,327 @@
+// DiagnosticExtractor.cpp
+#include "ui/widgets/terminal/DiagnosticExtractor.h"
+#include <QDir>
+#include <QRegularExpression>
+
+namespace {
+
+// All matchers are compiled once per process and shared by every extractor.
+const QRegularExpression& ansiEscapeRegex()
+{
+    static const QRegularExpression re(QStringLiteral("\\x1b\\[[0-9;]*[A-Za-z]"));
+    return re;
+}
+
+// file:line[:col]: (fatal error|error|warning|note|remark): message
+const QRegularExpression& compilerRegex()
+{
+    static const QRegularExpression re(
+        QStringLiteral("^(.+?):(\\d+):(?:(\\d+):)?\\s*(fatal error|error|warning|note|remark):\\s*(.*)$"));
+    return re;
+}
+
+// %Error[-CODE]: file:line[:col]: message
+const QRegularExpression& verilatorRegex()
+{
+    static const QRegularExpression re(
+        QStringLiteral("^%(Error|Warning)(?:-([A-Za-z0-9_]+))?:\\s*(.+?):(\\d+):(?:(\\d+):)?\\s*(.*)$"));
+    return re;
+}
+
+// file:line: (syntax error|error|warning|sorry)[: message]
+const QRegularExpression& icarusRegex()
+{
+    static const QRegularExpression re(
+        QStringLiteral("^(.+?):(\\d+):\\s*(syntax error|error|warning|sorry)(?::\\s*(.*))?$"));
+    return re;
+}
+
+// SC_REPORT header: Error: (E109) message / Warning: id: message
+const QRegularExpression& systemCHeaderRegex()
+{
+    static const QRegularExpression re(
+        QStringLiteral("^(Info|Warning|Error|Fatal):\\s+(.*)$"));
+    return re;
+}
+
+// SC_REPORT continuation: In file: path:line
+const QRegularExpression& systemCLocationRegex()
+{
+    static const QRegularExpression re(QStringLiteral("^In file:\\s*(.+?):(\\d+)\\s*$"));
+    return re;
+}
+
+int toInt(const QRegularExpressionMatch& match, int group)
+{
+    return match.capturedView(group).isEmpty() ? 0 : match.capturedView(group).toInt();
+}
+
+} // namespace
+
+DiagnosticExtractor::DiagnosticExtractor(QObject* parent)
+    : QObject(parent)
+    , m_decoder(QStringDecoder::Utf8)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &DiagnosticExtractor::flush);
+}
+
+void DiagnosticExtractor::feed(const QByteArray& chunk)
+{
+    if (chunk.isEmpty()) {
+        return;
+    }
+    const QString text = m_decoder.decode(chunk);
+    feed(text);
+}
+
+void DiagnosticExtractor::feed(const QString& text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+    m_buffer.append(text);
+    consumeLines();
+}
+
+void DiagnosticExtractor::finish()
+{
+    if (!m_buffer.isEmpty()) {
+        processLine(QStringView(m_buffer));
+        m_buffer.clear();
+    }
+    finishSystemCReport();
+    flush();
+}
+
+void DiagnosticExtractor::reset()
+{
+    m_flushTimer.stop();
+    m_decoder.resetState();
+    m_buffer.clear();
+    m_pending.clear();
+    m_hasPendingReport = false;
+    m_pendingReport = ProblemEntry();
+}
+
+void DiagnosticExtractor::flush()
+{
+    m_flushTimer.stop();
+
+    // A SystemC header with no "In file:" line yet is only held back while
+    // output keeps coming; once the stream goes quiet it is emitted as is.
+    if (m_hasPendingReport && m_buffer.isEmpty()) {
+        finishSystemCReport();
+    }
+
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QVector<ProblemEntry> batch;
+    batch.swap(m_pending);
+    emit problemsExtracted(batch);
+}
+
+void DiagnosticExtractor::consumeLines()
+{
+    // The buffer only ever holds the unterminated tail of the previous chunk
+    // plus the new text, so completed lines are processed exactly once.
+    qsizetype start = 0;
+    qsizetype newline = m_buffer.indexOf(QLatin1Char('\n'));
+
+    while (newline >= 0) {
+        QStringView line = QStringView(m_buffer).mid(start, newline - start);
+        if (line.endsWith(QLatin1Char('\r'))) {
+            line.chop(1);
+        }
+        processLine(line);
+        start = newline + 1;
+        newline = m_buffer.indexOf(QLatin1Char('\n'), start);
+    }
+
+    if (start > 0) {
+        m_buffer.remove(0, start);
+    }
+
+    // Guard against tools that never terminate a line
+    if (m_buffer.size() > MAX_LINE_LENGTH) {
+        processLine(QStringView(m_buffer));
+        m_buffer.clear();
+    }
+
+    if (!m_pending.isEmpty() || m_hasPendingReport) {
+        if (m_pending.size() >= MAX_BATCH_SIZE) {
+            flush();
+        } else if (!m_flushTimer.isActive()) {
+            m_flushTimer.start();
+        }
+    }
+}
+
+void DiagnosticExtractor::processLine(QStringView view)
+{
+    view = view.trimmed();
+    if (view.isEmpty()) {
+        return;
+    }
+
+    // SystemC continuation lines belong to the report header before them
+    if (m_hasPendingReport) {
+        if (view.startsWith(QLatin1String("In file:"))) {
+            const QRegularExpressionMatch match = systemCLocationRegex().match(view.toString());
+            if (match.hasMatch()) {
+                m_pendingReport.file = resolvePath(match.captured(1));
+                m_pendingReport.line = toInt(match, 2);
+            }
+            finishSystemCReport();
+            return;
+        }
+        if (view.startsWith(QLatin1String("In process:"))) {
+            return;
+        }
+        finishSystemCReport();
+    }
+
+    // Cheap pre-check: every recognised format needs a ':' and one of a few
+    // keywords, so the bulk of ordinary output never reaches a regex.
+    if (!view.contains(QLatin1Char(':'))) {
+        return;
+    }
+    const bool hasKeyword = view.contains(QLatin1String("rror"))
+                         || view.contains(QLatin1String("arning"))
+                         || view.contains(QLatin1String("note:"))
+                         || view.contains(QLatin1String("remark:"))
+                         || view.contains(QLatin1String("sorry"))
+                         || view.startsWith(QLatin1String("Info:"))
+                         || view.startsWith(QLatin1String("Fatal:"));
+    if (!hasKeyword) {
+        return;
+    }
+
+    QString line = view.toString();
+    if (line.contains(QChar(0x1b))) {
+        line.remove(ansiEscapeRegex());
+    }
+
+    if (line.startsWith(QLatin1Char('%'))) {
+        matchVerilatorLine(line);
+        return;
+    }
+    if (matchSystemCReport(line)) {
+        return;
+    }
+    if (matchCompilerLine(line)) {
+        return;
+    }
+    matchIcarusLine(line);
+}
+
+bool DiagnosticExtractor::matchCompilerLine(const QString& line)
+{
+    const QRegularExpressionMatch match = compilerRegex().match(line);
+    if (!match.hasMatch()) {
+        return false;
+    }
+
+    const QString kind = match.captured(4);
+    QString severity = QStringLiteral("Info");
+    if (kind.endsWith(QLatin1String("error"))) {
+        severity = QStringLiteral("Error");
+    } else if (kind == QLatin1String("warning")) {
+        severity = QStringLiteral("Warning");
+    }
+
+    addProblem(resolvePath(match.captured(1)), toInt(match, 2), toInt(match, 3),
+               match.captured(5), severity);
+    return true;
+}
+
+bool DiagnosticExtractor::matchVerilatorLine(const QString& line)
+{
+    const QRegularExpressionMatch match = verilatorRegex().match(line);
+    if (!match.hasMatch()) {
+        // e.g. "%Error: Exiting due to 3 error(s)" carries no location
+        return false;
+    }
+
+    QString message = match.captured(6);
+    const QString code = match.captured(2);
+    if (!code.isEmpty()) {
+        message = QStringLiteral("[%1] %2").arg(code, message);
+    }
+
+    addProblem(resolvePath(match.captured(3)), toInt(match, 4), toInt(match, 5),
+               message, match.captured(1));
+    return true;
+}
+
+bool DiagnosticExtractor::matchIcarusLine(const QString& line)
+{
+    const QRegularExpressionMatch match = icarusRegex().match(line);
+    if (!match.hasMatch()) {
+        return false;
+    }
+
+    const QString kind = match.captured(3);
+    QString message = match.captured(4);
+    if (message.isEmpty()) {
+        message = kind;
+    } else if (kind == QLatin1String("sorry")) {
+        message = QStringLiteral("sorry: ") + message;
+    }
+
+    const QString severity = (kind == QLatin1String("warning"))
+        ? QStringLiteral("Warning") : QStringLiteral("Error");
+    addProblem(resolvePath(match.captured(1)), toInt(match, 2), 0, message, severity);
+    return true;
+}
+
+bool DiagnosticExtractor::matchSystemCReport(const QString& line)
+{
+    const QRegularExpressionMatch match = systemCHeaderRegex().match(line);
+    if (!match.hasMatch()) {
+        return false;
+    }
+
+    m_pendingReport = ProblemEntry();
+    m_pendingReport.file = m_sourceName;
+    m_pendingReport.message = match.captured(2);
+    m_pendingReport.severity = match.captured(1);
+    m_hasPendingReport = true;
+    return true;
+}
+
+void DiagnosticExtractor::finishSystemCReport()
+{
+    if (!m_hasPendingReport) {
+        return;
+    }
+    m_hasPendingReport = false;
+    addProblem(m_pendingReport.file, m_pendingReport.line, m_pendingReport.column,
+               m_pendingReport.message, m_pendingReport.severity);
+    m_pendingReport = ProblemEntry();
+}
+
+void DiagnosticExtractor::addProblem(const QString& file, int line, int column,
+                                     const QString& message, const QString& severity)
+{
+    ProblemEntry entry;
+    entry.file = file;
+    entry.line = line;
+    entry.column = column;
+    entry.message = message.trimmed();
+    entry.severity = severity;
+    m_pending.append(entry);
+    m_extractedCount++;
+}
+
+QString DiagnosticExtractor::resolvePath(const QString& path) const
+{
+    const QString trimmed = path.trimmed();
+    if (m_workingDirectory.isEmpty() || QDir::isAbsolutePath(trimmed)) {
+        return trimmed;
+    }
+    return QDir::cleanPath(QDir(m_workingDirectory).absoluteFilePath(trimmed));
+}
@@ -0,0 +1,450 @@
+// JobRunner.cpp
+#include "ui/widgets/terminal/JobRunner.h"
+#include "ui/widgets/terminal/DiagnosticExtractor.h"
+#include "ui/widgets/terminal/SessionCapture.h"
+#include <QDateTime>
+#include <QDir>
+#include <QRegularExpression>
+#include <QStandardPaths>
+#include <QThread>
+#include <QDebug>
+
+JobRunner::JobRunner(QObject* parent)
+    : QObject(parent)
+    , m_maxConcurrent(qMax(1, QThread::idealThreadCount()))
+{
+}
+
+JobRunner::~JobRunner()
+{
+    m_queue.clear();
+    for (auto it = m_running.begin(); it != m_running.end(); ++it) {
+        it->process->disconnect(this);
+        it->process->kill();
+        it->process->waitForFinished(1000);
+        // The writer finishes its file on its own and then deletes itself
+        it->capture->setParent(nullptr);
+        connect(it->capture, &QThread::finished, it->capture, &QObject::deleteLater);
+        it->capture->requestStop();
+    }
+}
+
+void JobRunner::setMaxConcurrent(int count)
+{
+    m_maxConcurrent = qMax(1, count);
+    scheduleJobs();
+}
+
+int JobRunner::submit(const QString& commandTemplate, const QString& sweep, QString* error,
+                      QVector<int>* ids)
+{
+    if (commandTemplate.trimmed().isEmpty()) {
+        if (error) {
+            *error = "Command template is empty";
+        }
+        return -1;
+    }
+
+    const QVector<JobParameters> combinations = expandSweep(sweep, error);
+    if (combinations.isEmpty()) {
+        return -1;
+    }
+
+    // A new batch gets its own capture directory and wall clock
+    if (!isBusy()) {
+        const QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+        m_captureRoot = QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+            .filePath("job-runs/" + stamp);
+        m_wallTimer.start();
+        m_wallMs = 0;
+    }
+
+    for (const JobParameters& parameters : combinations) {
+        JobRecord record;
+        record.id = m_jobs.size();
+        record.parameters = parameters;
+        record.command = expandTemplate(commandTemplate, parameters, record.id + 1);
+        m_jobs.append(record);
+        m_queue.enqueue(record.id);
+        if (ids) {
+            ids->append(record.id);
+        }
+        emit jobAdded(record.id);
+    }
+
+    qDebug() << "🚀 Queued" << combinations.size() << "jobs," << m_maxConcurrent << "concurrent";
+
+    scheduleJobs();
+    emit statsChanged();
+    return combinations.size();
+}
+
+void JobRunner::stopAll()
+{
+    while (!m_queue.isEmpty()) {
+        const int id = m_queue.dequeue();
+        m_jobs[id].state = JobState::Cancelled;
+        emit jobChanged(id);
+    }
+
+    // finished() arrives later and records the job as cancelled
+    QList<QProcess*> processes;
+    for (auto it = m_running.begin(); it != m_running.end(); ++it) {
+        it->cancelRequested = true;
+        processes.append(it->process);
+    }
+    for (QProcess* process : processes) {
+        process->kill();
+    }
+
+    emit statsChanged();
+    if (!isBusy()) {
+        m_wallMs = m_wallTimer.isValid() ? m_wallTimer.elapsed() : 0;
+        emit allFinished();
+    }
+}
+
+void JobRunner::cancel(const QVector<int>& ids)
+{
+    for (int id : ids) {
+        if (m_queue.removeOne(id)) {
+            m_jobs[id].state = JobState::Cancelled;
+            emit jobChanged(id);
+            continue;
+        }
+        auto it = m_running.find(id);
+        if (it != m_running.end()) {
+            it->cancelRequested = true;
+            it->process->kill();
+        }
+    }
+
+    emit statsChanged();
+    if (!isBusy()) {
+        m_wallMs = m_wallTimer.isValid() ? m_wallTimer.elapsed() : 0;
+        emit allFinished();
+    }
+}
+
+bool JobRunner::clearFinished()
+{
+    if (isBusy()) {
+        return false;
+    }
+    m_jobs.clear();
+    m_wallMs = 0;
+    m_wallTimer.invalidate();
+    emit jobsCleared();
+    emit statsChanged();
+    return true;
+}
+
+const JobRecord* JobRunner::job(int id) const
+{
+    return (id >= 0 && id < m_jobs.size()) ? &m_jobs.at(id) : nullptr;
+}
+
+qint64 JobRunner::elapsedMs(int id) const
+{
+    auto it = m_running.constFind(id);
+    if (it != m_running.constEnd()) {
+        return it->timer.elapsed();
+    }
+    const JobRecord* record = job(id);
+    return record ? record->elapsedMs : 0;
+}
+
+JobStats JobRunner::stats() const
+{
+    JobStats stats;
+    bool first = true;
+
+    for (const JobRecord& record : m_jobs) {
+        switch (record.state) {
+            case JobState::Queued:    stats.queued++; break;
+            case JobState::Running:   stats.running++; break;
+            case JobState::Passed:    stats.passed++; break;
+            case JobState::Failed:    stats.failed++; break;
+            case JobState::Cancelled: stats.cancelled++; break;
+        }
+
+        if (record.state == JobState::Passed || record.state == JobState::Failed) {
+            stats.totalRuntimeMs += record.elapsedMs;
+            stats.minRuntimeMs = first ? record.elapsedMs : qMin(stats.minRuntimeMs, record.elapsedMs);
+            stats.maxRuntimeMs = qMax(stats.maxRuntimeMs, record.elapsedMs);
+            first = false;
+        }
+    }
+
+    stats.wallMs = (isBusy() && m_wallTimer.isValid()) ? m_wallTimer.elapsed() : m_wallMs;
+    return stats;
+}
+
+QVector<JobParameters> JobRunner::expandSweep(const QString& sweep, QString* error)
+{
+    static const QRegularExpression nameRegex("^[A-Za-z_][A-Za-z0-9_]*$");
+    static const QRegularExpression rangeRegex("^(-?\\d+)\\.\\.(-?\\d+)(?::(\\d+))?$");
+
+    QVector<JobParameters> combinations{JobParameters()};
+
+    for (const QString& part : sweep.split(';', Qt::SkipEmptyParts)) {
+        const QString spec = part.trimmed();
+        if (spec.isEmpty()) {
+            continue;
+        }
+
+        const int eq = spec.indexOf('=');
+        const QString name = spec.left(eq).trimmed();
+        if (eq <= 0 || !nameRegex.match(name).hasMatch()) {
+            if (error) {
+                *error = QString("Expected name=values, got '%1'").arg(spec);
+            }
+            return {};
+        }
+
+        QStringList values;
+        for (const QString& item : spec.mid(eq + 1).split(',', Qt::SkipEmptyParts)) {
+            const QString value = item.trimmed();
+            const QRegularExpressionMatch range = rangeRegex.match(value);
+            if (!range.hasMatch()) {
+                if (!value.isEmpty()) {
+                    values.append(value);
+                }
+                continue;
+            }
+
+            const qint64 from = range.captured(1).toLongLong();
+            const qint64 to = range.captured(2).toLongLong();
+            const qint64 step = range.captured(3).isEmpty() ? 1 : range.captured(3).toLongLong();
+            if (step <= 0 || qAbs(to - from) / step >= MAX_JOBS_PER_SUBMIT) {
+                if (error) {
+                    *error = QString("Range '%1' is empty or too large").arg(value);
+                }
+                return {};
+            }
+            for (qint64 v = from; from <= to ? v <= to : v >= to; v += (from <= to ? step : -step)) {
+                values.append(QString::number(v));
+            }
+        }
+
+        if (values.isEmpty()) {
+            if (error) {
+                *error = QString("Parameter '%1' has no values").arg(name);
+            }
+            return {};
+        }
+        if (static_cast<qint64>(combinations.size()) * values.size() > MAX_JOBS_PER_SUBMIT) {
+            if (error) {
+                *error = QString("Sweep expands to more than %1 jobs").arg(MAX_JOBS_PER_SUBMIT);
+            }
+            return {};
+        }
+
+        // Cartesian product with the parameters seen so far
+        QVector<JobParameters> expanded;
+        expanded.reserve(combinations.size() * values.size());
+        for (const JobParameters& base : combinations) {
+            for (const QString& value : values) {
+                JobParameters next = base;
+                next.append(qMakePair(name, value));
+                expanded.append(next);
+            }
+        }
+        combinations.swap(expanded);
+    }
+
+    return combinations;
+}
+
+QString JobRunner::expandTemplate(const QString& commandTemplate, const JobParameters& parameters, int index)
+{
+    QString command = commandTemplate;
+    command.replace("{index}", QString::number(index));
+    for (const auto& parameter : parameters) {
+        command.replace('{' + parameter.first + '}', parameter.second);
+    }
+    return command;
+}
+
+QString JobRunner::stateToString(JobState state)
+{
+    switch (state) {
+        case JobState::Queued:    return "Queued";
+        case JobState::Running:   return "Running";
+        case JobState::Passed:    return "Passed";
+        case JobState::Failed:    return "Failed";
+        case JobState::Cancelled: return "Cancelled";
+    }
+    return QString();
+}
+
+void JobRunner::scheduleJobs()
+{
+    while (m_running.size() < m_maxConcurrent && !m_queue.isEmpty()) {
+        startJob(m_queue.dequeue());
+    }
+}
+
+void JobRunner::startJob(int id)
+{
+    JobRecord& record = m_jobs[id];
+    record.state = JobState::Running;
+    record.captureDirectory = m_captureRoot;
+    record.captureBaseName = QString("job-%1").arg(id + 1, 4, 10, QLatin1Char('0'));
+
+    RunningJob run;
+    run.process = new QProcess(this);
+    if (!m_workingDirectory.isEmpty()) {
+        run.process->setWorkingDirectory(m_workingDirectory);
+    }
+
+    SessionCaptureWriter::Settings captureSettings;
+    captureSettings.directory = record.captureDirectory;
+    captureSettings.baseName = record.captureBaseName;
+    captureSettings.maxFileSize = 16 * 1024 * 1024;
+    captureSettings.maxFiles = 4;
+    run.capture = new SessionCaptureWriter(captureSettings, this);
+    run.capture->start(QThread::LowPriority);
+
+    // One extractor per pipe so stdout and stderr lines never interleave
+    const QString sourceName = QString("Job %1").arg(id + 1);
+    for (DiagnosticExtractor** extractor : {&run.stdoutDiagnostics, &run.stderrDiagnostics}) {
+        *extractor = new DiagnosticExtractor(this);
+        (*extractor)->setWorkingDirectory(m_workingDirectory);
+        (*extractor)->setSourceName(sourceName);
+        connect(*extractor, &DiagnosticExtractor::problemsExtracted, this,
+                [this, id](const QVector<ProblemEntry>& problems) {
+            JobRecord& job = m_jobs[id];
+            for (const ProblemEntry& entry : problems) {
+                const ProblemSeverity severity = ProblemsModel::severityFromString(entry.severity);
+                if (severity == ProblemSeverity::Error) {
+                    job.errorCount++;
+                } else if (severity == ProblemSeverity::Warning) {
+                    job.warningCount++;
+                }
+            }
+            emit problemsDetected(problems);
+        });
+    }
+
+    connect(run.process, &QProcess::readyReadStandardOutput, this, [this, id]() { onJobOutput(id, false); });
+    connect(run.process, &QProcess::readyReadStandardError, this, [this, id]() { onJobOutput(id, true); });
+    connect(run.process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, id](int exitCode, QProcess::ExitStatus status) { onJobFinished(id, exitCode, status); });
+    connect(run.process, &QProcess::errorOccurred, this,
+            [this, id](QProcess::ProcessError error) { onJobError(id, error); });
+
+    run.timer.start();
+    QProcess* process = run.process;
+    m_running.insert(id, run);
+    emit jobChanged(id);
+
+    // Registered before start(): a failed start reports errorOccurred right away
+#ifdef Q_OS_WIN
+    process->start("cmd.exe", QStringList() << "/c" << record.command);
+#else
+    process->start("/bin/bash", QStringList() << "-c" << record.command);
+#endif
+}
+
+void JobRunner::onJobOutput(int id, bool isError)
+{
+    auto it = m_running.find(id);
+    if (it == m_running.end()) {
+        return;
+    }
+
+    const QByteArray data = isError ? it->process->readAllStandardError()
+                                    : it->process->readAllStandardOutput();
+    if (data.isEmpty()) {
+        return;
+    }
+
+    it->capture->append(isError ? CaptureStream::StandardError : CaptureStream::StandardOutput, data);
+    (isError ? it->stderrDiagnostics : it->stdoutDiagnostics)->feed(data);
+    appendTail(m_jobs[id], data);
+    emit jobOutput(id, data);
+}
+
+void JobRunner::onJobFinished(int id, int exitCode, QProcess::ExitStatus status)
+{
+    auto it = m_running.find(id);
+    if (it == m_running.end()) {
+        return;
+    }
+
+    // Drain what is left in the pipes and flush partial diagnostics
+    onJobOutput(id, false);
+    onJobOutput(id, true);
+    it = m_running.find(id);
+    it->stdoutDiagnostics->finish();
+    it->stderrDiagnostics->finish();
+
+    JobState state = JobState::Passed;
+    if (it->cancelRequested) {
+        state = JobState::Cancelled;
+    } else if (status == QProcess::CrashExit || exitCode != 0 || m_jobs[id].errorCount > 0) {
+        state = JobState::Failed;
+    }
+
+    finishJob(id, state, exitCode);
+}
+
+void JobRunner::onJobError(int id, QProcess::ProcessError error)
+{
+    // Other errors are followed by finished(); only a failed start is terminal here
+    if (error != QProcess::FailedToStart || !m_running.contains(id)) {
+        return;
+    }
+
+    const QByteArray message = QString("Failed to start: %1\n")
+        .arg(m_running.value(id).process->errorString()).toUtf8();
+    appendTail(m_jobs[id], message);
+    emit jobOutput(id, message);
+
+    finishJob(id, JobState::Failed, -1);
+}
+
+void JobRunner::finishJob(int id, JobState state, int exitCode)
+{
+    const RunningJob run = m_running.take(id);
+
+    JobRecord& record = m_jobs[id];
+    record.state = state;
+    record.exitCode = exitCode;
+    record.elapsedMs = run.timer.elapsed();
+
+    run.process->disconnect(this);
+    run.process->deleteLater();
+    run.stdoutDiagnostics->deleteLater();
+    run.stderrDiagnostics->deleteLater();
+    // Deleted once it has written out the tail; stopping must not block the GUI thread
+    connect(run.capture, &QThread::finished, run.capture, &QObject::deleteLater);
+    run.capture->requestStop();
+
+    emit jobChanged(id);
+
+    scheduleJobs();
+    emit statsChanged();
+
+    if (!isBusy()) {
+        m_wallMs = m_wallTimer.isValid() ? m_wallTimer.elapsed() : 0;
+        qDebug() << "✅ Job batch finished in" << m_wallMs << "ms";
+        emit allFinished();
+    }
+}
+
+void JobRunner::appendTail(JobRecord& record, const QByteArray& data)
+{
+    record.outputTail.append(data);
+    if (record.outputTail.size() <= MAX_TAIL_BYTES) {
+        return;
+    }
+
+    // Keep whole lines at the front of the tail
+    record.outputTail.remove(0, record.outputTail.size() - MAX_TAIL_BYTES);
+    const int newline = record.outputTail.indexOf('\n');
+    if (newline >= 0) {
+        record.outputTail.remove(0, newline + 1);
+    }
+}
@@ -0,0 +1,432 @@
+// JobRunnerTab.cpp
+#include "ui/widgets/terminal/JobRunnerTab.h"
+#include "ui/widgets/terminal/SessionCapture.h"
+#include <QApplication>
+#include <QClipboard>
+#include <QDir>
+#include <QFileDialog>
+#include <QFutureWatcher>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QScrollBar>
+#include <QSettings>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+JobRunnerTab::JobRunnerTab(QWidget* parent)
+    : QWidget(parent)
+    , m_runner(nullptr)
+    , m_layout(nullptr)
+    , m_commandEdit(nullptr)
+    , m_sweepEdit(nullptr)
+    , m_workingDirEdit(nullptr)
+    , m_concurrencySpin(nullptr)
+    , m_runButton(nullptr)
+    , m_stopButton(nullptr)
+    , m_clearButton(nullptr)
+    , m_splitter(nullptr)
+    , m_jobList(nullptr)
+    , m_jobOutput(nullptr)
+    , m_statsLabel(nullptr)
+    , m_statsTimer(nullptr)
+    , m_contextMenu(nullptr)
+{
+    m_runner = new JobRunner(this);
+
+    setupUI();
+    setupContextMenu();
+    restoreSettings();
+
+    connect(m_runner, &JobRunner::jobAdded, this, &JobRunnerTab::onJobAdded);
+    connect(m_runner, &JobRunner::jobChanged, this, &JobRunnerTab::onJobChanged);
+    connect(m_runner, &JobRunner::jobsCleared, this, &JobRunnerTab::onJobsCleared);
+    connect(m_runner, &JobRunner::jobOutput, this, &JobRunnerTab::onJobOutput);
+    connect(m_runner, &JobRunner::statsChanged, this, &JobRunnerTab::updateStats);
+    connect(m_runner, &JobRunner::allFinished, this, [this]() {
+        m_statsTimer->stop();
+        updateStats();
+        updateButtons();
+    });
+
+    updateStats();
+    updateButtons();
+}
+
+JobRunnerTab::~JobRunnerTab()
+{
+}
+
+void JobRunnerTab::setWorkingDirectory(const QString& dir)
+{
+    m_workingDirEdit->setText(dir);
+}
+
+void JobRunnerTab::runJobs()
+{
+    const QString workingDir = m_workingDirEdit->text().trimmed();
+    if (!workingDir.isEmpty() && !QDir(workingDir).exists()) {
+        QMessageBox::warning(this, "Run Jobs", QString("Working directory does not exist:\n%1").arg(workingDir));
+        return;
+    }
+
+    m_runner->setWorkingDirectory(workingDir);
+    m_runner->setMaxConcurrent(m_concurrencySpin->value());
+
+    QString error;
+    if (m_runner->submit(m_commandEdit->text(), m_sweepEdit->text(), &error) < 0) {
+        QMessageBox::warning(this, "Run Jobs", error);
+        return;
+    }
+
+    saveSettings();
+    m_statsTimer->start();
+    updateButtons();
+}
+
+void JobRunnerTab::stopJobs()
+{
+    m_runner->stopAll();
+    updateButtons();
+}
+
+void JobRunnerTab::clearJobs()
+{
+    m_runner->clearFinished();
+}
+
+void JobRunnerTab::onJobAdded(int id)
+{
+    const JobRecord* record = m_runner->job(id);
+    if (!record) {
+        return;
+    }
+
+    QStringList parameters;
+    for (const auto& parameter : record->parameters) {
+        parameters.append(QString("%1=%2").arg(parameter.first, parameter.second));
+    }
+
+    QTreeWidgetItem* item = new QTreeWidgetItem(m_jobList);
+    item->setText(IndexColumn, QString::number(id + 1));
+    item->setText(ParametersColumn, parameters.join(' '));
+    item->setToolTip(ParametersColumn, record->command);
+    item->setData(IndexColumn, Qt::UserRole, id);
+
+    if (m_items.size() <= id) {
+        m_items.resize(id + 1);
+    }
+    m_items[id] = item;
+    updateItem(id);
+}
+
+void JobRunnerTab::onJobChanged(int id)
+{
+    updateItem(id);
+    if (id == selectedJobId()) {
+        onSelectionChanged();
+    }
+}
+
+void JobRunnerTab::onJobsCleared()
+{
+    m_jobList->clear();
+    m_items.clear();
+    m_jobOutput->clear();
+}
+
+void JobRunnerTab::onJobOutput(int id, const QByteArray& data)
+{
+    if (id != selectedJobId()) {
+        return;
+    }
+
+    QTextCursor cursor = m_jobOutput->textCursor();
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(QString::fromUtf8(data));
+
+    QScrollBar* scrollBar = m_jobOutput->verticalScrollBar();
+    scrollBar->setValue(scrollBar->maximum());
+}
+
+void JobRunnerTab::onSelectionChanged()
+{
+    const JobRecord* record = m_runner->job(selectedJobId());
+    if (!record) {
+        m_jobOutput->clear();
+        return;
+    }
+
+    QString header = QString("$ %1\n").arg(record->command);
+    if (record->outputTail.size() >= JobRunner::MAX_TAIL_BYTES - 4096) {
+        header += "[... earlier output is in the job log ...]\n";
+    }
+    m_jobOutput->setPlainText(header + QString::fromUtf8(record->outputTail));
+
+    QScrollBar* scrollBar = m_jobOutput->verticalScrollBar();
+    scrollBar->setValue(scrollBar->maximum());
+}
+
+void JobRunnerTab::onContextMenuRequested(const QPoint& pos)
+{
+    const bool hasJob = m_runner->job(selectedJobId()) != nullptr;
+    m_rerunAction->setEnabled(hasJob);
+    m_exportLogAction->setEnabled(hasJob);
+    m_copyCommandAction->setEnabled(hasJob);
+
+    if (m_contextMenu) {
+        m_contextMenu->exec(m_jobList->viewport()->mapToGlobal(pos));
+    }
+}
+
+void JobRunnerTab::updateStats()
+{
+    const JobStats stats = m_runner->stats();
+
+    QString text = QString("%1 passed, %2 failed, %3 running, %4 queued")
+        .arg(stats.passed).arg(stats.failed).arg(stats.running).arg(stats.queued);
+    if (stats.cancelled > 0) {
+        text += QString(", %1 cancelled").arg(stats.cancelled);
+    }
+    if (stats.finished() > 0) {
+        text += QString("  |  avg %1, min %2, max %3")
+            .arg(formatDuration(stats.averageRuntimeMs()),
+                 formatDuration(stats.minRuntimeMs),
+                 formatDuration(stats.maxRuntimeMs));
+    }
+    if (stats.wallMs > 0) {
+        text += QString("  |  wall %1").arg(formatDuration(stats.wallMs));
+    }
+    m_statsLabel->setText(text);
+
+    // Running jobs show a live runtime
+    for (const JobRecord& record : m_runner->jobs()) {
+        if (record.state == JobState::Running) {
+            updateItem(record.id);
+        }
+    }
+}
+
+void JobRunnerTab::setupUI()
+{
+    m_layout = new QVBoxLayout(this);
+    m_layout->setContentsMargins(5, 5, 5, 5);
+
+    // Command row
+    QHBoxLayout* commandLayout = new QHBoxLayout();
+    m_commandEdit = new QLineEdit(this);
+    m_commandEdit->setPlaceholderText("Command template, e.g. ./build/testbench +seed={seed} +mode={mode}");
+    m_commandEdit->setFont(QFont("Consolas", 9));
+    commandLayout->addWidget(new QLabel("Command:", this));
+    commandLayout->addWidget(m_commandEdit, 1);
+
+    // Sweep row
+    QHBoxLayout* sweepLayout = new QHBoxLayout();
+    m_sweepEdit = new QLineEdit(this);
+    m_sweepEdit->setPlaceholderText("Sweep, e.g. seed=1..32; mode=fast,slow");
+    m_sweepEdit->setFont(QFont("Consolas", 9));
+
+    m_workingDirEdit = new QLineEdit(this);
+    m_workingDirEdit->setPlaceholderText("Working directory");
+
+    m_concurrencySpin = new QSpinBox(this);
+    m_concurrencySpin->setRange(1, 256);
+    m_concurrencySpin->setValue(qMax(1, QThread::idealThreadCount()));
+    m_concurrencySpin->setToolTip("Maximum number of jobs running at the same time");
+
+    m_runButton = new QPushButton("Run", this);
+    m_stopButton = new QPushButton("Stop", this);
+    m_clearButton = new QPushButton("Clear", this);
+
+    connect(m_runButton, &QPushButton::clicked, this, &JobRunnerTab::runJobs);
+    connect(m_stopButton, &QPushButton::clicked, this, &JobRunnerTab::stopJobs);
+    connect(m_clearButton, &QPushButton::clicked, this, &JobRunnerTab::clearJobs);
+    connect(m_commandEdit, &QLineEdit::returnPressed, this, &JobRunnerTab::runJobs);
+    connect(m_sweepEdit, &QLineEdit::returnPressed, this, &JobRunnerTab::runJobs);
+    connect(m_concurrencySpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            m_runner, &JobRunner::setMaxConcurrent);
+
+    sweepLayout->addWidget(new QLabel("Sweep:", this));
+    sweepLayout->addWidget(m_sweepEdit, 2);
+    sweepLayout->addWidget(m_workingDirEdit, 1);
+    sweepLayout->addWidget(new QLabel("Parallel:", this));
+    sweepLayout->addWidget(m_concurrencySpin);
+    sweepLayout->addWidget(m_runButton);
+    sweepLayout->addWidget(m_stopButton);
+    sweepLayout->addWidget(m_clearButton);
+
+    // Job list and output
+    m_splitter = new QSplitter(Qt::Horizontal, this);
+
+    m_jobList = new QTreeWidget(m_splitter);
+    m_jobList->setHeaderLabels({"#", "Parameters", "Status", "Time", "Exit", "Errors / Warnings"});
+    m_jobList->setRootIsDecorated(false);
+    m_jobList->setUniformRowHeights(true);
+    m_jobList->setAlternatingRowColors(true);
+    m_jobList->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_jobList->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_jobList->header()->setSectionResizeMode(ParametersColumn, QHeaderView::Stretch);
+    m_jobList->header()->setStretchLastSection(false);
+
+    m_jobOutput = new QTextEdit(m_splitter);
+    m_jobOutput->setReadOnly(true);
+    m_jobOutput->setFont(QFont("Consolas", 9));
+    m_jobOutput->setLineWrapMode(QTextEdit::NoWrap);
+
+    m_splitter->setStretchFactor(0, 1);
+    m_splitter->setStretchFactor(1, 1);
+
+    connect(m_jobList, &QTreeWidget::itemSelectionChanged, this, &JobRunnerTab::onSelectionChanged);
+    connect(m_jobList, &QTreeWidget::customContextMenuRequested, this, &JobRunnerTab::onContextMenuRequested);
+
+    m_statsLabel = new QLabel(this);
+    m_statsLabel->setStyleSheet("color: #cccccc; padding: 2px;");
+
+    m_statsTimer = new QTimer(this);
+    m_statsTimer->setInterval(STATS_REFRESH_MS);
+    connect(m_statsTimer, &QTimer::timeout, this, &JobRunnerTab::updateStats);
+
+    m_layout->addLayout(commandLayout);
+    m_layout->addLayout(sweepLayout);
+    m_layout->addWidget(m_splitter, 1);
+    m_layout->addWidget(m_statsLabel);
+}
+
+void JobRunnerTab::setupContextMenu()
+{
+    m_contextMenu = new QMenu(this);
+
+    m_rerunAction = new QAction("Rerun Job", this);
+    m_exportLogAction = new QAction("Export Job Log...", this);
+    m_copyCommandAction = new QAction("Copy Command", this);
+
+    connect(m_rerunAction, &QAction::triggered, [this]() {
+        const JobRecord* record = m_runner->job(selectedJobId());
+        if (!record) {
+            return;
+        }
+        m_runner->setWorkingDirectory(m_workingDirEdit->text().trimmed());
+        m_runner->submit(record->command, QString());
+        m_statsTimer->start();
+        updateButtons();
+    });
+
+    connect(m_exportLogAction, &QAction::triggered, [this]() {
+        const JobRecord* record = m_runner->job(selectedJobId());
+        if (!record) {
+            return;
+        }
+
+        const QStringList files = SessionCaptureReader::captureFiles(record->captureDirectory,
+                                                                     record->captureBaseName);
+        if (files.isEmpty()) {
+            QMessageBox::information(this, "Export Job Log", "No log was captured for this job.");
+            return;
+        }
+
+        const QString path = QFileDialog::getSaveFileName(this, "Export Job Log",
+            QDir(m_workingDirEdit->text()).filePath(record->captureBaseName + ".log"),
+            "Log Files (*.log *.txt);;All Files (*)");
+        if (path.isEmpty()) {
+            return;
+        }
+
+        auto* watcher = new QFutureWatcher<QString>(this);
+        connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher]() {
+            const QString error = watcher->result();
+            if (!error.isEmpty()) {
+                QMessageBox::warning(this, "Export Job Log", error);
+            }
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run([files, path]() {
+            QString error;
+            SessionCaptureReader::exportText(files, path, &error);
+            return error;
+        }));
+    });
+
+    connect(m_copyCommandAction, &QAction::triggered, [this]() {
+        if (const JobRecord* record = m_runner->job(selectedJobId())) {
+            QApplication::clipboard()->setText(record->command);
+        }
+    });
+
+    m_contextMenu->addAction(m_rerunAction);
+    m_contextMenu->addAction(m_exportLogAction);
+    m_contextMenu->addSeparator();
+    m_contextMenu->addAction(m_copyCommandAction);
+}
+
+void JobRunnerTab::updateItem(int id)
+{
+    const JobRecord* record = m_runner->job(id);
+    if (!record || id >= m_items.size() || !m_items[id]) {
+        return;
+    }
+
+    QTreeWidgetItem* item = m_items[id];
+    item->setText(StatusColumn, JobRunner::stateToString(record->state));
+
+    QColor color(204, 204, 204);
+    switch (record->state) {
+        case JobState::Running:   color = QColor(55, 148, 255); break;
+        case JobState::Passed:    color = QColor(137, 209, 133); break;
+        case JobState::Failed:    color = QColor(244, 135, 113); break;
+        case JobState::Cancelled: color = QColor(128, 128, 128); break;
+        default: break;
+    }
+    item->setForeground(StatusColumn, color);
+
+    const bool finished = record->state == JobState::Passed || record->state == JobState::Failed;
+    const bool timed = finished || record->state == JobState::Running;
+    item->setText(TimeColumn, timed ? formatDuration(m_runner->elapsedMs(id)) : QString());
+    item->setText(ExitColumn, finished ? QString::number(record->exitCode) : QString());
+    item->setText(DiagnosticsColumn, (record->errorCount || record->warningCount)
+        ? QString("%1 / %2").arg(record->errorCount).arg(record->warningCount) : QString());
+}
+
+void JobRunnerTab::updateButtons()
+{
+    const bool busy = m_runner->isBusy();
+    m_stopButton->setEnabled(busy);
+    m_clearButton->setEnabled(!busy);
+}
+
+void JobRunnerTab::saveSettings()
+{
+    QSettings settings;
+    settings.beginGroup("JobRunner");
+    settings.setValue("command", m_commandEdit->text());
+    settings.setValue("sweep", m_sweepEdit->text());
+    settings.setValue("workingDirectory", m_workingDirEdit->text());
+    settings.setValue("concurrency", m_concurrencySpin->value());
+    settings.endGroup();
+}
+
+void JobRunnerTab::restoreSettings()
+{
+    QSettings settings;
+    settings.beginGroup("JobRunner");
+    m_commandEdit->setText(settings.value("command").toString());
+    m_sweepEdit->setText(settings.value("sweep").toString());
+    m_workingDirEdit->setText(settings.value("workingDirectory", QDir::currentPath()).toString());
+    m_concurrencySpin->setValue(settings.value("concurrency", m_concurrencySpin->value()).toInt());
+    settings.endGroup();
+}
+
+int JobRunnerTab::selectedJobId() const
+{
+    const QList<QTreeWidgetItem*> selected = m_jobList->selectedItems();
+    return selected.isEmpty() ? -1 : selected.first()->data(IndexColumn, Qt::UserRole).toInt();
+}
+
+QString JobRunnerTab::formatDuration(qint64 ms)
+{
+    if (ms < 1000) {
+        return QString("%1 ms").arg(ms);
+    }
+    if (ms < 60000) {
+        return QString("%1 s").arg(ms / 1000.0, 0, 'f', 1);
+    }
+    return QString("%1m %2s").arg(ms / 60000).arg((ms / 1000) % 60);
+}
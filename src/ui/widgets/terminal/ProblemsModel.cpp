@@ -0,0 +1,649 @@
+// ProblemsModel.cpp
+#include "ui/widgets/terminal/ProblemsModel.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFileInfo>
+#include <QColor>
+#include <QFont>
+#include <QSet>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Batches larger than this are applied through one filter run instead of
+// one row insertion per diagnostic.
+constexpr int kBatchResetThreshold = 256;
+
+// How often the linear scan polls for cancellation
+constexpr int kCancelPollInterval = 4096;
+
+bool recordLess(const QVector<ProblemRecord>& records, int a, int b,
+                int sortColumn, Qt::SortOrder order)
+{
+    const ProblemRecord& ra = records.at(a);
+    const ProblemRecord& rb = records.at(b);
+
+    int cmp = 0;
+    switch (sortColumn) {
+        case ProblemsModel::SeverityColumn:
+            cmp = static_cast<int>(ra.severity) - static_cast<int>(rb.severity);
+            break;
+        case ProblemsModel::ColumnColumn:
+            cmp = ra.column - rb.column;
+            break;
+        case ProblemsModel::MessageColumn:
+            cmp = QString::compare(ra.message, rb.message, Qt::CaseInsensitive);
+            break;
+        default:
+            // Line and file order (rows of one group share the file)
+            break;
+    }
+    if (cmp == 0) cmp = ra.line - rb.line;
+    if (cmp == 0) cmp = ra.column - rb.column;
+    if (cmp == 0) cmp = a - b;
+
+    return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+}
+
+bool groupLess(const QStringList& fileNames, int fa, int fb,
+               int sortColumn, Qt::SortOrder order)
+{
+    int cmp = QString::compare(fileNames.at(fa), fileNames.at(fb), Qt::CaseInsensitive);
+    if (cmp == 0) cmp = fa - fb;
+
+    // Groups only follow the header direction when sorting by file
+    if (sortColumn == ProblemsModel::FileColumn && order == Qt::DescendingOrder) {
+        return cmp > 0;
+    }
+    return cmp < 0;
+}
+
+} // namespace
+
+// ProblemIndex Implementation
+void ProblemIndex::clear()
+{
+    m_haystacks.clear();
+    m_postings.clear();
+}
+
+quint64 ProblemIndex::trigramKey(QChar a, QChar b, QChar c)
+{
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+void ProblemIndex::append(const QString& text)
+{
+    const int id = m_haystacks.size();
+    const QString folded = fold(text);
+    m_haystacks.append(folded);
+
+    for (int i = 0; i + 2 < folded.size(); ++i) {
+        QVector<int>& list = m_postings[trigramKey(folded.at(i), folded.at(i + 1), folded.at(i + 2))];
+        // Ids are appended in increasing order, so a repeated trigram is always the last entry
+        if (list.isEmpty() || list.last() != id) {
+            list.append(id);
+        }
+    }
+}
+
+bool ProblemIndex::matches(int id, const QString& needle) const
+{
+    return id >= 0 && id < m_haystacks.size() && m_haystacks.at(id).contains(needle);
+}
+
+QVector<int> ProblemIndex::query(const QString& needle, const std::function<bool()>& cancelled) const
+{
+    QVector<int> result;
+    auto isCancelled = [&cancelled]() { return cancelled && cancelled(); };
+
+    if (needle.size() < 3) {
+        // Too short for trigrams - scan the haystacks directly
+        for (int id = 0; id < m_haystacks.size(); ++id) {
+            if ((id % kCancelPollInterval) == 0 && isCancelled()) {
+                return QVector<int>();
+            }
+            if (m_haystacks.at(id).contains(needle)) {
+                result.append(id);
+            }
+        }
+        return result;
+    }
+
+    // Collect the posting list of every distinct trigram in the query
+    QVector<const QVector<int>*> lists;
+    QSet<quint64> seen;
+    for (int i = 0; i + 2 < needle.size(); ++i) {
+        const quint64 key = trigramKey(needle.at(i), needle.at(i + 1), needle.at(i + 2));
+        if (seen.contains(key)) {
+            continue;
+        }
+        seen.insert(key);
+
+        auto it = m_postings.constFind(key);
+        if (it == m_postings.constEnd()) {
+            return result; // A trigram nobody has - no matches
+        }
+        lists.append(&it.value());
+    }
+
+    // Intersect starting from the rarest trigram
+    std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) {
+        return a->size() < b->size();
+    });
+
+    QVector<int> candidates = *lists.first();
+    QVector<int> scratch;
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        if (isCancelled()) {
+            return QVector<int>();
+        }
+        scratch.clear();
+        scratch.reserve(candidates.size());
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                              lists.at(i)->cbegin(), lists.at(i)->cend(),
+                              std::back_inserter(scratch));
+        candidates.swap(scratch);
+    }
+
+    // Trigrams may match out of order - verify the survivors
+    result.reserve(candidates.size());
+    for (int i = 0; i < candidates.size(); ++i) {
+        if ((i % kCancelPollInterval) == 0 && isCancelled()) {
+            return QVector<int>();
+        }
+        const int id = candidates.at(i);
+        if (m_haystacks.at(id).contains(needle)) {
+            result.append(id);
+        }
+    }
+    return result;
+}
+
+// ProblemsModel Implementation
+ProblemsModel::ProblemsModel(QObject* parent)
+    : QAbstractItemModel(parent)
+    , m_generation(std::make_shared<std::atomic<int>>(0))
+{
+    connect(&m_watcher, &QFutureWatcher<FilterResult>::finished, this, &ProblemsModel::onFilterFinished);
+}
+
+ProblemsModel::~ProblemsModel()
+{
+    // Tell any running worker its result is no longer wanted
+    m_generation->fetch_add(1);
+    m_watcher.waitForFinished();
+}
+
+QModelIndex ProblemsModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    if (!parent.isValid()) {
+        if (row >= m_groups.size()) {
+            return QModelIndex();
+        }
+        return createIndex(row, column, quintptr(0));
+    }
+
+    // Children store their group row + 1 as internal id (0 marks a group)
+    if (isGroup(parent) && row < m_groups.at(parent.row()).ids.size()) {
+        return createIndex(row, column, quintptr(parent.row() + 1));
+    }
+    return QModelIndex();
+}
+
+QModelIndex ProblemsModel::parent(const QModelIndex& child) const
+{
+    if (!child.isValid() || child.internalId() == 0) {
+        return QModelIndex();
+    }
+    return createIndex(static_cast<int>(child.internalId() - 1), 0, quintptr(0));
+}
+
+int ProblemsModel::rowCount(const QModelIndex& parent) const
+{
+    if (!parent.isValid()) {
+        return m_groups.size();
+    }
+    if (isGroup(parent) && parent.column() == 0) {
+        return m_groups.at(parent.row()).ids.size();
+    }
+    return 0;
+}
+
+int ProblemsModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent)
+    return ColumnCount;
+}
+
+bool ProblemsModel::isGroup(const QModelIndex& index) const
+{
+    return index.isValid() && index.internalId() == 0 && index.row() < m_groups.size();
+}
+
+QVariant ProblemsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    // File group row
+    if (isGroup(index)) {
+        const ProblemGroup& group = m_groups.at(index.row());
+        switch (role) {
+            case Qt::DisplayRole:
+                if (index.column() == 0) {
+                    return QString("%1 (%2)").arg(m_fileNames.at(group.fileIndex)).arg(group.ids.size());
+                }
+                return QVariant();
+            case Qt::ToolTipRole:
+            case FilePathRole:
+                return m_files.at(group.fileIndex);
+            case Qt::FontRole: {
+                QFont font;
+                font.setBold(true);
+                return font;
+            }
+            case IsGroupRole:
+                return true;
+            default:
+                return QVariant();
+        }
+    }
+
+    const int groupRow = static_cast<int>(index.internalId() - 1);
+    if (groupRow < 0 || groupRow >= m_groups.size() || index.row() >= m_groups.at(groupRow).ids.size()) {
+        return QVariant();
+    }
+    const ProblemRecord& record = m_records.at(m_groups.at(groupRow).ids.at(index.row()));
+
+    switch (role) {
+        case Qt::DisplayRole:
+            switch (index.column()) {
+                case SeverityColumn: return severityToString(record.severity);
+                case LineColumn:     return record.line;
+                case ColumnColumn:   return record.column;
+                case FileColumn:     return m_fileNames.at(record.fileIndex);
+                case MessageColumn:  return record.message;
+                default:             return QVariant();
+            }
+        case Qt::ToolTipRole:
+            if (index.column() == FileColumn) {
+                return m_files.at(record.fileIndex);
+            }
+            if (index.column() == MessageColumn) {
+                return record.message;
+            }
+            return QVariant();
+        case Qt::ForegroundRole:
+            if (index.column() == SeverityColumn) {
+                switch (record.severity) {
+                    case ProblemSeverity::Error:   return QColor(255, 100, 100);
+                    case ProblemSeverity::Warning: return QColor(255, 200, 100);
+                    default:                       return QColor(100, 200, 255);
+                }
+            }
+            return QVariant();
+        case FilePathRole:
+            return m_files.at(record.fileIndex);
+        case LineRole:
+            return record.line;
+        case ColumnRole:
+            return record.column;
+        case IsGroupRole:
+            return false;
+        default:
+            return QVariant();
+    }
+}
+
+QVariant ProblemsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (section) {
+        case SeverityColumn: return QStringLiteral("Severity");
+        case LineColumn:     return QStringLiteral("Line");
+        case ColumnColumn:   return QStringLiteral("Column");
+        case FileColumn:     return QStringLiteral("File");
+        case MessageColumn:  return QStringLiteral("Message");
+        default:             return QVariant();
+    }
+}
+
+void ProblemsModel::sort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrder = order;
+
+    emit layoutAboutToBeChanged();
+
+    // Remember what every persistent index points at: (file, record id or -1 for the group)
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QVector<QPair<int, int>> anchors;
+    anchors.reserve(oldIndexes.size());
+    for (const QModelIndex& idx : oldIndexes) {
+        if (isGroup(idx)) {
+            anchors.append(qMakePair(m_groups.at(idx.row()).fileIndex, -1));
+        } else {
+            const ProblemGroup& group = m_groups.at(static_cast<int>(idx.internalId() - 1));
+            anchors.append(qMakePair(group.fileIndex, group.ids.at(idx.row())));
+        }
+    }
+
+    const QStringList& fileNames = m_fileNames;
+    std::sort(m_groups.begin(), m_groups.end(), [&](const ProblemGroup& a, const ProblemGroup& b) {
+        return groupLess(fileNames, a.fileIndex, b.fileIndex, column, order);
+    });
+    for (ProblemGroup& group : m_groups) {
+        std::sort(group.ids.begin(), group.ids.end(), [&](int a, int b) {
+            return recordLess(m_records, a, b, column, order);
+        });
+    }
+    rebuildGroupLookup();
+
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (int i = 0; i < oldIndexes.size(); ++i) {
+        const int groupRow = m_groupOfFile.value(anchors.at(i).first, -1);
+        if (groupRow < 0) {
+            newIndexes.append(QModelIndex());
+        } else if (anchors.at(i).second < 0) {
+            newIndexes.append(createIndex(groupRow, oldIndexes.at(i).column(), quintptr(0)));
+        } else {
+            const int row = m_groups.at(groupRow).ids.indexOf(anchors.at(i).second);
+            newIndexes.append(createIndex(row, oldIndexes.at(i).column(), quintptr(groupRow + 1)));
+        }
+    }
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged();
+
+    // A filter still in flight was computed with the old order
+    if (isFiltering()) {
+        startFilter();
+    }
+}
+
+void ProblemsModel::addProblem(const ProblemEntry& entry)
+{
+    appendRecord(entry);
+
+    const int id = m_records.size() - 1;
+    if (m_needle.isEmpty() || m_index.matches(id, m_needle)) {
+        insertVisible(id);
+    }
+    emit countsChanged();
+}
+
+void ProblemsModel::addProblems(const QVector<ProblemEntry>& entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    if (entries.size() > kBatchResetThreshold) {
+        // One off-thread regroup is cheaper than thousands of row insertions
+        m_records.reserve(m_records.size() + entries.size());
+        for (const ProblemEntry& entry : entries) {
+            appendRecord(entry);
+        }
+        startFilter();
+    } else {
+        for (const ProblemEntry& entry : entries) {
+            appendRecord(entry);
+            const int id = m_records.size() - 1;
+            if (m_needle.isEmpty() || m_index.matches(id, m_needle)) {
+                insertVisible(id);
+            }
+        }
+    }
+    emit countsChanged();
+}
+
+void ProblemsModel::clear()
+{
+    // Drop any filter result computed for the old contents
+    m_generation->fetch_add(1);
+
+    beginResetModel();
+    m_records.clear();
+    m_files.clear();
+    m_fileNames.clear();
+    m_fileLookup.clear();
+    m_index.clear();
+    std::fill(std::begin(m_severityCounts), std::end(m_severityCounts), 0);
+    m_groups.clear();
+    m_groupOfFile.clear();
+    m_visibleCount = 0;
+    endResetModel();
+
+    emit countsChanged();
+}
+
+int ProblemsModel::countBySeverity(ProblemSeverity severity) const
+{
+    return m_severityCounts[static_cast<int>(severity)];
+}
+
+void ProblemsModel::setFilter(const QString& filter)
+{
+    const QString needle = ProblemIndex::fold(filter.trimmed());
+    m_filterText = filter;
+    if (needle == m_needle && !isFiltering()) {
+        return;
+    }
+    m_needle = needle;
+    startFilter();
+}
+
+ProblemSeverity ProblemsModel::severityFromString(const QString& severity)
+{
+    const QString s = severity.trimmed().toLower();
+    if (s.startsWith("error") || s.startsWith("fatal")) {
+        return ProblemSeverity::Error;
+    }
+    if (s.startsWith("warn")) {
+        return ProblemSeverity::Warning;
+    }
+    return ProblemSeverity::Info;
+}
+
+QString ProblemsModel::severityToString(ProblemSeverity severity)
+{
+    switch (severity) {
+        case ProblemSeverity::Error:   return QStringLiteral("Error");
+        case ProblemSeverity::Warning: return QStringLiteral("Warning");
+        default:                       return QStringLiteral("Info");
+    }
+}
+
+void ProblemsModel::onFilterFinished()
+{
+    const FilterResult result = m_watcher.result();
+    if (result.generation != m_generation->load()) {
+        return; // Superseded by a newer filter, a sort or a clear
+    }
+
+    beginResetModel();
+    m_groups = result.groups;
+    rebuildGroupLookup();
+    m_visibleCount = 0;
+    for (const ProblemGroup& group : m_groups) {
+        m_visibleCount += group.ids.size();
+    }
+    endResetModel();
+
+    // Pick up diagnostics that arrived while the worker was running
+    for (int id = result.snapshotSize; id < m_records.size(); ++id) {
+        if (m_needle.isEmpty() || m_index.matches(id, m_needle)) {
+            insertVisible(id);
+        }
+    }
+
+    emit filterApplied(m_visibleCount, m_records.size());
+    emit countsChanged();
+}
+
+int ProblemsModel::internFile(const QString& file)
+{
+    auto it = m_fileLookup.constFind(file);
+    if (it != m_fileLookup.constEnd()) {
+        return it.value();
+    }
+
+    const int fileIndex = m_files.size();
+    m_files.append(file);
+    m_fileNames.append(QFileInfo(file).fileName());
+    m_fileLookup.insert(file, fileIndex);
+    return fileIndex;
+}
+
+void ProblemsModel::appendRecord(const ProblemEntry& entry)
+{
+    ProblemRecord record;
+    record.fileIndex = internFile(entry.file);
+    record.line = entry.line;
+    record.column = entry.column;
+    record.severity = severityFromString(entry.severity);
+    record.message = entry.message;
+
+    m_records.append(record);
+    m_severityCounts[static_cast<int>(record.severity)]++;
+
+    // Same fields the old QTreeWidget filter looked at: severity, file name, message
+    m_index.append(severityToString(record.severity) + QLatin1Char('\n')
+                   + m_fileNames.at(record.fileIndex) + QLatin1Char('\n')
+                   + record.message);
+}
+
+void ProblemsModel::insertVisible(int id)
+{
+    const int fileIndex = m_records.at(id).fileIndex;
+    auto it = m_groupOfFile.constFind(fileIndex);
+
+    if (it == m_groupOfFile.constEnd()) {
+        const int groupRow = groupInsertionRow(fileIndex);
+        beginInsertRows(QModelIndex(), groupRow, groupRow);
+        ProblemGroup group;
+        group.fileIndex = fileIndex;
+        group.ids.append(id);
+        m_groups.insert(groupRow, group);
+        rebuildGroupLookup();
+        endInsertRows();
+    } else {
+        const int groupRow = it.value();
+        const int row = insertionRow(m_groups.at(groupRow), id);
+        beginInsertRows(createIndex(groupRow, 0, quintptr(0)), row, row);
+        m_groups[groupRow].ids.insert(row, id);
+        endInsertRows();
+
+        // The group label carries the count
+        const QModelIndex groupIndex = createIndex(groupRow, 0, quintptr(0));
+        emit dataChanged(groupIndex, groupIndex, {Qt::DisplayRole});
+    }
+
+    m_visibleCount++;
+}
+
+int ProblemsModel::insertionRow(const ProblemGroup& group, int id) const
+{
+    auto pos = std::upper_bound(group.ids.cbegin(), group.ids.cend(), id, [this](int a, int b) {
+        return recordLess(m_records, a, b, m_sortColumn, m_sortOrder);
+    });
+    return static_cast<int>(pos - group.ids.cbegin());
+}
+
+int ProblemsModel::groupInsertionRow(int fileIndex) const
+{
+    auto pos = std::upper_bound(m_groups.cbegin(), m_groups.cend(), fileIndex,
+                                [this](int file, const ProblemGroup& group) {
+        return groupLess(m_fileNames, file, group.fileIndex, m_sortColumn, m_sortOrder);
+    });
+    return static_cast<int>(pos - m_groups.cbegin());
+}
+
+void ProblemsModel::rebuildGroupLookup()
+{
+    m_groupOfFile.clear();
+    m_groupOfFile.reserve(m_groups.size());
+    for (int row = 0; row < m_groups.size(); ++row) {
+        m_groupOfFile.insert(m_groups.at(row).fileIndex, row);
+    }
+}
+
+void ProblemsModel::startFilter()
+{
+    const int generation = m_generation->fetch_add(1) + 1;
+
+    // Implicitly shared snapshots - later appends detach on the GUI thread
+    const QVector<ProblemRecord> records = m_records;
+    const QStringList fileNames = m_fileNames;
+    const ProblemIndex index = m_index;
+    const QString needle = m_needle;
+    const int sortColumn = m_sortColumn;
+    const Qt::SortOrder order = m_sortOrder;
+    std::shared_ptr<const std::atomic<int>> latest = m_generation;
+
+    m_watcher.setFuture(QtConcurrent::run([=]() {
+        return computeGroups(records, fileNames, index, needle, sortColumn, order, generation, latest);
+    }));
+}
+
+ProblemsModel::FilterResult ProblemsModel::computeGroups(QVector<ProblemRecord> records, QStringList fileNames,
+                                                         ProblemIndex index, QString needle, int sortColumn,
+                                                         Qt::SortOrder order, int generation,
+                                                         std::shared_ptr<const std::atomic<int>> latestGeneration)
+{
+    FilterResult result;
+    result.generation = generation;
+    result.snapshotSize = records.size();
+
+    auto cancelled = [&latestGeneration, generation]() {
+        return latestGeneration->load(std::memory_order_relaxed) != generation;
+    };
+
+    QVector<int> ids;
+    if (needle.isEmpty()) {
+        ids.resize(records.size());
+        std::iota(ids.begin(), ids.end(), 0);
+    } else {
+        ids = index.query(needle, cancelled);
+    }
+    if (cancelled()) {
+        return result;
+    }
+
+    // Bucket by file, preserving id order inside each bucket
+    QHash<int, int> groupOfFile;
+    for (int id : ids) {
+        const int fileIndex = records.at(id).fileIndex;
+        auto it = groupOfFile.find(fileIndex);
+        if (it == groupOfFile.end()) {
+            it = groupOfFile.insert(fileIndex, result.groups.size());
+            ProblemGroup group;
+            group.fileIndex = fileIndex;
+            result.groups.append(group);
+        }
+        result.groups[it.value()].ids.append(id);
+    }
+
+    std::sort(result.groups.begin(), result.groups.end(), [&](const ProblemGroup& a, const ProblemGroup& b) {
+        return groupLess(fileNames, a.fileIndex, b.fileIndex, sortColumn, order);
+    });
+    for (ProblemGroup& group : result.groups) {
+        if (cancelled()) {
+            return result;
+        }
+        std::sort(group.ids.begin(), group.ids.end(), [&](int a, int b) {
+            return recordLess(records, a, b, sortColumn, order);
+        });
+    }
+    return result;
+}
@@ -0,0 +1,375 @@
+// ScrollbackSearch.cpp
+#include "ui/widgets/terminal/ScrollbackSearch.h"
+#include <QRegularExpression>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+
+void ScrollbackBuffer::sync(const QTextDocument* document, int position)
+{
+    // Lines before the one holding the change are the same as before
+    QTextBlock block = document->findBlock(qBound(0, position, m_length));
+    if (!block.isValid()) {
+        block = document->lastBlock();
+    }
+    const int from = qMin(block.position(), m_length);
+
+    const int index = chunkAt(from);
+    if (index >= 0) {
+        m_chunks[index].truncate(from - m_starts.at(index));
+        const int keep = m_chunks.at(index).isEmpty() ? index : index + 1;
+        m_chunks.resize(keep);
+        m_starts.resize(keep);
+    }
+    m_length = from;
+
+    for (; block.isValid(); block = block.next()) {
+        appendText(block.text(), block.next().isValid());
+    }
+}
+
+void ScrollbackBuffer::removeFront(int length)
+{
+    length = qBound(0, length, m_length);
+    int dropped = 0;
+    while (dropped < m_chunks.size() && m_starts.at(dropped) + m_chunks.at(dropped).size() <= length) {
+        ++dropped;
+    }
+    m_chunks.remove(0, dropped);
+    m_starts.remove(0, dropped);
+
+    // Only the chunk the cut falls into is copied
+    if (!m_chunks.isEmpty() && m_starts.first() < length) {
+        m_chunks.first().remove(0, length - m_starts.first());
+        m_starts.first() = length;
+    }
+    for (int& start : m_starts) {
+        start -= length;
+    }
+    m_length -= length;
+}
+
+void ScrollbackBuffer::clear()
+{
+    m_chunks.clear();
+    m_starts.clear();
+    m_length = 0;
+}
+
+ScrollbackBuffer::Snapshot ScrollbackBuffer::snapshot(int from) const
+{
+    Snapshot snapshot;
+    const int index = qMax(0, chunkAt(from));
+    snapshot.offset = index < m_starts.size() ? m_starts.at(index) : m_length;
+    snapshot.chunks = m_chunks.mid(index);
+    return snapshot;
+}
+
+int ScrollbackBuffer::chunkAt(int position) const
+{
+    auto it = std::upper_bound(m_starts.constBegin(), m_starts.constEnd(), position);
+    return int(it - m_starts.constBegin()) - 1;
+}
+
+void ScrollbackBuffer::appendText(const QString& text, bool endOfLine)
+{
+    // A chunk is closed only at the end of a line, so per-line patterns never straddle two
+    if (m_chunks.isEmpty() || (m_chunks.last().size() >= CHUNK_SIZE && m_chunks.last().endsWith(QLatin1Char('\n')))) {
+        m_chunks.append(QString());
+        m_starts.append(m_length);
+    }
+
+    // One character per document position, as QTextDocument counts them
+    QString line = text;
+    line.replace(QChar::LineSeparator, QLatin1Char('\n'));
+    line.replace(QChar::Nbsp, QLatin1Char(' '));
+    QString& chunk = m_chunks.last();
+    chunk += line;
+    if (endOfLine) {
+        chunk += QLatin1Char('\n');
+    }
+    m_length += line.size() + (endOfLine ? 1 : 0);
+}
+
+// ---------------------------------------------------------------------------
+
+ScrollbackSearch::ScrollbackSearch(QObject* parent)
+    : QObject(parent)
+    , m_generation(std::make_shared<std::atomic<int>>(0))
+{
+    m_pool.setMaxThreadCount(1);
+    connect(&m_watcher, &QFutureWatcher<ScanResult>::finished, this, &ScrollbackSearch::onScanFinished);
+}
+
+ScrollbackSearch::~ScrollbackSearch()
+{
+    // Workers post hits to this object, so none may outlive it
+    m_generation->fetch_add(1);
+    m_pool.waitForDone();
+}
+
+bool ScrollbackSearch::start(const ScrollbackBuffer::Snapshot& text, const Options& options)
+{
+    cancel();
+    m_hits.clear();
+    m_currentIndex = -1;
+    m_searchedLength = 0;
+    m_truncated = false;
+    m_errorString.clear();
+    m_options = options;
+
+    if (options.regex && !options.pattern.isEmpty()) {
+        const QRegularExpression re(options.pattern);
+        if (!re.isValid()) {
+            m_errorString = re.errorString();
+            m_options = Options();
+        }
+    }
+
+    emit hitsChanged();
+    emit currentHitChanged(-1, 0);
+
+    if (!isActive()) {
+        return false;
+    }
+
+    startScan(text, 0);
+    return true;
+}
+
+void ScrollbackSearch::extend(const ScrollbackBuffer::Snapshot& tail, int offset)
+{
+    if (!isActive()) {
+        return;
+    }
+
+    // Drop hits inside the rescanned region
+    auto it = std::lower_bound(m_hits.begin(), m_hits.end(), offset,
+                               [](const SearchHit& hit, int pos) { return hit.position < pos; });
+    m_hits.erase(it, m_hits.end());
+    if (m_currentIndex >= m_hits.size()) {
+        m_currentIndex = -1;
+    }
+    m_searchedLength = qMin(m_searchedLength, offset);
+    m_truncated = false;
+
+    emit hitsChanged();
+    startScan(tail, offset);
+}
+
+bool ScrollbackSearch::removeFront(int length)
+{
+    if (isRunning()) {
+        return false;
+    }
+    if (m_hits.isEmpty() && m_searchedLength == 0) {
+        return true;
+    }
+
+    auto it = std::lower_bound(m_hits.begin(), m_hits.end(), length,
+                               [](const SearchHit& hit, int pos) { return hit.position < pos; });
+    const int removed = int(it - m_hits.begin());
+    m_hits.erase(m_hits.begin(), it);
+    for (SearchHit& hit : m_hits) {
+        hit.position -= length;
+    }
+    m_currentIndex = (m_currentIndex >= removed) ? m_currentIndex - removed : -1;
+    m_searchedLength = qMax(0, m_searchedLength - length);
+
+    emit hitsChanged();
+    emit currentHitChanged(m_currentIndex, m_hits.size());
+    return true;
+}
+
+void ScrollbackSearch::cancel()
+{
+    m_generation->fetch_add(1);
+}
+
+void ScrollbackSearch::clear()
+{
+    cancel();
+    m_options = Options();
+    m_errorString.clear();
+    m_hits.clear();
+    m_currentIndex = -1;
+    m_searchedLength = 0;
+    m_truncated = false;
+
+    emit hitsChanged();
+    emit currentHitChanged(-1, 0);
+}
+
+int ScrollbackSearch::firstHitAfter(int position) const
+{
+    auto it = std::lower_bound(m_hits.constBegin(), m_hits.constEnd(), position,
+                               [](const SearchHit& hit, int pos) { return hit.position + hit.length <= pos; });
+    return it == m_hits.constEnd() ? -1 : int(it - m_hits.constBegin());
+}
+
+int ScrollbackSearch::next(int fromPosition)
+{
+    if (m_hits.isEmpty()) {
+        return -1;
+    }
+
+    int index;
+    if (fromPosition >= 0) {
+        auto it = std::lower_bound(m_hits.constBegin(), m_hits.constEnd(), fromPosition,
+                                   [](const SearchHit& hit, int pos) { return hit.position < pos; });
+        index = (it == m_hits.constEnd()) ? 0 : int(it - m_hits.constBegin());
+    } else {
+        index = (m_currentIndex + 1) % m_hits.size();
+    }
+
+    setCurrentIndex(index);
+    return index;
+}
+
+int ScrollbackSearch::previous(int fromPosition)
+{
+    if (m_hits.isEmpty()) {
+        return -1;
+    }
+
+    int index;
+    if (fromPosition >= 0) {
+        auto it = std::lower_bound(m_hits.constBegin(), m_hits.constEnd(), fromPosition,
+                                   [](const SearchHit& hit, int pos) { return hit.position < pos; });
+        index = int(it - m_hits.constBegin()) - 1;
+    } else {
+        index = m_currentIndex - 1;
+    }
+    if (index < 0) {
+        index = m_hits.size() - 1;
+    }
+
+    setCurrentIndex(index);
+    return index;
+}
+
+void ScrollbackSearch::setCurrentIndex(int index)
+{
+    if (index < -1 || index >= m_hits.size()) {
+        index = -1;
+    }
+    m_currentIndex = index;
+    emit currentHitChanged(m_currentIndex, m_hits.size());
+}
+
+void ScrollbackSearch::onScanFinished()
+{
+    const ScanResult result = m_watcher.result();
+    if (result.cancelled || result.generation != m_generation->load()) {
+        return;
+    }
+
+    m_searchedLength = result.endOffset;
+    m_truncated = result.truncated;
+    emit searchFinished(m_hits.size(), m_truncated);
+}
+
+void ScrollbackSearch::startScan(const ScrollbackBuffer::Snapshot& text, int from)
+{
+    const int generation = m_generation->fetch_add(1) + 1;
+    const int budget = MAX_HITS - m_hits.size();
+    const Options options = m_options;
+    std::shared_ptr<const std::atomic<int>> latest = m_generation;
+
+    if (budget <= 0) {
+        m_truncated = true;
+        emit searchFinished(m_hits.size(), m_truncated);
+        return;
+    }
+
+    m_watcher.setFuture(QtConcurrent::run(&m_pool, [this, text, from, options, budget, generation, latest]() {
+        return scan(this, text, from, options, budget, generation, latest);
+    }));
+}
+
+void ScrollbackSearch::deliverHits(int generation, const QVector<SearchHit>& hits)
+{
+    if (generation != m_generation->load()) {
+        return;
+    }
+
+    m_hits.append(hits);
+    emit hitsChanged();
+    emit currentHitChanged(m_currentIndex, m_hits.size());
+}
+
+ScrollbackSearch::ScanResult ScrollbackSearch::scan(ScrollbackSearch* receiver, ScrollbackBuffer::Snapshot text,
+                                                    int from, Options options, int budget, int generation,
+                                                    std::shared_ptr<const std::atomic<int>> latestGeneration)
+{
+    ScanResult result;
+    result.generation = generation;
+    result.endOffset = from;
+
+    const Qt::CaseSensitivity cs = options.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    QRegularExpression re;
+    if (options.regex) {
+        QRegularExpression::PatternOptions flags = QRegularExpression::MultilineOption;
+        if (!options.caseSensitive) {
+            flags |= QRegularExpression::CaseInsensitiveOption;
+        }
+        re = QRegularExpression(options.pattern, flags);
+        re.optimize();
+    }
+
+    const qsizetype patternLength = options.pattern.size();
+    QVector<SearchHit> batch;
+    int found = 0;
+    int chunkStart = text.offset;
+
+    // The buffer's chunks end on a line boundary, so they are scanned as they are
+    for (const QString& chunk : text.chunks) {
+        if (latestGeneration->load() != generation) {
+            result.cancelled = true;
+            return result;
+        }
+
+        const int chunkEnd = chunkStart + int(chunk.size());
+        const qsizetype skip = qMax(0, from - chunkStart);
+        if (skip < chunk.size()) {
+            if (options.regex) {
+                QRegularExpressionMatchIterator it = re.globalMatch(chunk, skip);
+                while (it.hasNext() && found < budget) {
+                    const QRegularExpressionMatch match = it.next();
+                    if (match.capturedLength() == 0) {
+                        continue;
+                    }
+                    batch.append({int(chunkStart + match.capturedStart()), int(match.capturedLength())});
+                    found++;
+                }
+            } else {
+                const QStringView view(chunk);
+                qsizetype pos = view.indexOf(options.pattern, skip, cs);
+                while (pos >= 0 && found < budget) {
+                    batch.append({int(chunkStart + pos), int(patternLength)});
+                    found++;
+                    pos = view.indexOf(options.pattern, pos + patternLength, cs);
+                }
+            }
+        }
+
+        if (!batch.isEmpty()) {
+            QMetaObject::invokeMethod(receiver, [receiver, generation, hits = std::move(batch)]() {
+                receiver->deliverHits(generation, hits);
+            }, Qt::QueuedConnection);
+            batch = QVector<SearchHit>();
+        }
+
+        if (found >= budget) {
+            result.truncated = true;
+            result.endOffset = chunkEnd;
+            return result;
+        }
+        chunkStart = chunkEnd;
+    }
+
+    result.endOffset = qMax(from, chunkStart);
+    return result;
+}
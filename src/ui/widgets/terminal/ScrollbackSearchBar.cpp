@@ -0,0 +1,396 @@
+// ScrollbackSearchBar.cpp
+#include "ui/widgets/terminal/ScrollbackSearchBar.h"
+#include <QKeyEvent>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+
+ScrollbackSearchBar::ScrollbackSearchBar(QTextEdit* target, QWidget* parent)
+    : QWidget(parent)
+    , m_target(target)
+    , m_search(nullptr)
+    , m_layout(nullptr)
+    , m_findEdit(nullptr)
+    , m_caseButton(nullptr)
+    , m_regexButton(nullptr)
+    , m_countLabel(nullptr)
+    , m_previousButton(nullptr)
+    , m_nextButton(nullptr)
+    , m_closeButton(nullptr)
+    , m_queryTimer(nullptr)
+    , m_extendTimer(nullptr)
+    , m_dirtyOffset(-1)
+    , m_revealPending(false)
+{
+    m_search = new ScrollbackSearch(this);
+
+    m_queryTimer = new QTimer(this);
+    m_queryTimer->setSingleShot(true);
+    m_queryTimer->setInterval(QUERY_DEBOUNCE_MS);
+
+    m_extendTimer = new QTimer(this);
+    m_extendTimer->setSingleShot(true);
+    m_extendTimer->setInterval(EXTEND_INTERVAL_MS);
+
+    setupUI();
+
+    connect(m_queryTimer, &QTimer::timeout, this, &ScrollbackSearchBar::runSearch);
+    connect(m_extendTimer, &QTimer::timeout, this, &ScrollbackSearchBar::onExtendTimeout);
+    connect(m_search, &ScrollbackSearch::hitsChanged, this, &ScrollbackSearchBar::onHitsChanged);
+    connect(m_search, &ScrollbackSearch::currentHitChanged, this, &ScrollbackSearchBar::onCurrentHitChanged);
+    connect(m_search, &ScrollbackSearch::searchFinished, this, [this]() {
+        updateCountLabel();
+        // Output that arrived during the scan is picked up now
+        if (m_dirtyOffset >= 0 && !m_extendTimer->isActive()) {
+            m_extendTimer->start();
+        }
+    });
+    m_buffer.sync(m_target->document(), 0);
+    connect(m_target->document(), &QTextDocument::contentsChange, this, &ScrollbackSearchBar::onContentsChange);
+    connect(m_target->verticalScrollBar(), &QScrollBar::valueChanged, this, &ScrollbackSearchBar::updateHighlights);
+
+    hide();
+}
+
+ScrollbackSearchBar::~ScrollbackSearchBar()
+{
+}
+
+void ScrollbackSearchBar::activate()
+{
+    // Seed the query with the current selection, like most editors do
+    const QString selection = m_target->textCursor().selectedText();
+    if (!selection.isEmpty() && !selection.contains(QChar::ParagraphSeparator)) {
+        m_findEdit->setText(selection);
+    }
+
+    show();
+    m_findEdit->setFocus();
+    m_findEdit->selectAll();
+
+    if (!m_search->isActive() && !m_findEdit->text().isEmpty()) {
+        runSearch();
+    }
+}
+
+void ScrollbackSearchBar::deactivate()
+{
+    m_queryTimer->stop();
+    m_extendTimer->stop();
+    m_dirtyOffset = -1;
+    m_search->clear();
+    m_target->setExtraSelections({});
+    hide();
+    m_target->setFocus();
+}
+
+void ScrollbackSearchBar::findNext()
+{
+    if (m_queryTimer->isActive()) {
+        m_queryTimer->stop();
+        runSearch();
+        return;
+    }
+
+    const int from = (m_search->currentIndex() < 0) ? firstVisiblePosition() : -1;
+    const int index = m_search->next(from);
+    if (index >= 0) {
+        revealHit(index);
+    }
+}
+
+void ScrollbackSearchBar::findPrevious()
+{
+    const int from = (m_search->currentIndex() < 0) ? lastVisiblePosition() : -1;
+    const int index = m_search->previous(from);
+    if (index >= 0) {
+        revealHit(index);
+    }
+}
+
+bool ScrollbackSearchBar::eventFilter(QObject* obj, QEvent* event)
+{
+    if (obj == m_findEdit && event->type() == QEvent::KeyPress) {
+        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        switch (keyEvent->key()) {
+            case Qt::Key_Return:
+            case Qt::Key_Enter:
+                if (keyEvent->modifiers() & Qt::ShiftModifier) {
+                    findPrevious();
+                } else {
+                    findNext();
+                }
+                return true;
+            case Qt::Key_Escape:
+                deactivate();
+                return true;
+            default:
+                break;
+        }
+    }
+    return QWidget::eventFilter(obj, event);
+}
+
+void ScrollbackSearchBar::onQueryChanged()
+{
+    m_queryTimer->start();
+}
+
+void ScrollbackSearchBar::runSearch()
+{
+    m_extendTimer->stop();
+    m_dirtyOffset = -1;
+
+    ScrollbackSearch::Options options;
+    options.pattern = m_findEdit->text();
+    options.regex = m_regexButton->isChecked();
+    options.caseSensitive = m_caseButton->isChecked();
+
+    m_revealPending = true;
+    m_search->start(m_buffer.snapshot(), options);
+    updateCountLabel();
+}
+
+void ScrollbackSearchBar::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    // Lines trimmed off the top move everything up rather than changing it
+    QTextDocument* document = m_target->document();
+    bool trimmed = position == 0 && charsAdded == 0 && charsRemoved > 0;
+    if (trimmed) {
+        m_buffer.removeFront(charsRemoved);
+    } else {
+        m_buffer.sync(document, position);
+    }
+    if (m_buffer.length() != document->characterCount() - 1) {
+        // The change was not the one reported; read the whole view again
+        m_buffer.clear();
+        m_buffer.sync(document, 0);
+        trimmed = false;
+        position = 0;
+    }
+
+    if (!isVisible() || !m_search->isActive()) {
+        return;
+    }
+
+    if (trimmed) {
+        if (m_search->removeFront(charsRemoved)) {
+            m_dirtyOffset = (m_dirtyOffset < 0) ? -1 : qMax(0, m_dirtyOffset - charsRemoved);
+            return;
+        }
+        // The running scan reports positions from before the trim
+        const ScrollbackSearch::Options options = m_search->options();
+        m_extendTimer->stop();
+        m_dirtyOffset = -1;
+        m_search->start(m_buffer.snapshot(), options);
+        updateCountLabel();
+        return;
+    }
+
+    // Rescan from the start of the changed line; earlier hits stay valid
+    const int lineStart = m_target->document()->findBlock(position).position();
+    if (m_dirtyOffset < 0 || lineStart < m_dirtyOffset) {
+        m_dirtyOffset = lineStart;
+    }
+
+    // Not restarted on every change, so a steady stream still gets searched
+    if (!m_extendTimer->isActive()) {
+        m_extendTimer->start();
+    }
+}
+
+void ScrollbackSearchBar::onExtendTimeout()
+{
+    if (m_dirtyOffset < 0 || !m_search->isActive()) {
+        return;
+    }
+    if (m_search->isRunning()) {
+        // Picked up again from searchFinished
+        return;
+    }
+
+    // The tail of the last scan may have been an unfinished line
+    QTextDocument* document = m_target->document();
+    const int searchedLineStart = document->findBlock(m_search->searchedLength()).position();
+    const int offset = qMax(0, qMin(m_dirtyOffset, searchedLineStart));
+    m_dirtyOffset = -1;
+
+    m_search->extend(m_buffer.snapshot(offset), offset);
+    updateCountLabel();
+}
+
+void ScrollbackSearchBar::onHitsChanged()
+{
+    if (m_revealPending && m_search->hitCount() > 0) {
+        m_revealPending = false;
+        const int index = m_search->next(firstVisiblePosition());
+        revealHit(index);
+    }
+    updateCountLabel();
+    updateHighlights();
+}
+
+void ScrollbackSearchBar::onCurrentHitChanged(int index, int total)
+{
+    Q_UNUSED(index)
+    Q_UNUSED(total)
+    updateCountLabel();
+    updateHighlights();
+}
+
+void ScrollbackSearchBar::updateHighlights()
+{
+    QList<QTextEdit::ExtraSelection> selections;
+    const QVector<SearchHit>& hits = m_search->hits();
+
+    if (isVisible() && !hits.isEmpty()) {
+        QTextDocument* document = m_target->document();
+        const int documentEnd = document->characterCount() - 1;
+        const int first = firstVisiblePosition();
+        const int last = lastVisiblePosition();
+        const int current = m_search->currentIndex();
+
+        QTextCharFormat matchFormat;
+        matchFormat.setBackground(QColor(234, 92, 0, 85));
+        QTextCharFormat currentFormat;
+        currentFormat.setBackground(QColor(81, 92, 106));
+
+        int index = m_search->firstHitAfter(first);
+        while (index >= 0 && index < hits.size() && hits[index].position <= last
+               && selections.size() < MAX_VISIBLE_HIGHLIGHTS) {
+            const SearchHit& hit = hits[index];
+            if (hit.position + hit.length > documentEnd) {
+                break; // Stale hit; a rescan is pending
+            }
+
+            QTextEdit::ExtraSelection selection;
+            selection.cursor = QTextCursor(document);
+            selection.cursor.setPosition(hit.position);
+            selection.cursor.setPosition(hit.position + hit.length, QTextCursor::KeepAnchor);
+            selection.format = (index == current) ? currentFormat : matchFormat;
+            selections.append(selection);
+            ++index;
+        }
+    }
+
+    m_target->setExtraSelections(selections);
+}
+
+void ScrollbackSearchBar::setupUI()
+{
+    m_layout = new QHBoxLayout(this);
+    m_layout->setContentsMargins(5, 2, 5, 2);
+    m_layout->setSpacing(2);
+
+    m_findEdit = new QLineEdit(this);
+    m_findEdit->setPlaceholderText("Find");
+    m_findEdit->setClearButtonEnabled(true);
+    m_findEdit->installEventFilter(this);
+
+    m_caseButton = new QToolButton(this);
+    m_caseButton->setText("Aa");
+    m_caseButton->setToolTip("Match Case");
+    m_caseButton->setCheckable(true);
+
+    m_regexButton = new QToolButton(this);
+    m_regexButton->setText(".*");
+    m_regexButton->setToolTip("Use Regular Expression");
+    m_regexButton->setCheckable(true);
+
+    m_countLabel = new QLabel("No results", this);
+    m_countLabel->setMinimumWidth(80);
+
+    m_previousButton = new QToolButton(this);
+    m_previousButton->setText("↑");
+    m_previousButton->setToolTip("Previous Match (Shift+Enter)");
+
+    m_nextButton = new QToolButton(this);
+    m_nextButton->setText("↓");
+    m_nextButton->setToolTip("Next Match (Enter)");
+
+    m_closeButton = new QToolButton(this);
+    m_closeButton->setText("✕");
+    m_closeButton->setToolTip("Close (Escape)");
+
+    connect(m_findEdit, &QLineEdit::textChanged, this, &ScrollbackSearchBar::onQueryChanged);
+    connect(m_caseButton, &QToolButton::toggled, this, &ScrollbackSearchBar::runSearch);
+    connect(m_regexButton, &QToolButton::toggled, this, &ScrollbackSearchBar::runSearch);
+    connect(m_previousButton, &QToolButton::clicked, this, &ScrollbackSearchBar::findPrevious);
+    connect(m_nextButton, &QToolButton::clicked, this, &ScrollbackSearchBar::findNext);
+    connect(m_closeButton, &QToolButton::clicked, this, &ScrollbackSearchBar::deactivate);
+
+    m_layout->addWidget(m_findEdit, 1);
+    m_layout->addWidget(m_caseButton);
+    m_layout->addWidget(m_regexButton);
+    m_layout->addWidget(m_countLabel);
+    m_layout->addWidget(m_previousButton);
+    m_layout->addWidget(m_nextButton);
+    m_layout->addWidget(m_closeButton);
+}
+
+void ScrollbackSearchBar::updateCountLabel()
+{
+    if (!m_search->errorString().isEmpty()) {
+        m_countLabel->setText("Invalid regex");
+        m_countLabel->setToolTip(m_search->errorString());
+        m_countLabel->setStyleSheet("color: #f48771;");
+        return;
+    }
+    m_countLabel->setToolTip(QString());
+    m_countLabel->setStyleSheet(QString());
+
+    const int total = m_search->hitCount();
+    if (!m_search->isActive()) {
+        m_countLabel->setText("No results");
+        return;
+    }
+
+    QString text;
+    if (total == 0) {
+        text = m_search->isRunning() ? QString("Searching...") : QString("No results");
+    } else {
+        const QString totalText = m_search->isTruncated()
+            ? QString("%1+").arg(total) : QString::number(total);
+        const int current = m_search->currentIndex();
+        text = (current >= 0) ? QString("%1 of %2").arg(current + 1).arg(totalText) : totalText;
+        if (m_search->isRunning()) {
+            text += "...";
+        }
+    }
+    m_countLabel->setText(text);
+}
+
+void ScrollbackSearchBar::revealHit(int index)
+{
+    if (index < 0 || index >= m_search->hitCount()) {
+        return;
+    }
+
+    const SearchHit& hit = m_search->hits().at(index);
+    if (hit.position > m_target->document()->characterCount() - 1) {
+        return;
+    }
+
+    // Scroll without touching the text cursor: the terminal uses it for input
+    QTextCursor cursor(m_target->document());
+    cursor.setPosition(hit.position);
+    const QRect rect = m_target->cursorRect(cursor);
+    const QRect viewport = m_target->viewport()->rect();
+    if (!viewport.contains(rect)) {
+        QScrollBar* scrollBar = m_target->verticalScrollBar();
+        scrollBar->setValue(scrollBar->value() + rect.center().y() - viewport.height() / 2);
+    }
+    updateHighlights();
+}
+
+int ScrollbackSearchBar::firstVisiblePosition() const
+{
+    return m_target->cursorForPosition(QPoint(0, 0)).position();
+}
+
+int ScrollbackSearchBar::lastVisiblePosition() const
+{
+    const QRect viewport = m_target->viewport()->rect();
+    return m_target->cursorForPosition(viewport.bottomRight()).position();
+}
@@ -0,0 +1,314 @@
+// SessionCapture.cpp
+#include "ui/widgets/terminal/SessionCapture.h"
+#include <QDateTime>
+#include <QDir>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+
+constexpr int kRecordHeaderSize = 5;   // quint8 stream + quint32 length
+constexpr int kBlockHeaderSize = 4;    // quint32 payload size
+
+void appendRecord(QByteArray& target, CaptureStream stream, const QByteArray& data)
+{
+    char header[kRecordHeaderSize];
+    header[0] = static_cast<char>(stream);
+    qToLittleEndian<quint32>(static_cast<quint32>(data.size()), header + 1);
+    target.append(header, kRecordHeaderSize);
+    target.append(data);
+}
+
+} // namespace
+
+// SessionCaptureWriter Implementation
+SessionCaptureWriter::SessionCaptureWriter(const Settings& settings, QObject* parent)
+    : QThread(parent)
+    , m_settings(settings)
+{
+}
+
+SessionCaptureWriter::~SessionCaptureWriter()
+{
+    stop();
+}
+
+void SessionCaptureWriter::append(CaptureStream stream, const QByteArray& data)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_stopRequested) {
+        return;
+    }
+    if (m_pending.size() + data.size() > m_settings.maxPendingBytes) {
+        m_bytesDropped.fetch_add(data.size());
+        return;
+    }
+
+    appendRecord(m_pending, stream, data);
+    m_bytesCaptured.fetch_add(data.size());
+
+    if (m_pending.size() >= m_settings.blockSize) {
+        m_wake.wakeOne();
+    }
+}
+
+quint64 SessionCaptureWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_wake.wakeOne();
+    return ++m_flushesRequested;
+}
+
+void SessionCaptureWriter::requestStop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopRequested = true;
+    m_wake.wakeOne();
+}
+
+void SessionCaptureWriter::stop()
+{
+    requestStop();
+    wait();
+}
+
+QString SessionCaptureWriter::currentFile() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_currentPath;
+}
+
+void SessionCaptureWriter::run()
+{
+    if (!QDir().mkpath(m_settings.directory)) {
+        emit captureError(QString("Cannot create capture directory %1").arg(m_settings.directory));
+        // Nothing will be written; nobody waiting on a flush should wait any longer
+        QMutexLocker locker(&m_mutex);
+        const quint64 flushes = m_flushesRequested;
+        locker.unlock();
+        emit flushed(flushes);
+        return;
+    }
+
+    quint64 flushesDone = 0;
+    for (;;) {
+        QByteArray records;
+        bool stopping = false;
+        quint64 flushes = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_pending.size() < m_settings.blockSize && !m_flushRequested && !m_stopRequested) {
+                m_wake.wait(&m_mutex, static_cast<unsigned long>(m_settings.flushIntervalMs));
+            }
+            records.swap(m_pending);
+            m_flushRequested = false;
+            stopping = m_stopRequested;
+            flushes = m_flushesRequested;
+        }
+
+        if (!records.isEmpty() && !m_failed) {
+            m_failed = !writeBlock(records);
+        }
+
+        // Everything queued before those flushes was in this block
+        if (flushes != flushesDone) {
+            flushesDone = flushes;
+            emit flushed(flushes);
+        }
+        if (stopping) {
+            break;
+        }
+    }
+
+    if (m_file) {
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+    }
+
+    // Flushes asked for after the last block are answered too; nothing more will be written
+    QMutexLocker locker(&m_mutex);
+    const quint64 outstanding = m_flushesRequested;
+    locker.unlock();
+    if (outstanding != flushesDone) {
+        emit flushed(outstanding);
+    }
+}
+
+bool SessionCaptureWriter::writeBlock(const QByteArray& records)
+{
+    if (!m_file || m_file->size() >= m_settings.maxFileSize) {
+        if (!openNextFile()) {
+            return false;
+        }
+    }
+
+    const QByteArray payload = qCompress(records, m_settings.compressionLevel);
+    char header[kBlockHeaderSize];
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header);
+
+    if (m_file->write(header, kBlockHeaderSize) != kBlockHeaderSize
+        || m_file->write(payload) != payload.size()) {
+        emit captureError(QString("Failed to write capture file %1: %2")
+                          .arg(m_file->fileName(), m_file->errorString()));
+        return false;
+    }
+
+    // Hand the block to the OS so readers (export) see whole blocks
+    m_file->flush();
+    return true;
+}
+
+bool SessionCaptureWriter::openNextFile()
+{
+    if (m_file) {
+        m_file->close();
+        delete m_file;
+        m_file = nullptr;
+    }
+
+    if (m_runStamp.isEmpty()) {
+        m_runStamp = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+    }
+
+    const QString name = QString("%1-%2-%3.%4")
+        .arg(m_settings.baseName, m_runStamp)
+        .arg(m_fileSequence++, 3, 10, QLatin1Char('0'))
+        .arg(fileSuffix());
+    const QString path = QDir(m_settings.directory).filePath(name);
+
+    m_file = new QFile(path);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        emit captureError(QString("Cannot open capture file %1: %2").arg(path, m_file->errorString()));
+        delete m_file;
+        m_file = nullptr;
+        return false;
+    }
+    m_file->write(fileMagic());
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_currentPath = path;
+    }
+
+    qDebug() << "💾 Capturing terminal output to" << path;
+    emit fileRotated(path);
+    pruneOldFiles();
+    return true;
+}
+
+void SessionCaptureWriter::pruneOldFiles()
+{
+    if (m_settings.maxFiles <= 0) {
+        return;
+    }
+
+    const QStringList files = SessionCaptureReader::captureFiles(m_settings.directory, m_settings.baseName);
+    for (int i = 0; i < files.size() - m_settings.maxFiles; ++i) {
+        QFile::remove(files.at(i));
+    }
+}
+
+// SessionCaptureReader Implementation
+QStringList SessionCaptureReader::captureFiles(const QString& directory, const QString& baseName)
+{
+    const QDir dir(directory);
+    const QStringList filters{QString("%1-*.%2").arg(baseName, SessionCaptureWriter::fileSuffix())};
+
+    // Names embed the start time and a sequence number, so name order is age order
+    QStringList files;
+    for (const QString& name : dir.entryList(filters, QDir::Files, QDir::Name)) {
+        files.append(dir.filePath(name));
+    }
+    return files;
+}
+
+bool SessionCaptureReader::read(const QString& path, const RecordSink& sink, QString* error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("Cannot open %1: %2").arg(path, file.errorString());
+        }
+        return false;
+    }
+
+    const QByteArray magic = SessionCaptureWriter::fileMagic();
+    if (file.read(magic.size()) != magic) {
+        if (error) {
+            *error = QString("%1 is not a capture file").arg(path);
+        }
+        return false;
+    }
+
+    for (;;) {
+        const QByteArray header = file.read(kBlockHeaderSize);
+        if (header.size() < kBlockHeaderSize) {
+            return true;
+        }
+
+        const quint32 payloadSize = qFromLittleEndian<quint32>(header.constData());
+        const QByteArray payload = file.read(payloadSize);
+        if (payload.size() < static_cast<qsizetype>(payloadSize)) {
+            return true; // Block still being written
+        }
+
+        const QByteArray records = qUncompress(payload);
+        if (records.isEmpty()) {
+            if (error) {
+                *error = QString("Corrupt block in %1").arg(path);
+            }
+            return false;
+        }
+
+        qsizetype pos = 0;
+        while (pos + kRecordHeaderSize <= records.size()) {
+            const auto stream = static_cast<CaptureStream>(static_cast<quint8>(records.at(pos)));
+            const quint32 length = qFromLittleEndian<quint32>(records.constData() + pos + 1);
+            pos += kRecordHeaderSize;
+            if (length > static_cast<quint64>(records.size() - pos)) {
+                break;
+            }
+            if (!sink(stream, records.mid(pos, length))) {
+                return true;
+            }
+            pos += length;
+        }
+    }
+}
+
+bool SessionCaptureReader::exportText(const QStringList& files, const QString& targetPath, QString* error)
+{
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) {
+            *error = QString("Cannot write %1: %2").arg(targetPath, target.errorString());
+        }
+        return false;
+    }
+
+    bool writeFailed = false;
+    for (const QString& file : files) {
+        const bool ok = read(file, [&target, &writeFailed](CaptureStream, const QByteArray& data) {
+            writeFailed = target.write(data) != data.size();
+            return !writeFailed;
+        }, error);
+
+        if (writeFailed) {
+            if (error) {
+                *error = QString("Failed writing %1: %2").arg(targetPath, target.errorString());
+            }
+            return false;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
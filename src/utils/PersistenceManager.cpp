@@ -4,11 +4,16 @@
 #include "persistence/ComponentPersistence.h"
 #include "persistence/RTLModulePersistence.h"
 #include "persistence/ConnectionPersistence.h"
+#include "persistence/BlockPersistence.h"
+#include "persistence/TopSvModel.h"
 #include "graphics/ReadyComponentGraphicsItem.h"
 #include "graphics/ModuleGraphicsItem.h"
+#include "graphics/BlockGraphicsItem.h"
 #include "graphics/wire/WireGraphicsItem.h"
+#include "scene/SchematicScene.h"
 #include <QFile>
 #include <QDir>
+#include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
@@ -45,6 +50,8 @@ void PersistenceManager::setWorkingDirectory(const QString& directory)
     m_componentPersistence = std::make_unique<ComponentPersistence>(directory);
     m_rtlModulePersistence = std::make_unique<RTLModulePersistence>(directory);
     m_connectionPersistence = std::make_unique<ConnectionPersistence>(directory);
+    m_blockPersistence = std::make_unique<BlockPersistence>(directory);
+    m_topSvModel.reset();
     
     qDebug() << "📂 PersistenceManager: Working directory set to" << directory;
 }
@@ -59,6 +66,7 @@ void PersistenceManager::setComponentId(ReadyComponentGraphicsItem* component, c
 {
     m_componentIdMap[component] = id;
     m_idToComponentMap[id] = component;
+    adoptMember(component);
 }
 
 void PersistenceManager::unregisterComponent(ReadyComponentGraphicsItem* component)
@@ -86,6 +94,7 @@ void PersistenceManager::setRTLModuleName(ModuleGraphicsItem* module, const QStr
 {
     m_rtlModuleNameMap[module] = name;
     m_nameToRTLModuleMap[name] = module;
+    adoptMember(module);
 }
 
 void PersistenceManager::unregisterRTLModule(ModuleGraphicsItem* module)
@@ -98,6 +107,24 @@ void PersistenceManager::unregisterRTLModule(ModuleGraphicsItem* module)
     }
 }
 
+QString PersistenceManager::createRTLModuleName(const QString& definition) const
+{
+    // Modules inside a closed block are not registered, but their names are taken
+    auto taken = [this](const QString& name) {
+        return m_nameToRTLModuleMap.contains(name)
+               || (m_blockPersistence && !m_blockPersistence->ownerOf(name, true).isEmpty());
+    };
+    if (!taken(definition)) {
+        return definition;
+    }
+    for (int i = 2;; ++i) {
+        const QString name = QString("%1_%2").arg(definition).arg(i);
+        if (!taken(name)) {
+            return name;
+        }
+    }
+}
+
 ReadyComponentGraphicsItem* PersistenceManager::getRTLModuleByName(const QString& name) const
 {
     return m_nameToRTLModuleMap.value(name, nullptr);
@@ -117,6 +144,12 @@ QString PersistenceManager::createComponentFile(const QString& componentType, co
     return m_componentPersistence->createComponentFile(componentType, position, size);
 }
 
+QStringList PersistenceManager::createComponentFiles(const QVector<ComponentPersistence::ComponentPlacement>& placements)
+{
+    if (!m_componentPersistence) return QStringList();
+    return m_componentPersistence->createComponentFiles(placements);
+}
+
 QString PersistenceManager::createRTLModuleFile(const ModuleInfo& moduleInfo, const QString& filePath,
                                                const QPointF& position, const QSizeF& size)
 {
@@ -322,6 +355,45 @@ void PersistenceManager::clearMetadataCache()
     }
 }
 
+void PersistenceManager::flushPendingWrites()
+{
+    if (m_componentPersistence) {
+        m_componentPersistence->flushPendingWrites();
+    }
+}
+
+void PersistenceManager::beginBatch()
+{
+    if (m_componentPersistence) {
+        m_componentPersistence->beginBatch();
+    }
+    if (m_connectionPersistence) {
+        m_connectionPersistence->beginBatch();
+    }
+    if (m_rtlModulePersistence) {
+        m_rtlModulePersistence->beginBatch();
+    }
+    if (m_blockPersistence) {
+        m_blockPersistence->beginBatch();
+    }
+}
+
+void PersistenceManager::endBatch()
+{
+    if (m_blockPersistence) {
+        m_blockPersistence->endBatch();
+    }
+    if (m_rtlModulePersistence) {
+        m_rtlModulePersistence->endBatch();
+    }
+    if (m_connectionPersistence) {
+        m_connectionPersistence->endBatch();
+    }
+    if (m_componentPersistence) {
+        m_componentPersistence->endBatch();
+    }
+}
+
 void PersistenceManager::deleteComponentFile(const QString& componentId, bool actuallyDelete)
 {
     if (m_componentPersistence) {
@@ -332,6 +404,9 @@ void PersistenceManager::deleteComponentFile(const QString& componentId, bool ac
         if (actuallyDelete) {
             // For user deletion: remove component and all its connections
             m_connectionPersistence->removeComponentFromConnections(componentId);
+            if (m_blockPersistence) {
+                m_blockPersistence->removeMember(componentId, false);
+            }
         } else {
             // For scene clearing: only remove component from list, preserve connections
             m_connectionPersistence->removeComponentOnlyFromConnections(componentId);
@@ -354,11 +429,12 @@ void PersistenceManager::removeComponentOnlyFromConnections(const QString& compo
 }
 
 // RTL Module operations (delegated to RTLModulePersistence)
-void PersistenceManager::saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position)
+void PersistenceManager::saveRTLModulePlacement(const QString& moduleName, const QString& filePath, const QPointF& position,
+                                                const QString& definition)
 {
     qDebug() << "💾 PersistenceManager::saveRTLModulePlacement() called for module:" << moduleName << "at file:" << filePath;
     if (m_rtlModulePersistence) {
-        m_rtlModulePersistence->saveRTLModulePlacement(moduleName, filePath, position);
+        m_rtlModulePersistence->saveRTLModulePlacement(moduleName, filePath, position, definition);
     }
 }
 
@@ -381,6 +457,9 @@ void PersistenceManager::removeRTLModulePlacement(const QString& moduleName)
     if (m_rtlModulePersistence) {
         m_rtlModulePersistence->removeRTLModulePlacement(moduleName);
     }
+    if (m_blockPersistence) {
+        m_blockPersistence->removeMember(moduleName, true);
+    }
 }
 
 bool PersistenceManager::loadRTLModules(QGraphicsScene* scene)
@@ -405,12 +484,14 @@ QJsonObject PersistenceManager::loadRTLPlacementsJson()
 void PersistenceManager::saveConnection(const QString& sourceId, const QPointF& sourcePort,
                                        const QString& targetId, const QPointF& targetPort,
                                        bool sourceIsRTL, bool targetIsRTL,
-                                       const QList<QPointF>& controlPoints, qreal orthogonalOffset)
+                                       const QList<QPointF>& controlPoints, qreal orthogonalOffset,
+                                       bool manualOffset)
 {
     qDebug() << "🔗 PersistenceManager::saveConnection() called from:" << sourceId << "to:" << targetId;
     if (m_connectionPersistence) {
         m_connectionPersistence->saveConnection(sourceId, sourcePort, targetId, targetPort,
-                                               sourceIsRTL, targetIsRTL, controlPoints, orthogonalOffset);
+                                               sourceIsRTL, targetIsRTL, controlPoints, orthogonalOffset,
+                                               manualOffset);
     }
 }
 
@@ -433,10 +514,11 @@ void PersistenceManager::updateConnectionControlPoints(const QString& sourceId,
 
 void PersistenceManager::updateConnectionOrthogonalOffset(const QString& sourceId, const QPointF& sourcePort,
                                                           const QString& targetId, const QPointF& targetPort,
-                                                          qreal orthogonalOffset)
+                                                          qreal orthogonalOffset, bool manualOffset)
 {
     if (m_connectionPersistence) {
-        m_connectionPersistence->updateConnectionOrthogonalOffset(sourceId, sourcePort, targetId, targetPort, orthogonalOffset);
+        m_connectionPersistence->updateConnectionOrthogonalOffset(sourceId, sourcePort, targetId, targetPort,
+                                                                  orthogonalOffset, manualOffset);
     }
 }
 
@@ -446,6 +528,93 @@ bool PersistenceManager::loadConnections(QGraphicsScene* scene)
     return m_connectionPersistence->loadConnections(scene, this);
 }
 
+QList<ConnectionData> PersistenceManager::connectionsOf(const QStringList& componentIds)
+{
+    if (!m_connectionPersistence) return {};
+    return m_connectionPersistence->connectionsOf(componentIds);
+}
+
+bool PersistenceManager::connectionEnd(ReadyComponentGraphicsItem* item, const QPointF& port, ConnectionEnd& end) const
+{
+    if (BlockGraphicsItem* block = SchematicItemType::cast<BlockGraphicsItem*>(item)) {
+        const BlockPort* member = block->memberOf(port);
+        if (!member) {
+            return false;
+        }
+        end.id = member->memberId;
+        end.port = member->memberPort;
+        end.isRTL = member->memberIsRTL;
+        return !end.id.isEmpty();
+    }
+    
+    // RTL modules are persisted by module name, everything else by component ID
+    ModuleGraphicsItem* module = SchematicItemType::cast<ModuleGraphicsItem*>(item);
+    end.isRTL = module && module->isRTLView();
+    end.id = end.isRTL ? getRTLModuleName(module) : getComponentId(item);
+    end.port = port;
+    return !end.id.isEmpty();
+}
+
+// Block operations (delegated to BlockPersistence)
+QString PersistenceManager::sceneScope(QGraphicsScene* scene) const
+{
+    SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene);
+    return schematicScene ? schematicScene->blockName() : QString();
+}
+
+bool PersistenceManager::belongsToScene(QGraphicsScene* scene, const QString& memberId, bool isRTL)
+{
+    return !m_blockPersistence || m_blockPersistence->ownerOf(memberId, isRTL) == sceneScope(scene);
+}
+
+PersistenceManager::SceneEndpoint PersistenceManager::sceneEndpoint(QGraphicsScene* scene, const QString& memberId,
+                                                                     bool isRTL, const QPointF& port)
+{
+    SceneEndpoint endpoint;
+    const QString scope = sceneScope(scene);
+    QString block = m_blockPersistence ? m_blockPersistence->ownerOf(memberId, isRTL) : QString();
+    if (block == scope) {
+        endpoint.item = isRTL ? getRTLModuleByName(memberId) : getComponentById(memberId);
+        endpoint.port = port;
+        return endpoint;
+    }
+    
+    // Climb to the block that sits directly in the scene; blocks nest only a few levels deep
+    for (int depth = 0; !block.isEmpty() && depth < 64; ++depth) {
+        const QString parent = m_blockPersistence->parentOf(block);
+        if (parent == scope) {
+            SchematicScene* schematicScene = qobject_cast<SchematicScene*>(scene);
+            endpoint.block = schematicScene ? schematicScene->blockItem(block) : nullptr;
+            if (endpoint.block) {
+                endpoint.port = endpoint.block->portFor(memberId, isRTL, port);
+                endpoint.item = endpoint.port.isNull() ? nullptr : endpoint.block;
+            }
+            return endpoint;
+        }
+        block = parent;
+    }
+    endpoint.outside = true;
+    return endpoint;
+}
+
+void PersistenceManager::adoptMember(ReadyComponentGraphicsItem* item)
+{
+    SchematicScene* scene = item ? qobject_cast<SchematicScene*>(item->scene()) : nullptr;
+    if (!scene || !m_blockPersistence || SchematicItemType::cast<BlockGraphicsItem*>(item)) {
+        return;
+    }
+    ConnectionEnd end;
+    if (connectionEnd(item, QPointF(), end) && m_blockPersistence->ownerOf(end.id, end.isRTL) != scene->blockName()) {
+        m_blockPersistence->setOwner(end.id, end.isRTL, scene->blockName());
+    }
+}
+
+bool PersistenceManager::loadBlocks(QGraphicsScene* scene)
+{
+    if (!m_blockPersistence) return false;
+    return m_blockPersistence->loadBlocks(scene, this);
+}
+
 
 void PersistenceManager::updateRTLComponentInConnections(const QString& componentId, const QPointF& position)
 {
@@ -539,6 +708,16 @@ SchematicPersistence* PersistenceManager::getSchematicPersistence() const
     return m_schematicPersistence.get();
 }
 
+ComponentPersistence* PersistenceManager::getComponentPersistence() const
+{
+    return m_componentPersistence.get();
+}
+
+BlockPersistence* PersistenceManager::getBlockPersistence() const
+{
+    return m_blockPersistence.get();
+}
+
 // Legacy methods for RTL/top.sv integration
 void PersistenceManager::updateComponentRTLConnection(const QString& componentId, const QString& rtlFilePath)
 {
@@ -611,6 +790,11 @@ QString PersistenceManager::getComponentRTLConnection(const QString& componentId
 }
 
 void PersistenceManager::generateTopSvIntegration(const QString& componentId, const QString& rtlFilePath)
+{
+    generateTopSvIntegration(QVector<QPair<QString, QString>>{{componentId, rtlFilePath}});
+}
+
+void PersistenceManager::generateTopSvIntegration(const QVector<QPair<QString, QString>>& components)
 {
     if (m_workingDirectory.isEmpty()) {
         qWarning() << "No working directory set";
@@ -618,60 +802,24 @@ void PersistenceManager::generateTopSvIntegration(const QString& componentId, co
     }
     
     QString topSvPath = QDir(m_workingDirectory).filePath("top.sv");
-    
-    QFile topFile(topSvPath);
-    if (!topFile.exists()) {
+    if (!QFile::exists(topSvPath)) {
         qDebug() << "top.sv does not exist, skipping integration";
         return;
     }
     
-    if (!topFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Failed to open top.sv for reading";
-        return;
+    if (!m_topSvModel) {
+        m_topSvModel = std::make_unique<TopSvModel>(topSvPath);
     }
     
-    QTextStream in(&topFile);
-    QString content = in.readAll();
-    topFile.close();
-    
-    QFileInfo rtlFileInfo(rtlFilePath);
-    QString rtlFileName = rtlFileInfo.fileName();
-    QString moduleName = rtlFileInfo.baseName();
-    
-    QString instantiationPattern = QString("\\b%1\\s+u_%2\\s*\\(").arg(moduleName).arg(componentId);
-    QRegularExpression regex(instantiationPattern);
-    
-    if (regex.match(content).hasMatch()) {
-        qDebug() << "Module" << moduleName << "already instantiated in top.sv";
-        return;
+    // The RTL module is found through the tool's file list, so no `include is added
+    for (const auto& component : components) {
+        const QString moduleName = QFileInfo(component.second).baseName();
+        m_topSvModel->addInstance(moduleName, "u_" + component.first);
     }
     
-    QString includePattern = QString("#include\\s+\"%1\"").arg(rtlFileName);
-    QRegularExpression includeRegex(includePattern);
-    
-    if (!includeRegex.match(content).hasMatch()) {
-        QRegularExpression includeSectionRegex(R"(^(\s*//.*\n)*\s*(module\s+top))", QRegularExpression::MultilineOption);
-        QRegularExpressionMatch match = includeSectionRegex.match(content);
-        
-        if (match.hasMatch()) {
-            QString includeLine = QString("#include \"%1\"\n\n").arg(rtlFileName);
-            content.insert(match.capturedStart(2), includeLine);
-        }
-    }
-    
-    QRegularExpression endmoduleRegex(R"(\s*endmodule\s*$)");
-    QRegularExpressionMatch endMatch = endmoduleRegex.match(content);
-    
-    if (endMatch.hasMatch()) {
-        QString instantiation = QString("    %1 u_%2 (.*);\n").arg(moduleName).arg(componentId);
-        content.insert(endMatch.capturedStart(), instantiation);
-        
-        if (topFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-            QTextStream out(&topFile);
-            out << content;
-            topFile.close();
-            qDebug() << "Updated top.sv with RTL module instantiation:" << moduleName;
-        }
+    QString error;
+    if (!m_topSvModel->flush(&error)) {
+        qWarning() << "Failed to update top.sv:" << error;
     }
 }
 